@@ -1176,6 +1176,18 @@ export declare namespace native {
          */
         export function getDataFromFile(fullpath: string): ArrayBuffer;
 
+        /**
+         *  @en
+         *  Read binary data from a file without copying it when possible, large local files are memory mapped.
+         *
+         *  @zh
+         *  从文件中读取二进制数据，尽量避免拷贝，较大的本地文件会通过内存映射读取
+         *
+         *  @param fullpath The current fullpath of the file. Includes path and name.
+         *  @return The file contents, or null if the file could not be read.
+         */
+        export function mapFile(fullpath: string): ArrayBuffer | null;
+
         /**
          *  @en
          *  write Data into a file
@@ -25,14 +25,87 @@
 #include "2d/renderer/Batcher2d.h"
 #include "application/ApplicationManager.h"
 #include "base/TypeDef.h"
+#include "base/job-system/JobSystem.h"
 #include "core/Root.h"
 #include "core/scene-graph/Scene.h"
 #include "editor-support/MiddlewareManager.h"
 #include "renderer/pipeline/Define.h"
 #include "scene/Pass.h"
 
+#if defined(__SSE2__) || defined(_M_X64) // math/Mat4.h undefines __SSE__
+    #include <xmmintrin.h>
+    #define CC_BATCHER2D_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define CC_BATCHER2D_NEON 1
+#endif
+
 namespace cc {
 
+namespace {
+// below this many vertices the job dispatch costs more than the fill itself
+constexpr uint32_t PARALLEL_FILL_VERTEX_THRESHOLD = 4096;
+constexpr uint32_t FILL_JOBS_PER_CHUNK = 64;
+
+// Vec3::transformMat4 for each vertex, with the matrix columns kept in registers.
+// Only xyz is written so the uv that follows the position is left untouched.
+void transformPositions(float* dst, const uint8_t* src, uint32_t stride, uint32_t vertexCount, const Mat4& m) {
+    static_assert(sizeof(Render2dLayout) >= 3 * sizeof(float), "position must be the first three floats");
+    const size_t strideBytes = stride * sizeof(float);
+#if CC_BATCHER2D_SSE
+    const __m128 col0 = _mm_loadu_ps(&m.m[0]);
+    const __m128 col1 = _mm_loadu_ps(&m.m[4]);
+    const __m128 col2 = _mm_loadu_ps(&m.m[8]);
+    const __m128 col3 = _mm_loadu_ps(&m.m[12]);
+    for (uint32_t i = 0; i < vertexCount; ++i, dst += stride, src += strideBytes) {
+        const auto* pos = reinterpret_cast<const float*>(src);
+        __m128 r = _mm_add_ps(_mm_mul_ps(col0, _mm_set1_ps(pos[0])), col3);
+        r = _mm_add_ps(r, _mm_mul_ps(col1, _mm_set1_ps(pos[1])));
+        r = _mm_add_ps(r, _mm_mul_ps(col2, _mm_set1_ps(pos[2])));
+        const float w = _mm_cvtss_f32(_mm_shuffle_ps(r, r, _MM_SHUFFLE(3, 3, 3, 3)));
+        if (CC_PREDICT_TRUE(math::isNotZeroF(w))) {
+            r = _mm_mul_ps(r, _mm_set1_ps(1.F / w));
+        }
+        _mm_storel_pi(reinterpret_cast<__m64*>(dst), r);
+        _mm_store_ss(dst + 2, _mm_movehl_ps(r, r));
+    }
+#elif CC_BATCHER2D_NEON
+    const float32x4_t col0 = vld1q_f32(&m.m[0]);
+    const float32x4_t col1 = vld1q_f32(&m.m[4]);
+    const float32x4_t col2 = vld1q_f32(&m.m[8]);
+    const float32x4_t col3 = vld1q_f32(&m.m[12]);
+    for (uint32_t i = 0; i < vertexCount; ++i, dst += stride, src += strideBytes) {
+        const auto* pos = reinterpret_cast<const float*>(src);
+        float32x4_t r = vmlaq_n_f32(col3, col0, pos[0]);
+        r = vmlaq_n_f32(r, col1, pos[1]);
+        r = vmlaq_n_f32(r, col2, pos[2]);
+        const float w = vgetq_lane_f32(r, 3);
+        if (CC_PREDICT_TRUE(math::isNotZeroF(w))) {
+            r = vmulq_n_f32(r, 1.F / w);
+        }
+        vst1_f32(dst, vget_low_f32(r));
+        dst[2] = vgetq_lane_f32(r, 2);
+    }
+#else
+    for (uint32_t i = 0; i < vertexCount; ++i, dst += stride, src += strideBytes) {
+        reinterpret_cast<Vec3*>(dst)->transformMat4(*reinterpret_cast<const Vec3*>(src), m);
+    }
+#endif
+}
+
+void fillColors(float* dst, uint32_t stride, uint32_t vertexCount, const Color& color, float opacity) {
+    const float r = static_cast<float>(color.r) / 255.0F;
+    const float g = static_cast<float>(color.g) / 255.0F;
+    const float b = static_cast<float>(color.b) / 255.0F;
+    for (uint32_t i = 0; i < vertexCount; ++i, dst += stride) {
+        dst[5] = r;
+        dst[6] = g;
+        dst[7] = b;
+        dst[8] = opacity;
+    }
+}
+} // namespace
+
 Batcher2d::Batcher2d() : Batcher2d(nullptr) {
 }
 
@@ -107,6 +180,71 @@ void Batcher2d::fillBuffersAndMergeBatches() {
         }
         index = count;
     }
+    flushVertexFills();
+}
+
+void Batcher2d::enqueueVertexFill(RenderEntity* entity, RenderDrawInfo* drawInfo, Node* node) {
+    VertexFillJob job;
+    job.drawInfo = drawInfo;
+    if (node->getChangedFlags() || drawInfo->getVertDirty()) {
+        // getWorldMatrix may update the transform lazily, so resolve it here rather than in a job
+        job.worldMatrix = &entity->getNode()->getWorldMatrix();
+        drawInfo->setVertDirty(false);
+    }
+    if (entity->getVBColorDirty()) {
+        job.fillColor = true;
+        job.color = entity->getColor();
+        job.opacity = entity->getOpacity();
+    }
+
+    // reserve the index range now, batches are generated from the offsets before the fill runs
+    UIMeshBuffer* buffer = drawInfo->getMeshBuffer();
+    job.indexOffset = buffer->getIndexOffset();
+    buffer->setIndexOffset(job.indexOffset + drawInfo->getIbCount());
+
+    _vertexFillCount += drawInfo->getVbCount();
+    _vertexFillJobs.push_back(job);
+}
+
+void Batcher2d::flushVertexFills() {
+    auto fill = [this](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            const VertexFillJob& job = _vertexFillJobs[i];
+            RenderDrawInfo* drawInfo = job.drawInfo;
+            uint32_t const stride = drawInfo->getStride();
+            uint32_t const vbCount = drawInfo->getVbCount();
+            float* vbBuffer = drawInfo->getVbBuffer();
+            if (job.worldMatrix) {
+                const auto* src = reinterpret_cast<const uint8_t*>(drawInfo->getRender2dLayout(0));
+                transformPositions(vbBuffer, src, stride, vbCount, *job.worldMatrix);
+            }
+            if (job.fillColor) {
+                fillColors(vbBuffer, stride, vbCount, job.color, job.opacity);
+            }
+            uint16_t* ib = drawInfo->getIDataBuffer();
+            memcpy(&ib[job.indexOffset], drawInfo->getIbBuffer(), drawInfo->getIbCount() * sizeof(uint16_t));
+        }
+    };
+
+    auto jobCount = static_cast<uint32_t>(_vertexFillJobs.size());
+    auto* jobSystem = JobSystem::getInstance();
+    if (_vertexFillCount < PARALLEL_FILL_VERTEX_THRESHOLD || jobCount <= FILL_JOBS_PER_CHUNK || jobSystem->threadCount() < 2) {
+        fill(0, jobCount);
+    } else {
+        uint32_t const chunkCount = (jobCount + FILL_JOBS_PER_CHUNK - 1) / FILL_JOBS_PER_CHUNK;
+        auto fillChunk = [&](uint32_t chunk) {
+            uint32_t const begin = chunk * FILL_JOBS_PER_CHUNK;
+            fill(begin, std::min(begin + FILL_JOBS_PER_CHUNK, jobCount));
+        };
+        JobGraph g(jobSystem);
+        g.createForEachIndexJob(1U, chunkCount, 1U, fillChunk);
+        g.run();
+        fillChunk(0U); // the calling thread takes the first chunk
+        g.waitForAll();
+    }
+
+    _vertexFillJobs.clear();
+    _vertexFillCount = 0;
 }
 
 void Batcher2d::walk(Node* node, float parentOpacity) { // NOLINT(misc-no-recursion)
@@ -206,15 +344,7 @@ CC_FORCE_INLINE void Batcher2d::handleComponentDraw(RenderEntity* entity, Render
     }
 
     if (!drawInfo->getIsMeshBuffer()) {
-        if (node->getChangedFlags() || drawInfo->getVertDirty()) {
-            fillVertexBuffers(entity, drawInfo);
-            drawInfo->setVertDirty(false);
-        }
-        if (entity->getVBColorDirty()) {
-            fillColors(entity, drawInfo);
-        }
-
-        fillIndexBuffers(drawInfo);
+        enqueueVertexFill(entity, drawInfo, node);
     }
 
     if (isMask) {
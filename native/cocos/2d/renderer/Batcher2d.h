@@ -74,39 +74,13 @@ public:
     void generateBatchForMiddleware(RenderEntity* entity, RenderDrawInfo* drawInfo);
     void resetRenderStates();
 
+    // records the vertex and index fill of a draw info, flushVertexFills runs the recorded fills
+    void enqueueVertexFill(RenderEntity* entity, RenderDrawInfo* drawInfo, Node* node);
+    void flushVertexFills();
+
 private:
     bool _isInit = false;
 
-    inline void fillIndexBuffers(RenderDrawInfo* drawInfo) { // NOLINT(readability-convert-member-functions-to-static)
-        uint16_t* ib = drawInfo->getIDataBuffer();
-
-        UIMeshBuffer* buffer = drawInfo->getMeshBuffer();
-        uint32_t indexOffset = buffer->getIndexOffset();
-
-        uint16_t* indexb = drawInfo->getIbBuffer();
-        uint32_t indexCount = drawInfo->getIbCount();
-
-        memcpy(&ib[indexOffset], indexb, indexCount * sizeof(uint16_t));
-        indexOffset += indexCount;
-
-        buffer->setIndexOffset(indexOffset);
-    }
-
-    inline void fillVertexBuffers(RenderEntity* entity, RenderDrawInfo* drawInfo) { // NOLINT(readability-convert-member-functions-to-static)
-        Node* node = entity->getNode();
-        const Mat4& matrix = node->getWorldMatrix();
-        uint8_t stride = drawInfo->getStride();
-        uint32_t size = drawInfo->getVbCount() * stride;
-        float* vbBuffer = drawInfo->getVbBuffer();
-        for (int i = 0; i < size; i += stride) {
-            Render2dLayout* curLayout = drawInfo->getRender2dLayout(i);
-            // make sure that the layout of Vec3 is three consecutive floats
-            static_assert(sizeof(Vec3) == 3 * sizeof(float));
-            // cast to reduce value copy instructions
-            reinterpret_cast<Vec3*>(vbBuffer + i)->transformMat4(curLayout->position, matrix);
-        }
-    }
-
     inline void setIndexRange(RenderDrawInfo* drawInfo) { // NOLINT(readability-convert-member-functions-to-static)
         UIMeshBuffer* buffer = drawInfo->getMeshBuffer();
         uint32_t indexOffset = drawInfo->getIndexOffset();
@@ -117,22 +91,16 @@ private:
         }
     }
 
-    inline void fillColors(RenderEntity* entity, RenderDrawInfo* drawInfo) { // NOLINT(readability-convert-member-functions-to-static)
-        Color temp = entity->getColor();
-
-        uint8_t stride = drawInfo->getStride();
-        uint32_t size = drawInfo->getVbCount() * stride;
-        float* vbBuffer = drawInfo->getVbBuffer();
-
-        uint32_t offset = 0;
-        for (int i = 0; i < size; i += stride) {
-            offset = i + 5;
-            vbBuffer[offset++] = static_cast<float>(temp.r) / 255.0F;
-            vbBuffer[offset++] = static_cast<float>(temp.g) / 255.0F;
-            vbBuffer[offset++] = static_cast<float>(temp.b) / 255.0F;
-            vbBuffer[offset++] = entity->getOpacity();
-        }
-    }
+    // Vertex and index work recorded by the serial walk. The walk reserves the index range and
+    // snapshots everything read from the scene graph, so the fill itself touches no shared state.
+    struct VertexFillJob {
+        RenderDrawInfo* drawInfo{nullptr};
+        const Mat4* worldMatrix{nullptr}; // nullptr if the positions are up to date
+        Color color;
+        float opacity{1.F};
+        bool fillColor{false};
+        uint32_t indexOffset{0};
+    };
 
     void insertMaskBatch(RenderEntity* entity);
     void createClearModel();
@@ -175,6 +143,9 @@ private:
     // weak reference
     ccstd::vector<RenderDrawInfo*> _meshRenderDrawInfo;
 
+    ccstd::vector<VertexFillJob> _vertexFillJobs;
+    uint32_t _vertexFillCount{0};
+
     // manage memory manually
     ccstd::unordered_map<ccstd::hash_t, gfx::DescriptorSet*> _descriptorSetCache;
     gfx::DescriptorSetInfo _dsInfo;
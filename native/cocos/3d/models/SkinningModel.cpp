@@ -27,12 +27,21 @@
 
 #include "3d/assets/Mesh.h"
 #include "3d/assets/Skeleton.h"
+#include "base/job-system/JobSystem.h"
 #include "core/platform/Debug.h"
 #include "core/scene-graph/Node.h"
 #include "renderer/gfx-base/GFXBuffer.h"
 #include "scene/Pass.h"
 #include "scene/RenderScene.h"
 
+#if defined(__SSE2__) || defined(_M_X64) // math/Mat4.h undefines __SSE__
+    #include <xmmintrin.h>
+    #define CC_SKINNING_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define CC_SKINNING_NEON 1
+#endif
+
 const uint32_t REALTIME_JOINT_TEXTURE_WIDTH = 256;
 const uint32_t REALTIME_JOINT_TEXTURE_HEIGHT = 3;
 
@@ -53,6 +62,9 @@ void getRelevantBuffers(ccstd::vector<index_t> &outIndices, ccstd::vector<int32_
     }
 }
 
+// below this many joints in total the palettes are cheaper to compute on the calling thread
+constexpr size_t PARALLEL_PALETTE_JOINT_THRESHOLD = 1024;
+
 ccstd::vector<cc::scene::IMacroPatch> uniformPatches{{"CC_USE_SKINNING", true}, {"CC_USE_REAL_TIME_JOINT_TEXTURE", false}};
 ccstd::vector<cc::scene::IMacroPatch> texturePatches{{"CC_USE_SKINNING", true}, {"CC_USE_REAL_TIME_JOINT_TEXTURE", true}};
 
@@ -143,20 +155,74 @@ void SkinningModel::updateTransform(uint32_t stamp) {
 
 void SkinningModel::updateUBOs(uint32_t stamp) {
     Super::updateUBOs(stamp);
-    uint32_t bIdx = 0;
+    // models attached to a scene are batched by RenderScene::update through updateJointPalettes
+    if (_scene == nullptr) {
+        updateJointPalette();
+        uploadJointPalette();
+    }
+}
+
+// Writes world * bindpose as the 3x4 joint data layout expected by the skinning shaders,
+// i.e. the first three columns with the translation moved into their w components.
+void SkinningModel::computeJointData(const Mat4 &world, const Mat4 &bindpose, float *dst) {
+    const float *b = bindpose.m;
+#if CC_SKINNING_SSE
+    const __m128 a0 = _mm_loadu_ps(&world.m[0]);
+    const __m128 a1 = _mm_loadu_ps(&world.m[4]);
+    const __m128 a2 = _mm_loadu_ps(&world.m[8]);
+    const __m128 a3 = _mm_loadu_ps(&world.m[12]);
+    alignas(16) float translation[4];
+    for (uint32_t c = 0; c < 4; ++c, b += 4) {
+        __m128 col = _mm_mul_ps(a0, _mm_set1_ps(b[0]));
+        col = _mm_add_ps(col, _mm_mul_ps(a1, _mm_set1_ps(b[1])));
+        col = _mm_add_ps(col, _mm_mul_ps(a2, _mm_set1_ps(b[2])));
+        col = _mm_add_ps(col, _mm_mul_ps(a3, _mm_set1_ps(b[3])));
+        if (c < 3) {
+            _mm_storeu_ps(dst + c * 4, col);
+        } else {
+            _mm_store_ps(translation, col);
+        }
+    }
+#elif CC_SKINNING_NEON
+    const float32x4_t a0 = vld1q_f32(&world.m[0]);
+    const float32x4_t a1 = vld1q_f32(&world.m[4]);
+    const float32x4_t a2 = vld1q_f32(&world.m[8]);
+    const float32x4_t a3 = vld1q_f32(&world.m[12]);
+    alignas(16) float translation[4];
+    for (uint32_t c = 0; c < 4; ++c, b += 4) {
+        float32x4_t col = vmulq_n_f32(a0, b[0]);
+        col = vmlaq_n_f32(col, a1, b[1]);
+        col = vmlaq_n_f32(col, a2, b[2]);
+        col = vmlaq_n_f32(col, a3, b[3]);
+        vst1q_f32(c < 3 ? dst + c * 4 : translation, col);
+    }
+#else
     Mat4 mat4;
+    Mat4::multiply(world, bindpose, &mat4);
+    memcpy(dst, mat4.m, sizeof(float) * 12);
+    const float *translation = mat4.m + 12;
+#endif
+    dst[3] = translation[0];
+    dst[7] = translation[1];
+    dst[11] = translation[2];
+}
+
+void SkinningModel::updateJointPalette() {
+    float jointData[12];
     for (const JointInfo &jointInfo : _joints) {
-        Mat4::multiply(jointInfo.transform->world, jointInfo.bindpose, &mat4);
-        for (uint32_t buffer : jointInfo.buffers) {
-            uploadJointData(jointInfo.indices[bIdx] * 12, mat4, _dataArray[buffer]);
-            bIdx++;
+        computeJointData(jointInfo.transform->world, jointInfo.bindpose, jointData);
+        const auto bufferCount = jointInfo.buffers.size();
+        for (size_t i = 0; i < bufferCount; ++i) {
+            memcpy(_dataArray[jointInfo.buffers[i]] + jointInfo.indices[i] * 12, jointData, sizeof(jointData));
         }
-        bIdx = 0;
     }
+}
+
+void SkinningModel::uploadJointPalette() {
     if (_realTimeTextureMode) {
         updateRealTimeJointTextureBuffer();
     } else {
-        bIdx = 0;
+        uint32_t bIdx = 0;
         for (gfx::Buffer *buffer : _buffers) {
             buffer->update(_dataArray[bIdx], buffer->getSize());
             bIdx++;
@@ -164,6 +230,34 @@ void SkinningModel::updateUBOs(uint32_t stamp) {
     }
 }
 
+void SkinningModel::updateJointPalettes(const ccstd::vector<SkinningModel *> &models) {
+    size_t jointCount = 0;
+    for (const auto *model : models) {
+        jointCount += model->_joints.size();
+    }
+
+    auto *jobSystem = JobSystem::getInstance();
+    const auto modelCount = static_cast<uint32_t>(models.size());
+    if (jointCount >= PARALLEL_PALETTE_JOINT_THRESHOLD && modelCount > 1 && jobSystem->threadCount() > 1) {
+        JobGraph g(jobSystem);
+        g.createForEachIndexJob(1U, modelCount, 1U, [&models](uint32_t i) {
+            models[i]->updateJointPalette();
+        });
+        g.run();
+        models[0]->updateJointPalette(); // the calling thread takes the first model
+        g.waitForAll();
+    } else {
+        for (auto *model : models) {
+            model->updateJointPalette();
+        }
+    }
+
+    // buffer updates go through the device and stay on the calling thread
+    for (auto *model : models) {
+        model->uploadJointPalette();
+    }
+}
+
 void SkinningModel::initSubModel(index_t idx, RenderingSubMesh *subMeshData, Material *mat) {
     const auto &original = subMeshData->getVertexBuffers();
     auto &iaInfo = subMeshData->getIaInfo();
@@ -187,13 +281,6 @@ ccstd::vector<scene::IMacroPatch> SkinningModel::getMacroPatches(index_t subMode
     return myPatches;
 }
 
-void SkinningModel::uploadJointData(uint32_t base, const Mat4 &mat, float *dst) {
-    memcpy(reinterpret_cast<void *>(dst + base), mat.m, sizeof(float) * 12);
-    dst[base + 3] = mat.m[12];
-    dst[base + 7] = mat.m[13];
-    dst[base + 11] = mat.m[14];
-}
-
 void SkinningModel::updateLocalDescriptors(index_t submodelIdx, gfx::DescriptorSet *descriptorset) {
     Super::updateLocalDescriptors(submodelIdx, descriptorset);
     uint32_t idx = _bufferIndices[submodelIdx];
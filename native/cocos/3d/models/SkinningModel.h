@@ -64,8 +64,15 @@ public:
 
     void bindSkeleton(Skeleton *skeleton, Node *skinningRoot, Mesh *mesh);
 
+    // only reads the joint transforms resolved by updateTransform, so models can be computed on different threads
+    void updateJointPalette();
+    void uploadJointPalette();
+    // computes the palettes of all models on worker threads when there is enough work, then uploads them
+    static void updateJointPalettes(const ccstd::vector<SkinningModel *> &models);
+    // writes world * bindpose in the 3x4 joint layout of the skinning shaders, with SSE or NEON where available
+    static void computeJointData(const Mat4 &world, const Mat4 &bindpose, float *dst);
+
 private:
-    static void uploadJointData(uint32_t base, const Mat4 &mat, float *dst);
     void ensureEnoughBuffers(uint32_t count);
     void updateRealTimeJointTextureBuffer();
     void initRealTimeJointTexture();
@@ -0,0 +1,547 @@
+/****************************************************************************
+ Copyright (c) 2017-2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+
+#include "audio/common/mixer/SoftwareMixer.h"
+
+#include <algorithm>
+#include "audio/common/utils/include/primitives.h"
+
+#if defined(__SSE2__) || defined(_M_X64) // math/Mat4.h undefines __SSE__
+    #include <emmintrin.h>
+    #define CC_AUDIO_MIXER_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define CC_AUDIO_MIXER_NEON 1
+#endif
+
+namespace cc {
+
+namespace {
+constexpr uint64_t FIXED_ONE = 1ULL << 32U;
+constexpr uint64_t FIXED_FRACTION_MASK = FIXED_ONE - 1;
+constexpr float FIXED_FRACTION_SCALE = 1.0F / 4294967296.0F;
+constexpr float SAMPLE_SCALE = 1.0F / 32768.0F;
+// below one lsb of the output a voice is not mixed, only kept running
+constexpr float INAUDIBLE_VOLUME = 1.0F / 65536.0F;
+// the index is the low 16 bits of a voice id, the generation of the slot the high ones
+constexpr uint32_t VOICE_INDEX_BITS = 16;
+constexpr uint32_t MAX_VOICES = (1U << VOICE_INDEX_BITS) - 1;
+
+inline float lerp(float a, float b, float t) {
+    return a + (b - a) * t;
+}
+
+// Reads the frame index and fraction of four output frames, and the left and right samples on both sides of them.
+inline void gatherFrames(const int16_t *src, uint32_t srcChannels, uint64_t &position, uint64_t step,
+                         float *left0, float *left1, float *right0, float *right1, float *fractions) {
+    const uint32_t right = srcChannels - 1;
+    for (uint32_t k = 0; k < 4; ++k) {
+        const int16_t *frame = src + (position >> 32U) * srcChannels;
+        left0[k] = frame[0];
+        left1[k] = frame[srcChannels];
+        right0[k] = frame[right];
+        right1[k] = frame[srcChannels + right];
+        fractions[k] = static_cast<float>(position & FIXED_FRACTION_MASK) * FIXED_FRACTION_SCALE;
+        position += step;
+    }
+}
+
+/**
+ * Accumulates count frames resampled from src into the stereo dst, starting at position and moving by step.
+ * The gain ramps by gainStep every frame. Every frame read and the one after it must be inside src.
+ */
+void resampleToStereo(const int16_t *src, uint32_t srcChannels, uint64_t position, uint64_t step,
+                      float gain, float gainStep, float *dst, uint32_t count) {
+    uint32_t i = 0;
+#if CC_AUDIO_MIXER_SSE2 || CC_AUDIO_MIXER_NEON
+    alignas(16) float left0[4];
+    alignas(16) float left1[4];
+    alignas(16) float right0[4];
+    alignas(16) float right1[4];
+    alignas(16) float fractions[4];
+    alignas(16) const float gains[4] = {gain, gain + gainStep, gain + gainStep * 2, gain + gainStep * 3};
+    #if CC_AUDIO_MIXER_SSE2
+    const __m128 scale = _mm_set1_ps(SAMPLE_SCALE);
+    const __m128 gainStep4 = _mm_set1_ps(gainStep * 4);
+    __m128 g = _mm_load_ps(gains);
+    for (; i + 4 <= count; i += 4) {
+        gatherFrames(src, srcChannels, position, step, left0, left1, right0, right1, fractions);
+        const __m128 t = _mm_load_ps(fractions);
+        const __m128 l0 = _mm_load_ps(left0);
+        const __m128 r0 = _mm_load_ps(right0);
+        const __m128 frameGain = _mm_mul_ps(g, scale);
+        const __m128 l = _mm_mul_ps(_mm_add_ps(l0, _mm_mul_ps(_mm_sub_ps(_mm_load_ps(left1), l0), t)), frameGain);
+        const __m128 r = _mm_mul_ps(_mm_add_ps(r0, _mm_mul_ps(_mm_sub_ps(_mm_load_ps(right1), r0), t)), frameGain);
+        float *out = dst + i * 2;
+        _mm_storeu_ps(out, _mm_add_ps(_mm_loadu_ps(out), _mm_unpacklo_ps(l, r)));
+        _mm_storeu_ps(out + 4, _mm_add_ps(_mm_loadu_ps(out + 4), _mm_unpackhi_ps(l, r)));
+        g = _mm_add_ps(g, gainStep4);
+    }
+    #else
+    const float32x4_t gainStep4 = vdupq_n_f32(gainStep * 4);
+    float32x4_t g = vld1q_f32(gains);
+    for (; i + 4 <= count; i += 4) {
+        gatherFrames(src, srcChannels, position, step, left0, left1, right0, right1, fractions);
+        const float32x4_t t = vld1q_f32(fractions);
+        const float32x4_t l0 = vld1q_f32(left0);
+        const float32x4_t r0 = vld1q_f32(right0);
+        const float32x4_t frameGain = vmulq_n_f32(g, SAMPLE_SCALE);
+        const float32x4_t l = vmulq_f32(vmlaq_f32(l0, vsubq_f32(vld1q_f32(left1), l0), t), frameGain);
+        const float32x4_t r = vmulq_f32(vmlaq_f32(r0, vsubq_f32(vld1q_f32(right1), r0), t), frameGain);
+        const float32x4x2_t lr = vzipq_f32(l, r);
+        float *out = dst + i * 2;
+        vst1q_f32(out, vaddq_f32(vld1q_f32(out), lr.val[0]));
+        vst1q_f32(out + 4, vaddq_f32(vld1q_f32(out + 4), lr.val[1]));
+        g = vaddq_f32(g, gainStep4);
+    }
+    #endif
+    gain += gainStep * static_cast<float>(i);
+#endif
+    const uint32_t right = srcChannels - 1;
+    for (; i < count; ++i) {
+        const int16_t *frame = src + (position >> 32U) * srcChannels;
+        const float t = static_cast<float>(position & FIXED_FRACTION_MASK) * FIXED_FRACTION_SCALE;
+        const float frameGain = gain * SAMPLE_SCALE;
+        dst[i * 2] += lerp(frame[0], frame[srcChannels], t) * frameGain;
+        dst[i * 2 + 1] += lerp(frame[right], frame[srcChannels + right], t) * frameGain;
+        position += step;
+        gain += gainStep;
+    }
+}
+
+// Accumulates count frames of src from frame index on into the stereo dst, for sounds at the output rate.
+void copyToStereo(const int16_t *src, uint32_t srcChannels, float gain, float gainStep, float *dst, uint32_t count) {
+    uint32_t i = 0;
+#if CC_AUDIO_MIXER_SSE2
+    const __m128 scale = _mm_set1_ps(SAMPLE_SCALE);
+    const __m128 gainStep4 = _mm_set1_ps(gainStep * 4);
+    __m128 g = _mm_setr_ps(gain, gain + gainStep, gain + gainStep * 2, gain + gainStep * 3);
+    for (; i + 4 <= count; i += 4) {
+        const __m128 frameGain = _mm_mul_ps(g, scale);
+        __m128 lo;
+        __m128 hi;
+        if (srcChannels == 2) {
+            // L0 R0 L1 R1 and L2 R2 L3 R3
+            const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * 2));
+            lo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16));
+            hi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16));
+            lo = _mm_mul_ps(lo, _mm_unpacklo_ps(frameGain, frameGain));
+            hi = _mm_mul_ps(hi, _mm_unpackhi_ps(frameGain, frameGain));
+        } else {
+            const __m128i samples = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(src + i));
+            const __m128 mono = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16)), frameGain);
+            lo = _mm_unpacklo_ps(mono, mono);
+            hi = _mm_unpackhi_ps(mono, mono);
+        }
+        float *out = dst + i * 2;
+        _mm_storeu_ps(out, _mm_add_ps(_mm_loadu_ps(out), lo));
+        _mm_storeu_ps(out + 4, _mm_add_ps(_mm_loadu_ps(out + 4), hi));
+        g = _mm_add_ps(g, gainStep4);
+    }
+    gain += gainStep * static_cast<float>(i);
+#elif CC_AUDIO_MIXER_NEON
+    alignas(16) const float gains[4] = {gain, gain + gainStep, gain + gainStep * 2, gain + gainStep * 3};
+    const float32x4_t gainStep4 = vdupq_n_f32(gainStep * 4);
+    float32x4_t g = vld1q_f32(gains);
+    for (; i + 4 <= count; i += 4) {
+        const float32x4_t frameGain = vmulq_n_f32(g, SAMPLE_SCALE);
+        // deinterleaved: left samples in val[0], right ones in val[1]
+        float32x4x2_t out = vld2q_f32(dst + i * 2);
+        if (srcChannels == 2) {
+            const int16x4x2_t samples = vld2_s16(src + i * 2);
+            out.val[0] = vmlaq_f32(out.val[0], vcvtq_f32_s32(vmovl_s16(samples.val[0])), frameGain);
+            out.val[1] = vmlaq_f32(out.val[1], vcvtq_f32_s32(vmovl_s16(samples.val[1])), frameGain);
+        } else {
+            const float32x4_t mono = vmulq_f32(vcvtq_f32_s32(vmovl_s16(vld1_s16(src + i))), frameGain);
+            out.val[0] = vaddq_f32(out.val[0], mono);
+            out.val[1] = vaddq_f32(out.val[1], mono);
+        }
+        vst2q_f32(dst + i * 2, out);
+        g = vaddq_f32(g, gainStep4);
+    }
+    gain += gainStep * static_cast<float>(i);
+#endif
+    const uint32_t right = srcChannels - 1;
+    for (; i < count; ++i) {
+        const int16_t *frame = src + i * srcChannels;
+        const float frameGain = gain * SAMPLE_SCALE;
+        dst[i * 2] += static_cast<float>(frame[0]) * frameGain;
+        dst[i * 2 + 1] += static_cast<float>(frame[right]) * frameGain;
+        gain += gainStep;
+    }
+}
+
+// Mono outputs are rare enough for a scalar loop, stereo sounds are downmixed.
+void resampleToMono(const int16_t *src, uint32_t srcChannels, uint64_t position, uint64_t step,
+                    float gain, float gainStep, float *dst, uint32_t count) {
+    const uint32_t right = srcChannels - 1;
+    for (uint32_t i = 0; i < count; ++i) {
+        const int16_t *frame = src + (position >> 32U) * srcChannels;
+        const float t = static_cast<float>(position & FIXED_FRACTION_MASK) * FIXED_FRACTION_SCALE;
+        const float left = lerp(frame[0], frame[srcChannels], t);
+        const float rightSample = lerp(frame[right], frame[srcChannels + right], t);
+        dst[i] += (left + rightSample) * 0.5F * gain * SAMPLE_SCALE;
+        position += step;
+        gain += gainStep;
+    }
+}
+
+} // namespace
+
+SoftwareMixer::SoftwareMixer(uint32_t sampleRate, uint32_t channelCount, uint32_t maxAudibleVoices)
+: _sampleRate(sampleRate),
+  _channelCount(channelCount == 1 ? 1 : 2),
+  _maxAudibleVoices(maxAudibleVoices) {
+    CC_ASSERT(sampleRate > 0);
+}
+
+SoftwareMixer::VoiceId SoftwareMixer::play(const Sound &sound, float volume, bool loop, int priority) {
+    if (sound.frames == nullptr || sound.frameCount == 0 || sound.sampleRate == 0 ||
+        (sound.channelCount != 1 && sound.channelCount != 2)) {
+        return INVALID_VOICE;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    uint32_t index = 0;
+    if (!_freeVoices.empty()) {
+        index = _freeVoices.back();
+        _freeVoices.pop_back();
+    } else if (_voices.size() < MAX_VOICES) {
+        index = static_cast<uint32_t>(_voices.size());
+        _voices.emplace_back();
+        _voices.back().generation = 1;
+    } else {
+        return INVALID_VOICE;
+    }
+
+    auto &voice = _voices[index];
+    voice.sound = sound;
+    voice.position = 0;
+    voice.step = (static_cast<uint64_t>(sound.sampleRate) << 32U) / _sampleRate;
+    voice.volume = std::max(volume, 0.0F);
+    voice.gain = voice.volume;
+    voice.priority = priority;
+    voice.order = ++_nextOrder;
+    voice.active = true;
+    voice.loop = loop;
+    voice.paused = false;
+    _activeVoices.push_back(index);
+
+    return (voice.generation << VOICE_INDEX_BITS) | index;
+}
+
+SoftwareMixer::Voice *SoftwareMixer::findVoice(VoiceId id) {
+    const uint32_t index = id & MAX_VOICES;
+    if (index >= _voices.size()) {
+        return nullptr;
+    }
+    auto &voice = _voices[index];
+    return voice.active && voice.generation == (id >> VOICE_INDEX_BITS) ? &voice : nullptr;
+}
+
+const SoftwareMixer::Voice *SoftwareMixer::findVoice(VoiceId id) const {
+    return const_cast<SoftwareMixer *>(this)->findVoice(id);
+}
+
+void SoftwareMixer::releaseVoice(uint32_t index) {
+    auto &voice = _voices[index];
+    voice.active = false;
+    voice.sound = {};
+    // an id of the slot never comes back, even once the generation wraps
+    voice.generation = (voice.generation + 1) & MAX_VOICES;
+    if (voice.generation == 0) {
+        voice.generation = 1;
+    }
+    _freeVoices.push_back(index);
+
+    auto it = std::find(_activeVoices.begin(), _activeVoices.end(), index);
+    if (it != _activeVoices.end()) {
+        *it = _activeVoices.back();
+        _activeVoices.pop_back();
+    }
+}
+
+bool SoftwareMixer::stop(VoiceId id) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (findVoice(id) == nullptr) {
+        return false;
+    }
+    releaseVoice(id & MAX_VOICES);
+    return true;
+}
+
+bool SoftwareMixer::pause(VoiceId id) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto *voice = findVoice(id);
+    if (voice == nullptr) {
+        return false;
+    }
+    voice->paused = true;
+    return true;
+}
+
+bool SoftwareMixer::resume(VoiceId id) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto *voice = findVoice(id);
+    if (voice == nullptr) {
+        return false;
+    }
+    if (voice->paused) {
+        voice->paused = false;
+        voice->gain = 0.0F;
+    }
+    return true;
+}
+
+bool SoftwareMixer::setVolume(VoiceId id, float volume) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto *voice = findVoice(id);
+    if (voice == nullptr) {
+        return false;
+    }
+    voice->volume = std::max(volume, 0.0F);
+    return true;
+}
+
+bool SoftwareMixer::setLoop(VoiceId id, bool loop) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto *voice = findVoice(id);
+    if (voice == nullptr) {
+        return false;
+    }
+    voice->loop = loop;
+    return true;
+}
+
+float SoftwareMixer::getTime(VoiceId id) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    const auto *voice = findVoice(id);
+    if (voice == nullptr) {
+        return -1.0F;
+    }
+    return static_cast<float>(static_cast<double>(voice->position) / static_cast<double>(FIXED_ONE) / voice->sound.sampleRate);
+}
+
+bool SoftwareMixer::setTime(VoiceId id, float time) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto *voice = findVoice(id);
+    if (voice == nullptr || time < 0.0F) {
+        return false;
+    }
+    const auto frame = static_cast<double>(time) * voice->sound.sampleRate;
+    if (frame >= voice->sound.frameCount) {
+        return false;
+    }
+    voice->position = static_cast<uint64_t>(frame * static_cast<double>(FIXED_ONE));
+    return true;
+}
+
+bool SoftwareMixer::isActive(VoiceId id) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return findVoice(id) != nullptr;
+}
+
+void SoftwareMixer::stopSound(const int16_t *frames) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (uint32_t i = 0; i < _activeVoices.size();) {
+        const uint32_t index = _activeVoices[i];
+        if (_voices[index].sound.frames == frames) {
+            releaseVoice(index);
+        } else {
+            ++i;
+        }
+    }
+}
+
+void SoftwareMixer::stopAll() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    while (!_activeVoices.empty()) {
+        releaseVoice(_activeVoices.back());
+    }
+}
+
+void SoftwareMixer::collectFinished(ccstd::vector<VoiceId> &finished) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    finished.insert(finished.end(), _finished.begin(), _finished.end());
+    _finished.clear();
+}
+
+uint32_t SoftwareMixer::getMaxAudibleVoices() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _maxAudibleVoices;
+}
+
+void SoftwareMixer::setMaxAudibleVoices(uint32_t count) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _maxAudibleVoices = count;
+}
+
+SoftwareMixer::Stats SoftwareMixer::getStats() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stats;
+}
+
+bool SoftwareMixer::mixVoice(Voice &voice, uint32_t frameCount) {
+    const auto &sound = voice.sound;
+    const uint64_t end = static_cast<uint64_t>(sound.frameCount) << 32U;
+    // frames before this one can be interpolated with the next frame of the sound
+    const uint64_t interpolationEnd = static_cast<uint64_t>(sound.frameCount - 1) << 32U;
+    const float gainStep = (voice.volume - voice.gain) / static_cast<float>(frameCount);
+    float gain = voice.gain;
+    float *dst = _mixBuffer.data();
+
+    uint32_t done = 0;
+    while (done < frameCount) {
+        if (voice.position >= end) {
+            if (!voice.loop) {
+                return false;
+            }
+            voice.position %= end;
+        }
+
+        if (voice.position < interpolationEnd) {
+            const uint64_t available = (interpolationEnd - voice.position + voice.step - 1) / voice.step;
+            const auto count = static_cast<uint32_t>(std::min<uint64_t>(available, frameCount - done));
+            const int16_t *src = sound.frames + (voice.position >> 32U) * sound.channelCount;
+            if (_channelCount == 1) {
+                resampleToMono(sound.frames, sound.channelCount, voice.position, voice.step, gain, gainStep, dst, count);
+            } else if (voice.step == FIXED_ONE && (voice.position & FIXED_FRACTION_MASK) == 0) {
+                copyToStereo(src, sound.channelCount, gain, gainStep, dst, count);
+            } else {
+                resampleToStereo(sound.frames, sound.channelCount, voice.position, voice.step, gain, gainStep, dst, count);
+            }
+            voice.position += voice.step * count;
+            gain += gainStep * static_cast<float>(count);
+            dst += count * _channelCount;
+            done += count;
+            continue;
+        }
+
+        // the last frame interpolates towards the start of a loop, or holds
+        const int16_t *frame = sound.frames + static_cast<size_t>(sound.frameCount - 1) * sound.channelCount;
+        const int16_t *next = voice.loop ? sound.frames : frame;
+        const float t = static_cast<float>(voice.position & FIXED_FRACTION_MASK) * FIXED_FRACTION_SCALE;
+        const float left = lerp(frame[0], next[0], t) * gain * SAMPLE_SCALE;
+        const float right = lerp(frame[sound.channelCount - 1], next[sound.channelCount - 1], t) * gain * SAMPLE_SCALE;
+        if (_channelCount == 1) {
+            dst[0] += (left + right) * 0.5F;
+        } else {
+            dst[0] += left;
+            dst[1] += right;
+        }
+        voice.position += voice.step;
+        gain += gainStep;
+        dst += _channelCount;
+        ++done;
+    }
+
+    voice.gain = voice.volume;
+    return voice.loop || voice.position < end;
+}
+
+bool SoftwareMixer::advanceVoice(Voice &voice, uint32_t frameCount) {
+    const uint64_t end = static_cast<uint64_t>(voice.sound.frameCount) << 32U;
+    voice.position += voice.step * frameCount;
+    // fades in from silence once it is mixed again
+    voice.gain = 0.0F;
+    if (voice.position < end) {
+        return true;
+    }
+    if (!voice.loop) {
+        return false;
+    }
+    voice.position %= end;
+    return true;
+}
+
+void SoftwareMixer::mix(int16_t *out, uint32_t frameCount) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _mixBuffer.assign(static_cast<size_t>(frameCount) * _channelCount, 0.0F);
+
+    _candidates.clear();
+    for (const uint32_t index : _activeVoices) {
+        if (!_voices[index].paused) {
+            _candidates.push_back(index);
+        }
+    }
+
+    // Voices fading out are still mixed, to ramp their gain down to silence.
+    const auto audibleEnd = std::partition(_candidates.begin(), _candidates.end(), [this](uint32_t index) {
+        const auto &voice = _voices[index];
+        return voice.volume > INAUDIBLE_VOLUME || voice.gain > INAUDIBLE_VOLUME;
+    });
+    auto audibleCount = static_cast<uint32_t>(audibleEnd - _candidates.begin());
+    if (audibleCount > _maxAudibleVoices) {
+        audibleCount = _maxAudibleVoices;
+        std::nth_element(_candidates.begin(), _candidates.begin() + audibleCount, audibleEnd, [this](uint32_t a, uint32_t b) {
+            const auto &voiceA = _voices[a];
+            const auto &voiceB = _voices[b];
+            if (voiceA.priority != voiceB.priority) {
+                return voiceA.priority > voiceB.priority;
+            }
+            if (voiceA.volume != voiceB.volume) {
+                return voiceA.volume > voiceB.volume;
+            }
+            return voiceA.order > voiceB.order;
+        });
+    }
+
+    for (uint32_t i = 0; i < _candidates.size(); ++i) {
+        const uint32_t index = _candidates[i];
+        auto &voice = _voices[index];
+        const bool playing = i < audibleCount ? mixVoice(voice, frameCount) : advanceVoice(voice, frameCount);
+        if (!playing) {
+            _finished.push_back((voice.generation << VOICE_INDEX_BITS) | index);
+            releaseVoice(index);
+        }
+    }
+
+    memcpy_to_i16_from_float(out, _mixBuffer.data(), _mixBuffer.size());
+
+    _stats.voices = static_cast<uint32_t>(_activeVoices.size());
+    _stats.audible = audibleCount;
+    _stats.virtualized = static_cast<uint32_t>(_candidates.size()) - audibleCount;
+}
+
+bool NullMixerOutput::start(SoftwareMixer *mixer) {
+    _mixer = mixer;
+    return mixer != nullptr;
+}
+
+void NullMixerOutput::stop() {
+    _mixer = nullptr;
+}
+
+const ccstd::vector<int16_t> &NullMixerOutput::render(uint32_t frameCount) {
+    if (_mixer == nullptr) {
+        _samples.clear();
+        return _samples;
+    }
+    _samples.resize(static_cast<size_t>(frameCount) * _mixer->getChannelCount());
+    _mixer->mix(_samples.data(), frameCount);
+    return _samples;
+}
+
+} // namespace cc
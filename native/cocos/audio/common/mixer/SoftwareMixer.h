@@ -0,0 +1,170 @@
+/****************************************************************************
+ Copyright (c) 2017-2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include "base/Macros.h"
+#include "base/std/container/vector.h"
+
+namespace cc {
+
+/**
+ *  A software mixer of 16 bit PCM sounds into a single output stream.
+ *
+ *  Voices are resampled to the output rate by linear interpolation, with SSE2 or NEON where available,
+ *  and accumulated in floating point. Only the maxAudibleVoices most important voices are mixed in a block:
+ *  the others, and the voices too quiet to hear, are virtual. A virtual voice keeps its play position
+ *  running without being resampled, so it comes back in time when it is important again.
+ *
+ *  Voices are controlled from any thread; mix() is called by the output, usually on its own thread.
+ */
+class CC_DLL SoftwareMixer final {
+public:
+    using VoiceId = uint32_t;
+    static constexpr VoiceId INVALID_VOICE = 0;
+
+    // Interleaved 16 bit frames of one or two channels. They are read in place and must outlive the voices.
+    struct Sound {
+        const int16_t *frames{nullptr};
+        uint32_t frameCount{0};
+        uint32_t channelCount{0};
+        uint32_t sampleRate{0};
+    };
+
+    // voice counts of the last mixed block
+    struct Stats {
+        uint32_t voices{0};
+        uint32_t audible{0};
+        uint32_t virtualized{0};
+    };
+
+    SoftwareMixer(uint32_t sampleRate, uint32_t channelCount, uint32_t maxAudibleVoices);
+    ~SoftwareMixer() = default;
+
+    /**
+     * Starts a voice. Voices of higher priority, then louder ones, then newer ones are mixed first.
+     * @return INVALID_VOICE if the sound is empty or not in a supported layout.
+     */
+    VoiceId play(const Sound &sound, float volume, bool loop, int priority = 0);
+    bool stop(VoiceId id);
+    bool pause(VoiceId id);
+    bool resume(VoiceId id);
+    bool setVolume(VoiceId id, float volume);
+    bool setLoop(VoiceId id, bool loop);
+    // position in seconds of the sound, -1 if the voice is not playing
+    float getTime(VoiceId id) const;
+    bool setTime(VoiceId id, float time);
+    bool isActive(VoiceId id) const;
+
+    // Stops every voice reading frames, e.g. before the sound is freed.
+    void stopSound(const int16_t *frames);
+    void stopAll();
+
+    // Moves the voices that reached the end of their sounds since the last call to finished.
+    void collectFinished(ccstd::vector<VoiceId> &finished);
+
+    // Mixes the next frameCount frames of all voices into out, interleaved in the output channel count.
+    void mix(int16_t *out, uint32_t frameCount);
+
+    inline uint32_t getSampleRate() const { return _sampleRate; }
+    inline uint32_t getChannelCount() const { return _channelCount; }
+    uint32_t getMaxAudibleVoices() const;
+    void setMaxAudibleVoices(uint32_t count);
+    Stats getStats() const;
+
+private:
+    struct Voice {
+        Sound sound;
+        // source frames in 32.32 fixed point
+        uint64_t position{0};
+        uint64_t step{0};
+        float volume{0.0F};
+        // the gain applied at the end of the last mixed block, ramped to volume in the next one
+        float gain{0.0F};
+        int priority{0};
+        uint32_t order{0};
+        uint32_t generation{0};
+        bool active{false};
+        bool loop{false};
+        bool paused{false};
+    };
+
+    Voice *findVoice(VoiceId id);
+    const Voice *findVoice(VoiceId id) const;
+    void releaseVoice(uint32_t index);
+    // resamples frameCount frames into _mixBuffer, false when the voice reached its end
+    bool mixVoice(Voice &voice, uint32_t frameCount);
+    bool advanceVoice(Voice &voice, uint32_t frameCount);
+
+    uint32_t _sampleRate{0};
+    uint32_t _channelCount{0};
+    uint32_t _maxAudibleVoices{0};
+    uint32_t _nextOrder{0};
+
+    ccstd::vector<Voice> _voices;
+    ccstd::vector<uint32_t> _freeVoices;
+    // indices of the voices playing, in no order
+    ccstd::vector<uint32_t> _activeVoices;
+    ccstd::vector<uint32_t> _candidates;
+    ccstd::vector<VoiceId> _finished;
+    ccstd::vector<float> _mixBuffer;
+    Stats _stats;
+
+    mutable std::mutex _mutex;
+
+    CC_DISALLOW_COPY_MOVE_ASSIGN(SoftwareMixer);
+};
+
+/**
+ *  Where the mixed stream goes. The output pulls blocks from the mixer at its own pace.
+ */
+class CC_DLL MixerOutput {
+public:
+    virtual ~MixerOutput() = default;
+
+    virtual bool start(SoftwareMixer *mixer) = 0;
+    virtual void stop() = 0;
+};
+
+/**
+ *  An output without a device: nothing is mixed until render() is called, the way a device callback
+ *  would pull a block. Used to run the mixer offline and in tests.
+ */
+class CC_DLL NullMixerOutput final : public MixerOutput {
+public:
+    bool start(SoftwareMixer *mixer) override;
+    void stop() override;
+
+    // Mixes frameCount frames, the samples stay readable until the next call.
+    const ccstd::vector<int16_t> &render(uint32_t frameCount);
+
+private:
+    SoftwareMixer *_mixer{nullptr};
+    ccstd::vector<int16_t> _samples;
+};
+
+} // namespace cc
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <cstring>
 #include "audio/common/utils/include/primitives.h"
 #include "audio/common/utils/private/private.h"
 #if CC_PLATFORM == CC_PLATFORM_ANDROID
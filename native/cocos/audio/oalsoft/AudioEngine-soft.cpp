@@ -135,8 +135,13 @@ AudioEngineImpl::~AudioEngineImpl() {
         sche->unschedule("AudioEngine", this);
     }
 
+    // The mixer thread reads the pcm data of the caches
+    if (_mixerOutput) {
+        _mixerOutput->stop();
+    }
+
     if (sALContext) {
-        alDeleteSources(MAX_AUDIOINSTANCES, _alSources);
+        alDeleteSources(MAX_AL_SOURCES, _alSources);
 
         _audioCaches.clear();
 
@@ -163,7 +168,7 @@ bool AudioEngineImpl::init() {
             sALContext = alcCreateContext(sALDevice, nullptr);
             alcMakeContextCurrent(sALContext);
 
-            alGenSources(MAX_AUDIOINSTANCES, _alSources);
+            alGenSources(MAX_AL_SOURCES, _alSources);
             auto alError = alGetError();
             if (alError != AL_NO_ERROR) {
                 CC_LOG_ERROR("%s:generating sources failed! error = %x\n", __FUNCTION__, alError);
@@ -174,6 +179,16 @@ bool AudioEngineImpl::init() {
                 _alSourceUsed[src] = false;
             }
 
+            ALCint frequency = 0;
+            alcGetIntegerv(sALDevice, ALC_FREQUENCY, 1, &frequency);
+            _mixer = std::make_unique<SoftwareMixer>(frequency > 0 ? frequency : 44100, 2, MAX_AUDIBLE_VOICES);
+            _mixerOutput = std::make_unique<OpenALMixerOutput>();
+            if (!_mixerOutput->start(_mixer.get())) {
+                CC_LOG_WARNING("%s: software mixer isn't available, every sound plays on its own source", __FUNCTION__);
+                _mixerOutput.reset();
+                _mixer.reset();
+            }
+
             _scheduler = CC_CURRENT_ENGINE()->getScheduler();
             ret = AudioDecoderManager::init();
             CC_LOG_DEBUG("OpenAL was initialized successfully!");
@@ -215,6 +230,50 @@ int AudioEngineImpl::play2d(const ccstd::string &filePath, bool loop, float volu
         return AudioEngine::INVALID_AUDIO_ID;
     }
 
+    auto audioCache = preload(filePath, nullptr);
+    if (audioCache == nullptr) {
+        return AudioEngine::INVALID_AUDIO_ID;
+    }
+
+    // A cache still loading may turn out to be streamed, it then falls back to a source in onMixerCacheReady.
+    if (_mixer && (audioCache->_state != AudioCache::State::READY || canMix(audioCache))) {
+        const int audioID = _currentAudioID;
+        auto &playback = _mixerPlaybacks[audioID];
+        playback.cache = audioCache;
+        playback.loop = loop;
+        playback.volume = volume;
+
+        if (audioCache->_state == AudioCache::State::READY) {
+            if (!startMixerVoice(audioID, playback)) {
+                _mixerPlaybacks.erase(audioID);
+                return AudioEngine::INVALID_AUDIO_ID;
+            }
+        } else {
+            auto isCacheDestroyed = audioCache->_isDestroyed;
+            audioCache->addPlayCallback([this, audioID, isCacheDestroyed]() {
+                //Note: It may be in sub thread, the playbacks are only touched in Cocos thread.
+                if (auto sche = _scheduler.lock()) {
+                    sche->performFunctionInCocosThread([this, audioID, isCacheDestroyed]() {
+                        if (!*isCacheDestroyed) {
+                            onMixerCacheReady(audioID);
+                        }
+                    });
+                }
+            });
+        }
+
+        scheduleUpdate();
+        return _currentAudioID++;
+    }
+
+    const int audioID = play2dWithSource(audioCache, _currentAudioID, loop, volume);
+    if (audioID != AudioEngine::INVALID_AUDIO_ID) {
+        ++_currentAudioID;
+    }
+    return audioID;
+}
+
+int AudioEngineImpl::play2dWithSource(AudioCache *audioCache, int audioID, bool loop, float volume) {
     bool sourceFlag = false;
     ALuint alSource = 0;
     for (unsigned int src : _alSources) {
@@ -238,29 +297,104 @@ int AudioEngineImpl::play2d(const ccstd::string &filePath, bool loop, float volu
     player->_loop = loop;
     player->_volume = volume;
 
-    auto audioCache = preload(filePath, nullptr);
-    if (audioCache == nullptr) {
-        delete player;
-        return AudioEngine::INVALID_AUDIO_ID;
-    }
-
     player->setCache(audioCache);
     _threadMutex.lock();
-    _audioPlayers[_currentAudioID] = player;
+    _audioPlayers[audioID] = player;
     _threadMutex.unlock();
 
     _alSourceUsed[alSource] = true;
 
-    audioCache->addPlayCallback(std::bind(&AudioEngineImpl::play2dImpl, this, audioCache, _currentAudioID));
+    audioCache->addPlayCallback(std::bind(&AudioEngineImpl::play2dImpl, this, audioCache, audioID));
 
+    scheduleUpdate();
+
+    return audioID;
+}
+
+void AudioEngineImpl::scheduleUpdate() {
     if (_lazyInitLoop) {
         _lazyInitLoop = false;
         if (auto sche = _scheduler.lock()) {
             sche->schedule(CC_CALLBACK_1(AudioEngineImpl::update, this), this, 0.05F, false, "AudioEngine");
         }
     }
+}
+
+bool AudioEngineImpl::canMix(const AudioCache *cache) const {
+    return cache->_state == AudioCache::State::READY && !cache->isStreaming() && cache->_pcmData != nullptr &&
+           cache->_channelCount <= 2 && cache->_bytesPerFrame == cache->_channelCount * sizeof(int16_t);
+}
+
+bool AudioEngineImpl::startMixerVoice(int audioID, MixerPlayback &playback) {
+    const auto *cache = playback.cache;
+    SoftwareMixer::Sound sound;
+    sound.frames = reinterpret_cast<const int16_t *>(cache->_pcmData);
+    sound.frameCount = cache->_totalFrames;
+    sound.channelCount = cache->_channelCount;
+    sound.sampleRate = static_cast<uint32_t>(cache->_sampleRate);
+
+    playback.voice = _mixer->play(sound, playback.volume, playback.loop);
+    if (playback.voice == SoftwareMixer::INVALID_VOICE) {
+        return false;
+    }
+    if (playback.startTime > 0.0F) {
+        _mixer->setTime(playback.voice, playback.startTime);
+    }
+    _voiceAudioIDs[playback.voice] = audioID;
+    return true;
+}
+
+void AudioEngineImpl::onMixerCacheReady(int audioID) {
+    auto it = _mixerPlaybacks.find(audioID);
+    if (it == _mixerPlaybacks.end() || it->second.voice != SoftwareMixer::INVALID_VOICE) {
+        return;
+    }
+
+    auto &playback = it->second;
+    auto *cache = playback.cache;
+    if (cache->_state != AudioCache::State::READY) {
+        CC_LOG_DEBUG("AudioEngineImpl::onMixerCacheReady, cache isn't ready!");
+        _mixerPlaybacks.erase(it);
+        AudioEngine::remove(audioID);
+        return;
+    }
+
+    if (!canMix(cache)) {
+        const auto startTime = playback.startTime;
+        auto finishCallback = std::move(playback.finishCallback);
+        const bool loop = playback.loop;
+        const float volume = playback.volume;
+        _mixerPlaybacks.erase(it);
+
+        if (play2dWithSource(cache, audioID, loop, volume) == AudioEngine::INVALID_AUDIO_ID) {
+            CC_LOG_INFO("Fail to play %s cause by no free OpenAL source", cache->_fileFullPath.c_str());
+            AudioEngine::remove(audioID);
+            return;
+        }
+        if (startTime > 0.0F) {
+            setCurrentTime(audioID, startTime);
+        }
+        setFinishCallback(audioID, finishCallback);
+        return;
+    }
+
+    // A paused playback starts in resume
+    if (!playback.paused && !startMixerVoice(audioID, playback)) {
+        _mixerPlaybacks.erase(it);
+        AudioEngine::remove(audioID);
+    }
+}
 
-    return _currentAudioID++;
+void AudioEngineImpl::removeMixerPlayback(int audioID) {
+    auto it = _mixerPlaybacks.find(audioID);
+    if (it == _mixerPlaybacks.end()) {
+        return;
+    }
+    if (it->second.voice != SoftwareMixer::INVALID_VOICE) {
+        _mixer->stop(it->second.voice);
+        _voiceAudioIDs.erase(it->second.voice);
+    }
+    _mixerPlaybacks.erase(it);
 }
 
 void AudioEngineImpl::play2dImpl(AudioCache *cache, int audioID) {
@@ -288,6 +422,14 @@ void AudioEngineImpl::play2dImpl(AudioCache *cache, int audioID) {
 }
 
 void AudioEngineImpl::setVolume(int audioID, float volume) {
+    auto mixerIt = _mixerPlaybacks.find(audioID);
+    if (mixerIt != _mixerPlaybacks.end()) {
+        mixerIt->second.volume = volume;
+        if (mixerIt->second.voice != SoftwareMixer::INVALID_VOICE) {
+            _mixer->setVolume(mixerIt->second.voice, volume);
+        }
+        return;
+    }
     if (!checkAudioIdValid(audioID)) {
         return;
     }
@@ -305,6 +447,14 @@ void AudioEngineImpl::setVolume(int audioID, float volume) {
 }
 
 void AudioEngineImpl::setLoop(int audioID, bool loop) {
+    auto mixerIt = _mixerPlaybacks.find(audioID);
+    if (mixerIt != _mixerPlaybacks.end()) {
+        mixerIt->second.loop = loop;
+        if (mixerIt->second.voice != SoftwareMixer::INVALID_VOICE) {
+            _mixer->setLoop(mixerIt->second.voice, loop);
+        }
+        return;
+    }
     if (!checkAudioIdValid(audioID)) {
         return;
     }
@@ -331,6 +481,14 @@ void AudioEngineImpl::setLoop(int audioID, bool loop) {
 }
 
 bool AudioEngineImpl::pause(int audioID) {
+    auto mixerIt = _mixerPlaybacks.find(audioID);
+    if (mixerIt != _mixerPlaybacks.end()) {
+        mixerIt->second.paused = true;
+        if (mixerIt->second.voice != SoftwareMixer::INVALID_VOICE) {
+            return _mixer->pause(mixerIt->second.voice);
+        }
+        return true;
+    }
     if (!checkAudioIdValid(audioID)) {
         return false;
     }
@@ -347,6 +505,19 @@ bool AudioEngineImpl::pause(int audioID) {
 }
 
 bool AudioEngineImpl::resume(int audioID) {
+    auto mixerIt = _mixerPlaybacks.find(audioID);
+    if (mixerIt != _mixerPlaybacks.end()) {
+        auto &playback = mixerIt->second;
+        playback.paused = false;
+        if (playback.voice != SoftwareMixer::INVALID_VOICE) {
+            return _mixer->resume(playback.voice);
+        }
+        // paused before its cache was ready
+        if (playback.cache->_state == AudioCache::State::READY) {
+            return startMixerVoice(audioID, playback);
+        }
+        return true;
+    }
     if (!checkAudioIdValid(audioID)) {
         return false;
     }
@@ -363,6 +534,10 @@ bool AudioEngineImpl::resume(int audioID) {
 }
 
 void AudioEngineImpl::stop(int audioID) {
+    if (_mixerPlaybacks.find(audioID) != _mixerPlaybacks.end()) {
+        removeMixerPlayback(audioID);
+        return;
+    }
     if (!checkAudioIdValid(audioID)) {
         return;
     }
@@ -377,12 +552,18 @@ void AudioEngineImpl::stop(int audioID) {
 }
 
 void AudioEngineImpl::stopAll() {
+    if (_mixer) {
+        _mixer->stopAll();
+    }
+    _mixerPlaybacks.clear();
+    _voiceAudioIDs.clear();
+
     for (auto &&player : _audioPlayers) {
         player.second->destroy();
     }
     //Note: Don't set the flag to false here, it should be set in 'update' function.
     // Otherwise, the state got from alSourceState may be wrong
-    //    for(int index = 0; index < MAX_AUDIOINSTANCES; ++index)
+    //    for(int index = 0; index < MAX_AL_SOURCES; ++index)
     //    {
     //        _alSourceUsed[_alSources[index]] = false;
     //    }
@@ -392,6 +573,11 @@ void AudioEngineImpl::stopAll() {
 }
 
 float AudioEngineImpl::getDuration(int audioID) {
+    auto mixerIt = _mixerPlaybacks.find(audioID);
+    if (mixerIt != _mixerPlaybacks.end()) {
+        const auto *cache = mixerIt->second.cache;
+        return cache->_state == AudioCache::State::READY ? cache->_duration : AudioEngine::TIME_UNKNOWN;
+    }
     if (!checkAudioIdValid(audioID)) {
         return 0.0F;
     }
@@ -413,6 +599,13 @@ float AudioEngineImpl::getDurationFromFile(const ccstd::string &filePath) {
 }
 
 float AudioEngineImpl::getCurrentTime(int audioID) {
+    auto mixerIt = _mixerPlaybacks.find(audioID);
+    if (mixerIt != _mixerPlaybacks.end()) {
+        if (mixerIt->second.voice != SoftwareMixer::INVALID_VOICE) {
+            return std::max(_mixer->getTime(mixerIt->second.voice), 0.0F);
+        }
+        return mixerIt->second.startTime;
+    }
     if (!checkAudioIdValid(audioID)) {
         return 0.0F;
     }
@@ -435,6 +628,14 @@ float AudioEngineImpl::getCurrentTime(int audioID) {
 }
 
 bool AudioEngineImpl::setCurrentTime(int audioID, float time) {
+    auto mixerIt = _mixerPlaybacks.find(audioID);
+    if (mixerIt != _mixerPlaybacks.end()) {
+        if (mixerIt->second.voice != SoftwareMixer::INVALID_VOICE) {
+            return _mixer->setTime(mixerIt->second.voice, time);
+        }
+        mixerIt->second.startTime = time;
+        return true;
+    }
     if (!checkAudioIdValid(audioID)) {
         return false;
     }
@@ -474,6 +675,11 @@ bool AudioEngineImpl::setCurrentTime(int audioID, float time) {
 }
 
 void AudioEngineImpl::setFinishCallback(int audioID, const std::function<void(int, const ccstd::string &)> &callback) {
+    auto mixerIt = _mixerPlaybacks.find(audioID);
+    if (mixerIt != _mixerPlaybacks.end()) {
+        mixerIt->second.finishCallback = callback;
+        return;
+    }
     if (!checkAudioIdValid(audioID)) {
         return;
     }
@@ -488,6 +694,41 @@ void AudioEngineImpl::update(float /*dt*/) {
 
     //    ALOGV("AudioPlayer count: %d", (int)_audioPlayers.size());
 
+    if (_mixer) {
+        // A finish callback may play or stop sounds, so don't keep iterators into the playbacks.
+        ccstd::vector<SoftwareMixer::VoiceId> finishedVoices;
+        _mixer->collectFinished(finishedVoices);
+        for (auto voice : finishedVoices) {
+            auto voiceIt = _voiceAudioIDs.find(voice);
+            if (voiceIt == _voiceAudioIDs.end()) {
+                continue;
+            }
+            audioID = voiceIt->second;
+            _voiceAudioIDs.erase(voiceIt);
+
+            auto mixerIt = _mixerPlaybacks.find(audioID);
+            if (mixerIt == _mixerPlaybacks.end()) {
+                continue;
+            }
+            auto finishCallback = std::move(mixerIt->second.finishCallback);
+            _mixerPlaybacks.erase(mixerIt);
+
+            ccstd::string filePath;
+            if (finishCallback) {
+                auto infoIt = AudioEngine::sAudioIDInfoMap.find(audioID);
+                if (infoIt != AudioEngine::sAudioIDInfoMap.end()) {
+                    filePath = *infoIt->second.filePath;
+                }
+            }
+
+            AudioEngine::remove(audioID);
+
+            if (finishCallback) {
+                finishCallback(audioID, filePath);
+            }
+        }
+    }
+
     for (auto it = _audioPlayers.begin(); it != _audioPlayers.end();) {
         audioID = it->first;
         player = it->second;
@@ -524,7 +765,7 @@ void AudioEngineImpl::update(float /*dt*/) {
         }
     }
 
-    if (_audioPlayers.empty()) {
+    if (_audioPlayers.empty() && _mixerPlaybacks.empty()) {
         _lazyInitLoop = true;
         if (auto sche = _scheduler.lock()) {
             sche->unschedule("AudioEngine", this);
@@ -533,10 +774,21 @@ void AudioEngineImpl::update(float /*dt*/) {
 }
 
 void AudioEngineImpl::uncache(const ccstd::string &filePath) {
-    _audioCaches.erase(filePath);
+    auto it = _audioCaches.find(filePath);
+    if (it == _audioCaches.end()) {
+        return;
+    }
+    // The instances were stopped, make sure no voice still reads the pcm data
+    if (_mixer && it->second._pcmData != nullptr) {
+        _mixer->stopSound(reinterpret_cast<const int16_t *>(it->second._pcmData));
+    }
+    _audioCaches.erase(it);
 }
 
 void AudioEngineImpl::uncacheAll() {
+    if (_mixer) {
+        _mixer->stopAll();
+    }
     _audioCaches.clear();
 }
 
@@ -26,9 +26,12 @@
 #pragma once
 
 #include <stdint.h>
+#include <memory>
+#include "audio/common/mixer/SoftwareMixer.h"
 #include "audio/include/AudioDef.h"
 #include "audio/oalsoft/AudioCache.h"
 #include "audio/oalsoft/AudioPlayer.h"
+#include "audio/oalsoft/OpenALMixerOutput.h"
 #include "base/std/container/unordered_map.h"
 #include "cocos/base/RefCounted.h"
 #include "cocos/base/std/any.h"
@@ -37,7 +40,12 @@ namespace cc {
 
 class Scheduler;
 
-#define MAX_AUDIOINSTANCES 32
+// Sounds fully decoded in memory are mixed in software, so many more instances than OpenAL sources can play.
+#define MAX_AUDIOINSTANCES 512
+// sources for streamed sounds, or for every sound when the software mixer isn't available
+#define MAX_AL_SOURCES 32
+// voices mixed in a block, the quieter and less important ones are virtual
+#define MAX_AUDIBLE_VOICES 64
 
 class CC_DLL AudioEngineImpl : public RefCounted {
 public:
@@ -66,10 +74,27 @@ public:
     ccstd::vector<uint8_t> getOriginalPCMBuffer(const char *url, uint32_t channelID);
 
 private:
+    // an instance played by the software mixer, voice stays INVALID_VOICE until its cache is ready
+    struct MixerPlayback {
+        AudioCache *cache{nullptr};
+        SoftwareMixer::VoiceId voice{SoftwareMixer::INVALID_VOICE};
+        float volume{1.0F};
+        float startTime{0.0F};
+        bool loop{false};
+        bool paused{false};
+        std::function<void(int, const ccstd::string &)> finishCallback;
+    };
+
     bool checkAudioIdValid(int audioID);
     void play2dImpl(AudioCache *cache, int audioID);
+    int play2dWithSource(AudioCache *cache, int audioID, bool loop, float volume);
+    bool canMix(const AudioCache *cache) const;
+    bool startMixerVoice(int audioID, MixerPlayback &playback);
+    void onMixerCacheReady(int audioID);
+    void removeMixerPlayback(int audioID);
+    void scheduleUpdate();
 
-    ALuint _alSources[MAX_AUDIOINSTANCES];
+    ALuint _alSources[MAX_AL_SOURCES];
 
     //source,used
     ccstd::unordered_map<ALuint, bool> _alSourceUsed;
@@ -81,6 +106,13 @@ private:
     ccstd::unordered_map<int, AudioPlayer *> _audioPlayers;
     std::mutex _threadMutex;
 
+    std::unique_ptr<SoftwareMixer> _mixer;
+    std::unique_ptr<OpenALMixerOutput> _mixerOutput;
+    //audioID,MixerPlayback
+    ccstd::unordered_map<int, MixerPlayback> _mixerPlaybacks;
+    //voice,audioID
+    ccstd::unordered_map<SoftwareMixer::VoiceId, int> _voiceAudioIDs;
+
     bool _lazyInitLoop;
 
     int _currentAudioID;
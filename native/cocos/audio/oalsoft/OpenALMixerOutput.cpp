@@ -0,0 +1,132 @@
+/****************************************************************************
+ Copyright (c) 2017-2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+
+#define LOG_TAG "OpenALMixerOutput"
+
+#include "audio/oalsoft/OpenALMixerOutput.h"
+#include <chrono>
+#include "audio/include/AudioMacros.h"
+#include "base/Log.h"
+
+namespace cc {
+
+OpenALMixerOutput::~OpenALMixerOutput() {
+    stop();
+}
+
+bool OpenALMixerOutput::start(SoftwareMixer *mixer) {
+    if (_running || mixer == nullptr || mixer->getChannelCount() == 0 || mixer->getChannelCount() > 2) {
+        return false;
+    }
+
+    alGetError();
+    alGenSources(1, &_alSource);
+    auto alError = alGetError();
+    if (alError != AL_NO_ERROR) {
+        ALOGE("%s: generating source failed! error = %x", __FUNCTION__, alError);
+        return false;
+    }
+    alGenBuffers(MIXER_BUFFER_COUNT, _bufferIds);
+    alError = alGetError();
+    if (alError != AL_NO_ERROR) {
+        ALOGE("%s: generating buffers failed! error = %x", __FUNCTION__, alError);
+        alDeleteSources(1, &_alSource);
+        return false;
+    }
+
+    _mixer = mixer;
+    _format = mixer->getChannelCount() > 1 ? AL_FORMAT_STEREO16 : AL_FORMAT_MONO16;
+    _samples.resize(static_cast<size_t>(MIXER_BUFFER_FRAMES) * mixer->getChannelCount());
+
+    alSourcef(_alSource, AL_GAIN, 1.0F);
+    alSourcei(_alSource, AL_LOOPING, AL_FALSE);
+    for (auto buffer : _bufferIds) {
+        queueBuffer(buffer);
+    }
+    alSourcePlay(_alSource);
+    CHECK_AL_ERROR_DEBUG();
+
+    _running = true;
+    _thread = std::thread(&OpenALMixerOutput::mixThread, this);
+    return true;
+}
+
+void OpenALMixerOutput::stop() {
+    if (!_running) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _running = false;
+    }
+    _sleepCondition.notify_one();
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+
+    alSourceStop(_alSource);
+    alSourcei(_alSource, AL_BUFFER, 0);
+    alDeleteSources(1, &_alSource);
+    alDeleteBuffers(MIXER_BUFFER_COUNT, _bufferIds);
+    CHECK_AL_ERROR_DEBUG();
+    _alSource = 0;
+    _mixer = nullptr;
+}
+
+void OpenALMixerOutput::queueBuffer(ALuint buffer) {
+    _mixer->mix(_samples.data(), MIXER_BUFFER_FRAMES);
+    alBufferData(buffer, _format, _samples.data(), static_cast<ALsizei>(_samples.size() * sizeof(int16_t)),
+                 static_cast<ALsizei>(_mixer->getSampleRate()));
+    alSourceQueueBuffers(_alSource, 1, &buffer);
+    CHECK_AL_ERROR_DEBUG();
+}
+
+void OpenALMixerOutput::mixThread() {
+    // wake up twice per buffer, so a played buffer is refilled long before the queue runs dry
+    const auto sleepTime = std::chrono::microseconds(500000ULL * MIXER_BUFFER_FRAMES / _mixer->getSampleRate());
+
+    std::unique_lock<std::mutex> lock(_sleepMutex);
+    while (_running) {
+        ALint processed = 0;
+        alGetSourcei(_alSource, AL_BUFFERS_PROCESSED, &processed);
+        while (processed-- > 0) {
+            ALuint buffer = 0;
+            alSourceUnqueueBuffers(_alSource, 1, &buffer);
+            queueBuffer(buffer);
+        }
+
+        // the source stops when every queued buffer was played before being refilled
+        ALint state = AL_STOPPED;
+        alGetSourcei(_alSource, AL_SOURCE_STATE, &state);
+        if (state != AL_PLAYING) {
+            alSourcePlay(_alSource);
+        }
+
+        _sleepCondition.wait_for(lock, sleepTime, [this]() { return !_running; });
+    }
+}
+
+} // namespace cc
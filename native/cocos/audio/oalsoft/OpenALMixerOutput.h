@@ -0,0 +1,80 @@
+/****************************************************************************
+ Copyright (c) 2017-2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#ifdef OPENAL_PLAIN_INCLUDES
+    #include <al.h>
+#elif CC_PLATFORM == CC_PLATFORM_WINDOWS
+    #include <OpenalSoft/al.h>
+#elif CC_PLATFORM == CC_PLATFORM_OHOS
+    #include <AL/al.h>
+#elif CC_PLATFORM == CC_PLATFORM_LINUX || CC_PLATFORM == CC_PLATFORM_QNX
+    #include <AL/al.h>
+#endif
+#include "audio/common/mixer/SoftwareMixer.h"
+#include "base/std/container/vector.h"
+
+namespace cc {
+
+/**
+ *  Streams the mixer through one OpenAL source: a thread keeps MIXER_BUFFER_COUNT buffers of
+ *  MIXER_BUFFER_FRAMES frames queued, mixing a block for every buffer the source has played.
+ *  The mixer must have 1 or 2 channels.
+ */
+class CC_DLL OpenALMixerOutput final : public MixerOutput {
+public:
+    static constexpr uint32_t MIXER_BUFFER_COUNT = 4;
+    static constexpr uint32_t MIXER_BUFFER_FRAMES = 1024;
+
+    OpenALMixerOutput() = default;
+    ~OpenALMixerOutput() override;
+
+    bool start(SoftwareMixer *mixer) override;
+    void stop() override;
+
+private:
+    void queueBuffer(ALuint buffer);
+    void mixThread();
+
+    SoftwareMixer *_mixer{nullptr};
+    ALuint _alSource{0};
+    ALuint _bufferIds[MIXER_BUFFER_COUNT]{};
+    ALenum _format{0};
+    ccstd::vector<int16_t> _samples;
+
+    std::thread _thread;
+    std::condition_variable _sleepCondition;
+    std::mutex _sleepMutex;
+    std::atomic<bool> _running{false};
+
+    CC_DISALLOW_COPY_MOVE_ASSIGN(OpenALMixerOutput);
+};
+
+} // namespace cc
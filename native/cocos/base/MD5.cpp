@@ -0,0 +1,151 @@
+/****************************************************************************
+ Copyright (c) 2017-2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+
+#include "base/MD5.h"
+#include <algorithm>
+#include <cstring>
+
+namespace cc {
+
+namespace {
+
+// per round shift amounts and sine derived constants of RFC 1321
+constexpr uint32_t SHIFTS[64] = {
+    7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+    5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20,
+    4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+    6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21};
+
+constexpr uint32_t SINES[64] = {
+    0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+    0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+    0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+    0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+    0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+    0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+    0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+    0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391};
+
+inline uint32_t rotateLeft(uint32_t value, uint32_t bits) {
+    return (value << bits) | (value >> (32 - bits));
+}
+
+} // namespace
+
+MD5::MD5()
+: _state{0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476} {
+}
+
+void MD5::update(const void *data, size_t size) {
+    if (_finished) {
+        return;
+    }
+    const auto *bytes = static_cast<const uint8_t *>(data);
+    auto buffered = static_cast<size_t>(_size % 64);
+    _size += size;
+
+    if (buffered > 0) {
+        const size_t count = std::min(size, 64 - buffered);
+        memcpy(_buffer + buffered, bytes, count);
+        bytes += count;
+        size -= count;
+        buffered += count;
+        if (buffered < 64) {
+            return;
+        }
+        transform(_buffer);
+    }
+    for (; size >= 64; bytes += 64, size -= 64) {
+        transform(bytes);
+    }
+    memcpy(_buffer, bytes, size);
+}
+
+ccstd::string MD5::hexDigest() {
+    if (!_finished) {
+        // pad to 56 bytes modulo 64, then append the bit length
+        const uint64_t bitSize = _size * 8;
+        uint8_t padding[72] = {0x80};
+        const auto buffered = static_cast<size_t>(_size % 64);
+        const size_t paddingSize = buffered < 56 ? 56 - buffered : 120 - buffered;
+        for (uint32_t i = 0; i < 8; ++i) {
+            padding[paddingSize + i] = static_cast<uint8_t>(bitSize >> (i * 8));
+        }
+        update(padding, paddingSize + 8);
+        for (uint32_t i = 0; i < 16; ++i) {
+            _digest[i] = static_cast<uint8_t>(_state[i / 4] >> ((i % 4) * 8));
+        }
+        _finished = true;
+    }
+
+    static const char HEX[] = "0123456789abcdef";
+    ccstd::string result(32, '0');
+    for (uint32_t i = 0; i < 16; ++i) {
+        result[i * 2] = HEX[_digest[i] >> 4];
+        result[i * 2 + 1] = HEX[_digest[i] & 0xf];
+    }
+    return result;
+}
+
+void MD5::transform(const uint8_t *block) {
+    uint32_t words[16];
+    for (uint32_t i = 0; i < 16; ++i) {
+        words[i] = static_cast<uint32_t>(block[i * 4]) | (static_cast<uint32_t>(block[i * 4 + 1]) << 8) |
+                   (static_cast<uint32_t>(block[i * 4 + 2]) << 16) | (static_cast<uint32_t>(block[i * 4 + 3]) << 24);
+    }
+
+    uint32_t a = _state[0];
+    uint32_t b = _state[1];
+    uint32_t c = _state[2];
+    uint32_t d = _state[3];
+    for (uint32_t i = 0; i < 64; ++i) {
+        uint32_t f = 0;
+        uint32_t g = 0;
+        if (i < 16) {
+            f = (b & c) | (~b & d);
+            g = i;
+        } else if (i < 32) {
+            f = (d & b) | (~d & c);
+            g = (5 * i + 1) % 16;
+        } else if (i < 48) {
+            f = b ^ c ^ d;
+            g = (3 * i + 5) % 16;
+        } else {
+            f = c ^ (b | ~d);
+            g = (7 * i) % 16;
+        }
+        const uint32_t next = d;
+        d = c;
+        c = b;
+        b = b + rotateLeft(a + f + SINES[i] + words[g], SHIFTS[i]);
+        a = next;
+    }
+    _state[0] += a;
+    _state[1] += b;
+    _state[2] += c;
+    _state[3] += d;
+}
+
+} // namespace cc
@@ -0,0 +1,60 @@
+/****************************************************************************
+ Copyright (c) 2017-2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "base/Macros.h"
+#include "base/std/container/string.h"
+
+namespace cc {
+
+/**
+ *  Computes the MD5 digest of data received in pieces, e.g. a file while it is downloaded.
+ */
+class CC_DLL MD5 final {
+public:
+    MD5();
+
+    void update(const void *data, size_t size);
+
+    /**
+     *  Finishes the digest on the first call, later updates are ignored.
+     *  @return the digest as 32 lower case hex characters.
+     */
+    ccstd::string hexDigest();
+
+private:
+    void transform(const uint8_t *block);
+
+    uint32_t _state[4];
+    uint64_t _size{0};
+    uint8_t _buffer[64];
+    uint8_t _digest[16];
+    bool _finished{false};
+};
+
+} // namespace cc
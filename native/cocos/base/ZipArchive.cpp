@@ -0,0 +1,509 @@
+/****************************************************************************
+ Copyright (c) 2017-2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+
+#include "base/ZipArchive.h"
+
+#include <sys/stat.h>
+#include <zlib.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <utility>
+#include "base/Log.h"
+#include "base/job-system/JobSystem.h"
+#include "base/memory/Memory.h"
+#include "platform/FileUtils.h"
+
+#if (CC_PLATFORM != CC_PLATFORM_WINDOWS) && (CC_PLATFORM != CC_PLATFORM_WINRT)
+    #include <fcntl.h>
+    #include <unistd.h>
+    #define CC_ZIP_ARCHIVE_STREAMED 1
+#endif
+
+namespace cc {
+
+namespace {
+
+constexpr uint32_t END_OF_CENTRAL_DIRECTORY_SIGNATURE = 0x06054b50;
+constexpr uint32_t ZIP64_END_OF_CENTRAL_DIRECTORY_SIGNATURE = 0x06064b50;
+constexpr uint32_t ZIP64_END_OF_CENTRAL_DIRECTORY_LOCATOR_SIGNATURE = 0x07064b50;
+constexpr uint32_t CENTRAL_DIRECTORY_HEADER_SIGNATURE = 0x02014b50;
+constexpr uint32_t LOCAL_FILE_HEADER_SIGNATURE = 0x04034b50;
+
+constexpr uint32_t END_OF_CENTRAL_DIRECTORY_SIZE = 22;
+constexpr uint32_t ZIP64_END_OF_CENTRAL_DIRECTORY_SIZE = 56;
+constexpr uint32_t ZIP64_END_OF_CENTRAL_DIRECTORY_LOCATOR_SIZE = 20;
+constexpr uint32_t CENTRAL_DIRECTORY_HEADER_SIZE = 46;
+constexpr uint32_t LOCAL_FILE_HEADER_SIZE = 30;
+constexpr uint32_t MAX_COMMENT_SIZE = 0xffff;
+constexpr uint16_t ZIP64_EXTRA_FIELD_ID = 0x0001;
+
+constexpr uint16_t METHOD_STORED = 0;
+constexpr uint16_t METHOD_DEFLATED = 8;
+
+// below this much compressed data the job system costs more than it saves
+constexpr uint64_t PARALLEL_INFLATE_MIN_BYTES = 256 * 1024;
+
+inline uint16_t readU16(const uint8_t *p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+inline uint32_t readU32(const uint8_t *p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline uint64_t readU64(const uint8_t *p) {
+    return static_cast<uint64_t>(readU32(p)) | (static_cast<uint64_t>(readU32(p + 4)) << 32);
+}
+
+// what a mounted archive was indexed from, a file replaced since then is indexed again
+struct FileStamp {
+    int64_t size{-1};
+    int64_t mtime{0};
+
+    bool operator==(const FileStamp &rhs) const { return size == rhs.size && mtime == rhs.mtime; }
+};
+
+// size is -1 for paths that are not native files, e.g. assets inside the apk
+FileStamp statFile(const ccstd::string &path) {
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) {
+        return {};
+    }
+    return {static_cast<int64_t>(info.st_size), static_cast<int64_t>(info.st_mtime)};
+}
+
+struct MountedArchive {
+    IntrusivePtr<ZipArchive> archive;
+    FileStamp stamp;
+};
+
+std::mutex gMountMutex;
+ccstd::unordered_map<ccstd::string, MountedArchive> gMountedArchives;
+
+} // namespace
+
+IntrusivePtr<ZipArchive> ZipArchive::mount(const ccstd::string &path) {
+    const FileStamp stamp = statFile(path);
+    std::lock_guard<std::mutex> lock(gMountMutex);
+    auto iter = gMountedArchives.find(path);
+    if (iter != gMountedArchives.end()) {
+        if (iter->second.stamp == stamp) {
+            return iter->second.archive;
+        }
+        gMountedArchives.erase(iter);
+    }
+
+    IntrusivePtr<ZipArchive> archive;
+    if (stamp.size >= 0) {
+        // a file that cannot be mapped (e.g. a large OBB) is read on demand rather than copied into the heap
+        auto file = MappedFile::open(path, true);
+        archive = file ? create(std::move(file)) : openStreamed(path);
+    }
+#if CC_ZIP_ARCHIVE_STREAMED
+    if (!archive && stamp.size < 0) {
+#else
+    if (!archive) {
+#endif
+        // paths that are not plain native files (e.g. in the apk) are read through FileUtils
+        auto *fs = FileUtils::getInstance();
+        if (fs) {
+            archive = create(fs->mapFile(path));
+        }
+    }
+    if (archive) {
+        gMountedArchives[path] = {archive, stamp};
+    }
+    return archive;
+}
+
+void ZipArchive::unmount(const ccstd::string &path) {
+    std::lock_guard<std::mutex> lock(gMountMutex);
+    gMountedArchives.erase(path);
+}
+
+void ZipArchive::unmountDirectory(const ccstd::string &directory) {
+    if (directory.empty()) {
+        return;
+    }
+    const bool hasSeparator = directory.back() == '/' || directory.back() == '\\';
+    std::lock_guard<std::mutex> lock(gMountMutex);
+    for (auto iter = gMountedArchives.begin(); iter != gMountedArchives.end();) {
+        const ccstd::string &path = iter->first;
+        const bool below = path.size() > directory.size() && path.compare(0, directory.size(), directory) == 0 &&
+                           (hasSeparator || path[directory.size()] == '/' || path[directory.size()] == '\\');
+        iter = below ? gMountedArchives.erase(iter) : std::next(iter);
+    }
+}
+
+void ZipArchive::unmountAll() {
+    std::lock_guard<std::mutex> lock(gMountMutex);
+    gMountedArchives.clear();
+}
+
+IntrusivePtr<ZipArchive> ZipArchive::create(IntrusivePtr<MappedFile> file) {
+    if (!file) {
+        return nullptr;
+    }
+    IntrusivePtr<ZipArchive> archive{ccnew ZipArchive(std::move(file))};
+    if (!archive->readCentralDirectory()) {
+        return nullptr;
+    }
+    return archive;
+}
+
+IntrusivePtr<ZipArchive> ZipArchive::openStreamed(const ccstd::string &path) {
+#if CC_ZIP_ARCHIVE_STREAMED
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        return nullptr;
+    }
+    struct stat info;
+    if (fstat(fd, &info) == -1 || !S_ISREG(info.st_mode)) {
+        ::close(fd);
+        return nullptr;
+    }
+    IntrusivePtr<ZipArchive> archive{ccnew ZipArchive(fd, static_cast<uint64_t>(info.st_size))};
+    if (!archive->readCentralDirectory()) {
+        return nullptr;
+    }
+    return archive;
+#else
+    CC_UNUSED_PARAM(path);
+    return nullptr;
+#endif
+}
+
+ZipArchive::ZipArchive(IntrusivePtr<MappedFile> &&file)
+: _file(std::move(file)) {
+    _size = _file->getSize();
+}
+
+ZipArchive::ZipArchive(int fd, uint64_t size)
+: _fd(fd),
+  _size(size) {
+}
+
+ZipArchive::~ZipArchive() {
+#if CC_ZIP_ARCHIVE_STREAMED
+    if (_fd != -1) {
+        ::close(_fd);
+    }
+#endif
+}
+
+const uint8_t *ZipArchive::readRange(uint64_t offset, uint64_t length, ccstd::vector<uint8_t> *scratch) const {
+    if (offset > _size || length > _size - offset) {
+        return nullptr;
+    }
+    if (_file) {
+        return _file->getBytes() + offset;
+    }
+#if CC_ZIP_ARCHIVE_STREAMED
+    scratch->resize(static_cast<size_t>(length));
+    uint64_t done = 0;
+    while (done < length) {
+        const ssize_t n = ::pread(_fd, scratch->data() + done, static_cast<size_t>(length - done), static_cast<off_t>(offset + done));
+        if (n <= 0) {
+            if (n == -1 && errno == EINTR) {
+                continue;
+            }
+            return nullptr;
+        }
+        done += static_cast<uint64_t>(n);
+    }
+    return scratch->data();
+#else
+    CC_UNUSED_PARAM(scratch);
+    return nullptr;
+#endif
+}
+
+bool ZipArchive::readCentralDirectory() {
+    const uint64_t size = _size;
+    if (size < END_OF_CENTRAL_DIRECTORY_SIZE) {
+        return false;
+    }
+
+    // the end of central directory record is followed by a comment of up to 64KB,
+    // and preceded by the zip64 locator when there is one
+    const uint64_t tailSize = std::min<uint64_t>(size, ZIP64_END_OF_CENTRAL_DIRECTORY_LOCATOR_SIZE + END_OF_CENTRAL_DIRECTORY_SIZE + MAX_COMMENT_SIZE);
+    ccstd::vector<uint8_t> tailScratch;
+    const uint8_t *tail = readRange(size - tailSize, tailSize, &tailScratch);
+    if (!tail) {
+        return false;
+    }
+    const uint8_t *eocd = nullptr;
+    const uint64_t searchEnd = tailSize > END_OF_CENTRAL_DIRECTORY_SIZE + MAX_COMMENT_SIZE ? tailSize - END_OF_CENTRAL_DIRECTORY_SIZE - MAX_COMMENT_SIZE : 0;
+    for (uint64_t pos = tailSize - END_OF_CENTRAL_DIRECTORY_SIZE + 1; pos-- > searchEnd;) {
+        if (readU32(tail + pos) == END_OF_CENTRAL_DIRECTORY_SIGNATURE) {
+            eocd = tail + pos;
+            break;
+        }
+    }
+    if (!eocd) {
+        return false;
+    }
+
+    uint64_t entryCount = readU16(eocd + 10);
+    uint64_t directorySize = readU32(eocd + 12);
+    uint64_t directoryOffset = readU32(eocd + 16);
+
+    if (eocd - tail >= ZIP64_END_OF_CENTRAL_DIRECTORY_LOCATOR_SIZE) {
+        const uint8_t *locator = eocd - ZIP64_END_OF_CENTRAL_DIRECTORY_LOCATOR_SIZE;
+        if (readU32(locator) == ZIP64_END_OF_CENTRAL_DIRECTORY_LOCATOR_SIGNATURE) {
+            ccstd::vector<uint8_t> zip64Scratch;
+            const uint8_t *zip64 = readRange(readU64(locator + 8), ZIP64_END_OF_CENTRAL_DIRECTORY_SIZE, &zip64Scratch);
+            if (!zip64 || readU32(zip64) != ZIP64_END_OF_CENTRAL_DIRECTORY_SIGNATURE) {
+                return false;
+            }
+            entryCount = readU64(zip64 + 32);
+            directorySize = readU64(zip64 + 40);
+            directoryOffset = readU64(zip64 + 48);
+        }
+    }
+    ccstd::vector<uint8_t> directoryScratch;
+    const uint8_t *p = readRange(directoryOffset, directorySize, &directoryScratch);
+    if (!p) {
+        return false;
+    }
+
+    _entries.reserve(static_cast<size_t>(entryCount));
+    const uint8_t *end = p + directorySize;
+    for (uint64_t i = 0; i < entryCount; ++i) {
+        if (p + CENTRAL_DIRECTORY_HEADER_SIZE > end || readU32(p) != CENTRAL_DIRECTORY_HEADER_SIGNATURE) {
+            return false;
+        }
+        const uint16_t nameLength = readU16(p + 28);
+        const uint16_t extraLength = readU16(p + 30);
+        const uint16_t commentLength = readU16(p + 32);
+        const uint8_t *name = p + CENTRAL_DIRECTORY_HEADER_SIZE;
+        const uint8_t *extra = name + nameLength;
+        const uint8_t *next = extra + extraLength + commentLength;
+        if (next > end) {
+            return false;
+        }
+
+        uint64_t compressedSize = readU32(p + 20);
+        uint64_t uncompressedSize = readU32(p + 24);
+        uint64_t localHeaderOffset = readU32(p + 42);
+        // sizes that do not fit in 32 bits are moved to the zip64 extra field, in this order
+        for (const uint8_t *field = extra; field + 4 <= extra + extraLength;) {
+            const uint16_t id = readU16(field);
+            const uint16_t fieldSize = readU16(field + 2);
+            const uint8_t *value = field + 4;
+            const uint8_t *valueEnd = value + fieldSize;
+            if (valueEnd > extra + extraLength) {
+                break;
+            }
+            if (id == ZIP64_EXTRA_FIELD_ID) {
+                if (uncompressedSize == UINT32_MAX && value + 8 <= valueEnd) {
+                    uncompressedSize = readU64(value);
+                    value += 8;
+                }
+                if (compressedSize == UINT32_MAX && value + 8 <= valueEnd) {
+                    compressedSize = readU64(value);
+                    value += 8;
+                }
+                if (localHeaderOffset == UINT32_MAX && value + 8 <= valueEnd) {
+                    localHeaderOffset = readU64(value);
+                }
+                break;
+            }
+            field = valueEnd;
+        }
+
+        // directories have no contents, and nothing larger than the archive can be in it
+        if (nameLength > 0 && name[nameLength - 1] != '/' && localHeaderOffset < size && compressedSize <= size && compressedSize <= UINT32_MAX && uncompressedSize <= UINT32_MAX) {
+            Entry entry;
+            entry.localHeaderOffset = localHeaderOffset;
+            entry.compressedSize = static_cast<uint32_t>(compressedSize);
+            entry.uncompressedSize = static_cast<uint32_t>(uncompressedSize);
+            entry.method = readU16(p + 10);
+            entry.encrypted = (readU16(p + 8) & 0x1) != 0;
+            _entries.emplace(ccstd::string{reinterpret_cast<const char *>(name), nameLength}, entry);
+        }
+        p = next;
+    }
+    return true;
+}
+
+bool ZipArchive::fileExists(const ccstd::string &fileName) const {
+    return _entries.find(fileName) != _entries.end();
+}
+
+int64_t ZipArchive::getFileSize(const ccstd::string &fileName) const {
+    auto iter = _entries.find(fileName);
+    return iter != _entries.end() ? static_cast<int64_t>(iter->second.uncompressedSize) : -1;
+}
+
+ccstd::vector<ccstd::string> ZipArchive::getFilenames() const {
+    ccstd::vector<ccstd::string> names;
+    names.reserve(_entries.size());
+    for (const auto &entry : _entries) {
+        names.push_back(entry.first);
+    }
+    return names;
+}
+
+const uint8_t *ZipArchive::getEntryData(const Entry &entry, ccstd::vector<uint8_t> *scratch) const {
+    // the local header repeats the name and may carry a different extra field
+    const uint8_t *header = readRange(entry.localHeaderOffset, LOCAL_FILE_HEADER_SIZE, scratch);
+    if (!header || readU32(header) != LOCAL_FILE_HEADER_SIGNATURE) {
+        return nullptr;
+    }
+    const uint64_t dataOffset = entry.localHeaderOffset + LOCAL_FILE_HEADER_SIZE + readU16(header + 26) + readU16(header + 28);
+    return readRange(dataOffset, entry.compressedSize, scratch);
+}
+
+bool ZipArchive::extract(const Entry &entry, uint8_t *dst) const {
+    if (entry.encrypted) {
+        CC_LOG_ERROR("ZipArchive: encrypted entries are not supported");
+        return false;
+    }
+    // a streamed archive only holds the compressed bytes of this entry in memory
+    ccstd::vector<uint8_t> scratch;
+    const uint8_t *src = getEntryData(entry, &scratch);
+    if (!src) {
+        return false;
+    }
+
+    if (entry.method == METHOD_STORED) {
+        if (entry.compressedSize != entry.uncompressedSize) {
+            return false;
+        }
+        memcpy(dst, src, entry.uncompressedSize);
+        return true;
+    }
+
+    if (entry.method != METHOD_DEFLATED) {
+        CC_LOG_ERROR("ZipArchive: unsupported compression method %d", static_cast<int>(entry.method));
+        return false;
+    }
+
+    // raw deflate stream, every call has its own decoder state
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) {
+        return false;
+    }
+    stream.next_in = const_cast<Bytef *>(src);
+    stream.avail_in = entry.compressedSize;
+    stream.next_out = dst;
+    stream.avail_out = entry.uncompressedSize;
+    const int err = inflate(&stream, Z_FINISH);
+    const bool ok = err == Z_STREAM_END && stream.total_out == entry.uncompressedSize;
+    inflateEnd(&stream);
+    return ok;
+}
+
+bool ZipArchive::getStoredView(const ccstd::string &fileName, const uint8_t **bytes, uint32_t *size) const {
+    auto iter = _entries.find(fileName);
+    if (iter == _entries.end()) {
+        return false;
+    }
+    const Entry &entry = iter->second;
+    if (!_file || entry.method != METHOD_STORED || entry.encrypted || entry.compressedSize != entry.uncompressedSize) {
+        return false;
+    }
+    const uint8_t *data = getEntryData(entry, nullptr);
+    if (!data) {
+        return false;
+    }
+    *bytes = data;
+    *size = entry.uncompressedSize;
+    return true;
+}
+
+bool ZipArchive::getFileData(const ccstd::string &fileName, ResizableBuffer *buffer) const {
+    auto iter = _entries.find(fileName);
+    if (iter == _entries.end()) {
+        return false;
+    }
+    const Entry &entry = iter->second;
+    buffer->resize(entry.uncompressedSize);
+    if (entry.uncompressedSize == 0) {
+        return true;
+    }
+    return extract(entry, static_cast<uint8_t *>(buffer->buffer()));
+}
+
+bool ZipArchive::getFileData(const ccstd::string &fileName, Data *data) const {
+    ResizableBufferAdapter<Data> buffer(data);
+    if (getFileData(fileName, &buffer)) {
+        return true;
+    }
+    data->clear();
+    return false;
+}
+
+unsigned char *ZipArchive::getFileData(const ccstd::string &fileName, uint32_t *size) const {
+    if (size) {
+        *size = 0;
+    }
+    Data data;
+    if (!getFileData(fileName, &data)) {
+        return nullptr;
+    }
+    uint32_t dataSize = 0;
+    unsigned char *bytes = data.takeBuffer(&dataSize);
+    if (size) {
+        *size = dataSize;
+    }
+    return bytes;
+}
+
+void ZipArchive::getFilesData(const ccstd::vector<ccstd::string> &fileNames, ccstd::vector<Data> *out) const {
+    const auto count = static_cast<uint32_t>(fileNames.size());
+    out->clear();
+    out->resize(count);
+
+    uint64_t compressedBytes = 0;
+    for (const auto &fileName : fileNames) {
+        auto iter = _entries.find(fileName);
+        if (iter != _entries.end()) {
+            compressedBytes += iter->second.compressedSize;
+        }
+    }
+
+    auto &results = *out;
+    auto *jobSystem = JobSystem::getInstance();
+    if (compressedBytes >= PARALLEL_INFLATE_MIN_BYTES && count > 1 && jobSystem->threadCount() > 1) {
+        JobGraph g(jobSystem);
+        g.createForEachIndexJob(1U, count, 1U, [this, &fileNames, &results](uint32_t i) {
+            getFileData(fileNames[i], &results[i]);
+        });
+        g.run();
+        getFileData(fileNames[0], &results[0]); // the calling thread takes the first entry
+        g.waitForAll();
+    } else {
+        for (uint32_t i = 0; i < count; ++i) {
+            getFileData(fileNames[i], &results[i]);
+        }
+    }
+}
+
+} // namespace cc
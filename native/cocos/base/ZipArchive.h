@@ -0,0 +1,137 @@
+/****************************************************************************
+ Copyright (c) 2017-2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+
+#pragma once
+
+#include "base/Data.h"
+#include "base/Macros.h"
+#include "base/Ptr.h"
+#include "base/RefCounted.h"
+#include "base/std/container/string.h"
+#include "base/std/container/unordered_map.h"
+#include "base/std/container/vector.h"
+#include "platform/MappedFile.h"
+
+namespace cc {
+
+class ResizableBuffer;
+
+/**
+ *  A zip archive indexed once for random access.
+ *
+ *  The archive is mapped into memory and its central directory is parsed into a hash table
+ *  when it is opened, so looking up an entry never rescans the archive. Entries keep no
+ *  decoder state: stored entries are served straight from the mapping, and deflated entries
+ *  may be inflated from several threads at the same time.
+ *
+ *  Archives opened by mount() are shared: mounting the same path again returns the same
+ *  instance until it is unmounted, or until the file changes size or modification time.
+ */
+class CC_DLL ZipArchive final : public RefCounted {
+public:
+    /**
+     *  Returns the archive mounted at the given full path, opening and indexing it on first use.
+     *  Native files that cannot be mapped are read on demand instead of being copied into memory.
+     *  @return nullptr when the file cannot be read or is not a zip archive.
+     */
+    static IntrusivePtr<ZipArchive> mount(const ccstd::string &path);
+    // Archives still referenced elsewhere stay readable, the path is only forgotten.
+    static void unmount(const ccstd::string &path);
+    // Unmounts every archive below the given directory, e.g. before it is removed.
+    static void unmountDirectory(const ccstd::string &directory);
+    static void unmountAll();
+
+    /**
+     *  Indexes an archive already in memory, without mounting it.
+     *  @return nullptr when the contents are not a zip archive.
+     */
+    static IntrusivePtr<ZipArchive> create(IntrusivePtr<MappedFile> file);
+
+    /**
+     *  Indexes a native file without mapping it, entries are read from the file when requested.
+     *  Only the central directory is kept in memory. Not available on Windows.
+     *  @return nullptr when the file cannot be opened or is not a zip archive.
+     */
+    static IntrusivePtr<ZipArchive> openStreamed(const ccstd::string &path);
+
+    ~ZipArchive() override;
+
+    bool fileExists(const ccstd::string &fileName) const;
+    // uncompressed size of the entry, or -1 when it does not exist
+    int64_t getFileSize(const ccstd::string &fileName) const;
+    inline uint32_t getFileCount() const { return static_cast<uint32_t>(_entries.size()); }
+    ccstd::vector<ccstd::string> getFilenames() const;
+
+    /**
+     *  Points at the contents of an entry stored without compression, without copying.
+     *  The view stays valid as long as the archive is alive.
+     *  @return false when the entry does not exist, is compressed or the archive is streamed.
+     */
+    bool getStoredView(const ccstd::string &fileName, const uint8_t **bytes, uint32_t *size) const;
+
+    /**
+     *  Gets the uncompressed contents of an entry. Safe to call from any thread.
+     */
+    bool getFileData(const ccstd::string &fileName, ResizableBuffer *buffer) const;
+    bool getFileData(const ccstd::string &fileName, Data *data) const;
+    /**
+     *  @warning Recall: you are responsible for calling free() on any Non-nullptr pointer returned.
+     */
+    unsigned char *getFileData(const ccstd::string &fileName, uint32_t *size) const;
+
+    /**
+     *  Gets the contents of several entries, inflating them on the job system.
+     *  Entries that cannot be read are left empty in the output.
+     */
+    void getFilesData(const ccstd::vector<ccstd::string> &fileNames, ccstd::vector<Data> *out) const;
+
+private:
+    struct Entry {
+        uint64_t localHeaderOffset{0};
+        uint32_t compressedSize{0};
+        uint32_t uncompressedSize{0};
+        uint16_t method{0};
+        bool encrypted{false};
+    };
+
+    explicit ZipArchive(IntrusivePtr<MappedFile> &&file);
+    ZipArchive(int fd, uint64_t size);
+
+    bool readCentralDirectory();
+    // Points into the mapping, or reads a streamed archive into scratch.
+    const uint8_t *readRange(uint64_t offset, uint64_t length, ccstd::vector<uint8_t> *scratch) const;
+    const uint8_t *getEntryData(const Entry &entry, ccstd::vector<uint8_t> *scratch) const;
+    bool extract(const Entry &entry, uint8_t *dst) const;
+
+    IntrusivePtr<MappedFile> _file;
+    // descriptor of a streamed archive, read with positioned reads so threads never share an offset
+    int _fd{-1};
+    uint64_t _size{0};
+    ccstd::unordered_map<ccstd::string, Entry> _entries;
+
+    CC_DISALLOW_COPY_MOVE_ASSIGN(ZipArchive);
+};
+
+} // namespace cc
@@ -0,0 +1,528 @@
+/****************************************************************************
+ Copyright (c) 2017-2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+
+#include "base/ZipStreamExtractor.h"
+
+#include <zlib.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include "base/Log.h"
+#include "base/job-system/JobSystem.h"
+#include "platform/FileUtils.h"
+
+namespace cc {
+
+namespace {
+
+constexpr uint32_t LOCAL_FILE_HEADER_SIGNATURE = 0x04034b50;
+constexpr uint32_t CENTRAL_DIRECTORY_SIGNATURE = 0x02014b50;
+constexpr uint32_t END_OF_CENTRAL_DIRECTORY_SIGNATURE = 0x06054b50;
+constexpr uint32_t DATA_DESCRIPTOR_SIGNATURE = 0x08074b50;
+constexpr size_t LOCAL_FILE_HEADER_SIZE = 30;
+constexpr uint16_t ZIP64_EXTRA_FIELD_ID = 0x0001;
+
+constexpr uint16_t FLAG_ENCRYPTED = 1U << 0;
+constexpr uint16_t FLAG_DATA_DESCRIPTOR = 1U << 3;
+
+constexpr uint16_t METHOD_STORED = 0;
+constexpr uint16_t METHOD_DEFLATED = 8;
+
+// entries bigger than this, compressed or inflated, are inflated as they arrive instead of being buffered
+constexpr uint32_t BUFFERED_ENTRY_MAX_BYTES = 1024 * 1024;
+// bytes of buffered entries handed to the job system at once, counting each entry at
+// the larger of its compressed and inflated size
+constexpr uint32_t BATCH_BYTES = 1024 * 1024;
+// bounds the memory held by buffered entries waiting to be written, at most
+// MAX_RUNNING_BATCHES * (BATCH_BYTES + BUFFERED_ENTRY_MAX_BYTES) compressed plus as many inflated bytes
+constexpr size_t MAX_RUNNING_BATCHES = 4;
+constexpr size_t STREAM_CHUNK_SIZE = 32 * 1024;
+
+inline uint16_t readU16(const uint8_t *p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+inline uint32_t readU32(const uint8_t *p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+bool hasZip64Extra(const uint8_t *extra, size_t size) {
+    size_t offset = 0;
+    while (offset + 4 <= size) {
+        if (readU16(extra + offset) == ZIP64_EXTRA_FIELD_ID) {
+            return true;
+        }
+        offset += 4 + readU16(extra + offset + 2);
+    }
+    return false;
+}
+
+// rejects names that would be written outside of the root path
+bool isSafeName(const ccstd::string &name) {
+    if (name.empty() || name[0] == '/' || name[0] == '\\' || name.find(':') != ccstd::string::npos) {
+        return false;
+    }
+    size_t begin = 0;
+    while (begin <= name.size()) {
+        size_t end = name.find_first_of("/\\", begin);
+        if (end == ccstd::string::npos) {
+            end = name.size();
+        }
+        if (name.compare(begin, end - begin, "..") == 0) {
+            return false;
+        }
+        begin = end + 1;
+    }
+    return true;
+}
+
+ccstd::string parentPath(const ccstd::string &path) {
+    const size_t pos = path.find_last_of('/');
+    return pos == ccstd::string::npos ? ccstd::string() : path.substr(0, pos + 1);
+}
+
+FILE *openForWriting(const ccstd::string &path) {
+    return fopen(FileUtils::getInstance()->getSuitableFOpen(path).c_str(), "wb");
+}
+
+} // namespace
+
+struct ZipStreamExtractor::Batch {
+    explicit Batch(JobSystem *jobSystem) : graph(jobSystem) {}
+
+    JobGraph graph;
+    ccstd::vector<Entry> entries;
+};
+
+ZipStreamExtractor::ZipStreamExtractor(const ccstd::string &rootPath)
+: _rootPath(rootPath) {
+}
+
+ZipStreamExtractor::~ZipStreamExtractor() {
+    waitForBatches(0);
+    closeStreamedEntry();
+}
+
+bool ZipStreamExtractor::feed(const uint8_t *data, uint32_t size) {
+    if (_failed) {
+        return false;
+    }
+    _md5.update(data, size);
+    _bytesFed += size;
+
+    // only the bytes of an incomplete header or data descriptor are kept between calls
+    const uint8_t *bytes = data;
+    size_t count = size;
+    const bool pending = !_pending.empty();
+    if (pending) {
+        _pending.insert(_pending.end(), data, data + size);
+        bytes = _pending.data();
+        count = _pending.size();
+    }
+
+    size_t offset = 0;
+    while (offset < count && _state != State::DONE && !_failed) {
+        size_t used = 0;
+        switch (_state) {
+            case State::HEADER:
+                used = readHeader(bytes + offset, count - offset);
+                break;
+            case State::BUFFERED_DATA:
+                used = readBufferedData(bytes + offset, count - offset);
+                break;
+            case State::STREAMED_DATA:
+                used = readStreamedData(bytes + offset, count - offset);
+                break;
+            case State::DATA_DESCRIPTOR:
+                used = readDataDescriptor(bytes + offset, count - offset);
+                break;
+            default:
+                break;
+        }
+        if (used == 0) {
+            break;
+        }
+        offset += used;
+    }
+
+    if (_state == State::DONE) {
+        _pending.clear();
+    } else if (pending) {
+        _pending.erase(_pending.begin(), _pending.begin() + static_cast<std::ptrdiff_t>(offset));
+    } else {
+        _pending.assign(bytes + offset, bytes + count);
+    }
+    return !_failed;
+}
+
+bool ZipStreamExtractor::finish() {
+    runBatch();
+    waitForBatches(0);
+    closeStreamedEntry();
+    if (!_failed && _state != State::DONE) {
+        fail("the archive is truncated");
+    }
+    return !_failed;
+}
+
+ccstd::string ZipStreamExtractor::getMD5() {
+    return _md5.hexDigest();
+}
+
+size_t ZipStreamExtractor::readHeader(const uint8_t *data, size_t size) {
+    if (size < 4) {
+        return 0;
+    }
+    const uint32_t signature = readU32(data);
+    if (signature == CENTRAL_DIRECTORY_SIGNATURE || signature == END_OF_CENTRAL_DIRECTORY_SIGNATURE) {
+        // every entry has been read, start writing the last batch while the rest arrives
+        _state = State::DONE;
+        runBatch();
+        return size;
+    }
+    if (signature != LOCAL_FILE_HEADER_SIGNATURE) {
+        fail("invalid local file header");
+        return 0;
+    }
+    if (size < LOCAL_FILE_HEADER_SIZE) {
+        return 0;
+    }
+    const uint16_t nameLength = readU16(data + 26);
+    const uint16_t extraLength = readU16(data + 28);
+    const size_t headerSize = LOCAL_FILE_HEADER_SIZE + nameLength + extraLength;
+    if (size < headerSize) {
+        return 0;
+    }
+
+    const uint16_t flags = readU16(data + 6);
+    Entry entry;
+    entry.method = readU16(data + 8);
+    entry.crc = readU32(data + 14);
+    entry.compressedSize = readU32(data + 18);
+    entry.uncompressedSize = readU32(data + 22);
+    entry.hasDataDescriptor = (flags & FLAG_DATA_DESCRIPTOR) != 0;
+    const ccstd::string name(reinterpret_cast<const char *>(data + LOCAL_FILE_HEADER_SIZE), nameLength);
+
+    if (flags & FLAG_ENCRYPTED) {
+        fail("encrypted entries are not supported");
+        return 0;
+    }
+    if (hasZip64Extra(data + LOCAL_FILE_HEADER_SIZE + nameLength, extraLength)) {
+        fail("zip64 entries are not supported");
+        return 0;
+    }
+    if (!isSafeName(name)) {
+        CC_LOG_ERROR("ZipStreamExtractor: unsafe entry name %s", name.c_str());
+        _failed = true;
+        return 0;
+    }
+
+    entry.path = _rootPath + name;
+    if (name.back() == '/' || name.back() == '\\') {
+        if (!createDirectory(entry.path)) {
+            return 0;
+        }
+        if (entry.hasDataDescriptor) {
+            _entry = std::move(entry);
+            _streamedCrc = _streamedIn = _streamedOut = 0;
+            _state = State::DATA_DESCRIPTOR;
+        } else if (entry.compressedSize != 0) {
+            fail("directory entry with data");
+            return 0;
+        }
+        return headerSize;
+    }
+
+    if (entry.method != METHOD_STORED && entry.method != METHOD_DEFLATED) {
+        CC_LOG_ERROR("ZipStreamExtractor: unsupported compression method %d", static_cast<int>(entry.method));
+        _failed = true;
+        return 0;
+    }
+    if (entry.hasDataDescriptor && entry.method == METHOD_STORED) {
+        // the end of the data could only be found by guessing from the next signature
+        fail("stored entries with a data descriptor are not supported");
+        return 0;
+    }
+    if (!createDirectory(parentPath(entry.path))) {
+        return 0;
+    }
+
+    ++_fileCount;
+    _entry = std::move(entry);
+    // the inflated size decides the buffer writeEntry() allocates, so it is bounded as well
+    if (_entry.hasDataDescriptor || _entry.compressedSize > BUFFERED_ENTRY_MAX_BYTES || _entry.uncompressedSize > BUFFERED_ENTRY_MAX_BYTES) {
+        if (!beginStreamedEntry()) {
+            return 0;
+        }
+        _state = State::STREAMED_DATA;
+    } else if (_entry.compressedSize == 0) {
+        queueEntry();
+    } else {
+        _entry.data.reserve(_entry.compressedSize);
+        _state = State::BUFFERED_DATA;
+    }
+    return headerSize;
+}
+
+size_t ZipStreamExtractor::readBufferedData(const uint8_t *data, size_t size) {
+    const size_t used = std::min(size, static_cast<size_t>(_entry.compressedSize - _entry.data.size()));
+    _entry.data.insert(_entry.data.end(), data, data + used);
+    if (_entry.data.size() == _entry.compressedSize) {
+        queueEntry();
+        _state = State::HEADER;
+    }
+    return used;
+}
+
+size_t ZipStreamExtractor::readStreamedData(const uint8_t *data, size_t size) {
+    size_t available = size;
+    if (!_entry.hasDataDescriptor) {
+        available = std::min(available, static_cast<size_t>(_entry.compressedSize - _streamedIn));
+    }
+
+    size_t used = 0;
+    bool ended = false;
+    if (_entry.method == METHOD_STORED) {
+        if (!writeStreamed(data, available)) {
+            return 0;
+        }
+        used = available;
+        ended = _streamedIn + used == _entry.compressedSize;
+    } else {
+        uint8_t out[STREAM_CHUNK_SIZE];
+        _stream->next_in = const_cast<Bytef *>(data);
+        _stream->avail_in = static_cast<uInt>(available);
+        int err = Z_OK;
+        do {
+            _stream->next_out = out;
+            _stream->avail_out = STREAM_CHUNK_SIZE;
+            err = inflate(_stream, Z_NO_FLUSH);
+            if (err != Z_OK && err != Z_STREAM_END && err != Z_BUF_ERROR) {
+                fail("invalid deflate stream");
+                return 0;
+            }
+            if (!writeStreamed(out, STREAM_CHUNK_SIZE - _stream->avail_out)) {
+                return 0;
+            }
+        } while (err == Z_OK && (_stream->avail_in > 0 || _stream->avail_out == 0));
+        used = available - _stream->avail_in;
+        ended = err == Z_STREAM_END;
+    }
+    _streamedIn += static_cast<uint32_t>(used);
+
+    if (ended) {
+        if (_entry.hasDataDescriptor) {
+            _state = State::DATA_DESCRIPTOR;
+        } else {
+            endStreamedEntry(_entry.crc, _entry.compressedSize, _entry.uncompressedSize);
+        }
+    } else if (!_entry.hasDataDescriptor && _streamedIn == _entry.compressedSize) {
+        fail("truncated deflate stream");
+        return 0;
+    }
+    return used;
+}
+
+size_t ZipStreamExtractor::readDataDescriptor(const uint8_t *data, size_t size) {
+    if (size < 4) {
+        return 0;
+    }
+    // the signature is optional
+    const size_t offset = readU32(data) == DATA_DESCRIPTOR_SIGNATURE ? 4 : 0;
+    if (size < offset + 12) {
+        return 0;
+    }
+    endStreamedEntry(readU32(data + offset), readU32(data + offset + 4), readU32(data + offset + 8));
+    return offset + 12;
+}
+
+bool ZipStreamExtractor::beginStreamedEntry() {
+    _streamedCrc = static_cast<uint32_t>(crc32(0L, Z_NULL, 0));
+    _streamedIn = 0;
+    _streamedOut = 0;
+    _file = openForWriting(_entry.path);
+    if (!_file) {
+        CC_LOG_ERROR("ZipStreamExtractor: can not create %s (errno: %d)", _entry.path.c_str(), errno);
+        _failed = true;
+        return false;
+    }
+    if (_entry.method == METHOD_DEFLATED) {
+        _stream = ccnew z_stream;
+        memset(_stream, 0, sizeof(z_stream));
+        if (inflateInit2(_stream, -MAX_WBITS) != Z_OK) {
+            delete _stream;
+            _stream = nullptr;
+            fail("can not initialize zlib");
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ZipStreamExtractor::endStreamedEntry(uint32_t crc, uint32_t compressedSize, uint32_t uncompressedSize) {
+    closeStreamedEntry();
+    _state = State::HEADER;
+    if (_streamedCrc != crc || _streamedIn != compressedSize || _streamedOut != uncompressedSize) {
+        CC_LOG_ERROR("ZipStreamExtractor: %s is corrupted", _entry.path.c_str());
+        _failed = true;
+        return false;
+    }
+    return true;
+}
+
+bool ZipStreamExtractor::writeStreamed(const uint8_t *data, size_t size) {
+    if (size == 0) {
+        return true;
+    }
+    if (fwrite(data, 1, size, _file) != size) {
+        CC_LOG_ERROR("ZipStreamExtractor: can not write %s (errno: %d)", _entry.path.c_str(), errno);
+        _failed = true;
+        return false;
+    }
+    _streamedCrc = static_cast<uint32_t>(crc32(_streamedCrc, data, static_cast<uInt>(size)));
+    _streamedOut += static_cast<uint32_t>(size);
+    return true;
+}
+
+void ZipStreamExtractor::closeStreamedEntry() {
+    if (_file) {
+        fclose(_file);
+        _file = nullptr;
+    }
+    if (_stream) {
+        inflateEnd(_stream);
+        delete _stream;
+        _stream = nullptr;
+    }
+}
+
+void ZipStreamExtractor::queueEntry() {
+    _batchBytes += std::max(_entry.compressedSize, _entry.uncompressedSize);
+    _batch.push_back(std::move(_entry));
+    _entry = Entry();
+    if (_batchBytes >= BATCH_BYTES) {
+        runBatch();
+    }
+}
+
+void ZipStreamExtractor::runBatch() {
+    if (_batch.empty()) {
+        return;
+    }
+    auto *jobSystem = JobSystem::getInstance();
+    if (jobSystem->threadCount() <= 1) {
+        for (auto &entry : _batch) {
+            if (!writeEntry(entry)) {
+                _failed = true;
+            }
+        }
+    } else {
+        waitForBatches(MAX_RUNNING_BATCHES - 1);
+        auto batch = std::make_unique<Batch>(jobSystem);
+        batch->entries = std::move(_batch);
+        auto *entries = &batch->entries;
+        batch->graph.createForEachIndexJob(0U, static_cast<uint32_t>(entries->size()), 1U, [this, entries](uint32_t i) {
+            if (!writeEntry((*entries)[i])) {
+                _failed = true;
+            }
+        });
+        batch->graph.run();
+        _runningBatches.push_back(std::move(batch));
+    }
+    _batch.clear();
+    _batchBytes = 0;
+}
+
+void ZipStreamExtractor::waitForBatches(size_t maxPending) {
+    while (_runningBatches.size() > maxPending) {
+        _runningBatches.front()->graph.waitForAll();
+        _runningBatches.pop_front();
+    }
+}
+
+bool ZipStreamExtractor::createDirectory(const ccstd::string &path) {
+    if (path.empty() || _directories.count(path)) {
+        return true;
+    }
+    if (!FileUtils::getInstance()->createDirectory(path)) {
+        CC_LOG_ERROR("ZipStreamExtractor: can not create directory %s", path.c_str());
+        _failed = true;
+        return false;
+    }
+    _directories.insert(path);
+    return true;
+}
+
+void ZipStreamExtractor::fail(const char *reason) {
+    if (!_failed.exchange(true)) {
+        CC_LOG_ERROR("ZipStreamExtractor: %s", reason);
+    }
+}
+
+bool ZipStreamExtractor::writeEntry(Entry &entry) {
+    ccstd::vector<uint8_t> buffer;
+    const uint8_t *bytes = entry.data.data();
+    if (entry.method == METHOD_DEFLATED) {
+        buffer.resize(entry.uncompressedSize);
+        z_stream stream;
+        memset(&stream, 0, sizeof(stream));
+        if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) {
+            return false;
+        }
+        stream.next_in = entry.data.data();
+        stream.avail_in = entry.compressedSize;
+        stream.next_out = buffer.data();
+        stream.avail_out = entry.uncompressedSize;
+        const int err = inflate(&stream, Z_FINISH);
+        const bool ok = err == Z_STREAM_END && stream.total_out == entry.uncompressedSize;
+        inflateEnd(&stream);
+        if (!ok) {
+            CC_LOG_ERROR("ZipStreamExtractor: can not inflate %s", entry.path.c_str());
+            return false;
+        }
+        bytes = buffer.data();
+    } else if (entry.compressedSize != entry.uncompressedSize) {
+        CC_LOG_ERROR("ZipStreamExtractor: %s is corrupted", entry.path.c_str());
+        return false;
+    }
+
+    if (static_cast<uint32_t>(crc32(crc32(0L, Z_NULL, 0), bytes, entry.uncompressedSize)) != entry.crc) {
+        CC_LOG_ERROR("ZipStreamExtractor: %s is corrupted", entry.path.c_str());
+        return false;
+    }
+
+    FILE *file = openForWriting(entry.path);
+    if (!file) {
+        CC_LOG_ERROR("ZipStreamExtractor: can not create %s (errno: %d)", entry.path.c_str(), errno);
+        return false;
+    }
+    const bool written = entry.uncompressedSize == 0 || fwrite(bytes, 1, entry.uncompressedSize, file) == entry.uncompressedSize;
+    fclose(file);
+    // the buffered bytes are not needed once the file is written
+    ccstd::vector<uint8_t>().swap(entry.data);
+    return written;
+}
+
+} // namespace cc
@@ -0,0 +1,148 @@
+/****************************************************************************
+ Copyright (c) 2017-2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+
+#pragma once
+
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include "base/MD5.h"
+#include "base/Macros.h"
+#include "base/std/container/deque.h"
+#include "base/std/container/string.h"
+#include "base/std/container/unordered_set.h"
+#include "base/std/container/vector.h"
+
+struct z_stream_s;
+
+namespace cc {
+
+/**
+ *  Extracts a zip archive while it is being received, e.g. from a download.
+ *
+ *  The archive is fed in order and its local file headers are parsed as they arrive, the
+ *  central directory is never needed. Small entries whose sizes are in the local header are
+ *  collected and inflated in batches on the job system. Large entries, and entries followed
+ *  by a data descriptor, are inflated and written as their bytes arrive. The MD5 digest of
+ *  the archive is updated on the way, so it never has to be read again.
+ *
+ *  feed() and finish() may be called from different threads, but not at the same time.
+ */
+class CC_DLL ZipStreamExtractor final {
+public:
+    /**
+     *  @param rootPath The directory the entries are extracted to, ending with a path separator.
+     */
+    explicit ZipStreamExtractor(const ccstd::string &rootPath);
+    ~ZipStreamExtractor();
+
+    /**
+     *  Extracts the entries completed by the next bytes of the archive.
+     *  @return false once the archive is invalid or an entry could not be written.
+     */
+    bool feed(const uint8_t *data, uint32_t size);
+
+    /**
+     *  Waits for the entries being inflated on the job system.
+     *  @return true if all the entries up to the central directory were extracted.
+     */
+    bool finish();
+
+    inline bool isFailed() const { return _failed.load(); }
+    inline uint64_t getBytesFed() const { return _bytesFed; }
+    // files extracted or being extracted
+    inline uint32_t getFileCount() const { return _fileCount; }
+
+    /**
+     *  The digest of the bytes fed so far, nothing is digested after the first call.
+     */
+    ccstd::string getMD5();
+
+private:
+    enum class State {
+        HEADER,
+        BUFFERED_DATA,
+        STREAMED_DATA,
+        DATA_DESCRIPTOR,
+        DONE,
+    };
+
+    struct Entry {
+        ccstd::string path;
+        ccstd::vector<uint8_t> data;
+        uint32_t crc{0};
+        uint32_t compressedSize{0};
+        uint32_t uncompressedSize{0};
+        uint16_t method{0};
+        bool hasDataDescriptor{false};
+    };
+
+    struct Batch;
+
+    // each returns the bytes consumed, 0 if more are needed
+    size_t readHeader(const uint8_t *data, size_t size);
+    size_t readBufferedData(const uint8_t *data, size_t size);
+    size_t readStreamedData(const uint8_t *data, size_t size);
+    size_t readDataDescriptor(const uint8_t *data, size_t size);
+
+    bool beginStreamedEntry();
+    bool endStreamedEntry(uint32_t crc, uint32_t compressedSize, uint32_t uncompressedSize);
+    bool writeStreamed(const uint8_t *data, size_t size);
+    void closeStreamedEntry();
+
+    void queueEntry();
+    void runBatch();
+    void waitForBatches(size_t maxPending);
+    bool createDirectory(const ccstd::string &path);
+    void fail(const char *reason);
+
+    static bool writeEntry(Entry &entry);
+
+    ccstd::string _rootPath;
+    State _state{State::HEADER};
+    ccstd::vector<uint8_t> _pending;
+    Entry _entry;
+
+    // the entry inflated as its bytes arrive
+    FILE *_file{nullptr};
+    z_stream_s *_stream{nullptr};
+    uint32_t _streamedCrc{0};
+    uint32_t _streamedIn{0};
+    uint32_t _streamedOut{0};
+
+    ccstd::vector<Entry> _batch;
+    uint32_t _batchBytes{0};
+    ccstd::deque<std::unique_ptr<Batch>> _runningBatches;
+
+    ccstd::unordered_set<ccstd::string> _directories;
+    MD5 _md5;
+    uint64_t _bytesFed{0};
+    uint32_t _fileCount{0};
+    std::atomic<bool> _failed{false};
+
+    CC_DISALLOW_COPY_MOVE_ASSIGN(ZipStreamExtractor);
+};
+
+} // namespace cc
@@ -70,6 +70,28 @@ etc1_uint32 etc1_pkm_get_width(const etc1_byte *pHeader);
 
 etc1_uint32 etc1_pkm_get_height(const etc1_byte *pHeader);
 
+// Decode a block of pixels.
+//
+// pIn is an ETC1 compressed version of the data.
+//
+// pOut is a pointer to a ETC1_DECODED_BLOCK_SIZE array of bytes that represent a
+// 4 x 4 square of 3-byte pixels in form R, G, B. Byte (3 * (x + 4 * y) is the R
+// value of pixel (x, y).
+
+void etc1_decode_block(const etc1_byte *pIn, etc1_byte *pOut);
+
+// Decode an entire image.
+// pIn - pointer to encoded data.
+// pOut - pointer to the image data. Will be written such that
+//        pixel (x,y) is at pOut + pixelSize * x + stride * y. Must be
+//        large enough to store entire image.
+// pixelSize can be 3 for R, G, B pixels or 4 for R, G, B pixels with an opaque alpha.
+// returns non-zero if there is an error.
+
+int etc1_decode_image(const etc1_byte *pIn, etc1_byte *pOut,
+                      etc1_uint32 width, etc1_uint32 height,
+                      etc1_uint32 pixelSize, etc1_uint32 stride);
+
 #ifdef __cplusplus
 }
 #endif
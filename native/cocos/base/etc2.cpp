@@ -71,3 +71,253 @@ etc2_uint32 etc2_pkm_get_height(const etc2_byte *pHeader) {
 etc2_uint32 etc2_pkm_get_format(const uint8_t *pHeader) {
     return readBEUint16(pHeader + ETC2_PKM_FORMAT_OFFSET);
 }
+
+// The reference decoder below works one pixel at a time, see CompressedTextureDecoder for the
+// decoder used at runtime.
+
+static const int kModifierTable[8][4] = {
+    {2, 8, -2, -8},
+    {5, 17, -5, -17},
+    {9, 29, -9, -29},
+    {13, 42, -13, -42},
+    {18, 60, -18, -60},
+    {24, 80, -24, -80},
+    {33, 106, -33, -106},
+    {47, 183, -47, -183}};
+
+static const int kLookup[8] = {0, 1, 2, 3, -4, -3, -2, -1};
+
+static const int kDistanceTable[8] = {3, 6, 11, 16, 23, 32, 41, 64};
+
+static const int kAlphaModifierTable[16][8] = {
+    {-3, -6, -9, -15, 2, 5, 8, 14},
+    {-3, -7, -10, -13, 2, 6, 9, 12},
+    {-2, -5, -8, -13, 1, 4, 7, 12},
+    {-2, -4, -6, -13, 1, 3, 5, 12},
+    {-3, -6, -8, -12, 2, 5, 7, 11},
+    {-3, -7, -9, -11, 2, 6, 8, 10},
+    {-4, -7, -8, -11, 3, 6, 7, 10},
+    {-3, -5, -8, -11, 2, 4, 7, 10},
+    {-2, -6, -8, -10, 1, 5, 7, 9},
+    {-2, -5, -8, -10, 1, 4, 7, 9},
+    {-2, -4, -8, -10, 1, 3, 7, 9},
+    {-2, -5, -7, -10, 1, 4, 6, 9},
+    {-3, -4, -7, -10, 2, 3, 6, 9},
+    {-1, -2, -3, -10, 0, 1, 2, 9},
+    {-4, -6, -8, -9, 3, 5, 7, 8},
+    {-3, -5, -7, -9, 2, 4, 6, 8}};
+
+static inline etc2_byte clamp(int x) {
+    return (etc2_byte)(x >= 0 ? (x < 255 ? x : 255) : 0);
+}
+
+static inline int extend4To8(int c) {
+    return (c << 4) | c;
+}
+
+static inline int extend5To8(int c) {
+    return (c << 3) | (c >> 2);
+}
+
+static inline int extend6To8(int c) {
+    return (c << 2) | (c >> 4);
+}
+
+static inline int extend7To8(int c) {
+    return (c << 1) | (c >> 6);
+}
+
+static uint64_t readBEUint64(const etc2_byte *pIn) {
+    uint64_t w = 0;
+    for (int i = 0; i < 8; ++i) {
+        w = (w << 8) | pIn[i];
+    }
+    return w;
+}
+
+// Pixel (x, y) selects its 2-bit index from bit x * 4 + y of the low word, most significant bit 16 higher.
+
+static inline int pixelIndex(uint64_t w, int x, int y) {
+    int k = x * 4 + y;
+    return (int)((((w >> (k + 16)) & 1) << 1) | ((w >> k) & 1));
+}
+
+static inline void setPixel(etc2_byte *pOut, int x, int y, int r, int g, int b) {
+    etc2_byte *q = pOut + 4 * (x + 4 * y);
+    q[0] = clamp(r);
+    q[1] = clamp(g);
+    q[2] = clamp(b);
+    q[3] = 255;
+}
+
+static void decode_etc1_modes(uint64_t w, etc2_byte *pOut) {
+    int base[2][3];
+    if (w & (1ULL << 33)) {
+        for (int c = 0; c < 3; ++c) {
+            int shift = 59 - c * 8;
+            int value = (int)((w >> shift) & 0x1F);
+            base[0][c] = extend5To8(value);
+            base[1][c] = extend5To8(value + kLookup[(w >> (shift - 3)) & 7]);
+        }
+    } else {
+        for (int c = 0; c < 3; ++c) {
+            int shift = 60 - c * 8;
+            base[0][c] = extend4To8((int)((w >> shift) & 0xF));
+            base[1][c] = extend4To8((int)((w >> (shift - 4)) & 0xF));
+        }
+    }
+    const int *tables[2] = {kModifierTable[(w >> 37) & 7], kModifierTable[(w >> 34) & 7]};
+    bool flipped = (w & (1ULL << 32)) != 0;
+    for (int y = 0; y < 4; ++y) {
+        for (int x = 0; x < 4; ++x) {
+            int sub = flipped ? (y >> 1) : (x >> 1);
+            int delta = tables[sub][pixelIndex(w, x, y)];
+            setPixel(pOut, x, y, base[sub][0] + delta, base[sub][1] + delta, base[sub][2] + delta);
+        }
+    }
+}
+
+static void decode_paint_colors(uint64_t w, const int paint[4][3], etc2_byte *pOut) {
+    for (int y = 0; y < 4; ++y) {
+        for (int x = 0; x < 4; ++x) {
+            const int *p = paint[pixelIndex(w, x, y)];
+            setPixel(pOut, x, y, p[0], p[1], p[2]);
+        }
+    }
+}
+
+static void decode_t_mode(uint64_t w, etc2_byte *pOut) {
+    int c1[3] = {
+        extend4To8((int)((((w >> 59) & 3) << 2) | ((w >> 56) & 3))),
+        extend4To8((int)((w >> 52) & 0xF)),
+        extend4To8((int)((w >> 48) & 0xF))};
+    int c2[3] = {
+        extend4To8((int)((w >> 44) & 0xF)),
+        extend4To8((int)((w >> 40) & 0xF)),
+        extend4To8((int)((w >> 36) & 0xF))};
+    int d = kDistanceTable[(((w >> 34) & 3) << 1) | ((w >> 32) & 1)];
+    int paint[4][3];
+    for (int c = 0; c < 3; ++c) {
+        paint[0][c] = c1[c];
+        paint[1][c] = c2[c] + d;
+        paint[2][c] = c2[c];
+        paint[3][c] = c2[c] - d;
+    }
+    decode_paint_colors(w, paint, pOut);
+}
+
+static void decode_h_mode(uint64_t w, etc2_byte *pOut) {
+    int c1[3] = {
+        (int)((w >> 59) & 0xF),
+        (int)((((w >> 56) & 7) << 1) | ((w >> 52) & 1)),
+        (int)((((w >> 51) & 1) << 3) | ((w >> 47) & 7))};
+    int c2[3] = {
+        (int)((w >> 43) & 0xF),
+        (int)((w >> 39) & 0xF),
+        (int)((w >> 35) & 0xF)};
+    int order = ((c1[0] << 8) | (c1[1] << 4) | c1[2]) >= ((c2[0] << 8) | (c2[1] << 4) | c2[2]) ? 1 : 0;
+    int d = kDistanceTable[(((w >> 34) & 1) << 2) | (((w >> 32) & 1) << 1) | order];
+    int paint[4][3];
+    for (int c = 0; c < 3; ++c) {
+        paint[0][c] = extend4To8(c1[c]) + d;
+        paint[1][c] = extend4To8(c1[c]) - d;
+        paint[2][c] = extend4To8(c2[c]) + d;
+        paint[3][c] = extend4To8(c2[c]) - d;
+    }
+    decode_paint_colors(w, paint, pOut);
+}
+
+static void decode_planar_mode(uint64_t w, etc2_byte *pOut) {
+    int o[3] = {
+        extend6To8((int)((w >> 57) & 0x3F)),
+        extend7To8((int)((((w >> 56) & 1) << 6) | ((w >> 49) & 0x3F))),
+        extend6To8((int)((((w >> 48) & 1) << 5) | (((w >> 43) & 3) << 3) | ((w >> 39) & 7)))};
+    int h[3] = {
+        extend6To8((int)((((w >> 34) & 0x1F) << 1) | ((w >> 32) & 1))),
+        extend7To8((int)((w >> 25) & 0x7F)),
+        extend6To8((int)((w >> 19) & 0x3F))};
+    int v[3] = {
+        extend6To8((int)((w >> 13) & 0x3F)),
+        extend7To8((int)((w >> 6) & 0x7F)),
+        extend6To8((int)(w & 0x3F))};
+    for (int y = 0; y < 4; ++y) {
+        for (int x = 0; x < 4; ++x) {
+            int rgb[3];
+            for (int c = 0; c < 3; ++c) {
+                rgb[c] = (x * (h[c] - o[c]) + y * (v[c] - o[c]) + 4 * o[c] + 2) >> 2;
+            }
+            setPixel(pOut, x, y, rgb[0], rgb[1], rgb[2]);
+        }
+    }
+}
+
+static void decode_color_block(const etc2_byte *pIn, etc2_byte *pOut) {
+    uint64_t w = readBEUint64(pIn);
+    if (w & (1ULL << 33)) {
+        int r = (int)((w >> 59) & 0x1F) + kLookup[(w >> 56) & 7];
+        int g = (int)((w >> 51) & 0x1F) + kLookup[(w >> 48) & 7];
+        int b = (int)((w >> 43) & 0x1F) + kLookup[(w >> 40) & 7];
+        if (r < 0 || r > 31) {
+            decode_t_mode(w, pOut);
+            return;
+        }
+        if (g < 0 || g > 31) {
+            decode_h_mode(w, pOut);
+            return;
+        }
+        if (b < 0 || b > 31) {
+            decode_planar_mode(w, pOut);
+            return;
+        }
+    }
+    decode_etc1_modes(w, pOut);
+}
+
+static void decode_alpha_block(const etc2_byte *pIn, etc2_byte *pOut) {
+    uint64_t w = readBEUint64(pIn);
+    int base = (int)(w >> 56);
+    int multiplier = (int)((w >> 52) & 0xF);
+    const int *table = kAlphaModifierTable[(w >> 48) & 0xF];
+    // Alpha indices are stored column by column, 3 bits each.
+    for (int i = 0; i < 16; ++i) {
+        int x = i >> 2;
+        int y = i & 3;
+        int index = (int)((w >> (45 - 3 * i)) & 7);
+        pOut[4 * (x + 4 * y) + 3] = clamp(base + table[index] * multiplier);
+    }
+}
+
+// Decode a block of pixels.
+
+void etc2_decode_block(const etc2_byte *pIn, etc2_uint32 format, etc2_byte *pOut) {
+    if (format == ETC2_RGBA_NO_MIPMAPS) {
+        decode_color_block(pIn + 8, pOut);
+        decode_alpha_block(pIn, pOut);
+    } else {
+        decode_color_block(pIn, pOut);
+    }
+}
+
+// Decode an entire image.
+
+int etc2_decode_image(const etc2_byte *pIn, etc2_uint32 format, etc2_byte *pOut,
+                      etc2_uint32 width, etc2_uint32 height, etc2_uint32 stride) {
+    if (format != ETC2_RGB_NO_MIPMAPS && format != ETC2_RGBA_NO_MIPMAPS) {
+        return -1;
+    }
+    etc2_uint32 blockSize = format == ETC2_RGBA_NO_MIPMAPS ? ETC2_RGBA_ENCODED_BLOCK_SIZE : ETC2_RGB_ENCODED_BLOCK_SIZE;
+    etc2_byte block[ETC2_DECODED_BLOCK_SIZE];
+
+    for (etc2_uint32 y = 0; y < height; y += 4) {
+        etc2_uint32 yEnd = height - y < 4 ? height - y : 4;
+        for (etc2_uint32 x = 0; x < width; x += 4) {
+            etc2_uint32 xEnd = width - x < 4 ? width - x : 4;
+            etc2_decode_block(pIn, format, block);
+            pIn += blockSize;
+            for (etc2_uint32 cy = 0; cy < yEnd; cy++) {
+                memcpy(pOut + 4 * x + stride * (y + cy), block + 16 * cy, 4 * xEnd);
+            }
+        }
+    }
+    return 0;
+}
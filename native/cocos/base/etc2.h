@@ -51,6 +51,15 @@ extern "C" {
 #define ETC2_RGB_NO_MIPMAPS  1
 #define ETC2_RGBA_NO_MIPMAPS 3
 
+// Size of a block of ETC2 RGB or ETC2 RGBA (EAC alpha followed by color) data, in bytes.
+
+#define ETC2_RGB_ENCODED_BLOCK_SIZE  8
+#define ETC2_RGBA_ENCODED_BLOCK_SIZE 16
+
+// Size of a decoded 4 x 4 block of RGBA pixels, in bytes.
+
+#define ETC2_DECODED_BLOCK_SIZE 64
+
 // Check if a PKM header is correctly formatted.
 
 etc2_bool etc2_pkm_is_valid(const etc2_byte *pHeader);
@@ -67,6 +76,24 @@ etc2_uint32 etc2_pkm_get_height(const etc2_byte *pHeader);
 
 etc2_uint32 etc2_pkm_get_format(const etc2_byte *pHeader);
 
+// Decode a block of pixels.
+//
+// pIn is an ETC2 compressed block, format is ETC2_RGB_NO_MIPMAPS or ETC2_RGBA_NO_MIPMAPS.
+//
+// pOut is a pointer to a ETC2_DECODED_BLOCK_SIZE array of bytes that represent a
+// 4 x 4 square of 4-byte pixels in form R, G, B, A. Byte (4 * (x + 4 * y) is the R
+// value of pixel (x, y). Alpha is 255 for ETC2_RGB_NO_MIPMAPS.
+
+void etc2_decode_block(const etc2_byte *pIn, etc2_uint32 format, etc2_byte *pOut);
+
+// Decode an entire image to R, G, B, A pixels.
+// pIn - pointer to encoded data.
+// pOut - pointer to the image data. Pixel (x,y) is at pOut + 4 * x + stride * y.
+// returns non-zero if there is an error.
+
+int etc2_decode_image(const etc2_byte *pIn, etc2_uint32 format, etc2_byte *pOut,
+                      etc2_uint32 width, etc2_uint32 height, etc2_uint32 stride);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,104 @@
+/****************************************************************************
+ Copyright (c) 2020-2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+
+#include "NativeJobGraph.h"
+
+namespace cc {
+
+namespace {
+// slices created per worker for each for-each job, so that uneven workloads can be balanced by stealing
+constexpr uint32_t SLICES_PER_WORKER = 4U;
+} // namespace
+
+NativeJobNode &NativeJobGraph::addNode() {
+    CC_ASSERT(!_pending);
+    NativeJobNode &node = _nodes.emplace_back();
+    node.graph = this;
+    return node;
+}
+
+void NativeJobGraph::addSlices(NativeJobNode &node, uint32_t begin, uint32_t end, uint32_t step) {
+    if (end <= begin || step == 0U) return;
+
+    uint32_t iterations = (end - begin - 1U) / step + 1U;
+    // the thread waiting for the graph will help executing as well
+    uint32_t sliceCount = std::min(iterations, (_system->threadCount() + 1U) * SLICES_PER_WORKER);
+    node.slices.reserve(sliceCount);
+
+    for (uint32_t i = 0U; i < sliceCount; ++i) {
+        uint32_t first = static_cast<uint32_t>(static_cast<uint64_t>(iterations) * i / sliceCount);
+        uint32_t last = static_cast<uint32_t>(static_cast<uint64_t>(iterations) * (i + 1U) / sliceCount);
+
+        NativeJobNode &slice = _slices.emplace_back();
+        slice.graph = this;
+        slice.parent = &node;
+        slice.task = [parent = &node, first, last, begin, step]() {
+            for (uint32_t j = first; j < last; ++j) {
+                parent->indexTask(begin + j * step);
+            }
+        };
+        node.slices.push_back(&slice);
+    }
+}
+
+void NativeJobGraph::makeEdge(uint32_t j1, uint32_t j2) noexcept {
+    CC_ASSERT(!_pending && j1 != j2);
+    _nodes[j1].successors.push_back(&_nodes[j2]);
+    ++_nodes[j2].predecessorCount;
+}
+
+void NativeJobGraph::run() noexcept {
+    if (_pending || _nodes.empty()) return;
+
+    // every counter has to be reset before the first job is submitted
+    _remaining.store(static_cast<uint32_t>(_nodes.size()), std::memory_order_relaxed);
+    for (auto &node : _nodes) {
+        node.pendingPredecessors.store(node.predecessorCount, std::memory_order_relaxed);
+        node.unfinished.store(1U, std::memory_order_relaxed);
+    }
+    for (auto &slice : _slices) {
+        slice.unfinished.store(1U, std::memory_order_relaxed);
+    }
+    _pending = true;
+
+    for (auto &node : _nodes) {
+        if (!node.predecessorCount) {
+            _system->submit(&node);
+        }
+    }
+}
+
+void NativeJobGraph::waitForAll() noexcept {
+    if (!_pending) return;
+
+    while (_remaining.load(std::memory_order_acquire) != 0U) {
+        if (!_system->executeOne()) {
+            std::this_thread::yield();
+        }
+    }
+    _pending = false;
+}
+
+} // namespace cc
@@ -0,0 +1,103 @@
+/****************************************************************************
+ Copyright (c) 2020-2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include "NativeJobSystem.h"
+#include "base/std/container/deque.h"
+#include "base/std/container/vector.h"
+
+namespace cc {
+
+struct NativeJobNode final {
+    std::function<void()> task;
+    // only set on for-each jobs, invoked by the slices
+    std::function<void(uint32_t)> indexTask;
+    ccstd::vector<NativeJobNode *> successors;
+    // parallel slices of a for-each job
+    ccstd::vector<NativeJobNode *> slices;
+    NativeJobNode *parent{nullptr};
+    NativeJobGraph *graph{nullptr};
+    uint32_t predecessorCount{0U};
+
+    std::atomic<uint32_t> pendingPredecessors{0U};
+    // the job itself plus its unfinished slices
+    std::atomic<uint32_t> unfinished{0U};
+};
+
+class NativeJobGraph final {
+public:
+    explicit NativeJobGraph(NativeJobSystem *system) noexcept : _system(system) {}
+    NativeJobGraph(const NativeJobGraph &) = delete;
+    NativeJobGraph(NativeJobGraph &&) = delete;
+    NativeJobGraph &operator=(const NativeJobGraph &) = delete;
+    NativeJobGraph &operator=(NativeJobGraph &&) = delete;
+    ~NativeJobGraph() noexcept { waitForAll(); }
+
+    template <typename Function>
+    uint32_t createJob(Function &&func) noexcept;
+
+    template <typename Function>
+    uint32_t createForEachIndexJob(uint32_t begin, uint32_t end, uint32_t step, Function &&func) noexcept;
+
+    void makeEdge(uint32_t j1, uint32_t j2) noexcept;
+
+    void run() noexcept;
+
+    void waitForAll() noexcept;
+
+private:
+    friend class NativeJobSystem;
+
+    NativeJobNode &addNode();
+    void addSlices(NativeJobNode &node, uint32_t begin, uint32_t end, uint32_t step);
+
+    NativeJobSystem *_system{nullptr};
+
+    ccstd::deque<NativeJobNode> _nodes; // existing nodes cannot be invalidated
+    ccstd::deque<NativeJobNode> _slices;
+
+    std::atomic<uint32_t> _remaining{0U};
+    bool _pending{false};
+};
+
+template <typename Function>
+uint32_t NativeJobGraph::createJob(Function &&func) noexcept {
+    NativeJobNode &node = addNode();
+    node.task = std::forward<Function>(func);
+    return static_cast<uint32_t>(_nodes.size() - 1U);
+}
+
+template <typename Function>
+uint32_t NativeJobGraph::createForEachIndexJob(uint32_t begin, uint32_t end, uint32_t step, Function &&func) noexcept {
+    NativeJobNode &node = addNode();
+    node.indexTask = std::forward<Function>(func);
+    addSlices(node, begin, end, step);
+    return static_cast<uint32_t>(_nodes.size() - 1U);
+}
+
+} // namespace cc
@@ -0,0 +1,176 @@
+/****************************************************************************
+ Copyright (c) 2020-2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+
+#include "NativeJobSystem.h"
+#include "NativeJobGraph.h"
+#include "base/Log.h"
+
+namespace cc {
+
+namespace {
+// spins performed by an idle worker before going to sleep
+constexpr uint32_t IDLE_SPIN_COUNT = 32U;
+
+thread_local NativeJobSystem *tWorkerSystem{nullptr};
+thread_local uint32_t tWorkerIndex{0U};
+} // namespace
+
+NativeJobSystem *NativeJobSystem::_instance = nullptr;
+
+NativeJobSystem::NativeJobSystem(uint32_t threadCount) noexcept {
+    threadCount = std::max(1U, threadCount);
+    _queues.resize(threadCount);
+    _workers.reserve(threadCount);
+    for (uint32_t i = 0U; i < threadCount; ++i) {
+        _workers.emplace_back(&NativeJobSystem::workerLoop, this, i);
+    }
+    CC_LOG_INFO("Native job system initialized: %d worker threads", threadCount);
+}
+
+NativeJobSystem::~NativeJobSystem() {
+    _running.store(false);
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _sleepCondition.notify_all();
+    }
+    for (auto &worker : _workers) {
+        worker.join();
+    }
+}
+
+void NativeJobSystem::submit(NativeJobNode *job) {
+    uint32_t queueIndex = tWorkerSystem == this
+                              ? tWorkerIndex
+                              : _nextQueue.fetch_add(1U, std::memory_order_relaxed) % static_cast<uint32_t>(_queues.size());
+    // count first so that the counter never falls behind the actual queue sizes
+    _queuedJobs.fetch_add(1U);
+    {
+        WorkerQueue &queue = _queues[queueIndex];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(job);
+    }
+    if (_sleepingWorkers.load() > 0U) {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _sleepCondition.notify_one();
+    }
+}
+
+NativeJobNode *NativeJobSystem::pop(uint32_t queueIndex) {
+    WorkerQueue &queue = _queues[queueIndex];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.jobs.empty()) return nullptr;
+    NativeJobNode *job = queue.jobs.back();
+    queue.jobs.pop_back();
+    return job;
+}
+
+NativeJobNode *NativeJobSystem::steal(uint32_t startIndex) {
+    auto queueCount = static_cast<uint32_t>(_queues.size());
+    for (uint32_t i = 0U; i < queueCount; ++i) {
+        WorkerQueue &queue = _queues[(startIndex + i) % queueCount];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.jobs.empty()) continue;
+        NativeJobNode *job = queue.jobs.front();
+        queue.jobs.pop_front();
+        return job;
+    }
+    return nullptr;
+}
+
+bool NativeJobSystem::executeOne() {
+    if (_queuedJobs.load(std::memory_order_relaxed) == 0U) return false;
+
+    NativeJobNode *job = nullptr;
+    if (tWorkerSystem == this) {
+        job = pop(tWorkerIndex);
+        if (!job) job = steal(tWorkerIndex + 1U);
+    } else {
+        job = steal(_nextQueue.load(std::memory_order_relaxed));
+    }
+    if (!job) return false;
+
+    _queuedJobs.fetch_sub(1U);
+    execute(job);
+    return true;
+}
+
+void NativeJobSystem::execute(NativeJobNode *job) {
+    if (!job->slices.empty()) {
+        // expose all but the first slice to thieves, then work on the first one right away
+        job->unfinished.fetch_add(static_cast<uint32_t>(job->slices.size()), std::memory_order_relaxed);
+        for (size_t i = 1; i < job->slices.size(); ++i) {
+            submit(job->slices[i]);
+        }
+        execute(job->slices[0]);
+    } else if (job->task) {
+        job->task();
+    }
+    finish(job);
+}
+
+void NativeJobSystem::finish(NativeJobNode *job) { // NOLINT(misc-no-recursion)
+    if (job->unfinished.fetch_sub(1U, std::memory_order_acq_rel) != 1U) return;
+
+    if (job->parent) {
+        finish(job->parent);
+        return;
+    }
+
+    for (NativeJobNode *successor : job->successors) {
+        if (successor->pendingPredecessors.fetch_sub(1U, std::memory_order_acq_rel) == 1U) {
+            submit(successor);
+        }
+    }
+    // the graph may be destroyed right after the last job is retired
+    job->graph->_remaining.fetch_sub(1U, std::memory_order_release);
+}
+
+void NativeJobSystem::workerLoop(uint32_t index) {
+    tWorkerSystem = this;
+    tWorkerIndex = index;
+
+    uint32_t idleSpins = 0U;
+    while (true) {
+        if (executeOne()) {
+            idleSpins = 0U;
+            continue;
+        }
+        if (++idleSpins < IDLE_SPIN_COUNT) {
+            std::this_thread::yield();
+            continue;
+        }
+        idleSpins = 0U;
+
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        _sleepingWorkers.fetch_add(1U);
+        _sleepCondition.wait(lock, [this]() {
+            return _queuedJobs.load() > 0U || !_running.load();
+        });
+        _sleepingWorkers.fetch_sub(1U);
+        if (!_running.load() && _queuedJobs.load() == 0U) break;
+    }
+}
+
+} // namespace cc
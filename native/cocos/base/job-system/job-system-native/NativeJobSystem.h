@@ -0,0 +1,109 @@
+/****************************************************************************
+ Copyright (c) 2020-2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "base/Macros.h"
+#include "base/memory/Memory.h"
+#include "base/std/container/deque.h"
+#include "base/std/container/vector.h"
+
+namespace cc {
+
+using NativeJobToken = void;
+
+class NativeJobGraph;
+struct NativeJobNode;
+
+/**
+ * Dependency-free work-stealing scheduler.
+ * Every worker owns a deque: the owner pushes and pops at the back (LIFO, cache friendly),
+ * idle workers steal from the front of other deques (FIFO, oldest and usually largest work).
+ * Threads waiting on a graph help executing jobs instead of blocking.
+ */
+class NativeJobSystem final {
+public:
+    static NativeJobSystem *getInstance() {
+        if (!_instance) {
+            _instance = ccnew NativeJobSystem;
+        }
+        return _instance;
+    }
+
+    static void destroyInstance() {
+        CC_SAFE_DELETE(_instance);
+    }
+
+    NativeJobSystem() noexcept : NativeJobSystem(defaultThreadCount()) {}
+    explicit NativeJobSystem(uint32_t threadCount) noexcept;
+    NativeJobSystem(const NativeJobSystem &) = delete;
+    NativeJobSystem(NativeJobSystem &&) = delete;
+    NativeJobSystem &operator=(const NativeJobSystem &) = delete;
+    NativeJobSystem &operator=(NativeJobSystem &&) = delete;
+    ~NativeJobSystem();
+
+    inline uint32_t threadCount() const { return static_cast<uint32_t>(_workers.size()); }
+
+private:
+    friend class NativeJobGraph;
+
+    struct WorkerQueue {
+        std::mutex mutex;
+        ccstd::deque<NativeJobNode *> jobs;
+    };
+
+    static uint32_t defaultThreadCount() {
+        uint32_t hardwareThreads = std::thread::hardware_concurrency();
+        return std::max(2U, hardwareThreads > 2U ? hardwareThreads - 2U : 0U);
+    }
+
+    void submit(NativeJobNode *job);
+    NativeJobNode *pop(uint32_t queueIndex);
+    NativeJobNode *steal(uint32_t startIndex);
+    // returns false if there is no job available at the moment
+    bool executeOne();
+    void execute(NativeJobNode *job);
+    void finish(NativeJobNode *job);
+    void workerLoop(uint32_t index);
+
+    static NativeJobSystem *_instance;
+
+    ccstd::vector<std::thread> _workers;
+    ccstd::deque<WorkerQueue> _queues; // non-movable elements
+    std::atomic<uint32_t> _queuedJobs{0U};
+    std::atomic<uint32_t> _nextQueue{0U};
+    std::atomic<uint32_t> _sleepingWorkers{0U};
+    std::atomic<bool> _running{true};
+
+    std::mutex _sleepMutex;
+    std::condition_variable _sleepCondition;
+};
+
+} // namespace cc
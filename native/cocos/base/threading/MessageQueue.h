@@ -31,7 +31,9 @@
 
 namespace cc {
 
-// TODO(YunHsiao): thread-specific allocators
+// Backing memory for message chunks. Both queues pool their chunks per producer
+// (MessageQueue::MemoryAllocator, and the thread-local producer contexts of
+// MultiProducerMessageQueue), so this is only reached when a pool runs dry.
 template <typename T>
 inline T *memoryAllocateForMultiThread(uint32_t const count) noexcept {
     return static_cast<T *>(malloc(sizeof(T) * count));
@@ -63,6 +65,7 @@ private:
     Message *_next; // explicitly assigned beforehand, don't init the member here
 
     friend class MessageQueue;
+    friend class MultiProducerMessageQueue;
 };
 
 // structs may be padded
@@ -255,14 +258,14 @@ T *MessageQueue::allocateAndZero(uint32_t const count) noexcept {
 
 // utility macros for the producer thread to enqueue messages
 
-#define WRITE_MESSAGE(queue, MessageName, Params)                                \
-    {                                                                            \
-        if (!queue->isImmediateMode()) {                                         \
-            ccnew_placement(queue->allocate<MessageName>(1)) MessageName Params; \
-        } else {                                                                 \
-            MessageName msg Params;                                              \
-            msg.execute();                                                       \
-        }                                                                        \
+#define WRITE_MESSAGE(queue, MessageName, Params)                                         \
+    {                                                                                     \
+        if (!queue->isImmediateMode()) {                                                  \
+            ccnew_placement(queue->template allocate<MessageName>(1)) MessageName Params; \
+        } else {                                                                          \
+            MessageName msg Params;                                                       \
+            msg.execute();                                                                \
+        }                                                                                 \
     }
 
 #define ENQUEUE_MESSAGE_0(queue, MessageName, Code)         \
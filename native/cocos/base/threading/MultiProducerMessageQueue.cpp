@@ -0,0 +1,284 @@
+/****************************************************************************
+ Copyright (c) 2020-2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+
+#include "MultiProducerMessageQueue.h"
+#include "AutoReleasePool.h"
+#include <limits>
+#include "base/std/container/unordered_map.h"
+
+namespace cc {
+
+class MultiProducerMessageQueue::TerminateMessage final : public Message {
+public:
+    TerminateMessage(MultiProducerMessageQueue *queue, EventSem *event) noexcept
+    : _queue(queue), _event(event) {}
+
+    void execute() noexcept override {
+        _queue->_terminateConsumerThread = true;
+        _event->signal();
+    }
+    char const *getName() const noexcept override { return "TerminateConsumerThread"; }
+
+private:
+    MultiProducerMessageQueue *_queue{nullptr};
+    EventSem *_event{nullptr};
+};
+
+namespace {
+std::atomic<uint64_t> queueIdCounter{0};
+
+// the tail of every chunk links it into the retired list, messages may still live in the rest of it
+constexpr uint32_t CHUNK_LINK_MEMORY_REQUIREMENT = 16;
+constexpr uint32_t USABLE_CHUNK_SIZE = MultiProducerMessageQueue::MEMORY_CHUNK_SIZE - CHUNK_LINK_MEMORY_REQUIREMENT;
+} // namespace
+
+MultiProducerMessageQueue::MultiProducerMessageQueue()
+: _id(queueIdCounter.fetch_add(1, std::memory_order_relaxed)) {
+}
+
+MultiProducerMessageQueue::~MultiProducerMessageQueue() {
+    terminateConsumerThread();
+
+    for (auto &producer : _producers) {
+        for (uint8_t *chunk : producer->allocatedChunks) {
+            memoryFreeForMultiThread(chunk);
+        }
+    }
+}
+
+void MultiProducerMessageQueue::kick() noexcept {
+    ProducerContext &context = getProducerContext();
+    if (!context.firstMessage) return;
+
+    // may switch chunks and retire the current one, so take the retired list afterwards
+    auto *const batch = reinterpret_cast<MessageBatch *>(allocateImpl(context, sizeof(MessageBatch)));
+    batch->first = context.firstMessage;
+    batch->last = context.lastMessage;
+    batch->context = &context;
+    batch->retiredChunks = context.retiredChunks;
+    context.firstMessage = nullptr;
+    context.lastMessage = nullptr;
+    context.retiredChunks = nullptr;
+
+    MessageBatch *head = _publishedBatches.load(std::memory_order_relaxed);
+    do {
+        batch->next = head;
+    } while (!_publishedBatches.compare_exchange_weak(head, batch, std::memory_order_seq_cst, std::memory_order_relaxed));
+
+    // pairs with the store in waitForMessages, the mutex is only taken when the consumer is asleep
+    if (_consumerWaiting.load(std::memory_order_seq_cst)) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _condVar.notify_all();
+    }
+}
+
+void MultiProducerMessageQueue::kickAndWait() noexcept {
+    EventSem event;
+    EventSem *const pEvent = &event;
+
+    ENQUEUE_MESSAGE_1(this, WaitUntilFinish,
+                      pEvent, pEvent,
+                      {
+                          pEvent->signal();
+                      });
+
+    if (_immediateMode) return;
+
+    kick();
+    if (_consumerThread) {
+        event.wait();
+    } else {
+        flushMessages();
+    }
+}
+
+void MultiProducerMessageQueue::runConsumerThread() noexcept {
+    if (_immediateMode || _consumerThread) return;
+
+    _terminateConsumerThread = false;
+    _consumerThread = ccnew std::thread(&MultiProducerMessageQueue::consumerThreadLoop, this);
+}
+
+void MultiProducerMessageQueue::terminateConsumerThread() noexcept {
+    if (!_consumerThread) return;
+
+    EventSem event;
+    ccnew_placement(allocate<TerminateMessage>(1)) TerminateMessage(this, &event);
+
+    kick();
+    event.wait();
+
+    if (_consumerThread->joinable()) {
+        _consumerThread->join();
+    }
+    CC_SAFE_DELETE(_consumerThread);
+}
+
+void MultiProducerMessageQueue::flushMessages() noexcept {
+    CC_ASSERT(!_consumerThread);
+    while (executeMessages()) {
+    }
+}
+
+MultiProducerMessageQueue::ProducerContext &MultiProducerMessageQueue::getProducerContext() noexcept {
+    // queue ids are never reused, so entries of destroyed queues are simply never hit again
+    thread_local uint64_t cachedId{std::numeric_limits<uint64_t>::max()};
+    thread_local ProducerContext *cachedContext{nullptr};
+    if (cachedId == _id) return *cachedContext;
+
+    thread_local ccstd::unordered_map<uint64_t, ProducerContext *> contexts;
+    ProducerContext *&context = contexts[_id];
+    if (!context) {
+        std::lock_guard<std::mutex> lock(_producersMutex);
+        _producers.emplace_back(std::make_unique<ProducerContext>());
+        context = _producers.back().get();
+    }
+
+    cachedId = _id;
+    cachedContext = context;
+    return *context;
+}
+
+// NOLINTNEXTLINE(misc-no-recursion)
+uint8_t *MultiProducerMessageQueue::allocateImpl(ProducerContext &context, uint32_t const requestSize) noexcept {
+    uint32_t const alignedSize = align(requestSize, 16);
+    CC_ASSERT(alignedSize <= USABLE_CHUNK_SIZE);
+
+    if (!context.currentMemoryChunk) {
+        context.currentMemoryChunk = requestChunk(context);
+    }
+
+    uint32_t const newOffset = context.offset + alignedSize;
+    if (newOffset <= USABLE_CHUNK_SIZE) {
+        uint8_t *const allocatedMemory = context.currentMemoryChunk + context.offset;
+        context.offset = newOffset;
+        return allocatedMemory;
+    }
+
+    uint8_t *const oldChunk = context.currentMemoryChunk;
+    context.currentMemoryChunk = requestChunk(context);
+    context.offset = 0;
+
+    if (_immediateMode) {
+        // nothing is queued, but the old chunk goes to the back of the line
+        context.freeChunks.insert(context.freeChunks.begin(), oldChunk);
+    } else {
+        // payloads in the old chunk may belong to messages not written yet,
+        // so the chunk is handed back only after the next published batch has executed
+        retiredChunkLink(oldChunk) = context.retiredChunks;
+        context.retiredChunks = oldChunk;
+    }
+
+    return allocateImpl(context, requestSize);
+}
+
+void MultiProducerMessageQueue::pushMessage(ProducerContext &context, Message *const msg) noexcept {
+    if (context.lastMessage) {
+        context.lastMessage->_next = msg;
+    } else {
+        context.firstMessage = msg;
+    }
+    context.lastMessage = msg;
+}
+
+uint8_t *MultiProducerMessageQueue::requestChunk(ProducerContext &context) noexcept {
+    if (context.freeChunks.empty()) {
+        uint8_t *chunk = context.returnedChunks.exchange(nullptr, std::memory_order_acquire);
+        while (chunk) {
+            context.freeChunks.push_back(chunk);
+            chunk = *reinterpret_cast<uint8_t **>(chunk);
+        }
+    }
+
+    if (!context.freeChunks.empty()) {
+        uint8_t *const chunk = context.freeChunks.back();
+        context.freeChunks.pop_back();
+        return chunk;
+    }
+
+    uint8_t *const chunk = memoryAllocateForMultiThread<uint8_t>(MEMORY_CHUNK_SIZE);
+    context.allocatedChunks.push_back(chunk);
+    return chunk;
+}
+
+void MultiProducerMessageQueue::returnChunk(ProducerContext &context, uint8_t *const chunk) noexcept {
+    uint8_t *head = context.returnedChunks.load(std::memory_order_relaxed);
+    do {
+        *reinterpret_cast<uint8_t **>(chunk) = head;
+    } while (!context.returnedChunks.compare_exchange_weak(head, chunk, std::memory_order_release, std::memory_order_relaxed));
+}
+
+uint8_t *&MultiProducerMessageQueue::retiredChunkLink(uint8_t *const chunk) noexcept {
+    return *reinterpret_cast<uint8_t **>(chunk + USABLE_CHUNK_SIZE);
+}
+
+bool MultiProducerMessageQueue::executeMessages() noexcept {
+    MessageBatch *batch = _publishedBatches.exchange(nullptr, std::memory_order_acquire);
+    if (!batch) return false;
+
+    // batches are stacked in reverse publishing order, and the batch nodes
+    // live in chunks which may be retired by the batches, so copy them out first
+    _executingBatches.clear();
+    for (; batch; batch = batch->next) {
+        _executingBatches.push_back(*batch);
+    }
+
+    for (auto it = _executingBatches.rbegin(); it != _executingBatches.rend(); ++it) {
+        Message *msg = it->first;
+        while (true) {
+            bool const isLast = msg == it->last;
+            Message *const next = isLast ? nullptr : msg->getNext();
+            msg->execute();
+            msg->~Message();
+            if (isLast) break;
+            msg = next;
+        }
+
+        for (uint8_t *chunk = it->retiredChunks; chunk;) {
+            uint8_t *const nextChunk = retiredChunkLink(chunk);
+            returnChunk(*it->context, chunk);
+            chunk = nextChunk;
+        }
+    }
+    return true;
+}
+
+void MultiProducerMessageQueue::waitForMessages() noexcept {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _consumerWaiting.store(true, std::memory_order_seq_cst);
+    _condVar.wait(lock, [this]() { return _publishedBatches.load(std::memory_order_seq_cst) != nullptr; });
+    _consumerWaiting.store(false, std::memory_order_relaxed);
+}
+
+void MultiProducerMessageQueue::consumerThreadLoop() noexcept {
+    while (!_terminateConsumerThread) {
+        AutoReleasePool autoReleasePool;
+        if (!executeMessages()) {
+            waitForMessages();
+        }
+    }
+}
+
+} // namespace cc
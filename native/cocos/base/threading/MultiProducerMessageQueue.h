@@ -0,0 +1,175 @@
+/****************************************************************************
+ Copyright (c) 2020-2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "MessageQueue.h"
+#include "base/std/container/vector.h"
+
+namespace cc {
+
+// structs may be padded
+#if (CC_COMPILER == CC_COMPILER_MSVC)
+    #pragma warning(disable : 4324)
+#endif
+
+// A multi-producer single-consumer message queue.
+// Every producer thread writes into memory chunks from its own thread-local chunk allocator,
+// and publishes the pending messages as one batch with a lock-free push on `kick`.
+// Messages from the same producer are executed in submission order,
+// there is no ordering guarantee between different producers.
+// Enqueuing is compatible with the `ENQUEUE_MESSAGE_*` macros.
+class ALIGNAS(64) MultiProducerMessageQueue final {
+public:
+    static constexpr uint32_t MEMORY_CHUNK_SIZE = MessageQueue::MEMORY_CHUNK_SIZE;
+
+    MultiProducerMessageQueue();
+    ~MultiProducerMessageQueue();
+    MultiProducerMessageQueue(MultiProducerMessageQueue const &) = delete;
+    MultiProducerMessageQueue(MultiProducerMessageQueue &&) = delete;
+    MultiProducerMessageQueue &operator=(MultiProducerMessageQueue const &) = delete;
+    MultiProducerMessageQueue &operator=(MultiProducerMessageQueue &&) = delete;
+
+    // message allocation
+    template <typename T>
+    std::enable_if_t<std::is_base_of<Message, T>::value, T *>
+    allocate(uint32_t count) noexcept;
+
+    // general-purpose allocation
+    template <typename T>
+    std::enable_if_t<!std::is_base_of<Message, T>::value, T *>
+    allocate(uint32_t count) noexcept;
+    template <typename T>
+    T *allocateAndCopy(uint32_t count, void const *data) noexcept;
+    template <typename T>
+    T *allocateAndZero(uint32_t count) noexcept;
+
+    // publish the messages written by the calling thread and notify the consumer
+    void kick() noexcept;
+
+    // publish the messages written by the calling thread and block it until they are executed
+    void kickAndWait() noexcept;
+
+    void runConsumerThread() noexcept;
+    void terminateConsumerThread() noexcept;
+
+    // execute all the published messages on the calling thread, only valid without a consumer thread
+    void flushMessages() noexcept;
+
+    inline bool isImmediateMode() const noexcept { return _immediateMode; }
+    inline void setImmediateMode(bool immediateMode) noexcept { _immediateMode = immediateMode; }
+
+private:
+    struct ProducerContext;
+
+    struct MessageBatch final {
+        MessageBatch *next{nullptr};
+        Message *first{nullptr};
+        Message *last{nullptr};
+        ProducerContext *context{nullptr};
+        uint8_t *retiredChunks{nullptr}; // handed back to the producer once the batch has executed
+    };
+
+    struct ALIGNAS(64) ProducerContext final {
+        uint8_t *currentMemoryChunk{nullptr};
+        uint32_t offset{0};
+        Message *firstMessage{nullptr}; // written but not published yet
+        Message *lastMessage{nullptr};
+        ccstd::vector<uint8_t *> freeChunks;      // only touched by the producer
+        ccstd::vector<uint8_t *> allocatedChunks; // only touched by the producer
+        uint8_t *retiredChunks{nullptr};                // switched away from, but not published with a batch yet
+        std::atomic<uint8_t *> returnedChunks{nullptr}; // intrusive list pushed by the consumer
+    };
+
+    class TerminateMessage;
+
+    ProducerContext &getProducerContext() noexcept;
+    uint8_t *allocateImpl(ProducerContext &context, uint32_t requestSize) noexcept;
+    static void pushMessage(ProducerContext &context, Message *msg) noexcept;
+    static uint8_t *requestChunk(ProducerContext &context) noexcept;
+    static void returnChunk(ProducerContext &context, uint8_t *chunk) noexcept;
+    static uint8_t *&retiredChunkLink(uint8_t *chunk) noexcept;
+
+    // consumer specifics
+    bool executeMessages() noexcept;
+    void waitForMessages() noexcept;
+    void consumerThreadLoop() noexcept;
+
+    std::atomic<MessageBatch *> _publishedBatches{nullptr};
+    std::atomic<bool> _consumerWaiting{false};
+    std::mutex _mutex;
+    std::condition_variable _condVar;
+    ccstd::vector<MessageBatch> _executingBatches;
+    bool _terminateConsumerThread{false};
+
+    std::mutex _producersMutex;
+    ccstd::vector<std::unique_ptr<ProducerContext>> _producers;
+    uint64_t const _id;
+
+    bool _immediateMode{true};
+    std::thread *_consumerThread{nullptr};
+};
+
+#if (CC_COMPILER == CC_COMPILER_MSVC)
+    #pragma warning(default : 4324)
+#endif
+
+template <typename T>
+std::enable_if_t<std::is_base_of<Message, T>::value, T *>
+MultiProducerMessageQueue::allocate(uint32_t const /*count*/) noexcept {
+    ProducerContext &context = getProducerContext();
+    T *const msg = reinterpret_cast<T *>(allocateImpl(context, sizeof(T)));
+    pushMessage(context, msg);
+    return msg;
+}
+
+template <typename T>
+std::enable_if_t<!std::is_base_of<Message, T>::value, T *>
+MultiProducerMessageQueue::allocate(uint32_t const count) noexcept {
+    uint32_t const requestSize = sizeof(T) * count;
+    CC_ASSERT(requestSize);
+    return reinterpret_cast<T *>(allocateImpl(getProducerContext(), requestSize));
+}
+
+template <typename T>
+T *MultiProducerMessageQueue::allocateAndCopy(uint32_t const count, void const *data) noexcept {
+    T *const allocatedMemory = allocate<T>(count);
+    memcpy(allocatedMemory, data, sizeof(T) * count);
+    return allocatedMemory;
+}
+
+template <typename T>
+T *MultiProducerMessageQueue::allocateAndZero(uint32_t const count) noexcept {
+    T *const allocatedMemory = allocate<T>(count);
+    memset(allocatedMemory, 0, sizeof(T) * count);
+    return allocatedMemory;
+}
+
+} // namespace cc
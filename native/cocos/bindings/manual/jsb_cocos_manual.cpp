@@ -636,6 +636,37 @@ static bool js_engine_FileUtils_listFilesRecursively(se::State &s) { // NOLINT(r
 }
 SE_BIND_FUNC(js_engine_FileUtils_listFilesRecursively) // NOLINT(readability-identifier-naming)
 
+static bool js_engine_FileUtils_mapFile(se::State &s) { // NOLINT(readability-identifier-naming)
+    auto *cobj = static_cast<cc::FileUtils *>(s.nativeThisObject());
+    SE_PRECONDITION2(cobj, false, "Invalid Native Object");
+    const auto &args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        ccstd::string arg0;
+        ok &= sevalue_to_native(args[0], &arg0);
+        SE_PRECONDITION2(ok, false, "Error processing arguments");
+        auto file = cobj->mapFile(arg0);
+        if (!file) {
+            s.rval().setNull();
+            return true;
+        }
+        // the ArrayBuffer keeps the file alive, its private mapping tolerates writes from scripts
+        auto *data = const_cast<uint8_t *>(file->getBytes());
+        file->addRef();
+        se::HandleObject buffer(se::Object::createExternalArrayBufferObject(
+            data, file->getSize(), [](void * /*contents*/, size_t /*byteLength*/, void *userData) {
+                static_cast<cc::MappedFile *>(userData)->release();
+            },
+            file.get()));
+        s.rval().setObject(buffer);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_engine_FileUtils_mapFile) // NOLINT(readability-identifier-naming)
+
 static bool js_se_setExceptionCallback(se::State &s) { // NOLINT(readability-identifier-naming)
     const auto &args = s.args();
     if (args.size() != 1 || !args[0].isObject() || !args[0].toObject()->isFunction()) {
@@ -674,6 +705,7 @@ SE_BIND_FUNC(js_se_setExceptionCallback) // NOLINT(readability-identifier-naming
 
 static bool register_filetuils_ext(se::Object * /*obj*/) { // NOLINT(readability-identifier-naming)
     __jsb_cc_FileUtils_proto->defineFunction("listFilesRecursively", _SE(js_engine_FileUtils_listFilesRecursively));
+    __jsb_cc_FileUtils_proto->defineFunction("mapFile", _SE(js_engine_FileUtils_mapFile));
     return true;
 }
 
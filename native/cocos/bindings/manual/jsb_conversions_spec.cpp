@@ -348,6 +348,20 @@ bool seval_to_DownloaderHints(const se::Value &v, cc::network::DownloaderHints *
     SE_PRECONDITION3(ok && tmp.isString(), false, *ret = ZERO);
     ret->tempFileNameSuffix = tmp.toString();
 
+    // optional, only used by the curl downloader
+    if (obj->getProperty("countOfMaxRangesPerTask", &tmp) && tmp.isNumber()) {
+        ret->countOfMaxRangesPerTask = tmp.toUint32();
+    }
+    if (obj->getProperty("minRangeSizeInBytes", &tmp) && tmp.isNumber()) {
+        ret->minRangeSizeInBytes = tmp.toUint32();
+    }
+    if (obj->getProperty("countOfRetriesPerRange", &tmp) && tmp.isNumber()) {
+        ret->countOfRetriesPerRange = tmp.toUint32();
+    }
+    if (obj->getProperty("maxBytesPerSecond", &tmp) && tmp.isNumber()) {
+        ret->maxBytesPerSecond = tmp.toUint32();
+    }
+
     return ok;
 }
 
@@ -38,6 +38,7 @@
 #include "network/Downloader.h"
 #include "network/HttpClient.h"
 #include "platform/Image.h"
+#include "platform/ImageDecodeService.h"
 #include "platform/interfaces/modules/ISystem.h"
 #include "platform/interfaces/modules/ISystemWindow.h"
 #include "ui/edit-box/EditBox.h"
@@ -588,22 +589,19 @@ bool jsb_global_load_image(const ccstd::string &path, const se::Value &callbackV
     std::shared_ptr<se::Value> callbackPtr = std::make_shared<se::Value>(callbackVal);
 
     auto initImageFunc = [path, callbackPtr](const ccstd::string &fullPath, unsigned char *imageData, int imageBytes) {
-        auto *img = ccnew Image();
-
-        gThreadPool->pushTask([=](int /*tid*/) {
-            // NOTE: FileUtils::getInstance()->fullPathForFilename isn't a threadsafe method,
-            // Image::initWithImageFile will call fullPathForFilename internally which may
-            // cause thread race issues. Therefore, we get the full path of file before
-            // going into task callback.
-            // Be careful of invoking any Cocos2d-x interface in a sub-thread.
-            bool loadSucceed = false;
-            if (fullPath.empty()) {
-                loadSucceed = img->initWithImageData(imageData, imageBytes);
-                free(imageData);
-            } else {
-                loadSucceed = img->initWithImageFile(fullPath);
-            }
-
+        // NOTE: FileUtils::getInstance()->fullPathForFilename isn't a threadsafe method,
+        // Image::initWithImageFile will call fullPathForFilename internally which may
+        // cause thread race issues. Therefore, we get the full path of file before
+        // going into the decode service.
+        ImageDecodeService::DecodeRequest request;
+        if (fullPath.empty()) {
+            request.data.fastSet(imageData, static_cast<uint32_t>(imageBytes));
+        } else {
+            request.path = fullPath;
+        }
+        // runs on a decode thread, be careful of invoking any Cocos2d-x interface here.
+        request.callback = [path, callbackPtr](Image *img) {
+            const bool loadSucceed = img != nullptr;
             ImageInfo *imgInfo = nullptr;
             if (loadSucceed) {
                 imgInfo = createImageInfo(img);
@@ -611,7 +609,6 @@ bool jsb_global_load_image(const ccstd::string &path, const se::Value &callbackV
             auto app = CC_CURRENT_APPLICATION();
             if (!app) {
                 delete imgInfo;
-                delete img;
                 return;
             }
             auto engine = app->getEngine();
@@ -640,9 +637,9 @@ bool jsb_global_load_image(const ccstd::string &path, const se::Value &callbackV
                     SE_REPORT_ERROR("initWithImageFile: %s failed!", path.c_str());
                 }
                 callbackPtr->toObject()->call(seArgs, nullptr);
-                delete img;
             });
-        });
+        };
+        ImageDecodeService::getInstance()->decode(std::move(request));
     };
     size_t pos = ccstd::string::npos;
     if (path.find("http://") == 0 || path.find("https://") == 0) {
@@ -1607,6 +1604,7 @@ bool jsb_register_global_variables(se::Object *global) { // NOLINT
     se::ScriptEngine::getInstance()->addBeforeCleanupHook([]() {
         delete gThreadPool;
         gThreadPool = nullptr;
+        ImageDecodeService::destroyInstance();
 
         DeferredReleasePool::clear();
     });
@@ -25,6 +25,7 @@
 #include "core/assets/ImageAsset.h"
 
 #include "platform/Image.h"
+#include "renderer/gfx-base/GFXDevice.h"
 
 #include "base/Log.h"
 
@@ -41,6 +42,12 @@ void ImageAsset::setNativeAsset(const ccstd::any &obj) {
         auto **pImage = const_cast<Image **>(ccstd::any_cast<Image *>(&obj));
         if (pImage != nullptr) {
             Image *image = *pImage;
+            // Fall back to RGBA8 for ETC data the device can not sample.
+            auto *device = gfx::Device::getInstance();
+            if (image->isCompressed() && device != nullptr &&
+                !hasFlag(device->getFormatFeatures(image->getRenderFormat()), gfx::FormatFeatureBit::SAMPLED_TEXTURE)) {
+                image->decompress();
+            }
             image->takeData(&_data);
             _needFreeData = true;
 
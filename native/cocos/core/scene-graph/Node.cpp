@@ -69,6 +69,7 @@ Node::~Node() {
         // Reset children's _parent to nullptr to avoid dangerous pointer
         for (const auto &child : _children) {
             child->_parent = nullptr;
+            child->setHierarchyScene(nullptr);
         }
     }
 }
@@ -168,8 +169,15 @@ void Node::setParent(Node *parent, bool isKeepWorld /* = false */) {
         debug::errorID(3821);
     }
 #endif
+    if (oldParent) {
+        oldParent->invalidateHierarchyOrder();
+    }
     _parent = newParent;
     _siblingIndex = 0;
+    setHierarchyScene(newParent ? newParent->_hierarchyScene : nullptr);
+    if (newParent) {
+        newParent->invalidateHierarchyOrder();
+    }
     onSetParent(oldParent, isKeepWorld);
     emit<ParentChanged>(oldParent);
     if (oldParent) {
@@ -201,6 +209,33 @@ void Node::setParent(Node *parent, bool isKeepWorld /* = false */) {
     onHierarchyChanged(oldParent);
 }
 
+void Node::modifyParent(Node *parent) {
+    if (_parent) {
+        _parent->invalidateHierarchyOrder();
+    }
+    _parent = parent;
+    setHierarchyScene(parent ? parent->_hierarchyScene : nullptr);
+    if (parent) {
+        parent->invalidateHierarchyOrder();
+    }
+}
+
+void Node::invalidateHierarchyOrder() {
+    if (_hierarchyScene) {
+        _hierarchyScene->getTransformHierarchy().invalidateOrder();
+    }
+}
+
+void Node::setHierarchyScene(Scene *scene) { // NOLINT(misc-no-recursion)
+    if (_hierarchyScene == scene) {
+        return;
+    }
+    _hierarchyScene = scene;
+    for (const auto &child : _children) {
+        child->setHierarchyScene(scene);
+    }
+}
+
 void Node::walk(const WalkCallback &preFunc) {
     walk(preFunc, nullptr);
 }
@@ -257,6 +292,8 @@ bool Node::onPreDestroyBase() {
             index_t childIdx = getIdxOfChild(_parent->_children, this);
             if (childIdx != -1) {
                 _parent->_children.erase(_parent->_children.begin() + childIdx);
+                _parent->invalidateHierarchyOrder();
+                setHierarchyScene(nullptr);
             }
             _siblingIndex = 0;
             _parent->updateSiblingIndex();
@@ -342,6 +379,7 @@ void Node::removeAllChildren() {
         }
     }
     _children.clear();
+    invalidateHierarchyOrder();
 }
 
 void Node::setSiblingIndex(index_t index) {
@@ -364,6 +402,7 @@ void Node::setSiblingIndex(index_t index) {
         } else {
             siblings.emplace_back(this);
         }
+        _parent->invalidateHierarchyOrder();
         _parent->updateSiblingIndex();
         emit<SiblingIndexChanged>(index);
     }
@@ -515,16 +554,45 @@ Mat4 Node::getWorldRT() {
     return target;
 }
 
-void Node::invalidateChildren(TransformBit dirtyBit) { // NOLINT(misc-no-recursion)
-    auto curDirtyBit{static_cast<uint32_t>(dirtyBit)};
-    const uint32_t hasChangedFlags = getChangedFlags();
-    const uint32_t transformFlags = _transformFlags;
-    if (isValid() && (transformFlags & hasChangedFlags & curDirtyBit) != curDirtyBit) {
-        _transformFlags = (transformFlags | curDirtyBit);
-        setChangedFlags(hasChangedFlags | curDirtyBit);
+void Node::invalidateChildren(TransformBit dirtyBit) {
+    const auto rootDirtyBit{static_cast<uint32_t>(dirtyBit)};
+    const uint32_t rootChangedFlags = getChangedFlags();
+    const uint32_t rootTransformFlags = _transformFlags;
+    if (!isValid() || (rootTransformFlags & rootChangedFlags & rootDirtyBit) == rootDirtyBit) {
+        return;
+    }
+    _transformFlags = (rootTransformFlags | rootDirtyBit);
+    setChangedFlags(rootChangedFlags | rootDirtyBit);
+
+    // the transform hierarchy of the scene then only sweeps the dirty subtrees
+    if (_hierarchyScene) {
+        _hierarchyScene->getTransformHierarchy().addDirtyRoot(this);
+    }
+    if (_children.empty()) {
+        return;
+    }
+
+    // descendants all get the same bits, so walk the subtree with a stack instead of recursion.
+    // Transforms are only changed on the main thread, and nothing below calls out, so one stack is reused.
+    const auto childDirtyBit{static_cast<uint32_t>(dirtyBit | TransformBit::POSITION)};
+    static ccstd::vector<Node *> stack;
+    stack.clear();
+    for (const auto &child : _children) {
+        stack.emplace_back(child.get());
+    }
+    while (!stack.empty()) {
+        Node *node = stack.back();
+        stack.pop_back();
+
+        const uint32_t hasChangedFlags = node->getChangedFlags();
+        const uint32_t transformFlags = node->_transformFlags;
+        if (node->isValid() && (transformFlags & hasChangedFlags & childDirtyBit) != childDirtyBit) {
+            node->_transformFlags = (transformFlags | childDirtyBit);
+            node->setChangedFlags(hasChangedFlags | childDirtyBit);
 
-        for (Node *child : getChildren()) {
-            child->invalidateChildren(dirtyBit | TransformBit::POSITION);
+            for (const auto &child : node->getChildren()) {
+                stack.emplace_back(child.get());
+            }
         }
     }
 }
@@ -871,12 +939,18 @@ void Node::onHierarchyChanged(Node *oldParent) {
 //
 void Node::_setChildren(ccstd::vector<IntrusivePtr<Node>> &&children) {
     _children = std::move(children);
+    for (const auto &child : _children) {
+        child->setHierarchyScene(_hierarchyScene);
+    }
+    invalidateHierarchyOrder();
 }
 
 void Node::destruct() {
     CCObject::destruct();
     _children.clear();
+    invalidateHierarchyOrder();
     _scene = nullptr;
+    _hierarchyScene = nullptr;
     _userData = nullptr;
 }
 
@@ -137,7 +137,7 @@ public:
     virtual void onPostActivated(bool active) {}
 
     void setParent(Node *parent, bool isKeepWorld = false);
-    inline void modifyParent(Node *parent) { _parent = parent; }
+    void modifyParent(Node *parent);
 
     inline Scene *getScene() const { return _scene; };
 
@@ -479,6 +479,7 @@ public:
     }
 
     inline bool isTransformDirty() const { return _transformFlags != static_cast<uint32_t>(TransformBit::NONE); }
+
     inline void setLayer(uint32_t layer) {
         _layer = layer;
         emit<LayerChanged>(layer);
@@ -604,6 +605,10 @@ private:
 
     void inverseTransformPointRecursive(Vec3 &out) const;
     void updateWorldTransformRecursive(uint32_t &superDirtyBits);
+    // tells the scene this node is in that nodes were attached, detached or reordered below it
+    void invalidateHierarchyOrder();
+    // sets _hierarchyScene of this subtree, subtrees which already have it are skipped
+    void setHierarchyScene(Scene *scene);
 
     inline void notifyLocalPositionUpdated() {
         emit<LocalPositionUpdated>(_localPosition.x, _localPosition.y, _localPosition.z);
@@ -671,9 +676,14 @@ private:
     uint32_t _hasChangedFlags{0};
 
     bool _eulerDirty{false};
+    // position in the transform hierarchy of the scene, valid until the scene is reordered
+    uint32_t _hierarchyIndex{0};
+    // the scene at the root of this node's tree, unlike _scene it is updated on every parent change
+    Scene *_hierarchyScene{nullptr};
 
     friend class NodeActivator;
     friend class Scene;
+    friend class TransformHierarchy;
 
     CC_DISALLOW_COPY_MOVE_ASSIGN(Node);
 };
@@ -28,22 +28,29 @@
 #include "core/Root.h"
 //#include "core/scene-graph/NodeActivator.h"
 #include "engine/EngineEvents.h"
+#include "scene/RenderScene.h"
 
 namespace cc {
 
 Scene::Scene(const ccstd::string &name)
 : Node(name) {
+    _hierarchyScene = this;
     // _activeInHierarchy is initalized to 'false', so doesn't need to set it to false again
     //    _activeInHierarchy = false;
     if (Root::getInstance() != nullptr) {
         _renderScene = Root::getInstance()->createScene({});
+        _renderScene->setTransformHierarchy(&_transformHierarchy);
     }
     _globals = ccnew SceneGlobals();
 }
 
 Scene::Scene() : Scene("") {}
 
-Scene::~Scene() = default;
+Scene::~Scene() {
+    if (_renderScene) {
+        _renderScene->setTransformHierarchy(nullptr);
+    }
+}
 
 void Scene::setSceneGlobals(SceneGlobals *globals) { _globals = globals; }
 
@@ -25,6 +25,7 @@
 #pragma once
 
 #include "core/scene-graph/Node.h"
+#include "core/scene-graph/TransformHierarchy.h"
 
 namespace cc {
 class SceneGlobals;
@@ -44,6 +45,7 @@ public:
     void setSceneGlobals(SceneGlobals *globals);
     inline bool isAutoReleaseAssets() const { return _autoReleaseAssets; }
     inline void setAutoReleaseAssets(bool val) { _autoReleaseAssets = val; }
+    inline TransformHierarchy &getTransformHierarchy() { return _transformHierarchy; }
 
     void load();
     void activate(bool active = true);
@@ -61,6 +63,8 @@ protected:
      */
     //    @serializable
     IntrusivePtr<SceneGlobals> _globals;
+    // updated by the render scene once per frame, before models read their transforms
+    TransformHierarchy _transformHierarchy{this};
     bool _inited{false};
 
     /**
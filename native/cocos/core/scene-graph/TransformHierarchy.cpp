@@ -0,0 +1,159 @@
+/****************************************************************************
+ Copyright (c) 2021-2023 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos.com
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+#include "core/scene-graph/TransformHierarchy.h"
+#include <algorithm>
+#include <utility>
+#include "base/job-system/JobSystem.h"
+#include "core/scene-graph/Node.h"
+
+namespace cc {
+
+namespace {
+// below this size a single sweep is faster than dispatching jobs
+constexpr uint32_t PARALLEL_UPDATE_THRESHOLD = 4096;
+} // namespace
+
+TransformHierarchy::TransformHierarchy(Node *root)
+: _root(root) {
+}
+
+void TransformHierarchy::rebuild() {
+    _nodes.clear();
+    _subtreeEnds.clear();
+    _branches.clear();
+    _orderDirty = false;
+
+    ccstd::vector<uint32_t> parents;
+    ccstd::vector<std::pair<Node *, uint32_t>> stack;
+    stack.emplace_back(_root, 0);
+    while (!stack.empty()) {
+        const auto [node, parent] = stack.back();
+        stack.pop_back();
+
+        const auto index = static_cast<uint32_t>(_nodes.size());
+        node->_hierarchyIndex = index;
+        _nodes.emplace_back(node);
+        parents.emplace_back(parent);
+        if (index != 0 && parent == 0) {
+            _branches.emplace_back(index);
+        }
+
+        // push in reverse order, so children are visited in sibling order
+        const auto &children = node->getChildren();
+        for (auto iter = children.rbegin(); iter != children.rend(); ++iter) {
+            stack.emplace_back(iter->get(), index);
+        }
+    }
+
+    // a subtree ends where the last subtree of its children ends
+    const auto count = static_cast<uint32_t>(_nodes.size());
+    _subtreeEnds.resize(count);
+    for (uint32_t i = 0; i != count; ++i) {
+        _subtreeEnds[i] = i + 1;
+    }
+    for (uint32_t i = count - 1; i > 0; --i) {
+        auto &parentEnd = _subtreeEnds[parents[i]];
+        parentEnd = std::max(parentEnd, _subtreeEnds[i]);
+    }
+}
+
+void TransformHierarchy::update() {
+    if (!_root->isActiveInHierarchy()) {
+        // nothing is swept meanwhile, so sweep everything once the scene is active again
+        invalidateOrder();
+        return;
+    }
+    if (_orderDirty) {
+        rebuild();
+        _root->updateWorldTransform();
+        updateSubtrees(_branches, size() - 1);
+        return;
+    }
+    if (_dirtyRoots.empty()) {
+        return;
+    }
+
+    // the order is unchanged since the roots were added, so they are all still in it
+    _dirtyBegins.clear();
+    for (Node *node : _dirtyRoots) {
+        if (node->isTransformDirty()) {
+            _dirtyBegins.emplace_back(node->_hierarchyIndex);
+        }
+    }
+    _dirtyRoots.clear();
+    std::sort(_dirtyBegins.begin(), _dirtyBegins.end());
+
+    // subtrees nested in another dirty subtree are swept with it
+    uint32_t nodeCount = 0;
+    uint32_t coveredEnd = 0;
+    auto last = _dirtyBegins.begin();
+    for (const auto begin : _dirtyBegins) {
+        if (begin >= coveredEnd) {
+            *last++ = begin;
+            coveredEnd = _subtreeEnds[begin];
+            nodeCount += coveredEnd - begin;
+        }
+    }
+    _dirtyBegins.erase(last, _dirtyBegins.end());
+    updateSubtrees(_dirtyBegins, nodeCount);
+}
+
+void TransformHierarchy::updateSubtrees(const ccstd::vector<uint32_t> &begins, uint32_t nodeCount) const {
+    // parents are updated before their children, so every node only reads an up-to-date parent
+    auto *jobSystem = JobSystem::getInstance();
+    if (nodeCount < PARALLEL_UPDATE_THRESHOLD || begins.size() < 2 || jobSystem->threadCount() < 2) {
+        for (const auto begin : begins) {
+            updateRange(begin, _subtreeEnds[begin]);
+        }
+        return;
+    }
+    // a subtree may hang below a dirty node outside of all of them, update it first so jobs share no node
+    for (const auto begin : begins) {
+        _nodes[begin]->updateWorldTransform();
+    }
+    JobGraph g(jobSystem);
+    g.createForEachIndexJob(0, static_cast<uint32_t>(begins.size()), 1U, [this, &begins](uint32_t i) {
+        updateRange(begins[i], _subtreeEnds[begins[i]]);
+    });
+    g.run();
+    g.waitForAll();
+}
+
+void TransformHierarchy::updateRange(uint32_t begin, uint32_t end) const {
+    for (uint32_t i = begin; i < end;) {
+        Node *node = _nodes[i];
+        // inactive subtrees are skipped, their transforms are still updated lazily when accessed
+        if (!node->isActiveInHierarchy()) {
+            i = _subtreeEnds[i];
+            continue;
+        }
+        if (node->isTransformDirty()) {
+            node->updateWorldTransform();
+        }
+        ++i;
+    }
+}
+
+} // namespace cc
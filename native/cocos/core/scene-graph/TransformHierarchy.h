@@ -0,0 +1,86 @@
+/****************************************************************************
+ Copyright (c) 2021-2023 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos.com
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include "base/Macros.h"
+#include "base/std/container/vector.h"
+
+namespace cc {
+
+class Node;
+
+/**
+ * Flattened view of a scene for updating world transforms in linear sweeps.
+ * Nodes are kept in depth-first pre-order, so a parent always comes before its children
+ * and every subtree is a contiguous range. The order is rebuilt lazily when nodes of this scene
+ * are attached, detached or reordered; changes elsewhere leave it alone. Between rebuilds only
+ * the subtrees whose transforms changed are swept. The transforms themselves stay in Node,
+ * which shares them with the script engine.
+ */
+class CC_DLL TransformHierarchy final {
+public:
+    explicit TransformHierarchy(Node *root);
+    ~TransformHierarchy() = default;
+
+    // Updates the world transform of every dirty node which is active in hierarchy.
+    void update();
+
+    // Called by nodes below the root when their children or sibling order changed.
+    inline void invalidateOrder() {
+        _orderDirty = true;
+        // the next update sweeps everything, and nodes in the list may be gone by then
+        _dirtyRoots.clear();
+    }
+    // Called by a node below the root whose subtree was just marked dirty. Main thread only.
+    inline void addDirtyRoot(Node *node) {
+        if (!_orderDirty) {
+            _dirtyRoots.emplace_back(node);
+        }
+    }
+
+    inline bool isOrderDirty() const { return _orderDirty; }
+    inline uint32_t size() const { return static_cast<uint32_t>(_nodes.size()); }
+
+private:
+    void rebuild();
+    // updates the subtrees starting at the given indices, which must not overlap
+    void updateSubtrees(const ccstd::vector<uint32_t> &begins, uint32_t nodeCount) const;
+    void updateRange(uint32_t begin, uint32_t end) const;
+
+    Node *_root{nullptr};
+    ccstd::vector<Node *> _nodes;
+    // _subtreeEnds[i] is one past the last descendant of _nodes[i]
+    ccstd::vector<uint32_t> _subtreeEnds;
+    // subtrees of the root's children, they are independent of each other
+    ccstd::vector<uint32_t> _branches;
+    ccstd::vector<Node *> _dirtyRoots;
+    ccstd::vector<uint32_t> _dirtyBegins;
+    bool _orderDirty{true};
+
+    CC_DISALLOW_COPY_MOVE_ASSIGN(TransformHierarchy);
+};
+
+} // namespace cc
@@ -24,12 +24,19 @@
 
 #include "MiddlewareManager.h"
 #include <algorithm>
+#include <functional>
 #include "2d/renderer/Batcher2d.h"
 #include "SeApi.h"
+#include "base/job-system/JobSystem.h"
 #include "core/Root.h"
 
 MIDDLEWARE_BEGIN
 
+namespace {
+// below this many instances the job graph costs more than it saves
+constexpr size_t PARALLEL_MIN_MIDDLEWARE_COUNT = 8;
+} // namespace
+
 MiddlewareManager *MiddlewareManager::instance = nullptr;
 
 MiddlewareManager::MiddlewareManager() : _renderInfo(se::Object::TypedArrayType::UINT32),
@@ -65,6 +72,44 @@ void MiddlewareManager::clearRemoveList() {
     _removeList.clear();
 }
 
+bool MiddlewareManager::isRemoved(IMiddleware *editor) const {
+    return !_removeList.empty() && std::find(_removeList.begin(), _removeList.end(), editor) != _removeList.end();
+}
+
+void MiddlewareManager::runParallel(void (IMiddleware::*work)()) {
+    auto *jobSystem = JobSystem::getInstance();
+    if (_parallelList.size() >= PARALLEL_MIN_MIDDLEWARE_COUNT && jobSystem->threadCount() > 1) {
+        // a stable sort keeps the update order within a group
+        std::stable_sort(_parallelList.begin(), _parallelList.end(), [](const IMiddleware *lhs, const IMiddleware *rhs) {
+            return std::less<const void *>()(lhs->getParallelGroup(), rhs->getParallelGroup());
+        });
+        _parallelGroups.clear();
+        for (uint32_t i = 0; i < _parallelList.size(); ++i) {
+            if (i == 0 || _parallelList[i]->getParallelGroup() != _parallelList[i - 1]->getParallelGroup()) {
+                _parallelGroups.push_back(i);
+            }
+        }
+        auto count = static_cast<uint32_t>(_parallelGroups.size());
+        _parallelGroups.push_back(static_cast<uint32_t>(_parallelList.size()));
+
+        auto runGroup = [this, work](uint32_t group) {
+            for (uint32_t i = _parallelGroups[group]; i < _parallelGroups[group + 1]; ++i) {
+                (_parallelList[i]->*work)();
+            }
+        };
+        JobGraph g(jobSystem);
+        g.createForEachIndexJob(1U, count, 1U, runGroup);
+        g.run();
+        runGroup(0); // the calling thread takes the first group
+        g.waitForAll();
+    } else {
+        for (auto *editor : _parallelList) {
+            (editor->*work)();
+        }
+    }
+    _parallelList.clear();
+}
+
 void MiddlewareManager::update(float dt) {
     isUpdating = true;
 
@@ -85,6 +130,15 @@ void MiddlewareManager::update(float dt) {
         }
     }
 
+    if (_parallelEnabled) {
+        for (auto *editor : _updateList) {
+            if (!isRemoved(editor) && editor->beginParallelUpdate()) {
+                _parallelList.push_back(editor);
+            }
+        }
+        runParallel(&IMiddleware::updateParallel);
+    }
+
     isUpdating = false;
 
     clearRemoveList();
@@ -100,6 +154,15 @@ void MiddlewareManager::render(float dt) {
 
     isRendering = true;
 
+    if (_parallelEnabled) {
+        for (auto *editor : _updateList) {
+            if (!isRemoved(editor) && editor->beginParallelRender()) {
+                _parallelList.push_back(editor);
+            }
+        }
+        runParallel(&IMiddleware::renderParallel);
+    }
+
     for (auto *editor : _updateList) {
         if (!_removeList.empty()) {
             auto removeIt = std::find(_removeList.begin(), _removeList.end(), editor);
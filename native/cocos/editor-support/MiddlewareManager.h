@@ -42,6 +42,22 @@ public:
     virtual ~IMiddleware() = default;
     virtual void update(float dt) = 0;
     virtual void render(float dt) = 0;
+
+    /**
+     * Parallel middleware mode, see MiddlewareManager::setParallelEnabled().
+     * After update() and before render(), the manager asks every instance on the main thread whether it
+     * has work to do in parallel. If so, updateParallel() or renderParallel() runs on a job worker side by
+     * side with the other instances, and may only touch data owned by the instance or its parallel group.
+     */
+    virtual bool beginParallelUpdate() { return false; }
+    virtual void updateParallel() {}
+    virtual bool beginParallelRender() { return false; }
+    virtual void renderParallel() {}
+    /**
+     * Instances returning the same group share data, their parallel work runs one after another on the same
+     * worker in update order. Every instance is a group of its own by default.
+     */
+    virtual const void *getParallelGroup() const { return this; }
 };
 
 /**
@@ -102,6 +118,14 @@ public:
     std::size_t getVBTypedArrayLength(int format, std::size_t bufferPos);
     std::size_t getIBTypedArrayLength(int format, std::size_t bufferPos);
 
+    /**
+     * @brief Turns parallel middleware mode on or off, it is off by default. Instances that support it
+     * compute world transforms and generate vertices on job workers, then render() copies the vertices
+     * to the shared mesh buffers in the usual order.
+     */
+    void setParallelEnabled(bool enabled) { _parallelEnabled = enabled; }
+    bool isParallelEnabled() const { return _parallelEnabled; }
+
     SharedBufferManager *getRenderInfoMgr();
     SharedBufferManager *getAttachInfoMgr();
 
@@ -114,9 +138,15 @@ public:
 
 private:
     void clearRemoveList();
+    bool isRemoved(IMiddleware *editor) const;
+    void runParallel(void (IMiddleware::*work)());
 
     ccstd::vector<IMiddleware *> _updateList;
     ccstd::vector<IMiddleware *> _removeList;
+    ccstd::vector<IMiddleware *> _parallelList;
+    // where each parallel group starts in the sorted _parallelList, followed by its end
+    ccstd::vector<uint32_t> _parallelGroups;
+    bool _parallelEnabled = false;
     std::map<int, MeshBuffer *> _mbMap;
 
     SharedBufferManager _renderInfo;
@@ -22,9 +22,16 @@
  */
 
 #include "ArmatureCache.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
 #include "CCFactory.h"
+#include "CCTextureAtlasData.h"
+#include "base/ThreadPool.h"
 #include "base/TypeDef.h"
 #include "base/memory/Memory.h"
+#include "platform/FileUtils.h"
 
 USING_NS_MW; // NOLINT(google-build-using-namespace)
 
@@ -34,6 +41,117 @@ DRAGONBONES_NAMESPACE_BEGIN
 
 float ArmatureCache::FrameTime = 1.0F / 60.0F;
 float ArmatureCache::MaxCacheTime = 120.0F;
+bool ArmatureCache::BakeInBackground = true;
+bool ArmatureCache::PersistBakedFrames = false;
+
+namespace {
+constexpr uint32_t PERSIST_MAGIC = 0x46434244; // "DBCF"
+constexpr uint32_t PERSIST_VERSION = 1;
+const char *const PERSIST_DIRECTORY = "dragonbones-cache/";
+
+LegacyThreadPool *getBakeThreadPool() {
+    // Intentionally leaked, caches wait for their own bakes before they go away.
+    static LegacyThreadPool *pool = LegacyThreadPool::newSingleThreadPool();
+    return pool;
+}
+
+void setEventQueue(Armature *armature, DragonBones *dragonBones) {
+    armature->_dragonBones = dragonBones;
+    for (auto *slot : armature->getSlots()) {
+        auto *childArmature = slot->getChildArmature();
+        if (childArmature != nullptr) {
+            setEventQueue(childArmature, dragonBones);
+        }
+    }
+}
+
+uint64_t hashKey(const std::string &key) {
+    uint64_t hash = 14695981039346656037ULL; // FNV-1a
+    for (auto c : key) {
+        hash = (hash ^ static_cast<uint8_t>(c)) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+template <typename T>
+void writeValue(std::vector<char> &out, const T &value) {
+    const auto *bytes = reinterpret_cast<const char *>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+void writeBytes(std::vector<char> &out, const void *data, uint32_t size) {
+    writeValue(out, size);
+    const auto *bytes = static_cast<const char *>(data);
+    out.insert(out.end(), bytes, bytes + size);
+}
+
+class Reader {
+public:
+    Reader(const char *data, std::size_t size) : _cur(data), _end(data + size) {}
+
+    template <typename T>
+    bool read(T &value) {
+        if (static_cast<std::size_t>(_end - _cur) < sizeof(T)) return false;
+        memcpy(&value, _cur, sizeof(T));
+        _cur += sizeof(T);
+        return true;
+    }
+
+    bool readBytes(cc::middleware::IOBuffer &buffer) {
+        uint32_t size = 0;
+        if (!read(size) || static_cast<std::size_t>(_end - _cur) < size) return false;
+        buffer.checkSpace(size, true);
+        buffer.writeBytes(_cur, size);
+        _cur += size;
+        return true;
+    }
+
+    bool readString(std::string &value) {
+        uint32_t size = 0;
+        if (!read(size) || static_cast<std::size_t>(_end - _cur) < size) return false;
+        value.assign(_cur, size);
+        _cur += size;
+        return true;
+    }
+
+private:
+    const char *_cur = nullptr;
+    const char *_end = nullptr;
+};
+
+bool writeFrame(std::vector<char> &out, const ArmatureCache::FrameData &frameData, const std::vector<middleware::Texture2D *> &atlasTextures) {
+    writeValue(out, static_cast<uint32_t>(frameData.getBoneCount()));
+    for (const auto *bone : frameData.getBones()) {
+        const auto &matm = bone->globalTransformMatrix.m;
+        for (auto index : {0, 1, 4, 5, 12, 13}) {
+            writeValue(out, matm[index]);
+        }
+    }
+
+    writeValue(out, static_cast<uint32_t>(frameData.getColorCount()));
+    for (const auto *color : frameData.getColors()) {
+        writeValue(out, color->color.r);
+        writeValue(out, color->color.g);
+        writeValue(out, color->color.b);
+        writeValue(out, color->color.a);
+        writeValue(out, static_cast<uint32_t>(color->vertexFloatOffset));
+    }
+
+    writeValue(out, static_cast<uint32_t>(frameData.getSegmentCount()));
+    for (const auto *segment : frameData.getSegments()) {
+        auto it = std::find(atlasTextures.begin(), atlasTextures.end(), segment->getTexture());
+        if (it == atlasTextures.end()) return false;
+        writeValue(out, static_cast<int32_t>(segment->blendMode));
+        writeValue(out, static_cast<uint32_t>(it - atlasTextures.begin()));
+        writeValue(out, static_cast<uint32_t>(segment->indexCount));
+        writeValue(out, static_cast<uint32_t>(segment->vertexFloatCount));
+    }
+
+    writeBytes(out, frameData.vb.getBuffer(), static_cast<uint32_t>(frameData.vb.getCurPos()));
+    writeBytes(out, frameData.ib.getBuffer(), static_cast<uint32_t>(frameData.ib.getCurPos()));
+    return true;
+}
+} // namespace
 
 ArmatureCache::SegmentData::SegmentData() = default;
 
@@ -54,26 +172,48 @@ cc::middleware::Texture2D *ArmatureCache::SegmentData::getTexture() const {
 ArmatureCache::FrameData::FrameData() = default;
 
 ArmatureCache::FrameData::~FrameData() {
-    for (auto &bone : _bones) {
+    reset();
+
+    for (auto &bone : _spareBones) {
         delete bone;
     }
-    _bones.clear();
+    _spareBones.clear();
 
-    for (auto &color : _colors) {
+    for (auto &color : _spareColors) {
         delete color;
     }
-    _colors.clear();
+    _spareColors.clear();
 
-    for (auto &segment : _segments) {
+    for (auto &segment : _spareSegments) {
         delete segment;
     }
+    _spareSegments.clear();
+}
+
+void ArmatureCache::FrameData::reset() {
+    for (auto &segment : _segments) {
+        segment->setTexture(nullptr);
+    }
+    _spareBones.insert(_spareBones.end(), _bones.begin(), _bones.end());
+    _bones.clear();
+    _spareColors.insert(_spareColors.end(), _colors.begin(), _colors.end());
+    _colors.clear();
+    _spareSegments.insert(_spareSegments.end(), _segments.begin(), _segments.end());
     _segments.clear();
+    vb.reset();
+    ib.reset();
 }
 
 ArmatureCache::BoneData *ArmatureCache::FrameData::buildBoneData(std::size_t index) {
     if (index > _bones.size()) return nullptr;
     if (index == _bones.size()) {
-        auto *boneData = new BoneData;
+        BoneData *boneData = nullptr;
+        if (_spareBones.empty()) {
+            boneData = new BoneData;
+        } else {
+            boneData = _spareBones.back();
+            _spareBones.pop_back();
+        }
         _bones.push_back(boneData);
     }
     return _bones[index];
@@ -86,7 +226,13 @@ std::size_t ArmatureCache::FrameData::getBoneCount() const {
 ArmatureCache::ColorData *ArmatureCache::FrameData::buildColorData(std::size_t index) {
     if (index > _colors.size()) return nullptr;
     if (index == _colors.size()) {
-        auto *colorData = new ColorData;
+        ColorData *colorData = nullptr;
+        if (_spareColors.empty()) {
+            colorData = new ColorData;
+        } else {
+            colorData = _spareColors.back();
+            _spareColors.pop_back();
+        }
         _colors.push_back(colorData);
     }
     return _colors[index];
@@ -99,7 +245,13 @@ std::size_t ArmatureCache::FrameData::getColorCount() const {
 ArmatureCache::SegmentData *ArmatureCache::FrameData::buildSegmentData(std::size_t index) {
     if (index > _segments.size()) return nullptr;
     if (index == _segments.size()) {
-        auto *segmentData = new SegmentData;
+        SegmentData *segmentData = nullptr;
+        if (_spareSegments.empty()) {
+            segmentData = new SegmentData;
+        } else {
+            segmentData = _spareSegments.back();
+            _spareSegments.pop_back();
+        }
         _segments.push_back(segmentData);
     }
     return _segments[index];
@@ -109,6 +261,18 @@ std::size_t ArmatureCache::FrameData::getSegmentCount() const {
     return _segments.size();
 }
 
+void ArmatureCache::FrameData::retainTextures() {
+    for (auto *segment : _segments) {
+        CC_SAFE_ADD_REF(segment->_texture);
+    }
+}
+
+void ArmatureCache::FrameData::dropTextures() {
+    for (auto *segment : _segments) {
+        segment->_texture = nullptr;
+    }
+}
+
 ArmatureCache::AnimationData::AnimationData() = default;
 
 ArmatureCache::AnimationData::~AnimationData() {
@@ -120,6 +284,11 @@ void ArmatureCache::AnimationData::reset() {
         delete frame;
     }
     _frames.clear();
+    for (auto &frame : _bakedFrames) {
+        frame->dropTextures();
+        delete frame;
+    }
+    _bakedFrames.clear();
     _isComplete = false;
     _totalTime = 0.0F;
 }
@@ -150,18 +319,38 @@ std::size_t ArmatureCache::AnimationData::getFrameCount() const {
     return _frames.size();
 }
 
-ArmatureCache::ArmatureCache(const std::string &armatureName, const std::string &armatureKey, const std::string &atlasUUID) {
+ArmatureCache::ArmatureCache(const std::string &armatureName, const std::string &armatureKey, const std::string &atlasUUID)
+: _armatureName(armatureName),
+  _armatureKey(armatureKey),
+  _atlasUUID(atlasUUID) {
     _armatureDisplay = dragonBones::CCFactory::getFactory()->buildArmatureDisplay(armatureName, armatureKey, "", atlasUUID);
     if (_armatureDisplay) {
         _armatureDisplay->addRef();
+        _bakeDragonBones = new DragonBones(nullptr);
+        setEventQueue(_armatureDisplay->getArmature(), _bakeDragonBones);
     }
 }
 
 ArmatureCache::~ArmatureCache() {
+    {
+        std::lock_guard<std::mutex> lock(_bakeMutex);
+        _cancelBake = true;
+        _bakeQueue.clear();
+    }
+    waitForBake();
+    BaseObject::returnDeferredObjects(_deferredReturns);
+
     if (_armatureDisplay) {
+        // disposing the armature buffers it, which has to happen on the shared instance again
+        setEventQueue(_armatureDisplay->getArmature(), CCFactory::getFactory()->getDragonBones());
         _armatureDisplay->release();
         _armatureDisplay = nullptr;
     }
+    if (_bakeDragonBones) {
+        _bakeDragonBones->discardBuffered();
+        delete _bakeDragonBones;
+        _bakeDragonBones = nullptr;
+    }
 
     for (auto &animationCache : _animationCaches) {
         delete animationCache.second;
@@ -204,10 +393,25 @@ void ArmatureCache::updateToFrame(const std::string &animationName, int toFrameI
     }
 
     AnimationData *animationData = it->second;
-    if (!animationData || !animationData->needUpdate(toFrameIdx)) {
+    if (!animationData) {
+        return;
+    }
+
+    if (BakeInBackground) {
+        collectBakedFrames(animationData);
+        if (animationData->needUpdate(toFrameIdx)) {
+            scheduleBake(animationData);
+        }
         return;
     }
 
+    if (!animationData->needUpdate(toFrameIdx)) {
+        return;
+    }
+
+    // the armature may still be with the bake thread if background baking was switched off
+    waitForBake();
+
     if (_curAnimationName != animationName) {
         updateToFrame(_curAnimationName);
         _curAnimationName = animationName;
@@ -223,6 +427,7 @@ void ArmatureCache::updateToFrame(const std::string &animationName, int toFrameI
 
     do {
         armature->advanceTime(FrameTime);
+        _bakeDragonBones->discardBuffered();
         renderAnimationFrame(animationData);
         animationData->_totalTime += FrameTime;
         if (animation->isCompleted()) {
@@ -233,10 +438,325 @@ void ArmatureCache::updateToFrame(const std::string &animationName, int toFrameI
 
 void ArmatureCache::renderAnimationFrame(AnimationData *animationData) {
     std::size_t frameIndex = animationData->getFrameCount();
-    _frameData = animationData->buildFrameData(frameIndex);
+    FrameData *frameData = animationData->buildFrameData(frameIndex);
+    _frameBuilder.build(_armatureDisplay->getArmature(), frameData);
+}
+
+void ArmatureCache::scheduleBake(AnimationData *animationData) {
+    if (animationData->_bakeScheduled || !_armatureDisplay) {
+        return;
+    }
+    if (animationData->getFrameCount() > 0) {
+        // frames baked on the main thread cannot be continued by the bake thread
+        resetAnimation(animationData);
+    }
+
+    std::string persistPath;
+    std::string fingerprint;
+    std::vector<middleware::Texture2D *> atlasTextures;
+    // without a digest of the skeleton data, stored frames could silently outlive a changed file
+    const auto &dataDigest = CCFactory::getFactory()->getDragonBonesDataDigest(_armatureKey);
+    if (PersistBakedFrames && !dataDigest.empty()) {
+        auto *fileUtils = cc::FileUtils::getInstance();
+        std::string directory = fileUtils->getWritablePath() + PERSIST_DIRECTORY;
+        if (fileUtils->isDirectoryExist(directory) || fileUtils->createDirectory(directory)) {
+            const auto &name = animationData->_animationName;
+            auto key = _armatureKey + '\n' + _armatureName + '\n' + _atlasUUID + '\n' + name;
+            char fileName[32] = {0};
+            snprintf(fileName, sizeof(fileName), "%016llx.bin", static_cast<unsigned long long>(hashKey(key)));
+            persistPath = directory + fileName;
+
+            auto *textureAtlasDataList = CCFactory::getFactory()->getTextureAtlasData(_atlasUUID);
+            if (textureAtlasDataList) {
+                for (auto *textureAtlasData : *textureAtlasDataList) {
+                    atlasTextures.push_back(static_cast<CCTextureAtlasData *>(textureAtlasData)->getRenderTexture());
+                }
+            }
+
+            // baked frames only stay valid for the same data and baking settings
+            auto *armature = _armatureDisplay->getArmature();
+            const auto *armatureData = armature->getArmatureData();
+            const auto *animation = armatureData->getAnimation(name);
+            std::ostringstream stream;
+            stream << key << '\n'
+                   << dataDigest << '\n'
+                   << armature->getBones().size() << ' ' << armature->getSlots().size() << ' '
+                   << (animation ? animation->frameCount : 0) << ' ' << (animation ? animation->duration : 0.0F) << ' '
+                   << FrameTime << ' ' << MaxCacheTime << ' ' << atlasTextures.size();
+            fingerprint = stream.str();
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(_bakeMutex);
+    if (!persistPath.empty()) {
+        animationData->_persistPath = persistPath;
+        animationData->_fingerprint = fingerprint;
+        // the atlas of a cache never changes, once set the bake thread reads it unlocked
+        if (_atlasTextures.empty()) {
+            _atlasTextures = atlasTextures;
+        }
+    }
+    animationData->_bakeScheduled = true;
+    _bakeQueue.push_back(animationData);
+    if (!_baking) {
+        _baking = true;
+        getBakeThreadPool()->pushTask([this](int /*tid*/) {
+            bakeQueued();
+        });
+    }
+}
+
+void ArmatureCache::collectBakedFrames(AnimationData *animationData) {
+    std::vector<BaseObject *> deferredReturns;
+    {
+        std::lock_guard<std::mutex> lock(_bakeMutex);
+        deferredReturns.swap(_deferredReturns);
+        if (animationData->_bakeScheduled) {
+            for (auto *frameData : animationData->_bakedFrames) {
+                frameData->retainTextures();
+                animationData->_frames.push_back(frameData);
+            }
+            animationData->_bakedFrames.clear();
+            animationData->_totalTime = animationData->_bakeTime;
+            if (animationData->_bakeDone) {
+                animationData->_isComplete = animationData->_bakeComplete;
+            }
+        }
+    }
+    BaseObject::returnDeferredObjects(deferredReturns);
+}
+
+void ArmatureCache::waitForBake() {
+    std::unique_lock<std::mutex> lock(_bakeMutex);
+    _bakeIdle.wait(lock, [this]() { return !_baking; });
+}
+
+void ArmatureCache::bakeQueued() {
+    std::vector<BaseObject *> deferredReturns;
+    BaseObject::setDeferredReturnList(&deferredReturns);
+    while (true) {
+        AnimationData *animationData = nullptr;
+        uint32_t generation = 0;
+        std::string persistPath;
+        std::string fingerprint;
+        {
+            std::lock_guard<std::mutex> lock(_bakeMutex);
+            _deferredReturns.insert(_deferredReturns.end(), deferredReturns.begin(), deferredReturns.end());
+            deferredReturns.clear();
+            if (_cancelBake || _bakeQueue.empty()) {
+                _baking = false;
+                _bakeIdle.notify_all();
+                break;
+            }
+            animationData = _bakeQueue.front();
+            _bakeQueue.pop_front();
+            generation = animationData->_bakeGeneration;
+            if (PersistBakedFrames) {
+                persistPath = animationData->_persistPath;
+                fingerprint = animationData->_fingerprint;
+            }
+        }
+        bakeAnimation(animationData, generation, persistPath, fingerprint, deferredReturns);
+    }
+    BaseObject::setDeferredReturnList(nullptr);
+}
+
+bool ArmatureCache::handOverFrame(AnimationData *animationData, uint32_t generation, FrameData *frameData, float totalTime,
+                                  bool complete, bool done, std::vector<BaseObject *> &deferredReturns) {
+    std::lock_guard<std::mutex> lock(_bakeMutex);
+    _deferredReturns.insert(_deferredReturns.end(), deferredReturns.begin(), deferredReturns.end());
+    deferredReturns.clear();
+    if (_cancelBake || generation != animationData->_bakeGeneration) {
+        frameData->dropTextures();
+        delete frameData;
+        return false;
+    }
+    animationData->_bakedFrames.push_back(frameData);
+    animationData->_bakeTime = totalTime;
+    animationData->_bakeComplete = complete;
+    animationData->_bakeDone = done;
+    return true;
+}
+
+void ArmatureCache::bakeAnimation(AnimationData *animationData, uint32_t generation, const std::string &persistPath,
+                                  const std::string &fingerprint, std::vector<BaseObject *> &deferredReturns) {
+    if (!persistPath.empty() && loadBakedFrames(animationData, generation, persistPath, fingerprint)) {
+        return;
+    }
+
+    auto *armature = _armatureDisplay->getArmature();
+    auto *animation = armature->getAnimation();
+    animation->play(animationData->_animationName, 1);
+
+    FrameBuilder frameBuilder(false);
+    bool persist = !persistPath.empty();
+    std::vector<char> persistFrames;
+    uint32_t frameCount = 0;
+    float totalTime = 0.0F;
+    bool complete = false;
+    bool done = false;
+    while (!done) {
+        armature->advanceTime(FrameTime);
+        _bakeDragonBones->discardBuffered();
+        auto *frameData = new FrameData();
+        frameBuilder.build(armature, frameData);
+        totalTime += FrameTime;
+        complete = animation->isCompleted();
+        done = complete || totalTime > MaxCacheTime;
+
+        persist = persist && writeFrame(persistFrames, *frameData, _atlasTextures);
+        frameCount++;
+        if (!handOverFrame(animationData, generation, frameData, totalTime, complete, done, deferredReturns)) {
+            return;
+        }
+    }
 
-    _preColor = Color4B(0, 0, 0, 0);
-    _color = Color4B(255, 255, 255, 255);
+    if (persist) {
+        std::vector<char> header;
+        writeValue(header, PERSIST_MAGIC);
+        writeValue(header, PERSIST_VERSION);
+        writeBytes(header, fingerprint.data(), static_cast<uint32_t>(fingerprint.size()));
+        writeValue(header, frameCount);
+        writeValue(header, static_cast<uint8_t>(complete));
+        writeValue(header, totalTime);
+
+        // write aside and rename, a cut short write must not look like valid frames
+        auto tempPath = persistPath + ".tmp";
+        FILE *file = fopen(cc::FileUtils::getInstance()->getSuitableFOpen(tempPath).c_str(), "wb");
+        if (file) {
+            bool written = fwrite(header.data(), 1, header.size(), file) == header.size() &&
+                           fwrite(persistFrames.data(), 1, persistFrames.size(), file) == persistFrames.size();
+            written = fclose(file) == 0 && written;
+            if (!written || std::rename(tempPath.c_str(), persistPath.c_str()) != 0) {
+                std::remove(tempPath.c_str());
+            }
+        }
+    }
+}
+
+bool ArmatureCache::loadBakedFrames(AnimationData *animationData, uint32_t generation, const std::string &persistPath,
+                                    const std::string &fingerprint) {
+    FILE *file = fopen(cc::FileUtils::getInstance()->getSuitableFOpen(persistPath).c_str(), "rb");
+    if (!file) return false;
+    std::vector<char> data;
+    char chunk[16384];
+    std::size_t size = 0;
+    while ((size = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        data.insert(data.end(), chunk, chunk + size);
+    }
+    fclose(file);
+
+    Reader reader(data.data(), data.size());
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    std::string storedFingerprint;
+    uint32_t frameCount = 0;
+    uint8_t complete = 0;
+    float totalTime = 0.0F;
+    if (!reader.read(magic) || magic != PERSIST_MAGIC || !reader.read(version) || version != PERSIST_VERSION ||
+        !reader.readString(storedFingerprint) || storedFingerprint != fingerprint ||
+        !reader.read(frameCount) || !reader.read(complete) || !reader.read(totalTime)) {
+        return false;
+    }
+
+    std::vector<FrameData *> frames;
+    auto readFrame = [&](FrameData *frameData) {
+        uint32_t count = 0;
+        uint64_t lastColorOffset = 0;
+        uint64_t totalVertexFloats = 0;
+        uint64_t totalIndices = 0;
+        if (!reader.read(count)) return false;
+        for (uint32_t i = 0; i < count; ++i) {
+            auto &matm = frameData->buildBoneData(i)->globalTransformMatrix.m;
+            for (auto index : {0, 1, 4, 5, 12, 13}) {
+                if (!reader.read(matm[index])) return false;
+            }
+        }
+
+        if (!reader.read(count)) return false;
+        for (uint32_t i = 0; i < count; ++i) {
+            auto *colorData = frameData->buildColorData(i);
+            uint32_t vertexFloatOffset = 0;
+            if (!reader.read(colorData->color.r) || !reader.read(colorData->color.g) ||
+                !reader.read(colorData->color.b) || !reader.read(colorData->color.a) || !reader.read(vertexFloatOffset)) {
+                return false;
+            }
+            if (vertexFloatOffset < lastColorOffset) return false;
+            lastColorOffset = vertexFloatOffset;
+            colorData->vertexFloatOffset = vertexFloatOffset;
+        }
+
+        if (!reader.read(count)) return false;
+        for (uint32_t i = 0; i < count; ++i) {
+            auto *segmentData = frameData->buildSegmentData(i);
+            int32_t blendMode = 0;
+            uint32_t textureIndex = 0;
+            uint32_t indexCount = 0;
+            uint32_t vertexFloatCount = 0;
+            if (!reader.read(blendMode) || !reader.read(textureIndex) || !reader.read(indexCount) ||
+                !reader.read(vertexFloatCount) || textureIndex >= _atlasTextures.size()) {
+                return false;
+            }
+            segmentData->blendMode = blendMode;
+            segmentData->_texture = _atlasTextures[textureIndex];
+            segmentData->indexCount = indexCount;
+            segmentData->vertexFloatCount = vertexFloatCount;
+            if (vertexFloatCount % VF_XYZUVC != 0) return false;
+            totalVertexFloats += vertexFloatCount;
+            totalIndices += indexCount;
+        }
+        if (!reader.readBytes(frameData->vb) || !reader.readBytes(frameData->ib)) return false;
+
+        // The display walks segments and colors sequentially over vb/ib, so a
+        // truncated or corrupted file must not let either run past the end.
+        const uint64_t vbFloats = frameData->vb.getCurPos() / sizeof(float);
+        const uint64_t ibIndices = frameData->ib.getCurPos() / sizeof(uint16_t);
+        if (totalVertexFloats > vbFloats || totalIndices > ibIndices || lastColorOffset > vbFloats) return false;
+        if (totalVertexFloats > 0 && (frameData->getColorCount() == 0 || lastColorOffset < totalVertexFloats)) {
+            return false;
+        }
+
+        const auto *indices = reinterpret_cast<const uint16_t *>(frameData->ib.getBuffer());
+        const auto &segments = frameData->getSegments();
+        std::size_t indexPos = 0;
+        for (const auto *segment : segments) {
+            const auto vertexCount = static_cast<std::size_t>(segment->vertexFloatCount / VF_XYZUVC);
+            for (std::size_t i = 0; i < static_cast<std::size_t>(segment->indexCount); ++i, ++indexPos) {
+                if (indices[indexPos] >= vertexCount) return false;
+            }
+        }
+        return true;
+    };
+
+    for (uint32_t i = 0; i < frameCount; ++i) {
+        auto *frameData = new FrameData();
+        frames.push_back(frameData);
+        if (!readFrame(frameData)) {
+            for (auto *frame : frames) {
+                frame->dropTextures();
+                delete frame;
+            }
+            return false;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(_bakeMutex);
+    if (_cancelBake || generation != animationData->_bakeGeneration) {
+        for (auto *frame : frames) {
+            frame->dropTextures();
+            delete frame;
+        }
+        return true;
+    }
+    animationData->_bakedFrames.insert(animationData->_bakedFrames.end(), frames.begin(), frames.end());
+    animationData->_bakeTime = totalTime;
+    animationData->_bakeComplete = complete != 0;
+    animationData->_bakeDone = true;
+    return true;
+}
+
+void ArmatureCache::FrameBuilder::build(Armature *armature, FrameData *frameData) {
+    _frameData = frameData;
 
     _preBlendMode = -1;
     _preTextureIndex = -1;
@@ -246,7 +766,6 @@ void ArmatureCache::renderAnimationFrame(AnimationData *animationData) {
     _curVSegLen = 0;
     _materialLen = 0;
 
-    auto *armature = _armatureDisplay->getArmature();
     traverseArmature(armature);
 
     if (_preISegWritePos != -1) {
@@ -264,7 +783,7 @@ void ArmatureCache::renderAnimationFrame(AnimationData *animationData) {
     _frameData = nullptr;
 }
 
-void ArmatureCache::traverseArmature(Armature *armature, float parentOpacity /*= 1.0f*/) {
+void ArmatureCache::FrameBuilder::traverseArmature(Armature *armature, float parentOpacity /*= 1.0f*/) {
     middleware::IOBuffer &vb = _frameData->vb;
     middleware::IOBuffer &ib = _frameData->ib;
 
@@ -286,7 +805,12 @@ void ArmatureCache::traverseArmature(Armature *armature, float parentOpacity /*=
         }
 
         SegmentData *segmentData = _frameData->buildSegmentData(_materialLen);
-        segmentData->setTexture(texture);
+        if (_retainTextures) {
+            segmentData->setTexture(texture);
+        } else {
+            // reference counts are not thread safe, the frame retains its textures once handed over
+            segmentData->_texture = texture;
+        }
         segmentData->blendMode = static_cast<int>(slot->_blendMode);
 
         // save new segment count pos field
@@ -397,23 +921,36 @@ void ArmatureCache::traverseArmature(Armature *armature, float parentOpacity /*=
     } // End slot traverse
 }
 
+void ArmatureCache::resetAnimation(AnimationData *animationData) {
+    std::lock_guard<std::mutex> lock(_bakeMutex);
+    // a bake still running for the old generation discards its frames on hand over
+    animationData->_bakeGeneration++;
+    animationData->_bakeScheduled = false;
+    animationData->_bakeDone = false;
+    animationData->_bakeComplete = false;
+    animationData->_bakeTime = 0.0F;
+    _bakeQueue.erase(std::remove(_bakeQueue.begin(), _bakeQueue.end(), animationData), _bakeQueue.end());
+    animationData->reset();
+}
+
 void ArmatureCache::resetAllAnimationData() {
     for (auto &animationCache : _animationCaches) {
-        animationCache.second->reset();
+        resetAnimation(animationCache.second);
     }
 }
 
 void ArmatureCache::resetAnimationData(const std::string &animationName) {
     for (auto &animationCache : _animationCaches) {
         if (animationCache.second->_animationName == animationName) {
-            animationCache.second->reset();
+            resetAnimation(animationCache.second);
             break;
         }
     }
 }
 
 CCArmatureDisplay *ArmatureCache::getArmatureDisplay() {
-    return _armatureDisplay;
+    std::lock_guard<std::mutex> lock(_bakeMutex);
+    return _baking ? nullptr : _armatureDisplay;
 }
 
 DRAGONBONES_NAMESPACE_END
@@ -23,6 +23,9 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 #include "CCArmatureDisplay.h"
 #include "IOBuffer.h"
 #include "base/RefCounted.h"
@@ -31,8 +34,11 @@ DRAGONBONES_NAMESPACE_BEGIN
 
 class ArmatureCache : public cc::RefCounted {
 public:
+    class FrameBuilder;
+
     struct SegmentData {
         friend class ArmatureCache;
+        friend class FrameBuilder;
 
         SegmentData();
         ~SegmentData();
@@ -60,9 +66,12 @@ public:
 
     struct FrameData {
         friend class ArmatureCache;
+        friend class FrameBuilder;
 
         FrameData();
         ~FrameData();
+        // Empties the frame for another build, records and buffers are kept for reuse.
+        void reset();
 
         const std::vector<BoneData *> &getBones() const {
             return _bones;
@@ -86,10 +95,18 @@ public:
         ColorData *buildColorData(std::size_t index);
         // if bone data is empty, it will build new one.
         BoneData *buildBoneData(std::size_t index);
+        // Frames are built without retaining textures, the main thread
+        // retains them once the frame is handed over or drops them.
+        void retainTextures();
+        void dropTextures();
 
         std::vector<BoneData *> _bones;
         std::vector<ColorData *> _colors;
         std::vector<SegmentData *> _segments;
+        // records left over by reset()
+        std::vector<BoneData *> _spareBones;
+        std::vector<ColorData *> _spareColors;
+        std::vector<SegmentData *> _spareSegments;
 
     public:
         cc::middleware::IOBuffer ib;
@@ -117,15 +134,49 @@ public:
         bool _isComplete = false;
         float _totalTime = 0.0F;
         std::vector<FrameData *> _frames;
+
+        // Background baking state, the fields below are guarded by the cache bake mutex.
+        bool _bakeScheduled = false;
+        bool _bakeDone = false;
+        bool _bakeComplete = false;
+        float _bakeTime = 0.0F;
+        uint32_t _bakeGeneration = 0;
+        std::vector<FrameData *> _bakedFrames;
+        std::string _persistPath;
+        std::string _fingerprint;
+    };
+
+    // Collects the render data of the current armature pose into a FrameData.
+    class FrameBuilder {
+    public:
+        // Off the main thread textures must not be retained, see FrameData::retainTextures.
+        explicit FrameBuilder(bool retainTextures = true) : _retainTextures(retainTextures) {}
+        void build(Armature *armature, FrameData *frameData);
+
+    private:
+        void traverseArmature(Armature *armature, float parentOpacity = 1.0F);
+
+        bool _retainTextures = true;
+        FrameData *_frameData = nullptr;
+        int _preBlendMode = -1;
+        int _preTextureIndex = -1;
+        int _curTextureIndex = -1;
+        int _preISegWritePos = -1;
+        int _curISegLen = 0;
+        int _curVSegLen = 0;
+        int _materialLen = 0;
     };
 
     ArmatureCache(const std::string &armatureName, const std::string &armatureKey, const std::string &atlasUUID);
     ~ArmatureCache() override;
 
+    // With BakeInBackground, hands over the frames baked so far and queues the rest
+    // on the bake thread instead of baking up to toFrameIdx before returning.
     void updateToFrame(const std::string &animationName, int toFrameIdx = -1);
     // if animation data is empty, it will build new one.
     AnimationData *buildAnimationData(const std::string &animationName);
     AnimationData *getAnimationData(const std::string &animationName);
+    // nullptr while the armature is with the bake thread, it is never waited for.
     CCArmatureDisplay *getArmatureDisplay();
 
     void resetAllAnimationData();
@@ -133,26 +184,49 @@ public:
 
 private:
     void renderAnimationFrame(AnimationData *animationData);
-    void traverseArmature(Armature *armature, float parentOpacity = 1.0F);
+    void resetAnimation(AnimationData *animationData);
+
+    void scheduleBake(AnimationData *animationData);
+    void collectBakedFrames(AnimationData *animationData);
+    void waitForBake();
+    void bakeQueued();
+    void bakeAnimation(AnimationData *animationData, uint32_t generation, const std::string &persistPath,
+                       const std::string &fingerprint, std::vector<BaseObject *> &deferredReturns);
+    bool loadBakedFrames(AnimationData *animationData, uint32_t generation, const std::string &persistPath,
+                         const std::string &fingerprint);
+    bool handOverFrame(AnimationData *animationData, uint32_t generation, FrameData *frameData, float totalTime,
+                       bool complete, bool done, std::vector<BaseObject *> &deferredReturns);
 
 public:
     static float FrameTime;    // NOLINT
     static float MaxCacheTime; // NOLINT
+    // Bake frames on a worker thread, displays evaluate in realtime until they are ready.
+    static bool BakeInBackground; // NOLINT
+    // Keep background baked frames in the writable path so later launches load them instead.
+    static bool PersistBakedFrames; // NOLINT
 
 private:
-    FrameData *_frameData = nullptr;
-    cc::middleware::Color4F _preColor = cc::middleware::Color4F(-1.0F, -1.0F, -1.0F, -1.0F);
-    cc::middleware::Color4F _color = cc::middleware::Color4F(1.0F, 1.0F, 1.0F, 1.0F);
+    std::string _armatureName;
+    std::string _armatureKey;
+    std::string _atlasUUID;
     CCArmatureDisplay *_armatureDisplay = nullptr;
-    int _preBlendMode = -1;
-    int _preTextureIndex = -1;
-    int _curTextureIndex = -1;
-    int _preISegWritePos = -1;
-    int _curISegLen = 0;
-    int _curVSegLen = 0;
-    int _materialLen = 0;
+    // Events and objects buffered by the baked armature end up here instead of the shared
+    // DragonBones instance, so the main thread never dispatches them while the armature is baked.
+    DragonBones *_bakeDragonBones = nullptr;
+    FrameBuilder _frameBuilder;
     std::string _curAnimationName;
     std::map<std::string, AnimationData *> _animationCaches;
+
+    // The armature belongs to the bake thread while _baking is set.
+    std::mutex _bakeMutex;
+    std::condition_variable _bakeIdle;
+    std::deque<AnimationData *> _bakeQueue;
+    bool _baking = false;
+    bool _cancelBake = false;
+    // cleared on the bake thread, pooled on the main thread
+    std::vector<BaseObject *> _deferredReturns;
+    // atlas textures by index, the persisted frames refer to them this way
+    std::vector<cc::middleware::Texture2D *> _atlasTextures;
 };
 
 DRAGONBONES_NAMESPACE_END
@@ -48,7 +48,10 @@ static const std::string COMPLETE_EVENT = "complete";
 DRAGONBONES_NAMESPACE_BEGIN
 
 USING_NS_MW; // NOLINT(google-build-using-namespace)
-CCArmatureCacheDisplay::CCArmatureCacheDisplay(const std::string &armatureName, const std::string &armatureKey, const std::string &atlasUUID, bool isShare) {
+CCArmatureCacheDisplay::CCArmatureCacheDisplay(const std::string &armatureName, const std::string &armatureKey, const std::string &atlasUUID, bool isShare)
+: _armatureName(armatureName),
+  _armatureKey(armatureKey),
+  _atlasUUID(atlasUUID) {
     _eventObject = BaseObject::borrowObject<EventObject>();
 
     if (isShare) {
@@ -80,6 +83,8 @@ CCArmatureCacheDisplay::~CCArmatureCacheDisplay() {
 }
 
 void CCArmatureCacheDisplay::dispose() {
+    _realtimeArmatureInUse = false;
+    stopRealtime();
     if (_armatureCache) {
         _armatureCache->release();
         _armatureCache = nullptr;
@@ -100,6 +105,11 @@ void CCArmatureCacheDisplay::update(float dt) {
         if (_animationData && !_animationData->isComplete()) {
             _armatureCache->updateToFrame(_animationName);
         }
+        // the last realtime frame stays on screen until the baked one is there
+        if (_realtimeFrame && _animationData && _animationData->isComplete()) {
+            _curFrameIndex = static_cast<int>(_animationData->getFrameCount()) - 1;
+            stopRealtime();
+        }
         return;
     }
 
@@ -114,8 +124,18 @@ void CCArmatureCacheDisplay::update(float dt) {
         _armatureCache->updateToFrame(_animationName, frameIdx);
     }
 
+    bool realtimeComplete = false;
+    if (_animationData->getFrameData(frameIdx)) {
+        _useRealtimeFrame = false;
+        if (_realtimeFrame && _animationData->isComplete()) {
+            stopRealtime();
+        }
+    } else {
+        realtimeComplete = updateRealtime();
+    }
+
     int finalFrameIndex = static_cast<int>(_animationData->getFrameCount()) - 1;
-    if (_animationData->isComplete() && frameIdx >= finalFrameIndex) {
+    if ((_animationData->isComplete() && frameIdx >= finalFrameIndex) || realtimeComplete) {
         _playCount++;
         _accTime = 0.0F;
         if (_playTimes > 0 && _playCount >= _playTimes) {
@@ -135,9 +155,54 @@ void CCArmatureCacheDisplay::update(float dt) {
     _curFrameIndex = frameIdx;
 }
 
+CCArmatureDisplay *CCArmatureCacheDisplay::getRealtimeDisplay() const {
+    if (!_realtimeDisplay) {
+        _realtimeDisplay = CCFactory::getFactory()->buildArmatureDisplay(_armatureName, _armatureKey, "", _atlasUUID);
+    }
+    return _realtimeDisplay;
+}
+
+bool CCArmatureCacheDisplay::updateRealtime() {
+    if (!_realtimeDisplay) {
+        if (!getRealtimeDisplay()) return false;
+        _realtimeTime = -1.0F;
+    }
+
+    auto *armature = _realtimeDisplay->getArmature();
+    auto *animation = armature->getAnimation();
+    if (_realtimeTime < 0.0F || _accTime < _realtimeTime) {
+        animation->play(_animationName, 1);
+        _realtimeTime = 0.0F;
+    }
+    armature->advanceTime(_accTime - _realtimeTime);
+    _realtimeTime = _accTime;
+
+    if (_realtimeFrame) {
+        _realtimeFrame->reset();
+    } else {
+        _realtimeFrame = new ArmatureCache::FrameData();
+    }
+    _realtimeBuilder.build(armature, _realtimeFrame);
+    _useRealtimeFrame = true;
+    return animation->isCompleted();
+}
+
+void CCArmatureCacheDisplay::stopRealtime() {
+    // once handed out by getArmature() the armature lives as long as this display
+    if (_realtimeDisplay && !_realtimeArmatureInUse) {
+        // the armature returns the display to the pool on its own
+        _realtimeDisplay->dispose();
+        _realtimeDisplay = nullptr;
+    }
+    delete _realtimeFrame;
+    _realtimeFrame = nullptr;
+    _useRealtimeFrame = false;
+    _realtimeTime = -1.0F;
+}
+
 void CCArmatureCacheDisplay::render(float /*dt*/) {
     if (!_animationData) return;
-    ArmatureCache::FrameData *frameData = _animationData->getFrameData(_curFrameIndex);
+    ArmatureCache::FrameData *frameData = _useRealtimeFrame ? _realtimeFrame : _animationData->getFrameData(_curFrameIndex);
     if (!frameData) return;
 
     auto *mgr = MiddlewareManager::getInstance();
@@ -336,12 +401,18 @@ void CCArmatureCacheDisplay::onDisable() {
 
 Armature *CCArmatureCacheDisplay::getArmature() const {
     auto *armatureDisplay = _armatureCache->getArmatureDisplay();
+    if (!armatureDisplay) {
+        // the cache armature is being baked, answer with the realtime one instead of waiting
+        armatureDisplay = getRealtimeDisplay();
+        if (!armatureDisplay) return nullptr;
+        _realtimeArmatureInUse = true;
+    }
     return armatureDisplay->getArmature();
 }
 
 Animation *CCArmatureCacheDisplay::getAnimation() const {
     auto *armature = getArmature();
-    return armature->getAnimation();
+    return armature ? armature->getAnimation() : nullptr;
 }
 
 void CCArmatureCacheDisplay::playAnimation(const std::string &name, int playTimes) {
@@ -352,6 +423,7 @@ void CCArmatureCacheDisplay::playAnimation(const std::string &name, int playTime
     _accTime = 0.0F;
     _playCount = 0;
     _curFrameIndex = 0;
+    _realtimeTime = -1.0F;
 }
 
 void CCArmatureCacheDisplay::addDBEventListener(const std::string &type) {
@@ -97,6 +97,11 @@ public:
     void setRenderEntity(cc::RenderEntity *entity);
 
 private:
+    // Evaluates the animation in realtime while its frames are still baked in the background.
+    bool updateRealtime();
+    void stopRealtime();
+    CCArmatureDisplay *getRealtimeDisplay() const;
+
     float _timeScale = 1;
     int _curFrameIndex = -1;
     float _accTime = 0.0F;
@@ -118,6 +123,18 @@ private:
     ArmatureCache *_armatureCache = nullptr;
     EventObject *_eventObject;
 
+    std::string _armatureName;
+    std::string _armatureKey;
+    std::string _atlasUUID;
+    mutable CCArmatureDisplay *_realtimeDisplay = nullptr;
+    // getArmature() handed out the realtime armature while the cache one was busy baking
+    mutable bool _realtimeArmatureInUse = false;
+    ArmatureCache::FrameBuilder _realtimeBuilder;
+    // reused for every realtime frame until the baked animation takes over
+    ArmatureCache::FrameData *_realtimeFrame = nullptr;
+    float _realtimeTime = -1.0F;
+    bool _useRealtimeFrame = false;
+
     cc::middleware::IOTypedArray *_sharedBufferOffset = nullptr;
 
     cc::RenderEntity *_entity = nullptr;
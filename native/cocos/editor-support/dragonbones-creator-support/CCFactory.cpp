@@ -24,6 +24,8 @@
 ****************************************************************************/
 
 #include "dragonbones-creator-support/CCFactory.h"
+#include "base/MD5.h"
+#include "dragonbones-creator-support/ArmatureCache.h"
 #include "dragonbones-creator-support/CCArmatureDisplay.h"
 #include "dragonbones-creator-support/CCSlot.h"
 #include "dragonbones-creator-support/CCTextureAtlasData.h"
@@ -92,20 +94,50 @@ DragonBonesData *CCFactory::loadDragonBonesData(const std::string &filePath, con
 
         if (pos != std::string::npos) {
             const auto data = cc::FileUtils::getInstance()->getStringFromFile(filePath);
-
-            return parseDragonBonesData(data.c_str(), name, scale);
+            const auto dragonBonesData = parseDragonBonesData(data.c_str(), name, scale);
+            recordDataDigest(name, dragonBonesData, data.data(), data.size());
+            return dragonBonesData;
         } else {
-            cc::Data cocos2dData;
-            cc::FileUtils::getInstance()->getContents(fullpath, &cocos2dData);
-            uint8_t *binary = cocos2dData.takeBuffer();
-            // NOTE: binary is freed in DragonBonesData::_onClear
-            return parseDragonBonesData(reinterpret_cast<char *>(binary), name, scale);
+            return parseBinaryDragonBonesData(fullpath, name, scale);
         }
     }
 
     return nullptr;
 }
 
+DragonBonesData *CCFactory::parseBinaryDragonBonesData(const std::string &fullpath, const std::string &name, float scale) {
+    auto file = cc::FileUtils::getInstance()->mapFile(fullpath);
+    if (file == nullptr) {
+        return nullptr;
+    }
+
+    const auto *bytes = reinterpret_cast<const char *>(file->getBytes());
+    if (
+        file->getSize() >= sizeof(FlatDataHeader) &&
+        FlatDataParser::isFlatData(bytes) &&
+        reinterpret_cast<const FlatDataHeader *>(bytes)->size <= file->getSize()) {
+        // Flat data is read in place, its arrays keep pointing into the file until the data is cleared.
+        const auto dragonBonesData = parseDragonBonesData(bytes, name, scale);
+        recordDataDigest(name, dragonBonesData, bytes, file->getSize());
+        if (dragonBonesData != nullptr) {
+            auto *mappedFile = file.get();
+            mappedFile->addRef();
+            dragonBonesData->releaseBinary = [mappedFile]() {
+                mappedFile->release();
+            };
+        }
+
+        return dragonBonesData;
+    }
+
+    // NOTE: binary is freed in DragonBonesData::_onClear
+    auto *binary = static_cast<char *>(malloc(file->getSize()));
+    memcpy(binary, bytes, file->getSize());
+    const auto dragonBonesData = parseDragonBonesData(binary, name, scale);
+    recordDataDigest(name, dragonBonesData, bytes, file->getSize());
+    return dragonBonesData;
+}
+
 DragonBonesData *CCFactory::parseDragonBonesDataByPath(const std::string &filePath, const std::string &name, float scale) {
     if (!name.empty()) {
         const auto existedData = getDragonBonesData(name);
@@ -118,19 +150,34 @@ DragonBonesData *CCFactory::parseDragonBonesDataByPath(const std::string &filePa
     if (dbbinPos != std::string::npos) {
         const auto fullpath = cc::FileUtils::getInstance()->fullPathForFilename(filePath);
         if (cc::FileUtils::getInstance()->isFileExist(filePath)) {
-            cc::Data cocos2dData;
-            cc::FileUtils::getInstance()->getContents(fullpath, &cocos2dData);
-            uint8_t *binary = cocos2dData.takeBuffer();
-            // NOTE: binary is freed in DragonBonesData::_onClear
-            return parseDragonBonesData(reinterpret_cast<char *>(binary), name, scale);
+            return parseBinaryDragonBonesData(fullpath, name, scale);
         }
     } else {
-        return parseDragonBonesData(filePath.c_str(), name, scale);
+        // without the .dbbin extension the path carries the json text itself
+        const auto dragonBonesData = parseDragonBonesData(filePath.c_str(), name, scale);
+        recordDataDigest(name, dragonBonesData, filePath.data(), filePath.size());
+        return dragonBonesData;
     }
 
     return nullptr;
 }
 
+void CCFactory::recordDataDigest(const std::string &name, const DragonBonesData *dragonBonesData, const void *rawData, std::size_t size) {
+    if (dragonBonesData == nullptr || !ArmatureCache::PersistBakedFrames) {
+        return;
+    }
+
+    cc::MD5 md5;
+    md5.update(rawData, size);
+    _dataDigests[name.empty() ? dragonBonesData->name : name] = md5.hexDigest();
+}
+
+const std::string &CCFactory::getDragonBonesDataDigest(const std::string &name) const {
+    static const std::string empty;
+    const auto it = _dataDigests.find(name);
+    return it != _dataDigests.end() ? it->second : empty;
+}
+
 DragonBonesData *CCFactory::getDragonBonesDataByUUID(const std::string &uuid) {
     DragonBonesData *bonesData = nullptr;
     for (auto it = _dragonBonesDataMap.begin(); it != _dragonBonesDataMap.end();) {
@@ -88,6 +88,10 @@ public:
 
 protected:
     std::string _prevPath;
+    // MD5 of the raw skeleton data by data name, only kept while baked frames are persisted
+    std::map<std::string, std::string> _dataDigests;
+
+    void recordDataDigest(const std::string &name, const DragonBonesData *dragonBonesData, const void *rawData, std::size_t size);
 
 public:
     /**
@@ -132,6 +136,10 @@ protected:
     virtual TextureAtlasData *_buildTextureAtlasData(TextureAtlasData *textureAtlasData, void *textureAtlas) const override;
     virtual Armature *_buildArmature(const BuildArmaturePackage &dataPackage) const override;
     virtual Slot *_buildSlot(const BuildArmaturePackage &dataPackage, const SlotData *slotData, Armature *armature) const override;
+    /**
+     * Parses a binary file, flat data is used in place from the mapped file and binary data from a copy.
+     */
+    DragonBonesData *parseBinaryDragonBonesData(const std::string &fullpath, const std::string &name, float scale);
 
 public:
     virtual DragonBonesData *loadDragonBonesData(const std::string &filePath, const std::string &name = "", float scale = 1.0f);
@@ -248,6 +256,8 @@ public:
 
     CCTextureAtlasData *getTextureAtlasDataByIndex(const std::string &name, int textureIndex) const;
     DragonBonesData *parseDragonBonesDataByPath(const std::string &filePath, const std::string &name = "", float scale = 1.0f);
+    // Empty if the data was not loaded through this factory or while ArmatureCache::PersistBakedFrames is off.
+    const std::string &getDragonBonesDataDigest(const std::string &name) const;
 };
 
 DRAGONBONES_NAMESPACE_END
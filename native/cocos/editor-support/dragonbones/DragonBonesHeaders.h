@@ -73,6 +73,7 @@
     // parser
     #include "parser/BinaryDataParser.h"
     #include "parser/DataParser.h"
+    #include "parser/FlatDataParser.h"
     #include "parser/JSONDataParser.h"
 
     // factory
@@ -2,13 +2,21 @@
 DRAGONBONES_NAMESPACE_BEGIN
 
 std::vector<BaseObject*> BaseObject::__allDragonBonesObjects;
-unsigned BaseObject::_hashCode = 0;
+std::atomic<unsigned> BaseObject::_hashCode{0};
 unsigned BaseObject::_defaultMaxCount = 3000;
 std::map<std::size_t, unsigned> BaseObject::_maxCountMap;
 std::map<std::size_t, std::vector<BaseObject*>> BaseObject::_poolsMap;
 BaseObject::RecycleOrDestroyCallback BaseObject::_recycleOrDestroyCallback = nullptr;
+std::recursive_mutex BaseObject::_poolMutex;
+thread_local std::vector<BaseObject*>* BaseObject::_deferredReturns = nullptr;
 
 void BaseObject::_returnObject(BaseObject* object) {
+    if (_deferredReturns != nullptr) {
+        _deferredReturns->push_back(object);
+        return;
+    }
+
+    std::lock_guard<std::recursive_mutex> lock(_poolMutex);
     const auto classType = object->getClassTypeIndex();
     const auto maxCountIterator = _maxCountMap.find(classType);
     const auto maxCount = maxCountIterator != _maxCountMap.end() ? maxCountIterator->second : _defaultMaxCount;
@@ -37,7 +45,19 @@ void BaseObject::setObjectRecycleOrDestroyCallback(const std::function<void(Base
     _recycleOrDestroyCallback = cb;
 }
 
+void BaseObject::setDeferredReturnList(std::vector<BaseObject*>* list) {
+    _deferredReturns = list;
+}
+
+void BaseObject::returnDeferredObjects(std::vector<BaseObject*>& list) {
+    for (auto object : list) {
+        _returnObject(object);
+    }
+    list.clear();
+}
+
 void BaseObject::setMaxCount(std::size_t classType, unsigned maxCount) {
+    std::lock_guard<std::recursive_mutex> lock(_poolMutex);
     if (classType > 0) {
         const auto iterator = _poolsMap.find(classType);
         if (iterator != _poolsMap.end()) {
@@ -71,6 +91,7 @@ void BaseObject::setMaxCount(std::size_t classType, unsigned maxCount) {
     }
 }
 void BaseObject::clearPool(std::size_t classType) {
+    std::lock_guard<std::recursive_mutex> lock(_poolMutex);
     if (classType > 0) {
         const auto iterator = _poolsMap.find(classType);
         if (iterator != _poolsMap.end()) {
@@ -98,7 +119,8 @@ void BaseObject::clearPool(std::size_t classType) {
 }
 
 BaseObject::BaseObject()
-: hashCode(BaseObject::_hashCode++), _isInPool(false) {
+: hashCode(BaseObject::_hashCode.fetch_add(1)), _isInPool(false) {
+    std::lock_guard<std::recursive_mutex> lock(_poolMutex);
     __allDragonBonesObjects.push_back(this);
 }
 
@@ -106,6 +128,7 @@ BaseObject::~BaseObject() {
     if (_recycleOrDestroyCallback != nullptr)
         _recycleOrDestroyCallback(this, 1);
 
+    std::lock_guard<std::recursive_mutex> lock(_poolMutex);
     auto iter = std::find(__allDragonBonesObjects.begin(), __allDragonBonesObjects.end(), this);
     if (iter != __allDragonBonesObjects.end()) {
         __allDragonBonesObjects.erase(iter);
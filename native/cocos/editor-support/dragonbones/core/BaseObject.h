@@ -23,6 +23,8 @@
 #ifndef DRAGONBONES_BASE_OBJECT_H
 #define DRAGONBONES_BASE_OBJECT_H
 
+#include <atomic>
+#include <mutex>
 #include <vector>
 #include "DragonBones.h"
 
@@ -44,10 +46,14 @@ public:
     typedef std::function<void(BaseObject*, int)> RecycleOrDestroyCallback;
 
 private:
-    static unsigned _hashCode;
+    static std::atomic<unsigned> _hashCode;
     static unsigned _defaultMaxCount;
     static std::map<std::size_t, unsigned> _maxCountMap;
     static std::map<std::size_t, std::vector<BaseObject*>> _poolsMap;
+    // Pools are shared with armatures baked on worker threads.
+    static std::recursive_mutex _poolMutex;
+    // Set on threads whose returned objects must be pooled later on the main thread.
+    static thread_local std::vector<BaseObject*>* _deferredReturns;
     static void _returnObject(BaseObject* object);
 
     static RecycleOrDestroyCallback _recycleOrDestroyCallback;
@@ -82,6 +88,13 @@ public:
      * @language zh_CN
      */
     static void clearPool(std::size_t classTypeIndex = 0);
+    /**
+     * - Objects returned on the calling thread are cleared but only collected into the list,
+     * so pooling and the recycle callback stay on the thread that later calls returnDeferredObjects.
+     * Pass nullptr to return objects directly again.
+     */
+    static void setDeferredReturnList(std::vector<BaseObject*>* list);
+    static void returnDeferredObjects(std::vector<BaseObject*>& list);
     template <typename T>
     /**
      * - Get an instance of the specify class from object pool.
@@ -96,6 +109,7 @@ public:
      * @language zh_CN
      */
     static T* borrowObject() {
+        std::lock_guard<std::recursive_mutex> lock(_poolMutex);
         const auto classTypeIndex = T::getTypeIndex();
         const auto iterator = _poolsMap.find(classTypeIndex);
         if (iterator != _poolsMap.end()) {
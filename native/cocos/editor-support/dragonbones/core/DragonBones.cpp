@@ -33,19 +33,26 @@ DragonBones::~DragonBones() {
 }
 
 void DragonBones::advanceTime(float passedTime) {
-    if (!_objectsMap.empty()) {
-        for (auto it = _objectsMap.begin(); it != _objectsMap.end(); it++) {
+    std::map<BaseObject*, bool> objectsMap;
+    std::vector<EventObject*> events;
+    {
+        std::lock_guard<std::mutex> lock(_bufferMutex);
+        objectsMap.swap(_objectsMap);
+        events.swap(_events);
+    }
+
+    if (!objectsMap.empty()) {
+        for (auto it = objectsMap.begin(); it != objectsMap.end(); it++) {
             auto object = it->first;
             if (object) {
                 object->returnToPool();
             }
         }
-        _objectsMap.clear();
     }
 
-    if (!_events.empty()) {
-        for (std::size_t i = 0; i < _events.size(); ++i) {
-            const auto eventObject = _events[i];
+    if (!events.empty()) {
+        for (std::size_t i = 0; i < events.size(); ++i) {
+            const auto eventObject = events[i];
             const auto armature = eventObject->armature;
             if (armature->_armatureData != nullptr) {
                 armature->getProxy()->dispatchDBEvent(eventObject->type, eventObject);
@@ -56,8 +63,6 @@ void DragonBones::advanceTime(float passedTime) {
 
             bufferObject(eventObject);
         }
-
-        _events.clear();
     }
 
     _clock->advanceTime(passedTime);
@@ -68,11 +73,33 @@ void DragonBones::render() {
 }
 
 void DragonBones::bufferEvent(EventObject* value) {
+    std::lock_guard<std::mutex> lock(_bufferMutex);
     _events.push_back(value);
 }
 
+void DragonBones::discardBuffered() {
+    std::map<BaseObject*, bool> objectsMap;
+    std::vector<EventObject*> events;
+    {
+        std::lock_guard<std::mutex> lock(_bufferMutex);
+        objectsMap.swap(_objectsMap);
+        events.swap(_events);
+    }
+
+    for (auto it = objectsMap.begin(); it != objectsMap.end(); it++) {
+        auto object = it->first;
+        if (object) {
+            object->returnToPool();
+        }
+    }
+    for (const auto eventObject : events) {
+        eventObject->returnToPool();
+    }
+}
+
 void DragonBones::bufferObject(BaseObject* object) {
     if (object == nullptr || object->isInPool()) return;
+    std::lock_guard<std::mutex> lock(_bufferMutex);
     // Just mark object will be put in pool next frame, 'true' is useless.
     _objectsMap[object] = true;
 }
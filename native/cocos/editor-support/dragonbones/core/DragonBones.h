@@ -29,6 +29,7 @@
 #include <cstdint>
 #include <functional>
 #include <map>
+#include <mutex>
 #include <sstream>
 #include <string>
 #include <tuple>
@@ -445,6 +446,8 @@ public:
     static bool checkInPool;
 
 private:
+    // guards the buffers below, armatures may be baked off the main thread
+    std::mutex _bufferMutex;
     std::map<BaseObject*, bool> _objectsMap;
     std::vector<EventObject*> _events;
     WorldClock* _clock;
@@ -458,6 +461,8 @@ public:
     void render();
     void bufferEvent(EventObject* value);
     void bufferObject(BaseObject* object);
+    // Returns the buffered objects and events to the pool without dispatching the events.
+    void discardBuffered();
 
     WorldClock* getClock();
     IEventDispatcher* getEventManager() const {
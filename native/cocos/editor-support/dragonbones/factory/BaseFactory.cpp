@@ -4,6 +4,7 @@ DRAGONBONES_NAMESPACE_BEGIN
 
 JSONDataParser BaseFactory::_jsonParser;
 BinaryDataParser BaseFactory::_binaryParser;
+FlatDataParser BaseFactory::_flatParser;
 
 TextureData* BaseFactory::_getTextureData(const std::string& textureAtlasName, const std::string& textureName) const {
     const auto iterator = _textureAtlasDataMap.find(textureAtlasName);
@@ -253,6 +254,8 @@ DragonBonesData* BaseFactory::parseDragonBonesData(const char* rawData, const st
         rawData[2] == 'D' &&
         rawData[3] == 'T') {
         dataParser = &_binaryParser;
+    } else if (FlatDataParser::isFlatData(rawData)) {
+        dataParser = &_flatParser;
     } else {
         dataParser = _dataParser;
     }
@@ -29,6 +29,7 @@
 #include "../armature/Constraint.h"
 #include "../armature/Slot.h"
 #include "../parser/BinaryDataParser.h"
+#include "../parser/FlatDataParser.h"
 #include "../parser/JSONDataParser.h"
 
 DRAGONBONES_NAMESPACE_BEGIN
@@ -58,6 +59,7 @@ class BaseFactory {
 protected:
     static JSONDataParser _jsonParser;
     static BinaryDataParser _binaryParser;
+    static FlatDataParser _flatParser;
 
 public:
     /**
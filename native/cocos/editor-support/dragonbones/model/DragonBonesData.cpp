@@ -10,9 +10,14 @@ void DragonBonesData::_onClear() {
     }
 
     if (binary != nullptr) {
-        free(const_cast<char*>(binary));
+        if (releaseBinary) {
+            releaseBinary();
+        } else {
+            free(const_cast<char*>(binary));
+        }
         binary = nullptr;
     }
+    releaseBinary = nullptr;
 
     if (userData != nullptr) {
         userData->returnToPool();
@@ -34,6 +39,7 @@ void DragonBonesData::_onClear() {
     frameFloatArray = nullptr;
     frameArray = nullptr;
     timelineArray = nullptr;
+    std::fill(std::begin(arrayLengths), std::end(arrayLengths), 0);
 }
 
 void DragonBonesData::addArmature(ArmatureData* value) {
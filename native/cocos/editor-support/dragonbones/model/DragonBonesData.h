@@ -135,6 +135,17 @@ public:
      * @internal
      */
     const uint16_t* timelineArray;
+    /**
+     * @internal
+     * Byte lengths of the int, float, frame int, frame float, frame and timeline arrays.
+     */
+    unsigned arrayLengths[6];
+    /**
+     * @internal
+     * Releases a binary that does not come from malloc, e.g. flat data read in place from a mapped file.
+     * When it is empty the binary is freed.
+     */
+    std::function<void()> releaseBinary;
     /**
      * @private
      */
@@ -174,6 +174,10 @@ void BinaryDataParser::_parseArray(const rapidjson::Value& rawData) {
     _data->frameFloatArray = _frameFloatArray = (float*)(_binary + _binaryOffset + offsets[6].GetUint());
     _data->frameArray = _frameArray = (int16_t*)(_binary + _binaryOffset + offsets[8].GetUint());
     _data->timelineArray = _timelineArray = (uint16_t*)(_binary + _binaryOffset + offsets[10].GetUint());
+
+    for (std::size_t i = 0; i < 6; ++i) {
+        _data->arrayLengths[i] = offsets[i * 2 + 1].GetUint();
+    }
 }
 
 DragonBonesData* BinaryDataParser::parseDragonBonesData(const char* rawData, float scale) {
@@ -0,0 +1,491 @@
+#include "FlatDataParser.h"
+#include <cstring>
+
+DRAGONBONES_NAMESPACE_BEGIN
+
+const char FlatDataParser::MAGIC[4] = {'D', 'B', 'F', 'L'};
+const uint32_t FlatDataParser::FORMAT_VERSION = 1;
+
+bool FlatDataParser::isFlatData(const char* rawData) {
+    return rawData != nullptr &&
+           rawData[0] == MAGIC[0] &&
+           rawData[1] == MAGIC[1] &&
+           rawData[2] == MAGIC[2] &&
+           rawData[3] == MAGIC[3];
+}
+
+uint32_t FlatDataParser::_readUint() {
+    if (_current >= _end) {
+        _error = true;
+        return 0;
+    }
+
+    return *_current++;
+}
+
+int FlatDataParser::_readInt() {
+    return (int)_readUint();
+}
+
+float FlatDataParser::_readFloat() {
+    const auto value = _readUint();
+    float result = 0.0f;
+    memcpy(&result, &value, sizeof(result));
+    return result;
+}
+
+bool FlatDataParser::_readBool() {
+    return _readUint() != 0;
+}
+
+std::string FlatDataParser::_getString(uint32_t index) {
+    if (index >= _header->stringCount) {
+        _error = true;
+        return "";
+    }
+
+    const auto entry = (const uint32_t*)(_rawData + _header->stringTable) + index * 2;
+    if (entry[0] > _header->size || entry[1] > _header->size - entry[0]) {
+        _error = true;
+        return "";
+    }
+
+    return std::string(_rawData + entry[0], entry[1]);
+}
+
+std::string FlatDataParser::_readString() {
+    return _getString(_readUint());
+}
+
+BoneData* FlatDataParser::_readBone() {
+    const auto index = _readInt();
+    return index >= 0 && (std::size_t)index < _bones.size() ? _bones[index] : nullptr;
+}
+
+SlotData* FlatDataParser::_readSlot() {
+    const auto index = _readInt();
+    return index >= 0 && (std::size_t)index < _slots.size() ? _slots[index] : nullptr;
+}
+
+void FlatDataParser::_readTransform(Transform& transform, float scale) {
+    transform.x = _readFloat() * scale;
+    transform.y = _readFloat() * scale;
+    transform.skew = _readFloat();
+    transform.rotation = _readFloat();
+    transform.scaleX = _readFloat();
+    transform.scaleY = _readFloat();
+}
+
+void FlatDataParser::_readRectangle(Rectangle& rectangle, float scale) {
+    rectangle.x = _readFloat() * scale;
+    rectangle.y = _readFloat() * scale;
+    rectangle.width = _readFloat() * scale;
+    rectangle.height = _readFloat() * scale;
+}
+
+UserData* FlatDataParser::_readUserData() {
+    if (!_readBool()) {
+        return nullptr;
+    }
+
+    const auto userData = BaseObject::borrowObject<UserData>();
+    for (std::size_t i = 0, l = _readUint(); i < l && !_error; ++i) {
+        userData->addInt(_readInt());
+    }
+
+    for (std::size_t i = 0, l = _readUint(); i < l && !_error; ++i) {
+        userData->addFloat(_readFloat());
+    }
+
+    for (std::size_t i = 0, l = _readUint(); i < l && !_error; ++i) {
+        userData->addString(_readString());
+    }
+
+    return userData;
+}
+
+void FlatDataParser::_readActions(std::vector<ActionData*>& actions) {
+    for (std::size_t i = 0, l = _readUint(); i < l && !_error; ++i) {
+        const auto action = BaseObject::borrowObject<ActionData>();
+        action->type = (ActionType)_readInt();
+        action->name = _readString();
+        action->bone = _readBone();
+        action->slot = _readSlot();
+        action->data = _readUserData();
+        actions.push_back(action);
+    }
+}
+
+TimelineData* FlatDataParser::_readTimeline() {
+    const auto type = _readInt();
+    if (type < 0) {
+        return nullptr;
+    }
+
+    const auto timeline = BaseObject::borrowObject<TimelineData>();
+    timeline->type = (TimelineType)type;
+    timeline->offset = _readUint();
+    timeline->frameIndicesOffset = _readInt();
+
+    return timeline;
+}
+
+void FlatDataParser::_readTimelines(std::map<std::string, std::vector<TimelineData*>>& timelines) {
+    for (std::size_t i = 0, l = _readUint(); i < l && !_error; ++i) {
+        auto& values = timelines[_readString()];
+        for (std::size_t j = 0, lJ = _readUint(); j < lJ && !_error; ++j) {
+            const auto timeline = _readTimeline();
+            if (timeline != nullptr) {
+                values.push_back(timeline);
+            }
+        }
+    }
+}
+
+DisplayData* FlatDataParser::_readDisplay() {
+    const auto type = _readInt();
+    if (type < 0) {
+        return nullptr;
+    }
+
+    const auto& name = _readString();
+    const auto& path = _readString();
+    DisplayData* display = nullptr;
+
+    switch ((DisplayType)type) {
+        case DisplayType::Image: {
+            const auto imageDisplay = BaseObject::borrowObject<ImageDisplayData>();
+            imageDisplay->pivot.x = _readFloat();
+            imageDisplay->pivot.y = _readFloat();
+
+            display = imageDisplay;
+            break;
+        }
+
+        case DisplayType::Armature: {
+            const auto armatureDisplay = BaseObject::borrowObject<ArmatureDisplayData>();
+            armatureDisplay->inheritAnimation = _readBool();
+            _readActions(armatureDisplay->actions);
+
+            display = armatureDisplay;
+            break;
+        }
+
+        case DisplayType::Mesh: {
+            const auto meshDisplay = BaseObject::borrowObject<MeshDisplayData>();
+            auto& vertices = meshDisplay->vertices;
+            vertices.inheritDeform = _readBool();
+            vertices.isShared = _readBool();
+            vertices.offset = _readUint();
+            vertices.data = _data;
+
+            const auto weightOffset = _readInt();
+            if (vertices.isShared) {
+                // Linked once the whole armature is read, the owner may come later.
+                if (weightOffset >= 0) {
+                    _sharedMeshes.emplace_back(meshDisplay, (unsigned)weightOffset);
+                }
+            } else if (weightOffset >= 0) {
+                const auto weight = BaseObject::borrowObject<WeightData>();
+                weight->offset = weightOffset;
+                weight->count = _readUint();
+                for (std::size_t i = 0, l = _readUint(); i < l && !_error; ++i) {
+                    weight->addBone(_readBone());
+                }
+
+                vertices.weight = weight;
+                _weights[weight->offset] = weight;
+            }
+
+            display = meshDisplay;
+            break;
+        }
+
+        case DisplayType::BoundingBox: {
+            BoundingBoxData* boundingBox = nullptr;
+            switch ((BoundingBoxType)_readInt()) {
+                case BoundingBoxType::Rectangle:
+                    boundingBox = BaseObject::borrowObject<RectangleBoundingBoxData>();
+                    break;
+
+                case BoundingBoxType::Ellipse:
+                    boundingBox = BaseObject::borrowObject<EllipseBoundingBoxData>();
+                    break;
+
+                case BoundingBoxType::Polygon:
+                    boundingBox = BaseObject::borrowObject<PolygonBoundingBoxData>();
+                    break;
+
+                default:
+                    _error = true;
+                    return nullptr;
+            }
+
+            boundingBox->color = _readUint();
+            boundingBox->width = _readFloat();
+            boundingBox->height = _readFloat();
+            if (boundingBox->type == BoundingBoxType::Polygon) {
+                const auto polygonBoundingBox = static_cast<PolygonBoundingBoxData*>(boundingBox);
+                polygonBoundingBox->x = _readFloat();
+                polygonBoundingBox->y = _readFloat();
+                polygonBoundingBox->vertices.resize(_error ? 0 : _readUint());
+                for (auto& value : polygonBoundingBox->vertices) {
+                    value = _readFloat();
+                }
+            }
+
+            const auto boundingBoxDisplay = BaseObject::borrowObject<BoundingBoxDisplayData>();
+            boundingBoxDisplay->boundingBox = boundingBox;
+
+            display = boundingBoxDisplay;
+            break;
+        }
+
+        default:
+            _error = true;
+            return nullptr;
+    }
+
+    display->name = name;
+    display->path = path;
+    _readTransform(display->transform, _scale);
+
+    return display;
+}
+
+AnimationData* FlatDataParser::_readAnimation() {
+    const auto animation = BaseObject::borrowObject<AnimationData>();
+    animation->name = _readString();
+    animation->frameIntOffset = _readUint();
+    animation->frameFloatOffset = _readUint();
+    animation->frameOffset = _readUint();
+    animation->frameCount = _readUint();
+    animation->playTimes = _readUint();
+    animation->duration = _readFloat();
+    animation->scale = _readFloat();
+    animation->fadeInTime = _readFloat();
+    animation->actionTimeline = _readTimeline();
+    animation->zOrderTimeline = _readTimeline();
+    _readTimelines(animation->boneTimelines);
+    _readTimelines(animation->slotTimelines);
+    _readTimelines(animation->constraintTimelines);
+
+    return animation;
+}
+
+ArmatureData* FlatDataParser::_readArmature() {
+    const auto armature = BaseObject::borrowObject<ArmatureData>();
+    armature->name = _readString();
+    armature->type = (ArmatureType)_readInt();
+    armature->frameRate = _readUint();
+    armature->scale = _scale;
+    _readRectangle(armature->aabb, _scale);
+
+    if (_readBool()) {
+        const auto canvas = BaseObject::borrowObject<CanvasData>();
+        canvas->hasBackground = _readBool();
+        canvas->color = _readUint();
+        _readRectangle(canvas->aabb, _scale);
+        armature->canvas = canvas;
+    }
+
+    armature->userData = _readUserData();
+
+    // Bones are stored sorted, they are added in place of sortBones().
+    for (std::size_t i = 0, l = _readUint(); i < l && !_error; ++i) {
+        const auto bone = BaseObject::borrowObject<BoneData>();
+        bone->name = _readString();
+        bone->inheritTranslation = _readBool();
+        bone->inheritRotation = _readBool();
+        bone->inheritScale = _readBool();
+        bone->inheritReflection = _readBool();
+        bone->length = _readFloat() * _scale;
+        _readTransform(bone->transform, _scale);
+        bone->parent = _readBone();
+        bone->userData = _readUserData();
+
+        armature->addBone(bone);
+        _bones.push_back(bone);
+    }
+
+    for (std::size_t i = 0, l = _readUint(); i < l && !_error; ++i) {
+        const auto constraint = BaseObject::borrowObject<IKConstraintData>();
+        constraint->name = _readString();
+        constraint->order = _readInt();
+        constraint->target = _readBone();
+        constraint->root = _readBone();
+        constraint->bone = _readBone();
+        constraint->scaleEnabled = _readBool();
+        constraint->bendPositive = _readBool();
+        constraint->weight = _readFloat();
+
+        armature->addConstraint(constraint);
+    }
+
+    for (std::size_t i = 0, l = _readUint(); i < l && !_error; ++i) {
+        const auto slot = BaseObject::borrowObject<SlotData>();
+        slot->name = _readString();
+        slot->blendMode = (BlendMode)_readInt();
+        slot->displayIndex = _readInt();
+        slot->zOrder = _readInt();
+        slot->parent = _readBone();
+
+        if (_readBool()) {
+            slot->color = SlotData::createColor();
+            slot->color->alphaMultiplier = _readFloat();
+            slot->color->redMultiplier = _readFloat();
+            slot->color->greenMultiplier = _readFloat();
+            slot->color->blueMultiplier = _readFloat();
+            slot->color->alphaOffset = _readInt();
+            slot->color->redOffset = _readInt();
+            slot->color->greenOffset = _readInt();
+            slot->color->blueOffset = _readInt();
+        } else {
+            slot->color = &SlotData::DEFAULT_COLOR;
+        }
+
+        slot->userData = _readUserData();
+
+        armature->addSlot(slot);
+        _slots.push_back(slot);
+    }
+
+    const auto defaultSkin = _readInt();
+    for (int i = 0, l = _readInt(); i < l && !_error; ++i) {
+        const auto skin = BaseObject::borrowObject<SkinData>();
+        skin->name = _readString();
+        for (std::size_t j = 0, lJ = _readUint(); j < lJ && !_error; ++j) {
+            const auto& slotName = _readString();
+            for (std::size_t k = 0, lK = _readUint(); k < lK && !_error; ++k) {
+                skin->addDisplay(slotName, _readDisplay());
+            }
+        }
+
+        armature->addSkin(skin);
+        if (i == defaultSkin) {
+            armature->defaultSkin = skin;
+        }
+    }
+
+    for (const auto& pair : _sharedMeshes) {
+        const auto iterator = _weights.find(pair.second);
+        if (iterator != _weights.end()) {
+            pair.first->vertices.weight = iterator->second;
+        }
+    }
+
+    const auto defaultAnimation = _readInt();
+    for (int i = 0, l = _readInt(); i < l && !_error; ++i) {
+        const auto animation = _readAnimation();
+        armature->addAnimation(animation);
+        if (i == defaultAnimation) {
+            armature->defaultAnimation = animation;
+        }
+    }
+
+    _readActions(armature->defaultActions);
+    _readActions(armature->actions);
+
+    return armature;
+}
+
+DragonBonesData* FlatDataParser::parseDragonBonesData(const char* rawData, float scale) {
+    DRAGONBONES_ASSERT(rawData != nullptr, "");
+
+    const auto header = (const FlatDataHeader*)rawData;
+    if (!isFlatData(rawData) || header->formatVersion != FORMAT_VERSION) {
+        DRAGONBONES_ASSERT(false, "Nonsupport data.");
+        return nullptr;
+    }
+
+    auto inFile = [header](uint32_t offset, uint64_t length) {
+        return offset <= header->size && length <= header->size - offset;
+    };
+
+    auto valid = inFile(header->stringTable, (uint64_t)header->stringCount * 8) &&
+                 inFile(header->armatureTable, (uint64_t)header->armatureCount * 8);
+    for (const auto& array : header->arrays) {
+        valid = valid && inFile(array[0], array[1]) && array[0] % 4 == 0;
+    }
+
+    if (!valid) {
+        DRAGONBONES_ASSERT(false, "Data error.");
+        return nullptr;
+    }
+
+    _rawData = rawData;
+    _header = header;
+    _scale = scale;
+    _error = false;
+
+    const auto data = BaseObject::borrowObject<DragonBonesData>();
+    data->name = _getString(header->name);
+    data->version = _getString(header->version);
+    data->frameRate = header->frameRate;
+    data->intArray = (const int16_t*)(rawData + header->arrays[FlatDataHeader::IntArray][0]);
+    data->floatArray = (const float*)(rawData + header->arrays[FlatDataHeader::FloatArray][0]);
+    data->frameIntArray = (const int16_t*)(rawData + header->arrays[FlatDataHeader::FrameIntArray][0]);
+    data->frameFloatArray = (const float*)(rawData + header->arrays[FlatDataHeader::FrameFloatArray][0]);
+    data->frameArray = (const int16_t*)(rawData + header->arrays[FlatDataHeader::FrameArray][0]);
+    data->timelineArray = (const uint16_t*)(rawData + header->arrays[FlatDataHeader::TimelineArray][0]);
+
+    for (std::size_t i = 0; i < FlatDataHeader::FrameIndices; ++i) {
+        data->arrayLengths[i] = header->arrays[i][1];
+    }
+
+    const auto& frameIndices = header->arrays[FlatDataHeader::FrameIndices];
+    const auto frameIndicesBegin = (const uint32_t*)(rawData + frameIndices[0]);
+    data->frameIndices.assign(frameIndicesBegin, frameIndicesBegin + frameIndices[1] / sizeof(uint32_t));
+
+    _data = data;
+
+    const auto armatureTable = (const uint32_t*)(rawData + header->armatureTable);
+    for (std::size_t i = 0, l = header->armatureCount; i < l && !_error; ++i) {
+        const auto offset = armatureTable[i * 2];
+        const auto length = armatureTable[i * 2 + 1];
+        if (!inFile(offset, length) || offset % 4 != 0) {
+            _error = true;
+            break;
+        }
+
+        _current = (const uint32_t*)(rawData + offset);
+        _end = _current + length / sizeof(uint32_t);
+        _bones.clear();
+        _slots.clear();
+        _sharedMeshes.clear();
+        _weights.clear();
+
+        const auto armature = _readArmature();
+        if (_error) {
+            armature->returnToPool();
+            break;
+        }
+
+        data->addArmature(armature);
+    }
+
+    _current = nullptr;
+    _end = nullptr;
+    _data = nullptr;
+    _bones.clear();
+    _slots.clear();
+    _sharedMeshes.clear();
+    _weights.clear();
+
+    if (_error) {
+        data->returnToPool();
+        DRAGONBONES_ASSERT(false, "Data error.");
+        return nullptr;
+    }
+
+    // The arrays above point into the raw data, so it is owned by the data from now on.
+    data->binary = rawData;
+
+    return data;
+}
+
+bool FlatDataParser::parseTextureAtlasData(const char* rawData, TextureAtlasData& textureAtlasData, float scale) {
+    return false;
+}
+
+DRAGONBONES_NAMESPACE_END
@@ -0,0 +1,132 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2012-2018 DragonBones team and other contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef DRAGONBONES_FLAT_DATA_PARSER_H
+#define DRAGONBONES_FLAT_DATA_PARSER_H
+
+#include "DataParser.h"
+
+DRAGONBONES_NAMESPACE_BEGIN
+
+/**
+ * @internal
+ * Layout of the flat data format, all values are little endian and all offsets count from the file start.
+ *
+ * The file is the already parsed DragonBones data, written by FlatDataWriter:
+ * - A string pool, every name is an index into the string table of (offset, length) pairs.
+ * - One record per armature, found through the armature table. A record is a run of 32 bit words
+ *   (bones, slots, constraints, skins, actions, animations and their timelines) read in order.
+ * - The int, float, frame and timeline arrays, 8 byte aligned and used in place, without a copy.
+ *
+ * Lengths and positions are stored at scale 1, the scale passed to the parser is applied on load.
+ */
+struct FlatDataHeader {
+    enum Array {
+        IntArray,
+        FloatArray,
+        FrameIntArray,
+        FrameFloatArray,
+        FrameArray,
+        TimelineArray,
+        FrameIndices,
+        ArrayCount
+    };
+
+    char magic[4];
+    uint32_t formatVersion;
+    uint32_t size;
+    uint32_t name;
+    uint32_t version;
+    uint32_t frameRate;
+    uint32_t stringCount;
+    uint32_t stringTable;
+    uint32_t armatureCount;
+    uint32_t armatureTable;
+    // (offset, byte length) of every array.
+    uint32_t arrays[ArrayCount][2];
+};
+
+/**
+ * @internal
+ * Builds DragonBonesData from the flat data format without tokenizing or key lookups.
+ * The parsed data keeps pointing into rawData, it owns rawData the same way as binary data.
+ */
+class FlatDataParser : public DataParser {
+    DRAGONBONES_DISALLOW_COPY_AND_ASSIGN(FlatDataParser)
+
+public:
+    static const char MAGIC[4];
+    static const uint32_t FORMAT_VERSION;
+
+    static bool isFlatData(const char* rawData);
+
+private:
+    const char* _rawData;
+    const FlatDataHeader* _header;
+    const uint32_t* _current;
+    const uint32_t* _end;
+    DragonBonesData* _data;
+    std::vector<BoneData*> _bones;
+    std::vector<SlotData*> _slots;
+    std::vector<std::pair<MeshDisplayData*, unsigned>> _sharedMeshes;
+    std::map<unsigned, WeightData*> _weights;
+    float _scale;
+    bool _error;
+
+    uint32_t _readUint();
+    int _readInt();
+    float _readFloat();
+    bool _readBool();
+    std::string _getString(uint32_t index);
+    std::string _readString();
+    BoneData* _readBone();
+    SlotData* _readSlot();
+
+    void _readTransform(Transform& transform, float scale);
+    void _readRectangle(Rectangle& rectangle, float scale);
+    UserData* _readUserData();
+    void _readActions(std::vector<ActionData*>& actions);
+    TimelineData* _readTimeline();
+    void _readTimelines(std::map<std::string, std::vector<TimelineData*>>& timelines);
+    DisplayData* _readDisplay();
+    ArmatureData* _readArmature();
+    AnimationData* _readAnimation();
+
+public:
+    FlatDataParser() : _rawData(nullptr),
+                       _header(nullptr),
+                       _current(nullptr),
+                       _end(nullptr),
+                       _data(nullptr),
+                       _scale(1.0f),
+                       _error(false) {}
+    virtual ~FlatDataParser() {}
+
+    virtual DragonBonesData* parseDragonBonesData(const char* rawData, float scale = 1.0f) override;
+    /**
+     * Flat data has no embedded texture atlases, they stay in their own json files.
+     */
+    virtual bool parseTextureAtlasData(const char* rawData, TextureAtlasData& textureAtlasData, float scale = 1.0f) override;
+};
+
+DRAGONBONES_NAMESPACE_END
+#endif // DRAGONBONES_FLAT_DATA_PARSER_H
@@ -0,0 +1,399 @@
+#include "FlatDataWriter.h"
+#include <cstring>
+
+DRAGONBONES_NAMESPACE_BEGIN
+
+namespace {
+
+void alignTo(std::vector<char>& result, std::size_t alignment) {
+    result.resize((result.size() + alignment - 1) / alignment * alignment, 0);
+}
+
+uint32_t append(std::vector<char>& result, const void* data, std::size_t length) {
+    alignTo(result, 8);
+    const auto offset = (uint32_t)result.size();
+    result.insert(result.end(), (const char*)data, (const char*)data + length);
+    return offset;
+}
+
+} // namespace
+
+void FlatDataWriter::_writeUint(uint32_t value) {
+    _words.push_back(value);
+}
+
+void FlatDataWriter::_writeInt(int value) {
+    _words.push_back((uint32_t)value);
+}
+
+void FlatDataWriter::_writeFloat(float value) {
+    uint32_t word = 0;
+    memcpy(&word, &value, sizeof(word));
+    _words.push_back(word);
+}
+
+void FlatDataWriter::_writeBool(bool value) {
+    _words.push_back(value ? 1 : 0);
+}
+
+uint32_t FlatDataWriter::_addString(const std::string& value) {
+    const auto iterator = _stringIndices.find(value);
+    if (iterator != _stringIndices.end()) {
+        return iterator->second;
+    }
+
+    const auto index = (uint32_t)_strings.size();
+    _strings.push_back(value);
+    _stringIndices[value] = index;
+
+    return index;
+}
+
+void FlatDataWriter::_writeString(const std::string& value) {
+    _writeUint(_addString(value));
+}
+
+void FlatDataWriter::_writeBone(const BoneData* value) {
+    const auto iterator = _boneIndices.find(value);
+    _writeInt(iterator != _boneIndices.end() ? iterator->second : -1);
+}
+
+void FlatDataWriter::_writeSlot(const SlotData* value) {
+    const auto iterator = _slotIndices.find(value);
+    _writeInt(iterator != _slotIndices.end() ? iterator->second : -1);
+}
+
+void FlatDataWriter::_writeTransform(const Transform& value, float scale) {
+    _writeFloat(value.x / scale);
+    _writeFloat(value.y / scale);
+    _writeFloat(value.skew);
+    _writeFloat(value.rotation);
+    _writeFloat(value.scaleX);
+    _writeFloat(value.scaleY);
+}
+
+void FlatDataWriter::_writeRectangle(const Rectangle& value, float scale) {
+    _writeFloat(value.x / scale);
+    _writeFloat(value.y / scale);
+    _writeFloat(value.width / scale);
+    _writeFloat(value.height / scale);
+}
+
+void FlatDataWriter::_writeUserData(const UserData* value) {
+    _writeBool(value != nullptr);
+    if (value == nullptr) {
+        return;
+    }
+
+    _writeUint(value->ints.size());
+    for (const auto item : value->ints) {
+        _writeInt(item);
+    }
+
+    _writeUint(value->floats.size());
+    for (const auto item : value->floats) {
+        _writeFloat(item);
+    }
+
+    _writeUint(value->strings.size());
+    for (const auto& item : value->strings) {
+        _writeString(item);
+    }
+}
+
+void FlatDataWriter::_writeActions(const std::vector<ActionData*>& value) {
+    _writeUint(value.size());
+    for (const auto action : value) {
+        _writeInt((int)action->type);
+        _writeString(action->name);
+        _writeBone(action->bone);
+        _writeSlot(action->slot);
+        _writeUserData(action->data);
+    }
+}
+
+void FlatDataWriter::_writeTimeline(const TimelineData* value) {
+    if (value == nullptr) {
+        _writeInt(-1);
+        return;
+    }
+
+    _writeInt((int)value->type);
+    _writeUint(value->offset);
+    _writeInt(value->frameIndicesOffset);
+}
+
+void FlatDataWriter::_writeTimelines(const std::map<std::string, std::vector<TimelineData*>>& value) {
+    _writeUint(value.size());
+    for (const auto& pair : value) {
+        _writeString(pair.first);
+        _writeUint(pair.second.size());
+        for (const auto timeline : pair.second) {
+            _writeTimeline(timeline);
+        }
+    }
+}
+
+void FlatDataWriter::_writeDisplay(const DisplayData* value) {
+    if (
+        value == nullptr ||
+        value->type == DisplayType::Path ||
+        (value->type == DisplayType::BoundingBox && static_cast<const BoundingBoxDisplayData*>(value)->boundingBox == nullptr)) {
+        _writeInt(-1);
+        return;
+    }
+
+    _writeInt((int)value->type);
+    _writeString(value->name);
+    _writeString(value->path);
+
+    switch (value->type) {
+        case DisplayType::Image: {
+            const auto imageDisplay = static_cast<const ImageDisplayData*>(value);
+            _writeFloat(imageDisplay->pivot.x);
+            _writeFloat(imageDisplay->pivot.y);
+            break;
+        }
+
+        case DisplayType::Armature: {
+            const auto armatureDisplay = static_cast<const ArmatureDisplayData*>(value);
+            _writeBool(armatureDisplay->inheritAnimation);
+            _writeActions(armatureDisplay->actions);
+            break;
+        }
+
+        case DisplayType::Mesh: {
+            const auto& vertices = static_cast<const MeshDisplayData*>(value)->vertices;
+            _writeBool(vertices.inheritDeform);
+            _writeBool(vertices.isShared);
+            _writeUint(vertices.offset);
+            _writeInt(vertices.weight != nullptr ? (int)vertices.weight->offset : -1);
+            if (!vertices.isShared && vertices.weight != nullptr) {
+                _writeUint(vertices.weight->count);
+                _writeUint(vertices.weight->bones.size());
+                for (const auto bone : vertices.weight->bones) {
+                    _writeBone(bone);
+                }
+            }
+            break;
+        }
+
+        case DisplayType::BoundingBox: {
+            const auto boundingBox = static_cast<const BoundingBoxDisplayData*>(value)->boundingBox;
+            _writeInt((int)boundingBox->type);
+            _writeUint(boundingBox->color);
+            _writeFloat(boundingBox->width);
+            _writeFloat(boundingBox->height);
+            if (boundingBox->type == BoundingBoxType::Polygon) {
+                const auto polygonBoundingBox = static_cast<const PolygonBoundingBoxData*>(boundingBox);
+                _writeFloat(polygonBoundingBox->x);
+                _writeFloat(polygonBoundingBox->y);
+                _writeUint(polygonBoundingBox->vertices.size());
+                for (const auto item : polygonBoundingBox->vertices) {
+                    _writeFloat(item);
+                }
+            }
+            break;
+        }
+
+        default:
+            break;
+    }
+
+    _writeTransform(value->transform, _scale);
+}
+
+void FlatDataWriter::_writeAnimation(const AnimationData& value) {
+    _writeString(value.name);
+    _writeUint(value.frameIntOffset);
+    _writeUint(value.frameFloatOffset);
+    _writeUint(value.frameOffset);
+    _writeUint(value.frameCount);
+    _writeUint(value.playTimes);
+    _writeFloat(value.duration);
+    _writeFloat(value.scale);
+    _writeFloat(value.fadeInTime);
+    _writeTimeline(value.actionTimeline);
+    _writeTimeline(value.zOrderTimeline);
+    _writeTimelines(value.boneTimelines);
+    _writeTimelines(value.slotTimelines);
+    _writeTimelines(value.constraintTimelines);
+}
+
+void FlatDataWriter::_writeArmature(const ArmatureData& value) {
+    _scale = value.scale != 0.0f ? value.scale : 1.0f;
+    _boneIndices.clear();
+    _slotIndices.clear();
+
+    _writeString(value.name);
+    _writeInt((int)value.type);
+    _writeUint(value.frameRate);
+    _writeRectangle(value.aabb, _scale);
+
+    _writeBool(value.canvas != nullptr);
+    if (value.canvas != nullptr) {
+        _writeBool(value.canvas->hasBackground);
+        _writeUint(value.canvas->color);
+        _writeRectangle(value.canvas->aabb, _scale);
+    }
+
+    _writeUserData(value.userData);
+
+    // Sorted, so the weights and the runtime bone order match without sorting again.
+    _writeUint(value.sortedBones.size());
+    for (const auto bone : value.sortedBones) {
+        _writeString(bone->name);
+        _writeBool(bone->inheritTranslation);
+        _writeBool(bone->inheritRotation);
+        _writeBool(bone->inheritScale);
+        _writeBool(bone->inheritReflection);
+        _writeFloat(bone->length / _scale);
+        _writeTransform(bone->transform, _scale);
+        _writeBone(bone->parent);
+        _writeUserData(bone->userData);
+
+        _boneIndices[bone] = (int)_boneIndices.size();
+    }
+
+    _writeUint(value.constraints.size());
+    for (const auto& pair : value.constraints) {
+        // IK is the only constraint type.
+        const auto constraint = static_cast<const IKConstraintData*>(pair.second);
+        _writeString(constraint->name);
+        _writeInt(constraint->order);
+        _writeBone(constraint->target);
+        _writeBone(constraint->root);
+        _writeBone(constraint->bone);
+        _writeBool(constraint->scaleEnabled);
+        _writeBool(constraint->bendPositive);
+        _writeFloat(constraint->weight);
+    }
+
+    _writeUint(value.sortedSlots.size());
+    for (const auto slot : value.sortedSlots) {
+        _writeString(slot->name);
+        _writeInt((int)slot->blendMode);
+        _writeInt(slot->displayIndex);
+        _writeInt(slot->zOrder);
+        _writeBone(slot->parent);
+
+        const auto hasColor = slot->color != nullptr && slot->color != &SlotData::DEFAULT_COLOR;
+        _writeBool(hasColor);
+        if (hasColor) {
+            _writeFloat(slot->color->alphaMultiplier);
+            _writeFloat(slot->color->redMultiplier);
+            _writeFloat(slot->color->greenMultiplier);
+            _writeFloat(slot->color->blueMultiplier);
+            _writeInt(slot->color->alphaOffset);
+            _writeInt(slot->color->redOffset);
+            _writeInt(slot->color->greenOffset);
+            _writeInt(slot->color->blueOffset);
+        }
+
+        _writeUserData(slot->userData);
+
+        _slotIndices[slot] = (int)_slotIndices.size();
+    }
+
+    int defaultSkin = -1, skinIndex = 0;
+    for (const auto& pair : value.skins) {
+        if (pair.second == value.defaultSkin) {
+            defaultSkin = skinIndex;
+        }
+
+        skinIndex++;
+    }
+
+    _writeInt(defaultSkin);
+    _writeUint(value.skins.size());
+    for (const auto& pair : value.skins) {
+        const auto skin = pair.second;
+        _writeString(skin->name);
+        _writeUint(skin->displays.size());
+        for (const auto& displays : skin->displays) {
+            _writeString(displays.first);
+            _writeUint(displays.second.size());
+            for (const auto display : displays.second) {
+                _writeDisplay(display);
+            }
+        }
+    }
+
+    // In name order, the order animationNames reports to scripts.
+    const auto defaultAnimation = value.defaultAnimation != nullptr ? indexOf(value.animationNames, value.defaultAnimation->name) : -1;
+    _writeInt(defaultAnimation);
+    _writeUint(value.animationNames.size());
+    for (const auto& animationName : value.animationNames) {
+        _writeAnimation(*value.getAnimation(animationName));
+    }
+
+    _writeActions(value.defaultActions);
+    _writeActions(value.actions);
+}
+
+void FlatDataWriter::write(const DragonBonesData& data, std::vector<char>& result) {
+    _strings.clear();
+    _stringIndices.clear();
+
+    const auto start = result.size();
+    result.resize(start + sizeof(FlatDataHeader), 0);
+
+    FlatDataHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, FlatDataParser::MAGIC, sizeof(header.magic));
+    header.formatVersion = FlatDataParser::FORMAT_VERSION;
+    header.name = _addString(data.name);
+    header.version = _addString(data.version);
+    header.frameRate = data.frameRate;
+
+    std::vector<uint32_t> armatureTable;
+    for (const auto& armatureName : data.armatureNames) {
+        _words.clear();
+        _writeArmature(*data.getArmature(armatureName));
+
+        armatureTable.push_back(append(result, _words.data(), _words.size() * sizeof(uint32_t)) - start);
+        armatureTable.push_back(_words.size() * sizeof(uint32_t));
+    }
+
+    header.armatureCount = data.armatureNames.size();
+    header.armatureTable = append(result, armatureTable.data(), armatureTable.size() * sizeof(uint32_t)) - start;
+
+    std::vector<uint32_t> stringTable;
+    std::vector<char> stringPool;
+    for (const auto& value : _strings) {
+        stringTable.push_back(stringPool.size());
+        stringTable.push_back(value.size());
+        stringPool.insert(stringPool.end(), value.begin(), value.end());
+    }
+
+    const auto stringPoolOffset = append(result, stringPool.data(), stringPool.size()) - start;
+    for (std::size_t i = 0; i < stringTable.size(); i += 2) {
+        stringTable[i] += stringPoolOffset;
+    }
+
+    header.stringCount = _strings.size();
+    header.stringTable = append(result, stringTable.data(), stringTable.size() * sizeof(uint32_t)) - start;
+
+    const void* arrays[] = {data.intArray, data.floatArray, data.frameIntArray, data.frameFloatArray, data.frameArray, data.timelineArray};
+    for (std::size_t i = 0; i < FlatDataHeader::FrameIndices; ++i) {
+        const auto length = arrays[i] != nullptr ? data.arrayLengths[i] : 0;
+        header.arrays[i][0] = append(result, arrays[i], length) - start;
+        header.arrays[i][1] = length;
+    }
+
+    std::vector<uint32_t> frameIndices(data.frameIndices.cbegin(), data.frameIndices.cend());
+    header.arrays[FlatDataHeader::FrameIndices][0] = append(result, frameIndices.data(), frameIndices.size() * sizeof(uint32_t)) - start;
+    header.arrays[FlatDataHeader::FrameIndices][1] = frameIndices.size() * sizeof(uint32_t);
+
+    alignTo(result, 8);
+    header.size = result.size() - start;
+    memcpy(result.data() + start, &header, sizeof(header));
+
+    _words.clear();
+    _strings.clear();
+    _stringIndices.clear();
+    _boneIndices.clear();
+    _slotIndices.clear();
+}
+
+DRAGONBONES_NAMESPACE_END
@@ -0,0 +1,76 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2012-2018 DragonBones team and other contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef DRAGONBONES_FLAT_DATA_WRITER_H
+#define DRAGONBONES_FLAT_DATA_WRITER_H
+
+#include "FlatDataParser.h"
+
+DRAGONBONES_NAMESPACE_BEGIN
+
+/**
+ * @internal
+ * Writes parsed DragonBonesData, e.g. from JSONDataParser, in the layout read by FlatDataParser.
+ */
+class FlatDataWriter {
+    DRAGONBONES_DISALLOW_COPY_AND_ASSIGN(FlatDataWriter)
+
+private:
+    std::vector<uint32_t> _words;
+    std::vector<std::string> _strings;
+    std::map<std::string, uint32_t> _stringIndices;
+    std::map<const BoneData*, int> _boneIndices;
+    std::map<const SlotData*, int> _slotIndices;
+    float _scale;
+
+    void _writeUint(uint32_t value);
+    void _writeInt(int value);
+    void _writeFloat(float value);
+    void _writeBool(bool value);
+    uint32_t _addString(const std::string& value);
+    void _writeString(const std::string& value);
+    void _writeBone(const BoneData* value);
+    void _writeSlot(const SlotData* value);
+
+    void _writeTransform(const Transform& value, float scale);
+    void _writeRectangle(const Rectangle& value, float scale);
+    void _writeUserData(const UserData* value);
+    void _writeActions(const std::vector<ActionData*>& value);
+    void _writeTimeline(const TimelineData* value);
+    void _writeTimelines(const std::map<std::string, std::vector<TimelineData*>>& value);
+    void _writeDisplay(const DisplayData* value);
+    void _writeArmature(const ArmatureData& value);
+    void _writeAnimation(const AnimationData& value);
+
+public:
+    FlatDataWriter() : _scale(1.0f) {}
+    ~FlatDataWriter() {}
+
+    /**
+     * Appends the flat data file of data to result.
+     * Positions are written at scale 1, divided by the scale the data was parsed with.
+     */
+    void write(const DragonBonesData& data, std::vector<char>& result);
+};
+
+DRAGONBONES_NAMESPACE_END
+#endif // DRAGONBONES_FLAT_DATA_WRITER_H
@@ -1638,6 +1638,12 @@ DragonBonesData *JSONDataParser::_parseDragonBonesData(const rapidjson::Value &r
                 data->frameFloatArray = frameFloatArray;
                 data->frameArray = frameArray;
                 data->timelineArray = timelineArray;
+                data->arrayLengths[0] = l1;
+                data->arrayLengths[1] = l2;
+                data->arrayLengths[2] = l3;
+                data->arrayLengths[3] = l4;
+                data->arrayLengths[4] = l5;
+                data->arrayLengths[5] = l6;
             }
 
             _defaultColorOffset = -1;
@@ -127,10 +127,25 @@ void SkeletonAnimation::update(float deltaTime) {
         if (_ownsSkeleton) _skeleton->update(deltaTime);
         _state->update(deltaTime);
         _state->apply(*_skeleton);
-        _skeleton->updateWorldTransform();
+        // listeners fire from the animation state, only the world transform is left to a job worker
+        auto *mgr = cc::middleware::MiddlewareManager::getInstance();
+        if (mgr->isUpdating && mgr->isParallelEnabled()) {
+            _worldTransformPending = true;
+        } else {
+            _skeleton->updateWorldTransform();
+        }
     }
 }
 
+bool SkeletonAnimation::beginParallelUpdate() {
+    return _worldTransformPending;
+}
+
+void SkeletonAnimation::updateParallel() {
+    _worldTransformPending = false;
+    _skeleton->updateWorldTransform();
+}
+
 void SkeletonAnimation::setAnimationStateData(AnimationStateData *stateData) {
     CC_ASSERT(stateData);
 
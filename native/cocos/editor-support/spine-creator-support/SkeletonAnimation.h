@@ -51,6 +51,8 @@ public:
     static void setGlobalTimeScale(float timeScale);
 
     virtual void update(float deltaTime) override;
+    bool beginParallelUpdate() override;
+    void updateParallel() override;
 
     void setAnimationStateData(AnimationStateData *stateData);
     void setMix(const std::string &fromAnimation, const std::string &toAnimation, float duration);
@@ -100,6 +102,7 @@ protected:
     DisposeListener _disposeListener = nullptr;
     CompleteListener _completeListener = nullptr;
     EventListener _eventListener = nullptr;
+    bool _worldTransformPending = false;
 
 private:
     typedef SkeletonRenderer super;
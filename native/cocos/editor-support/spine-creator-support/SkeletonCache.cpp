@@ -28,6 +28,9 @@
  *****************************************************************************/
 
 #include "SkeletonCache.h"
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
 #include "base/memory/Memory.h"
 #include "spine-creator-support/AttachmentVertices.h"
 
@@ -39,78 +42,71 @@ namespace spine {
 float SkeletonCache::FrameTime = 1.0F / 60.0F;
 float SkeletonCache::MaxCacheTime = 120.0F;
 
-SkeletonCache::SegmentData::SegmentData() = default;
+namespace {
+// quantized positions stay within int32 with room for the deltas between them
+constexpr float POSITION_LIMIT = 16777216.0F;
 
-SkeletonCache::SegmentData::~SegmentData() {
-    CC_SAFE_RELEASE_NULL(_texture);
+uint32_t quantize(float value, float scale, float minValue, float maxValue) {
+    return static_cast<uint32_t>(static_cast<int32_t>(std::lround(std::min(std::max(value, minValue), maxValue) * scale)));
 }
 
-void SkeletonCache::SegmentData::setTexture(cc::middleware::Texture2D *value) {
-    CC_SAFE_ADD_REF(value);
-    CC_SAFE_RELEASE(_texture);
-    _texture = value;
+float dequantize(uint32_t value, float scale) {
+    return static_cast<float>(static_cast<int32_t>(value)) / scale;
 }
 
-cc::middleware::Texture2D *SkeletonCache::SegmentData::getTexture() const {
-    return _texture;
-}
-
-SkeletonCache::FrameData::FrameData() = default;
-
-SkeletonCache::FrameData::~FrameData() {
-    for (auto &bone : _bones) {
-        delete bone;
-    }
-    _bones.clear();
-
-    for (auto &color : _colors) {
-        delete color;
-    }
-    _colors.clear();
-
-    for (auto &segment : _segments) {
-        delete segment;
+// Deltas are wrapping uint32 differences, zigzag mapped so small negative steps stay short.
+void writeVarint(std::vector<uint8_t> &out, uint32_t delta) {
+    uint32_t value = (delta << 1U) ^ static_cast<uint32_t>(static_cast<int32_t>(delta) >> 31);
+    while (value >= 0x80U) {
+        out.push_back(static_cast<uint8_t>(value | 0x80U));
+        value >>= 7U;
     }
-    _segments.clear();
+    out.push_back(static_cast<uint8_t>(value));
 }
 
-SkeletonCache::BoneData *SkeletonCache::FrameData::buildBoneData(std::size_t index) {
-    if (index > _bones.size()) return nullptr;
-    if (index == _bones.size()) {
-        auto *boneData = new BoneData;
-        _bones.push_back(boneData);
-    }
-    return _bones[index];
-}
-
-std::size_t SkeletonCache::FrameData::getBoneCount() const {
-    return _bones.size();
+uint32_t readVarint(const uint8_t *&in) {
+    uint32_t value = 0;
+    uint32_t shift = 0;
+    uint8_t byte = 0;
+    do {
+        byte = *in++;
+        value |= static_cast<uint32_t>(byte & 0x7FU) << shift;
+        shift += 7;
+    } while (byte & 0x80U);
+    return (value >> 1U) ^ (0U - (value & 1U));
 }
 
-SkeletonCache::ColorData *SkeletonCache::FrameData::buildColorData(std::size_t index) {
-    if (index > _colors.size()) return nullptr;
-    if (index == _colors.size()) {
-        auto *colorData = new ColorData;
-        _colors.push_back(colorData);
+template <typename T>
+uint32_t appendRecords(std::vector<uint8_t> &arena, const std::vector<T> &records) {
+    static_assert(std::is_standard_layout<T>::value, "arena records are copied bytewise");
+    auto offset = (arena.size() + alignof(T) - 1) / alignof(T) * alignof(T);
+    arena.resize(offset + records.size() * sizeof(T));
+    if (!records.empty()) {
+        memcpy(arena.data() + offset, records.data(), records.size() * sizeof(T));
     }
-    return _colors[index];
+    return static_cast<uint32_t>(offset);
 }
 
-std::size_t SkeletonCache::FrameData::getColorCount() const {
-    return _colors.size();
-}
-
-SkeletonCache::SegmentData *SkeletonCache::FrameData::buildSegmentData(std::size_t index) {
-    if (index > _segments.size()) return nullptr;
-    if (index == _segments.size()) {
-        auto *segmentData = new SegmentData;
-        _segments.push_back(segmentData);
+// Reuses the stream of the previous frame when it encodes the same values.
+uint32_t appendStream(std::vector<uint8_t> &arena, const std::vector<uint8_t> &stream, uint32_t prevOffset, bool prevComparable) {
+    if (prevComparable && prevOffset + stream.size() <= arena.size() &&
+        memcmp(arena.data() + prevOffset, stream.data(), stream.size()) == 0) {
+        return prevOffset;
     }
-    return _segments[index];
+    auto offset = static_cast<uint32_t>(arena.size());
+    arena.insert(arena.end(), stream.begin(), stream.end());
+    return offset;
 }
-
-std::size_t SkeletonCache::FrameData::getSegmentCount() const {
-    return _segments.size();
+} // namespace
+
+void SkeletonCache::BoneData::toMat4(cc::Mat4 &out) const {
+    out.setIdentity();
+    out.m[0] = a;
+    out.m[1] = c;
+    out.m[4] = b;
+    out.m[5] = d;
+    out.m[12] = worldX;
+    out.m[13] = worldY;
 }
 
 SkeletonCache::AnimationData::AnimationData() = default;
@@ -120,10 +116,14 @@ SkeletonCache::AnimationData::~AnimationData() {
 }
 
 void SkeletonCache::AnimationData::reset() {
-    for (auto &frame : _frames) {
-        delete frame;
+    for (auto *texture : _textures) {
+        CC_SAFE_RELEASE(texture);
     }
+    _textures.clear();
     _frames.clear();
+    _frames.shrink_to_fit();
+    _arena.clear();
+    _arena.shrink_to_fit();
     _isComplete = false;
     _totalTime = 0.0F;
 }
@@ -132,26 +132,139 @@ bool SkeletonCache::AnimationData::needUpdate(int toFrameIdx) const {
     return !_isComplete && _totalTime <= MaxCacheTime && (toFrameIdx == -1 || _frames.size() < toFrameIdx + 1);
 }
 
-SkeletonCache::FrameData *SkeletonCache::AnimationData::buildFrameData(std::size_t frameIdx) {
-    if (frameIdx > _frames.size()) {
+const SkeletonCache::FrameData *SkeletonCache::AnimationData::getFrameData(std::size_t frameIdx) const {
+    if (frameIdx >= _frames.size()) {
         return nullptr;
     }
-    if (frameIdx == _frames.size()) {
-        auto *frameData = new FrameData();
-        _frames.push_back(frameData);
+    return &_frames[frameIdx];
+}
+
+std::size_t SkeletonCache::AnimationData::getFrameCount() const {
+    return _frames.size();
+}
+
+const SkeletonCache::BoneData *SkeletonCache::AnimationData::getBones(const FrameData &frame) const {
+    return reinterpret_cast<const BoneData *>(_arena.data() + frame.boneOffset);
+}
+
+const SkeletonCache::ColorData *SkeletonCache::AnimationData::getColors(const FrameData &frame) const {
+    return reinterpret_cast<const ColorData *>(_arena.data() + frame.colorOffset);
+}
+
+const SkeletonCache::SegmentData *SkeletonCache::AnimationData::getSegments(const FrameData &frame) const {
+    return reinterpret_cast<const SegmentData *>(_arena.data() + frame.segmentOffset);
+}
+
+cc::middleware::Texture2D *SkeletonCache::AnimationData::getTexture(uint16_t textureIndex) const {
+    return textureIndex < _textures.size() ? _textures[textureIndex] : nullptr;
+}
+
+std::size_t SkeletonCache::AnimationData::getMemorySize() const {
+    return _arena.capacity() + _frames.capacity() * sizeof(FrameData) + _textures.capacity() * sizeof(cc::middleware::Texture2D *);
+}
+
+uint16_t SkeletonCache::AnimationData::addTexture(cc::middleware::Texture2D *texture) {
+    auto it = std::find(_textures.begin(), _textures.end(), texture);
+    if (it != _textures.end()) {
+        return static_cast<uint16_t>(it - _textures.begin());
     }
-    return _frames[frameIdx];
+    CC_SAFE_ADD_REF(texture);
+    _textures.push_back(texture);
+    return static_cast<uint16_t>(_textures.size() - 1);
 }
 
-SkeletonCache::FrameData *SkeletonCache::AnimationData::getFrameData(std::size_t frameIdx) const {
-    if (frameIdx >= _frames.size()) {
-        return nullptr;
+void SkeletonCache::AnimationData::appendFrame(const cc::middleware::IOBuffer &vb, const cc::middleware::IOBuffer &ib,
+                                               const std::vector<BoneData> &bones, const std::vector<ColorData> &colors,
+                                               const std::vector<SegmentData> &segments) {
+    const auto *verts = reinterpret_cast<const V3F_T2F_C4B_C4B *>(vb.getBuffer());
+    const auto *indices = reinterpret_cast<const uint16_t *>(ib.getBuffer());
+    FrameData frame;
+    frame.boneCount = static_cast<uint32_t>(bones.size());
+    frame.colorCount = static_cast<uint32_t>(colors.size());
+    frame.segmentCount = static_cast<uint32_t>(segments.size());
+    frame.vertexCount = static_cast<uint32_t>(vb.getCurPos() / sizeof(V3F_T2F_C4B_C4B));
+    frame.indexCount = static_cast<uint32_t>(ib.getCurPos() / sizeof(uint16_t));
+    frame.boneOffset = appendRecords(_arena, bones);
+    frame.colorOffset = appendRecords(_arena, colors);
+    frame.segmentOffset = appendRecords(_arena, segments);
+
+    frame.positionOffset = static_cast<uint32_t>(_arena.size());
+    uint32_t prevX = 0;
+    uint32_t prevY = 0;
+    for (uint32_t i = 0; i < frame.vertexCount; ++i) {
+        auto x = quantize(verts[i].vertex.x, PositionScale, -POSITION_LIMIT, POSITION_LIMIT);
+        auto y = quantize(verts[i].vertex.y, PositionScale, -POSITION_LIMIT, POSITION_LIMIT);
+        writeVarint(_arena, x - prevX);
+        writeVarint(_arena, y - prevY);
+        prevX = x;
+        prevY = y;
     }
-    return _frames[frameIdx];
+
+    // texture coordinates and indices only change with attachments or clipping,
+    // so most frames point back at the streams of the frame before them
+    const FrameData *prevFrame = _frames.empty() ? nullptr : &_frames.back();
+    std::vector<uint8_t> stream;
+    stream.reserve(frame.vertexCount * 2);
+    uint32_t prevU = 0;
+    uint32_t prevV = 0;
+    for (uint32_t i = 0; i < frame.vertexCount; ++i) {
+        auto u = quantize(verts[i].texCoord.u, UVScale, 0.0F, 1.0F);
+        auto v = quantize(verts[i].texCoord.v, UVScale, 0.0F, 1.0F);
+        writeVarint(stream, u - prevU);
+        writeVarint(stream, v - prevV);
+        prevU = u;
+        prevV = v;
+    }
+    frame.uvOffset = appendStream(_arena, stream, prevFrame ? prevFrame->uvOffset : 0,
+                                  prevFrame && prevFrame->vertexCount == frame.vertexCount);
+
+    stream.clear();
+    uint32_t prevIndex = 0;
+    for (uint32_t i = 0; i < frame.indexCount; ++i) {
+        writeVarint(stream, indices[i] - prevIndex);
+        prevIndex = indices[i];
+    }
+    frame.indexOffset = appendStream(_arena, stream, prevFrame ? prevFrame->indexOffset : 0,
+                                     prevFrame && prevFrame->indexCount == frame.indexCount);
+
+    _frames.push_back(frame);
 }
 
-std::size_t SkeletonCache::AnimationData::getFrameCount() const {
-    return _frames.size();
+SkeletonCache::FrameReader::FrameReader(const AnimationData &animationData, const FrameData &frame)
+: _color(animationData.getColors(frame)),
+  _position(animationData._arena.data() + frame.positionOffset),
+  _uv(animationData._arena.data() + frame.uvOffset),
+  _index(animationData._arena.data() + frame.indexOffset) {
+}
+
+void SkeletonCache::FrameReader::readVertices(uint32_t count, uint8_t *dst, std::size_t stride, bool tint) {
+    for (uint32_t i = 0; i < count; ++i, ++_vertex, dst += stride) {
+        while (_vertex >= _color->vertexEnd) {
+            ++_color;
+        }
+        _x += readVarint(_position);
+        _y += readVarint(_position);
+        _u += readVarint(_uv);
+        _v += readVarint(_uv);
+
+        auto *vertex = reinterpret_cast<V3F_T2F_C4B *>(dst);
+        vertex->vertex.x = dequantize(_x, PositionScale);
+        vertex->vertex.y = dequantize(_y, PositionScale);
+        vertex->vertex.z = 0.0F;
+        vertex->texCoord.u = dequantize(_u, UVScale);
+        vertex->texCoord.v = dequantize(_v, UVScale);
+        vertex->color = _color->finalColor;
+        if (tint) {
+            reinterpret_cast<V3F_T2F_C4B_C4B *>(dst)->color2 = _color->darkColor;
+        }
+    }
+}
+
+void SkeletonCache::FrameReader::readIndices(uint32_t count, uint16_t *dst, uint32_t vertexOffset) {
+    for (uint32_t i = 0; i < count; ++i) {
+        _lastIndex += readVarint(_index);
+        dst[i] = static_cast<uint16_t>(_lastIndex + vertexOffset);
+    }
 }
 
 SkeletonCache::SkeletonCache() = default;
@@ -221,16 +334,26 @@ void SkeletonCache::updateToFrame(const std::string &animationName, int toFrameI
         renderAnimationFrame(animationData);
         animationData->_totalTime += FrameTime;
     } while (animationData->needUpdate(toFrameIdx));
+
+    if (animationData->_isComplete) {
+        // baking is over, release the growth slack of the arena
+        animationData->_arena.shrink_to_fit();
+        animationData->_frames.shrink_to_fit();
+    }
 }
 
 void SkeletonCache::renderAnimationFrame(AnimationData *animationData) {
-    std::size_t frameIndex = animationData->getFrameCount();
-    FrameData *frameData = animationData->buildFrameData(frameIndex);
-
-    if (!_skeleton) return;
-
-    // If opacity is 0,then return.
-    if (_skeleton->getColor().a == 0) {
+    middleware::IOBuffer &vb = _bakeVB;
+    middleware::IOBuffer &ib = _bakeIB;
+    vb.reset();
+    ib.reset();
+    _bakeBones.clear();
+    _bakeColors.clear();
+    _bakeSegments.clear();
+
+    // If there is no skeleton or opacity is 0, bake an empty frame.
+    if (!_skeleton || _skeleton->getColor().a == 0) {
+        animationData->appendFrame(vb, ib, _bakeBones, _bakeColors, _bakeSegments);
         return;
     }
 
@@ -243,8 +366,6 @@ void SkeletonCache::renderAnimationFrame(AnimationData *animationData) {
     Color4B finalDardk;
 
     AttachmentVertices *attachmentVertices = nullptr;
-    middleware::IOBuffer &vb = frameData->vb;
-    middleware::IOBuffer &ib = frameData->ib;
 
     // vertex size int bytes with two color
     int vbs2 = sizeof(V3F_T2F_C4B_C4B);
@@ -262,7 +383,6 @@ void SkeletonCache::renderAnimationFrame(AnimationData *animationData) {
     int curISegLen = 0;
     int curVSegLen = 0;
 
-    int materialLen = 0;
     Slot *slot = nullptr;
 
     middleware::Texture2D *texture = nullptr;
@@ -270,14 +390,15 @@ void SkeletonCache::renderAnimationFrame(AnimationData *animationData) {
     auto flush = [&]() {
         // fill pre segment count field
         if (preISegWritePos != -1) {
-            SegmentData *preSegmentData = frameData->buildSegmentData(materialLen - 1);
-            preSegmentData->indexCount = curISegLen;
-            preSegmentData->vertexFloatCount = curVSegLen;
+            SegmentData &preSegmentData = _bakeSegments.back();
+            preSegmentData.indexCount = curISegLen;
+            preSegmentData.vertexCount = curVSegLen / vs2;
         }
 
-        SegmentData *segmentData = frameData->buildSegmentData(materialLen);
-        segmentData->setTexture(texture);
-        segmentData->blendMode = slot->getData().getBlendMode();
+        SegmentData segmentData;
+        segmentData.textureIndex = animationData->addTexture(texture);
+        segmentData.blendMode = static_cast<uint16_t>(slot->getData().getBlendMode());
+        _bakeSegments.push_back(segmentData);
 
         // save new segment count pos field
         preISegWritePos = static_cast<int>(ib.getCurPos() / sizeof(uint16_t));
@@ -289,22 +410,19 @@ void SkeletonCache::renderAnimationFrame(AnimationData *animationData) {
         curISegLen = 0;
         // reset vertex segmentation count
         curVSegLen = 0;
-        // material length increased
-        materialLen++;
     };
 
     auto &bones = _skeleton->getBones();
     for (std::size_t i = 0, n = bones.size(); i < n; i++) {
         auto &bone = bones[i];
-        auto boneCount = frameData->getBoneCount();
-        BoneData *boneData = frameData->buildBoneData(boneCount);
-        auto &matm = boneData->globalTransformMatrix.m;
-        matm[0] = bone->getA();
-        matm[1] = bone->getC();
-        matm[4] = bone->getB();
-        matm[5] = bone->getD();
-        matm[12] = bone->getWorldX();
-        matm[13] = bone->getWorldY();
+        BoneData boneData;
+        boneData.a = bone->getA();
+        boneData.b = bone->getB();
+        boneData.c = bone->getC();
+        boneData.d = bone->getD();
+        boneData.worldX = bone->getWorldX();
+        boneData.worldY = bone->getWorldY();
+        _bakeBones.push_back(boneData);
     }
 
     auto &drawOrder = _skeleton->getDrawOrder();
@@ -423,14 +541,13 @@ void SkeletonCache::renderAnimationFrame(AnimationData *animationData) {
         if (preColor != color || preDarkColor != darkColor) {
             preColor = color;
             preDarkColor = darkColor;
-            auto colorCount = frameData->getColorCount();
-            if (colorCount > 0) {
-                ColorData *preColorData = frameData->buildColorData(colorCount - 1);
-                preColorData->vertexFloatOffset = static_cast<int>(vb.getCurPos() / sizeof(float));
+            if (!_bakeColors.empty()) {
+                _bakeColors.back().vertexEnd = static_cast<uint32_t>(vb.getCurPos() / vbs2);
             }
-            ColorData *colorData = frameData->buildColorData(colorCount);
-            colorData->finalColor = finalColor;
-            colorData->darkColor = finalDardk;
+            ColorData colorData;
+            colorData.finalColor = finalColor;
+            colorData.darkColor = finalDardk;
+            _bakeColors.push_back(colorData);
         }
 
         // Two color tint logic
@@ -503,16 +620,16 @@ void SkeletonCache::renderAnimationFrame(AnimationData *animationData) {
     _clipper->clipEnd();
 
     if (preISegWritePos != -1) {
-        SegmentData *preSegmentData = frameData->buildSegmentData(materialLen - 1);
-        preSegmentData->indexCount = curISegLen;
-        preSegmentData->vertexFloatCount = curVSegLen;
+        SegmentData &preSegmentData = _bakeSegments.back();
+        preSegmentData.indexCount = curISegLen;
+        preSegmentData.vertexCount = curVSegLen / vs2;
     }
 
-    auto colorCount = frameData->getColorCount();
-    if (colorCount > 0) {
-        ColorData *preColorData = frameData->buildColorData(colorCount - 1);
-        preColorData->vertexFloatOffset = static_cast<int>(vb.getCurPos() / sizeof(float));
+    if (!_bakeColors.empty()) {
+        _bakeColors.back().vertexEnd = static_cast<uint32_t>(vb.getCurPos() / vbs2);
     }
+
+    animationData->appendFrame(vb, ib, _bakeBones, _bakeColors, _bakeSegments);
 }
 
 void SkeletonCache::onAnimationStateEvent(TrackEntry *entry, EventType type, Event *event) {
@@ -35,96 +35,117 @@
 #include "middleware-adapter.h"
 
 namespace spine {
+class SkeletonCacheMgr;
+
 class SkeletonCache : public SkeletonAnimation {
 public:
-    struct SegmentData {
-        friend class SkeletonCache;
-
-        SegmentData();
-        ~SegmentData();
+    // Baked positions are quantized to 1/PositionScale units and texture coordinates
+    // to 1/UVScale, then stored as zigzag varint deltas from the previous vertex.
+    static constexpr float PositionScale = 64.0F;
+    static constexpr float UVScale = 65535.0F;
 
-        void setTexture(cc::middleware::Texture2D *value);
-        cc::middleware::Texture2D *getTexture() const;
-
-    public:
-        int indexCount = 0;
-        int vertexFloatCount = 0;
-        int blendMode = 0;
-
-    private:
-        cc::middleware::Texture2D *_texture = nullptr;
+    struct SegmentData {
+        uint32_t indexCount = 0;
+        uint32_t vertexCount = 0;
+        uint16_t textureIndex = 0;
+        uint16_t blendMode = 0;
     };
 
     struct BoneData {
-        cc::Mat4 globalTransformMatrix;
+        float a = 1.0F;
+        float b = 0.0F;
+        float c = 0.0F;
+        float d = 1.0F;
+        float worldX = 0.0F;
+        float worldY = 0.0F;
+
+        void toMat4(cc::Mat4 &out) const;
     };
 
     struct ColorData {
         cc::middleware::Color4B finalColor;
         cc::middleware::Color4B darkColor;
-        int vertexFloatOffset = 0;
+        // index of the first vertex past this color run
+        uint32_t vertexEnd = 0;
     };
 
+    // Byte offsets of one baked frame inside its animation arena.
     struct FrameData {
-        friend class SkeletonCache;
-
-        FrameData();
-        ~FrameData();
-
-        const std::vector<BoneData *> &getBones() const {
-            return _bones;
-        }
-        std::size_t getBoneCount() const;
-
-        const std::vector<ColorData *> &getColors() const {
-            return _colors;
-        }
-        std::size_t getColorCount() const;
-
-        const std::vector<SegmentData *> &getSegments() const {
-            return _segments;
-        }
-        std::size_t getSegmentCount() const;
-
-    private:
-        // if segment data is empty, it will build new one.
-        SegmentData *buildSegmentData(std::size_t index);
-        // if color data is empty, it will build new one.
-        ColorData *buildColorData(std::size_t index);
-        // if bone data is empty, it will build new one.
-        BoneData *buildBoneData(std::size_t index);
-
-        std::vector<BoneData *> _bones;
-        std::vector<ColorData *> _colors;
-        std::vector<SegmentData *> _segments;
-
-    public:
-        cc::middleware::IOBuffer ib;
-        cc::middleware::IOBuffer vb;
+        uint32_t boneOffset = 0;
+        uint32_t colorOffset = 0;
+        uint32_t segmentOffset = 0;
+        uint32_t positionOffset = 0;
+        uint32_t uvOffset = 0;
+        uint32_t indexOffset = 0;
+        uint32_t boneCount = 0;
+        uint32_t colorCount = 0;
+        uint32_t segmentCount = 0;
+        uint32_t vertexCount = 0;
+        uint32_t indexCount = 0;
     };
 
     struct AnimationData {
         friend class SkeletonCache;
+        friend class SkeletonCacheMgr;
 
         AnimationData();
         ~AnimationData();
         void reset();
 
-        FrameData *getFrameData(std::size_t frameIdx) const;
+        const FrameData *getFrameData(std::size_t frameIdx) const;
         std::size_t getFrameCount() const;
 
+        const BoneData *getBones(const FrameData &frame) const;
+        const ColorData *getColors(const FrameData &frame) const;
+        const SegmentData *getSegments(const FrameData &frame) const;
+        cc::middleware::Texture2D *getTexture(uint16_t textureIndex) const;
+
+        // bytes held by the baked frames
+        std::size_t getMemorySize() const;
+
         bool isComplete() const { return _isComplete; }
         bool needUpdate(int toFrameIdx) const;
 
-    private:
-        // if frame is empty, it will build new one.
-        FrameData *buildFrameData(std::size_t frameIdx);
+        // Called while baking. Returns the index segments refer to the texture by.
+        uint16_t addTexture(cc::middleware::Texture2D *texture);
+        // Encodes one frame baked in V3F_T2F_C4B_C4B layout, with indices relative to their segment.
+        void appendFrame(const cc::middleware::IOBuffer &vb, const cc::middleware::IOBuffer &ib,
+                         const std::vector<BoneData> &bones, const std::vector<ColorData> &colors,
+                         const std::vector<SegmentData> &segments);
 
     private:
         std::string _animationName = "";
         bool _isComplete = false;
         float _totalTime = 0.0f;
-        std::vector<FrameData *> _frames;
+        uint64_t _lastUsed = 0;
+        std::vector<FrameData> _frames;
+        // bones, colors, segments and the vertex streams of every frame
+        std::vector<uint8_t> _arena;
+        std::vector<cc::middleware::Texture2D *> _textures;
+    };
+
+    // Decodes the streams of one frame, segment by segment in baking order.
+    class FrameReader {
+    public:
+        FrameReader(const AnimationData &animationData, const FrameData &frame);
+
+        // Writes position, texture coordinate and baked colors of the next count vertices,
+        // stride bytes apart, in V3F_T2F_C4B or, with tint, V3F_T2F_C4B_C4B layout.
+        void readVertices(uint32_t count, uint8_t *dst, std::size_t stride, bool tint);
+        // Writes the next count indices rebased by vertexOffset.
+        void readIndices(uint32_t count, uint16_t *dst, uint32_t vertexOffset);
+
+    private:
+        const ColorData *_color = nullptr;
+        const uint8_t *_position = nullptr;
+        const uint8_t *_uv = nullptr;
+        const uint8_t *_index = nullptr;
+        uint32_t _vertex = 0;
+        uint32_t _x = 0;
+        uint32_t _y = 0;
+        uint32_t _u = 0;
+        uint32_t _v = 0;
+        uint32_t _lastIndex = 0;
     };
 
     SkeletonCache();
@@ -144,6 +165,8 @@ public:
     void resetAnimationData(const std::string &animationName);
 
 private:
+    friend class SkeletonCacheMgr;
+
     void renderAnimationFrame(AnimationData *animationData);
 
 public:
@@ -153,5 +176,12 @@ public:
 private:
     std::string _curAnimationName = "";
     std::map<std::string, AnimationData *> _animationCaches;
+
+    // scratch for the frame being baked before it is encoded into the arena
+    cc::middleware::IOBuffer _bakeVB;
+    cc::middleware::IOBuffer _bakeIB;
+    std::vector<BoneData> _bakeBones;
+    std::vector<ColorData> _bakeColors;
+    std::vector<SegmentData> _bakeSegments;
 };
 } // namespace spine
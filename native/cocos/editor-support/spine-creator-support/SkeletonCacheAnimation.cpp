@@ -50,6 +50,7 @@ namespace spine {
 
 SkeletonCacheAnimation::SkeletonCacheAnimation(const std::string &uuid, bool isShare) {
     if (isShare) {
+        _uuid = uuid;
         _skeletonCache = SkeletonCacheMgr::getInstance()->buildSkeletonCache(uuid);
         _skeletonCache->addRef();
     } else {
@@ -96,7 +97,7 @@ void SkeletonCacheAnimation::update(float dt) {
     if (_isAniComplete) {
         if (_animationQueue.empty() && !_headAnimation) {
             if (_animationData && !_animationData->isComplete()) {
-                _skeletonCache->updateToFrame(_animationName);
+                updateToFrame();
             }
             return;
         }
@@ -129,7 +130,7 @@ void SkeletonCacheAnimation::update(float dt) {
     _accTime += dt;
     int frameIdx = floor(_accTime / SkeletonCache::FrameTime);
     if (!_animationData->isComplete()) {
-        _skeletonCache->updateToFrame(_animationName, frameIdx);
+        updateToFrame(frameIdx);
     }
 
     int finalFrameIndex = static_cast<int>(_animationData->getFrameCount()) - 1;
@@ -153,16 +154,26 @@ void SkeletonCacheAnimation::update(float dt) {
     _curFrameIndex = frameIdx;
 }
 
+void SkeletonCacheAnimation::updateToFrame(int toFrameIdx) {
+    _skeletonCache->updateToFrame(_animationName, toFrameIdx);
+    if (!_uuid.empty()) {
+        SkeletonCacheMgr::getInstance()->markBaked();
+    }
+}
+
 void SkeletonCacheAnimation::render(float /*dt*/) {
-    if (!_animationData) return;
-    SkeletonCache::FrameData *frameData = _animationData->getFrameData(_curFrameIndex);
-    if (!frameData) return;
     auto *entity = _entity;
     entity->clearDynamicRenderDrawInfos();
 
-    const auto &segments = frameData->getSegments();
-    const auto &colors = frameData->getColors();
-    if (segments.empty() || colors.empty()) return;
+    if (!_animationData) return;
+    SkeletonCacheMgr::getInstance()->markUsed(_animationData);
+    const SkeletonCache::FrameData *frameData = _animationData->getFrameData(_curFrameIndex);
+    if (!frameData) return;
+
+    if (frameData->segmentCount == 0 || frameData->colorCount == 0) return;
+    const SkeletonCache::SegmentData *segments = _animationData->getSegments(*frameData);
+    const SkeletonCache::ColorData *colors = _animationData->getColors(*frameData);
+    SkeletonCache::FrameReader reader(*_animationData, *frameData);
 
     auto *mgr = MiddlewareManager::getInstance();
     if (!mgr->isRendering) return;
@@ -181,8 +192,6 @@ void SkeletonCacheAnimation::render(float /*dt*/) {
     middleware::MeshBuffer *mb = mgr->getMeshBuffer(vertexFormat);
     middleware::IOBuffer &vb = mb->getVB();
     middleware::IOBuffer &ib = mb->getIB();
-    const auto &srcVB = frameData->vb;
-    const auto &srcIB = frameData->ib;
 
     // vertex size int bytes with one color
     int vbs1 = sizeof(V3F_T2F_C4B);
@@ -198,9 +207,8 @@ void SkeletonCacheAnimation::render(float /*dt*/) {
 
     auto &nodeWorldMat = entity->getNode()->getWorldMatrix();
 
-    int colorOffset = 0;
-    SkeletonCache::ColorData *nowColor = colors[colorOffset++];
-    auto maxVFOffset = nowColor->vertexFloatOffset;
+    const SkeletonCache::ColorData *nowColor = colors;
+    auto maxVertexEnd = nowColor->vertexEnd;
 
     Color4B finalColor;
     Color4B darkColor;
@@ -209,12 +217,9 @@ void SkeletonCacheAnimation::render(float /*dt*/) {
     float tempB = 0.0F;
     float tempA = 0.0F;
     float multiplier = 1.0F;
-    int srcVertexBytesOffset = 0;
-    int srcVertexBytes = 0;
+    uint32_t srcVertexOffset = 0;
     int vertexBytes = 0;
     int vertexFloats = 0;
-    int tintBytes = 0;
-    int srcIndexBytesOffset = 0;
     int indexBytes = 0;
     double effectHash = 0;
     int blendMode = 0;
@@ -237,7 +242,7 @@ void SkeletonCacheAnimation::render(float /*dt*/) {
         needColor = true;
     }
 
-    auto handleColor = [&](SkeletonCache::ColorData *colorData) {
+    auto handleColor = [&](const SkeletonCache::ColorData *colorData) {
         tempA = colorData->finalColor.a * _nodeColor.a;
         multiplier = _premultipliedAlpha ? tempA / 255 : 1;
         tempR = _nodeColor.r * multiplier;
@@ -257,20 +262,13 @@ void SkeletonCacheAnimation::render(float /*dt*/) {
 
     handleColor(nowColor);
     int segmentCount = 0;
-    for (auto *segment : segments) {
-        srcVertexBytes = static_cast<int32_t>(segment->vertexFloatCount * sizeof(float));
-        if (!_useTint) {
-            tintBytes = static_cast<int32_t>(segment->vertexFloatCount / vs2 * sizeof(float));
-            vertexBytes = srcVertexBytes - tintBytes;
-            vertexFloats = static_cast<int32_t>(vertexBytes / sizeof(float));
-        } else {
-            vertexBytes = srcVertexBytes;
-            vertexFloats = segment->vertexFloatCount;
-        }
+    for (const auto *segment = segments, *segmentEnd = segments + frameData->segmentCount; segment != segmentEnd; ++segment) {
+        vertexBytes = static_cast<int32_t>(segment->vertexCount * vbs);
+        vertexFloats = static_cast<int32_t>(segment->vertexCount * vs);
         curDrawInfo = requestDrawInfo(segmentCount++);
         entity->addDynamicRenderDrawInfo(curDrawInfo);
         // fill new texture index
-        curTexture = static_cast<cc::Texture2D *>(segment->getTexture()->getRealTexture());
+        curTexture = static_cast<cc::Texture2D *>(_animationData->getTexture(segment->textureIndex)->getRealTexture());
         gfx::Texture *texture = curTexture->getGFXTexture();
         gfx::Sampler *sampler = curTexture->getGFXSampler();
         curDrawInfo->setTexture(texture);
@@ -303,14 +301,8 @@ void SkeletonCacheAnimation::render(float /*dt*/) {
         dstVertexOffset = static_cast<int>(vb.getCurPos()) / vbs;
         dstVertexBuffer = reinterpret_cast<float *>(vb.getCurBuffer());
         dstColorBuffer = reinterpret_cast<unsigned int *>(vb.getCurBuffer());
-        if (!_useTint) {
-            char *srcBuffer = reinterpret_cast<char *>(srcVB.getBuffer()) + srcVertexBytesOffset;
-            for (std::size_t srcBufferIdx = 0; srcBufferIdx < srcVertexBytes; srcBufferIdx += vbs2) {
-                vb.writeBytes(srcBuffer + srcBufferIdx, vbs);
-            }
-        } else {
-            vb.writeBytes(reinterpret_cast<char *>(srcVB.getBuffer()) + srcVertexBytesOffset, vertexBytes);
-        }
+        reader.readVertices(segment->vertexCount, vb.getCurBuffer(), vbs, _useTint);
+        vb.move(vertexBytes);
         // batch handle
         if (_enableBatch) {
             cc::Vec3 *point = nullptr;
@@ -322,42 +314,39 @@ void SkeletonCacheAnimation::render(float /*dt*/) {
         }
         // handle vertex color
         if (needColor) {
-            int srcVertexFloatOffset = static_cast<int16_t>(srcVertexBytesOffset / sizeof(float));
+            uint32_t srcVertex = srcVertexOffset;
             if (_useTint) {
-                for (auto colorIndex = 0; colorIndex < vertexFloats; colorIndex += vs, srcVertexFloatOffset += vs2) {
-                    if (srcVertexFloatOffset >= maxVFOffset) {
-                        nowColor = colors[colorOffset++];
+                for (auto colorIndex = 0; colorIndex < vertexFloats; colorIndex += vs, srcVertex++) {
+                    while (srcVertex >= maxVertexEnd) {
+                        nowColor++;
                         handleColor(nowColor);
-                        maxVFOffset = nowColor->vertexFloatOffset;
+                        maxVertexEnd = nowColor->vertexEnd;
                     }
                     memcpy(dstColorBuffer + colorIndex + 5, &finalColor, sizeof(finalColor));
                     memcpy(dstColorBuffer + colorIndex + 6, &darkColor, sizeof(darkColor));
                 }
             } else {
-                for (auto colorIndex = 0; colorIndex < vertexFloats; colorIndex += vs, srcVertexFloatOffset += vs2) {
-                    if (srcVertexFloatOffset >= maxVFOffset) {
-                        nowColor = colors[colorOffset++];
+                for (auto colorIndex = 0; colorIndex < vertexFloats; colorIndex += vs, srcVertex++) {
+                    while (srcVertex >= maxVertexEnd) {
+                        nowColor++;
                         handleColor(nowColor);
-                        maxVFOffset = nowColor->vertexFloatOffset;
+                        maxVertexEnd = nowColor->vertexEnd;
                     }
                     memcpy(dstColorBuffer + colorIndex + 5, &finalColor, sizeof(finalColor));
                 }
             }
         }
 
-        // move src vertex buffer offset
-        srcVertexBytesOffset += srcVertexBytes;
+        // move src vertex offset
+        srcVertexOffset += segment->vertexCount;
 
         // fill index buffer
         indexBytes = static_cast<int32_t>(segment->indexCount * sizeof(uint16_t));
         ib.checkSpace(indexBytes, true);
         dstIndexOffset = static_cast<int32_t>(ib.getCurPos() / sizeof(uint16_t));
         dstIndexBuffer = reinterpret_cast<uint16_t *>(ib.getCurBuffer());
-        ib.writeBytes(reinterpret_cast<char *>(srcIB.getBuffer()) + srcIndexBytesOffset, indexBytes);
-        for (auto indexPos = 0; indexPos < segment->indexCount; indexPos++) {
-            dstIndexBuffer[indexPos] += dstVertexOffset;
-        }
-        srcIndexBytesOffset += indexBytes;
+        reader.readIndices(segment->indexCount, dstIndexBuffer, dstVertexOffset);
+        ib.move(indexBytes);
 
         // fill new index and vertex buffer id
         UIMeshBuffer *uiMeshBuffer = mb->getUIMeshBuffer();
@@ -370,13 +359,13 @@ void SkeletonCacheAnimation::render(float /*dt*/) {
     }
 
     if (_useAttach) {
-        const auto &bonesData = frameData->getBones();
-        auto boneCount = frameData->getBoneCount();
+        const SkeletonCache::BoneData *bonesData = _animationData->getBones(*frameData);
+        cc::Mat4 boneMat;
 
-        for (std::size_t i = 0, n = boneCount; i < n; i++) {
-            auto *bone = bonesData[i];
+        for (std::size_t i = 0, n = frameData->boneCount; i < n; i++) {
+            bonesData[i].toMat4(boneMat);
             attachInfo->checkSpace(sizeof(cc::Mat4), true);
-            attachInfo->writeBytes(reinterpret_cast<const char *>(&bone->globalTransformMatrix), sizeof(cc::Mat4));
+            attachInfo->writeBytes(reinterpret_cast<const char *>(&boneMat), sizeof(cc::Mat4));
         }
     }
 }
@@ -406,13 +395,22 @@ Slot *SkeletonCacheAnimation::findSlot(const std::string &slotName) const {
 }
 
 void SkeletonCacheAnimation::setSkin(const std::string &skinName) {
-    _skeletonCache->setSkin(skinName);
-    _skeletonCache->resetAllAnimationData();
+    if (_uuid.empty()) {
+        _skeletonCache->setSkin(skinName);
+        _skeletonCache->resetAllAnimationData();
+        return;
+    }
+    // a shared cache keeps its skin, move over to the one baked with the new skin
+    auto *skeletonCache = SkeletonCacheMgr::getInstance()->buildSkeletonCache(_uuid, skinName);
+    if (skeletonCache == _skeletonCache) return;
+    skeletonCache->addRef();
+    _skeletonCache->release();
+    _skeletonCache = skeletonCache;
+    _animationData = _animationName.empty() ? nullptr : _skeletonCache->buildAnimationData(_animationName);
 }
 
 void SkeletonCacheAnimation::setSkin(const char *skinName) {
-    _skeletonCache->setSkin(skinName);
-    _skeletonCache->resetAllAnimationData();
+    setSkin(skinName ? std::string(skinName) : std::string());
 }
 
 Attachment *SkeletonCacheAnimation::getAttachment(const std::string &slotName, const std::string &attachmentName) const {
@@ -106,6 +106,8 @@ public:
     void setMaterial(cc::Material *material);
     void setRenderEntity(cc::RenderEntity* entity);
 private:
+    void updateToFrame(int toFrameIdx = -1);
+
     float _timeScale = 1;
     bool _paused = false;
     bool _useAttach = false;
@@ -116,6 +118,8 @@ private:
     CacheFrameEvent _endListener = nullptr;
     CacheFrameEvent _completeListener = nullptr;
 
+    // skeleton data of the shared cache, empty when the cache is private
+    std::string _uuid;
     SkeletonCache *_skeletonCache = nullptr;
     SkeletonCache::AnimationData *_animationData = nullptr;
     int _curFrameIndex = -1;
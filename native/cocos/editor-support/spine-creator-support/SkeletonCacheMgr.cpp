@@ -28,26 +28,121 @@
  *****************************************************************************/
 
 #include "SkeletonCacheMgr.h"
+#include <algorithm>
 #include "base/DeferredReleasePool.h"
 
 namespace spine {
 SkeletonCacheMgr *SkeletonCacheMgr::instance = nullptr;
-SkeletonCache *SkeletonCacheMgr::buildSkeletonCache(const std::string &uuid) {
-    SkeletonCache *animation = _caches.at(uuid);
+SkeletonCache *SkeletonCacheMgr::buildSkeletonCache(const std::string &uuid, const std::string &skinName) {
+    const std::string key = skinName.empty() ? uuid : uuid + '#' + skinName;
+    SkeletonCache *animation = _caches.at(key);
     if (!animation) {
         animation = new SkeletonCache();
         animation->addRef();
         animation->initWithUUID(uuid);
-        _caches.insert(uuid, animation);
+        if (!skinName.empty()) {
+            animation->setSkin(skinName);
+        }
+        _caches.insert(key, animation);
         cc::DeferredReleasePool::add(animation);
     }
     return animation;
 }
 
 void SkeletonCacheMgr::removeSkeletonCache(const std::string &uuid) {
-    auto it = _caches.find(uuid);
-    if (it != _caches.end()) {
-        _caches.erase(it);
+    const std::string skinPrefix = uuid + '#';
+    for (auto it = _caches.begin(); it != _caches.end();) {
+        if (it->first == uuid || it->first.compare(0, skinPrefix.size(), skinPrefix) == 0) {
+            it = _caches.erase(it);
+        } else {
+            ++it;
+        }
     }
 }
+
+SkeletonCacheMgr::~SkeletonCacheMgr() {
+    if (_memoryBudget > 0) {
+        cc::middleware::MiddlewareManager::getInstance()->removeTimer(this);
+    }
+}
+
+void SkeletonCacheMgr::setMemoryBudget(std::size_t bytes) {
+    auto *mgr = cc::middleware::MiddlewareManager::getInstance();
+    if (bytes > 0) {
+        mgr->addTimer(this);
+    } else {
+        mgr->removeTimer(this);
+    }
+    _memoryBudget = bytes;
+    _needTrim = bytes > 0;
+}
+
+std::size_t SkeletonCacheMgr::getMemoryUsage() const {
+    std::size_t usage = 0;
+    for (const auto &cache : _caches) {
+        for (const auto &animationCache : cache.second->_animationCaches) {
+            usage += animationCache.second->getMemorySize();
+        }
+    }
+    return usage;
+}
+
+void SkeletonCacheMgr::markUsed(SkeletonCache::AnimationData *animationData) {
+    if (animationData) {
+        animationData->_lastUsed = _frame;
+    }
+}
+
+std::vector<std::size_t> SkeletonCacheMgr::selectEvictions(const std::vector<CacheUsage> &usages, std::size_t budget, uint64_t frame) {
+    std::size_t usage = 0;
+    std::vector<std::size_t> candidates;
+    for (std::size_t i = 0; i < usages.size(); ++i) {
+        const auto &cacheUsage = usages[i];
+        usage += cacheUsage.size;
+        if (cacheUsage.size > 0 && cacheUsage.complete && cacheUsage.lastUsedFrame + 1 < frame) {
+            candidates.push_back(i);
+        }
+    }
+    if (usage <= budget) return {};
+
+    std::stable_sort(candidates.begin(), candidates.end(), [&usages](std::size_t lhs, std::size_t rhs) {
+        return usages[lhs].lastUsedFrame < usages[rhs].lastUsedFrame;
+    });
+    std::size_t count = 0;
+    while (count < candidates.size() && usage > budget) {
+        usage -= usages[candidates[count++]].size;
+    }
+    candidates.resize(count);
+    return candidates;
+}
+
+void SkeletonCacheMgr::render(float /*dt*/) {
+    if (_needTrim) {
+        trimToBudget();
+    }
+    ++_frame;
+}
+
+void SkeletonCacheMgr::trimToBudget() {
+    std::vector<SkeletonCache::AnimationData *> animations;
+    std::vector<CacheUsage> usages;
+    for (const auto &cache : _caches) {
+        for (const auto &animationCache : cache.second->_animationCaches) {
+            auto *animationData = animationCache.second;
+            animations.push_back(animationData);
+            usages.push_back({animationData->getMemorySize(), animationData->_lastUsed, animationData->isComplete()});
+        }
+    }
+
+    std::size_t usage = 0;
+    for (const auto &cacheUsage : usages) {
+        usage += cacheUsage.size;
+    }
+    for (auto index : selectEvictions(usages, _memoryBudget, _frame)) {
+        usage -= usages[index].size;
+        animations[index]->reset();
+    }
+    // whatever is protected now may be evicted once it is no longer rendered
+    _needTrim = usage > _memoryBudget;
+}
 } // namespace spine
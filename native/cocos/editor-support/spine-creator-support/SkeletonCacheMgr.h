@@ -28,13 +28,21 @@
  *****************************************************************************/
 
 #pragma once
+#include <vector>
+#include "MiddlewareManager.h"
 #include "SkeletonCache.h"
 #include "base/RefMap.h"
 
 namespace spine {
 
-class SkeletonCacheMgr {
+class SkeletonCacheMgr : public cc::middleware::IMiddleware {
 public:
+    struct CacheUsage {
+        std::size_t size = 0;
+        uint64_t lastUsedFrame = 0;
+        bool complete = false;
+    };
+
     static SkeletonCacheMgr *getInstance() {
         if (instance == nullptr) {
             instance = new SkeletonCacheMgr();
@@ -49,12 +57,40 @@ public:
         }
     }
 
+    // Removes the shared caches of every skin built from the skeleton data.
     void removeSkeletonCache(const std::string &uuid);
-    SkeletonCache *buildSkeletonCache(const std::string &uuid);
+    // Caches are shared by skeleton data and skin, an empty skin keeps the default one.
+    SkeletonCache *buildSkeletonCache(const std::string &uuid, const std::string &skinName = "");
+
+    // Caps the bytes of baked frames held by shared caches, 0 means no limit.
+    // Once per frame after rendering, the least recently rendered animations are evicted
+    // and rebaked on demand.
+    void setMemoryBudget(std::size_t bytes);
+    std::size_t getMemoryBudget() const { return _memoryBudget; }
+    std::size_t getMemoryUsage() const;
+
+    void markUsed(SkeletonCache::AnimationData *animationData);
+    // Baking grew the usage, the budget is checked after this frame has rendered.
+    void markBaked() { _needTrim = _memoryBudget > 0; }
+
+    // Indices of the usages to evict until the rest fits the budget, least recently used first.
+    // Animations used in the given or the previous frame and unfinished bakes are never picked.
+    static std::vector<std::size_t> selectEvictions(const std::vector<CacheUsage> &usages, std::size_t budget, uint64_t frame);
+
+    void update(float /*dt*/) override {}
+    void render(float dt) override;
 
 private:
+    SkeletonCacheMgr() = default;
+    ~SkeletonCacheMgr() override;
+
+    void trimToBudget();
+
     static SkeletonCacheMgr *instance;
     cc::RefMap<std::string, SkeletonCache *> _caches;
+    std::size_t _memoryBudget = 0;
+    uint64_t _frame = 1;
+    bool _needTrim = false;
 };
 
 } // namespace spine
@@ -258,6 +258,9 @@ void SkeletonRenderer::initWithBinaryFile(const std::string &skeletonDataFile, c
 }
 
 void SkeletonRenderer::render(float /*deltaTime*/) {
+    // renderParallel() may have generated the vertices and the debug data of the slots already
+    bool staged = _staged;
+    _staged = false;
     if (!_skeleton) return;
     auto *entity = _entity;
     entity->clearDynamicRenderDrawInfos();
@@ -278,33 +281,13 @@ void SkeletonRenderer::render(float /*deltaTime*/) {
     if (_skeleton->getColor().a == 0) {
         return;
     }
-    auto &nodeWorldMat = entity->getNode()->getWorldMatrix();
-    // color range is [0.0, 1.0]
-    cc::middleware::Color4F color;
-    cc::middleware::Color4F darkColor;
-    AttachmentVertices *attachmentVertices = nullptr;
-    bool inRange = !(_startSlotIndex != -1 || _endSlotIndex != -1);
     auto vertexFormat = _useTint ? VF_XYZUVCC : VF_XYZUVC;
     cc::middleware::MeshBuffer *mb = mgr->getMeshBuffer(vertexFormat);
     cc::middleware::IOBuffer &vb = mb->getVB();
     cc::middleware::IOBuffer &ib = mb->getIB();
 
-    // vertex size int bytes with one color
-    unsigned int vbs1 = sizeof(V3F_T2F_C4B);
-    // vertex size in floats with one color
-    unsigned int vs1 = vbs1 / sizeof(float);
-    // vertex size int bytes with two color
-    unsigned int vbs2 = sizeof(V3F_T2F_C4B_C4B);
-    // verex size in floats with two color
-    unsigned int vs2 = vbs2 / sizeof(float);
-
-    auto vbs = vbs1;
-    if (_useTint) {
-        vbs = vbs2;
-    }
-
-    unsigned int vbSize = 0;
-    unsigned int ibSize = 0;
+    // vertex size in bytes
+    unsigned int vbs = _useTint ? sizeof(V3F_T2F_C4B_C4B) : sizeof(V3F_T2F_C4B);
 
     int curBlendSrc = -1;
     int curBlendDst = -1;
@@ -316,18 +299,12 @@ void SkeletonRenderer::render(float /*deltaTime*/) {
     RenderDrawInfo *curDrawInfo = nullptr;
 
     int materialLen = 0;
-    Slot *slot = nullptr;
-    int isFull = 0;
 
-    if (_debugSlots || _debugBones || _debugMesh) {
-        // If enable debug draw,then init debug buffer.
-        if (_debugBuffer == nullptr) {
-            _debugBuffer = new cc::middleware::IOTypedArray(se::Object::TypedArrayType::FLOAT32, MAX_DEBUG_BUFFER_SIZE);
-        }
-        _debugBuffer->reset();
+    if (!staged) {
+        resetDebugBuffer();
     }
 
-    auto flush = [&]() {
+    auto flush = [&](Slot *slot) {
         // fill pre segment indices count field
         if (curDrawInfo) {
             curDrawInfo->setIbCount(curISegLen);
@@ -372,6 +349,154 @@ void SkeletonRenderer::render(float /*deltaTime*/) {
         materialLen++;
     };
 
+    // Adds a slot written at the current buffer positions to the draw infos and moves past it.
+    auto commitSlot = [&](Slot *slot, cc::Texture2D *texture, unsigned int vbSize, unsigned int ibSize, int isFull) {
+        curTexture = texture;
+        // If texture or blendMode change,will change material.
+        if (preTexture != curTexture || preBlendMode != slot->getData().getBlendMode() || isFull) {
+            flush(slot);
+        }
+        auto vertexOffset = vb.getCurPos() / vbs;
+        if (vbSize > 0 && ibSize > 0) {
+            if (vertexOffset > 0) {
+                auto *ibBuffer = reinterpret_cast<uint16_t *>(ib.getCurBuffer());
+                for (unsigned int ii = 0, nn = ibSize / sizeof(uint16_t); ii < nn; ii++) {
+                    ibBuffer[ii] += vertexOffset;
+                }
+            }
+            vb.move(static_cast<int>(vbSize));
+            ib.move(static_cast<int>(ibSize));
+
+            // Record this turn index segmentation count,it will store in material buffer in the end.
+            curISegLen += ibSize / sizeof(uint16_t);
+        }
+    };
+
+    if (staged) {
+        for (const auto &stagedSlot : _stagedSlots) {
+            int isFull = vb.checkSpace(stagedSlot.vbSize, true);
+            memcpy(vb.getCurBuffer(), _stagedVB.getBuffer() + stagedSlot.vbOffset, stagedSlot.vbSize);
+            ib.checkSpace(stagedSlot.ibSize, true);
+            memcpy(ib.getCurBuffer(), _stagedIB.getBuffer() + stagedSlot.ibOffset, stagedSlot.ibSize);
+            commitSlot(stagedSlot.slot, stagedSlot.texture, stagedSlot.vbSize, stagedSlot.ibSize, isFull);
+        }
+        _stagedSlots.clear();
+    } else {
+        generateVertices(vb, ib, entity->getNode()->getWorldMatrix(), commitSlot);
+    }
+
+    if (curDrawInfo) curDrawInfo->setIbCount(curISegLen);
+
+    if (_useAttach || _debugBones) {
+        auto &bones = _skeleton->getBones();
+        size_t bonesCount = bones.size();
+
+        cc::Mat4 boneMat = cc::Mat4::IDENTITY;
+
+        if (_debugBones) {
+            _debugBuffer->writeFloat32(DebugType::BONES);
+            _debugBuffer->writeFloat32(static_cast<float>(bonesCount * 4));
+        }
+
+        for (size_t i = 0, n = bonesCount; i < n; i++) {
+            Bone *bone = bones[i];
+
+            boneMat.m[0] = bone->getA();
+            boneMat.m[1] = bone->getC();
+            boneMat.m[4] = bone->getB();
+            boneMat.m[5] = bone->getD();
+            boneMat.m[12] = bone->getWorldX();
+            boneMat.m[13] = bone->getWorldY();
+            attachInfo->checkSpace(sizeof(boneMat), true);
+            attachInfo->writeBytes(reinterpret_cast<const char *>(&boneMat), sizeof(boneMat));
+
+            if (_debugBones) {
+                float boneLength = bone->getData().getLength();
+                float x = boneLength * bone->getA() + bone->getWorldX();
+                float y = boneLength * bone->getC() + bone->getWorldY();
+                _debugBuffer->writeFloat32(bone->getWorldX());
+                _debugBuffer->writeFloat32(bone->getWorldY());
+                _debugBuffer->writeFloat32(x);
+                _debugBuffer->writeFloat32(y);
+            }
+        }
+    }
+
+    // debug end
+    if (_debugBuffer) {
+        if (_debugBuffer->isOutRange()) {
+            _debugBuffer->reset();
+            CC_LOG_INFO("Spine debug data is too large, debug buffer has no space to put in it!!!!!!!!!!");
+            CC_LOG_INFO("You can adjust MAX_DEBUG_BUFFER_SIZE macro");
+        }
+        _debugBuffer->writeFloat32(DebugType::NONE);
+    }
+}
+
+bool SkeletonRenderer::beginParallelRender() {
+    _staged = false;
+    if (!_skeleton || !_entity || _skeleton->getColor().a == 0) {
+        return false;
+    }
+    // vertex effects keep state while they run, e.g. the swirl center, and the delegate may be
+    // shared by skeletons of other groups, so these skeletons render on the main thread
+    if (_effectDelegate && _effectDelegate->getVertexEffect()) {
+        return false;
+    }
+    // the node world matrix is updated lazily, which is only safe on the main thread
+    _stagedWorldMatrix.set(_entity->getNode()->getWorldMatrix());
+    resetDebugBuffer();
+    return true;
+}
+
+void SkeletonRenderer::renderParallel() {
+    _stagedVB.reset();
+    _stagedIB.reset();
+    _stagedSlots.clear();
+    generateVertices(_stagedVB, _stagedIB, _stagedWorldMatrix, [this](Slot *slot, cc::Texture2D *texture, unsigned int vbSize, unsigned int ibSize, int /*isFull*/) {
+        _stagedSlots.push_back({slot, texture, static_cast<uint32_t>(_stagedVB.getCurPos()), vbSize, static_cast<uint32_t>(_stagedIB.getCurPos()), ibSize});
+        if (vbSize > 0 && ibSize > 0) {
+            _stagedVB.move(static_cast<int>(vbSize));
+            _stagedIB.move(static_cast<int>(ibSize));
+        }
+    });
+    _staged = true;
+}
+
+void SkeletonRenderer::resetDebugBuffer() {
+    if (_debugSlots || _debugBones || _debugMesh) {
+        // If enable debug draw,then init debug buffer.
+        if (_debugBuffer == nullptr) {
+            _debugBuffer = new cc::middleware::IOTypedArray(se::Object::TypedArrayType::FLOAT32, MAX_DEBUG_BUFFER_SIZE);
+        }
+        _debugBuffer->reset();
+    }
+}
+
+void SkeletonRenderer::generateVertices(cc::middleware::IOBuffer &vb, cc::middleware::IOBuffer &ib, const cc::Mat4 &nodeWorldMat, const SlotCallback &callback) {
+    // color range is [0.0, 1.0]
+    cc::middleware::Color4F color;
+    cc::middleware::Color4F darkColor;
+    AttachmentVertices *attachmentVertices = nullptr;
+    bool inRange = !(_startSlotIndex != -1 || _endSlotIndex != -1);
+
+    // vertex size int bytes with one color
+    unsigned int vbs1 = sizeof(V3F_T2F_C4B);
+    // vertex size in floats with one color
+    unsigned int vs1 = vbs1 / sizeof(float);
+    // vertex size int bytes with two color
+    unsigned int vbs2 = sizeof(V3F_T2F_C4B_C4B);
+    // verex size in floats with two color
+    unsigned int vs2 = vbs2 / sizeof(float);
+
+    auto vbs = vbs1;
+    if (_useTint) {
+        vbs = vbs2;
+    }
+
+    unsigned int vbSize = 0;
+    unsigned int ibSize = 0;
+
     VertexEffect *effect = nullptr;
     if (_effectDelegate) {
         effect = _effectDelegate->getVertexEffect();
@@ -383,8 +508,8 @@ void SkeletonRenderer::render(float /*deltaTime*/) {
 
     auto &drawOrder = _skeleton->getDrawOrder();
     for (size_t i = 0, n = drawOrder.size(); i < n; ++i) {
-        isFull = 0;
-        slot = drawOrder[i];
+        int isFull = 0;
+        Slot *slot = drawOrder[i];
 
         if (slot->getBone().isActive() == false) {
             continue;
@@ -709,11 +834,6 @@ void SkeletonRenderer::render(float /*deltaTime*/) {
             }
         }
 
-        curTexture = (cc::Texture2D *)attachmentVertices->_texture->getRealTexture();
-        // If texture or blendMode change,will change material.
-        if (preTexture != curTexture || preBlendMode != slot->getData().getBlendMode() || isFull) {
-            flush();
-        }
         if (_enableBatch) {
             uint8_t *vbBuffer = vb.getCurBuffer();
             cc::Vec3 *point = nullptr;
@@ -723,20 +843,7 @@ void SkeletonRenderer::render(float /*deltaTime*/) {
                 point->transformMat4(*point, nodeWorldMat);
             }
         }
-        auto vertexOffset = vb.getCurPos() / vbs;
-        if (vbSize > 0 && ibSize > 0) {
-            if (vertexOffset > 0) {
-                auto *ibBuffer = reinterpret_cast<uint16_t *>(ib.getCurBuffer());
-                for (unsigned int ii = 0, nn = ibSize / sizeof(uint16_t); ii < nn; ii++) {
-                    ibBuffer[ii] += vertexOffset;
-                }
-            }
-            vb.move(static_cast<int>(vbSize));
-            ib.move(static_cast<int>(ibSize));
-
-            // Record this turn index segmentation count,it will store in material buffer in the end.
-            curISegLen += ibSize / sizeof(uint16_t);
-        }
+        callback(slot, (cc::Texture2D *)attachmentVertices->_texture->getRealTexture(), vbSize, ibSize, isFull);
 
         _clipper->clipEnd(*slot);
     } // End slot traverse
@@ -744,53 +851,6 @@ void SkeletonRenderer::render(float /*deltaTime*/) {
     _clipper->clipEnd();
 
     if (effect) effect->end();
-
-    if (curDrawInfo) curDrawInfo->setIbCount(curISegLen);
-
-    if (_useAttach || _debugBones) {
-        auto &bones = _skeleton->getBones();
-        size_t bonesCount = bones.size();
-
-        cc::Mat4 boneMat = cc::Mat4::IDENTITY;
-
-        if (_debugBones) {
-            _debugBuffer->writeFloat32(DebugType::BONES);
-            _debugBuffer->writeFloat32(static_cast<float>(bonesCount * 4));
-        }
-
-        for (size_t i = 0, n = bonesCount; i < n; i++) {
-            Bone *bone = bones[i];
-
-            boneMat.m[0] = bone->getA();
-            boneMat.m[1] = bone->getC();
-            boneMat.m[4] = bone->getB();
-            boneMat.m[5] = bone->getD();
-            boneMat.m[12] = bone->getWorldX();
-            boneMat.m[13] = bone->getWorldY();
-            attachInfo->checkSpace(sizeof(boneMat), true);
-            attachInfo->writeBytes(reinterpret_cast<const char *>(&boneMat), sizeof(boneMat));
-
-            if (_debugBones) {
-                float boneLength = bone->getData().getLength();
-                float x = boneLength * bone->getA() + bone->getWorldX();
-                float y = boneLength * bone->getC() + bone->getWorldY();
-                _debugBuffer->writeFloat32(bone->getWorldX());
-                _debugBuffer->writeFloat32(bone->getWorldY());
-                _debugBuffer->writeFloat32(x);
-                _debugBuffer->writeFloat32(y);
-            }
-        }
-    }
-
-    // debug end
-    if (_debugBuffer) {
-        if (_debugBuffer->isOutRange()) {
-            _debugBuffer->reset();
-            CC_LOG_INFO("Spine debug data is too large, debug buffer has no space to put in it!!!!!!!!!!");
-            CC_LOG_INFO("You can adjust MAX_DEBUG_BUFFER_SIZE macro");
-        }
-        _debugBuffer->writeFloat32(DebugType::NONE);
-    }
 }
 
 cc::Rect SkeletonRenderer::getBoundingBox() const {
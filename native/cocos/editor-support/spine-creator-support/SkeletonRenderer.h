@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <functional>
 #include <vector>
 #include "IOTypedArray.h"
 #include "MiddlewareManager.h"
@@ -37,6 +38,7 @@
 #include "base/RefCounted.h"
 #include "base/RefMap.h"
 #include "core/assets/Texture2D.h"
+#include "math/Mat4.h"
 #include "middleware-adapter.h"
 #include "spine-creator-support/VertexEffectDelegate.h"
 #include "spine/spine.h"
@@ -62,6 +64,10 @@ public:
 
     void update(float deltaTime) override {}
     void render(float deltaTime) override;
+    bool beginParallelRender() override;
+    void renderParallel() override;
+    // renderers sharing a skeleton update and read it on the same worker
+    const void *getParallelGroup() const override { return _skeleton; }
     virtual cc::Rect getBoundingBox() const;
 
     Skeleton *getSkeleton() const;
@@ -154,7 +160,22 @@ public:
     void setSlotTexture(const std::string &slotName, cc::Texture2D *tex2d, bool createAttachment);
 
 protected:
+    // receives every visible slot whose vertices were written at the current positions of the buffers
+    using SlotCallback = std::function<void(Slot *slot, cc::Texture2D *texture, unsigned int vbSize, unsigned int ibSize, int isFull)>;
+
+    // vertices and slot-relative indices of the slots renderParallel() generated, render() copies them to the mesh buffer
+    struct StagedSlot {
+        Slot *slot{nullptr};
+        cc::Texture2D *texture{nullptr};
+        uint32_t vbOffset{0};
+        uint32_t vbSize{0};
+        uint32_t ibOffset{0};
+        uint32_t ibSize{0};
+    };
+
     void setSkeletonData(SkeletonData *skeletonData, bool ownsSkeletonData);
+    void generateVertices(cc::middleware::IOBuffer &vb, cc::middleware::IOBuffer &ib, const cc::Mat4 &nodeWorldMat, const SlotCallback &callback);
+    void resetDebugBuffer();
 
     bool _ownsSkeletonData = false;
     bool _ownsSkeleton = false;
@@ -187,6 +208,12 @@ protected:
     cc::Material *_material = nullptr;
     ccstd::vector<cc::RenderDrawInfo *> _drawInfoArray;
     ccstd::unordered_map<uint32_t, cc::Material *> _materialCaches;
+
+    bool _staged = false;
+    cc::Mat4 _stagedWorldMatrix;
+    cc::middleware::IOBuffer _stagedVB;
+    cc::middleware::IOBuffer _stagedIB;
+    ccstd::vector<StagedSlot> _stagedSlots;
 };
 
 } // namespace spine
@@ -27,6 +27,9 @@
 
 #include <curl/curl.h>
 #include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
 #include <thread>
 
 #include "application/ApplicationManager.h"
@@ -48,9 +51,40 @@
     #define CC_CURL_POLL_TIMEOUT_MS 50
 #endif
 
+// interval of saving the byte ranges of split tasks, for resuming them after the app is killed
+#ifndef CC_DOWNLOADER_SAVE_RANGES_INTERVAL_MS
+    #define CC_DOWNLOADER_SAVE_RANGES_INTERVAL_MS 1000
+#endif
+
+// delay before the first retry of a range after a network error, doubled on every further retry
+#ifndef CC_DOWNLOADER_RETRY_DELAY_MS
+    #define CC_DOWNLOADER_RETRY_DELAY_MS 250
+#endif
+
+#ifndef CC_DOWNLOADER_MAX_RETRY_DELAY_MS
+    #define CC_DOWNLOADER_MAX_RETRY_DELAY_MS 4000
+#endif
+
 namespace cc {
 namespace network {
 
+class DownloadTaskCURL;
+
+// One transfer of a task, the whole content or one byte range of it
+struct DownloadRangeCURL {
+    DownloadTaskCURL *coTask{nullptr};
+    CURL *handle{nullptr}; // nullptr if the range isn't transferring
+    FILE *fp{nullptr};     // file handle of the range if the task is split
+    uint32_t begin{0};
+    uint32_t end{0}; // exclusive, 0 if the content length is unknown
+    uint32_t received{0};
+    uint32_t retries{0};
+    std::chrono::steady_clock::time_point retryTime; // not restarted before this time after a network error
+    bool ranged{false};  // requested with a Range header, only a 206 response is accepted
+    bool checked{false}; // response code of the current transfer checked
+    bool done{false};
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 //  Implementation DownloadTaskCURL
 
@@ -63,9 +97,11 @@ class DownloadTaskCURL : public IDownloadTask {
 
 public:
     int serialId;
+    int32_t priority;
 
     DownloadTaskCURL()
     : serialId(_sSerialId++),
+      priority(0),
       _fp(nullptr) {
         _initInternal();
         DLLOG("Construct DownloadTaskCURL %p", this);
@@ -77,6 +113,7 @@ public:
         if (_tempFileName.length() && _sStoragePathSet.end() != _sStoragePathSet.find(_tempFileName)) {
             DownloadTaskCURL::_sStoragePathSet.erase(_tempFileName);
         }
+        closeRangeFilesProc();
         if (_fp) {
             fclose(_fp);
             _fp = nullptr;
@@ -95,6 +132,8 @@ public:
         _fileName = filename;
         _tempFileName = filename;
         _tempFileName.append(tempSuffix);
+        _rangesFileName = _tempFileName;
+        _rangesFileName.append(".ranges");
 
         if (_sStoragePathSet.end() != _sStoragePathSet.find(_tempFileName)) {
             // there is another task uses this storage path
@@ -157,11 +196,26 @@ public:
         _errDescription = desc;
     }
 
-    size_t writeDataProc(unsigned char *buffer, size_t size, size_t count) {
+    size_t writeDataProc(DownloadRangeCURL &range, unsigned char *buffer, size_t size, size_t count) {
+        if (_sink) {
+            // the sink may take a while, it's called without blocking the progress updates
+            size_t ret = size * count;
+            if (!_sink(buffer, static_cast<uint32_t>(ret))) {
+                setErrorProc(DownloadTask::ERROR_ABORT, 0, "Aborted by the stream sink.");
+                return 0;
+            }
+            std::lock_guard<std::mutex> lock(_mutex);
+            range.received += ret;
+            _bytesReceived += ret;
+            _totalBytesReceived += ret;
+            return ret;
+        }
+
         std::lock_guard<std::mutex> lock(_mutex);
         size_t ret = 0;
-        if (_fp) {
-            ret = fwrite(buffer, size, count, _fp);
+        FILE *fp = range.fp ? range.fp : _fp;
+        if (fp) {
+            ret = fwrite(buffer, size, count, fp);
         } else {
             ret = size * count;
             auto cap = _buf.capacity();
@@ -172,12 +226,32 @@ public:
             _buf.insert(_buf.end(), buffer, buffer + ret);
         }
         if (ret) {
+            range.received += ret;
             _bytesReceived += ret;
             _totalBytesReceived += ret;
         }
         return ret;
     }
 
+    bool isSplit() const {
+        return _ranges.size() > 1;
+    }
+
+    bool isCompletedProc() const {
+        return std::all_of(_ranges.begin(), _ranges.end(), [](const DownloadRangeCURL &range) {
+            return range.done;
+        });
+    }
+
+    void closeRangeFilesProc() {
+        for (auto &range : _ranges) {
+            if (range.fp) {
+                fclose(range.fp);
+                range.fp = nullptr;
+            }
+        }
+    }
+
 private:
     friend class DownloaderCURL;
 
@@ -191,6 +265,9 @@ private:
 
     ccstd::string _header; // temp buffer for receive header string, only used in thread proc
 
+    // transfers of the content, only used in thread proc
+    ccstd::vector<DownloadRangeCURL> _ranges;
+
     // progress
     uint32_t _bytesReceived;
     uint32_t _totalBytesReceived;
@@ -203,9 +280,13 @@ private:
     // for saving data
     ccstd::string _fileName;
     ccstd::string _tempFileName;
+    ccstd::string _rangesFileName;
     ccstd::vector<unsigned char> _buf;
     FILE *_fp;
 
+    // takes the content of a stream task instead of _buf, only called in thread proc
+    std::function<bool(const unsigned char *, uint32_t)> _sink;
+
     void _initInternal() {
         _acceptRanges = (false);
         _headerAchieved = (false);
@@ -216,6 +297,8 @@ private:
         _errCodeInternal = (CURLE_OK);
         _header.resize(0);
         _header.reserve(384); // pre alloc header string buffer
+        closeRangeFilesProc();
+        _ranges.clear();
     }
 };
 int DownloadTaskCURL::_sSerialId;
@@ -223,6 +306,12 @@ ccstd::set<ccstd::string> DownloadTaskCURL::_sStoragePathSet;
 
 typedef std::pair<std::shared_ptr<const DownloadTask>, DownloadTaskCURL *> TaskWrapper;
 
+// A curl handle added to the multi handle
+struct TransferCURL {
+    TaskWrapper wrapper;
+    DownloadRangeCURL *range{nullptr}; // nullptr for the header info request
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 //  Implementation DownloaderCURL::Impl
 // This class shared by DownloaderCURL and work thread.
@@ -243,7 +332,11 @@ public:
     void addTask(std::shared_ptr<const DownloadTask> task, DownloadTaskCURL *coTask) {
         if (DownloadTask::ERROR_NO_ERROR == coTask->_errCode) {
             std::lock_guard<std::mutex> lock(_requestMutex);
-            _requestQueue.push_back(make_pair(task, coTask));
+            // keep the queue ordered by priority, first in first out within a priority
+            auto it = std::find_if(_requestQueue.begin(), _requestQueue.end(), [coTask](const TaskWrapper &wrapper) {
+                return wrapper.second->priority < coTask->priority;
+            });
+            _requestQueue.insert(it, make_pair(task, coTask));
         } else {
             std::lock_guard<std::mutex> lock(_finishedMutex);
             _finishedQueue.push_back(make_pair(task, coTask));
@@ -294,16 +387,45 @@ private:
 
     static size_t _outputDataCallbackProc(void *buffer, size_t size, size_t count, void *userdata) {
         //            DLLOG("    _outputDataCallbackProc: size(%ld), count(%ld)", size, count);
-        DownloadTaskCURL *coTask = (DownloadTaskCURL *)userdata;
+        DownloadRangeCURL &range = *((DownloadRangeCURL *)userdata);
+
+        // a server ignoring the Range header responds 200 with the whole content
+        if (range.ranged && !range.checked) {
+            long httpResponseCode = 0;
+            curl_easy_getinfo(range.handle, CURLINFO_RESPONSE_CODE, &httpResponseCode);
+            if (206 != httpResponseCode) {
+                range.coTask->setErrorProc(DownloadTask::ERROR_IMPL_INTERNAL, CURLE_RANGE_ERROR, "Server doesn't respond with the requested byte range.");
+                return 0;
+            }
+            range.checked = true;
+        }
 
         // If your callback function returns CURL_WRITEFUNC_PAUSE it will cause this transfer to become paused.
-        return coTask->writeDataProc((unsigned char *)buffer, size, count);
+        return range.coTask->writeDataProc(range, (unsigned char *)buffer, size, count);
+    }
+
+    static bool _isTransientErrorProc(CURLcode code) {
+        switch (code) {
+            case CURLE_COULDNT_RESOLVE_HOST:
+            case CURLE_COULDNT_CONNECT:
+            case CURLE_PARTIAL_FILE:
+            case CURLE_OPERATION_TIMEDOUT:
+            case CURLE_SSL_CONNECT_ERROR:
+            case CURLE_GOT_NOTHING:
+            case CURLE_SEND_ERROR:
+            case CURLE_RECV_ERROR:
+            case CURLE_HTTP2:
+            case CURLE_HTTP2_STREAM:
+                return true;
+            default:
+                return false;
+        }
     }
 
     // this function designed call in work thread
     // the curl handle destroyed in _threadProc
-    // handle inited for get header
-    void _initCurlHandleProc(CURL *handle, TaskWrapper &wrapper, bool forContent = false) {
+    // handle inited for get header if range is nullptr
+    void _initCurlHandleProc(CURL *handle, TaskWrapper &wrapper, DownloadRangeCURL *range = nullptr) {
         const DownloadTask &task = *wrapper.first;
         const DownloadTaskCURL *coTask = wrapper.second;
 
@@ -312,12 +434,13 @@ private:
         curl_easy_setopt(handle, CURLOPT_URL, StringUtil::replaceAll(url, " ", "%20").c_str());
 
         // set write func
-        if (forContent) {
+        if (range) {
             curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, DownloaderCURL::Impl::_outputDataCallbackProc);
+            curl_easy_setopt(handle, CURLOPT_WRITEDATA, range);
         } else {
             curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, DownloaderCURL::Impl::_outputHeaderCallbackProc);
+            curl_easy_setopt(handle, CURLOPT_WRITEDATA, coTask);
         }
-        curl_easy_setopt(handle, CURLOPT_WRITEDATA, coTask);
 
         curl_easy_setopt(handle, CURLOPT_NOPROGRESS, true);
         //            curl_easy_setopt(handle, CURLOPT_XFERINFOFUNCTION, DownloaderCURL::Impl::_progressCallbackProc);
@@ -326,10 +449,16 @@ private:
         curl_easy_setopt(handle, CURLOPT_FAILONERROR, true);
         curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
 
-        if (forContent) {
-            /** if server acceptRanges and local has part of file, we continue to download **/
-            if (coTask->_acceptRanges && coTask->_totalBytesReceived > 0) {
-                curl_easy_setopt(handle, CURLOPT_RESUME_FROM_LARGE, (curl_off_t)coTask->_totalBytesReceived);
+        if (range) {
+            /** continue from the received part of the range, the rest of the file if the end is unknown **/
+            if (range->ranged) {
+                char rangeStr[32] = {0};
+                if (range->end) {
+                    snprintf(rangeStr, sizeof(rangeStr), "%u-%u", range->begin + range->received, range->end - 1);
+                } else {
+                    snprintf(rangeStr, sizeof(rangeStr), "%u-", range->begin + range->received);
+                }
+                curl_easy_setopt(handle, CURLOPT_RANGE, rangeStr);
             }
         } else {
             // get header options
@@ -360,7 +489,7 @@ private:
         }
     }
 
-    // get header info, if success set handle to content download state
+    // get header info, if success the content can be planned
     bool _getHeaderInfoProc(CURL *handle, TaskWrapper &wrapper) {
         DownloadTaskCURL &coTask = *wrapper.second;
         CURLcode rc = CURLE_OK;
@@ -372,8 +501,9 @@ private:
             }
             if (200 != httpResponseCode) {
                 char buf[256] = {0};
-                sprintf(buf, "When request url(%s) header info, return unexcept http response code(%ld)", wrapper.first->requestURL.c_str(), httpResponseCode);
+                snprintf(buf, sizeof(buf), "When request url(%s) header info, return unexcept http response code(%ld)", wrapper.first->requestURL.c_str(), httpResponseCode);
                 coTask.setErrorProc(DownloadTask::ERROR_IMPL_INTERNAL, CURLE_OK, buf);
+                break;
             }
 
             //                curl_easy_getinfo(handle, CURLINFO_EFFECTIVE_URL, &effectiveUrl);
@@ -384,21 +514,20 @@ private:
                 break;
             }
 
-            bool acceptRanges = (ccstd::string::npos != coTask._header.find("Accept-Ranges")) ? true : false;
-
-            // get current file size
-            uint32_t fileSize = 0;
-            if (acceptRanges && coTask._tempFileName.length()) {
-                fileSize = FileUtils::getInstance()->getFileSize(coTask._tempFileName);
+            // header names are lower case in http/2, and a server may answer "Accept-Ranges: none"
+            ccstd::string header = coTask._header;
+            StringUtil::tolower(header);
+            bool acceptRanges = false;
+            size_t found = header.rfind("accept-ranges:");
+            if (ccstd::string::npos != found) {
+                size_t lineEnd = header.find('\n', found);
+                acceptRanges = ccstd::string::npos != header.substr(found, lineEnd - found).find("bytes");
             }
 
             // set header info to coTask
             std::lock_guard<std::mutex> lock(coTask._mutex);
-            coTask._totalBytesExpected = (uint32_t)contentLen;
+            coTask._totalBytesExpected = contentLen > 0 ? (uint32_t)contentLen : 0;
             coTask._acceptRanges = acceptRanges;
-            if (acceptRanges && fileSize > 0) {
-                coTask._totalBytesReceived = fileSize;
-            }
             coTask._headerAchieved = true;
         } while (0);
 
@@ -408,18 +537,436 @@ private:
         return coTask._headerAchieved;
     }
 
+    // read the ranges saved by an interrupted download of the same content, the task mutex should be locked
+    bool _loadRangesProc(DownloadTaskCURL &coTask) {
+        auto util = FileUtils::getInstance();
+        FILE *fp = fopen(util->getSuitableFOpen(coTask._rangesFileName).c_str(), "r");
+        if (nullptr == fp) {
+            return false;
+        }
+
+        static const uint32_t MAX_RANGES = 1024;
+        uint32_t total = 0;
+        uint32_t count = 0;
+        bool ok = 2 == fscanf(fp, "%u %u", &total, &count) && total == coTask._totalBytesExpected && count > 0 && count <= MAX_RANGES;
+        uint32_t expectedBegin = 0;
+        uint32_t writtenEnd = 0;
+        for (uint32_t i = 0; ok && i < count; ++i) {
+            DownloadRangeCURL range;
+            range.coTask = &coTask;
+            ok = 3 == fscanf(fp, "%u %u %u", &range.begin, &range.end, &range.received) &&
+                 range.begin == expectedBegin && range.end > range.begin && range.received <= range.end - range.begin;
+            range.ranged = true;
+            range.done = range.received == range.end - range.begin;
+            expectedBegin = range.end;
+            writtenEnd = std::max(writtenEnd, range.begin + range.received);
+            coTask._ranges.push_back(range);
+        }
+        fclose(fp);
+
+        // the temp file was removed or replaced if it's shorter than what the ranges claim
+        long fileSize = util->getFileSize(coTask._tempFileName); //NOLINT(google-runtime-int)
+        ok = ok && expectedBegin == total && fileSize >= 0 && (uint32_t)fileSize >= writtenEnd;
+        if (!ok) {
+            coTask._ranges.clear();
+        }
+        return ok;
+    }
+
+    void _saveRangesProc(DownloadTaskCURL &coTask) {
+        if (!coTask.isSplit()) {
+            return;
+        }
+
+        // the saved ranges shouldn't claim data still buffered in memory
+        for (auto &range : coTask._ranges) {
+            if (range.fp) {
+                fflush(range.fp);
+            }
+        }
+
+        FILE *fp = fopen(FileUtils::getInstance()->getSuitableFOpen(coTask._rangesFileName).c_str(), "w");
+        if (nullptr == fp) {
+            return;
+        }
+        fprintf(fp, "%u %u\n", coTask._totalBytesExpected, (uint32_t)coTask._ranges.size());
+        for (auto &range : coTask._ranges) {
+            fprintf(fp, "%u %u %u\n", range.begin, range.end, range.received);
+        }
+        fclose(fp);
+    }
+
+    // split the content into byte ranges, or continue the ranges of an interrupted download
+    bool _planRangesProc(TaskWrapper &wrapper) {
+        DownloadTaskCURL &coTask = *wrapper.second;
+        std::lock_guard<std::mutex> lock(coTask._mutex);
+        uint32_t total = coTask._totalBytesExpected;
+        bool resumable = coTask._tempFileName.length() && coTask._acceptRanges && total;
+
+        coTask._ranges.clear();
+        if (resumable && _loadRangesProc(coTask)) {
+            if (coTask._fp) {
+                fclose(coTask._fp);
+                coTask._fp = nullptr;
+            }
+            for (auto &range : coTask._ranges) {
+                coTask._totalBytesReceived += range.received;
+            }
+            return true;
+        }
+
+        auto util = FileUtils::getInstance();
+        uint32_t offset = 0;
+        if (coTask._tempFileName.length()) {
+            // the temp file of stale ranges has holes
+            bool staleRanges = util->isFileExist(coTask._rangesFileName);
+            if (staleRanges) {
+                util->removeFile(coTask._rangesFileName);
+            }
+
+            // the temp file holds the head of the content if it's written by one transfer
+            long fileSize = util->getFileSize(coTask._tempFileName); //NOLINT(google-runtime-int)
+            if (resumable && !staleRanges && fileSize > 0 && (uint32_t)fileSize <= total) {
+                offset = (uint32_t)fileSize;
+            } else if (fileSize > 0) {
+                coTask._fp = freopen(util->getSuitableFOpen(coTask._tempFileName).c_str(), "wb", coTask._fp);
+                if (nullptr == coTask._fp) {
+                    coTask._errCode = DownloadTask::ERROR_FILE_OP_FAILED;
+                    coTask._errCodeInternal = 0;
+                    coTask._errDescription = "Can't truncate file:";
+                    coTask._errDescription.append(coTask._tempFileName);
+                    return false;
+                }
+            }
+        }
+        coTask._totalBytesReceived = offset;
+
+        uint32_t count = 1;
+        if (resumable && hints.minRangeSizeInBytes) {
+            count = std::min((total - offset) / hints.minRangeSizeInBytes, hints.countOfMaxRangesPerTask);
+            count = std::max(count, 1U);
+        }
+
+        DownloadRangeCURL range;
+        range.coTask = &coTask;
+        if (1 == count) {
+            range.begin = offset;
+            range.end = total;
+            range.ranged = offset > 0;
+            range.done = total && offset == total;
+            coTask._ranges.push_back(range);
+            return true;
+        }
+
+        // every range writes the temp file with its own file handle
+        if (coTask._fp) {
+            fclose(coTask._fp);
+            coTask._fp = nullptr;
+        }
+        if (offset) {
+            range.end = offset;
+            range.received = offset;
+            range.done = true;
+            coTask._ranges.push_back(range);
+        }
+        uint32_t size = (total - offset) / count;
+        range.ranged = true;
+        range.received = 0;
+        range.done = false;
+        for (uint32_t i = 0; i < count; ++i) {
+            range.begin = offset + i * size;
+            range.end = i + 1 == count ? total : range.begin + size;
+            coTask._ranges.push_back(range);
+        }
+        return true;
+    }
+
+    bool _startRangeProc(CURLM *curlmHandle, TaskWrapper &wrapper, DownloadRangeCURL &range) {
+        DownloadTaskCURL &coTask = *wrapper.second;
+        if (coTask.isSplit()) {
+            if (nullptr == range.fp) {
+                range.fp = fopen(FileUtils::getInstance()->getSuitableFOpen(coTask._tempFileName).c_str(), "r+b");
+            }
+            if (nullptr == range.fp || 0 != fseek(range.fp, (long)(range.begin + range.received), SEEK_SET)) { //NOLINT(google-runtime-int)
+                ccstd::string desc = "Can't open file:";
+                desc.append(coTask._tempFileName);
+                coTask.setErrorProc(DownloadTask::ERROR_FILE_OP_FAILED, 0, desc.c_str());
+                return false;
+            }
+        }
+
+        CURL *curlHandle = curl_easy_init();
+        if (nullptr == curlHandle) {
+            coTask.setErrorProc(DownloadTask::ERROR_IMPL_INTERNAL, 0, "Alloc curl handle failed.");
+            return false;
+        }
+
+        range.handle = curlHandle;
+        range.checked = false;
+        _initCurlHandleProc(curlHandle, wrapper, &range);
+
+        CURLMcode mcode = curl_multi_add_handle(curlmHandle, curlHandle);
+        if (CURLM_OK != mcode) {
+            curl_easy_cleanup(curlHandle);
+            range.handle = nullptr;
+            coTask.setErrorProc(DownloadTask::ERROR_IMPL_INTERNAL, mcode, curl_multi_strerror(mcode));
+            return false;
+        }
+
+        DLLOG("    _threadProc task create curl handle:%p for range [%u, %u)", curlHandle, range.begin, range.end);
+        _transfers[curlHandle] = {wrapper, &range};
+        _bandwidthDirty = true;
+        return true;
+    }
+
+    void _stopTransfersProc(CURLM *curlmHandle, DownloadTaskCURL &coTask) {
+        for (auto &range : coTask._ranges) {
+            if (range.handle) {
+                curl_multi_remove_handle(curlmHandle, range.handle);
+                curl_easy_cleanup(range.handle);
+                _transfers.erase(range.handle);
+                range.handle = nullptr;
+                _bandwidthDirty = true;
+            }
+        }
+    }
+
+    void _finishTaskProc(TaskWrapper &wrapper) {
+        DownloadTaskCURL &coTask = *wrapper.second;
+        if (DownloadTask::ERROR_NO_ERROR == coTask._errCode) {
+            if (coTask.isSplit()) {
+                FileUtils::getInstance()->removeFile(coTask._rangesFileName);
+            }
+        } else {
+            // keep what was received for resuming the download
+            _saveRangesProc(coTask);
+        }
+        coTask.closeRangeFilesProc();
+
+        auto it = std::find(_runningTasks.begin(), _runningTasks.end(), wrapper);
+        if (_runningTasks.end() != it) {
+            _runningTasks.erase(it);
+        }
+
+        // remove from _processSet
+        {
+            std::lock_guard<std::mutex> lock(_processMutex);
+            if (_processSet.end() != _processSet.find(wrapper)) {
+                _processSet.erase(wrapper);
+            }
+        }
+
+        // add to finishedQueue
+        {
+            std::lock_guard<std::mutex> lock(_finishedMutex);
+            _finishedQueue.push_back(wrapper);
+        }
+    }
+
+    void _onTransferDoneProc(CURLM *curlmHandle, CURL *curlHandle, CURLcode errCode) {
+        TransferCURL transfer = _transfers[curlHandle];
+        TaskWrapper &wrapper = transfer.wrapper;
+        DownloadTaskCURL &coTask = *wrapper.second;
+
+        // remove from multi-handle
+        curl_multi_remove_handle(curlmHandle, curlHandle);
+        _transfers.erase(curlHandle);
+        _bandwidthDirty = true;
+
+        if (nullptr == transfer.range) {
+            // the task is get header task
+            bool planned = false;
+            if (CURLE_OK != errCode) {
+                coTask.setErrorProc(DownloadTask::ERROR_IMPL_INTERNAL, errCode, curl_easy_strerror(errCode));
+            } else {
+                // the error info has been set in _getHeaderInfoProc and _planRangesProc
+                planned = _getHeaderInfoProc(curlHandle, wrapper) && _planRangesProc(wrapper);
+            }
+            curl_easy_cleanup(curlHandle);
+            DLLOG("    _threadProc task clean header handle :%p with errCode:%d", curlHandle, errCode);
+
+            // the ranges are started by _scheduleProc, unless the file has been downloaded completely
+            if (!planned || coTask.isCompletedProc()) {
+                _finishTaskProc(wrapper);
+            }
+            return;
+        }
+
+        DownloadRangeCURL &range = *transfer.range;
+        range.handle = nullptr;
+        curl_easy_cleanup(curlHandle);
+        DLLOG("    _threadProc task clean cur handle :%p with errCode:%d", curlHandle, errCode);
+
+        if (CURLE_OK == errCode && range.end && range.begin + range.received != range.end) {
+            errCode = CURLE_PARTIAL_FILE;
+        }
+
+        if (CURLE_OK == errCode) {
+            range.done = true;
+            if (coTask.isCompletedProc()) {
+                _finishTaskProc(wrapper);
+            }
+            return;
+        }
+
+        bool failed = false;
+        {
+            std::lock_guard<std::mutex> lock(coTask._mutex);
+            failed = DownloadTask::ERROR_NO_ERROR != coTask._errCode;
+        }
+
+        // resume the range after a network error, _scheduleProc restarts it
+        bool resumable = range.ranged || coTask._acceptRanges || 0 == range.received;
+        if (!failed && resumable && _isTransientErrorProc(errCode) && range.retries < hints.countOfRetriesPerRange) {
+            // back off, an unreachable host or a dropped network is rarely back at once
+            uint32_t delay = std::min<uint32_t>(CC_DOWNLOADER_RETRY_DELAY_MS << range.retries, CC_DOWNLOADER_MAX_RETRY_DELAY_MS);
+            range.retryTime = std::chrono::steady_clock::now() + std::chrono::milliseconds(delay);
+            ++range.retries;
+            range.ranged = range.ranged || range.received > 0;
+            DLLOG("    _threadProc retry range [%u, %u) of task %d", range.begin, range.end, coTask.serialId);
+            return;
+        }
+
+        if (!failed) {
+            coTask.setErrorProc(DownloadTask::ERROR_IMPL_INTERNAL, errCode, curl_easy_strerror(errCode));
+        }
+        _stopTransfersProc(curlmHandle, coTask);
+        _finishTaskProc(wrapper);
+    }
+
+    // ranges not transferring yet, or waiting to be retried
+    bool _hasPendingRangesProc() const {
+        for (const auto &wrapper : _runningTasks) {
+            for (const auto &range : wrapper.second->_ranges) {
+                if (!range.done && !range.handle) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // fill the free connections, the pending ranges of the running tasks go before the queued tasks
+    void _scheduleProc(CURLM *curlmHandle) {
+        uint32_t countOfMaxProcessingTasks = this->hints.countOfMaxProcessingTasks;
+        auto hasFreeConnection = [&]() {
+            return 0 == countOfMaxProcessingTasks || _transfers.size() < countOfMaxProcessingTasks;
+        };
+        auto now = std::chrono::steady_clock::now();
+
+        for (size_t i = 0; i < _runningTasks.size() && hasFreeConnection();) {
+            TaskWrapper wrapper = _runningTasks[i];
+            bool failed = false;
+            for (auto &range : wrapper.second->_ranges) {
+                if (!hasFreeConnection()) {
+                    break;
+                }
+                if (range.done || range.handle || now < range.retryTime) {
+                    continue;
+                }
+                if (!_startRangeProc(curlmHandle, wrapper, range)) {
+                    failed = true;
+                    break;
+                }
+            }
+            if (failed) {
+                // removed from _runningTasks
+                _stopTransfersProc(curlmHandle, *wrapper.second);
+                _finishTaskProc(wrapper);
+                continue;
+            }
+            ++i;
+        }
+
+        // process tasks in _requestList
+        while (hasFreeConnection()) {
+            // get task wrapper from request queue
+            TaskWrapper wrapper;
+            {
+                std::lock_guard<std::mutex> lock(_requestMutex);
+                if (_requestQueue.size()) {
+                    wrapper = _requestQueue.front();
+                    _requestQueue.pop_front();
+                }
+            }
+
+            // if request queue is empty, the wrapper.first is nullptr
+            if (!wrapper.first) {
+                break;
+            }
+
+            wrapper.second->initProc();
+
+            // create curl handle from task and add into curl multi handle
+            CURL *curlHandle = curl_easy_init();
+
+            if (nullptr == curlHandle) {
+                wrapper.second->setErrorProc(DownloadTask::ERROR_IMPL_INTERNAL, 0, "Alloc curl handle failed.");
+                std::lock_guard<std::mutex> lock(_finishedMutex);
+                _finishedQueue.push_back(wrapper);
+                continue;
+            }
+
+            // init curl handle for get header info
+            _initCurlHandleProc(curlHandle, wrapper);
+
+            // add curl handle to process list
+            CURLMcode mcode = curl_multi_add_handle(curlmHandle, curlHandle);
+            if (CURLM_OK != mcode) {
+                curl_easy_cleanup(curlHandle);
+                wrapper.second->setErrorProc(DownloadTask::ERROR_IMPL_INTERNAL, mcode, curl_multi_strerror(mcode));
+                std::lock_guard<std::mutex> lock(_finishedMutex);
+                _finishedQueue.push_back(wrapper);
+                continue;
+            }
+
+            DLLOG("    _threadProc task create curl handle:%p", curlHandle);
+            _transfers[curlHandle] = {wrapper, nullptr};
+            auto it = std::find_if(_runningTasks.begin(), _runningTasks.end(), [&wrapper](const TaskWrapper &running) {
+                return running.second->priority < wrapper.second->priority;
+            });
+            _runningTasks.insert(it, wrapper);
+            std::lock_guard<std::mutex> lock(_processMutex);
+            _processSet.insert(wrapper);
+        }
+    }
+
+    // share hints.maxBytesPerSecond between the content transfers in proportion to their task priority
+    void _balanceBandwidthProc() {
+        if (!_bandwidthDirty || 0 == hints.maxBytesPerSecond) {
+            return;
+        }
+        _bandwidthDirty = false;
+
+        auto weightOf = [](const TransferCURL &transfer) -> uint64_t {
+            return std::max(transfer.wrapper.second->priority, 0) + 1;
+        };
+        uint64_t totalWeight = 0;
+        for (auto &it : _transfers) {
+            if (it.second.range) {
+                totalWeight += weightOf(it.second);
+            }
+        }
+        for (auto &it : _transfers) {
+            if (it.second.range) {
+                uint64_t speed = std::max<uint64_t>(hints.maxBytesPerSecond * weightOf(it.second) / totalWeight, 1);
+                // the limit is read by curl on every read, so it applies to a running transfer too
+                curl_easy_setopt(it.first, CURLOPT_MAX_RECV_SPEED_LARGE, (curl_off_t)speed);
+            }
+        }
+    }
+
     void _threadProc() {
         DLLOG("++++DownloaderCURL::Impl::_threadProc begin %p", this);
         // the holder prevent DownloaderCURL::Impl class instance be destruct in main thread
         auto holder = this->shared_from_this();
         auto thisThreadId = std::this_thread::get_id();
-        uint32_t countOfMaxProcessingTasks = this->hints.countOfMaxProcessingTasks;
         // init curl content
         CURLM *curlmHandle = curl_multi_init();
-        ccstd::unordered_map<CURL *, TaskWrapper> coTaskMap;
         int runningHandles = 0;
         CURLMcode mcode = CURLM_OK;
         int rc = 0; // select return code
+        auto rangesSavedTime = std::chrono::steady_clock::now();
 
         do {
             // check the thread should exit or not
@@ -471,9 +1018,12 @@ private:
                 if (rc < 0) {
                     DLLOG("    _threadProc: select return unexpect code: %d", rc);
                 }
+            } else if (_transfers.empty() && _hasPendingRangesProc()) {
+                // every range left is waiting to be retried
+                std::this_thread::sleep_for(std::chrono::milliseconds(CC_CURL_POLL_TIMEOUT_MS));
             }
 
-            if (coTaskMap.size()) {
+            if (_transfers.size()) {
                 mcode = CURLM_CALL_MULTI_PERFORM;
                 while (CURLM_CALL_MULTI_PERFORM == mcode) {
                     mcode = curl_multi_perform(curlmHandle, &runningHandles);
@@ -487,126 +1037,22 @@ private:
                     int msgq = 0;
                     m = curl_multi_info_read(curlmHandle, &msgq);
                     if (m && (m->msg == CURLMSG_DONE)) {
-                        CURL *curlHandle = m->easy_handle;
-                        CURLcode errCode = m->data.result;
-
-                        TaskWrapper wrapper = coTaskMap[curlHandle];
-
-                        // remove from multi-handle
-                        curl_multi_remove_handle(curlmHandle, curlHandle);
-                        bool reinited = false;
-                        do {
-                            if (CURLE_OK != errCode) {
-                                wrapper.second->setErrorProc(DownloadTask::ERROR_IMPL_INTERNAL, errCode, curl_easy_strerror(errCode));
-                                break;
-                            }
-
-                            // if the task is content download task, cleanup the handle
-                            if (wrapper.second->_headerAchieved) {
-                                break;
-                            }
-
-                            // the task is get header task
-                            // first, we get info from response
-                            if (false == _getHeaderInfoProc(curlHandle, wrapper)) {
-                                // the error info has been set in _getHeaderInfoProc
-                                break;
-                            }
-
-                            // after get header info success
-                            // wrapper.second->_totalBytesReceived inited by local file size
-                            // if the local file size equal with the content size from header, the file has downloaded finish
-                            if (wrapper.second->_totalBytesReceived &&
-                                wrapper.second->_totalBytesReceived == wrapper.second->_totalBytesExpected) {
-                                // the file has download complete
-                                // break to move this task to finish queue
-                                break;
-                            }
-                            // reinit curl handle for download content
-                            curl_easy_reset(curlHandle);
-                            _initCurlHandleProc(curlHandle, wrapper, true);
-                            mcode = curl_multi_add_handle(curlmHandle, curlHandle);
-                            if (CURLM_OK != mcode) {
-                                wrapper.second->setErrorProc(DownloadTask::ERROR_IMPL_INTERNAL, mcode, curl_multi_strerror(mcode));
-                                break;
-                            }
-                            reinited = true;
-                        } while (0);
-
-                        if (reinited) {
-                            continue;
-                        }
-                        curl_easy_cleanup(curlHandle);
-                        DLLOG("    _threadProc task clean cur handle :%p with errCode:%d", curlHandle, errCode);
-
-                        // remove from coTaskMap
-                        coTaskMap.erase(curlHandle);
-
-                        // remove from _processSet
-                        {
-                            std::lock_guard<std::mutex> lock(_processMutex);
-                            if (_processSet.end() != _processSet.find(wrapper)) {
-                                _processSet.erase(wrapper);
-                            }
-                        }
-
-                        // add to finishedQueue
-                        {
-                            std::lock_guard<std::mutex> lock(_finishedMutex);
-                            _finishedQueue.push_back(wrapper);
-                        }
+                        _onTransferDoneProc(curlmHandle, m->easy_handle, m->data.result);
                     }
                 } while (m);
             }
 
-            // process tasks in _requestList
-            auto size = coTaskMap.size();
-            while (0 == countOfMaxProcessingTasks || size < countOfMaxProcessingTasks) {
-                // get task wrapper from request queue
-                TaskWrapper wrapper;
-                {
-                    std::lock_guard<std::mutex> lock(_requestMutex);
-                    if (_requestQueue.size()) {
-                        wrapper = _requestQueue.front();
-                        _requestQueue.pop_front();
-                    }
-                }
+            _scheduleProc(curlmHandle);
+            _balanceBandwidthProc();
 
-                // if request queue is empty, the wrapper.first is nullptr
-                if (!wrapper.first) {
-                    break;
+            auto now = std::chrono::steady_clock::now();
+            if (now - rangesSavedTime >= std::chrono::milliseconds(CC_DOWNLOADER_SAVE_RANGES_INTERVAL_MS)) {
+                for (auto &wrapper : _runningTasks) {
+                    _saveRangesProc(*wrapper.second);
                 }
-
-                wrapper.second->initProc();
-
-                // create curl handle from task and add into curl multi handle
-                CURL *curlHandle = curl_easy_init();
-
-                if (nullptr == curlHandle) {
-                    wrapper.second->setErrorProc(DownloadTask::ERROR_IMPL_INTERNAL, 0, "Alloc curl handle failed.");
-                    std::lock_guard<std::mutex> lock(_finishedMutex);
-                    _finishedQueue.push_back(wrapper);
-                    continue;
-                }
-
-                // init curl handle for get header info
-                _initCurlHandleProc(curlHandle, wrapper);
-
-                // add curl handle to process list
-                mcode = curl_multi_add_handle(curlmHandle, curlHandle);
-                if (CURLM_OK != mcode) {
-                    wrapper.second->setErrorProc(DownloadTask::ERROR_IMPL_INTERNAL, mcode, curl_multi_strerror(mcode));
-                    std::lock_guard<std::mutex> lock(_finishedMutex);
-                    _finishedQueue.push_back(wrapper);
-                    continue;
-                }
-
-                DLLOG("    _threadProc task create curl handle:%p", curlHandle);
-                coTaskMap[curlHandle] = wrapper;
-                std::lock_guard<std::mutex> lock(_processMutex);
-                _processSet.insert(wrapper);
+                rangesSavedTime = now;
             }
-        } while (coTaskMap.size());
+        } while (_transfers.size() || _hasPendingRangesProc());
 
         curl_multi_cleanup(curlmHandle);
         this->stop();
@@ -618,6 +1064,11 @@ private:
     ccstd::set<TaskWrapper> _processSet;
     ccstd::deque<TaskWrapper> _finishedQueue;
 
+    // only used in thread proc
+    ccstd::unordered_map<CURL *, TransferCURL> _transfers;
+    ccstd::vector<TaskWrapper> _runningTasks; // ordered by priority
+    bool _bandwidthDirty{false};
+
     std::mutex _threadMutex;
     std::mutex _requestMutex;
     std::mutex _processMutex;
@@ -631,7 +1082,10 @@ DownloaderCURL::DownloaderCURL(const DownloaderHints &hints)
   _currTask(nullptr) {
     DLLOG("Construct DownloaderCURL %p", this);
     _impl->hints = hints;
-    _scheduler = CC_CURRENT_ENGINE()->getScheduler();
+    // without a running application, e.g. in the unit tests, the owner calls onSchedule itself
+    if (auto app = CC_CURRENT_APPLICATION()) {
+        _scheduler = app->getEngine()->getScheduler();
+    }
 
     _transferDataToBuffer = [this](void *buf, uint32_t len) -> uint32_t {
         DownloadTaskCURL &coTask = *_currTask;
@@ -669,6 +1123,7 @@ DownloaderCURL::~DownloaderCURL() {
 
 IDownloadTask *DownloaderCURL::createCoTask(std::shared_ptr<const DownloadTask> &task) {
     DownloadTaskCURL *coTask = ccnew DownloadTaskCURL;
+    coTask->priority = task->priority;
     coTask->init(task->storagePath, _impl->hints.tempFileNameSuffix);
 
     DLLOG("    DownloaderCURL: createTask: Id(%d)", coTask->serialId);
@@ -682,6 +1137,25 @@ IDownloadTask *DownloaderCURL::createCoTask(std::shared_ptr<const DownloadTask>
     return coTask;
 }
 
+IDownloadTask *DownloaderCURL::createStreamCoTask(std::shared_ptr<const DownloadTask> &task,
+                                                 const std::function<bool(const unsigned char *data, uint32_t size)> &sink) {
+    // a data task, its interrupted transfers resume where the sink stopped
+    DownloadTaskCURL *coTask = ccnew DownloadTaskCURL;
+    coTask->priority = task->priority;
+    coTask->init("", _impl->hints.tempFileNameSuffix);
+    coTask->_sink = sink;
+
+    DLLOG("    DownloaderCURL: createStreamTask: Id(%d)", coTask->serialId);
+
+    _impl->addTask(task, coTask);
+    _impl->run();
+
+    if (auto sche = _scheduler.lock()) {
+        sche->resumeTarget(this);
+    }
+    return coTask;
+}
+
 void DownloaderCURL::abort(const std::unique_ptr<IDownloadTask> &task) {
     // REFINE
     // https://github.com/cocos-creator/cocos2d-x-lite/pull/1291
@@ -739,11 +1213,12 @@ void DownloaderCURL::onSchedule(float) {
         if (coTask._fp) {
             fclose(coTask._fp);
             coTask._fp = nullptr;
+        }
+        if (coTask._fileName.length() && DownloadTask::ERROR_NO_ERROR != coTask._errCode) {
+            // keep the temp file for resuming, and allow another task to continue it
+            DownloadTaskCURL::_sStoragePathSet.erase(coTask._tempFileName);
+        } else if (coTask._fileName.length()) {
             do {
-                if (0 == coTask._fileName.length()) {
-                    break;
-                }
-
                 auto util = FileUtils::getInstance();
                 // if file already exist, remove it
                 if (util->isFileExist(coTask._fileName)) {
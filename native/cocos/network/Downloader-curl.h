@@ -43,6 +43,11 @@ public:
 
     IDownloadTask *createCoTask(std::shared_ptr<const DownloadTask> &task) override;
 
+    bool isStreamingSupported() const override { return true; }
+
+    IDownloadTask *createStreamCoTask(std::shared_ptr<const DownloadTask> &task,
+                                      const std::function<bool(const unsigned char *data, uint32_t size)> &sink) override;
+
     void abort(const std::unique_ptr<IDownloadTask> &task) override;
 
 protected:
@@ -53,7 +58,8 @@ protected:
     DownloadTaskCURL *_currTask; // temp ref
     std::function<uint32_t(void *, uint32_t)> _transferDataToBuffer;
 
-    // scheduler for update processing and finished task in main schedule
+    // scheduler for update processing and finished task in main schedule,
+    // delivers the progress and the finished tasks when called directly too
     void onSchedule(float);
     ccstd::string _schedulerKey;
     std::weak_ptr<Scheduler> _scheduler;
@@ -129,7 +129,8 @@ std::shared_ptr<const DownloadTask> Downloader::createDataTask(const ccstd::stri
 std::shared_ptr<const DownloadTask> Downloader::createDownloadTask(const ccstd::string &srcUrl,
                                                                    const ccstd::string &storagePath,
                                                                    const ccstd::unordered_map<ccstd::string, ccstd::string> &header,
-                                                                   const ccstd::string &identifier /* = ""*/) {
+                                                                   const ccstd::string &identifier /* = ""*/,
+                                                                   int32_t priority /* = 0*/) {
     auto *iTask = ccnew DownloadTask();
     std::shared_ptr<const DownloadTask> task(iTask);
     do {
@@ -137,6 +138,7 @@ std::shared_ptr<const DownloadTask> Downloader::createDownloadTask(const ccstd::
         iTask->storagePath = storagePath;
         iTask->identifier = identifier;
         iTask->header = header;
+        iTask->priority = priority;
         if (0 == srcUrl.length() || 0 == storagePath.length()) {
             if (onTaskError) {
                 onTaskError(*task, DownloadTask::ERROR_INVALID_PARAMS, 0, "URL or storage path is empty.");
@@ -156,6 +158,31 @@ std::shared_ptr<const DownloadTask> Downloader::createDownloadTask(const ccstd::
     return createDownloadTask(srcUrl, storagePath, emptyHeader, identifier);
 }
 
+std::shared_ptr<const DownloadTask> Downloader::createStreamTask(const ccstd::string &srcUrl,
+                                                                 const std::function<bool(const unsigned char *data, uint32_t size)> &sink,
+                                                                 const ccstd::string &identifier /* = ""*/) {
+    auto *iTask = ccnew DownloadTask();
+    std::shared_ptr<const DownloadTask> task(iTask);
+    do {
+        iTask->requestURL = srcUrl;
+        iTask->identifier = identifier;
+        if (0 == srcUrl.length() || !sink || !_impl->isStreamingSupported()) {
+            if (onTaskError) {
+                onTaskError(*task, DownloadTask::ERROR_INVALID_PARAMS, 0, "URL or sink is empty, or streaming is not supported.");
+            }
+            task.reset();
+            break;
+        }
+        iTask->_coTask.reset(_impl->createStreamCoTask(task, sink));
+    } while (false);
+
+    return task;
+}
+
+bool Downloader::isStreamingSupported() const {
+    return _impl->isStreamingSupported();
+}
+
 void Downloader::abort(const std::shared_ptr<const DownloadTask> &task) {
     _impl->abort(task->_coTask);
 }
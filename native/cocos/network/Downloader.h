@@ -52,6 +52,8 @@ public:
     ccstd::string requestURL;
     ccstd::string storagePath;
     ccstd::unordered_map<ccstd::string, ccstd::string> header;
+    // Tasks with a higher priority are started first and get a larger share of DownloaderHints::maxBytesPerSecond
+    int32_t priority{0};
 
     DownloadTask();
     virtual ~DownloadTask();
@@ -65,6 +67,18 @@ struct CC_DLL DownloaderHints {
     uint32_t countOfMaxProcessingTasks{6};
     uint32_t timeoutInSeconds{45};
     ccstd::string tempFileNameSuffix{".tmp"};
+
+    // The hints below are only used by the curl downloader, which counts
+    // countOfMaxProcessingTasks in connections rather than in tasks.
+
+    // A file task is split into up to this many byte ranges downloaded in parallel, if the server accepts ranges
+    uint32_t countOfMaxRangesPerTask{4};
+    // Files smaller than twice this size are downloaded in one piece
+    uint32_t minRangeSizeInBytes{4 * 1024 * 1024};
+    // Times a transfer is resumed after a network error before the task fails
+    uint32_t countOfRetriesPerRange{3};
+    // Download speed shared by all the tasks and weighted by their priority, 0 means no limit
+    uint32_t maxBytesPerSecond{0};
 };
 
 class CC_DLL Downloader final {
@@ -113,7 +127,16 @@ public:
 
     std::shared_ptr<const DownloadTask> createDownloadTask(const ccstd::string &srcUrl, const ccstd::string &storagePath, const ccstd::string &identifier = "");
 
-    std::shared_ptr<const DownloadTask> createDownloadTask(const ccstd::string &srcUrl, const ccstd::string &storagePath, const ccstd::unordered_map<ccstd::string, ccstd::string> &header, const ccstd::string &identifier = "");
+    /**
+     * Creates a data task whose content is handed to sink as it arrives, on the download thread and in order.
+     * Returning false from sink aborts the task. onDataTaskSuccess is called with empty data once the content is complete.
+     * Fails with ERROR_INVALID_PARAMS where isStreamingSupported() is false.
+     */
+    std::shared_ptr<const DownloadTask> createStreamTask(const ccstd::string &srcUrl, const std::function<bool(const unsigned char *data, uint32_t size)> &sink, const ccstd::string &identifier = "");
+
+    bool isStreamingSupported() const;
+
+    std::shared_ptr<const DownloadTask> createDownloadTask(const ccstd::string &srcUrl, const ccstd::string &storagePath, const ccstd::unordered_map<ccstd::string, ccstd::string> &header, const ccstd::string &identifier = "", int32_t priority = 0);
 
     void abort(const std::shared_ptr<const DownloadTask> &task);
 
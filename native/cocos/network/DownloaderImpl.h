@@ -71,6 +71,14 @@ public:
 
     virtual IDownloadTask *createCoTask(std::shared_ptr<const DownloadTask> &task) = 0;
 
+    virtual bool isStreamingSupported() const { return false; }
+
+    // the content is handed to sink on the download thread instead of being buffered, returning false aborts the task
+    virtual IDownloadTask *createStreamCoTask(std::shared_ptr<const DownloadTask> & /*task*/,
+                                              const std::function<bool(const unsigned char *data, uint32_t size)> & /*sink*/) {
+        return nullptr;
+    }
+
     virtual void abort(const std::unique_ptr<IDownloadTask> &task) = 0;
 };
 
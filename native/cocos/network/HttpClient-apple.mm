@@ -339,6 +339,15 @@ void HttpClient::setSSLVerification(const ccstd::string &caFile) {
     _sslCaFilename = caFile;
 }
 
+// The platform's http stack schedules the requests and connections itself
+void HttpClient::setMaxConcurrentRequests(uint32_t count) {
+    _maxConcurrentRequests = count;
+}
+
+void HttpClient::setMaxConnectionsPerHost(uint32_t count) {
+    _maxConnectionsPerHost = count;
+}
+
 HttpClient::HttpClient()
 : _isInited(false),
   _timeoutForConnect(30),
@@ -26,294 +26,18 @@
 ****************************************************************************/
 
 #include "network/HttpClient.h"
-#include <curl/curl.h>
-#include <errno.h>
+#include <cstring>
 #include "application/ApplicationManager.h"
 #include "base/Log.h"
-#include "base/ThreadPool.h"
 #include "base/memory/Memory.h"
+#include "network/HttpSession-curl.h"
 #include "platform/FileUtils.h"
-#include "platform/StdC.h"
 
 namespace cc {
 
 namespace network {
 
-#if (CC_PLATFORM == CC_PLATFORM_WINDOWS)
-typedef int int32_t;
-#endif
-
 static HttpClient *_httpClient = nullptr; // pointer to singleton
-static LegacyThreadPool *gThreadPool = nullptr;
-
-typedef size_t (*write_callback)(void *ptr, size_t size, size_t nmemb, void *stream);
-
-// Callback function used by libcurl for collect response data
-static size_t writeData(void *ptr, size_t size, size_t nmemb, void *stream) {
-    ccstd::vector<char> *recvBuffer = (ccstd::vector<char> *)stream;
-    size_t sizes = size * nmemb;
-
-    // add data to the end of recvBuffer
-    // write data maybe called more than once in a single request
-    recvBuffer->insert(recvBuffer->end(), (char *)ptr, (char *)ptr + sizes);
-
-    return sizes;
-}
-
-// Callback function used by libcurl for collect header data
-static size_t writeHeaderData(void *ptr, size_t size, size_t nmemb, void *stream) {
-    ccstd::vector<char> *recvBuffer = (ccstd::vector<char> *)stream;
-    size_t sizes = size * nmemb;
-
-    // add data to the end of recvBuffer
-    // write data maybe called more than once in a single request
-    recvBuffer->insert(recvBuffer->end(), (char *)ptr, (char *)ptr + sizes);
-
-    return sizes;
-}
-
-static int processGetTask(HttpClient *client, HttpRequest *request, write_callback callback, void *stream, long *errorCode, write_callback headerCallback, void *headerStream, char *errorBuffer);
-static int processPostTask(HttpClient *client, HttpRequest *request, write_callback callback, void *stream, long *errorCode, write_callback headerCallback, void *headerStream, char *errorBuffer);
-static int processPutTask(HttpClient *client, HttpRequest *request, write_callback callback, void *stream, long *errorCode, write_callback headerCallback, void *headerStream, char *errorBuffer);
-static int processDeleteTask(HttpClient *client, HttpRequest *request, write_callback callback, void *stream, long *errorCode, write_callback headerCallback, void *headerStream, char *errorBuffer);
-static int processPatchTask(HttpClient *client, HttpRequest *request, write_callback callback, void *stream, long *errorCode, write_callback headerCallback, void *headerStream, char *errorBuffer);
-// int processDownloadTask(HttpRequest *task, write_callback callback, void *stream, int32_t *errorCode);
-
-// Worker thread
-void HttpClient::networkThread() {
-    increaseThreadCount();
-
-    while (true) {
-        HttpRequest *request;
-
-        // step 1: send http request if the requestQueue isn't empty
-        {
-            std::lock_guard<std::mutex> lock(_requestQueueMutex);
-            while (_requestQueue.empty()) {
-                _sleepCondition.wait(_requestQueueMutex);
-            }
-            request = _requestQueue.at(0);
-            _requestQueue.erase(0);
-        }
-
-        if (request == _requestSentinel) {
-            break;
-        }
-
-        // step 2: libcurl sync access
-
-        // Create a HttpResponse object, the default setting is http access failed
-        HttpResponse *response = ccnew HttpResponse(request);
-        response->addRef(); // NOTE: RefCounted object's reference count is changed to 0 now. so needs to addRef after ccnew.
-
-        processResponse(response, _responseMessage);
-
-        // add response packet into queue
-        _responseQueueMutex.lock();
-        _responseQueue.pushBack(response);
-        _responseQueueMutex.unlock();
-
-        _schedulerMutex.lock();
-        if (auto sche = _scheduler.lock()) {
-            sche->performFunctionInCocosThread(CC_CALLBACK_0(HttpClient::dispatchResponseCallbacks, this));
-        }
-        _schedulerMutex.unlock();
-    }
-
-    // cleanup: if worker thread received quit signal, clean up un-completed request queue
-    _requestQueueMutex.lock();
-    _requestQueue.clear();
-    _requestQueueMutex.unlock();
-
-    _responseQueueMutex.lock();
-    _responseQueue.clear();
-    _responseQueueMutex.unlock();
-
-    decreaseThreadCountAndMayDeleteThis();
-}
-
-// Worker thread
-void HttpClient::networkThreadAlone(HttpRequest *request, HttpResponse *response) {
-    increaseThreadCount();
-
-    char responseMessage[RESPONSE_BUFFER_SIZE] = {0};
-    processResponse(response, responseMessage);
-
-    _schedulerMutex.lock();
-    if (auto sche = _scheduler.lock()) {
-        sche->performFunctionInCocosThread([this, response, request] {
-            const ccHttpRequestCallback &callback = request->getResponseCallback();
-
-            if (callback != nullptr) {
-                callback(this, response);
-            }
-            response->release();
-            // do not release in other thread
-            request->release();
-        });
-    }
-    _schedulerMutex.unlock();
-
-    decreaseThreadCountAndMayDeleteThis();
-}
-
-//Configure curl's timeout property
-static bool configureCURL(HttpClient *client, HttpRequest *request, CURL *handle, char *errorBuffer) {
-    if (!handle) {
-        return false;
-    }
-
-    int32_t code;
-    code = curl_easy_setopt(handle, CURLOPT_ERRORBUFFER, errorBuffer);
-    if (code != CURLE_OK) {
-        return false;
-    }
-    // In the openharmony platform, the long type must be used, otherwise there will be an exception.
-    long timeout = static_cast<long>(request->getTimeout());
-    code = curl_easy_setopt(handle, CURLOPT_TIMEOUT, timeout);
-    if (code != CURLE_OK) {
-        return false;
-    }
-    code = curl_easy_setopt(handle, CURLOPT_CONNECTTIMEOUT, timeout);
-    if (code != CURLE_OK) {
-        return false;
-    }
-
-    ccstd::string sslCaFilename = client->getSSLVerification();
-    if (sslCaFilename.empty()) {
-        curl_easy_setopt(handle, CURLOPT_SSL_VERIFYPEER, 0L);
-        curl_easy_setopt(handle, CURLOPT_SSL_VERIFYHOST, 0L);
-    } else {
-        curl_easy_setopt(handle, CURLOPT_SSL_VERIFYPEER, 1L);
-        curl_easy_setopt(handle, CURLOPT_SSL_VERIFYHOST, 2L);
-        curl_easy_setopt(handle, CURLOPT_CAINFO, sslCaFilename.c_str());
-    }
-
-    // FIXED #3224: The subthread of CCHttpClient interrupts main thread if timeout comes.
-    // Document is here: http://curl.haxx.se/libcurl/c/curl_easy_setopt.html#CURLOPTNOSIGNAL
-    curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
-
-    curl_easy_setopt(handle, CURLOPT_ACCEPT_ENCODING, "");
-
-    return true;
-}
-
-class CURLRaii {
-    /// Instance of CURL
-    CURL *_curl;
-    /// Keeps custom header data
-    curl_slist *_headers;
-
-public:
-    CURLRaii()
-    : _curl(curl_easy_init()),
-      _headers(nullptr) {
-    }
-
-    ~CURLRaii() {
-        if (_curl)
-            curl_easy_cleanup(_curl);
-        /* free the linked list for header data */
-        if (_headers)
-            curl_slist_free_all(_headers);
-    }
-
-    template <class T>
-    bool setOption(CURLoption option, T data) {
-        return CURLE_OK == curl_easy_setopt(_curl, option, data);
-    }
-
-    /**
-     * @brief Inits CURL instance for common usage
-     * @param request Null not allowed
-     * @param callback Response write callback
-     * @param stream Response write stream
-     */
-    bool init(HttpClient *client, HttpRequest *request, write_callback callback, void *stream, write_callback headerCallback, void *headerStream, char *errorBuffer) {
-        if (!_curl)
-            return false;
-        if (!configureCURL(client, request, _curl, errorBuffer))
-            return false;
-
-        /* get custom header data (if set) */
-        ccstd::vector<ccstd::string> headers = request->getHeaders();
-        if (!headers.empty()) {
-            /* append custom headers one by one */
-            for (auto &header : headers)
-                _headers = curl_slist_append(_headers, header.c_str());
-            /* set custom headers for curl */
-            if (!setOption(CURLOPT_HTTPHEADER, _headers))
-                return false;
-        }
-        ccstd::string cookieFilename = client->getCookieFilename();
-        if (!cookieFilename.empty()) {
-            if (!setOption(CURLOPT_COOKIEFILE, cookieFilename.c_str())) {
-                return false;
-            }
-            if (!setOption(CURLOPT_COOKIEJAR, cookieFilename.c_str())) {
-                return false;
-            }
-        }
-
-        return setOption(CURLOPT_URL, request->getUrl()) && setOption(CURLOPT_WRITEFUNCTION, callback) && setOption(CURLOPT_WRITEDATA, stream) && setOption(CURLOPT_HEADERFUNCTION, headerCallback) && setOption(CURLOPT_HEADERDATA, headerStream);
-    }
-
-    /// @param responseCode Null not allowed
-    bool perform(long *responseCode) {
-        if (CURLE_OK != curl_easy_perform(_curl))
-            return false;
-        CURLcode code = curl_easy_getinfo(_curl, CURLINFO_RESPONSE_CODE, responseCode);
-        if (code != CURLE_OK || !(*responseCode >= 200 && *responseCode < 300)) {
-            CC_LOG_ERROR("Curl curl_easy_getinfo failed: %s", curl_easy_strerror(code));
-            return false;
-        }
-        // Get some mor data.
-
-        return true;
-    }
-};
-
-//Process Get Request
-static int processGetTask(HttpClient *client, HttpRequest *request, write_callback callback, void *stream, long *responseCode, write_callback headerCallback, void *headerStream, char *errorBuffer) {
-    CURLRaii curl;
-    bool ok = curl.init(client, request, callback, stream, headerCallback, headerStream, errorBuffer) && curl.setOption(CURLOPT_FOLLOWLOCATION, true) && curl.perform(responseCode);
-    return ok ? 0 : 1;
-}
-
-//Process POST Request
-static int processPostTask(HttpClient *client, HttpRequest *request, write_callback callback, void *stream, long *responseCode, write_callback headerCallback, void *headerStream, char *errorBuffer) {
-    CURLRaii curl;
-    bool ok = curl.init(client, request, callback, stream, headerCallback, headerStream, errorBuffer) && curl.setOption(CURLOPT_POST, 1) && curl.setOption(CURLOPT_POSTFIELDS, request->getRequestData()) && curl.setOption(CURLOPT_POSTFIELDSIZE, request->getRequestDataSize()) && curl.perform(responseCode);
-    return ok ? 0 : 1;
-}
-
-//Process PUT Request
-static int processPutTask(HttpClient *client, HttpRequest *request, write_callback callback, void *stream, long *responseCode, write_callback headerCallback, void *headerStream, char *errorBuffer) {
-    CURLRaii curl;
-    bool ok = curl.init(client, request, callback, stream, headerCallback, headerStream, errorBuffer) && curl.setOption(CURLOPT_CUSTOMREQUEST, "PUT") && curl.setOption(CURLOPT_POSTFIELDS, request->getRequestData()) && curl.setOption(CURLOPT_POSTFIELDSIZE, request->getRequestDataSize()) && curl.perform(responseCode);
-    return ok ? 0 : 1;
-}
-
-//Process HEAD Request
-static int processHeadTask(HttpClient *client, HttpRequest *request, write_callback callback, void *stream, long *responseCode, write_callback headerCallback, void *headerStream, char *errorBuffer) {
-    CURLRaii curl;
-    bool ok = curl.init(client, request, callback, stream, headerCallback, headerStream, errorBuffer) && curl.setOption(CURLOPT_NOBODY, "HEAD") && curl.setOption(CURLOPT_POSTFIELDS, request->getRequestData()) && curl.setOption(CURLOPT_POSTFIELDSIZE, request->getRequestDataSize()) && curl.perform(responseCode);
-    return ok ? 0 : 1;
-}
-
-//Process DELETE Request
-static int processDeleteTask(HttpClient *client, HttpRequest *request, write_callback callback, void *stream, long *responseCode, write_callback headerCallback, void *headerStream, char *errorBuffer) {
-    CURLRaii curl;
-    bool ok = curl.init(client, request, callback, stream, headerCallback, headerStream, errorBuffer) && curl.setOption(CURLOPT_CUSTOMREQUEST, "DELETE") && curl.setOption(CURLOPT_FOLLOWLOCATION, true) && curl.perform(responseCode);
-    return ok ? 0 : 1;
-}
-
-//Process PATCH Request
-static int processPatchTask(HttpClient *client, HttpRequest *request, write_callback callback, void *stream, long *responseCode, write_callback headerCallback, void *headerStream, char *errorBuffer) {
-    CURLRaii curl;
-    bool ok = curl.init(client, request, callback, stream, headerCallback, headerStream, errorBuffer) && curl.setOption(CURLOPT_CUSTOMREQUEST, "PATCH") && curl.setOption(CURLOPT_POSTFIELDS, request->getRequestData()) && curl.setOption(CURLOPT_POSTFIELDSIZE, request->getRequestDataSize()) && curl.perform(responseCode);
-    return ok ? 0 : 1;
-}
 
 // HttpClient implementation
 HttpClient *HttpClient::getInstance() {
@@ -342,11 +66,13 @@ void HttpClient::destroyInstance() {
     thiz->_scheduler.reset();
     thiz->_schedulerMutex.unlock();
 
-    thiz->_requestQueueMutex.lock();
-    thiz->_requestQueue.pushBack(thiz->_requestSentinel);
-    thiz->_requestQueueMutex.unlock();
+    // Aborts the requests in flight and drops the queued ones
+    thiz->_session->stop();
+
+    thiz->_responseQueueMutex.lock();
+    thiz->_responseQueue.clear();
+    thiz->_responseQueueMutex.unlock();
 
-    thiz->_sleepCondition.notify_one();
     thiz->decreaseThreadCountAndMayDeleteThis();
 
     CC_LOG_DEBUG("HttpClient::destroyInstance() finished!");
@@ -359,11 +85,23 @@ void HttpClient::enableCookies(const char *cookieFile) {
     } else {
         _cookieFilename = (FileUtils::getInstance()->getWritablePath() + "cookieFile.txt");
     }
+    _session->setCookieFilename(_cookieFilename);
 }
 
 void HttpClient::setSSLVerification(const ccstd::string &caFile) {
     std::lock_guard<std::mutex> lock(_sslCaFileMutex);
     _sslCaFilename = caFile;
+    _session->setSSLCaFilename(_sslCaFilename);
+}
+
+void HttpClient::setMaxConcurrentRequests(uint32_t count) {
+    _maxConcurrentRequests = count;
+    _session->setMaxConcurrentRequests(count);
+}
+
+void HttpClient::setMaxConnectionsPerHost(uint32_t count) {
+    _maxConnectionsPerHost = count;
+    _session->setMaxConnectionsPerHost(count);
 }
 
 HttpClient::HttpClient()
@@ -372,53 +110,42 @@ HttpClient::HttpClient()
   _timeoutForRead(60),
   _threadCount(0),
   _cookie(nullptr),
-  _requestSentinel(ccnew HttpRequest()) {
+  _requestSentinel(nullptr) {
     CC_LOG_DEBUG("In the constructor of HttpClient!");
-    _requestSentinel->addRef();
-    if (gThreadPool == nullptr) {
-        gThreadPool = LegacyThreadPool::newFixedThreadPool(4);
-    }
     memset(_responseMessage, 0, RESPONSE_BUFFER_SIZE * sizeof(char));
     _scheduler = CC_CURRENT_ENGINE()->getScheduler();
+
+    // Network thread
+    _session = ccnew HttpSessionCURL([this](HttpResponse *response) {
+        // add response packet into queue
+        _responseQueueMutex.lock();
+        _responseQueue.pushBack(response);
+        _responseQueueMutex.unlock();
+
+        _schedulerMutex.lock();
+        if (auto sche = _scheduler.lock()) {
+            sche->performFunctionInCocosThread(CC_CALLBACK_0(HttpClient::dispatchResponseCallbacks, this));
+        }
+        _schedulerMutex.unlock();
+    });
+    _session->setMaxConcurrentRequests(_maxConcurrentRequests);
+    _session->setMaxConnectionsPerHost(_maxConnectionsPerHost);
     increaseThreadCount();
 }
 
 HttpClient::~HttpClient() {
-    CC_SAFE_RELEASE(_requestSentinel);
+    delete _session;
     CC_LOG_DEBUG("HttpClient destructor");
 }
 
-//Lazy create semaphore & mutex & thread
-bool HttpClient::lazyInitThreadSemaphore() {
-    if (_isInited) {
-        return true;
-    } else {
-        auto t = std::thread(CC_CALLBACK_0(HttpClient::networkThread, this));
-        t.detach();
-        _isInited = true;
-    }
-
-    return true;
-}
-
 //Add a get task to queue
 void HttpClient::send(HttpRequest *request) {
-    if (false == lazyInitThreadSemaphore()) {
-        return;
-    }
-
     if (!request) {
         return;
     }
 
     request->addRef();
-
-    _requestQueueMutex.lock();
-    _requestQueue.pushBack(request);
-    _requestQueueMutex.unlock();
-
-    // Notify thread start to work
-    _sleepCondition.notify_one();
+    _session->send(request, false);
 }
 
 void HttpClient::sendImmediate(HttpRequest *request) {
@@ -426,12 +153,9 @@ void HttpClient::sendImmediate(HttpRequest *request) {
         return;
     }
 
+    // Skips the queue, it still counts in the concurrent requests
     request->addRef();
-    // Create a HttpResponse object, the default setting is http access failed
-    HttpResponse *response = ccnew HttpResponse(request);
-    response->addRef(); // NOTE: RefCounted object's reference count is changed to 0 now. so needs to addRef after ccnew.
-
-    gThreadPool->pushTask([this, request, response](int /*tid*/) { HttpClient::networkThreadAlone(request, response); });
+    _session->send(request, true);
 }
 
 // Poll and notify main thread if responses exists in queue
@@ -461,89 +185,6 @@ void HttpClient::dispatchResponseCallbacks() {
     }
 }
 
-// Process Response
-void HttpClient::processResponse(HttpResponse *response, char *responseMessage) {
-    auto request = response->getHttpRequest();
-    long responseCode = -1;
-    int retValue = 0;
-
-    // Process the request -> get response packet
-    switch (request->getRequestType()) {
-        case HttpRequest::Type::GET: // HTTP GET
-            retValue = processGetTask(this, request,
-                                      writeData,
-                                      response->getResponseData(),
-                                      &responseCode,
-                                      writeHeaderData,
-                                      response->getResponseHeader(),
-                                      responseMessage);
-            break;
-
-        case HttpRequest::Type::POST: // HTTP POST
-            retValue = processPostTask(this, request,
-                                       writeData,
-                                       response->getResponseData(),
-                                       &responseCode,
-                                       writeHeaderData,
-                                       response->getResponseHeader(),
-                                       responseMessage);
-            break;
-
-        case HttpRequest::Type::PUT:
-            retValue = processPutTask(this, request,
-                                      writeData,
-                                      response->getResponseData(),
-                                      &responseCode,
-                                      writeHeaderData,
-                                      response->getResponseHeader(),
-                                      responseMessage);
-            break;
-
-        case HttpRequest::Type::HEAD:
-            retValue = processHeadTask(this, request,
-                                       writeData,
-                                       response->getResponseData(),
-                                       &responseCode,
-                                       writeHeaderData,
-                                       response->getResponseHeader(),
-                                       responseMessage);
-            break;
-
-        case HttpRequest::Type::DELETE:
-            retValue = processDeleteTask(this, request,
-                                         writeData,
-                                         response->getResponseData(),
-                                         &responseCode,
-                                         writeHeaderData,
-                                         response->getResponseHeader(),
-                                         responseMessage);
-            break;
-
-        case HttpRequest::Type::PATCH:
-            retValue = processPatchTask(this, request,
-                                      writeData,
-                                      response->getResponseData(),
-                                      &responseCode,
-                                      writeHeaderData,
-                                      response->getResponseHeader(),
-                                      responseMessage);
-            break;
-
-        default:
-            CC_ABORT();
-            break;
-    }
-
-    // write data to HttpResponse
-    response->setResponseCode(responseCode);
-    if (retValue != 0) {
-        response->setSucceed(false);
-        response->setErrorBuffer(responseMessage);
-    } else {
-        response->setSucceed(true);
-    }
-}
-
 void HttpClient::increaseThreadCount() {
     _threadCountMutex.lock();
     ++_threadCount;
@@ -43,6 +43,8 @@ namespace cc {
 class Scheduler;
 namespace network {
 
+class HttpSessionCURL;
+
 /** Singleton that handles asynchronous http requests.
  *
  * Once the request completed, a callback will issued in main thread when it provided during make request.
@@ -112,6 +114,27 @@ public:
      */
     void sendImmediate(HttpRequest *request);
 
+    /**
+     * Set the maximum count of requests in flight at the same time, the others wait in the queue.
+     * Only the curl based client limits them.
+     *
+     * @param count the maximum count, 0 for no limit.
+     */
+    void setMaxConcurrentRequests(uint32_t count);
+
+    uint32_t getMaxConcurrentRequests() const { return _maxConcurrentRequests; }
+
+    /**
+     * Set the maximum count of connections open to a single host. They are kept alive and reused,
+     * and requests are multiplexed on them over HTTP/2 when the server supports it.
+     * Only the curl based client limits them.
+     *
+     * @param count the maximum count, 0 for no limit.
+     */
+    void setMaxConnectionsPerHost(uint32_t count);
+
+    uint32_t getMaxConnectionsPerHost() const { return _maxConnectionsPerHost; }
+
     HttpCookie *getCookie() const { return _cookie; }
 
     std::mutex &getCookieFileMutex() { return _cookieFileMutex; }
@@ -171,6 +194,11 @@ private: // NOLINT(readability-redundant-access-specifiers)
     char _responseMessage[RESPONSE_BUFFER_SIZE];
 
     HttpRequest *_requestSentinel;
+
+    uint32_t _maxConcurrentRequests{16};
+    uint32_t _maxConnectionsPerHost{6};
+    // transfers the requests of the curl based client
+    HttpSessionCURL *_session{nullptr};
 };
 
 } // namespace network
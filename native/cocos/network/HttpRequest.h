@@ -32,6 +32,7 @@
 
 #include <functional>
 #include "base/std/container/string.h"
+#include "base/std/container/vector.h"
 
 /**
  * @addtogroup network
@@ -46,6 +47,7 @@ class HttpClient;
 class HttpResponse;
 
 using ccHttpRequestCallback = std::function<void(HttpClient *, HttpResponse *)>;
+using ccHttpResponseSink = std::function<bool(const char *data, size_t size)>;
 
 /**
  * Defines the object which users must packed for HttpClient::send(HttpRequest*) method.
@@ -238,6 +240,26 @@ public:
         return _headers;
     }
 
+    /**
+     * Set a sink receiving the response body while it arrives, instead of collecting it in HttpResponse::getResponseData().
+     * It's called in the network thread, returning false cancels the request.
+     * Only the curl based HttpClient streams into the sink, the others still collect the body.
+     *
+     * @param sink the ccHttpResponseSink function.
+     */
+    inline void setResponseSink(const ccHttpResponseSink &sink) {
+        _responseSink = sink;
+    }
+
+    /**
+     * Get the response sink.
+     *
+     * @return const ccHttpResponseSink& the response sink, empty if the body is collected.
+     */
+    inline const ccHttpResponseSink &getResponseSink() const {
+        return _responseSink;
+    }
+
     inline void setTimeout(float timeoutInSeconds) {
         _timeoutInSeconds = timeoutInSeconds;
     }
@@ -253,6 +275,7 @@ protected:
     ccstd::vector<char> _requestData;      /// used for POST
     ccstd::string _tag;                    /// user defined tag, to identify different requests in response callback
     ccHttpRequestCallback _callback;       /// C++11 style callbacks
+    ccHttpResponseSink _responseSink;      /// receives the response body when set
     void *_userData{nullptr};              /// You can add your customed data here
     ccstd::vector<ccstd::string> _headers; /// custom http headers
     float _timeoutInSeconds{10.F};
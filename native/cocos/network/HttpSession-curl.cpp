@@ -0,0 +1,433 @@
+/****************************************************************************
+ Copyright (c) 2017-2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+
+#include "network/HttpSession-curl.h"
+
+#include <curl/curl.h>
+#include <algorithm>
+#include <cstring>
+#include "base/Log.h"
+#include "base/memory/Memory.h"
+#include "base/std/container/vector.h"
+
+#ifndef CC_CURL_POLL_TIMEOUT_MS
+    #define CC_CURL_POLL_TIMEOUT_MS 50
+#endif
+
+// curl_multi_poll and curl_multi_wakeup since curl 7.68
+#if LIBCURL_VERSION_NUM >= 0x074400
+    #define CC_CURL_MULTI_WAKEUP 1
+#endif
+
+namespace cc {
+namespace network {
+
+struct HttpSessionCURL::Transfer {
+    HttpRequest *request{nullptr};
+    HttpResponse *response{nullptr};
+    CURL *handle{nullptr};
+    curl_slist *headers{nullptr};
+    bool cookies{false};
+    char errorBuffer[CURL_ERROR_SIZE]{};
+};
+
+namespace {
+
+// idle easy handles kept for the next requests, they keep no connection of their own
+constexpr size_t MAX_IDLE_HANDLES = 16;
+
+// Callback function used by libcurl for collect response data
+size_t writeData(void *ptr, size_t size, size_t nmemb, void *userdata) {
+    auto *response = static_cast<HttpResponse *>(userdata);
+    const size_t sizes = size * nmemb;
+
+    const auto &sink = response->getHttpRequest()->getResponseSink();
+    if (sink) {
+        // returning less than sizes aborts the transfer
+        return sink(static_cast<const char *>(ptr), sizes) ? sizes : 0;
+    }
+
+    auto *recvBuffer = response->getResponseData();
+    recvBuffer->insert(recvBuffer->end(), static_cast<char *>(ptr), static_cast<char *>(ptr) + sizes);
+    return sizes;
+}
+
+// Callback function used by libcurl for collect header data
+size_t writeHeaderData(void *ptr, size_t size, size_t nmemb, void *userdata) {
+    auto *recvBuffer = static_cast<HttpResponse *>(userdata)->getResponseHeader();
+    const size_t sizes = size * nmemb;
+    recvBuffer->insert(recvBuffer->end(), static_cast<char *>(ptr), static_cast<char *>(ptr) + sizes);
+    return sizes;
+}
+
+template <class T>
+bool setOption(CURL *handle, CURLoption option, T data) {
+    return CURLE_OK == curl_easy_setopt(handle, option, data);
+}
+
+bool setRequestData(CURL *handle, HttpRequest *request) {
+    return setOption(handle, CURLOPT_POSTFIELDS, request->getRequestData()) &&
+           setOption(handle, CURLOPT_POSTFIELDSIZE, static_cast<long>(request->getRequestDataSize()));
+}
+
+bool setupHandle(CURL *handle, HttpResponse *response, curl_slist *&headers, char *errorBuffer,
+                 const ccstd::string &cookieFilename, const ccstd::string &sslCaFilename) {
+    auto *request = response->getHttpRequest();
+
+    // In the openharmony platform, the long type must be used, otherwise there will be an exception.
+    const auto timeout = static_cast<long>(request->getTimeout());
+    if (!setOption(handle, CURLOPT_ERRORBUFFER, errorBuffer) ||
+        !setOption(handle, CURLOPT_TIMEOUT, timeout) ||
+        !setOption(handle, CURLOPT_CONNECTTIMEOUT, timeout)) {
+        return false;
+    }
+
+    if (sslCaFilename.empty()) {
+        curl_easy_setopt(handle, CURLOPT_SSL_VERIFYPEER, 0L);
+        curl_easy_setopt(handle, CURLOPT_SSL_VERIFYHOST, 0L);
+    } else {
+        curl_easy_setopt(handle, CURLOPT_SSL_VERIFYPEER, 1L);
+        curl_easy_setopt(handle, CURLOPT_SSL_VERIFYHOST, 2L);
+        curl_easy_setopt(handle, CURLOPT_CAINFO, sslCaFilename.c_str());
+    }
+
+    // FIXED #3224: The subthread of CCHttpClient interrupts main thread if timeout comes.
+    // Document is here: http://curl.haxx.se/libcurl/c/curl_easy_setopt.html#CURLOPTNOSIGNAL
+    curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(handle, CURLOPT_ACCEPT_ENCODING, "");
+
+    // HTTP/2 over TLS when both ends support it, it falls back to HTTP/1.1 otherwise.
+    // A https request waits for a connection it can be multiplexed on rather than opening another one,
+    // cleartext requests are HTTP/1.1 and would wait for the requests in flight to finish.
+    curl_easy_setopt(handle, CURLOPT_HTTP_VERSION, static_cast<long>(CURL_HTTP_VERSION_2TLS));
+    if (strncmp(request->getUrl(), "https://", 8) == 0) {
+        curl_easy_setopt(handle, CURLOPT_PIPEWAIT, 1L);
+    }
+    curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+
+    for (const auto &header : request->getHeaders()) {
+        headers = curl_slist_append(headers, header.c_str());
+    }
+    if (headers != nullptr && !setOption(handle, CURLOPT_HTTPHEADER, headers)) {
+        return false;
+    }
+
+    if (!cookieFilename.empty()) {
+        if (!setOption(handle, CURLOPT_COOKIEFILE, cookieFilename.c_str()) ||
+            !setOption(handle, CURLOPT_COOKIEJAR, cookieFilename.c_str())) {
+            return false;
+        }
+    }
+
+    if (!setOption(handle, CURLOPT_URL, request->getUrl()) ||
+        !setOption(handle, CURLOPT_WRITEFUNCTION, writeData) ||
+        !setOption(handle, CURLOPT_WRITEDATA, static_cast<void *>(response)) ||
+        !setOption(handle, CURLOPT_HEADERFUNCTION, writeHeaderData) ||
+        !setOption(handle, CURLOPT_HEADERDATA, static_cast<void *>(response))) {
+        return false;
+    }
+
+    switch (request->getRequestType()) {
+        case HttpRequest::Type::GET:
+            return setOption(handle, CURLOPT_FOLLOWLOCATION, 1L);
+        case HttpRequest::Type::POST:
+            return setOption(handle, CURLOPT_POST, 1L) && setRequestData(handle, request);
+        case HttpRequest::Type::PUT:
+            return setOption(handle, CURLOPT_CUSTOMREQUEST, "PUT") && setRequestData(handle, request);
+        case HttpRequest::Type::HEAD:
+            return setOption(handle, CURLOPT_NOBODY, 1L) && setRequestData(handle, request);
+        case HttpRequest::Type::DELETE:
+            return setOption(handle, CURLOPT_CUSTOMREQUEST, "DELETE") && setOption(handle, CURLOPT_FOLLOWLOCATION, 1L);
+        case HttpRequest::Type::PATCH:
+            return setOption(handle, CURLOPT_CUSTOMREQUEST, "PATCH") && setRequestData(handle, request);
+        default:
+            CC_LOG_ERROR("HttpSessionCURL: unknown request type of %s", request->getUrl());
+            return false;
+    }
+}
+
+} // namespace
+
+HttpSessionCURL::HttpSessionCURL(const CompletionCallback &callback)
+: _callback(callback) {
+}
+
+HttpSessionCURL::~HttpSessionCURL() {
+    stop();
+}
+
+void HttpSessionCURL::send(HttpRequest *request, bool immediate) {
+    if (request == nullptr) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_stopped) {
+        request->release();
+        return;
+    }
+    if (immediate) {
+        _immediateQueue.push_back(request);
+    } else {
+        _requestQueue.push_back(request);
+    }
+    if (!_thread.joinable()) {
+        _thread = std::thread(&HttpSessionCURL::networkThread, this);
+    }
+    wakeUp();
+}
+
+void HttpSessionCURL::stop() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopped = true;
+        wakeUp();
+    }
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (auto *request : _immediateQueue) {
+        request->release();
+    }
+    for (auto *request : _requestQueue) {
+        request->release();
+    }
+    _immediateQueue.clear();
+    _requestQueue.clear();
+}
+
+void HttpSessionCURL::setMaxConcurrentRequests(uint32_t count) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _maxConcurrentRequests = count;
+    _limitsDirty = true;
+    wakeUp();
+}
+
+uint32_t HttpSessionCURL::getMaxConcurrentRequests() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _maxConcurrentRequests;
+}
+
+void HttpSessionCURL::setMaxConnectionsPerHost(uint32_t count) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _maxConnectionsPerHost = count;
+    _limitsDirty = true;
+    wakeUp();
+}
+
+uint32_t HttpSessionCURL::getMaxConnectionsPerHost() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _maxConnectionsPerHost;
+}
+
+void HttpSessionCURL::setCookieFilename(const ccstd::string &filename) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _cookieFilename = filename;
+}
+
+void HttpSessionCURL::setSSLCaFilename(const ccstd::string &filename) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _sslCaFilename = filename;
+}
+
+// Called with _mutex locked
+void HttpSessionCURL::wakeUp() {
+#if CC_CURL_MULTI_WAKEUP
+    if (_multiHandle != nullptr) {
+        curl_multi_wakeup(static_cast<CURLM *>(_multiHandle));
+    }
+#endif
+    _sleepCondition.notify_one();
+}
+
+// Network thread
+void HttpSessionCURL::networkThread() {
+    CURLM *multiHandle = curl_multi_init();
+    if (multiHandle == nullptr) {
+        CC_LOG_ERROR("HttpSessionCURL: curl_multi_init failed");
+        return;
+    }
+    // The connection cache of the multi handle is shared by all the transfers
+    curl_multi_setopt(multiHandle, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _multiHandle = multiHandle;
+    }
+
+    ccstd::vector<Transfer *> transfers;
+    ccstd::vector<HttpRequest *> requests;
+    ccstd::vector<CURL *> idleHandles;
+    ccstd::string cookieFilename;
+    ccstd::string sslCaFilename;
+
+    auto finishTransfer = [&](Transfer *transfer, CURLcode result) {
+        auto *response = transfer->response;
+        long responseCode = -1;
+        bool succeed = false;
+        if (result == CURLE_OK) {
+            curl_easy_getinfo(transfer->handle, CURLINFO_RESPONSE_CODE, &responseCode);
+            succeed = responseCode >= 200 && responseCode < 300;
+        }
+        response->setResponseCode(responseCode);
+        response->setSucceed(succeed);
+        if (!succeed) {
+            response->setErrorBuffer(transfer->errorBuffer[0] != '\0' || result == CURLE_OK ? transfer->errorBuffer : curl_easy_strerror(result));
+        }
+
+        if (transfer->handle != nullptr) {
+            if (transfer->cookies) {
+                // the cookie jar is only written on cleanup otherwise
+                curl_easy_setopt(transfer->handle, CURLOPT_COOKIELIST, "FLUSH");
+            }
+            if (idleHandles.size() < MAX_IDLE_HANDLES) {
+                idleHandles.push_back(transfer->handle);
+            } else {
+                curl_easy_cleanup(transfer->handle);
+            }
+        }
+        if (transfer->headers != nullptr) {
+            curl_slist_free_all(transfer->headers);
+        }
+        delete transfer;
+
+        _callback(response);
+    };
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _sleepCondition.wait(lock, [&]() {
+                return _stopped || !transfers.empty() || !_immediateQueue.empty() || !_requestQueue.empty();
+            });
+            if (_stopped) {
+                break;
+            }
+
+            if (_limitsDirty) {
+                curl_multi_setopt(multiHandle, CURLMOPT_MAX_HOST_CONNECTIONS, static_cast<long>(_maxConnectionsPerHost));
+                curl_multi_setopt(multiHandle, CURLMOPT_MAXCONNECTS, static_cast<long>(std::max(_maxConcurrentRequests, _maxConnectionsPerHost)));
+                _limitsDirty = false;
+            }
+
+            // immediate requests never wait for a free slot, they only take slots from the queued ones
+            requests.insert(requests.end(), _immediateQueue.begin(), _immediateQueue.end());
+            _immediateQueue.clear();
+            while (!_requestQueue.empty() && (_maxConcurrentRequests == 0 || transfers.size() + requests.size() < _maxConcurrentRequests)) {
+                requests.push_back(_requestQueue.front());
+                _requestQueue.pop_front();
+            }
+            if (!requests.empty()) {
+                cookieFilename = _cookieFilename;
+                sslCaFilename = _sslCaFilename;
+            }
+        }
+
+        for (auto *request : requests) {
+            auto *transfer = ccnew Transfer;
+            transfer->request = request;
+            // Create a HttpResponse object, the default setting is http access failed
+            transfer->response = ccnew HttpResponse(request);
+            transfer->response->addRef(); // NOTE: RefCounted object's reference count is changed to 0 now. so needs to addRef after ccnew.
+            transfer->cookies = !cookieFilename.empty();
+
+            if (idleHandles.empty()) {
+                transfer->handle = curl_easy_init();
+            } else {
+                transfer->handle = idleHandles.back();
+                idleHandles.pop_back();
+                curl_easy_reset(transfer->handle);
+            }
+
+            if (transfer->handle == nullptr ||
+                !setupHandle(transfer->handle, transfer->response, transfer->headers, transfer->errorBuffer, cookieFilename, sslCaFilename) ||
+                !setOption(transfer->handle, CURLOPT_PRIVATE, static_cast<void *>(transfer)) ||
+                curl_multi_add_handle(multiHandle, transfer->handle) != CURLM_OK) {
+                finishTransfer(transfer, CURLE_FAILED_INIT);
+                continue;
+            }
+            transfers.push_back(transfer);
+        }
+        requests.clear();
+
+        int runningHandles = 0;
+        CURLMcode mcode = curl_multi_perform(multiHandle, &runningHandles);
+        if (mcode != CURLM_OK) {
+            CC_LOG_ERROR("HttpSessionCURL: curl_multi_perform failed: %s", curl_multi_strerror(mcode));
+        }
+
+        bool finished = false;
+        int messagesInQueue = 0;
+        while (CURLMsg *message = curl_multi_info_read(multiHandle, &messagesInQueue)) {
+            if (message->msg != CURLMSG_DONE) {
+                continue;
+            }
+            CURL *handle = message->easy_handle;
+            const CURLcode result = message->data.result;
+            char *privateData = nullptr;
+            curl_easy_getinfo(handle, CURLINFO_PRIVATE, &privateData);
+            auto *transfer = reinterpret_cast<Transfer *>(privateData);
+
+            curl_multi_remove_handle(multiHandle, handle);
+            transfers.erase(std::find(transfers.begin(), transfers.end(), transfer));
+            finishTransfer(transfer, result);
+            finished = true;
+        }
+
+        // slots were freed, start the queued requests before waiting
+        if (!finished && !transfers.empty()) {
+#if CC_CURL_MULTI_WAKEUP
+            curl_multi_poll(multiHandle, nullptr, 0, 1000, nullptr);
+#else
+            curl_multi_wait(multiHandle, nullptr, 0, CC_CURL_POLL_TIMEOUT_MS, nullptr);
+#endif
+        }
+    }
+
+    // stopped: abort the requests in flight without calling back
+    for (auto *transfer : transfers) {
+        curl_multi_remove_handle(multiHandle, transfer->handle);
+        curl_easy_cleanup(transfer->handle);
+        if (transfer->headers != nullptr) {
+            curl_slist_free_all(transfer->headers);
+        }
+        transfer->response->release();
+        transfer->request->release();
+        delete transfer;
+    }
+    for (auto *handle : idleHandles) {
+        curl_easy_cleanup(handle);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _multiHandle = nullptr;
+    }
+    curl_multi_cleanup(multiHandle);
+}
+
+} // namespace network
+} // namespace cc
@@ -0,0 +1,110 @@
+/****************************************************************************
+ Copyright (c) 2017-2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include "base/Macros.h"
+#include "base/std/container/deque.h"
+#include "base/std/container/string.h"
+#include "network/HttpRequest.h"
+#include "network/HttpResponse.h"
+
+namespace cc {
+namespace network {
+
+/**
+ * Transfers http requests concurrently on one curl multi handle, in a thread of its own.
+ *
+ * Connections are kept alive and reused per host, and requests to the same host are multiplexed
+ * over HTTP/2 when the server and libcurl support it. Requests beyond the concurrency limit wait
+ * in the queue, so a slow endpoint only holds its own slot.
+ */
+class CC_DLL HttpSessionCURL {
+public:
+    // Called in the network thread with each finished request's response, see send().
+    using CompletionCallback = std::function<void(HttpResponse *response)>;
+
+    static constexpr uint32_t DEFAULT_MAX_CONCURRENT_REQUESTS = 16;
+    static constexpr uint32_t DEFAULT_MAX_CONNECTIONS_PER_HOST = 6;
+
+    explicit HttpSessionCURL(const CompletionCallback &callback);
+    ~HttpSessionCURL();
+
+    /**
+     * Queues a request. Immediate requests are started right away, even past the concurrency
+     * limit, the others wait for a free slot.
+     * The session takes over one reference to request. The response passed to the callback holds
+     * a reference of its own and the one to the request, the callback takes both over.
+     */
+    void send(HttpRequest *request, bool immediate);
+
+    /**
+     * Aborts the requests in flight and waits for the thread to exit, no callback is called afterwards.
+     */
+    void stop();
+
+    // 0 for no limit
+    void setMaxConcurrentRequests(uint32_t count);
+    uint32_t getMaxConcurrentRequests() const;
+    // 0 for no limit
+    void setMaxConnectionsPerHost(uint32_t count);
+    uint32_t getMaxConnectionsPerHost() const;
+
+    void setCookieFilename(const ccstd::string &filename);
+    // An empty file disables SSL verification
+    void setSSLCaFilename(const ccstd::string &filename);
+
+private:
+    struct Transfer;
+
+    void networkThread();
+    void wakeUp();
+
+    CompletionCallback _callback;
+
+    std::thread _thread;
+    mutable std::mutex _mutex;
+    std::condition_variable _sleepCondition;
+    ccstd::deque<HttpRequest *> _requestQueue;
+    ccstd::deque<HttpRequest *> _immediateQueue;
+    // the curl multi handle, while the thread is running
+    void *_multiHandle{nullptr};
+    bool _stopped{false};
+
+    uint32_t _maxConcurrentRequests{DEFAULT_MAX_CONCURRENT_REQUESTS};
+    uint32_t _maxConnectionsPerHost{DEFAULT_MAX_CONNECTIONS_PER_HOST};
+    bool _limitsDirty{true};
+    ccstd::string _cookieFilename;
+    ccstd::string _sslCaFilename;
+
+    CC_DISALLOW_COPY_MOVE_ASSIGN(HttpSessionCURL);
+};
+
+} // namespace network
+} // namespace cc
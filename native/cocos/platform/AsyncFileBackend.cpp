@@ -0,0 +1,214 @@
+/****************************************************************************
+ Copyright (c) 2017-2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+
+#include "platform/AsyncFileBackend.h"
+
+#include <cerrno>
+#include <thread>
+#include <utility>
+
+#if (CC_PLATFORM != CC_PLATFORM_WINDOWS) && (CC_PLATFORM != CC_PLATFORM_WINRT)
+    #include <fcntl.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #define CC_ASYNC_FILE_POSIX 1
+#endif
+
+namespace cc {
+
+void AsyncFileRequestQueue::push(ccstd::vector<AsyncFileRequest> &&requests) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (auto &request : requests) {
+            const uint32_t id = request.id;
+            _index[id] = _requests.insert(std::move(request)).first;
+        }
+    }
+    if (requests.size() == 1) {
+        _cv.notify_one();
+    } else {
+        _cv.notify_all();
+    }
+}
+
+AsyncFileRequest AsyncFileRequestQueue::take(RequestSet::iterator iter) {
+    // set elements are const, the request is not used by the set after being erased
+    AsyncFileRequest request = std::move(const_cast<AsyncFileRequest &>(*iter));
+    _index.erase(request.id);
+    _requests.erase(iter);
+    return request;
+}
+
+bool AsyncFileRequestQueue::pop(AsyncFileRequest *request) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _cv.wait(lock, [this]() { return _closed || !_requests.empty(); });
+    if (_closed) {
+        return false;
+    }
+    *request = take(_requests.begin());
+    return true;
+}
+
+size_t AsyncFileRequestQueue::tryPop(ccstd::vector<AsyncFileRequest> *requests, size_t maxCount) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    size_t count = 0;
+    while (count < maxCount && !_requests.empty()) {
+        requests->push_back(take(_requests.begin()));
+        ++count;
+    }
+    return count;
+}
+
+bool AsyncFileRequestQueue::remove(uint32_t id) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto iter = _index.find(id);
+    if (iter == _index.end()) {
+        return false;
+    }
+    _requests.erase(iter->second);
+    _index.erase(iter);
+    return true;
+}
+
+void AsyncFileRequestQueue::clear() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _requests.clear();
+    _index.clear();
+}
+
+void AsyncFileRequestQueue::close() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _closed = true;
+    }
+    _cv.notify_all();
+}
+
+FileUtils::Status readWholeFile(const ccstd::string &path, Data *data) {
+#if CC_ASYNC_FILE_POSIX
+    // files on the file system are read directly, FileUtils is only needed for packed assets
+    if (!path.empty() && path[0] == '/') {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd == -1) {
+            return errno == ENOENT ? FileUtils::Status::NOT_EXISTS : FileUtils::Status::OPEN_FAILED;
+        }
+        struct stat statBuf;
+        if (fstat(fd, &statBuf) == -1) {
+            ::close(fd);
+            return FileUtils::Status::OBTAIN_SIZE_FAILED;
+        }
+        if (static_cast<uint64_t>(statBuf.st_size) > UINT32_MAX) {
+            ::close(fd);
+            return FileUtils::Status::TOO_LARGE;
+        }
+        const auto size = static_cast<size_t>(statBuf.st_size);
+        if (size == 0) {
+            ::close(fd);
+            data->clear();
+            return FileUtils::Status::OK;
+        }
+        data->resize(static_cast<uint32_t>(size));
+        size_t offset = 0;
+        while (offset < size) {
+            const ssize_t n = ::read(fd, data->getBytes() + offset, size - offset);
+            if (n <= 0) {
+                if (n == -1 && errno == EINTR) {
+                    continue;
+                }
+                break;
+            }
+            offset += static_cast<size_t>(n);
+        }
+        ::close(fd);
+        if (offset < size) {
+            data->clear();
+            return FileUtils::Status::READ_FAILED;
+        }
+        return FileUtils::Status::OK;
+    }
+#endif
+    // full paths resolve without touching the path cache, so getContents is safe to call here
+    auto *fs = FileUtils::getInstance();
+    if (!fs) {
+        return FileUtils::Status::NOT_INITIALIZED;
+    }
+    return fs->getContents(path, data);
+}
+
+namespace {
+
+class ThreadPoolFileBackend final : public AsyncFileBackend {
+public:
+    ThreadPoolFileBackend(uint32_t threadCount, AsyncFileCompletion &&completion)
+    : _completion(std::move(completion)) {
+        _workers.reserve(threadCount);
+        for (uint32_t i = 0; i < threadCount; ++i) {
+            _workers.emplace_back([this]() { work(); });
+        }
+    }
+
+    ~ThreadPoolFileBackend() override {
+        _queue.close();
+        for (auto &worker : _workers) {
+            worker.join();
+        }
+    }
+
+    void submit(ccstd::vector<AsyncFileRequest> &&requests) override {
+        _queue.push(std::move(requests));
+    }
+
+    bool cancel(uint32_t id) override {
+        return _queue.remove(id);
+    }
+
+    void cancelAll() override {
+        _queue.clear();
+    }
+
+private:
+    void work() {
+        AsyncFileRequest request;
+        while (_queue.pop(&request)) {
+            Data data;
+            const FileUtils::Status status = readWholeFile(request.path, &data);
+            _completion(request.id, status, std::move(data));
+        }
+    }
+
+    AsyncFileRequestQueue _queue;
+    AsyncFileCompletion _completion;
+    ccstd::vector<std::thread> _workers;
+
+    CC_DISALLOW_COPY_MOVE_ASSIGN(ThreadPoolFileBackend);
+};
+
+} // namespace
+
+std::unique_ptr<AsyncFileBackend> createThreadPoolFileBackend(uint32_t threadCount, AsyncFileCompletion &&completion) {
+    return std::make_unique<ThreadPoolFileBackend>(threadCount, std::move(completion));
+}
+
+} // namespace cc
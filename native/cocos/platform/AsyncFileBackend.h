@@ -0,0 +1,110 @@
+/****************************************************************************
+ Copyright (c) 2017-2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include "base/Data.h"
+#include "base/Macros.h"
+#include "base/std/container/set.h"
+#include "base/std/container/string.h"
+#include "base/std/container/unordered_map.h"
+#include "base/std/container/vector.h"
+#include "platform/FileUtils.h"
+
+namespace cc {
+
+// Backends of AsyncFileReader, not meant to be used directly.
+
+struct AsyncFileRequest {
+    uint32_t id{0};
+    uint8_t priority{0};
+    uint64_t sequence{0}; // submission order, keeps requests of the same priority FIFO
+    ccstd::string path;   // resolved full path
+};
+
+// invoked on a backend thread for every request that was not cancelled before it started
+using AsyncFileCompletion = std::function<void(uint32_t id, FileUtils::Status status, Data &&data)>;
+
+/**
+ * Pending requests ordered by priority, then by submission order.
+ * Thread safe, requests can be removed until they are popped.
+ */
+class AsyncFileRequestQueue final {
+public:
+    AsyncFileRequestQueue() = default;
+
+    void push(ccstd::vector<AsyncFileRequest> &&requests);
+    // blocks until a request is available or the queue is closed, returns false once closed
+    bool pop(AsyncFileRequest *request);
+    // pops up to maxCount requests without blocking
+    size_t tryPop(ccstd::vector<AsyncFileRequest> *requests, size_t maxCount);
+    bool remove(uint32_t id);
+    void clear();
+    void close();
+
+private:
+    struct Order {
+        bool operator()(const AsyncFileRequest &lhs, const AsyncFileRequest &rhs) const {
+            return lhs.priority != rhs.priority ? lhs.priority > rhs.priority : lhs.sequence < rhs.sequence;
+        }
+    };
+    using RequestSet = ccstd::set<AsyncFileRequest, Order>;
+
+    AsyncFileRequest take(RequestSet::iterator iter);
+
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    RequestSet _requests;
+    ccstd::unordered_map<uint32_t, RequestSet::iterator> _index;
+    bool _closed{false};
+
+    CC_DISALLOW_COPY_MOVE_ASSIGN(AsyncFileRequestQueue);
+};
+
+class AsyncFileBackend {
+public:
+    virtual ~AsyncFileBackend() = default;
+
+    virtual void submit(ccstd::vector<AsyncFileRequest> &&requests) = 0;
+    // returns true if the request was removed before it started, its completion will not be invoked
+    virtual bool cancel(uint32_t id) = 0;
+    virtual void cancelAll() = 0;
+};
+
+// reads the whole file at a full path with blocking calls, thread safe
+FileUtils::Status readWholeFile(const ccstd::string &path, Data *data);
+
+std::unique_ptr<AsyncFileBackend> createThreadPoolFileBackend(uint32_t threadCount, AsyncFileCompletion &&completion);
+#if CC_PLATFORM == CC_PLATFORM_LINUX
+// returns nullptr if io_uring is not available, e.g. on old kernels or when blocked by seccomp
+std::unique_ptr<AsyncFileBackend> createIOUringFileBackend(AsyncFileCompletion &&completion);
+#endif
+
+} // namespace cc
@@ -0,0 +1,183 @@
+/****************************************************************************
+ Copyright (c) 2017-2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+
+#include "platform/AsyncFileReader.h"
+
+#include <mutex>
+#include <utility>
+#include "application/ApplicationManager.h"
+#include "base/Scheduler.h"
+#include "platform/AsyncFileBackend.h"
+
+namespace cc {
+
+namespace {
+// reads are bound by the storage, a few threads are enough to keep it busy
+constexpr uint32_t READER_THREAD_COUNT = 4;
+} // namespace
+
+struct AsyncFileReader::SharedState {
+    Dispatcher dispatcher;
+
+    std::mutex mutex;
+    ccstd::vector<Completion> completions;
+    bool deliveryScheduled{false};
+
+    // only touched on the main thread
+    ccstd::unordered_map<RequestId, Callback> callbacks;
+    bool closed{false};
+};
+
+AsyncFileReader::AsyncFileReader(Dispatcher dispatcher, bool useIOUring)
+: _state(std::make_shared<SharedState>()) {
+    if (!dispatcher) {
+        std::weak_ptr<Scheduler> weakScheduler = CC_CURRENT_ENGINE()->getScheduler();
+        dispatcher = [weakScheduler](std::function<void()> &&func) {
+            if (auto scheduler = weakScheduler.lock()) {
+                scheduler->performFunctionInCocosThread(func);
+            }
+        };
+    }
+    _state->dispatcher = std::move(dispatcher);
+
+    std::weak_ptr<SharedState> weakState = _state;
+    AsyncFileCompletion completion = [weakState](uint32_t id, FileUtils::Status status, Data &&data) {
+        if (auto state = weakState.lock()) {
+            postCompletion(state, id, status, std::move(data));
+        }
+    };
+#if CC_PLATFORM == CC_PLATFORM_LINUX
+    if (useIOUring) {
+        _backend = createIOUringFileBackend(AsyncFileCompletion(completion));
+        _usingIOUring = _backend != nullptr;
+    }
+#else
+    CC_UNUSED_PARAM(useIOUring);
+#endif
+    if (!_backend) {
+        _backend = createThreadPoolFileBackend(READER_THREAD_COUNT, std::move(completion));
+    }
+}
+
+AsyncFileReader::~AsyncFileReader() {
+    _state->closed = true;
+    _state->callbacks.clear();
+    // joins the backend threads, completions still in flight are dropped by the closed state
+    _backend.reset();
+}
+
+AsyncFileReader::RequestId AsyncFileReader::read(const ccstd::string &filename, Callback callback, Priority priority) {
+    ccstd::vector<ReadRequest> requests;
+    requests.push_back({filename, std::move(callback), priority});
+    return readBatch(std::move(requests)).front();
+}
+
+ccstd::vector<AsyncFileReader::RequestId> AsyncFileReader::readBatch(ccstd::vector<ReadRequest> &&requests) {
+    ccstd::vector<RequestId> ids;
+    ids.reserve(requests.size());
+    ccstd::vector<AsyncFileRequest> submitted;
+    submitted.reserve(requests.size());
+
+    auto *fs = FileUtils::getInstance();
+    for (auto &request : requests) {
+        const RequestId id = _nextId++;
+        if (_nextId == INVALID_REQUEST) {
+            _nextId = 1;
+        }
+        ids.push_back(id);
+        _state->callbacks.emplace(id, std::move(request.callback));
+
+        // fullPathForFilename is not thread safe, so paths are resolved before leaving the main thread
+        ccstd::string path = fs ? fs->fullPathForFilename(request.filename) : request.filename;
+        if (path.empty()) {
+            postCompletion(_state, id, FileUtils::Status::NOT_EXISTS, Data());
+            continue;
+        }
+        submitted.push_back({id, static_cast<uint8_t>(request.priority), _nextSequence++, std::move(path)});
+    }
+
+    if (!submitted.empty()) {
+        _backend->submit(std::move(submitted));
+    }
+    return ids;
+}
+
+bool AsyncFileReader::cancel(RequestId id) {
+    if (_state->callbacks.erase(id) == 0) {
+        return false;
+    }
+    _backend->cancel(id);
+    return true;
+}
+
+void AsyncFileReader::cancelAll() {
+    _state->callbacks.clear();
+    _backend->cancelAll();
+}
+
+size_t AsyncFileReader::getPendingCount() const {
+    return _state->callbacks.size();
+}
+
+void AsyncFileReader::postCompletion(const std::shared_ptr<SharedState> &state, RequestId id, FileUtils::Status status, Data &&data) {
+    bool schedule = false;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->completions.push_back({id, status, std::move(data)});
+        // completions arriving before the main thread drains the queue share a single delivery
+        schedule = !state->deliveryScheduled;
+        state->deliveryScheduled = true;
+    }
+    if (schedule) {
+        state->dispatcher([state]() { deliverCompletions(state); });
+    }
+}
+
+void AsyncFileReader::deliverCompletions(const std::shared_ptr<SharedState> &state) {
+    ccstd::vector<Completion> completions;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        completions.swap(state->completions);
+        state->deliveryScheduled = false;
+    }
+
+    for (auto &completion : completions) {
+        // the reader may be destroyed by a callback
+        if (state->closed) {
+            return;
+        }
+        auto iter = state->callbacks.find(completion.id);
+        if (iter == state->callbacks.end()) {
+            continue; // cancelled
+        }
+        Callback callback = std::move(iter->second);
+        state->callbacks.erase(iter);
+        if (callback) {
+            callback(completion.status, completion.data);
+        }
+    }
+}
+
+} // namespace cc
@@ -0,0 +1,117 @@
+/****************************************************************************
+ Copyright (c) 2017-2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include "base/Data.h"
+#include "base/Macros.h"
+#include "base/std/container/string.h"
+#include "base/std/container/vector.h"
+#include "platform/FileUtils.h"
+
+namespace cc {
+
+class AsyncFileBackend;
+
+/**
+ *  Reads whole files on background threads and delivers the results on the main thread.
+ *
+ *  Requests are resolved to full paths on the calling thread, queued by priority and handed to
+ *  a backend: io_uring on Linux kernels that support it, a pool of reader threads elsewhere.
+ *  Completion callbacks are always invoked on the main thread, through the Scheduler by default.
+ *
+ *  All methods must be called on the main thread.
+ */
+class CC_DLL AsyncFileReader final {
+public:
+    enum class Priority : uint8_t {
+        LOW,
+        NORMAL,
+        HIGH,
+    };
+
+    using RequestId = uint32_t;
+    static constexpr RequestId INVALID_REQUEST = 0;
+
+    // data is empty unless status is FileUtils::Status::OK
+    using Callback = std::function<void(FileUtils::Status status, Data &data)>;
+    // runs a function on the main thread, may be called from any thread
+    using Dispatcher = std::function<void(std::function<void()> &&)>;
+
+    struct ReadRequest {
+        ccstd::string filename;
+        Callback callback;
+        Priority priority{Priority::NORMAL};
+    };
+
+    /**
+     *  @param dispatcher Delivers completions to the main thread, the Scheduler of the current engine if empty.
+     *  @param useIOUring Whether the io_uring backend may be used where it is supported.
+     */
+    explicit AsyncFileReader(Dispatcher dispatcher = nullptr, bool useIOUring = true);
+    ~AsyncFileReader();
+
+    RequestId read(const ccstd::string &filename, Callback callback, Priority priority = Priority::NORMAL);
+    // submits all requests to the backend at once, the returned ids match the order of the requests
+    ccstd::vector<RequestId> readBatch(ccstd::vector<ReadRequest> &&requests);
+
+    /**
+     *  Cancels a request, its callback will not be invoked.
+     *  @return false if the request already completed or does not exist.
+     */
+    bool cancel(RequestId id);
+    void cancelAll();
+
+    // requests whose callback has not been invoked nor cancelled yet
+    size_t getPendingCount() const;
+    inline bool isUsingIOUring() const { return _usingIOUring; }
+
+private:
+    struct Completion {
+        RequestId id{INVALID_REQUEST};
+        FileUtils::Status status{FileUtils::Status::OK};
+        Data data;
+    };
+    struct SharedState;
+
+    // may be called on any thread
+    static void postCompletion(const std::shared_ptr<SharedState> &state, RequestId id, FileUtils::Status status, Data &&data);
+    static void deliverCompletions(const std::shared_ptr<SharedState> &state);
+
+    // completions are handed from the backend threads to the main thread through the shared state,
+    // which stays alive as long as a delivery is scheduled
+    std::shared_ptr<SharedState> _state;
+    std::unique_ptr<AsyncFileBackend> _backend;
+    RequestId _nextId{1};
+    uint64_t _nextSequence{0};
+    bool _usingIOUring{false};
+
+    CC_DISALLOW_COPY_MOVE_ASSIGN(AsyncFileReader);
+};
+
+} // namespace cc
@@ -0,0 +1,414 @@
+/****************************************************************************
+ Copyright (c) 2017-2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+
+#include "platform/CompressedTextureDecoder.h"
+
+#include <algorithm>
+#include <cstring>
+#include "base/job-system/JobSystem.h"
+
+#if defined(__SSE2__) || defined(_M_X64) // math/Mat4.h undefines __SSE__
+    #include <emmintrin.h>
+    #define CC_TEXTURE_DECODER_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define CC_TEXTURE_DECODER_NEON 1
+#endif
+
+namespace cc {
+
+namespace {
+// below this many blocks a level decodes faster than the job graph is set up
+constexpr uint32_t PARALLEL_DECODE_MIN_BLOCKS = 4096;
+
+constexpr uint32_t BLOCK_DIM = 4;
+constexpr uint32_t BLOCK_ROW_BYTES = BLOCK_DIM * 4;
+
+const int16_t ETC1_MODIFIERS[8][4] = {
+    {2, 8, -2, -8},
+    {5, 17, -5, -17},
+    {9, 29, -9, -29},
+    {13, 42, -13, -42},
+    {18, 60, -18, -60},
+    {24, 80, -24, -80},
+    {33, 106, -33, -106},
+    {47, 183, -47, -183}};
+
+const int ETC1_DIFF_LOOKUP[8] = {0, 1, 2, 3, -4, -3, -2, -1};
+
+const int16_t ETC2_DISTANCES[8] = {3, 6, 11, 16, 23, 32, 41, 64};
+
+alignas(16) const int16_t EAC_MODIFIERS[16][8] = {
+    {-3, -6, -9, -15, 2, 5, 8, 14},
+    {-3, -7, -10, -13, 2, 6, 9, 12},
+    {-2, -5, -8, -13, 1, 4, 7, 12},
+    {-2, -4, -6, -13, 1, 3, 5, 12},
+    {-3, -6, -8, -12, 2, 5, 7, 11},
+    {-3, -7, -9, -11, 2, 6, 8, 10},
+    {-4, -7, -8, -11, 3, 6, 7, 10},
+    {-3, -5, -8, -11, 2, 4, 7, 10},
+    {-2, -6, -8, -10, 1, 5, 7, 9},
+    {-2, -5, -8, -10, 1, 4, 7, 9},
+    {-2, -4, -8, -10, 1, 3, 7, 9},
+    {-2, -5, -7, -10, 1, 4, 6, 9},
+    {-3, -4, -7, -10, 2, 3, 6, 9},
+    {-1, -2, -3, -10, 0, 1, 2, 9},
+    {-4, -6, -8, -9, 3, 5, 7, 8},
+    {-3, -5, -7, -9, 2, 4, 6, 8}};
+
+inline uint64_t readBigEndian64(const uint8_t *p) {
+    uint64_t w = 0;
+    for (uint32_t i = 0; i < 8; ++i) {
+        w = (w << 8) | p[i];
+    }
+    return w;
+}
+
+inline int extend4To8(int c) { return (c << 4) | c; }
+inline int extend5To8(int c) { return (c << 3) | (c >> 2); }
+inline int extend6To8(int c) { return (c << 2) | (c >> 4); }
+inline int extend7To8(int c) { return (c << 1) | (c >> 6); }
+
+// Saturates four RGBA colors held as 16 signed lanes to 16 bytes.
+inline void packColors(const int16_t *lanes, uint8_t *out) {
+#if CC_TEXTURE_DECODER_SSE2
+    __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(lanes));
+    __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(lanes + 8));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_packus_epi16(lo, hi));
+#elif CC_TEXTURE_DECODER_NEON
+    vst1q_u8(out, vcombine_u8(vqmovun_s16(vld1q_s16(lanes)), vqmovun_s16(vld1q_s16(lanes + 8))));
+#else
+    for (uint32_t i = 0; i < 16; ++i) {
+        out[i] = static_cast<uint8_t>(std::min(std::max(static_cast<int>(lanes[i]), 0), 255));
+    }
+#endif
+}
+
+// Writes the four colors of palette an RGB base plus one offset per color makes.
+inline void buildPalette(const int base[3], const int16_t offsets[4], uint8_t *out) {
+    alignas(16) int16_t lanes[16];
+    for (uint32_t i = 0; i < 4; ++i) {
+        lanes[i * 4 + 0] = static_cast<int16_t>(base[0] + offsets[i]);
+        lanes[i * 4 + 1] = static_cast<int16_t>(base[1] + offsets[i]);
+        lanes[i * 4 + 2] = static_cast<int16_t>(base[2] + offsets[i]);
+        lanes[i * 4 + 3] = 255;
+    }
+    packColors(lanes, out);
+}
+
+// The 2-bit index of pixel (x, y) is bit x * 4 + y of the low word, its high bit 16 above.
+inline uint32_t pixelIndex(uint32_t low, uint32_t x, uint32_t y) {
+    uint32_t k = x * 4 + y;
+    return ((low >> k) & 1) | ((low >> (k + 15)) & 2);
+}
+
+// Expands a block whose pixels all pick one of four colors.
+void writePaletteBlock(const uint32_t palette[4], uint32_t low, uint8_t *dst, uint32_t dstStride) {
+    for (uint32_t y = 0; y < BLOCK_DIM; ++y) {
+        uint32_t row[BLOCK_DIM];
+        for (uint32_t x = 0; x < BLOCK_DIM; ++x) {
+            row[x] = palette[pixelIndex(low, x, y)];
+        }
+        memcpy(dst + y * dstStride, row, sizeof(row));
+    }
+}
+
+// Individual and differential modes, two subblocks of 4 x 2 or 2 x 4 pixels with a palette each.
+template <bool ETC2>
+void decodeSubblocks(uint64_t w, uint8_t *dst, uint32_t dstStride) {
+    int base[2][3];
+    if (w & (1ULL << 33)) {
+        for (uint32_t c = 0; c < 3; ++c) {
+            uint32_t shift = 59 - c * 8;
+            int value = static_cast<int>((w >> shift) & 0x1F);
+            int second = value + ETC1_DIFF_LOOKUP[(w >> (shift - 3)) & 7];
+            base[0][c] = extend5To8(value);
+            // ETC2 streams never reach here with an overflow, ETC1 decoders wrap it
+            base[1][c] = extend5To8(ETC2 ? second : (second & 0x1F));
+        }
+    } else {
+        for (uint32_t c = 0; c < 3; ++c) {
+            uint32_t shift = 60 - c * 8;
+            base[0][c] = extend4To8(static_cast<int>((w >> shift) & 0xF));
+            base[1][c] = extend4To8(static_cast<int>((w >> (shift - 4)) & 0xF));
+        }
+    }
+
+    alignas(16) uint32_t palette[8];
+    buildPalette(base[0], ETC1_MODIFIERS[(w >> 37) & 7], reinterpret_cast<uint8_t *>(palette));
+    buildPalette(base[1], ETC1_MODIFIERS[(w >> 34) & 7], reinterpret_cast<uint8_t *>(palette + 4));
+
+    auto low = static_cast<uint32_t>(w);
+    bool flipped = (w & (1ULL << 32)) != 0;
+    for (uint32_t y = 0; y < BLOCK_DIM; ++y) {
+        uint32_t row[BLOCK_DIM];
+        for (uint32_t x = 0; x < BLOCK_DIM; ++x) {
+            uint32_t subblock = flipped ? (y >> 1) : (x >> 1);
+            row[x] = palette[subblock * 4 + pixelIndex(low, x, y)];
+        }
+        memcpy(dst + y * dstStride, row, sizeof(row));
+    }
+}
+
+void decodeTMode(uint64_t w, uint8_t *dst, uint32_t dstStride) {
+    int c1[3] = {
+        extend4To8(static_cast<int>((((w >> 59) & 3) << 2) | ((w >> 56) & 3))),
+        extend4To8(static_cast<int>((w >> 52) & 0xF)),
+        extend4To8(static_cast<int>((w >> 48) & 0xF))};
+    int c2[3] = {
+        extend4To8(static_cast<int>((w >> 44) & 0xF)),
+        extend4To8(static_cast<int>((w >> 40) & 0xF)),
+        extend4To8(static_cast<int>((w >> 36) & 0xF))};
+    int16_t d = ETC2_DISTANCES[(((w >> 34) & 3) << 1) | ((w >> 32) & 1)];
+
+    // the first color is c1 as is, the other three come from c2
+    alignas(16) uint32_t palette[4];
+    const int16_t offsets[4] = {0, d, 0, static_cast<int16_t>(-d)};
+    buildPalette(c2, offsets, reinterpret_cast<uint8_t *>(palette));
+    uint8_t first[4] = {static_cast<uint8_t>(c1[0]), static_cast<uint8_t>(c1[1]), static_cast<uint8_t>(c1[2]), 255};
+    memcpy(palette, first, sizeof(first));
+    writePaletteBlock(palette, static_cast<uint32_t>(w), dst, dstStride);
+}
+
+void decodeHMode(uint64_t w, uint8_t *dst, uint32_t dstStride) {
+    int c1[3] = {
+        static_cast<int>((w >> 59) & 0xF),
+        static_cast<int>((((w >> 56) & 7) << 1) | ((w >> 52) & 1)),
+        static_cast<int>((((w >> 51) & 1) << 3) | ((w >> 47) & 7))};
+    int c2[3] = {
+        static_cast<int>((w >> 43) & 0xF),
+        static_cast<int>((w >> 39) & 0xF),
+        static_cast<int>((w >> 35) & 0xF)};
+    // the lowest distance bit is implied by the order of the two colors
+    uint32_t order = ((c1[0] << 8) | (c1[1] << 4) | c1[2]) >= ((c2[0] << 8) | (c2[1] << 4) | c2[2]) ? 1 : 0;
+    int16_t d = ETC2_DISTANCES[(((w >> 34) & 1) << 2) | (((w >> 32) & 1) << 1) | order];
+    for (uint32_t c = 0; c < 3; ++c) {
+        c1[c] = extend4To8(c1[c]);
+        c2[c] = extend4To8(c2[c]);
+    }
+
+    alignas(16) uint32_t palette[4];
+    alignas(16) int16_t lanes[16] = {
+        static_cast<int16_t>(c1[0] + d), static_cast<int16_t>(c1[1] + d), static_cast<int16_t>(c1[2] + d), 255,
+        static_cast<int16_t>(c1[0] - d), static_cast<int16_t>(c1[1] - d), static_cast<int16_t>(c1[2] - d), 255,
+        static_cast<int16_t>(c2[0] + d), static_cast<int16_t>(c2[1] + d), static_cast<int16_t>(c2[2] + d), 255,
+        static_cast<int16_t>(c2[0] - d), static_cast<int16_t>(c2[1] - d), static_cast<int16_t>(c2[2] - d), 255};
+    packColors(lanes, reinterpret_cast<uint8_t *>(palette));
+    writePaletteBlock(palette, static_cast<uint32_t>(w), dst, dstStride);
+}
+
+// Planar mode interpolates colors O, H and V given for pixels (0, 0), (4, 0) and (0, 4).
+void decodePlanarMode(uint64_t w, uint8_t *dst, uint32_t dstStride) {
+    int o[3] = {
+        extend6To8(static_cast<int>((w >> 57) & 0x3F)),
+        extend7To8(static_cast<int>((((w >> 56) & 1) << 6) | ((w >> 49) & 0x3F))),
+        extend6To8(static_cast<int>((((w >> 48) & 1) << 5) | (((w >> 43) & 3) << 3) | ((w >> 39) & 7)))};
+    int h[3] = {
+        extend6To8(static_cast<int>((((w >> 34) & 0x1F) << 1) | ((w >> 32) & 1))),
+        extend7To8(static_cast<int>((w >> 25) & 0x7F)),
+        extend6To8(static_cast<int>((w >> 19) & 0x3F))};
+    int v[3] = {
+        extend6To8(static_cast<int>((w >> 13) & 0x3F)),
+        extend7To8(static_cast<int>((w >> 6) & 0x7F)),
+        extend6To8(static_cast<int>(w & 0x3F))};
+
+    alignas(16) int16_t lanes[16];
+    for (uint32_t y = 0; y < BLOCK_DIM; ++y) {
+        for (uint32_t x = 0; x < BLOCK_DIM; ++x) {
+            for (uint32_t c = 0; c < 3; ++c) {
+                int value = static_cast<int>(x) * (h[c] - o[c]) + static_cast<int>(y) * (v[c] - o[c]) + 4 * o[c] + 2;
+                lanes[x * 4 + c] = static_cast<int16_t>(value >> 2);
+            }
+            lanes[x * 4 + 3] = 255;
+        }
+        packColors(lanes, dst + y * dstStride);
+    }
+}
+
+template <bool ETC2>
+void decodeColorBlock(const uint8_t *block, uint8_t *dst, uint32_t dstStride) {
+    uint64_t w = readBigEndian64(block);
+    if (ETC2 && (w & (1ULL << 33))) {
+        // an overflowing differential color selects one of the ETC2 modes
+        int r = static_cast<int>((w >> 59) & 0x1F) + ETC1_DIFF_LOOKUP[(w >> 56) & 7];
+        int g = static_cast<int>((w >> 51) & 0x1F) + ETC1_DIFF_LOOKUP[(w >> 48) & 7];
+        int b = static_cast<int>((w >> 43) & 0x1F) + ETC1_DIFF_LOOKUP[(w >> 40) & 7];
+        if (r < 0 || r > 31) {
+            decodeTMode(w, dst, dstStride);
+            return;
+        }
+        if (g < 0 || g > 31) {
+            decodeHMode(w, dst, dstStride);
+            return;
+        }
+        if (b < 0 || b > 31) {
+            decodePlanarMode(w, dst, dstStride);
+            return;
+        }
+    }
+    decodeSubblocks<ETC2>(w, dst, dstStride);
+}
+
+// Overwrites the alpha of a decoded block with an EAC alpha block.
+void decodeEACAlpha(const uint8_t *block, uint8_t *dst, uint32_t dstStride) {
+    uint64_t w = readBigEndian64(block);
+    auto base = static_cast<int16_t>(w >> 56);
+    auto multiplier = static_cast<int16_t>((w >> 52) & 0xF);
+    const int16_t *modifiers = EAC_MODIFIERS[(w >> 48) & 0xF];
+
+    uint8_t palette[8];
+#if CC_TEXTURE_DECODER_SSE2
+    __m128i values = _mm_add_epi16(_mm_set1_epi16(base), _mm_mullo_epi16(_mm_load_si128(reinterpret_cast<const __m128i *>(modifiers)), _mm_set1_epi16(multiplier)));
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(palette), _mm_packus_epi16(values, values));
+#elif CC_TEXTURE_DECODER_NEON
+    vst1_u8(palette, vqmovun_s16(vmlaq_s16(vdupq_n_s16(base), vld1q_s16(modifiers), vdupq_n_s16(multiplier))));
+#else
+    for (uint32_t i = 0; i < 8; ++i) {
+        palette[i] = static_cast<uint8_t>(std::min(std::max(base + modifiers[i] * multiplier, 0), 255));
+    }
+#endif
+
+    // 3-bit indices, column by column from the top bits down
+    for (uint32_t i = 0; i < 16; ++i) {
+        uint32_t x = i >> 2;
+        uint32_t y = i & 3;
+        dst[y * dstStride + x * 4 + 3] = palette[(w >> (45 - 3 * i)) & 7];
+    }
+}
+
+void decodeETC1Block(const uint8_t *block, uint8_t *dst, uint32_t dstStride) {
+    decodeColorBlock<false>(block, dst, dstStride);
+}
+
+void decodeETC2RGBBlock(const uint8_t *block, uint8_t *dst, uint32_t dstStride) {
+    decodeColorBlock<true>(block, dst, dstStride);
+}
+
+// ETC2 RGBA blocks store the alpha block ahead of the color block.
+void decodeETC2RGBABlock(const uint8_t *block, uint8_t *dst, uint32_t dstStride) {
+    decodeColorBlock<true>(block + 8, dst, dstStride);
+    decodeEACAlpha(block, dst, dstStride);
+}
+
+struct BlockFormat {
+    gfx::Format format;
+    CompressedTextureDecoder::BlockDecoder decoder;
+    uint32_t blockBytes;
+};
+
+const BlockFormat BLOCK_FORMATS[] = {
+    {gfx::Format::ETC_RGB8, decodeETC1Block, 8},
+    {gfx::Format::ETC2_RGB8, decodeETC2RGBBlock, 8},
+    {gfx::Format::ETC2_RGBA8, decodeETC2RGBABlock, 16},
+};
+
+const BlockFormat *findBlockFormat(gfx::Format format) {
+    for (const auto &info : BLOCK_FORMATS) {
+        if (info.format == format) {
+            return &info;
+        }
+    }
+    return nullptr;
+}
+} // namespace
+
+bool CompressedTextureDecoder::isSupported(gfx::Format format) {
+    return format == gfx::Format::RGBA8 || findBlockFormat(format) != nullptr;
+}
+
+uint32_t CompressedTextureDecoder::getEncodedSize(gfx::Format format, uint32_t width, uint32_t height) {
+    if (format == gfx::Format::RGBA8) {
+        return width * height * 4;
+    }
+    const auto *info = findBlockFormat(format);
+    if (!info) {
+        return 0;
+    }
+    return ((width + BLOCK_DIM - 1) / BLOCK_DIM) * ((height + BLOCK_DIM - 1) / BLOCK_DIM) * info->blockBytes;
+}
+
+CompressedTextureDecoder::BlockDecoder CompressedTextureDecoder::getBlockDecoder(gfx::Format format) {
+    const auto *info = findBlockFormat(format);
+    return info ? info->decoder : nullptr;
+}
+
+bool CompressedTextureDecoder::decode(gfx::Format format, const uint8_t *src, uint32_t srcLen, uint32_t width, uint32_t height, uint8_t *dst, uint32_t dstStride) {
+    if (format == gfx::Format::RGBA8) {
+        if (!src || !dst || width == 0 || height == 0 || dstStride < width * 4 || srcLen < getEncodedSize(format, width, height)) {
+            return false;
+        }
+        // a plain copy is bound by memory bandwidth, workers would only add their overhead
+        const uint32_t rowBytes = width * 4;
+        for (uint32_t y = 0; y < height; ++y) {
+            memcpy(dst + static_cast<size_t>(y) * dstStride, src + static_cast<size_t>(y) * rowBytes, rowBytes);
+        }
+        return true;
+    }
+
+    const auto *info = findBlockFormat(format);
+    if (!info || !src || !dst || width == 0 || height == 0 || dstStride < width * 4 || srcLen < getEncodedSize(format, width, height)) {
+        return false;
+    }
+
+    const uint32_t blocksX = (width + BLOCK_DIM - 1) / BLOCK_DIM;
+    const uint32_t blocksY = (height + BLOCK_DIM - 1) / BLOCK_DIM;
+    const BlockDecoder decoder = info->decoder;
+    const uint32_t blockBytes = info->blockBytes;
+
+    auto decodeBlockRow = [=](uint32_t by) {
+        const uint8_t *block = src + static_cast<size_t>(by) * blocksX * blockBytes;
+        uint8_t *out = dst + static_cast<size_t>(by) * BLOCK_DIM * dstStride;
+        const uint32_t rows = std::min(BLOCK_DIM, height - by * BLOCK_DIM);
+        for (uint32_t bx = 0; bx < blocksX; ++bx, block += blockBytes) {
+            const uint32_t columns = std::min(BLOCK_DIM, width - bx * BLOCK_DIM);
+            if (rows == BLOCK_DIM && columns == BLOCK_DIM) {
+                decoder(block, out + bx * BLOCK_ROW_BYTES, dstStride);
+                continue;
+            }
+            // blocks hanging over the right or bottom edge go through a scratch block
+            alignas(16) uint8_t edge[BLOCK_DIM * BLOCK_ROW_BYTES];
+            decoder(block, edge, BLOCK_ROW_BYTES);
+            for (uint32_t y = 0; y < rows; ++y) {
+                memcpy(out + y * dstStride + bx * BLOCK_ROW_BYTES, edge + y * BLOCK_ROW_BYTES, columns * 4);
+            }
+        }
+    };
+
+    auto *jobSystem = JobSystem::getInstance();
+    if (blocksX * blocksY >= PARALLEL_DECODE_MIN_BLOCKS && blocksY > 1 && jobSystem->threadCount() > 1) {
+        JobGraph g(jobSystem);
+        g.createForEachIndexJob(1U, blocksY, 1U, decodeBlockRow);
+        g.run();
+        decodeBlockRow(0); // the calling thread takes the first row
+        g.waitForAll();
+    } else {
+        for (uint32_t by = 0; by < blocksY; ++by) {
+            decodeBlockRow(by);
+        }
+    }
+    return true;
+}
+
+} // namespace cc
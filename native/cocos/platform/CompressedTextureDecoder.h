@@ -0,0 +1,64 @@
+/****************************************************************************
+ Copyright (c) 2017-2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+
+#pragma once
+
+#include <cstdint>
+#include "base/Macros.h"
+#include "gfx-base/GFXDef.h"
+
+namespace cc {
+
+/**
+ *  Software decoders for block compressed textures the GPU can not sample, ETC1 and ETC2 so far.
+ *
+ *  Every format is decoded to RGBA8 through one block decoder per format. Color palettes are built with
+ *  SSE2 or NEON where available, and images large enough are split across the job system by rows of blocks.
+ *  RGBA8 is accepted too and copied row by row on the calling thread, so callers need not special case it.
+ */
+class CC_DLL CompressedTextureDecoder final {
+public:
+    // decodes one 4 x 4 block to RGBA8, the four rows are dstStride bytes apart
+    using BlockDecoder = void (*)(const uint8_t *block, uint8_t *dst, uint32_t dstStride);
+
+    static bool isSupported(gfx::Format format);
+
+    // bytes of source data a width x height level takes, 0 if the format is not supported
+    static uint32_t getEncodedSize(gfx::Format format, uint32_t width, uint32_t height);
+
+    // nullptr for RGBA8, which has no blocks
+    static BlockDecoder getBlockDecoder(gfx::Format format);
+
+    /**
+     * Decodes a width x height level to RGBA8 rows dstStride bytes apart, dstStride being at least width * 4.
+     * @return false if the format is not supported or srcLen is too short.
+     */
+    static bool decode(gfx::Format format, const uint8_t *src, uint32_t srcLen, uint32_t width, uint32_t height, uint8_t *dst, uint32_t dstStride);
+
+private:
+    CompressedTextureDecoder() = delete;
+};
+
+} // namespace cc
@@ -31,17 +31,14 @@
 #include <cstring>
 #include <iostream>
 
-#ifdef MINIZIP_FROM_SYSTEM
-    #include <minizip/unzip.h>
-#else // from our embedded sources
-    #include "unzip/unzip.h"
-#endif
 #include <sys/stat.h>
 #include <regex>
 
 #include "base/Data.h"
 #include "base/Log.h"
+#include "base/ZipArchive.h"
 #include "base/memory/Memory.h"
+#include "platform/AsyncFileReader.h"
 #include "platform/SAXParser.h"
 
 #include "tinydir/tinydir.h"
@@ -596,42 +593,51 @@ FileUtils::Status FileUtils::getContents(const ccstd::string &filename, Resizabl
     return Status::OK;
 }
 
-unsigned char *FileUtils::getFileDataFromZip(const ccstd::string &zipFilePath, const ccstd::string &filename, uint32_t *size) {
-    unsigned char *buffer = nullptr;
-    unzFile file = nullptr;
-    *size = 0;
-
-    do {
-        CC_BREAK_IF(zipFilePath.empty());
-
-        file = unzOpen(FileUtils::getInstance()->getSuitableFOpen(zipFilePath).c_str());
-        CC_BREAK_IF(!file);
+IntrusivePtr<MappedFile> FileUtils::mapFile(const ccstd::string &filename) {
+    if (filename.empty()) {
+        return nullptr;
+    }
 
-        // minizip 1.2.0 is same with other platforms
-        int ret = unzLocateFile(file, filename.c_str(), nullptr);
-        CC_BREAK_IF(UNZ_OK != ret);
+    auto *fs = FileUtils::getInstance();
 
-        char filePathA[260];
-        unz_file_info fileInfo;
-        ret = unzGetCurrentFileInfo(file, &fileInfo, filePathA, sizeof(filePathA), nullptr, 0, nullptr, 0);
-        CC_BREAK_IF(UNZ_OK != ret);
+    ccstd::string fullPath = fs->fullPathForFilename(filename);
+    if (fullPath.empty()) {
+        return nullptr;
+    }
 
-        ret = unzOpenCurrentFile(file);
-        CC_BREAK_IF(UNZ_OK != ret);
+    if (fs->isAbsolutePath(fullPath)) {
+        auto file = MappedFile::open(fs->getSuitableFOpen(fullPath));
+        if (file) {
+            return file;
+        }
+    }
 
-        buffer = static_cast<unsigned char *>(malloc(fileInfo.uncompressed_size));
-        int CC_UNUSED readedSize = unzReadCurrentFile(file, buffer, static_cast<unsigned>(fileInfo.uncompressed_size));
-        CC_ASSERT(readedSize == 0 || readedSize == (int)fileInfo.uncompressed_size);
+    Data data;
+    if (fs->getContents(fullPath, &data) != Status::OK) {
+        return nullptr;
+    }
+    return IntrusivePtr<MappedFile>(ccnew MappedFile(std::move(data)));
+}
 
-        *size = fileInfo.uncompressed_size;
-        unzCloseCurrentFile(file);
-    } while (false);
+AsyncFileReader *FileUtils::getAsyncFileReader() {
+    if (!_asyncFileReader) {
+        _asyncFileReader = std::make_unique<AsyncFileReader>();
+    }
+    return _asyncFileReader.get();
+}
 
-    if (file) {
-        unzClose(file);
+unsigned char *FileUtils::getFileDataFromZip(const ccstd::string &zipFilePath, const ccstd::string &filename, uint32_t *size) {
+    *size = 0;
+    if (zipFilePath.empty()) {
+        return nullptr;
     }
 
-    return buffer;
+    // the archive stays mounted until the file changes or is removed, later lookups reuse its index
+    auto archive = ZipArchive::mount(zipFilePath);
+    if (!archive) {
+        return nullptr;
+    }
+    return archive->getFileData(filename, size);
 }
 
 ccstd::string FileUtils::getPathForFilename(const ccstd::string &filename, const ccstd::string &searchPath) const {
@@ -1072,6 +1078,8 @@ bool FileUtils::removeDirectory(const ccstd::string &path) {
 }
 
 bool FileUtils::removeFile(const ccstd::string &path) {
+    // an archive mounted from the file must not be served after it is gone
+    ZipArchive::unmount(path);
     return remove(path.c_str()) == 0;
 }
 
@@ -24,6 +24,7 @@
 
 #pragma once
 
+#include <memory>
 #include <type_traits>
 #include "base/Data.h"
 #include "base/Macros.h"
@@ -31,9 +32,12 @@
 #include "base/std/container/string.h"
 #include "base/std/container/unordered_map.h"
 #include "base/std/container/vector.h"
+#include "platform/MappedFile.h"
 
 namespace cc {
 
+class AsyncFileReader;
+
 class ResizableBuffer {
 public:
     ~ResizableBuffer() = default;
@@ -228,6 +232,24 @@ public:
     }
     virtual Status getContents(const ccstd::string &filename, ResizableBuffer *buffer);
 
+    /**
+     *  Gets a read-only view of the whole file contents without copying them when possible.
+     *
+     *  Files on the local file system are memory mapped, other files (e.g. packed in the apk)
+     *  fall back to getContents. Prefer this over getDataFromFile for large assets that are
+     *  only read once, such as images and binary buffers.
+     *
+     *  @param[in]  filename The resource file name which contains the path.
+     *  @return The file view, or nullptr if the file could not be read.
+     */
+    virtual IntrusivePtr<MappedFile> mapFile(const ccstd::string &filename);
+
+    /**
+     *  Gets the reader of asynchronous file reads, created on first use.
+     *  Read completions are delivered on the main thread, see AsyncFileReader.
+     */
+    AsyncFileReader *getAsyncFileReader();
+
     /**
      *  Gets resource file data from a zip file.
      *
@@ -623,6 +645,8 @@ protected:
      */
     static FileUtils *sharedFileUtils;
 
+    std::unique_ptr<AsyncFileReader> _asyncFileReader;
+
     /**
      *  Remove null value key (for iOS)
      */
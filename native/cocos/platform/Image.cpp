@@ -25,6 +25,7 @@
 ****************************************************************************/
 
 #include "Image.h"
+#include <algorithm>
 #include <cctype>
 #include <cstring>
 #include "base/Config.h" // CC_USE_JPEG, CC_USE_WEBP
@@ -61,6 +62,7 @@ extern "C" {
 #endif // CC_USE_WEBP
 
 #include "base/ZipUtils.h"
+#include "platform/CompressedTextureDecoder.h"
 #include "platform/FileUtils.h"
 #if (CC_PLATFORM == CC_PLATFORM_ANDROID)
     #include "platform/android/FileUtils-android.h"
@@ -261,6 +263,106 @@ void pngReadCallback(png_structp pngPtr, png_bytep data, png_size_t length) {
 #endif //CC_USE_PNG
 } // namespace
 
+// Where decoded rows go: a buffer the image takes over, caller memory, nowhere when only the
+// header is wanted, or a staging slice handed to a row callback. Decoders report errors with
+// longjmp, so everything allocated while decoding is owned here, in the caller's frame.
+struct Image::RasterTarget {
+    enum class Mode {
+        OWNED,
+        EXTERNAL,
+        HEADER,
+        ROWS,
+    };
+
+    Mode mode{Mode::OWNED};
+    unsigned char *dst{nullptr};
+    uint32_t dstLen{0};
+    int sliceRows{0};
+    const RowCallback *callback{nullptr};
+
+    unsigned char *buffer{nullptr};
+    unsigned char **rowTable{nullptr};
+    uint32_t rowBytes{0};
+    int height{0};
+    // rows arrive top-down, so a slice of them is enough
+    bool inOrder{false};
+
+    ~RasterTarget() {
+        free(buffer);
+        free(rowTable);
+    }
+
+    // returns false when no pixels should be decoded, for HEADER mode or a too small destination
+    bool begin(uint32_t bytesPerRow, int rows, bool rowsInOrder) {
+        rowBytes = bytesPerRow;
+        height = rows;
+        inOrder = rowsInOrder && mode == Mode::ROWS;
+        switch (mode) {
+            case Mode::OWNED:
+                buffer = static_cast<unsigned char *>(malloc(static_cast<size_t>(rowBytes) * height));
+                return buffer != nullptr;
+            case Mode::EXTERNAL:
+                return dst && static_cast<size_t>(dstLen) >= static_cast<size_t>(rowBytes) * height;
+            case Mode::ROWS:
+                sliceRows = std::max(1, std::min(sliceRows, height));
+                buffer = static_cast<unsigned char *>(malloc(static_cast<size_t>(rowBytes) * (inOrder ? sliceRows : height)));
+                return buffer != nullptr;
+            default:
+                return false;
+        }
+    }
+
+    unsigned char *row(int y) const {
+        if (mode == Mode::EXTERNAL) {
+            return dst + static_cast<size_t>(y) * rowBytes;
+        }
+        if (inOrder) {
+            return buffer + static_cast<size_t>(y % sliceRows) * rowBytes;
+        }
+        return buffer + static_cast<size_t>(y) * rowBytes;
+    }
+
+    unsigned char **rows() {
+        rowTable = static_cast<unsigned char **>(malloc(sizeof(unsigned char *) * height));
+        if (rowTable) {
+            for (int y = 0; y < height; ++y) {
+                rowTable[y] = row(y);
+            }
+        }
+        return rowTable;
+    }
+
+    // called once rows up to endRow are written, returns false when the callback stopped decoding
+    bool rowsWritten(int endRow) const {
+        if (mode != Mode::ROWS) {
+            return true;
+        }
+        if (inOrder) {
+            if (endRow % sliceRows != 0 && endRow != height) {
+                return true;
+            }
+            const int firstRow = (endRow - 1) / sliceRows * sliceRows;
+            return (*callback)(buffer, rowBytes, firstRow, endRow - firstRow);
+        }
+        if (endRow != height) {
+            return true;
+        }
+        for (int firstRow = 0; firstRow < height; firstRow += sliceRows) {
+            const int rowCount = std::min(sliceRows, height - firstRow);
+            if (!(*callback)(row(firstRow), rowBytes, firstRow, rowCount)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    unsigned char *release() {
+        unsigned char *data = buffer;
+        buffer = nullptr;
+        return data;
+    }
+};
+
 //////////////////////////////////////////////////////////////////////////
 // Implement Image
 //////////////////////////////////////////////////////////////////////////
@@ -278,10 +380,11 @@ bool Image::initWithImageFile(const ccstd::string &path) {
     //    _filePath = FileUtils::getInstance()->fullPathForFilename(path);
     _filePath = path;
 
-    const Data data = FileUtils::getInstance()->getDataFromFile(_filePath);
+    // decoders copy what they keep, so the file contents do not need a heap copy of their own
+    const auto file = FileUtils::getInstance()->mapFile(_filePath);
 
-    if (!data.isNull()) {
-        ret = initWithImageData(data.getBytes(), data.getSize());
+    if (file && file->getSize() > 0) {
+        ret = initWithImageData(file->getBytes(), file->getSize());
     }
 
     return ret;
@@ -346,6 +449,51 @@ bool Image::initWithImageData(const unsigned char *data, uint32_t dataLen) { //N
     return ret;
 }
 
+bool Image::initWithImageHeader(const unsigned char *data, uint32_t dataLen) {
+    RasterTarget target;
+    target.mode = RasterTarget::Mode::HEADER;
+    return decodeRaster(data, dataLen, &target);
+}
+
+bool Image::initWithImageData(const unsigned char *data, uint32_t dataLen, unsigned char *dst, uint32_t dstLen) {
+    RasterTarget target;
+    target.mode = RasterTarget::Mode::EXTERNAL;
+    target.dst = dst;
+    target.dstLen = dstLen;
+    return decodeRaster(data, dataLen, &target);
+}
+
+bool Image::decodeRows(const unsigned char *data, uint32_t dataLen, int sliceRows, const RowCallback &callback) {
+    if (sliceRows <= 0 || !callback) {
+        return false;
+    }
+    RasterTarget target;
+    target.mode = RasterTarget::Mode::ROWS;
+    target.sliceRows = sliceRows;
+    target.callback = &callback;
+    return decodeRaster(data, dataLen, &target);
+}
+
+bool Image::decodeRaster(const unsigned char *data, uint32_t dataLen, RasterTarget *target) {
+    if (!data || dataLen == 0) {
+        return false;
+    }
+
+    _fileType = detectFormat(data, dataLen);
+    switch (_fileType) {
+        case Format::PNG:
+            return decodePng(data, dataLen, target);
+        case Format::JPG:
+            return decodeJpg(data, dataLen, target);
+#if CC_USE_WEBP
+        case Format::WEBP:
+            return decodeWebp(data, dataLen, target);
+#endif
+        default:
+            return false;
+    }
+}
+
 bool Image::isPng(const unsigned char *data, uint32_t dataLen) {
     if (dataLen <= 8) {
         return false;
@@ -516,6 +664,15 @@ void myErrorExit(j_common_ptr cinfo) {
 } // namespace
 
 bool Image::initWithJpgData(const unsigned char *data, uint32_t dataLen) {
+    RasterTarget target;
+    if (!decodeJpg(data, dataLen, &target)) {
+        return false;
+    }
+    _data = target.release();
+    return true;
+}
+
+bool Image::decodeJpg(const unsigned char *data, uint32_t dataLen, RasterTarget *target) {
 #if CC_USE_JPEG
     /* these are standard libjpeg structures for reading(decompression) */
     struct jpeg_decompress_struct cinfo;
@@ -526,7 +683,6 @@ bool Image::initWithJpgData(const unsigned char *data, uint32_t dataLen) {
     struct MyErrorMgr jerr;
     /* libjpeg data structure for storing one row, that is, scanline of an image */
     JSAMPROW rowPointer[1] = {nullptr};
-    uint32_t location = 0;
 
     bool ret = false;
     do {
@@ -563,23 +719,35 @@ bool Image::initWithJpgData(const unsigned char *data, uint32_t dataLen) {
             _renderFormat = gfx::Format::RGB8;
         }
 
-        /* Start decompression jpeg here */
-        jpeg_start_decompress(&cinfo);
+        /* Start decompression jpeg here, progressive images are read whole by this */
+        if (target->mode == RasterTarget::Mode::HEADER) {
+            jpeg_calc_output_dimensions(&cinfo);
+        } else {
+            jpeg_start_decompress(&cinfo);
+        }
 
         /* init image info */
         _isCompressed = false;
         _width = cinfo.output_width;
         _height = cinfo.output_height;
-        _dataLen = cinfo.output_width * cinfo.output_height * cinfo.output_components;
-        _data = static_cast<unsigned char *>(malloc(_dataLen * sizeof(unsigned char)));
-        CC_BREAK_IF(!_data);
+        const uint32_t rowBytes = cinfo.output_width * cinfo.output_components;
+        _dataLen = rowBytes * cinfo.output_height;
+        if (!target->begin(rowBytes, _height, true)) {
+            ret = target->mode == RasterTarget::Mode::HEADER;
+            jpeg_destroy_decompress(&cinfo);
+            break;
+        }
 
-        /* now actually read the jpeg into the raw buffer */
+        /* now actually read the jpeg into the target */
         /* read one scan line at a time */
+        bool completed = true;
         while (cinfo.output_scanline < cinfo.output_height) {
-            rowPointer[0] = _data + location;
-            location += cinfo.output_width * cinfo.output_components;
+            rowPointer[0] = target->row(static_cast<int>(cinfo.output_scanline));
             jpeg_read_scanlines(&cinfo, rowPointer, 1);
+            if (!target->rowsWritten(static_cast<int>(cinfo.output_scanline))) {
+                completed = false;
+                break;
+            }
         }
 
         /* When read image file with broken data, jpeg_finish_decompress() may cause error.
@@ -590,14 +758,25 @@ bool Image::initWithJpgData(const unsigned char *data, uint32_t dataLen) {
         //jpeg_finish_decompress( &cinfo );
         jpeg_destroy_decompress(&cinfo);
         /* wrap up decompression, destroy objects, free pointers and close open files */
-        ret = true;
+        ret = completed;
     } while (false);
 
     return ret;
+#else
+    return false;
 #endif // CC_USE_JPEG
 }
 
 bool Image::initWithPngData(const unsigned char *data, uint32_t dataLen) {
+    RasterTarget target;
+    if (!decodePng(data, dataLen, &target)) {
+        return false;
+    }
+    _data = target.release();
+    return true;
+}
+
+bool Image::decodePng(const unsigned char *data, uint32_t dataLen, RasterTarget *target) {
 #if CC_USE_PNG
     // length of bytes to check if it is a valid png file
     #define PNGSIGSIZE 8
@@ -667,6 +846,11 @@ bool Image::initWithPngData(const unsigned char *data, uint32_t dataLen) {
         if (bitDepth < 8) {
             png_set_packing(pngPtr);
         }
+        // interlaced rows only take their final values in the last pass
+        const bool interlaced = png_get_interlace_type(pngPtr, infoPtr) != PNG_INTERLACE_NONE;
+        if (interlaced) {
+            png_set_interlace_handling(pngPtr);
+        }
         // update info
         png_read_update_info(pngPtr, infoPtr);
         colorType = png_get_color_type(pngPtr, infoPtr);
@@ -688,29 +872,32 @@ bool Image::initWithPngData(const unsigned char *data, uint32_t dataLen) {
                 break;
         }
 
-        auto *rowPointers = static_cast<png_bytep *>(malloc(sizeof(png_bytep) * _height));
-
         const png_size_t rowBytes = png_get_rowbytes(pngPtr, infoPtr);
-
         _dataLen = static_cast<uint32_t>(rowBytes * _height);
-        _data = static_cast<unsigned char *>(malloc(_dataLen * sizeof(unsigned char)));
-        if (!_data) {
-            if (rowPointers != nullptr) {
-                free(rowPointers);
-            }
+
+        if (!target->begin(static_cast<uint32_t>(rowBytes), _height, !interlaced)) {
+            ret = target->mode == RasterTarget::Mode::HEADER;
             break;
         }
 
-        for (int i = 0; i < _height; ++i) {
-            rowPointers[i] = _data + i * rowBytes;
+        if (target->inOrder) {
+            bool completed = true;
+            for (int i = 0; i < _height; ++i) {
+                png_read_row(pngPtr, target->row(i), nullptr);
+                if (!target->rowsWritten(i + 1)) {
+                    completed = false;
+                    break;
+                }
+            }
+            CC_BREAK_IF(!completed);
+        } else {
+            png_bytep *rowPointers = target->rows();
+            CC_BREAK_IF(!rowPointers);
+            png_read_image(pngPtr, rowPointers);
+            CC_BREAK_IF(!target->rowsWritten(_height));
         }
-        png_read_image(pngPtr, rowPointers);
         png_read_end(pngPtr, nullptr);
 
-        if (rowPointers != nullptr) {
-            free(rowPointers);
-        }
-
         ret = true;
     } while (false);
 
@@ -718,6 +905,8 @@ bool Image::initWithPngData(const unsigned char *data, uint32_t dataLen) {
         png_destroy_read_struct(&pngPtr, (infoPtr) ? &infoPtr : nullptr, nullptr);
     }
     return ret;
+#else
+    return false;
 #endif //CC_USE_PNG
 }
 
@@ -889,6 +1078,19 @@ bool Image::initWithCompressedMipsData(const unsigned char *data, uint32_t /*dat
         return false;
     }
 
+    bool rasterMips = true;
+    for (uint32_t i = 0; i < getChunkNumbers(data) && rasterMips; ++i) {
+        const auto format = detectFormat(getChunk(data, i), getChunkSizes(data, i));
+#if CC_USE_WEBP
+        rasterMips = format == Format::PNG || format == Format::JPG || format == Format::WEBP;
+#else
+        rasterMips = format == Format::PNG || format == Format::JPG;
+#endif
+    }
+    if (rasterMips) {
+        return initWithRasterMipsData(data);
+    }
+
     // unpack compressed chunks
     int width = 0;
     int height = 0;
@@ -934,12 +1136,61 @@ bool Image::initWithCompressedMipsData(const unsigned char *data, uint32_t /*dat
     return ret;
 }
 
+bool Image::initWithRasterMipsData(const unsigned char *data) {
+    // the headers size every level up front, so each one decodes straight into its place
+    const auto chunkNumbers = getChunkNumbers(data);
+    ccstd::vector<uint32_t> offsets(chunkNumbers);
+    _mipmapLevelDataSize.resize(chunkNumbers);
+    uint32_t dstDataLen = 0;
+    for (uint32_t i = 0; i < chunkNumbers; ++i) {
+        Image level;
+        if (!level.initWithImageHeader(getChunk(data, i), getChunkSizes(data, i))) {
+            return false;
+        }
+        if (i == 0) {
+            _width = level._width;
+            _height = level._height;
+            _renderFormat = level._renderFormat;
+            _isCompressed = false;
+        }
+        offsets[i] = dstDataLen;
+        _mipmapLevelDataSize[i] = level._dataLen;
+        dstDataLen += level._dataLen;
+    }
+
+    auto *dstData = static_cast<unsigned char *>(malloc(dstDataLen * sizeof(unsigned char)));
+    if (!dstData) {
+        return false;
+    }
+    for (uint32_t i = 0; i < chunkNumbers; ++i) {
+        Image level;
+        if (!level.initWithImageData(getChunk(data, i), getChunkSizes(data, i), dstData + offsets[i], _mipmapLevelDataSize[i])) {
+            free(dstData);
+            return false;
+        }
+    }
+
+    if (_data) free(_data);
+    _data = dstData;
+    _dataLen = dstDataLen;
+    return true;
+}
+
 bool Image::initWithPVRData(const unsigned char *data, uint32_t dataLen) {
     return initWithPVRv2Data(data, dataLen) || initWithPVRv3Data(data, dataLen);
 }
 
 #if CC_USE_WEBP
 bool Image::initWithWebpData(const unsigned char *data, uint32_t dataLen) {
+    RasterTarget target;
+    if (!decodeWebp(data, dataLen, &target)) {
+        return false;
+    }
+    _data = target.release();
+    return true;
+}
+
+bool Image::decodeWebp(const unsigned char *data, uint32_t dataLen, RasterTarget *target) {
     bool ret = false;
     do {
         WebPDecoderConfig config;
@@ -953,21 +1204,23 @@ bool Image::initWithWebpData(const unsigned char *data, uint32_t dataLen) {
         _height = config.input.height;
         _isCompressed = false;
 
-        _dataLen = _width * _height * (config.input.has_alpha ? 4 : 3);
-        _data = static_cast<unsigned char *>(malloc(_dataLen * sizeof(unsigned char)));
+        const uint32_t rowBytes = _width * (config.input.has_alpha ? 4 : 3);
+        _dataLen = rowBytes * _height;
+        if (!target->begin(rowBytes, _height, false)) {
+            ret = target->mode == RasterTarget::Mode::HEADER;
+            break;
+        }
 
-        config.output.u.RGBA.rgba = static_cast<uint8_t *>(_data);
-        config.output.u.RGBA.stride = _width * (config.input.has_alpha ? 4 : 3);
+        config.output.u.RGBA.rgba = static_cast<uint8_t *>(target->row(0));
+        config.output.u.RGBA.stride = static_cast<int>(rowBytes);
         config.output.u.RGBA.size = _dataLen;
         config.output.is_external_memory = 1;
 
         if (WebPDecode(static_cast<const uint8_t *>(data), dataLen, &config) != VP8_STATUS_OK) {
-            free(_data);
-            _data = nullptr;
             break;
         }
 
-        ret = true;
+        ret = target->rowsWritten(_height);
     } while (false);
     return ret;
 }
@@ -996,6 +1249,53 @@ bool Image::initWithRawData(const unsigned char *data, uint32_t /*dataLen*/, int
     return ret;
 }
 
+bool Image::decompress() {
+    if (!_isCompressed || !_data || !CompressedTextureDecoder::isSupported(_renderFormat)) {
+        return false;
+    }
+
+    ccstd::vector<uint32_t> encodedSizes = _mipmapLevelDataSize;
+    if (encodedSizes.empty()) {
+        encodedSizes.push_back(_dataLen);
+    }
+    ccstd::vector<uint32_t> decodedSizes(encodedSizes.size());
+    uint32_t decodedLen = 0;
+    for (size_t i = 0; i < encodedSizes.size(); ++i) {
+        const auto width = static_cast<uint32_t>(std::max(_width >> i, 1));
+        const auto height = static_cast<uint32_t>(std::max(_height >> i, 1));
+        decodedSizes[i] = width * height * 4;
+        decodedLen += decodedSizes[i];
+    }
+
+    auto *decoded = static_cast<unsigned char *>(malloc(decodedLen));
+    if (!decoded) {
+        return false;
+    }
+    uint32_t srcOffset = 0;
+    uint32_t dstOffset = 0;
+    for (size_t i = 0; i < encodedSizes.size(); ++i) {
+        const auto width = static_cast<uint32_t>(std::max(_width >> i, 1));
+        const auto height = static_cast<uint32_t>(std::max(_height >> i, 1));
+        if (srcOffset + encodedSizes[i] > _dataLen ||
+            !CompressedTextureDecoder::decode(_renderFormat, _data + srcOffset, encodedSizes[i], width, height, decoded + dstOffset, width * 4)) {
+            free(decoded);
+            return false;
+        }
+        srcOffset += encodedSizes[i];
+        dstOffset += decodedSizes[i];
+    }
+
+    free(_data);
+    _data = decoded;
+    _dataLen = decodedLen;
+    _renderFormat = gfx::Format::RGBA8;
+    _isCompressed = false;
+    if (!_mipmapLevelDataSize.empty()) {
+        _mipmapLevelDataSize = std::move(decodedSizes);
+    }
+    return true;
+}
+
 bool Image::saveToFile(const std::string &filename, bool isToRGB) {
     //only support for Image::PixelFormat::RGB888 or Image::PixelFormat::RGBA8888 uncompressed data
     if (isCompressed() || (_renderFormat != gfx::Format::RGB8 && _renderFormat != gfx::Format::RGBA8)) {
@@ -26,6 +26,7 @@
 
 #pragma once
 
+#include <functional>
 #include "base/RefCounted.h"
 #include "base/std/container/string.h"
 #include "gfx-base/GFXDef.h"
@@ -61,12 +62,41 @@ public:
         UNKNOWN
     };
 
+    /**
+     * Receives decoded rows top-down, rowCount rows of rowBytes bytes each starting at firstRow.
+     * The rows are only valid during the call, return false to stop decoding.
+     */
+    using RowCallback = std::function<bool(const unsigned char *rows, uint32_t rowBytes, int firstRow, int rowCount)>;
+
     bool initWithImageFile(const ccstd::string &path);
     bool initWithImageData(const unsigned char *data, uint32_t dataLen);
 
+    // Reads the size, render format and getDataLen() of a PNG, JPEG or WebP image without decoding its pixels.
+    bool initWithImageHeader(const unsigned char *data, uint32_t dataLen);
+
+    /**
+     * Decodes a PNG, JPEG or WebP image straight into caller memory of at least getDataLen() bytes,
+     * as reported by initWithImageHeader(). The image does not own the memory, getData() stays nullptr.
+     */
+    bool initWithImageData(const unsigned char *data, uint32_t dataLen, unsigned char *dst, uint32_t dstLen);
+
+    /**
+     * Decodes a PNG or JPEG image sliceRows rows at a time through one staging slice, so peak memory
+     * is a slice rather than the whole image. Interlaced PNGs and WebP images are decoded whole
+     * first and then handed over in slices.
+     * @return true when every row was delivered.
+     */
+    bool decodeRows(const unsigned char *data, uint32_t dataLen, int sliceRows, const RowCallback &callback);
+
     // @warning kFmtRawData only support RGBA8888
     bool initWithRawData(const unsigned char *data, uint32_t dataLen, int width, int height, int bitsPerComponent, bool preMulti = false);
 
+    /**
+     * Decodes compressed ETC1 or ETC2 data, every mipmap level of it, to RGBA8 for devices that can not
+     * sample the compressed format, see CompressedTextureDecoder. Returns false for other formats.
+     */
+    bool decompress();
+
     // data will be free outside.
     inline void takeData(unsigned char **outData) {
         *outData = _data;
@@ -92,6 +122,16 @@ public:
     bool saveToFile(const std::string &filename, bool isToRGB = true);
 
 protected:
+    struct RasterTarget;
+
+    bool decodeRaster(const unsigned char *data, uint32_t dataLen, RasterTarget *target);
+    bool decodeJpg(const unsigned char *data, uint32_t dataLen, RasterTarget *target);
+    bool decodePng(const unsigned char *data, uint32_t dataLen, RasterTarget *target);
+#if CC_USE_WEBP
+    bool decodeWebp(const unsigned char *data, uint32_t dataLen, RasterTarget *target);
+#endif
+    bool initWithRasterMipsData(const unsigned char *data);
+
     bool initWithJpgData(const unsigned char *data, uint32_t dataLen);
     bool initWithPngData(const unsigned char *data, uint32_t dataLen);
 #if CC_USE_WEBP
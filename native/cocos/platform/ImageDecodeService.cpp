@@ -0,0 +1,109 @@
+/****************************************************************************
+ Copyright (c) 2017-2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+
+#include "platform/ImageDecodeService.h"
+
+#include <algorithm>
+#include <thread>
+#include <utility>
+#include "base/Ptr.h"
+#include "base/ThreadPool.h"
+#include "base/memory/Memory.h"
+#include "platform/FileUtils.h"
+#include "platform/Image.h"
+
+namespace cc {
+
+namespace {
+// decoding is CPU bound, more threads than cores only adds contention
+constexpr uint32_t MAX_DECODE_THREADS = 8;
+
+ImageDecodeService *gInstance = nullptr;
+} // namespace
+
+ImageDecodeService *ImageDecodeService::getInstance() {
+    if (!gInstance) {
+        gInstance = ccnew ImageDecodeService();
+    }
+    return gInstance;
+}
+
+void ImageDecodeService::destroyInstance() {
+    CC_SAFE_DELETE(gInstance);
+}
+
+ImageDecodeService::ImageDecodeService(uint32_t threadCount) {
+    if (threadCount == 0) {
+        // leave a core to the main thread
+        const uint32_t cores = std::thread::hardware_concurrency();
+        threadCount = std::max(2U, std::min(cores > 1 ? cores - 1 : 1U, MAX_DECODE_THREADS));
+    }
+    _threadCount = threadCount;
+    _pool.reset(LegacyThreadPool::newFixedThreadPool(static_cast<int>(threadCount)));
+}
+
+ImageDecodeService::~ImageDecodeService() {
+    _pool->stopAllTasks();
+    _pool.reset();
+}
+
+void ImageDecodeService::decode(DecodeRequest &&request) {
+    auto task = std::make_shared<DecodeRequest>(std::move(request));
+    _pool->pushTask([task](int /*tid*/) {
+        run(task.get());
+    });
+}
+
+void ImageDecodeService::decodeBatch(ccstd::vector<DecodeRequest> &&requests) {
+    for (auto &request : requests) {
+        decode(std::move(request));
+    }
+}
+
+void ImageDecodeService::run(DecodeRequest *request) {
+    IntrusivePtr<Image> image{ccnew Image()};
+    bool succeed = false;
+    if (request->dst) {
+        // the encoded file is only read here, the pixels land in the caller's memory
+        IntrusivePtr<MappedFile> file;
+        if (request->path.empty()) {
+            file = ccnew MappedFile(std::move(request->data));
+        } else {
+            file = FileUtils::getInstance()->mapFile(request->path);
+        }
+        succeed = file && image->initWithImageData(file->getBytes(), file->getSize(), request->dst, request->dstLen);
+    } else if (request->path.empty()) {
+        succeed = image->initWithImageData(request->data.getBytes(), request->data.getSize());
+        request->data.clear();
+    } else {
+        succeed = image->initWithImageFile(request->path);
+    }
+
+    if (request->callback) {
+        request->callback(succeed ? image.get() : nullptr);
+    }
+}
+
+} // namespace cc
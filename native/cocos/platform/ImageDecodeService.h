@@ -0,0 +1,85 @@
+/****************************************************************************
+ Copyright (c) 2017-2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include "base/Data.h"
+#include "base/Macros.h"
+#include "base/std/container/string.h"
+#include "base/std/container/vector.h"
+
+namespace cc {
+
+class Image;
+class LegacyThreadPool;
+
+/**
+ *  Decodes images on a pool of worker threads, so several textures of a level load decode side by side.
+ *
+ *  Methods must be called on the main thread. Callbacks run on the decode thread that produced
+ *  the image; post to the cocos thread for anything that touches the engine.
+ */
+class CC_DLL ImageDecodeService final {
+public:
+    // image is nullptr when decoding failed, it is released after the callback returns unless retained
+    using Callback = std::function<void(Image *image)>;
+
+    struct DecodeRequest {
+        // full path of the encoded file, read on the decode thread
+        ccstd::string path;
+        // encoded contents already in memory, used when path is empty
+        Data data;
+        // optional caller memory to decode into, which must stay alive until the callback runs
+        unsigned char *dst{nullptr};
+        uint32_t dstLen{0};
+        Callback callback;
+    };
+
+    static ImageDecodeService *getInstance();
+    static void destroyInstance();
+
+    // threadCount 0 picks one thread per spare core
+    explicit ImageDecodeService(uint32_t threadCount = 0);
+    // waits for the decodes already running, pending ones are dropped
+    ~ImageDecodeService();
+
+    void decode(DecodeRequest &&request);
+    void decodeBatch(ccstd::vector<DecodeRequest> &&requests);
+
+    inline uint32_t getThreadCount() const { return _threadCount; }
+
+private:
+    static void run(DecodeRequest *request);
+
+    std::unique_ptr<LegacyThreadPool> _pool;
+    uint32_t _threadCount{0};
+
+    CC_DISALLOW_COPY_MOVE_ASSIGN(ImageDecodeService);
+};
+
+} // namespace cc
@@ -0,0 +1,123 @@
+/****************************************************************************
+ Copyright (c) 2017-2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+
+#include "platform/MappedFile.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <utility>
+#include "base/memory/Memory.h"
+
+#if (CC_PLATFORM != CC_PLATFORM_WINDOWS) && (CC_PLATFORM != CC_PLATFORM_WINRT)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #define CC_MAPPED_FILE_MMAP 1
+#endif
+
+namespace cc {
+
+namespace {
+// mapping costs a few syscalls and a page fault per page, below this a plain read is cheaper
+constexpr size_t MIN_MAPPED_SIZE = 64 * 1024;
+} // namespace
+
+IntrusivePtr<MappedFile> MappedFile::open(const ccstd::string &path, bool mappedOnly) {
+#if CC_MAPPED_FILE_MMAP
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        return nullptr;
+    }
+
+    struct stat statBuf;
+    if (fstat(fd, &statBuf) == -1 || !S_ISREG(statBuf.st_mode) || static_cast<uint64_t>(statBuf.st_size) > UINT32_MAX) {
+        ::close(fd);
+        return nullptr;
+    }
+    const auto size = static_cast<size_t>(statBuf.st_size);
+
+    IntrusivePtr<MappedFile> file{ccnew MappedFile()};
+    if (size >= MIN_MAPPED_SIZE) {
+        void *addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+            ::close(fd);
+            file->_bytes = static_cast<uint8_t *>(addr);
+            file->_size = static_cast<uint32_t>(size);
+            file->_mapped = true;
+            return file;
+        }
+        if (mappedOnly) {
+            ::close(fd);
+            return nullptr;
+        }
+    }
+
+    // small file, or the file system refused the mapping
+    if (size == 0) {
+        ::close(fd);
+        return file;
+    }
+    file->_data.resize(static_cast<uint32_t>(size));
+    size_t offset = 0;
+    while (offset < size) {
+        const ssize_t n = ::read(fd, file->_data.getBytes() + offset, size - offset);
+        if (n <= 0) {
+            if (n == -1 && errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        offset += static_cast<size_t>(n);
+    }
+    ::close(fd);
+    if (offset < size) {
+        return nullptr;
+    }
+    file->_bytes = file->_data.getBytes();
+    file->_size = file->_data.getSize();
+    return file;
+#else
+    CC_UNUSED_PARAM(path);
+    CC_UNUSED_PARAM(mappedOnly);
+    return nullptr;
+#endif
+}
+
+MappedFile::MappedFile(Data &&data)
+: _data(std::move(data)) {
+    _bytes = _data.getBytes();
+    _size = _data.getSize();
+}
+
+MappedFile::~MappedFile() {
+#if CC_MAPPED_FILE_MMAP
+    if (_mapped) {
+        munmap(_bytes, _size);
+    }
+#endif
+}
+
+} // namespace cc
@@ -0,0 +1,76 @@
+/****************************************************************************
+ Copyright (c) 2017-2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+
+#pragma once
+
+#include "base/Data.h"
+#include "base/Macros.h"
+#include "base/Ptr.h"
+#include "base/RefCounted.h"
+#include "base/std/container/string.h"
+
+namespace cc {
+
+/**
+ *  A refcounted read-only view of a whole file.
+ *
+ *  Large files on a local file system are memory mapped, so their pages are shared with the
+ *  page cache instead of being copied into a heap buffer. Small files, and platforms or paths
+ *  that cannot be mapped, keep the contents in a heap buffer read once.
+ *
+ *  The mapping is private: writes through the mapped pages (e.g. by a script owning an
+ *  ArrayBuffer created from it) only touch a copy of the written pages, never the file.
+ */
+class CC_DLL MappedFile final : public RefCounted {
+public:
+    /**
+     *  Opens and maps the file at the given native path.
+     *  @param mappedOnly Return nullptr instead of reading a file large enough to be mapped into
+     *  a heap buffer when the file system refuses the mapping.
+     *  @return nullptr when the file cannot be opened, so the caller can fall back to another reader.
+     */
+    static IntrusivePtr<MappedFile> open(const ccstd::string &path, bool mappedOnly = false);
+
+    /** Wraps contents already read into memory. */
+    explicit MappedFile(Data &&data);
+    ~MappedFile() override;
+
+    inline const uint8_t *getBytes() const { return _bytes; }
+    inline uint32_t getSize() const { return _size; }
+    // whether the contents are memory mapped or held in a heap buffer
+    inline bool isMapped() const { return _mapped; }
+
+private:
+    MappedFile() = default;
+
+    uint8_t *_bytes{nullptr};
+    uint32_t _size{0};
+    bool _mapped{false};
+    Data _data;
+
+    CC_DISALLOW_COPY_MOVE_ASSIGN(MappedFile);
+};
+
+} // namespace cc
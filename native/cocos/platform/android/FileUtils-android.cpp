@@ -31,7 +31,7 @@
 #include "android/asset_manager.h"
 #include "android/asset_manager_jni.h"
 #include "base/Log.h"
-#include "base/ZipUtils.h"
+#include "base/ZipArchive.h"
 #include "base/memory/Memory.h"
 #include "platform/java/jni/JniHelper.h"
 #include "platform/java/jni/JniImp.h"
@@ -48,7 +48,7 @@
 namespace cc {
 
 AAssetManager *FileUtilsAndroid::assetmanager = nullptr;
-ZipFile *FileUtilsAndroid::obbfile = nullptr;
+IntrusivePtr<ZipArchive> FileUtilsAndroid::obbfile;
 
 FileUtils *createFileUtils() {
     return ccnew FileUtilsAndroid();
@@ -68,7 +68,7 @@ FileUtilsAndroid::FileUtilsAndroid() {
 }
 
 FileUtilsAndroid::~FileUtilsAndroid() {
-    CC_SAFE_DELETE(obbfile);
+    obbfile = nullptr;
 }
 
 bool FileUtilsAndroid::init() {
@@ -76,7 +76,7 @@ bool FileUtilsAndroid::init() {
 
     ccstd::string assetsPath(getObbFilePathJNI());
     if (assetsPath.find("/obb/") != ccstd::string::npos) {
-        obbfile = ccnew ZipFile(assetsPath);
+        obbfile = ZipArchive::mount(assetsPath);
     }
 
     return FileUtils::init();
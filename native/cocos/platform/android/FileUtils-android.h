@@ -28,13 +28,14 @@
 
 #include "android/asset_manager.h"
 #include "base/Macros.h"
+#include "base/Ptr.h"
 #include "base/std/container/string.h"
 #include "jni.h"
 #include "platform/FileUtils.h"
 
 namespace cc {
 
-class ZipFile;
+class ZipArchive;
 
 /**
  * @addtogroup platform
@@ -51,7 +52,7 @@ public:
 
     static void setAssetManager(AAssetManager *a);
     static AAssetManager *getAssetManager() { return assetmanager; }
-    static ZipFile *getObbFile() { return obbfile; }
+    static ZipArchive *getObbFile() { return obbfile.get(); }
 
     /* override functions */
     bool init() override;
@@ -65,7 +66,7 @@ private:
     bool isDirectoryExistInternal(const ccstd::string &dirPath) const override;
 
     static AAssetManager *assetmanager;
-    static ZipFile *obbfile;
+    static IntrusivePtr<ZipArchive> obbfile;
 };
 
 // end of platform group
@@ -0,0 +1,384 @@
+/****************************************************************************
+ Copyright (c) 2017-2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+
+#include "platform/AsyncFileBackend.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <thread>
+#include <utility>
+#include "base/Log.h"
+
+#if __has_include(<linux/io_uring.h>)
+    #include <fcntl.h>
+    #include <linux/io_uring.h>
+    #include <sys/eventfd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+    #define CC_ASYNC_FILE_IO_URING 1
+#endif
+
+namespace cc {
+
+#if CC_ASYNC_FILE_IO_URING
+
+namespace {
+
+// one entry is kept for the doorbell read that wakes the ring up when requests are submitted
+constexpr uint32_t QUEUE_DEPTH = 256;
+constexpr uint32_t MAX_READS_IN_FLIGHT = QUEUE_DEPTH - 1;
+constexpr uint64_t DOORBELL_TAG = UINT64_MAX;
+// a single read never transfers more than this, larger files take several reads
+constexpr size_t MAX_READ_SIZE = 1U << 30U;
+
+int ioUringSetup(uint32_t entries, io_uring_params *params) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int ioUringEnter(int fd, uint32_t toSubmit, uint32_t minComplete, uint32_t flags) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0));
+}
+
+template <typename T>
+T loadAcquire(const T *ptr) {
+    return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+}
+
+template <typename T>
+void storeRelease(T *ptr, T value) {
+    __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+}
+
+class IOUringFileBackend final : public AsyncFileBackend {
+public:
+    explicit IOUringFileBackend(AsyncFileCompletion &&completion)
+    : _completion(std::move(completion)) {}
+
+    ~IOUringFileBackend() override {
+        if (_thread.joinable()) {
+            _stopping.store(true, std::memory_order_relaxed);
+            _queue.close();
+            ringDoorbell();
+            _thread.join();
+        }
+        if (_sqes) munmap(_sqes, _sqesSize);
+        if (_cqRing && _cqRing != _sqRing) munmap(_cqRing, _cqRingSize);
+        if (_sqRing) munmap(_sqRing, _sqRingSize);
+        if (_ringFd != -1) close(_ringFd);
+        if (_eventFd != -1) close(_eventFd);
+    }
+
+    bool initialize() {
+        io_uring_params params;
+        memset(&params, 0, sizeof(params));
+        _ringFd = ioUringSetup(QUEUE_DEPTH, &params);
+        // IORING_OP_READ came with the same kernel release as IORING_FEAT_RW_CUR_POS
+        if (_ringFd == -1 || !(params.features & IORING_FEAT_RW_CUR_POS)) {
+            return false;
+        }
+
+        _sqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+        _cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool singleMmap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (singleMmap) {
+            _sqRingSize = _cqRingSize = std::max(_sqRingSize, _cqRingSize);
+        }
+        _sqRing = mapRing(_sqRingSize, IORING_OFF_SQ_RING);
+        _cqRing = singleMmap ? _sqRing : mapRing(_cqRingSize, IORING_OFF_CQ_RING);
+        _sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        _sqes = static_cast<io_uring_sqe *>(mapRing(_sqesSize, IORING_OFF_SQES));
+        if (!_sqRing || !_cqRing || !_sqes) {
+            return false;
+        }
+
+        auto *sq = static_cast<uint8_t *>(_sqRing);
+        _sqHead = reinterpret_cast<uint32_t *>(sq + params.sq_off.head);
+        _sqTail = reinterpret_cast<uint32_t *>(sq + params.sq_off.tail);
+        _sqMask = *reinterpret_cast<uint32_t *>(sq + params.sq_off.ring_mask);
+        _sqEntries = params.sq_entries;
+        _sqArray = reinterpret_cast<uint32_t *>(sq + params.sq_off.array);
+        auto *cq = static_cast<uint8_t *>(_cqRing);
+        _cqHead = reinterpret_cast<uint32_t *>(cq + params.cq_off.head);
+        _cqTail = reinterpret_cast<uint32_t *>(cq + params.cq_off.tail);
+        _cqMask = *reinterpret_cast<uint32_t *>(cq + params.cq_off.ring_mask);
+        _cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+        _localSqTail = *_sqTail;
+
+        _eventFd = eventfd(0, EFD_CLOEXEC);
+        if (_eventFd == -1) {
+            return false;
+        }
+
+        _reads.resize(MAX_READS_IN_FLIGHT);
+        _freeSlots.reserve(MAX_READS_IN_FLIGHT);
+        for (uint32_t i = MAX_READS_IN_FLIGHT; i > 0; --i) {
+            _freeSlots.push_back(i - 1);
+        }
+
+        _thread = std::thread([this]() { run(); });
+        return true;
+    }
+
+    void submit(ccstd::vector<AsyncFileRequest> &&requests) override {
+        _queue.push(std::move(requests));
+        ringDoorbell();
+    }
+
+    // reads already handed to the kernel still complete, the reader drops their results
+    bool cancel(uint32_t id) override {
+        return _queue.remove(id);
+    }
+
+    void cancelAll() override {
+        _queue.clear();
+    }
+
+private:
+    struct Read {
+        uint32_t id{0};
+        int fd{-1};
+        Data data;
+        size_t size{0};
+        size_t offset{0};
+    };
+
+    void *mapRing(size_t size, off_t offset) const {
+        void *ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ringFd, offset);
+        return ptr == MAP_FAILED ? nullptr : ptr;
+    }
+
+    void ringDoorbell() const {
+        const uint64_t one = 1;
+        CC_UNUSED ssize_t n = write(_eventFd, &one, sizeof(one));
+    }
+
+    io_uring_sqe *nextSqe() {
+        // the ring is never overrun: at most one entry per slot plus the doorbell is outstanding
+        CC_ASSERT(_localSqTail - loadAcquire(_sqHead) < _sqEntries);
+        const uint32_t index = _localSqTail & _sqMask;
+        _sqArray[index] = index;
+        ++_localSqTail;
+        ++_toSubmit;
+        io_uring_sqe *sqe = &_sqes[index];
+        memset(sqe, 0, sizeof(*sqe));
+        return sqe;
+    }
+
+    void queueRead(int fd, void *buffer, uint32_t length, uint64_t offset, uint64_t tag) {
+        io_uring_sqe *sqe = nextSqe();
+        sqe->opcode = IORING_OP_READ;
+        sqe->fd = fd;
+        sqe->addr = reinterpret_cast<uint64_t>(buffer);
+        sqe->len = length;
+        sqe->off = offset;
+        sqe->user_data = tag;
+    }
+
+    void queueDoorbell() {
+        queueRead(_eventFd, &_doorbellValue, sizeof(_doorbellValue), 0, DOORBELL_TAG);
+    }
+
+    void queueNextChunk(uint32_t slot) {
+        Read &read = _reads[slot];
+        const auto length = static_cast<uint32_t>(std::min(read.size - read.offset, MAX_READ_SIZE));
+        queueRead(read.fd, read.data.getBytes() + read.offset, length, read.offset, slot);
+    }
+
+    void finish(uint32_t slot, FileUtils::Status status) {
+        Read &read = _reads[slot];
+        close(read.fd);
+        read.fd = -1;
+        if (status != FileUtils::Status::OK) {
+            read.data.clear();
+        }
+        _completion(read.id, status, std::move(read.data));
+        read.data = Data();
+        _freeSlots.push_back(slot);
+    }
+
+    // opens the files of pending requests and queues their first read, until all slots are used
+    void startReads() {
+        _started.clear();
+        _queue.tryPop(&_started, _freeSlots.size());
+        for (auto &request : _started) {
+            if (request.path.empty() || request.path[0] != '/') {
+                // not on the file system, e.g. packed assets
+                Data data;
+                const FileUtils::Status status = readWholeFile(request.path, &data);
+                _completion(request.id, status, std::move(data));
+                continue;
+            }
+            const int fd = open(request.path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd == -1) {
+                _completion(request.id, errno == ENOENT ? FileUtils::Status::NOT_EXISTS : FileUtils::Status::OPEN_FAILED, Data());
+                continue;
+            }
+            struct stat statBuf;
+            FileUtils::Status status = FileUtils::Status::OK;
+            if (fstat(fd, &statBuf) == -1) {
+                status = FileUtils::Status::OBTAIN_SIZE_FAILED;
+            } else if (static_cast<uint64_t>(statBuf.st_size) > UINT32_MAX) {
+                status = FileUtils::Status::TOO_LARGE;
+            }
+            if (status != FileUtils::Status::OK || statBuf.st_size == 0) {
+                close(fd);
+                _completion(request.id, status, Data());
+                continue;
+            }
+
+            const uint32_t slot = _freeSlots.back();
+            _freeSlots.pop_back();
+            Read &read = _reads[slot];
+            read.id = request.id;
+            read.fd = fd;
+            read.size = static_cast<size_t>(statBuf.st_size);
+            read.offset = 0;
+            read.data.resize(static_cast<uint32_t>(read.size));
+            queueNextChunk(slot);
+        }
+    }
+
+    void handleCompletion(const io_uring_cqe &cqe) {
+        if (cqe.user_data == DOORBELL_TAG) {
+            if (!_stopping.load(std::memory_order_relaxed)) {
+                queueDoorbell();
+            } else {
+                _doorbellArmed = false;
+            }
+            return;
+        }
+
+        const auto slot = static_cast<uint32_t>(cqe.user_data);
+        Read &read = _reads[slot];
+        if (cqe.res == -EINTR || cqe.res == -EAGAIN) {
+            queueNextChunk(slot);
+        } else if (cqe.res <= 0) {
+            // an error, or the file was truncated while being read
+            finish(slot, FileUtils::Status::READ_FAILED);
+        } else {
+            read.offset += static_cast<size_t>(cqe.res);
+            if (read.offset < read.size) {
+                queueNextChunk(slot);
+            } else {
+                finish(slot, FileUtils::Status::OK);
+            }
+        }
+    }
+
+    void run() {
+        queueDoorbell();
+        _doorbellArmed = true;
+        while (_doorbellArmed || _freeSlots.size() < MAX_READS_IN_FLIGHT) {
+            if (!_stopping.load(std::memory_order_relaxed)) {
+                startReads();
+            }
+
+            storeRelease(_sqTail, _localSqTail);
+            const int submitted = ioUringEnter(_ringFd, _toSubmit, 1, IORING_ENTER_GETEVENTS);
+            if (submitted < 0) {
+                if (errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+                    continue;
+                }
+                CC_LOG_ERROR("io_uring_enter failed: %d", errno);
+                break;
+            }
+            _toSubmit -= static_cast<uint32_t>(submitted);
+
+            uint32_t head = *_cqHead;
+            const uint32_t tail = loadAcquire(_cqTail);
+            for (; head != tail; ++head) {
+                handleCompletion(_cqes[head & _cqMask]);
+            }
+            storeRelease(_cqHead, head);
+        }
+
+        // the ring failed, serve the remaining requests with blocking reads until the backend is destroyed
+        AsyncFileRequest request;
+        while (!_stopping.load(std::memory_order_relaxed) && _queue.pop(&request)) {
+            Data data;
+            const FileUtils::Status status = readWholeFile(request.path, &data);
+            _completion(request.id, status, std::move(data));
+        }
+    }
+
+    AsyncFileRequestQueue _queue;
+    AsyncFileCompletion _completion;
+    std::thread _thread;
+    std::atomic<bool> _stopping{false};
+
+    int _ringFd{-1};
+    int _eventFd{-1};
+    void *_sqRing{nullptr};
+    void *_cqRing{nullptr};
+    io_uring_sqe *_sqes{nullptr};
+    size_t _sqRingSize{0};
+    size_t _cqRingSize{0};
+    size_t _sqesSize{0};
+
+    uint32_t *_sqHead{nullptr};
+    uint32_t *_sqTail{nullptr};
+    uint32_t *_sqArray{nullptr};
+    uint32_t _sqMask{0};
+    uint32_t _sqEntries{0};
+    uint32_t _localSqTail{0};
+    uint32_t _toSubmit{0};
+    uint32_t *_cqHead{nullptr};
+    uint32_t *_cqTail{nullptr};
+    uint32_t _cqMask{0};
+    io_uring_cqe *_cqes{nullptr};
+
+    // only touched by the ring thread
+    ccstd::vector<Read> _reads;
+    ccstd::vector<uint32_t> _freeSlots;
+    ccstd::vector<AsyncFileRequest> _started;
+    uint64_t _doorbellValue{0};
+    bool _doorbellArmed{false};
+
+    CC_DISALLOW_COPY_MOVE_ASSIGN(IOUringFileBackend);
+};
+
+} // namespace
+
+std::unique_ptr<AsyncFileBackend> createIOUringFileBackend(AsyncFileCompletion &&completion) {
+    auto backend = std::make_unique<IOUringFileBackend>(std::move(completion));
+    if (!backend->initialize()) {
+        return nullptr;
+    }
+    return backend;
+}
+
+#else
+
+std::unique_ptr<AsyncFileBackend> createIOUringFileBackend(AsyncFileCompletion && /*completion*/) {
+    return nullptr;
+}
+
+#endif
+
+} // namespace cc
@@ -39,6 +39,7 @@
 
 #include "base/memory/Memory.h"
 #include "base/Log.h"
+#include "base/ZipArchive.h"
 
 namespace cc {
 
@@ -240,6 +241,8 @@ bool FileUtilsOpenHarmony::renameFile(const std::string &oldfullpath, const std:
 }
 
 bool FileUtilsOpenHarmony::removeFile(const std::string &filepath) {
+    // an archive mounted from the file must not be served after it is gone
+    ZipArchive::unmount(filepath);
     return remove(filepath.c_str()) == 0;
 }
 
@@ -30,6 +30,7 @@
 #include <regex>
 #include <sstream>
 #include "base/Log.h"
+#include "base/ZipArchive.h"
 #include "base/memory/Memory.h"
 #include "platform/win32/Utils-win32.h"
 
@@ -321,6 +322,8 @@ bool FileUtilsWin32::removeFile(const ccstd::string &filepath) {
     std::regex pat("\\/");
     ccstd::string win32path = std::regex_replace(filepath, pat, "\\");
 
+    // an archive mounted from the file must not be served after it is gone
+    ZipArchive::unmount(filepath);
     if (DeleteFile(StringUtf8ToWideChar(win32path).c_str())) {
         return true;
     } else {
@@ -117,6 +117,31 @@ public:
         return nullptr;
     }
 
+    // A device on the empty backend, optionally behind the agent, without the validation layer.
+    // Lets the CPU side of the renderer be measured headless. It is always a new device, created
+    // next to the one of the application if there is one, and stands in as the current instance
+    // until destroyHeadless() puts the previous instances back.
+    static Device *createHeadless(const DeviceInfo &info, bool detachDeviceThread) {
+        CC_ASSERT(!headlessState.active);
+        headlessState = {true, Device::instance, DeviceAgent::instance, EmptyDevice::instance};
+
+        Device *device = ccnew EmptyDevice;
+        if (detachDeviceThread) {
+            device = ccnew gfx::DeviceAgent(device);
+        }
+        if (!device->initialize(info)) {
+            CC_SAFE_DELETE(device);
+            restoreInstances();
+        }
+        return device;
+    }
+
+    static void destroyHeadless(Device *device) {
+        CC_ASSERT(headlessState.active);
+        CC_SAFE_DESTROY_AND_DELETE(device);
+        restoreInstances();
+    }
+
     static bool isDetachDeviceThread() {
         return DETACH_DEVICE_THREAD && Device::isSupportDetachDeviceThread;
     }
@@ -141,6 +166,22 @@ public:
     }
 
 private:
+    // the instances that were current before createHeadless()
+    struct HeadlessState {
+        bool active;
+        Device *device;
+        DeviceAgent *deviceAgent;
+        EmptyDevice *emptyDevice;
+    };
+    static inline HeadlessState headlessState{false, nullptr, nullptr, nullptr};
+
+    static void restoreInstances() {
+        Device::instance = headlessState.device;
+        DeviceAgent::instance = headlessState.deviceAgent;
+        EmptyDevice::instance = headlessState.emptyDevice;
+        headlessState = HeadlessState{};
+    }
+
     template <typename DeviceCtor, typename Enable = std::enable_if_t<std::is_base_of<Device, DeviceCtor>::value>>
     static bool tryCreate(const DeviceInfo &info, Device **pDevice) {
         Device *device = ccnew DeviceCtor;
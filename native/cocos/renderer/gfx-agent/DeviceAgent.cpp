@@ -27,6 +27,7 @@
 #include "application/ApplicationManager.h"
 #include "base/Log.h"
 #include "base/threading/MessageQueue.h"
+#include "base/threading/MultiProducerMessageQueue.h"
 #include "base/threading/ThreadSafeLinearAllocator.h"
 #include "platform/interfaces/modules/IXRInterface.h"
 
@@ -91,6 +92,8 @@ bool DeviceAgent::doInit(const DeviceInfo &info) {
 }
 
 void DeviceAgent::doDestroy() {
+    setWorkerMessageQueueEnabled(false);
+
     if (!_mainMessageQueue) {
         _actor->destroy();
     } else {
@@ -146,6 +149,8 @@ void DeviceAgent::acquire(Swapchain *const *swapchains, uint32_t count) {
 }
 
 void DeviceAgent::present() {
+    flushWorkerMessages();
+
     if (_xr) {
         ENQUEUE_MESSAGE_1(
             _mainMessageQueue, DevicePresent,
@@ -205,6 +210,43 @@ void DeviceAgent::setMultithreaded(bool multithreaded) {
     }
 }
 
+void DeviceAgent::setWorkerMessageQueueEnabled(bool enabled) {
+    if (enabled == (_workerMessageQueue != nullptr)) return;
+
+    if (enabled) {
+        // never executes on its own, the device thread drains it in flushWorkerMessages
+        _workerMessageQueue = ccnew MultiProducerMessageQueue;
+        _workerMessageQueue->setImmediateMode(false);
+        return;
+    }
+
+    auto *workerMessageQueue = _workerMessageQueue;
+    _workerMessageQueue = nullptr;
+    if (!_mainMessageQueue) {
+        workerMessageQueue->flushMessages();
+        delete workerMessageQueue;
+        return;
+    }
+    ENQUEUE_MESSAGE_1(
+        _mainMessageQueue, DeviceDestroyWorkerMessageQueue,
+        queue, workerMessageQueue,
+        {
+            queue->flushMessages();
+            delete queue;
+        });
+}
+
+void DeviceAgent::flushWorkerMessages() {
+    if (!_workerMessageQueue) return;
+
+    ENQUEUE_MESSAGE_1(
+        _mainMessageQueue, DeviceFlushWorkerMessages,
+        queue, _workerMessageQueue,
+        {
+            queue->flushMessages();
+        });
+}
+
 CommandBuffer *DeviceAgent::createCommandBuffer(const CommandBufferInfo &info, bool /*hasAgent*/) {
     CommandBuffer *actor = _actor->createCommandBuffer(info, true);
     return ccnew CommandBufferAgent(actor);
@@ -291,8 +333,8 @@ BufferBarrier *DeviceAgent::getBufferBarrier(const BufferBarrierInfo &info) {
     return _actor->getBufferBarrier(info);
 }
 
-template <typename T>
-void doBufferTextureCopy(const uint8_t *const *buffers, Texture *texture, const BufferTextureCopy *regions, uint32_t count, MessageQueue *mq, T *actor) {
+template <typename Q, typename T>
+void doBufferTextureCopy(const uint8_t *const *buffers, Texture *texture, const BufferTextureCopy *regions, uint32_t count, Q *mq, T *actor) {
     uint32_t bufferCount = 0U;
     for (uint32_t i = 0U; i < count; i++) {
         bufferCount += regions[i].texSubres.layerCount;
@@ -367,6 +409,12 @@ void DeviceAgent::copyBuffersToTexture(const uint8_t *const *buffers, Texture *d
     doBufferTextureCopy(buffers, dst, regions, count, _mainMessageQueue, _actor);
 }
 
+void DeviceAgent::copyBuffersToTextureFromWorker(const uint8_t *const *buffers, Texture *dst, const BufferTextureCopy *regions, uint32_t count) {
+    CC_ASSERT(_workerMessageQueue);
+    doBufferTextureCopy(buffers, dst, regions, count, _workerMessageQueue, _actor);
+    _workerMessageQueue->kick();
+}
+
 void CommandBufferAgent::copyBuffersToTexture(const uint8_t *const *buffers, Texture *texture, const BufferTextureCopy *regions, uint32_t count) {
     doBufferTextureCopy(buffers, texture, regions, count, _messageQueue, _actor);
 }
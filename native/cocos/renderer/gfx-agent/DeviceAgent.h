@@ -32,6 +32,7 @@
 namespace cc {
 class IXRInterface;
 class MessageQueue;
+class MultiProducerMessageQueue;
 
 namespace gfx {
 
@@ -102,6 +103,16 @@ public:
 
     inline MessageQueue *getMessageQueue() const { return _mainMessageQueue; }
 
+    // Opt-in queue for worker threads to enqueue device work into without locking.
+    // Kicked messages are executed on the device thread before the next present.
+    // Resources used by the messages must be created on the main thread first,
+    // and workers must stop enqueuing before the queue is disabled.
+    void setWorkerMessageQueueEnabled(bool enabled);
+    inline MultiProducerMessageQueue *getWorkerMessageQueue() const { return _workerMessageQueue; }
+
+    // Same as copyBuffersToTexture, but callable from worker threads once the worker queue is enabled.
+    void copyBuffersToTextureFromWorker(const uint8_t *const *buffers, Texture *dst, const BufferTextureCopy *regions, uint32_t count);
+
     void presentWait();
     void presentSignal();
 
@@ -118,8 +129,11 @@ protected:
     bool doInit(const DeviceInfo &info) override;
     void doDestroy() override;
 
+    void flushWorkerMessages();
+
     bool _multithreaded{false};
     MessageQueue *_mainMessageQueue{nullptr};
+    MultiProducerMessageQueue *_workerMessageQueue{nullptr};
 
     uint32_t _currentIndex = 0U;
 #if CC_USE_XR
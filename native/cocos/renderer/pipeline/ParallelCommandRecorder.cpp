@@ -0,0 +1,104 @@
+/****************************************************************************
+ Copyright (c) 2020-2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+
+#include "ParallelCommandRecorder.h"
+#include <algorithm>
+#include "base/job-system/JobSystem.h"
+#include "gfx-base/GFXCommandBuffer.h"
+#include "gfx-base/GFXDevice.h"
+
+namespace cc {
+namespace pipeline {
+
+ParallelCommandRecorder::ParallelCommandRecorder(gfx::Device *device)
+: _device(device) {
+}
+
+ParallelCommandRecorder::~ParallelCommandRecorder() {
+    destroy();
+}
+
+bool ParallelCommandRecorder::isSupported(const gfx::Device *device) {
+    return device && device->getGfxAPI() == gfx::API::UNKNOWN;
+}
+
+void ParallelCommandRecorder::record(gfx::CommandBuffer *cmdBuffer, gfx::RenderPass *renderPass, uint32_t subpassIndex,
+                                     uint32_t count, uint32_t chunkSize, const RecordFunc &recordRange) {
+    if (!count) return;
+    CC_ASSERT(chunkSize);
+
+    uint32_t const chunkCount = (count - 1) / chunkSize + 1;
+    _chunkCmdBuffers.clear();
+    for (uint32_t i = 0U; i < chunkCount; ++i) {
+        _chunkCmdBuffers.push_back(requestCommandBuffer());
+    }
+
+    auto recordChunk = [&](uint32_t i) {
+        gfx::CommandBuffer *chunkCmdBuffer = _chunkCmdBuffers[i];
+        uint32_t const begin = i * chunkSize;
+        chunkCmdBuffer->begin(renderPass, subpassIndex);
+        recordRange(chunkCmdBuffer, begin, std::min(begin + chunkSize, count));
+        chunkCmdBuffer->end();
+    };
+
+    if (chunkCount > 1) {
+        JobGraph g(JobSystem::getInstance());
+        g.createForEachIndexJob(1U, chunkCount, 1U, recordChunk);
+        g.run();
+        recordChunk(0U); // the calling thread takes the first chunk
+        g.waitForAll();
+    } else {
+        recordChunk(0U);
+    }
+
+    cmdBuffer->execute(_chunkCmdBuffers.data(), chunkCount);
+}
+
+void ParallelCommandRecorder::flush() {
+    if (!_usedCount) return;
+
+    _device->flushCommands(_cmdBuffers.data(), _usedCount);
+    _usedCount = 0;
+}
+
+void ParallelCommandRecorder::destroy() {
+    for (auto *cmdBuffer : _cmdBuffers) {
+        CC_SAFE_DESTROY_AND_DELETE(cmdBuffer);
+    }
+    _cmdBuffers.clear();
+    _chunkCmdBuffers.clear();
+    _usedCount = 0;
+}
+
+gfx::CommandBuffer *ParallelCommandRecorder::requestCommandBuffer() {
+    // never reuse a command buffer within a frame, the agent replays all of them after the frame is recorded
+    if (_usedCount == _cmdBuffers.size()) {
+        _cmdBuffers.push_back(_device->createCommandBuffer({_device->getQueue(), gfx::CommandBufferType::SECONDARY}));
+    }
+    return _cmdBuffers[_usedCount++];
+}
+
+} // namespace pipeline
+} // namespace cc
@@ -0,0 +1,80 @@
+/****************************************************************************
+ Copyright (c) 2020-2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+
+#pragma once
+
+#include <functional>
+#include "base/Macros.h"
+#include "base/std/container/vector.h"
+
+namespace cc {
+
+namespace gfx {
+class Device;
+class RenderPass;
+class CommandBuffer;
+} // namespace gfx
+
+namespace pipeline {
+
+// Records ranges of a render queue into secondary command buffers on job-system workers,
+// and executes them in order from the primary command buffer.
+class CC_DLL ParallelCommandRecorder final {
+public:
+    using RecordFunc = std::function<void(gfx::CommandBuffer *cmdBuffer, uint32_t begin, uint32_t end)>;
+
+    explicit ParallelCommandRecorder(gfx::Device *device);
+    ~ParallelCommandRecorder();
+
+    // Vulkan only accepts secondary command buffers in render passes begun for them exclusively,
+    // GLES aborts on `execute` and Metal skips them, so only the empty backend (directly or behind
+    // the agent) can replay them inside the inline render passes the pipeline records.
+    static bool isSupported(const gfx::Device *device);
+
+    // `recordRange` may be invoked concurrently, so it must not create any gfx object.
+    void record(gfx::CommandBuffer *cmdBuffer, gfx::RenderPass *renderPass, uint32_t subpassIndex,
+                uint32_t count, uint32_t chunkSize, const RecordFunc &recordRange);
+
+    // Hands the secondary command buffers recorded this frame over to the device,
+    // must be called before the primary command buffers are flushed.
+    void flush();
+
+    void destroy();
+
+private:
+    gfx::CommandBuffer *requestCommandBuffer();
+
+    // weak reference
+    gfx::Device *_device{nullptr};
+    // manage memory manually
+    ccstd::vector<gfx::CommandBuffer *> _cmdBuffers;
+    ccstd::vector<gfx::CommandBuffer *> _chunkCmdBuffers;
+    uint32_t _usedCount{0};
+
+    CC_DISALLOW_COPY_MOVE_ASSIGN(ParallelCommandRecorder);
+};
+
+} // namespace pipeline
+} // namespace cc
@@ -24,7 +24,9 @@
 
 #include "RenderInstancedQueue.h"
 #include "InstancedBuffer.h"
+#include "ParallelCommandRecorder.h"
 #include "PipelineStateManager.h"
+#include "RenderPipeline.h"
 #include "gfx-base/GFXCommandBuffer.h"
 #include "gfx-base/GFXDescriptorSet.h"
 #include "gfx-base/GFXDevice.h"
@@ -59,6 +61,18 @@ void RenderInstancedQueue::uploadBuffers(gfx::CommandBuffer *cmdBuffer) {
 
 void RenderInstancedQueue::recordCommandBuffer(gfx::Device * /*device*/, gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuffer,
                                                gfx::DescriptorSet *ds, uint32_t offset, const ccstd::vector<uint32_t> *dynamicOffsets) {
+    const auto *pipeline = RenderPipeline::getInstance();
+    if (pipeline && pipeline->isParallelRecordingEnabled()) {
+        uint32_t drawCount = 0;
+        for (const auto *instanceBuffer : _queues) {
+            if (instanceBuffer->hasPendingModels()) drawCount += static_cast<uint32_t>(instanceBuffer->getInstances().size());
+        }
+        if (pipeline->shouldRecordInParallel(drawCount)) {
+            recordCommandBufferInParallel(renderPass, cmdBuffer, ds, offset, dynamicOffsets);
+            return;
+        }
+    }
+
     auto recordCommands = [&](const auto &renderQueue) {
         for (const auto *instanceBuffer : renderQueue) {
             if (!instanceBuffer->hasPendingModels()) continue;
@@ -95,6 +109,61 @@ void RenderInstancedQueue::recordCommandBuffer(gfx::Device * /*device*/, gfx::Re
     }
 }
 
+void RenderInstancedQueue::recordCommandBufferInParallel(gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuffer,
+                                                         gfx::DescriptorSet *ds, uint32_t offset, const ccstd::vector<uint32_t> *dynamicOffsets) {
+    // flatten the instances in recording order and resolve the pipeline states on this thread,
+    // the pipeline state cache isn't thread-safe
+    _draws.clear();
+    auto collectDraws = [&](const auto &renderQueue) {
+        for (const auto *instanceBuffer : renderQueue) {
+            if (!instanceBuffer->hasPendingModels()) continue;
+
+            const auto *pass = instanceBuffer->getPass();
+            for (const auto &instance : instanceBuffer->getInstances()) {
+                if (!instance.drawInfo.instanceCount) {
+                    continue;
+                }
+                auto *pso = PipelineStateManager::getOrCreatePipelineState(pass, instance.shader, instance.ia, renderPass);
+                _draws.push_back({instanceBuffer, &instance, pso});
+            }
+        }
+    };
+
+    if (_renderQueues.empty()) {
+        collectDraws(_queues);
+    } else {
+        collectDraws(_renderQueues);
+    }
+
+    auto recordRange = [&](gfx::CommandBuffer *chunkCmdBuffer, uint32_t begin, uint32_t end) {
+        const InstancedBuffer *lastInstanceBuffer = nullptr;
+        gfx::PipelineState *lastPSO = nullptr;
+        for (uint32_t i = begin; i < end; ++i) {
+            const auto &draw = _draws[i];
+            if (lastInstanceBuffer != draw.instanceBuffer) {
+                chunkCmdBuffer->bindDescriptorSet(materialSet, draw.instanceBuffer->getPass()->getDescriptorSet());
+                lastInstanceBuffer = draw.instanceBuffer;
+                lastPSO = nullptr;
+            }
+            if (lastPSO != draw.pipelineState) {
+                chunkCmdBuffer->bindPipelineState(draw.pipelineState);
+                lastPSO = draw.pipelineState;
+            }
+            if (ds) chunkCmdBuffer->bindDescriptorSet(globalSet, ds, 1, &offset);
+            if (dynamicOffsets) {
+                chunkCmdBuffer->bindDescriptorSet(localSet, draw.instance->descriptorSet, *dynamicOffsets);
+            } else {
+                chunkCmdBuffer->bindDescriptorSet(localSet, draw.instance->descriptorSet, draw.instanceBuffer->dynamicOffsets());
+            }
+            chunkCmdBuffer->bindInputAssembler(draw.instance->ia);
+            chunkCmdBuffer->draw(draw.instance->ia);
+        }
+    };
+    auto *pipeline = RenderPipeline::getInstance();
+    pipeline->getParallelCommandRecorder()->record(cmdBuffer, renderPass, 0, static_cast<uint32_t>(_draws.size()),
+                                                   pipeline->getParallelRecordingChunkSize(), recordRange);
+}
+
 void RenderInstancedQueue::add(InstancedBuffer *instancedBuffer) {
     _queues.emplace(instancedBuffer);
 }
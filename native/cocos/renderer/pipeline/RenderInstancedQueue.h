@@ -37,11 +37,13 @@ class Device;
 class RenderPass;
 class CommandBuffer;
 class DescriptorSet;
+class PipelineState;
 } // namespace gfx
 
 namespace pipeline {
 
 class InstancedBuffer;
+struct InstancedItem;
 
 class CC_DLL RenderInstancedQueue final : public RefCounted {
 public:
@@ -56,9 +58,19 @@ public:
     bool empty() { return _queues.empty(); }
 
 private:
+    struct InstancedDraw {
+        const InstancedBuffer *instanceBuffer{nullptr};
+        const InstancedItem *instance{nullptr};
+        gfx::PipelineState *pipelineState{nullptr};
+    };
+
+    void recordCommandBufferInParallel(gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuffer,
+                                       gfx::DescriptorSet *ds, uint32_t offset, const ccstd::vector<uint32_t> *dynamicOffsets);
+
     // `InstancedBuffer *`: weak reference
     ccstd::set<InstancedBuffer *> _queues;
     ccstd::vector<InstancedBuffer *> _renderQueues;
+    ccstd::vector<InstancedDraw> _draws;
 };
 
 } // namespace pipeline
@@ -28,11 +28,13 @@
 #endif
 #include "GlobalDescriptorSetManager.h"
 #include "InstancedBuffer.h"
+#include "ParallelCommandRecorder.h"
 #include "PipelineSceneData.h"
 #include "PipelineStateManager.h"
 #include "PipelineUBO.h"
 #include "RenderFlow.h"
 #include "base/StringUtil.h"
+#include "base/job-system/JobSystem.h"
 #include "base/std/hash/hash.h"
 #include "frame-graph/FrameGraph.h"
 #include "gfx-base/GFXDevice.h"
@@ -64,6 +66,7 @@ RenderPipeline::RenderPipeline()
 
     _globalDSManager = ccnew GlobalDSManager();
     _pipelineUBO = ccnew PipelineUBO();
+    _parallelCommandRecorder = ccnew ParallelCommandRecorder(_device);
 }
 
 RenderPipeline::~RenderPipeline() {
@@ -76,6 +79,15 @@ bool RenderPipeline::initialize(const RenderPipelineInfo &info) {
     return true;
 }
 
+bool RenderPipeline::isParallelRecordingEnabled() const {
+    return _parallelRecordingEnabled && JobSystem::getInstance()->threadCount() > 1 && ParallelCommandRecorder::isSupported(_device);
+}
+
+bool RenderPipeline::shouldRecordInParallel(uint32_t drawCount) const {
+    // the calling thread records a chunk too, so anything below two chunks stays sequential
+    return drawCount >= 2 * _parallelRecordingChunkSize && isParallelRecordingEnabled();
+}
+
 bool RenderPipeline::isEnvmapEnabled() const {
     return _pipelineSceneData->getSkybox()->isUseIBL();
 }
@@ -158,6 +170,7 @@ bool RenderPipeline::destroy() {
     _descriptorSet = nullptr;
     CC_SAFE_DESTROY_AND_DELETE(_globalDSManager);
     CC_SAFE_DESTROY_AND_DELETE(_pipelineUBO);
+    CC_SAFE_DESTROY_AND_DELETE(_parallelCommandRecorder);
     CC_SAFE_DESTROY_NULL(_pipelineSceneData);
 #if CC_USE_DEBUG_RENDERER
     CC_DEBUG_RENDERER->destroy();
@@ -54,6 +54,7 @@ class PipelineSceneData;
 class GlobalDSManager;
 class RenderStage;
 class GeometryRenderer;
+class ParallelCommandRecorder;
 struct CC_DLL RenderPipelineInfo {
     uint32_t tag = 0;
     RenderFlowList flows;
@@ -106,6 +107,14 @@ public:
 #endif
     }
     void setOcclusionQueryEnabled(bool enable) { _occlusionQueryEnabled = enable; }
+
+    bool isParallelRecordingEnabled() const;
+    void setParallelRecordingEnabled(bool enable) { _parallelRecordingEnabled = enable; }
+    uint32_t getParallelRecordingChunkSize() const { return _parallelRecordingChunkSize; }
+    void setParallelRecordingChunkSize(uint32_t size) { _parallelRecordingChunkSize = std::max(size, 1U); }
+    // whether a queue of `drawCount` draws is worth splitting into secondary command buffers
+    bool shouldRecordInParallel(uint32_t drawCount) const;
+    inline ParallelCommandRecorder *getParallelCommandRecorder() const { return _parallelCommandRecorder; }
     bool isEnvmapEnabled() const;
 
     gfx::Viewport getViewport(scene::Camera *camera);
@@ -200,6 +209,10 @@ protected:
     bool _clusterEnabled{false};
     bool _bloomEnabled{false};
     bool _occlusionQueryEnabled{false};
+    bool _parallelRecordingEnabled{false};
+    uint32_t _parallelRecordingChunkSize{256};
+    // manage memory manually
+    ParallelCommandRecorder *_parallelCommandRecorder{nullptr};
 
     bool _resetRenderQueue{true};
 
@@ -26,6 +26,7 @@
 
 #include <utility>
 #include "PipelineSceneData.h"
+#include "ParallelCommandRecorder.h"
 #include "PipelineStateManager.h"
 #include "RenderPipeline.h"
 #include "gfx-base/GFXCommandBuffer.h"
@@ -80,6 +81,11 @@ void RenderQueue::sort() {
 void RenderQueue::recordCommandBuffer(gfx::Device * /*device*/, scene::Camera *camera, gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuff, uint32_t subpassIndex) {
     PipelineSceneData *const sceneData = _pipeline->getPipelineSceneData();
     bool enableOcclusionQuery = _pipeline->isOcclusionQueryEnabled() && _useOcclusionQuery;
+    if (!enableOcclusionQuery && _pipeline->shouldRecordInParallel(static_cast<uint32_t>(_queue.size()))) {
+        recordCommandBufferInParallel(renderPass, cmdBuff, subpassIndex);
+        return;
+    }
+
     auto *queryPool = _pipeline->getQueryPools()[0];
     for (auto &i : _queue) {
         const auto *subModel = i.subModel;
@@ -118,5 +124,31 @@ void RenderQueue::recordCommandBuffer(gfx::Device * /*device*/, scene::Camera *c
     }
 }
 
+void RenderQueue::recordCommandBufferInParallel(gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuff, uint32_t subpassIndex) {
+    // pipeline states are created on demand and the cache isn't thread-safe, resolve them up front
+    _pipelineStates.resize(_queue.size());
+    for (size_t i = 0; i < _queue.size(); ++i) {
+        const auto *subModel = _queue[i].subModel;
+        const auto passIdx = _queue[i].passIndex;
+        _pipelineStates[i] = PipelineStateManager::getOrCreatePipelineState(subModel->getPass(passIdx), subModel->getShader(passIdx), subModel->getInputAssembler(), renderPass, subpassIndex);
+    }
+
+    auto recordRange = [this](gfx::CommandBuffer *chunkCmdBuff, uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            const auto *subModel = _queue[i].subModel;
+            const auto *pass = subModel->getPass(_queue[i].passIndex);
+            auto *inputAssembler = subModel->getInputAssembler();
+
+            chunkCmdBuff->bindPipelineState(_pipelineStates[i]);
+            chunkCmdBuff->bindDescriptorSet(materialSet, pass->getDescriptorSet());
+            chunkCmdBuff->bindDescriptorSet(localSet, subModel->getDescriptorSet());
+            chunkCmdBuff->bindInputAssembler(inputAssembler);
+            chunkCmdBuff->draw(inputAssembler);
+        }
+    };
+    _pipeline->getParallelCommandRecorder()->record(cmdBuff, renderPass, subpassIndex, static_cast<uint32_t>(_queue.size()),
+                                                    _pipeline->getParallelRecordingChunkSize(), recordRange);
+}
+
 } // namespace pipeline
 } // namespace cc
@@ -45,9 +45,12 @@ public:
     bool empty() { return _queue.empty(); }
 
 private:
+    void recordCommandBufferInParallel(gfx::RenderPass *renderPass, gfx::CommandBuffer *cmdBuff, uint32_t subpassIndex);
+
     // weak reference
     RenderPipeline *_pipeline{nullptr};
     RenderPassList _queue;
+    ccstd::vector<gfx::PipelineState *> _pipelineStates;
     RenderQueueCreateInfo _passDesc;
     bool _useOcclusionQuery{false};
 };
@@ -237,7 +237,16 @@ void sceneCulling(const RenderPipeline *pipeline, scene::Camera *camera) {
             sceneData->addRenderObject(genRenderObject(model, camera));
         }
     } else {
-        for (const auto &model : scene->getModels()) {
+        const auto &models = scene->getModels();
+        const auto &modelBounds = scene->getModelBounds();
+        const bool useModelBounds = modelBounds.size() == models.size();
+        ccstd::vector<uint8_t> frustumVisible;
+        if (useModelBounds) {
+            frustumVisible.resize(models.size());
+            modelBounds.cullFrustum(camera->getFrustum(), 0, static_cast<uint32_t>(models.size()), frustumVisible.data());
+        }
+        for (uint32_t modelIdx = 0; modelIdx < models.size(); ++modelIdx) {
+            const auto &model = models[modelIdx];
             // filter model by view visibility
             if (model->isEnabled()) {
                 if (scene->isCulledByLod(camera, model)) {
@@ -261,7 +270,7 @@ void sceneCulling(const RenderPipeline *pipeline, scene::Camera *camera) {
                     }
 
                     // frustum culling
-                    if (modelWorldBounds->aabbFrustum(camera->getFrustum())) {
+                    if (useModelBounds ? frustumVisible[modelIdx] : modelWorldBounds->aabbFrustum(camera->getFrustum())) {
                         sceneData->addRenderObject(genRenderObject(model, camera));
                     }
                 }
@@ -148,6 +148,27 @@ struct BarrierNode {
     ccstd::vector<Barrier> rearBarriers;
 };
 
+struct ScheduledPass {
+    RenderGraph::vertex_descriptor passID{0xFFFFFFFF};
+    gfx::QueueType queue{gfx::QueueType::GRAPHICS};
+    uint32_t queueIndex{0};
+    uint32_t level{0};
+};
+
+struct QueueSync {
+    gfx::QueueType signalQueue{gfx::QueueType::GRAPHICS};
+    gfx::QueueType waitQueue{gfx::QueueType::GRAPHICS};
+    RenderGraph::vertex_descriptor signalPass{0xFFFFFFFF};
+    RenderGraph::vertex_descriptor waitPass{0xFFFFFFFF};
+    uint32_t fenceValue{0};
+};
+
+struct PassSchedule {
+    ccstd::vector<ScheduledPass> passes;
+    ccstd::vector<QueueSync> syncs;
+    ccstd::vector<Barrier> queueTransfers;
+};
+
 struct SliceNode {
     bool full{false};
     ccstd::vector<uint32_t> mips;
@@ -462,8 +483,16 @@ struct FrameGraphDispatcher {
 
     void enableMemoryAliasing(bool enable);
 
+    // run standalone compute passes on the async compute queue when graphics work can overlap them,
+    // the multi-queue schedule is built by run(), false by default
+    void enableAsyncCompute(bool enable);
+
     void run();
 
+    // passes by queue with the fences and queue ownership transfers between queues,
+    // empty unless async compute is enabled
+    const PassSchedule& getSchedule() const;
+
     const BarrierNode& getBarrier(RenderGraph::vertex_descriptor u) const;
 
     const ResourceAccessNode& getAccessNode(RenderGraph::vertex_descriptor u) const;
@@ -492,9 +521,11 @@ struct FrameGraphDispatcher {
     const LayoutGraphData& layoutGraph;
     boost::container::pmr::memory_resource* scratch{nullptr};
     RelationGraph relationGraph;
+    PassSchedule schedule;
     bool _enablePassReorder{false};
     bool _enableAutoBarrier{true};
     bool _enableMemoryAliasing{false};
+    bool _enableAsyncCompute{false};
     bool _accessGraphBuilt{false};
     float _paralellExecWeight{0.0F};
 };
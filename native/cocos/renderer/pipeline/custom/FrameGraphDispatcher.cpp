@@ -25,6 +25,7 @@
     #pragma clang diagnostic ignored "-Wshorten-64-to-32"
 #endif
 #include <algorithm>
+#include <array>
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/graph/breadth_first_search.hpp>
 #include <boost/graph/filtered_graph.hpp>
@@ -80,8 +81,13 @@ static constexpr bool ENABLE_BRANCH_CULLING = BRANCH_CULLING;
 void passReorder(FrameGraphDispatcher &fgDispatcher);
 void memoryAliasing(FrameGraphDispatcher &fgDispatcher);
 void buildBarriers(FrameGraphDispatcher &fgDispatcher);
+void buildSchedule(FrameGraphDispatcher &fgDispatcher);
 
 void FrameGraphDispatcher::run() {
+    // a schedule of an earlier run must not outlive async compute being disabled
+    schedule.passes.clear();
+    schedule.syncs.clear();
+    schedule.queueTransfers.clear();
     if (_enablePassReorder) {
         passReorder(*this);
     }
@@ -89,6 +95,9 @@ void FrameGraphDispatcher::run() {
         memoryAliasing(*this);
     }
     buildBarriers(*this);
+    if (_enableAsyncCompute) {
+        buildSchedule(*this);
+    }
 }
 
 void FrameGraphDispatcher::enablePassReorder(bool enable) {
@@ -103,6 +112,14 @@ void FrameGraphDispatcher::setParalellWeight(float paralellExecWeight) {
     _paralellExecWeight = clampf(paralellExecWeight, 0.0F, 1.0F);
 }
 
+void FrameGraphDispatcher::enableAsyncCompute(bool enable) {
+    _enableAsyncCompute = enable;
+}
+
+const PassSchedule &FrameGraphDispatcher::getSchedule() const {
+    return schedule;
+}
+
 const BarrierNode &FrameGraphDispatcher::getBarrier(RenderGraph::vertex_descriptor u) const {
     auto ragVertID = resourceAccessGraph.passIndex.at(u);
     return get(ResourceAccessGraph::BarrierTag{}, resourceAccessGraph, ragVertID);
@@ -2608,6 +2625,212 @@ void passReorder(FrameGraphDispatcher &fgDispatcher) {
 void memoryAliasing(FrameGraphDispatcher &fgDispatcher) {
 }
 
+#pragma region BUILD_SCHEDULE
+namespace {
+
+constexpr uint32_t QUEUE_COUNT = 3;
+constexpr uint32_t INVALID_POSITION = 0xFFFFFFFF;
+
+struct ResourceDependency {
+    uint32_t src{0};
+    uint32_t dst{0};
+    ResourceGraph::vertex_descriptor resourceID{0xFFFFFFFF};
+    AccessStatus srcStatus;
+    AccessStatus dstStatus;
+};
+
+using QueueProgress = std::array<uint32_t, QUEUE_COUNT>;
+
+} // namespace
+
+// passes are referred by their position in execution order below.
+void buildSchedule(FrameGraphDispatcher &fgDispatcher) {
+    auto *scratch = fgDispatcher.scratch;
+    const auto &renderGraph = fgDispatcher.renderGraph;
+    const auto &resourceGraph = fgDispatcher.resourceGraph;
+    const auto &rag = fgDispatcher.resourceAccessGraph;
+    auto &schedule = fgDispatcher.schedule;
+
+    // execution order, without the empty head and the fake present node
+    ccstd::pmr::vector<ResourceAccessGraph::vertex_descriptor> order(scratch);
+    ccstd::pmr::vector<uint32_t> position(num_vertices(rag), INVALID_POSITION, scratch);
+    order.reserve(rag.topologicalOrder.size());
+    for (const auto ragVert : rag.topologicalOrder) {
+        if (ragVert == EXPECT_START_ID || rag.culledPasses.count(ragVert) ||
+            get(ResourceAccessGraph::PassIDTag{}, rag, ragVert) == RenderGraph::null_vertex()) {
+            continue;
+        }
+        position[ragVert] = static_cast<uint32_t>(order.size());
+        order.emplace_back(ragVert);
+    }
+    const auto passCount = static_cast<uint32_t>(order.size());
+    if (!passCount) {
+        return;
+    }
+
+    // an edge of access graph only orders a write after the latest read, enough for a single queue,
+    // so hazards against every access since the last dependent one are collected again from access records.
+    ccstd::pmr::vector<ResourceDependency> resourceDependencies(scratch);
+    ccstd::pmr::vector<std::pair<uint32_t, const AccessStatus *>> accesses(scratch);
+    ccstd::pmr::vector<std::pair<uint32_t, const AccessStatus *>> unordered(scratch);
+    for (const auto &[resName, accessRecord] : rag.resourceAccess) {
+        auto resID = findVertex(resName, resourceGraph);
+        if (resID == ResourceGraph::null_vertex()) {
+            continue;
+        }
+        bool isBuffer = get(ResourceGraph::DescTag{}, resourceGraph, resID).dimension == ResourceDimension::BUFFER;
+
+        accesses.clear();
+        for (const auto &[ragVert, status] : accessRecord) {
+            if (ragVert < position.size() && position[ragVert] != INVALID_POSITION) {
+                accesses.emplace_back(position[ragVert], &status);
+            }
+        }
+        std::sort(accesses.begin(), accesses.end(), [](const auto &lhs, const auto &rhs) {
+            return lhs.first < rhs.first;
+        });
+
+        // accesses not ordered before any later one yet
+        unordered.clear();
+        for (const auto &curr : accesses) {
+            auto keep = unordered.begin();
+            for (const auto &prev : unordered) {
+                if (prev.first == curr.first) {
+                    continue;
+                }
+                if (accessDependent(prev.second->accessFlag, curr.second->accessFlag, isBuffer)) {
+                    resourceDependencies.emplace_back(ResourceDependency{prev.first, curr.first, resID, *prev.second, *curr.second});
+                } else {
+                    *keep++ = prev;
+                }
+            }
+            unordered.erase(keep, unordered.end());
+            unordered.emplace_back(curr);
+        }
+    }
+
+    // (dst, src) pairs, sorted so that all predecessors of a pass come together
+    ccstd::pmr::vector<std::pair<uint32_t, uint32_t>> dependencies(scratch);
+    for (const auto ragVert : order) {
+        for (const auto e : makeRange(out_edges(ragVert, rag))) {
+            auto dstVert = target(e, rag);
+            if (dstVert < position.size() && position[dstVert] != INVALID_POSITION && position[ragVert] < position[dstVert]) {
+                dependencies.emplace_back(position[dstVert], position[ragVert]);
+            }
+        }
+    }
+    for (const auto &dep : resourceDependencies) {
+        dependencies.emplace_back(dep.dst, dep.src);
+    }
+    std::sort(dependencies.begin(), dependencies.end());
+    dependencies.erase(std::unique(dependencies.begin(), dependencies.end()), dependencies.end());
+
+    // longest path from a root and transitive predecessors, sources are always ahead of their targets
+    const uint32_t words = (passCount + 63) / 64;
+    ccstd::pmr::vector<uint64_t> ancestors(static_cast<size_t>(passCount) * words, 0, scratch);
+    ccstd::pmr::vector<uint32_t> levels(passCount, 0, scratch);
+    for (const auto &[dst, src] : dependencies) {
+        levels[dst] = std::max(levels[dst], levels[src] + 1);
+        auto *dstBits = &ancestors[static_cast<size_t>(dst) * words];
+        const auto *srcBits = &ancestors[static_cast<size_t>(src) * words];
+        for (uint32_t i = 0; i < words; ++i) {
+            dstBits[i] |= srcBits[i];
+        }
+        dstBits[src / 64] |= 1ULL << (src % 64);
+    }
+    auto isAncestor = [&](uint32_t lhs, uint32_t rhs) {
+        return (ancestors[static_cast<size_t>(rhs) * words + lhs / 64] >> (lhs % 64)) & 1ULL;
+    };
+
+    // a compute pass only goes async when some graphics pass is independent of it,
+    // otherwise the fences would cost more than the overlap brings.
+    ccstd::pmr::vector<RenderGraph::vertex_descriptor> passIDs(passCount, scratch);
+    ccstd::pmr::vector<uint8_t> isCompute(passCount, 0, scratch);
+    for (uint32_t i = 0; i < passCount; ++i) {
+        passIDs[i] = get(ResourceAccessGraph::PassIDTag{}, rag, order[i]);
+        isCompute[i] = holds<ComputeTag>(passIDs[i], renderGraph);
+    }
+    ccstd::pmr::vector<gfx::QueueType> queues(passCount, gfx::QueueType::GRAPHICS, scratch);
+    for (uint32_t i = 0; i < passCount; ++i) {
+        if (!isCompute[i]) {
+            continue;
+        }
+        for (uint32_t j = 0; j < passCount; ++j) {
+            if (!isCompute[j] && !isAncestor(i, j) && !isAncestor(j, i)) {
+                queues[i] = gfx::QueueType::COMPUTE;
+                break;
+            }
+        }
+    }
+
+    QueueProgress queueSizes{};
+    std::array<RenderGraph::vertex_descriptor, QUEUE_COUNT> lastPasses{};
+    ccstd::pmr::vector<uint32_t> queueIndices(passCount, 0, scratch);
+    schedule.passes.reserve(passCount);
+    for (uint32_t i = 0; i < passCount; ++i) {
+        auto queue = static_cast<uint32_t>(queues[i]);
+        queueIndices[i] = queueSizes[queue]++;
+        lastPasses[queue] = passIDs[i];
+        schedule.passes.emplace_back(ScheduledPass{passIDs[i], queues[i], queueIndices[i], levels[i]});
+    }
+
+    // fence values are timelines counting finished passes of a queue,
+    // a wait is skipped when the queue already knows that far, directly or through another queue.
+    std::array<QueueProgress, QUEUE_COUNT> known{};
+    ccstd::pmr::vector<QueueProgress> finished(passCount, scratch);
+    auto depIter = dependencies.begin();
+    for (uint32_t i = 0; i < passCount; ++i) {
+        const auto waitQueue = static_cast<uint32_t>(queues[i]);
+        auto &progress = known[waitQueue];
+
+        QueueProgress required{};
+        std::array<uint32_t, QUEUE_COUNT> signalers{};
+        for (; depIter != dependencies.end() && depIter->first == i; ++depIter) {
+            const auto src = depIter->second;
+            const auto signalQueue = static_cast<uint32_t>(queues[src]);
+            if (signalQueue != waitQueue && queueIndices[src] + 1 > required[signalQueue]) {
+                required[signalQueue] = queueIndices[src] + 1;
+                signalers[signalQueue] = src;
+            }
+        }
+        for (uint32_t signalQueue = 0; signalQueue < QUEUE_COUNT; ++signalQueue) {
+            if (required[signalQueue] <= progress[signalQueue]) {
+                continue;
+            }
+            const auto signaler = signalers[signalQueue];
+            schedule.syncs.emplace_back(QueueSync{queues[signaler], queues[i], passIDs[signaler], passIDs[i], required[signalQueue]});
+            for (uint32_t queue = 0; queue < QUEUE_COUNT; ++queue) {
+                progress[queue] = std::max(progress[queue], finished[signaler][queue]);
+            }
+        }
+        progress[waitQueue] = queueIndices[i] + 1;
+        finished[i] = progress;
+    }
+
+    // work left on other queues is joined to graphics queue before the frame ends
+    constexpr auto GRAPHICS = static_cast<uint32_t>(gfx::QueueType::GRAPHICS);
+    for (uint32_t signalQueue = 0; signalQueue < QUEUE_COUNT; ++signalQueue) {
+        if (signalQueue != GRAPHICS && queueSizes[signalQueue] > known[GRAPHICS][signalQueue]) {
+            schedule.syncs.emplace_back(QueueSync{static_cast<gfx::QueueType>(signalQueue), gfx::QueueType::GRAPHICS,
+                                                  lastPasses[signalQueue], RenderGraph::null_vertex(), queueSizes[signalQueue]});
+        }
+    }
+
+    for (const auto &dep : resourceDependencies) {
+        if (queues[dep.src] == queues[dep.dst]) {
+            continue;
+        }
+        auto &transfer = schedule.queueTransfers.emplace_back();
+        transfer.resourceID = dep.resourceID;
+        transfer.type = gfx::BarrierType::FULL;
+        transfer.beginVert = passIDs[dep.src];
+        transfer.endVert = passIDs[dep.dst];
+        transfer.beginStatus = dep.srcStatus;
+        transfer.endStatus = dep.dstStatus;
+    }
+}
+#pragma endregion BUILD_SCHEDULE
+
 #pragma region assisstantFuncDefinition
 template <typename Graph>
 bool tryAddEdge(uint32_t srcVertex, uint32_t dstVertex, Graph &graph) {
@@ -1417,6 +1417,14 @@ void NativePipeline::setValue(const ccstd::string &name, int32_t value) {
 }
 
 void NativePipeline::setValue(const ccstd::string &name, bool value) {
+    if (name == "enableParallelCulling") {
+        nativeContext.sceneCulling.enableParallelCulling = value;
+        return;
+    }
+    if (name == "enableOcclusionCulling") {
+        nativeContext.sceneCulling.enableOcclusionCulling = value;
+        return;
+    }
     macros[name] = value;
 }
 
@@ -208,7 +208,10 @@ SceneCulling::SceneCulling(SceneCulling&& rhs, const allocator_type& alloc)
   numFrustumCulling(rhs.numFrustumCulling),
   numLightBoundsCulling(rhs.numLightBoundsCulling),
   numRenderQueues(rhs.numRenderQueues),
-  gpuCullingPassID(rhs.gpuCullingPassID) {}
+  gpuCullingPassID(rhs.gpuCullingPassID),
+  enableParallelCulling(rhs.enableParallelCulling),
+  enableOcclusionCulling(rhs.enableOcclusionCulling),
+  occlusionBuffer(std::move(rhs.occlusionBuffer)) {}
 
 LightResource::LightResource(const allocator_type& alloc) noexcept
 : cpuBuffer(alloc),
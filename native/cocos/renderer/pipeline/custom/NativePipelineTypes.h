@@ -43,6 +43,7 @@
 #include "cocos/renderer/pipeline/custom/NativeTypes.h"
 #include "cocos/renderer/pipeline/custom/details/Map.h"
 #include "cocos/renderer/pipeline/custom/details/Set.h"
+#include "cocos/scene/OcclusionBuffer.h"
 #include "cocos/scene/ReflectionProbe.h"
 
 #ifdef _MSC_VER
@@ -1413,6 +1414,9 @@ public:
     uint32_t numLightBoundsCulling{0};
     uint32_t numRenderQueues{0};
     uint32_t gpuCullingPassID{0xFFFFFFFF};
+    bool enableParallelCulling{false};
+    bool enableOcclusionCulling{false};
+    std::unique_ptr<scene::OcclusionBuffer> occlusionBuffer;
 };
 
 struct LightResource {
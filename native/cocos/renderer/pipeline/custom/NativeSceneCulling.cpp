@@ -1,3 +1,4 @@
+#include "cocos/base/job-system/JobSystem.h"
 #include "cocos/renderer/pipeline/Define.h"
 #include "cocos/renderer/pipeline/custom/LayoutGraphUtils.h"
 #include "cocos/renderer/pipeline/custom/NativeBuiltinUtils.h"
@@ -5,6 +6,8 @@
 #include "cocos/renderer/pipeline/custom/NativeRenderGraphUtils.h"
 #include "cocos/renderer/pipeline/custom/details/GslUtils.h"
 #include "cocos/renderer/pipeline/custom/details/Range.h"
+#include "cocos/core/assets/RenderingSubMesh.h"
+#include "cocos/scene/OcclusionBuffer.h"
 #include "cocos/scene/Octree.h"
 #include "cocos/scene/ReflectionProbe.h"
 #include "cocos/scene/RenderScene.h"
@@ -197,6 +200,17 @@ bool isFrustumVisible(const scene::Model& model, const geometry::Frustum& frustu
     return !transWorldBounds.aabbFrustum(frustum);
 }
 
+void addSkyboxModel(
+    const scene::Model* skyboxModel,
+    const scene::Camera& camera,
+    bool bCastShadow,
+    ccstd::vector<const scene::Model*>& models) {
+    const auto camSkyboxFlag = (static_cast<int32_t>(camera.getClearFlag()) & scene::Camera::SKYBOX_FLAG);
+    if (!bCastShadow && skyboxModel && camSkyboxFlag) {
+        models.emplace_back(skyboxModel);
+    }
+}
+
 void octreeCulling(
     const scene::Octree& octree,
     const scene::Model* skyboxModel,
@@ -206,10 +220,7 @@ void octreeCulling(
     bool bCastShadow,
     ccstd::vector<const scene::Model*>& models) {
     const auto visibility = camera.getVisibility();
-    const auto camSkyboxFlag = (static_cast<int32_t>(camera.getClearFlag()) & scene::Camera::SKYBOX_FLAG);
-    if (!bCastShadow && skyboxModel && camSkyboxFlag) {
-        models.emplace_back(skyboxModel);
-    }
+    addSkyboxModel(skyboxModel, camera, bCastShadow, models);
     // add instances without world bounds
     for (const auto& pModel : scene.getModels()) {
         CC_EXPECTS(pModel);
@@ -235,19 +246,49 @@ void octreeCulling(
 }
 
 void bruteForceCulling(
-    const scene::Model* skyboxModel,
     const scene::RenderScene& scene,
     const scene::Camera& camera,
     const geometry::Frustum& cameraOrLightFrustum,
     bool bCastShadow,
     const scene::ReflectionProbe* probe,
+    uint32_t modelBegin,
+    uint32_t modelEnd,
     ccstd::vector<const scene::Model*>& models) {
     const auto visibility = camera.getVisibility();
-    const auto camSkyboxFlag = (static_cast<int32_t>(camera.getClearFlag()) & scene::Camera::SKYBOX_FLAG);
-    if (!bCastShadow && skyboxModel && camSkyboxFlag) {
-        models.emplace_back(skyboxModel);
+    const auto& sceneModels = scene.getModels();
+    CC_EXPECTS(modelEnd <= sceneModels.size());
+
+    // planar shadow casters are tested with projected bounds, which are not kept in the bounds array
+    const auto& modelBounds = scene.getModelBounds();
+    const bool bPlanarShadow = kPipelineSceneData->getShadows()->getType() == scene::ShadowType::PLANAR && bCastShadow;
+    if (!probe && !bPlanarShadow && modelBounds.size() == sceneModels.size()) {
+        ccstd::vector<uint8_t> frustumVisible(modelEnd - modelBegin);
+        modelBounds.cullFrustum(cameraOrLightFrustum, modelBegin, modelEnd, frustumVisible.data());
+        for (uint32_t modelIdx = modelBegin; modelIdx < modelEnd; ++modelIdx) {
+            const auto flags = modelBounds.getFlags(modelIdx);
+            if (!(flags & scene::ModelBoundsArray::ENABLED) || !(flags & scene::ModelBoundsArray::HAS_NODE) ||
+                (bCastShadow && !(flags & scene::ModelBoundsArray::CAST_SHADOW))) {
+                continue;
+            }
+            const auto* const model = sceneModels[modelIdx].get();
+            // lod culling
+            if (scene.isCulledByLod(&camera, model)) {
+                continue;
+            }
+            // filter model by view visibility
+            const auto layer = modelBounds.getLayer(modelIdx);
+            if (((visibility & layer) == layer) || (visibility & modelBounds.getVisFlags(modelIdx))) {
+                // frustum culling, models without bounds are always visible
+                if (frustumVisible[modelIdx - modelBegin]) {
+                    models.emplace_back(model);
+                }
+            }
+        }
+        return;
     }
-    for (const auto& pModel : scene.getModels()) {
+
+    for (uint32_t modelIdx = modelBegin; modelIdx < modelEnd; ++modelIdx) {
+        const auto& pModel = sceneModels[modelIdx];
         CC_EXPECTS(pModel);
         const auto& model = *pModel;
         if (!model.isEnabled() || !model.getNode() || (bCastShadow && !model.isCastShadow())) {
@@ -275,6 +316,11 @@ void bruteForceCulling(
     }
 }
 
+bool isOctreeCulling(const scene::RenderScene& scene, const scene::ReflectionProbe* probe) {
+    const auto* const octree = scene.getOctree();
+    return octree && octree->isEnabled() && !probe;
+}
+
 void sceneCulling(
     const scene::Model* skyboxModel,
     const scene::RenderScene& scene,
@@ -283,16 +329,170 @@ void sceneCulling(
     bool bCastShadow,
     const scene::ReflectionProbe* probe,
     ccstd::vector<const scene::Model*>& models) {
-    const auto* const octree = scene.getOctree();
-    if (octree && octree->isEnabled() && !probe) {
+    if (isOctreeCulling(scene, probe)) {
         octreeCulling(
-            *octree, skyboxModel,
+            *scene.getOctree(), skyboxModel,
             scene, camera, cameraOrLightFrustum, bCastShadow, models);
     } else {
+        addSkyboxModel(skyboxModel, camera, bCastShadow, models);
         bruteForceCulling(
-            skyboxModel,
-            scene, camera, cameraOrLightFrustum, bCastShadow, probe, models);
+            scene, camera, cameraOrLightFrustum, bCastShadow, probe,
+            0, static_cast<uint32_t>(scene.getModels().size()), models);
+    }
+}
+
+struct FrustumCullingQuery {
+    const scene::RenderScene* scene{nullptr};
+    const scene::Camera* camera{nullptr};
+    const geometry::Frustum* frustum{nullptr};
+    const scene::ReflectionProbe* probe{nullptr};
+    const scene::Light* light{nullptr};
+    bool bCastShadow{false};
+    ccstd::vector<const scene::Model*>* models{nullptr};
+};
+
+// A job of the parallel frustum culling, brute-force queries are split into model ranges
+struct FrustumCullingSlice {
+    uint32_t queryIndex{0};
+    uint32_t modelBegin{0};
+    uint32_t modelEnd{0};
+    bool bOctree{false};
+    ccstd::vector<const scene::Model*> models;
+};
+
+constexpr uint32_t PARALLEL_CULLING_MODELS_PER_SLICE = 1024;
+
+void parallelSceneCulling(
+    const scene::Model* skyboxModel,
+    const ccstd::vector<FrustumCullingQuery>& queries) {
+    ccstd::vector<FrustumCullingSlice> slices;
+    for (uint32_t queryIdx = 0; queryIdx != queries.size(); ++queryIdx) {
+        const auto& query = queries[queryIdx];
+        if (isOctreeCulling(*query.scene, query.probe)) {
+            auto& slice = slices.emplace_back();
+            slice.queryIndex = queryIdx;
+            slice.bOctree = true;
+            continue;
+        }
+        const auto numModels = static_cast<uint32_t>(query.scene->getModels().size());
+        uint32_t modelBegin = 0;
+        do {
+            const auto modelEnd = std::min(modelBegin + PARALLEL_CULLING_MODELS_PER_SLICE, numModels);
+            auto& slice = slices.emplace_back();
+            slice.queryIndex = queryIdx;
+            slice.modelBegin = modelBegin;
+            slice.modelEnd = modelEnd;
+            modelBegin = modelEnd;
+        } while (modelBegin < numModels);
+    }
+
+    JobGraph g(JobSystem::getInstance());
+    g.createForEachIndexJob(0, static_cast<uint32_t>(slices.size()), 1U, [&](uint32_t sliceIdx) {
+        auto& slice = slices[sliceIdx];
+        const auto& query = queries[slice.queryIndex];
+        if (slice.bOctree) {
+            octreeCulling(
+                *query.scene->getOctree(), skyboxModel,
+                *query.scene, *query.camera, *query.frustum, query.bCastShadow, slice.models);
+        } else {
+            bruteForceCulling(
+                *query.scene, *query.camera, *query.frustum, query.bCastShadow, query.probe,
+                slice.modelBegin, slice.modelEnd, slice.models);
+        }
+    });
+    g.run();
+    g.waitForAll();
+
+    // merge in slice order, the result is identical to the serial culling
+    for (auto& slice : slices) {
+        const auto& query = queries[slice.queryIndex];
+        auto& models = *query.models;
+        if (!slice.bOctree && slice.modelBegin == 0) {
+            addSkyboxModel(skyboxModel, *query.camera, query.bCastShadow, models);
+        }
+        models.insert(models.end(), slice.models.begin(), slice.models.end());
+    }
+}
+
+template <typename T>
+void rasterizeIndices(
+    scene::OcclusionBuffer& buffer, const Mat4& world,
+    const float* positions, uint32_t numVertices,
+    const TypedArrayTemp<T>& indices) {
+    if (indices.empty()) {
+        return;
+    }
+    const auto* data = reinterpret_cast<const T*>(indices.buffer()->getData() + indices.byteOffset());
+    buffer.rasterize(world, positions, 3, numVertices, data, indices.length());
+}
+
+void rasterizeOccluder(scene::OcclusionBuffer& buffer, const scene::Model& model) {
+    const auto* transform = model.getTransform();
+    if (!transform) {
+        return;
+    }
+    const auto& world = transform->getWorldMatrix();
+    for (const auto& subModel : model.getSubModels()) {
+        auto* subMesh = subModel->getSubMesh();
+        if (!subMesh || subMesh->getPrimitiveMode() != gfx::PrimitiveMode::TRIANGLE_LIST) {
+            continue;
+        }
+        // positions are always converted to 3 floats, unless the mesh is 2D
+        const auto& attributes = subMesh->getAttributes();
+        auto iter = std::find_if(attributes.begin(), attributes.end(), [](const gfx::Attribute& attr) {
+            return attr.name == gfx::ATTR_NAME_POSITION;
+        });
+        if (iter == attributes.end() || gfx::GFX_FORMAT_INFOS[static_cast<uint32_t>(iter->format)].count < 3) {
+            continue;
+        }
+        const auto& info = subMesh->getGeometricInfo();
+        if (info.positions.empty()) {
+            continue;
+        }
+        const auto* positions = reinterpret_cast<const float*>(info.positions.buffer()->getData() + info.positions.byteOffset());
+        const auto numVertices = info.positions.length() / 3;
+        if (!info.indices.has_value()) {
+            buffer.rasterize(world, positions, 3, numVertices);
+            continue;
+        }
+        const auto& indices = info.indices.value();
+        if (const auto* indices16 = ccstd::get_if<Uint16Array>(&indices)) {
+            rasterizeIndices(buffer, world, positions, numVertices, *indices16);
+        } else if (const auto* indices32 = ccstd::get_if<Uint32Array>(&indices)) {
+            rasterizeIndices(buffer, world, positions, numVertices, *indices32);
+        } else if (const auto* indices8 = ccstd::get_if<Uint8Array>(&indices)) {
+            rasterizeIndices(buffer, world, positions, numVertices, *indices8);
+        }
+    }
+}
+
+// Hides the models behind the occluders found by frustum culling, models are removed in place.
+void occlusionCulling(
+    scene::OcclusionBuffer& buffer,
+    const scene::Model* skyboxModel,
+    const scene::Camera& camera,
+    ccstd::vector<const scene::Model*>& models) {
+    buffer.begin(camera.getMatViewProj());
+    bool hasOccluder = false;
+    for (const auto* model : models) {
+        if (model != skyboxModel && model->isOccluder()) {
+            rasterizeOccluder(buffer, *model);
+            hasOccluder = true;
+        }
+    }
+    if (!hasOccluder) {
+        return;
     }
+    buffer.end();
+
+    auto last = std::remove_if(models.begin(), models.end(), [&](const scene::Model* model) {
+        if (model == skyboxModel || model->isOccluder()) {
+            return false;
+        }
+        const auto* bounds = model->getWorldBounds();
+        return bounds && buffer.isOccluded(*bounds);
+    });
+    models.erase(last, models.end());
 }
 
 } // namespace
@@ -302,67 +502,80 @@ void SceneCulling::batchFrustumCulling(const NativePipeline& ppl) {
     const auto* const skybox = pplSceneData.getSkybox();
     const auto* const skyboxModel = skybox && skybox->isEnabled() ? skybox->getModel() : nullptr;
 
-    for (const auto& [scene, queries] : frustumCullings) {
+    // resolve culling frustums on the render thread, builtin shadow frustums are looked up from pipeline
+    ccstd::vector<FrustumCullingQuery> queries;
+    queries.reserve(numFrustumCulling);
+    for (const auto& [scene, cullingQueries] : frustumCullings) {
         CC_ENSURES(scene);
-        for (const auto& [key, frustomCulledResultID] : queries.resultIndex) {
+        for (const auto& [key, frustomCulledResultID] : cullingQueries.resultIndex) {
             CC_EXPECTS(key.camera);
             CC_EXPECTS(key.camera->getScene() == scene);
             const auto* light = key.light;
             const auto level = key.lightLevel;
-            const auto bCastShadow = key.castShadow;
             const auto* probe = key.probe;
             const auto& camera = probe ? *probe->getCamera() : *key.camera;
             CC_EXPECTS(frustomCulledResultID.value < frustumCullingResults.size());
-            auto& models = frustumCullingResults[frustomCulledResultID.value];
 
-            if (probe) {
-                sceneCulling(
-                    skyboxModel,
-                    *scene, camera,
-                    camera.getFrustum(),
-                    bCastShadow,
-                    probe,
-                    models);
-                continue;
-            }
+            FrustumCullingQuery query{};
+            query.scene = scene;
+            query.camera = &camera;
+            query.probe = probe;
+            query.light = light;
+            query.bCastShadow = key.castShadow;
+            query.models = &frustumCullingResults[frustomCulledResultID.value];
 
-            if (light) {
+            if (probe) {
+                query.frustum = &camera.getFrustum();
+            } else if (light) {
                 switch (light->getType()) {
                     case scene::LightType::SPOT:
-                        sceneCulling(
-                            skyboxModel,
-                            *scene, camera,
-                            dynamic_cast<const scene::SpotLight*>(light)->getFrustum(),
-                            bCastShadow,
-                            nullptr,
-                            models);
+                        query.frustum = &dynamic_cast<const scene::SpotLight*>(light)->getFrustum();
                         break;
                     case scene::LightType::DIRECTIONAL: {
                         const auto* mainLight = dynamic_cast<const scene::DirectionalLight*>(light);
-                        const auto& frustum = getBuiltinShadowFrustum(ppl, camera, mainLight, level);
-                        sceneCulling(
-                            skyboxModel,
-                            *scene, camera,
-                            frustum,
-                            bCastShadow,
-                            nullptr,
-                            models);
+                        query.frustum = &getBuiltinShadowFrustum(ppl, camera, mainLight, level);
                     } break;
                     default:
                         // noop
                         break;
                 }
             } else {
-                sceneCulling(
-                    skyboxModel,
-                    *scene, camera,
-                    camera.getFrustum(),
-                    bCastShadow,
-                    nullptr,
-                    models);
+                query.frustum = &camera.getFrustum();
+            }
+            if (query.frustum) {
+                queries.emplace_back(query);
             }
         }
     }
+
+    // queries are independent of each other, and write to their own results
+    if (enableParallelCulling && JobSystem::getInstance()->threadCount() > 1) {
+        parallelSceneCulling(skyboxModel, queries);
+    } else {
+        for (const auto& query : queries) {
+            sceneCulling(
+                skyboxModel,
+                *query.scene, *query.camera,
+                *query.frustum,
+                query.bCastShadow,
+                query.probe,
+                *query.models);
+        }
+    }
+
+    // occlusion culling runs after frustum culling, on camera views only
+    if (!enableOcclusionCulling) {
+        return;
+    }
+    if (!occlusionBuffer) {
+        occlusionBuffer = std::make_unique<scene::OcclusionBuffer>();
+    }
+    for (const auto& query : queries) {
+        if (query.light || query.probe || query.bCastShadow) {
+            continue;
+        }
+        occlusionCulling(*occlusionBuffer, skyboxModel, *query.camera, *query.models);
+    }
 }
 
 namespace {
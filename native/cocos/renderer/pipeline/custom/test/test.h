@@ -796,5 +796,88 @@ static void fillTestGraph(const ViewInfo &rasterData, const ResourceInfo &rescIn
             {"22", 22, cc::gfx::ShaderStageFlagBit::FRAGMENT}, \
         },                                                     \
     };
+
+#define TEST_CASE_5                                            \
+    TEST_CASE_DEFINE                                           \
+                                                               \
+    for (auto &resource : resources) {                         \
+        std::get<1>(resource).flags |= ResourceFlags::STORAGE; \
+    }                                                          \
+                                                               \
+    ViewInfo rasterData = {                                    \
+        {                                                      \
+            PassType::COMPUTE,                                 \
+            {                                                  \
+                {{"6"}, {"7"}},                                \
+            },                                                 \
+        },                                                     \
+        {                                                      \
+            PassType::RASTER,                                  \
+            {                                                  \
+                {{"7"}, {"0"}},                                \
+            },                                                 \
+        },                                                     \
+        {                                                      \
+            PassType::COMPUTE,                                 \
+            {                                                  \
+                {{"0"}, {"1"}},                                \
+            },                                                 \
+        },                                                     \
+        {                                                      \
+            PassType::COMPUTE,                                 \
+            {                                                  \
+                {{"1"}, {"2"}},                                \
+            },                                                 \
+        },                                                     \
+        {                                                      \
+            PassType::RASTER,                                  \
+            {                                                  \
+                {{"7"}, {"3"}},                                \
+            },                                                 \
+        },                                                     \
+        {                                                      \
+            PassType::RASTER,                                  \
+            {                                                  \
+                {{"3"}, {"4"}},                                \
+            },                                                 \
+        },                                                     \
+        {                                                      \
+            PassType::RASTER,                                  \
+            {                                                  \
+                {{"2", "4"}, {"22"}},                          \
+            },                                                 \
+        },                                                     \
+    };                                                         \
+                                                               \
+    LayoutInfo layoutInfo = {                                  \
+        {                                                      \
+            {"6", 6, cc::gfx::ShaderStageFlagBit::COMPUTE},    \
+            {"7", 7, cc::gfx::ShaderStageFlagBit::FRAGMENT},   \
+        },                                                     \
+        {                                                      \
+            {"7", 7, cc::gfx::ShaderStageFlagBit::FRAGMENT},   \
+            {"0", 0, cc::gfx::ShaderStageFlagBit::COMPUTE},    \
+        },                                                     \
+        {                                                      \
+            {"0", 0, cc::gfx::ShaderStageFlagBit::COMPUTE},    \
+            {"1", 1, cc::gfx::ShaderStageFlagBit::COMPUTE},    \
+        },                                                     \
+        {                                                      \
+            {"1", 1, cc::gfx::ShaderStageFlagBit::COMPUTE},    \
+            {"2", 2, cc::gfx::ShaderStageFlagBit::FRAGMENT},   \
+        },                                                     \
+        {                                                      \
+            {"7", 7, cc::gfx::ShaderStageFlagBit::FRAGMENT},   \
+            {"3", 3, cc::gfx::ShaderStageFlagBit::FRAGMENT},   \
+        },                                                     \
+        {                                                      \
+            {"3", 3, cc::gfx::ShaderStageFlagBit::FRAGMENT},   \
+            {"4", 4, cc::gfx::ShaderStageFlagBit::FRAGMENT},   \
+        },                                                     \
+        {                                                      \
+            {"2", 2, cc::gfx::ShaderStageFlagBit::FRAGMENT},   \
+            {"4", 4, cc::gfx::ShaderStageFlagBit::FRAGMENT},   \
+            {"22", 22, cc::gfx::ShaderStageFlagBit::FRAGMENT}, \
+        }};
 } // namespace render
 } // namespace cc
@@ -25,6 +25,7 @@
 
 #include "DeferredPipeline.h"
 #include "../GlobalDescriptorSetManager.h"
+#include "../ParallelCommandRecorder.h"
 #include "../PipelineUBO.h"
 #include "../RenderPipeline.h"
 #include "../SceneCulling.h"
@@ -149,6 +150,7 @@ void DeferredPipeline::render(const ccstd::vector<scene::Camera *> &cameras) {
     }
 
     _commandBuffers[0]->end();
+    _parallelCommandRecorder->flush();
     _device->flushCommands(_commandBuffers);
     _device->getQueue()->submit(_commandBuffers);
 
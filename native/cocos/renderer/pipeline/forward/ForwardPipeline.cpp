@@ -24,6 +24,7 @@
 
 #include "ForwardPipeline.h"
 #include "../GlobalDescriptorSetManager.h"
+#include "../ParallelCommandRecorder.h"
 #include "../PipelineSceneData.h"
 #include "../PipelineUBO.h"
 #include "../SceneCulling.h"
@@ -136,6 +137,7 @@ void ForwardPipeline::render(const ccstd::vector<scene::Camera *> &cameras) {
     }
 
     _commandBuffers[0]->end();
+    _parallelCommandRecorder->flush();
     _device->flushCommands(_commandBuffers);
     _device->getQueue()->submit(_commandBuffers);
 
@@ -157,6 +157,8 @@ public:
     }
     inline void detachFromScene() { _scene = nullptr; };
     inline void setCastShadow(bool value) { _castShadow = value; }
+    // occluders are rasterized by the CPU occlusion culling to hide the models behind them
+    inline void setOccluder(bool value) { _occluder = value; }
     inline void setEnabled(bool value) { _enabled = value; }
     inline void setLocalBuffer(gfx::Buffer *buffer) { _localBuffer = buffer; }
     inline void setLocalSHBuffer(gfx::Buffer *buffer) { _localSHBuffer = buffer; }
@@ -177,6 +179,8 @@ public:
         _worldBoundsDirty = true;
     }
     inline void setOctreeNode(OctreeNode *node) { _octreeNode = node; }
+    // position in the octree's list of models to reinsert, -1 if not listed
+    inline void setOctreePendingIndex(int32_t index) { _octreePendingIndex = index; }
     inline void setScene(RenderScene *scene) {
         _scene = scene;
         if (scene) _localDataUpdated = true;
@@ -184,6 +188,7 @@ public:
 
     inline bool isInited() const { return _inited; }
     inline bool isCastShadow() const { return _castShadow; }
+    inline bool isOccluder() const { return _occluder; }
     inline bool isEnabled() const { return _enabled; }
     inline bool getUseLightProbe() const { return _useLightProbe; }
     inline void setUseLightProbe(bool val) {
@@ -224,9 +229,11 @@ public:
     inline uint32_t getUpdateStamp() const { return _updateStamp; }
     inline Layers::Enum getVisFlags() const { return _visFlags; }
     inline geometry::AABB *getWorldBounds() const { return _worldBounds; }
+    inline bool isWorldBoundsDirty() const { return _worldBoundsDirty; }
     inline Type getType() const { return _type; };
     inline void setType(Type type) { _type = type; }
     inline OctreeNode *getOctreeNode() const { return _octreeNode; }
+    inline int32_t getOctreePendingIndex() const { return _octreePendingIndex; }
     inline RenderScene *getScene() const { return _scene; }
     inline void setDynamicBatching(bool val) { _isDynamicBatching = val; }
     inline bool isDynamicBatching() const { return _isDynamicBatching; }
@@ -264,6 +271,7 @@ protected:
 
     UseReflectionProbeType _reflectionProbeType{ UseReflectionProbeType::NONE };
     int32_t _tetrahedronIndex{-1};
+    int32_t _octreePendingIndex{-1};
     uint32_t _descriptorSetCount{1};
     uint32_t _priority{0};
     uint32_t _updateStamp{0};
@@ -286,6 +294,7 @@ protected:
 
     bool _enabled{false};
     bool _castShadow{false};
+    bool _occluder{false};
     bool _receiveShadow{false};
     bool _isDynamicBatching{false};
     bool _inited{false};
@@ -0,0 +1,230 @@
+/****************************************************************************
+ Copyright (c) 2020-2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+
+#include "scene/ModelBoundsArray.h"
+#include <cfloat>
+#include <cmath>
+#include "core/geometry/AABB.h"
+#include "core/geometry/Frustum.h"
+#include "scene/Model.h"
+
+#if defined(__SSE2__) || defined(_M_X64) // math/Mat4.h undefines __SSE__
+    #include <xmmintrin.h>
+    #define CC_MODEL_BOUNDS_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define CC_MODEL_BOUNDS_NEON 1
+#endif
+
+namespace cc {
+namespace scene {
+
+namespace {
+constexpr uint32_t PLANE_COUNT = 6;
+constexpr uint32_t LANE_WIDTH = 4;
+} // namespace
+
+void ModelBoundsArray::push(const Model &model) {
+    const auto index = size();
+    resize(index + 1);
+    update(index, model, true);
+}
+
+void ModelBoundsArray::erase(uint32_t index) {
+    CC_ASSERT_LT(index, size());
+    _centerX.erase(_centerX.begin() + index);
+    _centerY.erase(_centerY.begin() + index);
+    _centerZ.erase(_centerZ.begin() + index);
+    _extentX.erase(_extentX.begin() + index);
+    _extentY.erase(_extentY.begin() + index);
+    _extentZ.erase(_extentZ.begin() + index);
+    _layers.erase(_layers.begin() + index);
+    _visFlags.erase(_visFlags.begin() + index);
+    _flags.erase(_flags.begin() + index);
+}
+
+void ModelBoundsArray::resize(uint32_t count) {
+    _centerX.resize(count);
+    _centerY.resize(count);
+    _centerZ.resize(count);
+    _extentX.resize(count);
+    _extentY.resize(count);
+    _extentZ.resize(count);
+    _layers.resize(count);
+    _visFlags.resize(count);
+    _flags.resize(count);
+}
+
+void ModelBoundsArray::clear() {
+    resize(0);
+}
+
+void ModelBoundsArray::update(uint32_t index, const Model &model, bool boundsChanged) {
+    const auto *node = model.getNode();
+    const auto *worldBounds = model.getWorldBounds();
+
+    uint8_t flags = 0;
+    if (model.isEnabled()) flags |= ENABLED;
+    if (node) flags |= HAS_NODE;
+    if (model.isCastShadow()) flags |= CAST_SHADOW;
+    if (worldBounds) flags |= HAS_BOUNDS;
+
+    // bounds may have been attached or detached without being marked as dirty
+    if (boundsChanged || (flags & HAS_BOUNDS) != (_flags[index] & HAS_BOUNDS)) {
+        setBounds(index, worldBounds);
+    }
+    setMasks(index, flags, node ? node->getLayer() : 0, static_cast<uint32_t>(model.getVisFlags()));
+}
+
+void ModelBoundsArray::setBounds(uint32_t index, const geometry::AABB *bounds) {
+    CC_ASSERT_LT(index, size());
+    if (!bounds) {
+        // never culled: every plane test sees an infinitely large box
+        _centerX[index] = _centerY[index] = _centerZ[index] = 0.0F;
+        _extentX[index] = _extentY[index] = _extentZ[index] = FLT_MAX;
+        return;
+    }
+    const auto &center = bounds->getCenter();
+    const auto &halfExtents = bounds->getHalfExtents();
+    _centerX[index] = center.x;
+    _centerY[index] = center.y;
+    _centerZ[index] = center.z;
+    _extentX[index] = halfExtents.x;
+    _extentY[index] = halfExtents.y;
+    _extentZ[index] = halfExtents.z;
+}
+
+void ModelBoundsArray::setMasks(uint32_t index, uint8_t flags, uint32_t layer, uint32_t visFlags) {
+    CC_ASSERT_LT(index, size());
+    _flags[index] = flags;
+    _layers[index] = layer;
+    _visFlags[index] = visFlags;
+}
+
+void ModelBoundsArray::cullFrustum(const geometry::Frustum &frustum, uint32_t begin, uint32_t end, uint8_t *results) const {
+    CC_ASSERT(begin <= end && end <= size());
+
+    float nx[PLANE_COUNT];
+    float ny[PLANE_COUNT];
+    float nz[PLANE_COUNT];
+    float d[PLANE_COUNT];
+    for (uint32_t p = 0; p < PLANE_COUNT; ++p) {
+        const auto *plane = frustum.planes[p];
+        nx[p] = plane->n.x;
+        ny[p] = plane->n.y;
+        nz[p] = plane->n.z;
+        d[p] = plane->d;
+    }
+
+    uint32_t i = begin;
+#if CC_MODEL_BOUNDS_SSE
+    __m128 planeNX[PLANE_COUNT];
+    __m128 planeNY[PLANE_COUNT];
+    __m128 planeNZ[PLANE_COUNT];
+    __m128 planeAbsNX[PLANE_COUNT];
+    __m128 planeAbsNY[PLANE_COUNT];
+    __m128 planeAbsNZ[PLANE_COUNT];
+    __m128 planeD[PLANE_COUNT];
+    for (uint32_t p = 0; p < PLANE_COUNT; ++p) {
+        planeNX[p] = _mm_set1_ps(nx[p]);
+        planeNY[p] = _mm_set1_ps(ny[p]);
+        planeNZ[p] = _mm_set1_ps(nz[p]);
+        planeAbsNX[p] = _mm_set1_ps(std::abs(nx[p]));
+        planeAbsNY[p] = _mm_set1_ps(std::abs(ny[p]));
+        planeAbsNZ[p] = _mm_set1_ps(std::abs(nz[p]));
+        planeD[p] = _mm_set1_ps(d[p]);
+    }
+    for (; i + LANE_WIDTH <= end; i += LANE_WIDTH) {
+        const __m128 cx = _mm_loadu_ps(&_centerX[i]);
+        const __m128 cy = _mm_loadu_ps(&_centerY[i]);
+        const __m128 cz = _mm_loadu_ps(&_centerZ[i]);
+        const __m128 ex = _mm_loadu_ps(&_extentX[i]);
+        const __m128 ey = _mm_loadu_ps(&_extentY[i]);
+        const __m128 ez = _mm_loadu_ps(&_extentZ[i]);
+        __m128 outside = _mm_setzero_ps();
+        for (uint32_t p = 0; p < PLANE_COUNT; ++p) {
+            const __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ex, planeAbsNX[p]), _mm_mul_ps(ey, planeAbsNY[p])), _mm_mul_ps(ez, planeAbsNZ[p]));
+            const __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(planeNX[p], cx), _mm_mul_ps(planeNY[p], cy)), _mm_mul_ps(planeNZ[p], cz));
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(dot, r), planeD[p]));
+        }
+        const int mask = _mm_movemask_ps(outside);
+        for (uint32_t lane = 0; lane < LANE_WIDTH; ++lane) {
+            results[i - begin + lane] = (mask & (1 << lane)) ? 0 : 1;
+        }
+    }
+#elif CC_MODEL_BOUNDS_NEON
+    float32x4_t planeNX[PLANE_COUNT];
+    float32x4_t planeNY[PLANE_COUNT];
+    float32x4_t planeNZ[PLANE_COUNT];
+    float32x4_t planeAbsNX[PLANE_COUNT];
+    float32x4_t planeAbsNY[PLANE_COUNT];
+    float32x4_t planeAbsNZ[PLANE_COUNT];
+    float32x4_t planeD[PLANE_COUNT];
+    for (uint32_t p = 0; p < PLANE_COUNT; ++p) {
+        planeNX[p] = vdupq_n_f32(nx[p]);
+        planeNY[p] = vdupq_n_f32(ny[p]);
+        planeNZ[p] = vdupq_n_f32(nz[p]);
+        planeAbsNX[p] = vdupq_n_f32(std::abs(nx[p]));
+        planeAbsNY[p] = vdupq_n_f32(std::abs(ny[p]));
+        planeAbsNZ[p] = vdupq_n_f32(std::abs(nz[p]));
+        planeD[p] = vdupq_n_f32(d[p]);
+    }
+    for (; i + LANE_WIDTH <= end; i += LANE_WIDTH) {
+        const float32x4_t cx = vld1q_f32(&_centerX[i]);
+        const float32x4_t cy = vld1q_f32(&_centerY[i]);
+        const float32x4_t cz = vld1q_f32(&_centerZ[i]);
+        const float32x4_t ex = vld1q_f32(&_extentX[i]);
+        const float32x4_t ey = vld1q_f32(&_extentY[i]);
+        const float32x4_t ez = vld1q_f32(&_extentZ[i]);
+        uint32x4_t outside = vdupq_n_u32(0);
+        for (uint32_t p = 0; p < PLANE_COUNT; ++p) {
+            // no fused multiply-add, keep the rounding of the scalar path
+            const float32x4_t r = vaddq_f32(vaddq_f32(vmulq_f32(ex, planeAbsNX[p]), vmulq_f32(ey, planeAbsNY[p])), vmulq_f32(ez, planeAbsNZ[p]));
+            const float32x4_t dot = vaddq_f32(vaddq_f32(vmulq_f32(planeNX[p], cx), vmulq_f32(planeNY[p], cy)), vmulq_f32(planeNZ[p], cz));
+            outside = vorrq_u32(outside, vcltq_f32(vaddq_f32(dot, r), planeD[p]));
+        }
+        results[i - begin + 0] = vgetq_lane_u32(outside, 0) ? 0 : 1;
+        results[i - begin + 1] = vgetq_lane_u32(outside, 1) ? 0 : 1;
+        results[i - begin + 2] = vgetq_lane_u32(outside, 2) ? 0 : 1;
+        results[i - begin + 3] = vgetq_lane_u32(outside, 3) ? 0 : 1;
+    }
+#endif
+    // remaining bounds, or every bounds if simd is not available
+    for (; i < end; ++i) {
+        uint8_t visible = 1;
+        for (uint32_t p = 0; p < PLANE_COUNT; ++p) {
+            const float r = _extentX[i] * std::abs(nx[p]) + _extentY[i] * std::abs(ny[p]) + _extentZ[i] * std::abs(nz[p]);
+            const float dot = nx[p] * _centerX[i] + ny[p] * _centerY[i] + nz[p] * _centerZ[i];
+            if (dot + r < d[p]) {
+                visible = 0;
+                break;
+            }
+        }
+        results[i - begin] = visible;
+    }
+}
+
+} // namespace scene
+} // namespace cc
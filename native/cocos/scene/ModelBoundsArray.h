@@ -0,0 +1,98 @@
+/****************************************************************************
+ Copyright (c) 2020-2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+
+#pragma once
+
+#include <cstdint>
+#include "base/Macros.h"
+#include "base/std/container/vector.h"
+
+namespace cc {
+
+namespace geometry {
+class AABB;
+class Frustum;
+} // namespace geometry
+
+namespace scene {
+
+class Model;
+
+/**
+ * World bounds and culling masks of the models in a RenderScene, stored as structure of arrays.
+ * Slot i always mirrors RenderScene::getModels()[i], so culling can run over contiguous lanes
+ * and only touch the models which are visible.
+ */
+class ModelBoundsArray final {
+public:
+    enum Flag : uint8_t {
+        ENABLED = 1U << 0,
+        HAS_NODE = 1U << 1,
+        CAST_SHADOW = 1U << 2,
+        HAS_BOUNDS = 1U << 3,
+    };
+
+    ModelBoundsArray() = default;
+    ~ModelBoundsArray() = default;
+
+    void push(const Model &model);
+    void erase(uint32_t index);
+    void resize(uint32_t count);
+    void clear();
+
+    // Masks are refreshed every time, bounds only if they have been changed since last update.
+    void update(uint32_t index, const Model &model, bool boundsChanged);
+    // Models without bounds are never culled.
+    void setBounds(uint32_t index, const geometry::AABB *bounds);
+    void setMasks(uint32_t index, uint8_t flags, uint32_t layer, uint32_t visFlags);
+
+    inline uint32_t size() const { return static_cast<uint32_t>(_flags.size()); }
+    inline uint8_t getFlags(uint32_t index) const { return _flags[index]; }
+    inline uint32_t getLayer(uint32_t index) const { return _layers[index]; }
+    inline uint32_t getVisFlags(uint32_t index) const { return _visFlags[index]; }
+
+    /**
+     * Tests the bounds in [begin, end) against every plane of the frustum, 4 bounds at a time.
+     * results[i - begin] is set to 1 if the bounds intersect the frustum, otherwise 0.
+     * The result is identical to geometry::AABB::aabbFrustum.
+     */
+    void cullFrustum(const geometry::Frustum &frustum, uint32_t begin, uint32_t end, uint8_t *results) const;
+
+private:
+    ccstd::vector<float> _centerX;
+    ccstd::vector<float> _centerY;
+    ccstd::vector<float> _centerZ;
+    ccstd::vector<float> _extentX;
+    ccstd::vector<float> _extentY;
+    ccstd::vector<float> _extentZ;
+    ccstd::vector<uint32_t> _layers;
+    ccstd::vector<uint32_t> _visFlags;
+    ccstd::vector<uint8_t> _flags;
+
+    CC_DISALLOW_COPY_MOVE_ASSIGN(ModelBoundsArray);
+};
+
+} // namespace scene
+} // namespace cc
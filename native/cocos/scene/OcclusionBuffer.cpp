@@ -0,0 +1,380 @@
+/****************************************************************************
+ Copyright (c) 2020-2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+
+#include "scene/OcclusionBuffer.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include "core/geometry/AABB.h"
+
+#if defined(__SSE2__) || defined(_M_X64) // math/Mat4.h undefines __SSE__
+    #include <xmmintrin.h>
+    #define CC_OCCLUSION_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define CC_OCCLUSION_NEON 1
+#endif
+
+namespace cc {
+namespace scene {
+
+namespace {
+constexpr uint32_t LANE_WIDTH = 4;
+// vertices closer than this to the camera plane are clipped
+constexpr float NEAR_W = 1e-5F;
+// a box is tested against at most (MAX_TEST_TEXELS + 1)^2 texels of the pyramid
+constexpr uint32_t MAX_TEST_TEXELS = 3;
+
+inline Vec4 transformPoint(const Mat4 &m, float x, float y, float z) {
+    return {
+        m.m[0] * x + m.m[4] * y + m.m[8] * z + m.m[12],
+        m.m[1] * x + m.m[5] * y + m.m[9] * z + m.m[13],
+        m.m[2] * x + m.m[6] * y + m.m[10] * z + m.m[14],
+        m.m[3] * x + m.m[7] * y + m.m[11] * z + m.m[15],
+    };
+}
+
+inline Vec4 lerpClip(const Vec4 &a, const Vec4 &b, float t) {
+    return {a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t, a.w + (b.w - a.w) * t};
+}
+
+inline int32_t clampPixel(float v, uint32_t size) {
+    // clamp in float first, screen positions of clipped vertices can be huge
+    return static_cast<int32_t>(std::floor(std::min(std::max(v, 0.0F), static_cast<float>(size - 1))));
+}
+} // namespace
+
+void OcclusionBuffer::begin(const Mat4 &viewProj, uint32_t width, uint32_t height) {
+    _viewProj = viewProj;
+    _width = std::max(width, 1U);
+    _height = std::max(height, 1U);
+    _stride = (_width + LANE_WIDTH - 1) & ~(LANE_WIDTH - 1);
+    _depth.assign(static_cast<size_t>(_stride) * _height, FLT_MAX);
+    _levels.clear();
+}
+
+void OcclusionBuffer::rasterize(const Mat4 &world, const float *positions, uint32_t stride, uint32_t numVertices,
+                                const uint32_t *indices, uint32_t numIndices) {
+    rasterizeIndexed(world, positions, stride, numVertices, indices, numIndices);
+}
+
+void OcclusionBuffer::rasterize(const Mat4 &world, const float *positions, uint32_t stride, uint32_t numVertices,
+                                const uint16_t *indices, uint32_t numIndices) {
+    rasterizeIndexed(world, positions, stride, numVertices, indices, numIndices);
+}
+
+void OcclusionBuffer::rasterize(const Mat4 &world, const float *positions, uint32_t stride, uint32_t numVertices,
+                                const uint8_t *indices, uint32_t numIndices) {
+    rasterizeIndexed(world, positions, stride, numVertices, indices, numIndices);
+}
+
+void OcclusionBuffer::rasterize(const Mat4 &world, const float *positions, uint32_t stride, uint32_t numVertices) {
+    transformVertices(world, positions, stride, numVertices);
+    for (uint32_t i = 0; i + 2 < numVertices; i += 3) {
+        clipTriangle(_clipPositions[i], _clipPositions[i + 1], _clipPositions[i + 2]);
+    }
+}
+
+template <typename Index>
+void OcclusionBuffer::rasterizeIndexed(const Mat4 &world, const float *positions, uint32_t stride, uint32_t numVertices,
+                                       const Index *indices, uint32_t numIndices) {
+    transformVertices(world, positions, stride, numVertices);
+    for (uint32_t i = 0; i + 2 < numIndices; i += 3) {
+        const uint32_t i0 = indices[i];
+        const uint32_t i1 = indices[i + 1];
+        const uint32_t i2 = indices[i + 2];
+        if (i0 >= numVertices || i1 >= numVertices || i2 >= numVertices) {
+            continue;
+        }
+        clipTriangle(_clipPositions[i0], _clipPositions[i1], _clipPositions[i2]);
+    }
+}
+
+void OcclusionBuffer::transformVertices(const Mat4 &world, const float *positions, uint32_t stride, uint32_t numVertices) {
+    CC_ASSERT(stride >= 3);
+    Mat4 worldViewProj;
+    Mat4::multiply(_viewProj, world, &worldViewProj);
+
+    _clipPositions.resize(numVertices);
+    for (uint32_t i = 0; i != numVertices; ++i) {
+        const float *p = positions + static_cast<size_t>(i) * stride;
+        _clipPositions[i] = transformPoint(worldViewProj, p[0], p[1], p[2]);
+    }
+}
+
+void OcclusionBuffer::clipTriangle(const Vec4 &v0, const Vec4 &v1, const Vec4 &v2) {
+    // trivially reject triangles outside of one side of the frustum
+    if ((v0.x > v0.w && v1.x > v1.w && v2.x > v2.w) ||
+        (v0.x < -v0.w && v1.x < -v1.w && v2.x < -v2.w) ||
+        (v0.y > v0.w && v1.y > v1.w && v2.y > v2.w) ||
+        (v0.y < -v0.w && v1.y < -v1.w && v2.y < -v2.w)) {
+        return;
+    }
+
+    const bool in0 = v0.w > NEAR_W;
+    const bool in1 = v1.w > NEAR_W;
+    const bool in2 = v2.w > NEAR_W;
+    if (in0 && in1 && in2) {
+        rasterizeTriangle(v0, v1, v2);
+        return;
+    }
+    if (!in0 && !in1 && !in2) {
+        return;
+    }
+
+    // clip against the near plane, the result is a triangle or a quad
+    const Vec4 *src[3] = {&v0, &v1, &v2};
+    Vec4 polygon[4];
+    uint32_t count = 0;
+    for (uint32_t i = 0; i != 3; ++i) {
+        const Vec4 &a = *src[i];
+        const Vec4 &b = *src[(i + 1) % 3];
+        const bool aIn = a.w > NEAR_W;
+        const bool bIn = b.w > NEAR_W;
+        if (aIn) {
+            polygon[count++] = a;
+        }
+        if (aIn != bIn) {
+            polygon[count++] = lerpClip(a, b, (NEAR_W - a.w) / (b.w - a.w));
+        }
+    }
+    for (uint32_t i = 1; i + 1 < count; ++i) {
+        rasterizeTriangle(polygon[0], polygon[i], polygon[i + 1]);
+    }
+}
+
+void OcclusionBuffer::rasterizeTriangle(const Vec4 &v0, const Vec4 &v1, const Vec4 &v2) {
+    const auto width = static_cast<float>(_width);
+    const auto height = static_cast<float>(_height);
+
+    // to screen space, z/w is linear in screen space
+    float x0 = (v0.x / v0.w * 0.5F + 0.5F) * width;
+    float y0 = (v0.y / v0.w * 0.5F + 0.5F) * height;
+    const float z0 = v0.z / v0.w;
+    float x1 = (v1.x / v1.w * 0.5F + 0.5F) * width;
+    float y1 = (v1.y / v1.w * 0.5F + 0.5F) * height;
+    float z1 = v1.z / v1.w;
+    float x2 = (v2.x / v2.w * 0.5F + 0.5F) * width;
+    float y2 = (v2.y / v2.w * 0.5F + 0.5F) * height;
+    float z2 = v2.z / v2.w;
+
+    float area = (x1 - x0) * (y2 - y0) - (x2 - x0) * (y1 - y0);
+    if (!(std::abs(area) > FLT_EPSILON)) {
+        return;
+    }
+    // both faces are rasterized, make the winding counter-clockwise
+    if (area < 0.0F) {
+        std::swap(x1, x2);
+        std::swap(y1, y2);
+        std::swap(z1, z2);
+        area = -area;
+    }
+
+    const float minX = std::min({x0, x1, x2});
+    const float maxX = std::max({x0, x1, x2});
+    const float minY = std::min({y0, y1, y2});
+    const float maxY = std::max({y0, y1, y2});
+    if (maxX < 0.0F || maxY < 0.0F || minX > width || minY > height) {
+        return;
+    }
+    const int32_t pixelMinX = clampPixel(minX, _width);
+    const int32_t pixelMaxX = clampPixel(maxX, _width);
+    const int32_t pixelMinY = clampPixel(minY, _height);
+    const int32_t pixelMaxY = clampPixel(maxY, _height);
+
+    // edge functions e(x, y) = a * x + b * y + c, non-negative inside the triangle
+    const float a0 = y1 - y2;
+    const float b0 = x2 - x1;
+    const float c0 = x1 * y2 - x2 * y1;
+    const float a1 = y2 - y0;
+    const float b1 = x0 - x2;
+    const float c1 = x2 * y0 - x0 * y2;
+    const float a2 = y0 - y1;
+    const float b2 = x1 - x0;
+    const float c2 = x0 * y1 - x1 * y0;
+
+    // depth plane z(x, y) = dzdx * (x - x0) + dzdy * (y - y0) + z0
+    const float dzdx = ((z1 - z0) * (y2 - y0) - (z2 - z0) * (y1 - y0)) / area;
+    const float dzdy = ((z2 - z0) * (x1 - x0) - (z1 - z0) * (x2 - x0)) / area;
+
+    // start from an aligned column, so rows are processed in whole SIMD lanes
+    const int32_t startX = pixelMinX & ~static_cast<int32_t>(LANE_WIDTH - 1);
+    const float fx = static_cast<float>(startX) + 0.5F;
+
+    for (int32_t y = pixelMinY; y <= pixelMaxY; ++y) {
+        const float fy = static_cast<float>(y) + 0.5F;
+        const float e0Row = a0 * fx + b0 * fy + c0;
+        const float e1Row = a1 * fx + b1 * fy + c1;
+        const float e2Row = a2 * fx + b2 * fy + c2;
+        const float zRow = dzdx * (fx - x0) + dzdy * (fy - y0) + z0;
+        float *row = _depth.data() + static_cast<size_t>(y) * _stride;
+
+#if CC_OCCLUSION_SSE
+        const __m128 laneOffset = _mm_set_ps(3.0F, 2.0F, 1.0F, 0.0F);
+        const __m128 farDepth = _mm_set1_ps(FLT_MAX);
+        const __m128 zero = _mm_setzero_ps();
+        for (int32_t x = startX; x <= pixelMaxX; x += LANE_WIDTH) {
+            const __m128 offset = _mm_add_ps(_mm_set1_ps(static_cast<float>(x - startX)), laneOffset);
+            const __m128 e0 = _mm_add_ps(_mm_set1_ps(e0Row), _mm_mul_ps(_mm_set1_ps(a0), offset));
+            const __m128 e1 = _mm_add_ps(_mm_set1_ps(e1Row), _mm_mul_ps(_mm_set1_ps(a1), offset));
+            const __m128 e2 = _mm_add_ps(_mm_set1_ps(e2Row), _mm_mul_ps(_mm_set1_ps(a2), offset));
+            const __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)), _mm_cmpge_ps(e2, zero));
+            const __m128 z = _mm_add_ps(_mm_set1_ps(zRow), _mm_mul_ps(_mm_set1_ps(dzdx), offset));
+            // pixels outside of the triangle keep their depth
+            const __m128 masked = _mm_or_ps(_mm_and_ps(inside, z), _mm_andnot_ps(inside, farDepth));
+            _mm_storeu_ps(row + x, _mm_min_ps(_mm_loadu_ps(row + x), masked));
+        }
+#elif CC_OCCLUSION_NEON
+        const float laneOffsetData[LANE_WIDTH] = {0.0F, 1.0F, 2.0F, 3.0F};
+        const float32x4_t laneOffset = vld1q_f32(laneOffsetData);
+        const float32x4_t farDepth = vdupq_n_f32(FLT_MAX);
+        const float32x4_t zero = vdupq_n_f32(0.0F);
+        for (int32_t x = startX; x <= pixelMaxX; x += LANE_WIDTH) {
+            const float32x4_t offset = vaddq_f32(vdupq_n_f32(static_cast<float>(x - startX)), laneOffset);
+            const float32x4_t e0 = vaddq_f32(vdupq_n_f32(e0Row), vmulq_f32(vdupq_n_f32(a0), offset));
+            const float32x4_t e1 = vaddq_f32(vdupq_n_f32(e1Row), vmulq_f32(vdupq_n_f32(a1), offset));
+            const float32x4_t e2 = vaddq_f32(vdupq_n_f32(e2Row), vmulq_f32(vdupq_n_f32(a2), offset));
+            const uint32x4_t inside = vandq_u32(vandq_u32(vcgeq_f32(e0, zero), vcgeq_f32(e1, zero)), vcgeq_f32(e2, zero));
+            const float32x4_t z = vaddq_f32(vdupq_n_f32(zRow), vmulq_f32(vdupq_n_f32(dzdx), offset));
+            // pixels outside of the triangle keep their depth
+            const float32x4_t masked = vbslq_f32(inside, z, farDepth);
+            vst1q_f32(row + x, vminq_f32(vld1q_f32(row + x), masked));
+        }
+#else
+        for (int32_t x = startX; x <= pixelMaxX; ++x) {
+            const auto offset = static_cast<float>(x - startX);
+            const float e0 = e0Row + a0 * offset;
+            const float e1 = e1Row + a1 * offset;
+            const float e2 = e2Row + a2 * offset;
+            if (e0 >= 0.0F && e1 >= 0.0F && e2 >= 0.0F) {
+                row[x] = std::min(row[x], zRow + dzdx * offset);
+            }
+        }
+#endif
+    }
+}
+
+void OcclusionBuffer::end() {
+    _levels.clear();
+    _levels.push_back({_width, _height, _stride, 0});
+
+    // every texel of a level keeps the farthest depth of the 2x2 texels below it
+    uint32_t hiZSize = 0;
+    for (uint32_t w = _width, h = _height; w > 1 || h > 1;) {
+        w = (w + 1) / 2;
+        h = (h + 1) / 2;
+        _levels.push_back({w, h, w, hiZSize});
+        hiZSize += w * h;
+    }
+    _hiZ.resize(hiZSize);
+
+    for (uint32_t l = 1; l < _levels.size(); ++l) {
+        const auto &src = _levels[l - 1];
+        const auto &dst = _levels[l];
+        const float *srcData = l == 1 ? _depth.data() : _hiZ.data() + src.offset;
+        float *dstData = _hiZ.data() + dst.offset;
+        for (uint32_t y = 0; y != dst.height; ++y) {
+            const uint32_t sy0 = y * 2;
+            const uint32_t sy1 = std::min(sy0 + 1, src.height - 1);
+            for (uint32_t x = 0; x != dst.width; ++x) {
+                const uint32_t sx0 = x * 2;
+                const uint32_t sx1 = std::min(sx0 + 1, src.width - 1);
+                dstData[y * dst.stride + x] = std::max(
+                    std::max(srcData[sy0 * src.stride + sx0], srcData[sy0 * src.stride + sx1]),
+                    std::max(srcData[sy1 * src.stride + sx0], srcData[sy1 * src.stride + sx1]));
+            }
+        }
+    }
+}
+
+float OcclusionBuffer::getDepth(uint32_t level, uint32_t x, uint32_t y) const {
+    CC_ASSERT_LT(level, _levels.size());
+    const auto &info = _levels[level];
+    CC_ASSERT(x < info.width && y < info.height);
+    const float *data = level == 0 ? _depth.data() : _hiZ.data() + info.offset;
+    return data[y * info.stride + x];
+}
+
+bool OcclusionBuffer::isOccluded(const geometry::AABB &box) const {
+    if (_levels.empty()) {
+        return false;
+    }
+
+    const auto width = static_cast<float>(_width);
+    const auto height = static_cast<float>(_height);
+    const Vec3 &center = box.getCenter();
+    const Vec3 &halfExtents = box.getHalfExtents();
+
+    float minX = FLT_MAX;
+    float minY = FLT_MAX;
+    float minZ = FLT_MAX;
+    float maxX = -FLT_MAX;
+    float maxY = -FLT_MAX;
+    for (uint32_t i = 0; i != 8; ++i) {
+        const float x = center.x + ((i & 1) ? halfExtents.x : -halfExtents.x);
+        const float y = center.y + ((i & 2) ? halfExtents.y : -halfExtents.y);
+        const float z = center.z + ((i & 4) ? halfExtents.z : -halfExtents.z);
+        const Vec4 clip = transformPoint(_viewProj, x, y, z);
+        // the box reaches the camera plane, never occluded
+        if (!(clip.w > NEAR_W)) {
+            return false;
+        }
+        const float sx = (clip.x / clip.w * 0.5F + 0.5F) * width;
+        const float sy = (clip.y / clip.w * 0.5F + 0.5F) * height;
+        minX = std::min(minX, sx);
+        maxX = std::max(maxX, sx);
+        minY = std::min(minY, sy);
+        maxY = std::max(maxY, sy);
+        minZ = std::min(minZ, clip.z / clip.w);
+    }
+    if (maxX < 0.0F || maxY < 0.0F || minX > width || minY > height) {
+        return false;
+    }
+
+    // every pixel touched by the screen rect of the box is tested
+    const auto x0 = static_cast<uint32_t>(clampPixel(minX, _width));
+    const auto x1 = static_cast<uint32_t>(clampPixel(maxX, _width));
+    const auto y0 = static_cast<uint32_t>(clampPixel(minY, _height));
+    const auto y1 = static_cast<uint32_t>(clampPixel(maxY, _height));
+
+    // pick the finest level where the rect covers only a few texels
+    uint32_t level = 0;
+    while (level + 1 < _levels.size() &&
+           ((x1 >> level) - (x0 >> level) > MAX_TEST_TEXELS || (y1 >> level) - (y0 >> level) > MAX_TEST_TEXELS)) {
+        ++level;
+    }
+
+    for (uint32_t y = y0 >> level; y <= (y1 >> level); ++y) {
+        for (uint32_t x = x0 >> level; x <= (x1 >> level); ++x) {
+            if (getDepth(level, x, y) >= minZ) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace scene
+} // namespace cc
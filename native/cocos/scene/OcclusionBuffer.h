@@ -0,0 +1,113 @@
+/****************************************************************************
+ Copyright (c) 2020-2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include "base/Macros.h"
+#include "base/std/container/vector.h"
+#include "math/Mat4.h"
+#include "math/Vec4.h"
+
+namespace cc {
+
+namespace geometry {
+class AABB;
+} // namespace geometry
+
+namespace scene {
+
+/**
+ * A low resolution depth buffer for CPU occlusion culling.
+ * Occluder triangles are rasterized 4 pixels at a time, keeping the nearest depth of every pixel.
+ * A hierarchical Z pyramid is then built from it, where every texel stores the farthest depth of
+ * the pixels it covers, so a bounding box can be tested against a few texels only.
+ * Nothing depends on the GPU, the result only depends on the input.
+ */
+class CC_DLL OcclusionBuffer final {
+public:
+    static constexpr uint32_t DEFAULT_WIDTH = 256;
+    static constexpr uint32_t DEFAULT_HEIGHT = 128;
+
+    OcclusionBuffer() = default;
+    ~OcclusionBuffer() = default;
+
+    // Clears the depth buffer to the far plane and sets the view projection used by rasterize and isOccluded.
+    void begin(const Mat4 &viewProj, uint32_t width = DEFAULT_WIDTH, uint32_t height = DEFAULT_HEIGHT);
+
+    /**
+     * Rasterizes a triangle list, positions are read with a stride of `stride` floats.
+     * Triangles crossing the near plane are clipped, both faces are rasterized.
+     */
+    void rasterize(const Mat4 &world, const float *positions, uint32_t stride, uint32_t numVertices,
+                   const uint32_t *indices, uint32_t numIndices);
+    void rasterize(const Mat4 &world, const float *positions, uint32_t stride, uint32_t numVertices,
+                   const uint16_t *indices, uint32_t numIndices);
+    void rasterize(const Mat4 &world, const float *positions, uint32_t stride, uint32_t numVertices,
+                   const uint8_t *indices, uint32_t numIndices);
+    // Rasterizes a non-indexed triangle list.
+    void rasterize(const Mat4 &world, const float *positions, uint32_t stride, uint32_t numVertices);
+
+    // Builds the hierarchical Z pyramid, must be called after the occluders are rasterized.
+    void end();
+
+    // Returns true if the box is completely hidden behind the rasterized occluders.
+    bool isOccluded(const geometry::AABB &box) const;
+
+    inline uint32_t getWidth() const { return _width; }
+    inline uint32_t getHeight() const { return _height; }
+    inline uint32_t getLevelCount() const { return static_cast<uint32_t>(_levels.size()); }
+    // Depth of pixel (x, y) at the given level of the pyramid, level 0 is the depth buffer itself.
+    float getDepth(uint32_t level, uint32_t x, uint32_t y) const;
+
+private:
+    struct Level {
+        uint32_t width{0};
+        uint32_t height{0};
+        uint32_t stride{0};
+        uint32_t offset{0};
+    };
+
+    template <typename Index>
+    void rasterizeIndexed(const Mat4 &world, const float *positions, uint32_t stride, uint32_t numVertices,
+                          const Index *indices, uint32_t numIndices);
+    void transformVertices(const Mat4 &world, const float *positions, uint32_t stride, uint32_t numVertices);
+    void clipTriangle(const Vec4 &v0, const Vec4 &v1, const Vec4 &v2);
+    void rasterizeTriangle(const Vec4 &v0, const Vec4 &v1, const Vec4 &v2);
+
+    Mat4 _viewProj;
+    uint32_t _width{0};
+    uint32_t _height{0};
+    // row stride of the depth buffer, padded to the SIMD width
+    uint32_t _stride{0};
+    ccstd::vector<float> _depth;
+    ccstd::vector<float> _hiZ;
+    ccstd::vector<Level> _levels;
+    ccstd::vector<Vec4> _clipPositions;
+
+    CC_DISALLOW_COPY_MOVE_ASSIGN(OcclusionBuffer);
+};
+
+} // namespace scene
+} // namespace cc
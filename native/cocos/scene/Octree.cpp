@@ -23,6 +23,7 @@
 ****************************************************************************/
 
 #include "Octree.h"
+#include <cmath>
 #include <future>
 #include <utility>
 #include "scene/Camera.h"
@@ -31,6 +32,13 @@
 namespace cc {
 namespace scene {
 
+namespace {
+BBox enlargeBox(const BBox &box) {
+    const cc::Vec3 expand = (box.max - box.min) * ((OCTREE_LOOSE_FACTOR - 1.0F) * 0.5F);
+    return {box.min - expand, box.max + expand};
+}
+} // namespace
+
 void OctreeInfo::setEnabled(bool val) {
     if (_enabled == val) {
         return;
@@ -62,6 +70,13 @@ void OctreeInfo::setDepth(uint32_t val) {
     }
 }
 
+void OctreeInfo::setLoose(bool val) {
+    _loose = val;
+    if (_resource) {
+        _resource->setLoose(val);
+    }
+}
+
 void OctreeInfo::activate(Octree *resource) {
     _resource = resource;
     _resource->initialize(*this);
@@ -86,14 +101,20 @@ void OctreeInfo::activate(Octree *resource) {
 /**
  * OctreeNode class
  */
-OctreeNode::OctreeNode(Octree *owner, OctreeNode *parent)
-: _owner(owner), _parent(parent) {
+void OctreeNode::reset(Octree *owner, OctreeNode *parent) {
+    _owner = owner;
+    _parent = parent;
+    _next = nullptr;
+    _children.fill(nullptr);
+    // keep the capacity, pooled nodes are reused frequently in animated scenes
+    _models.clear();
+    _depth = 0;
+    _index = 0;
 }
 
-OctreeNode::~OctreeNode() {
-    for (auto i = 0; i < OCTREE_CHILDREN_NUM; i++) {
-        deleteChild(i);
-    }
+void OctreeNode::setBox(const BBox &aabb) {
+    _aabb = aabb;
+    _looseBox = _owner && _owner->isLoose() ? enlargeBox(aabb) : aabb;
 }
 
 BBox OctreeNode::getChildBox(uint32_t index) const {
@@ -125,7 +146,7 @@ BBox OctreeNode::getChildBox(uint32_t index) const {
 OctreeNode *OctreeNode::getOrCreateChild(uint32_t index) {
     if (!_children[index]) {
         BBox childBox = getChildBox(index);
-        auto *child = _children[index] = ccnew OctreeNode(_owner, this);
+        auto *child = _children[index] = _owner->allocNode(this);
         child->setBox(childBox);
         child->setDepth(_depth + 1);
         child->setIndex(index);
@@ -136,11 +157,17 @@ OctreeNode *OctreeNode::getOrCreateChild(uint32_t index) {
 
 void OctreeNode::deleteChild(uint32_t index) {
     if (_children[index]) {
-        delete _children[index];
+        _owner->freeNode(_children[index]);
         _children[index] = nullptr;
     }
 }
 
+void OctreeNode::deleteChildren() {
+    for (auto i = 0; i < OCTREE_CHILDREN_NUM; i++) {
+        deleteChild(i);
+    }
+}
+
 void OctreeNode::insert(Model *model) { // NOLINT(misc-no-recursion)
     bool split = false;
     if (_depth < _owner->getMaxDepth() - 1) {
@@ -152,7 +179,11 @@ void OctreeNode::insert(Model *model) { // NOLINT(misc-no-recursion)
         index += modelCenter.y < nodeCenter.y ? 0 : 2;
         index += modelCenter.z < nodeCenter.z ? 0 : 4;
 
+        // a loose child accepts the model as long as its enlarged bounds contain it
         BBox childBox = getChildBox(index);
+        if (_owner->isLoose()) {
+            childBox = enlargeBox(childBox);
+        }
         if (childBox.contain(modelBox)) {
             split = true;
 
@@ -183,7 +214,9 @@ void OctreeNode::add(Model *model) {
 void OctreeNode::remove(Model *model) {
     auto iter = std::find(_models.begin(), _models.end(), model);
     if (iter != _models.end()) {
-        _models.erase(iter);
+        // the order of models in a node doesn't matter
+        *iter = _models.back();
+        _models.pop_back();
     }
 
     onRemoved();
@@ -251,7 +284,7 @@ void OctreeNode::doQueryVisibility(const Camera *camera, const geometry::Frustum
 
 void OctreeNode::queryVisibilityParallelly(const Camera *camera, const geometry::Frustum &frustum, bool isShadow, ccstd::vector<const Model *> &results) const {
     geometry::AABB box;
-    geometry::AABB::fromPoints(_aabb.min, _aabb.max, &box);
+    geometry::AABB::fromPoints(_looseBox.min, _looseBox.max, &box);
     if (!box.aabbFrustum(frustum)) {
         return;
     }
@@ -279,7 +312,7 @@ void OctreeNode::queryVisibilityParallelly(const Camera *camera, const geometry:
 
 void OctreeNode::queryVisibilitySequentially(const Camera *camera, const geometry::Frustum &frustum, bool isShadow, ccstd::vector<const Model *> &results) const { // NOLINT(misc-no-recursion)
     geometry::AABB box;
-    geometry::AABB::fromPoints(_aabb.min, _aabb.max, &box);
+    geometry::AABB::fromPoints(_looseBox.min, _looseBox.max, &box);
     if (!box.aabbFrustum(frustum)) {
         return;
     }
@@ -298,11 +331,44 @@ void OctreeNode::queryVisibilitySequentially(const Camera *camera, const geometr
  * Octree class
  */
 Octree::Octree() {
-    _root = ccnew OctreeNode(this, nullptr);
+    _root = allocNode(nullptr);
 }
 
 Octree::~Octree() {
-    delete _root;
+    clearPendingModels();
+    freeNode(_root);
+    for (auto *chunk : _allocatedChunks) {
+        delete[] chunk;
+    }
+    _allocatedChunks.clear();
+}
+
+void Octree::allocChunk() {
+    CC_ASSERT_NULL(_freeList);
+    _freeList = ccnew OctreeNode[OCTREE_NODE_CHUNK_SIZE]();
+    _allocatedChunks.emplace_back(_freeList);
+    for (uint32_t i = 0; i < OCTREE_NODE_CHUNK_SIZE - 1; i++) {
+        _freeList[i]._next = &_freeList[i + 1];
+    }
+    _freeList[OCTREE_NODE_CHUNK_SIZE - 1]._next = nullptr;
+}
+
+OctreeNode *Octree::allocNode(OctreeNode *parent) {
+    if (_freeList == nullptr) {
+        allocChunk();
+    }
+    auto *node = _freeList;
+    _freeList = _freeList->_next;
+    node->reset(this, parent);
+    return node;
+}
+
+void Octree::freeNode(OctreeNode *node) { // NOLINT(misc-no-recursion)
+    node->deleteChildren();
+    node->_models.clear();
+    node->_parent = nullptr;
+    node->_next = _freeList;
+    _freeList = node;
 }
 
 void Octree::initialize(const OctreeInfo &info) {
@@ -310,6 +376,7 @@ void Octree::initialize(const OctreeInfo &info) {
     _minPos = info.getMinPos();
     _maxPos = info.getMaxPos();
     _maxDepth = std::max(info.getDepth(), 1U);
+    _loose = info.isLoose();
     setEnabled(info.isEnabled());
     _root->setBox(BBox{_minPos - expand, _maxPos});
     _root->setDepth(0);
@@ -321,6 +388,9 @@ void Octree::setEnabled(bool val) {
         return;
     }
     _enabled = val;
+    if (!_enabled) {
+        clearPendingModels();
+    }
 }
 
 void Octree::setMinPos(const Vec3 &val) {
@@ -335,6 +405,14 @@ void Octree::setMaxDepth(uint32_t val) {
     _maxDepth = val;
 }
 
+void Octree::setLoose(bool val) {
+    if (_loose == val) {
+        return;
+    }
+    _loose = val;
+    rebuild(_root->getBox(), _maxDepth);
+}
+
 void Octree::resize(const Vec3 &minPos, const Vec3 &maxPos, uint32_t maxDepth) {
     const Vec3 expand{OCTREE_BOX_EXPAND_SIZE, OCTREE_BOX_EXPAND_SIZE, OCTREE_BOX_EXPAND_SIZE};
     BBox rootBox = _root->getBox();
@@ -342,23 +420,58 @@ void Octree::resize(const Vec3 &minPos, const Vec3 &maxPos, uint32_t maxDepth) {
         return;
     }
 
+    rebuild(BBox{minPos - expand, maxPos}, maxDepth);
+}
+
+void Octree::rebuild(const BBox &rootBox, uint32_t maxDepth) {
     ccstd::vector<Model *> models;
     _root->gatherModels(models);
 
-    delete _root;
-    _root = ccnew OctreeNode(this, nullptr);
-    _root->setBox(BBox{minPos - expand, maxPos});
+    freeNode(_root);
+    _root = allocNode(nullptr);
+    _root->setBox(rootBox);
     _root->setDepth(0);
     _root->setIndex(0);
 
     _maxDepth = std::max(maxDepth, 1U);
+    _totalCount = 0;
 
+    // models outside of the new root are dropped, insert() is not used here so the root doesn't grow again
     for (auto *model : models) {
         model->setOctreeNode(nullptr);
-        insert(model);
+        if (!model->getWorldBounds() || isOutside(model)) {
+            continue;
+        }
+        _totalCount++;
+        _root->insert(model);
     }
 }
 
+bool Octree::grow(const BBox &modelBox) {
+    const BBox &rootBox = _root->getBox();
+    const Vec3 center = rootBox.getCenter();
+    const Vec3 halfExtents = (rootBox.max - rootBox.min) * 0.5F;
+
+    // scale needed to cover the model when the root box grows around its center
+    float scale = 1.0F;
+    scale = std::max(scale, std::max(center.x - modelBox.min.x, modelBox.max.x - center.x) / halfExtents.x);
+    scale = std::max(scale, std::max(center.y - modelBox.min.y, modelBox.max.y - center.y) / halfExtents.y);
+    scale = std::max(scale, std::max(center.z - modelBox.min.z, modelBox.max.z - center.z) / halfExtents.z);
+    if (!std::isfinite(scale)) {
+        return false;
+    }
+
+    const auto steps = static_cast<uint32_t>(std::ceil(std::log2(scale)));
+    if (steps == 0 || steps > OCTREE_MAX_GROW_STEPS) {
+        return false;
+    }
+
+    // keep the size of leaf nodes by going one level deeper each time the root doubles
+    const float factor = static_cast<float>(1U << steps);
+    rebuild(BBox{center - halfExtents * factor, center + halfExtents * factor}, std::max(_maxDepth, std::min(_maxDepth + steps, OCTREE_MAX_DEPTH)));
+    return true;
+}
+
 void Octree::insert(Model *model) {
     CC_ASSERT(model);
 
@@ -366,6 +479,10 @@ void Octree::insert(Model *model) {
         return;
     }
 
+    if (!isInside(model)) {
+        grow(BBox(*model->getWorldBounds()));
+    }
+
     if (isOutside(model)) {
         CC_LOG_WARNING("Octree insert: model is outside of the scene bounding box, please modify DEFAULT_WORLD_MIN_POS and DEFAULT_WORLD_MAX_POS.");
         return;
@@ -387,10 +504,73 @@ void Octree::remove(Model *model) {
         model->setOctreeNode(nullptr);
         _totalCount--;
     }
+
+    // the slot is skipped by flushUpdates, the model may be gone by then
+    const int32_t pendingIndex = model->getOctreePendingIndex();
+    if (pendingIndex >= 0) {
+        _pendingModels[pendingIndex] = nullptr;
+        model->setOctreePendingIndex(-1);
+    }
 }
 
 void Octree::update(Model *model) {
-    insert(model);
+    CC_ASSERT(model);
+
+    // models that are not in the tree yet go through the regular path
+    if (!model->getOctreeNode()) {
+        insert(model);
+        return;
+    }
+
+    // already listed, it is reinserted where its bounds are at flush time
+    if (model->getOctreePendingIndex() >= 0) {
+        return;
+    }
+    model->setOctreePendingIndex(static_cast<int32_t>(_pendingModels.size()));
+    _pendingModels.push_back(model);
+}
+
+void Octree::flushUpdates() {
+    for (auto *model : _pendingModels) {
+        if (!model) {
+            continue;
+        }
+        model->setOctreePendingIndex(-1);
+
+        OctreeNode *node = model->getOctreeNode();
+        if (!node) {
+            continue;
+        }
+
+        if (!model->getWorldBounds()) {
+            node->remove(model);
+            model->setOctreeNode(nullptr);
+            _totalCount--;
+            continue;
+        }
+
+        // climb to the nearest node that still holds the model, and sink it down from there
+        const BBox modelBox(*model->getWorldBounds());
+        while (node->_parent && !node->getLooseBox().contain(modelBox)) {
+            node = node->_parent;
+        }
+
+        if (node == _root && !isInside(model)) {
+            insert(model);
+        } else {
+            node->insert(model);
+        }
+    }
+    _pendingModels.clear();
+}
+
+void Octree::clearPendingModels() {
+    for (auto *model : _pendingModels) {
+        if (model) {
+            model->setOctreePendingIndex(-1);
+        }
+    }
+    _pendingModels.clear();
 }
 
 void Octree::queryVisibility(const Camera *camera, const geometry::Frustum &frustum, bool isShadow, ccstd::vector<const Model *> &results) const {
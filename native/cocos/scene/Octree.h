@@ -43,6 +43,10 @@ const Vec3 DEFAULT_WORLD_MIN_POS = {-1024.0F, -1024.0F, -1024.0F};
 const Vec3 DEFAULT_WORLD_MAX_POS = {1024.0F, 1024.0F, 1024.0F};
 const float OCTREE_BOX_EXPAND_SIZE = 10.0F;
 constexpr int USE_MULTI_THRESHOLD = 1024; // use parallel culling if greater than this value
+constexpr uint32_t OCTREE_MAX_DEPTH = 16;
+constexpr uint32_t OCTREE_MAX_GROW_STEPS = 16;  // the root box is doubled at most this many times to fit a model
+constexpr uint32_t OCTREE_NODE_CHUNK_SIZE = 64; // nodes are allocated from the pool in chunks of this size
+constexpr float OCTREE_LOOSE_FACTOR = 2.0F;     // size of a loose node's bounds relative to its cell
 
 class CC_DLL OctreeInfo final : public RefCounted {
 public:
@@ -76,6 +80,13 @@ public:
     void setDepth(uint32_t val);
     inline uint32_t getDepth() const { return _depth; }
 
+    /**
+     * @en Whether to use loose bounds for octree nodes
+     * @zh 是否使用松散八叉树
+     */
+    void setLoose(bool val);
+    inline bool isLoose() const { return _loose; }
+
     void activate(Octree *resource);
 
     // JS deserialization require the properties to be public
@@ -84,6 +95,7 @@ public:
     Vec3 _minPos{DEFAULT_WORLD_MIN_POS};
     Vec3 _maxPos{DEFAULT_WORLD_MAX_POS};
     uint32_t _depth{DEFAULT_OCTREE_DEPTH};
+    bool _loose{false};
 
 private:
     Octree *_resource{nullptr};
@@ -134,18 +146,22 @@ struct CC_DLL BBox final {
  */
 class CC_DLL OctreeNode final {
 private:
-    OctreeNode(Octree *owner, OctreeNode *parent);
-    ~OctreeNode();
+    OctreeNode() = default;
+    ~OctreeNode() = default;
 
-    inline void setBox(const BBox &aabb) { _aabb = aabb; }
+    void reset(Octree *owner, OctreeNode *parent);
+    void setBox(const BBox &aabb);
     inline void setDepth(uint32_t depth) { _depth = depth; }
     inline void setIndex(uint32_t index) { _index = index; }
 
     inline Octree *getOwner() const { return _owner; }
     inline const BBox &getBox() const { return _aabb; }
+    // bounds that every model in this node lies in, equal to the cell box unless the octree is loose
+    inline const BBox &getLooseBox() const { return _looseBox; }
     BBox getChildBox(uint32_t index) const;
     OctreeNode *getOrCreateChild(uint32_t index);
     void deleteChild(uint32_t index);
+    void deleteChildren();
     void insert(Model *model);
     void add(Model *model);
     void remove(Model *model);
@@ -157,9 +173,11 @@ private:
 
     Octree *_owner{nullptr};
     OctreeNode *_parent{nullptr};
+    OctreeNode *_next{nullptr}; // next node in the free list of the pool
     ccstd::array<OctreeNode *, OCTREE_CHILDREN_NUM> _children{};
     ccstd::vector<Model *> _models;
     BBox _aabb{};
+    BBox _looseBox{};
     uint32_t _depth{0};
     uint32_t _index{0};
 
@@ -206,9 +224,12 @@ public:
     // remove a model from tree.
     void remove(Model *model);
 
-    // update model's location in the tree.
+    // mark model's location in the tree as outdated, it is reinserted in flushUpdates.
     void update(Model *model);
 
+    // reinsert all models marked by update, called once per frame.
+    void flushUpdates();
+
     /**
      * @en depth of octree
      * @zh 八叉树深度
@@ -217,20 +238,40 @@ public:
     // return octree depth
     inline uint32_t getMaxDepth() const { return _maxDepth; }
 
+    /**
+     * @en Whether to use loose bounds for octree nodes
+     * @zh 是否使用松散八叉树
+     */
+    void setLoose(bool val);
+    inline bool isLoose() const { return _loose; }
+
     // view frustum culling
     void queryVisibility(const Camera *camera, const geometry::Frustum &frustum, bool isShadow, ccstd::vector<const Model *> &results) const;
 
 private:
     bool isInside(Model *model) const;
     bool isOutside(Model *model) const;
+    bool grow(const BBox &modelBox);
+    void rebuild(const BBox &rootBox, uint32_t maxDepth);
+    void clearPendingModels();
+
+    OctreeNode *allocNode(OctreeNode *parent);
+    void freeNode(OctreeNode *node);
+    void allocChunk();
 
     OctreeNode *_root{nullptr};
+    OctreeNode *_freeList{nullptr};
+    ccstd::vector<OctreeNode *> _allocatedChunks;
+    // removed models leave a nullptr behind, see Model::getOctreePendingIndex
+    ccstd::vector<Model *> _pendingModels;
     uint32_t _maxDepth{DEFAULT_OCTREE_DEPTH};
     uint32_t _totalCount{0};
 
     bool _enabled{false};
+    bool _loose{false};
     Vec3 _minPos;
     Vec3 _maxPos;
+    friend class OctreeNode;
 };
 
 } // namespace scene
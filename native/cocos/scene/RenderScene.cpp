@@ -31,6 +31,7 @@
 #include "base/Log.h"
 #include "core/Root.h"
 #include "core/scene-graph/Node.h"
+#include "core/scene-graph/TransformHierarchy.h"
 #include "profiler/Profiler.h"
 #include "renderer/pipeline/PipelineSceneData.h"
 #include "renderer/pipeline/custom/RenderInterfaceTypes.h"
@@ -163,6 +164,10 @@ void RenderScene::setMainLight(DirectionalLight *dl) {
 void RenderScene::update(uint32_t stamp) {
     CC_PROFILE(RenderSceneUpdate);
 
+    if (_transformHierarchy) {
+        _transformHierarchy->update();
+    }
+
     if (_mainLight) {
         _mainLight->update();
     }
@@ -178,12 +183,27 @@ void RenderScene::update(uint32_t stamp) {
     for (const auto &light : _rangedDirLights) {
         light->update();
     }
-    for (const auto &model : _models) {
+    for (uint32_t i = 0; i < _models.size(); ++i) {
+        const auto &model = _models[i];
+        bool boundsChanged = false;
         if (model->isEnabled()) {
             model->updateTransform(stamp);
             model->updateUBOs(stamp);
+            boundsChanged = model->isWorldBoundsDirty();
             model->updateOctree();
+            if (model->getType() == Model::Type::SKINNING) {
+                _skinningModels.emplace_back(static_cast<SkinningModel *>(model.get()));
+            }
         }
+        _modelBounds.update(i, *model, boundsChanged);
+    }
+    // joint transforms are all resolved now, the palettes only read them
+    if (!_skinningModels.empty()) {
+        SkinningModel::updateJointPalettes(_skinningModels);
+        _skinningModels.clear();
+    }
+    if (_octree && _octree->isEnabled()) {
+        _octree->flushUpdates();
     }
 
     CC_PROFILE_OBJECT_UPDATE(Models, _models.size());
@@ -343,6 +363,7 @@ void RenderScene::removeRangedDirLights() {
 void RenderScene::addModel(Model *model) {
     model->attachToScene(this);
     _models.emplace_back(model);
+    _modelBounds.push(*model);
     if (_octree && _octree->isEnabled()) {
         _octree->insert(model);
     }
@@ -356,6 +377,7 @@ void RenderScene::removeModel(Model *model) {
         }
         _lodStateCache->removeModel(model);
         model->detachFromScene();
+        _modelBounds.erase(static_cast<uint32_t>(iter - _models.begin()));
         _models.erase(iter);
     } else {
         CC_LOG_WARNING("Try to remove invalid model.");
@@ -372,6 +394,7 @@ void RenderScene::removeModels() {
         CC_SAFE_DESTROY(model);
     }
     _models.clear();
+    _modelBounds.clear();
 }
 void RenderScene::addBatch(DrawBatch2D *drawBatch2D) {
     _batches.emplace_back(drawBatch2D);
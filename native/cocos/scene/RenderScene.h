@@ -29,10 +29,12 @@
 #include "base/RefCounted.h"
 #include "base/std/container/string.h"
 #include "base/std/container/vector.h"
+#include "scene/ModelBoundsArray.h"
 
 namespace cc {
 
 class Node;
+class TransformHierarchy;
 class SkinningModel;
 class BakedSkinningModel;
 
@@ -121,8 +123,10 @@ public:
     inline const ccstd::vector<IntrusivePtr<PointLight>> &getPointLights() const { return _pointLights; }
     inline const ccstd::vector<IntrusivePtr<RangedDirectionalLight>> &getRangedDirLights() const { return _rangedDirLights; }
     inline const ccstd::vector<IntrusivePtr<Model>> &getModels() const { return _models; }
+    inline const ModelBoundsArray &getModelBounds() const { return _modelBounds; }
     inline Octree *getOctree() const { return _octree; }
     void updateOctree(Model *model);
+    inline void setTransformHierarchy(TransformHierarchy *hierarchy) { _transformHierarchy = hierarchy; }
     inline const ccstd::vector<DrawBatch2D *> &getBatches() const { return _batches; }
 
 private:
@@ -131,6 +135,7 @@ private:
     IntrusivePtr<DirectionalLight> _mainLight;
     IntrusivePtr<LodStateCache> _lodStateCache;
     ccstd::vector<IntrusivePtr<Model>> _models;
+    ModelBoundsArray _modelBounds;
     ccstd::vector<IntrusivePtr<Camera>> _cameras;
     ccstd::vector<IntrusivePtr<DirectionalLight>> _directionalLights;
     ccstd::vector<IntrusivePtr<LODGroup>> _lodGroups;
@@ -139,7 +144,10 @@ private:
     ccstd::vector<IntrusivePtr<PointLight>> _pointLights;
     ccstd::vector<IntrusivePtr<RangedDirectionalLight>> _rangedDirLights;
     ccstd::vector<DrawBatch2D *> _batches;
+    // weak reference, skinning models updated in the current frame
+    ccstd::vector<SkinningModel *> _skinningModels;
     Octree *_octree{nullptr};
+    TransformHierarchy *_transformHierarchy{nullptr};
 
     CC_DISALLOW_COPY_MOVE_ASSIGN(RenderScene);
 };
@@ -25,14 +25,21 @@
 ****************************************************************************/
 #include "AssetsManagerEx.h"
 
+#include <algorithm>
+#include <cctype>
 #include <cerrno>
 #include <cstdio>
 
 #include "AsyncTaskPool.h"
 #include "base/DeferredReleasePool.h"
 #include "base/Log.h"
+#include "base/MD5.h"
 #include "base/UTF8.h"
+#include "base/ZipArchive.h"
+#include "base/ZipStreamExtractor.h"
+#include "base/job-system/JobSystem.h"
 #include "base/memory/Memory.h"
+#include "platform/MappedFile.h"
 
 #ifdef MINIZIP_FROM_SYSTEM
     #include <minizip/unzip.h>
@@ -46,6 +53,7 @@ NS_CC_EXT_BEGIN
 #define TEMP_MANIFEST_FILENAME "project.manifest.temp"
 #define TEMP_PACKAGE_SUFFIX    "_temp"
 #define MANIFEST_FILENAME      "project.manifest"
+#define MANIFEST_CACHE_SUFFIX  ".bin"
 
 #define BUFFER_SIZE  8192
 #define MAX_FILENAME 512
@@ -90,6 +98,10 @@ void AssetsManagerEx::init(const std::string &manifestUrl, const std::string &st
     _downloader->onFileTaskSuccess = [this](const network::DownloadTask &task) {
         this->onSuccess(task.requestURL, task.storagePath, task.identifier);
     };
+    // only the compressed assets extracted while downloading are data tasks
+    _downloader->onDataTaskSuccess = [this](const network::DownloadTask &task, const ccstd::vector<unsigned char> & /*data*/) {
+        this->finishStreamDecompression(task.identifier);
+    };
     setStoragePath(storagePath);
     _tempVersionPath = _tempStoragePath + VERSION_FILENAME;
     _cacheManifestPath = _storagePath + MANIFEST_FILENAME;
@@ -103,6 +115,7 @@ void AssetsManagerEx::init(const std::string &manifestUrl, const std::string &st
 AssetsManagerEx::~AssetsManagerEx() {
     _downloader->onTaskError = (nullptr);
     _downloader->onFileTaskSuccess = (nullptr);
+    _downloader->onDataTaskSuccess = (nullptr);
     _downloader->onTaskProgress = (nullptr);
     CC_SAFE_RELEASE(_localManifest);
     // _tempManifest could share a ptr with _remoteManifest or _localManifest
@@ -166,6 +179,28 @@ void AssetsManagerEx::prepareLocalManifest() {
     _localManifest->prependSearchPaths();
 }
 
+Manifest *AssetsManagerEx::loadCachedManifest() {
+    if (!_fileUtils->isFileExist(_cacheManifestPath)) {
+        return nullptr;
+    }
+    auto *cachedManifest = ccnew Manifest();
+    cachedManifest->addRef();
+    // The binary cache is only valid for the json file it was written from
+    std::string binaryPath = _cacheManifestPath + MANIFEST_CACHE_SUFFIX;
+    if (cachedManifest->parseBinaryFile(binaryPath, _cacheManifestPath)) {
+        return cachedManifest;
+    }
+    cachedManifest->parseFile(_cacheManifestPath);
+    if (!cachedManifest->isLoaded()) {
+        _fileUtils->removeFile(_cacheManifestPath);
+        CC_SAFE_RELEASE(cachedManifest);
+        return nullptr;
+    }
+    // Next launches load the binary cache instead of parsing the json file again
+    cachedManifest->saveToBinaryFile(binaryPath, _cacheManifestPath);
+    return cachedManifest;
+}
+
 bool AssetsManagerEx::loadLocalManifest(Manifest *localManifest, const std::string &storagePath) {
     if (_updateState > State::UNINITED) {
         return false;
@@ -188,24 +223,13 @@ bool AssetsManagerEx::loadLocalManifest(Manifest *localManifest, const std::stri
     _localManifest = localManifest;
     _localManifest->addRef();
     // Find the cached manifest file
-    Manifest *cachedManifest = nullptr;
-    if (_fileUtils->isFileExist(_cacheManifestPath)) {
-        cachedManifest = ccnew Manifest();
-        if (cachedManifest) {
-            cachedManifest->addRef();
-            cachedManifest->parseFile(_cacheManifestPath);
-            if (!cachedManifest->isLoaded()) {
-                _fileUtils->removeFile(_cacheManifestPath);
-                CC_SAFE_RELEASE(cachedManifest);
-                cachedManifest = nullptr;
-            }
-        }
-    }
+    Manifest *cachedManifest = loadCachedManifest();
     // Compare with cached manifest to determine which one to use
     if (cachedManifest) {
         bool localNewer = _localManifest->versionGreater(cachedManifest, _versionCompareHandle);
         if (localNewer) {
             // Recreate storage, to empty the content
+            ZipArchive::unmountDirectory(_storagePath);
             _fileUtils->removeDirectory(_storagePath);
             _fileUtils->createDirectory(_storagePath);
             CC_SAFE_RELEASE(cachedManifest);
@@ -240,20 +264,8 @@ bool AssetsManagerEx::loadLocalManifest(const std::string &manifestUrl) {
         return false;
     }
     _localManifest->addRef();
-    Manifest *cachedManifest = nullptr;
     // Find the cached manifest file
-    if (_fileUtils->isFileExist(_cacheManifestPath)) {
-        cachedManifest = ccnew Manifest();
-        if (cachedManifest) {
-            cachedManifest->addRef();
-            cachedManifest->parseFile(_cacheManifestPath);
-            if (!cachedManifest->isLoaded()) {
-                _fileUtils->removeFile(_cacheManifestPath);
-                CC_SAFE_RELEASE(cachedManifest);
-                cachedManifest = nullptr;
-            }
-        }
-    }
+    Manifest *cachedManifest = loadCachedManifest();
 
     // Ensure no search path of cached manifest is used to load this manifest
     std::vector<std::string> searchPaths = _fileUtils->getSearchPaths();
@@ -280,6 +292,7 @@ bool AssetsManagerEx::loadLocalManifest(const std::string &manifestUrl) {
             bool localNewer = _localManifest->versionGreater(cachedManifest, _versionCompareHandle);
             if (localNewer) {
                 // Recreate storage, to empty the content
+                ZipArchive::unmountDirectory(_storagePath);
                 _fileUtils->removeDirectory(_storagePath);
                 _fileUtils->createDirectory(_storagePath);
                 CC_SAFE_RELEASE(cachedManifest);
@@ -527,6 +540,78 @@ void AssetsManagerEx::decompressDownloadedZip(const std::string &customId, const
     });
 }
 
+bool AssetsManagerEx::downloadAndDecompress(const DownloadUnit &unit) {
+    if (!_streamingDecompression || !_downloader->isStreamingSupported()) {
+        return false;
+    }
+    const auto &assets = _remoteManifest->getAssets();
+    auto assetIt = assets.find(unit.customId);
+    size_t pos = unit.storagePath.find_last_of("/\\");
+    if (assetIt == assets.end() || !assetIt->second.compressed || pos == std::string::npos) {
+        return false;
+    }
+
+    // the entries are extracted beside the zip file, as decompress() does
+    auto extractor = std::make_shared<ZipStreamExtractor>(unit.storagePath.substr(0, pos + 1));
+    _streamExtractors[unit.customId] = extractor;
+    _downloader->createStreamTask(
+        unit.srcUrl, [extractor](const unsigned char *data, uint32_t size) {
+            return extractor->feed(data, size);
+        },
+        unit.customId);
+    return true;
+}
+
+void AssetsManagerEx::finishStreamDecompression(const std::string &customId) {
+    auto extractorIt = _streamExtractors.find(customId);
+    if (extractorIt == _streamExtractors.end()) {
+        return;
+    }
+
+    struct AsyncData {
+        std::string customId;
+        std::shared_ptr<ZipStreamExtractor> extractor;
+        std::string md5;
+        bool succeed;
+        bool verified;
+    };
+
+    auto *asyncData = ccnew AsyncData();
+    asyncData->customId = customId;
+    asyncData->extractor = extractorIt->second;
+    asyncData->succeed = false;
+    asyncData->verified = false;
+    _streamExtractors.erase(extractorIt);
+
+    const auto &assets = _remoteManifest->getAssets();
+    auto assetIt = assets.find(customId);
+    if (assetIt != assets.end()) {
+        asyncData->md5 = assetIt->second.md5;
+    }
+
+    std::function<void(void *)> decompressFinished = [this](void *param) {
+        auto *dataInner = reinterpret_cast<AsyncData *>(param);
+        if (!dataInner->succeed) {
+            std::string errorMsg = "Unable to decompress file " + dataInner->customId;
+            dispatchUpdateEvent(EventAssetsManagerEx::EventCode::ERROR_DECOMPRESS, "", errorMsg);
+            fileError(dataInner->customId, errorMsg);
+        } else if (!dataInner->verified) {
+            fileError(dataInner->customId, "Asset file verification failed after downloaded");
+        } else {
+            fileSuccess(dataInner->customId, "");
+        }
+        delete dataInner;
+    };
+    AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_OTHER, decompressFinished, static_cast<void *>(asyncData), [asyncData]() {
+        // Wait for the entries still being inflated
+        asyncData->succeed = asyncData->extractor->finish();
+        std::string md5 = asyncData->extractor->getMD5();
+        std::transform(asyncData->md5.begin(), asyncData->md5.end(), asyncData->md5.begin(), ::tolower);
+        asyncData->verified = asyncData->md5.empty() || asyncData->md5 == md5;
+        asyncData->extractor.reset();
+    });
+}
+
 void AssetsManagerEx::dispatchUpdateEvent(EventAssetsManagerEx::EventCode code, const std::string &assetId /* = ""*/, const std::string &message /* = ""*/, int curleCode /* = CURLE_OK*/, int curlmCode /* = CURLM_OK*/) {
     switch (code) {
         case EventAssetsManagerEx::EventCode::ERROR_UPDATING:
@@ -760,6 +845,12 @@ void AssetsManagerEx::updateSucceed() {
     }
 
     // Every thing is correctly downloaded, do the following
+    // 0. remove the binary cache of the cached manifest being replaced
+    std::string binaryPath = _cacheManifestPath + MANIFEST_CACHE_SUFFIX;
+    if (_fileUtils->isFileExist(binaryPath)) {
+        _fileUtils->removeFile(binaryPath);
+    }
+
     // 1. rename temporary manifest to valid manifest
     if (_fileUtils->isFileExist(_tempManifestPath)) {
         _fileUtils->renameFile(_tempStoragePath, TEMP_MANIFEST_FILENAME, MANIFEST_FILENAME);
@@ -814,6 +905,9 @@ void AssetsManagerEx::updateSucceed() {
     _localManifest = _remoteManifest;
     _localManifest->setManifestRoot(_storagePath);
     _remoteManifest = nullptr;
+    if (_fileUtils->isFileExist(_cacheManifestPath)) {
+        _localManifest->saveToBinaryFile(binaryPath, _cacheManifestPath);
+    }
     // 5. make local manifest take effect
     prepareLocalManifest();
     // 6. Set update state
@@ -1011,6 +1105,15 @@ void AssetsManagerEx::onError(const network::DownloadTask &task,
         dispatchUpdateEvent(EventAssetsManagerEx::EventCode::ERROR_DOWNLOAD_MANIFEST, task.identifier, errorStr, errorCode, errorCodeInternal);
         _updateState = State::FAIL_TO_UPDATE;
     } else {
+        auto extractorIt = _streamExtractors.find(task.identifier);
+        if (extractorIt != _streamExtractors.end()) {
+            bool failed = extractorIt->second->isFailed();
+            _streamExtractors.erase(extractorIt);
+            if (failed) {
+                std::string errorMsg = "Unable to decompress file " + task.identifier;
+                dispatchUpdateEvent(EventAssetsManagerEx::EventCode::ERROR_DECOMPRESS, "", errorMsg);
+            }
+        }
         fileError(task.identifier, errorStr, errorCode, errorCodeInternal);
     }
 }
@@ -1021,15 +1124,12 @@ void AssetsManagerEx::onProgress(double total, double downloaded, const std::str
         // Notify progression event
         dispatchUpdateEvent(EventAssetsManagerEx::EventCode::UPDATE_PROGRESSION, customId);
         return;
-    } // Calculate total downloaded
-    bool found = false;
-    _totalDownloaded = 0;
-    for (auto &it : _downloadedSize) {
-        if (it.first == customId) {
-            it.second = downloaded;
-            found = true;
-        }
-        _totalDownloaded += it.second;
+    } // Update total downloaded by the change of this unit instead of summing all units on every progress
+    auto sizeIt = _downloadedSize.find(customId);
+    bool found = sizeIt != _downloadedSize.end();
+    if (found) {
+        _totalDownloaded += downloaded - sizeIt->second;
+        sizeIt->second = downloaded;
     }
     // Collect information if not registed
     if (!found) {
@@ -1037,6 +1137,7 @@ void AssetsManagerEx::onProgress(double total, double downloaded, const std::str
         _tempManifest->setAssetDownloadState(customId, Manifest::DownloadState::DOWNLOADING);
         // Register the download size information
         _downloadedSize.emplace(customId, downloaded);
+        _totalDownloaded += downloaded;
         // Check download unit size existance, if not exist collect size in total size
         if (_downloadUnits[customId].size == 0) {
             _totalSize += total;
@@ -1066,31 +1167,106 @@ void AssetsManagerEx::onSuccess(const std::string & /*srcUrl*/, const std::strin
     } else if (customId == MANIFEST_ID) {
         _updateState = State::MANIFEST_LOADED;
         parseManifest();
+    } else if (_parallelVerification) {
+        verifyDownloadedAsset(customId, storagePath);
     } else {
-        bool ok = true;
-        const auto &assets = _remoteManifest->getAssets();
-        auto assetIt = assets.find(customId);
-        if (assetIt != assets.end()) {
-            Manifest::Asset asset = assetIt->second;
-            if (_verifyCallback != nullptr) {
-                ok = _verifyCallback(storagePath, asset);
-            }
+        onAssetVerified(customId, storagePath, true);
+    }
+}
+
+void AssetsManagerEx::onAssetVerified(const std::string &customId, const std::string &storagePath, bool verified) {
+    bool ok = verified;
+    const auto &assets = _remoteManifest->getAssets();
+    auto assetIt = assets.find(customId);
+    if (ok && assetIt != assets.end()) {
+        Manifest::Asset asset = assetIt->second;
+        if (_verifyCallback != nullptr) {
+            ok = _verifyCallback(storagePath, asset);
         }
+    }
 
-        if (ok) {
-            bool compressed = assetIt != assets.end() ? assetIt->second.compressed : false;
-            if (compressed) {
-                decompressDownloadedZip(customId, storagePath);
-            } else {
-                fileSuccess(customId, storagePath);
-            }
+    if (ok) {
+        bool compressed = assetIt != assets.end() ? assetIt->second.compressed : false;
+        if (compressed) {
+            decompressDownloadedZip(customId, storagePath);
         } else {
-            fileError(customId, "Asset file verification failed after downloaded");
+            fileSuccess(customId, storagePath);
         }
+    } else {
+        fileError(customId, "Asset file verification failed after downloaded");
+    }
+}
+
+void AssetsManagerEx::verifyDownloadedAsset(const std::string &customId, const std::string &storagePath) {
+    PendingVerification pending;
+    pending.customId = customId;
+    pending.storagePath = storagePath;
+    pending.verified = false;
+    const auto &assets = _remoteManifest->getAssets();
+    auto assetIt = assets.find(customId);
+    if (assetIt != assets.end()) {
+        pending.md5 = assetIt->second.md5;
+    }
+    _pendingVerifications.push_back(pending);
+
+    // The assets downloaded while a batch is hashed are hashed together in the next one
+    if (!_verifying) {
+        verifyPendingAssets();
     }
 }
 
+void AssetsManagerEx::verifyPendingAssets() {
+    auto *batch = ccnew std::vector<PendingVerification>();
+    batch->swap(_pendingVerifications);
+    _verifying = true;
+
+    std::function<void(void *)> verifyFinished = [this](void *param) {
+        auto *batchInner = reinterpret_cast<std::vector<PendingVerification> *>(param);
+        _verifying = false;
+        for (const auto &pending : *batchInner) {
+            onAssetVerified(pending.customId, pending.storagePath, pending.verified);
+        }
+        delete batchInner;
+        if (!_verifying && !_pendingVerifications.empty()) {
+            verifyPendingAssets();
+        }
+    };
+    AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_IO, verifyFinished, static_cast<void *>(batch), [batch]() {
+        auto verify = [batch](uint32_t i) {
+            PendingVerification &pending = (*batch)[i];
+            if (pending.md5.empty()) {
+                pending.verified = true;
+                return;
+            }
+            auto file = MappedFile::open(pending.storagePath);
+            if (!file) {
+                return;
+            }
+            MD5 md5;
+            md5.update(file->getBytes(), file->getSize());
+            std::transform(pending.md5.begin(), pending.md5.end(), pending.md5.begin(), ::tolower);
+            pending.verified = pending.md5 == md5.hexDigest();
+        };
+
+        // The files are hashed in parallel, each by a single thread
+        auto count = static_cast<uint32_t>(batch->size());
+        auto *jobSystem = JobSystem::getInstance();
+        if (count > 1 && jobSystem->threadCount() > 1) {
+            JobGraph g(jobSystem);
+            g.createForEachIndexJob(1U, count, 1U, verify);
+            g.run();
+            verify(0); // the calling thread takes the first file
+            g.waitForAll();
+        } else {
+            for (uint32_t i = 0; i < count; ++i) {
+                verify(i);
+            }
+        }
+    });
+}
+
 void AssetsManagerEx::destroyDownloadedVersion() {
+    ZipArchive::unmountDirectory(_storagePath);
     _fileUtils->removeDirectory(_storagePath);
     _fileUtils->removeDirectory(_tempStoragePath);
 }
@@ -1106,6 +1282,10 @@ void AssetsManagerEx::batchDownload() {
 
         _queue.push_back(iter.first);
     }
+    // Start the largest units first, they are split into parallel ranges and would otherwise finish last
+    std::stable_sort(_queue.begin(), _queue.end(), [this](const std::string &a, const std::string &b) {
+        return _downloadUnits[a].size < _downloadUnits[b].size;
+    });
     // All collected, enable total size
     if (_sizeCollected == _totalToDownload) {
         _totalEnabled = true;
@@ -1127,7 +1307,9 @@ void AssetsManagerEx::queueDowload() {
         _currConcurrentTask++;
         DownloadUnit &unit = _downloadUnits[key];
         _fileUtils->createDirectory(basename(unit.storagePath));
-        _downloader->createDownloadTask(unit.srcUrl, unit.storagePath, unit.customId);
+        if (!downloadAndDecompress(unit)) {
+            _downloader->createDownloadTask(unit.srcUrl, unit.storagePath, unit.customId);
+        }
 
         _tempManifest->setAssetDownloadState(key, Manifest::DownloadState::DOWNLOADING);
     }
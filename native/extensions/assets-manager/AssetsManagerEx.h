@@ -40,6 +40,10 @@
 #include "extensions/ExtensionMacros.h"
 #include "json/document-wrapper.h"
 
+namespace cc {
+class ZipStreamExtractor;
+}
+
 NS_CC_EXT_BEGIN
 
 /**
@@ -205,6 +209,37 @@ public:
         _verifyCallback = callback;
     };
 
+    /** @brief Whether compressed assets are extracted while they are downloaded
+     */
+    bool isStreamingDecompression() const {
+        return _streamingDecompression;
+    };
+
+    /** @brief Extract compressed assets while they are downloaded instead of after the whole zip file is saved.
+     * It's only used where the downloader supports streaming, the zip file is then never written,
+     * so the verify callback isn't called for it and its md5 in the manifest is checked instead.
+     * Zip64 and encrypted archives can't be extracted this way.
+     * @param enabled  Whether to extract compressed assets while they are downloaded
+     */
+    void setStreamingDecompression(bool enabled) {
+        _streamingDecompression = enabled;
+    };
+
+    /** @brief Whether the md5 of downloaded assets is verified on worker threads
+     */
+    bool isParallelVerification() const {
+        return _parallelVerification;
+    };
+
+    /** @brief Verify the md5 of downloaded assets against the remote manifest on worker threads.
+     * The downloaded files are hashed in batches in parallel, the verify callback is then only called
+     * for the assets whose md5 matches, and the assets without md5 in the manifest aren't checked.
+     * @param enabled  Whether to verify the md5 of downloaded assets on worker threads
+     */
+    void setParallelVerification(bool enabled) {
+        _parallelVerification = enabled;
+    };
+
     /** @brief Set the event callback for receiving update process events
      * @param callback  The event callback function
      */
@@ -237,6 +272,12 @@ protected:
     void updateSucceed();
     bool decompress(const std::string &filename);
     void decompressDownloadedZip(const std::string &customId, const std::string &storagePath);
+    bool downloadAndDecompress(const DownloadUnit &unit);
+    void finishStreamDecompression(const std::string &customId);
+    void verifyDownloadedAsset(const std::string &customId, const std::string &storagePath);
+    void verifyPendingAssets();
+    void onAssetVerified(const std::string &customId, const std::string &storagePath, bool verified);
+    Manifest *loadCachedManifest();
 
     /** @brief Update a list of assets under the current AssetsManagerEx context
      */
@@ -402,6 +443,28 @@ private:
     //! Callback function to verify the downloaded assets
     VerifyCallback _verifyCallback = nullptr;
 
+    //! Whether compressed assets are extracted while they are downloaded
+    bool _streamingDecompression = false;
+
+    //! Extractors of the compressed assets being downloaded
+    std::unordered_map<std::string, std::shared_ptr<ZipStreamExtractor>> _streamExtractors;
+
+    //! Whether the md5 of downloaded assets is verified on worker threads
+    bool _parallelVerification = false;
+
+    struct PendingVerification {
+        std::string customId;
+        std::string storagePath;
+        std::string md5;
+        bool verified;
+    };
+
+    //! Downloaded assets waiting for the batch being hashed
+    std::vector<PendingVerification> _pendingVerifications;
+
+    //! Whether a batch of downloaded assets is being hashed
+    bool _verifying = false;
+
     //! Callback function to dispatch events
     EventCallback _eventCallback = nullptr;
 
@@ -26,11 +26,16 @@
 
 #include "Manifest.h"
 #include "base/Log.h"
+#include "base/MD5.h"
+#include "base/job-system/JobSystem.h"
 #include "json/prettywriter.h"
 #include "json/stringbuffer.h"
+#include "platform/MappedFile.h"
 
+#include <sys/stat.h>
 #include <algorithm>
 #include <cstdio>
+#include <cstring>
 #include <fstream>
 
 #define KEY_VERSION          "version"
@@ -54,6 +59,95 @@
 
 NS_CC_EXT_BEGIN
 
+namespace {
+
+// "CCMF", followed by the format version and the stamp of the json file the binary cache was written from
+const uint32_t BINARY_MAGIC = 0x464D4343;
+const uint32_t BINARY_VERSION = 2;
+
+const uint8_t BINARY_ASSET_COMPRESSED = 1;
+const uint8_t BINARY_ASSET_HAS_PATH = 2;
+// key and md5 lengths, flags, size and download state
+const uint32_t BINARY_ASSET_MIN_SIZE = 17;
+
+// Diffs of fewer assets are merged on the calling thread
+const size_t PARALLEL_DIFF_MIN_ASSETS = 32768;
+const uint32_t MAX_DIFF_RANGES = 16;
+
+class BinaryWriter {
+public:
+    template <typename T>
+    void write(T value) {
+        _buffer.append(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    void writeString(const std::string &value) {
+        write(static_cast<uint32_t>(value.size()));
+        _buffer.append(value);
+    }
+
+    const std::string &getBuffer() const { return _buffer; }
+
+private:
+    std::string _buffer;
+};
+
+class BinaryReader {
+public:
+    BinaryReader(const uint8_t *bytes, uint32_t size)
+    : _cursor(bytes), _end(bytes + size) {}
+
+    template <typename T>
+    bool read(T *value) {
+        if (remaining() < sizeof(T)) {
+            return false;
+        }
+        memcpy(value, _cursor, sizeof(T));
+        _cursor += sizeof(T);
+        return true;
+    }
+
+    bool readString(std::string *value) {
+        uint32_t size = 0;
+        if (!read(&size) || remaining() < size) {
+            return false;
+        }
+        value->assign(reinterpret_cast<const char *>(_cursor), size);
+        _cursor += size;
+        return true;
+    }
+
+    size_t remaining() const { return static_cast<size_t>(_end - _cursor); }
+
+private:
+    const uint8_t *_cursor;
+    const uint8_t *_end;
+};
+
+// Identifies the json file a binary cache was written from, the digest catches
+// rewrites that keep both the size and the modification time
+struct SourceStamp {
+    int64_t size{-1};
+    int64_t mtime{0};
+    std::string md5;
+};
+
+bool readSourceStamp(const std::string &sourceUrl, SourceStamp *stamp) {
+    auto file = MappedFile::open(sourceUrl);
+    if (!file) {
+        return false;
+    }
+    struct stat info;
+    stamp->size = file->getSize();
+    stamp->mtime = stat(FileUtils::getInstance()->getSuitableFOpen(sourceUrl).c_str(), &info) == 0 ? static_cast<int64_t>(info.st_mtime) : 0;
+    MD5 md5;
+    md5.update(file->getBytes(), file->getSize());
+    stamp->md5 = md5.hexDigest();
+    return true;
+}
+
+} // namespace
+
 static int cmpVersion(const std::string &v1, const std::string &v2) {
     int i;
     int octV1[4] = {0};
@@ -161,6 +255,93 @@ void Manifest::parseJSONString(const std::string &content, const std::string &ma
     }
 }
 
+bool Manifest::parseBinaryFile(const std::string &binaryUrl, const std::string &sourceUrl) {
+    clear();
+    auto file = MappedFile::open(binaryUrl);
+    SourceStamp source;
+    if (!file || !readSourceStamp(sourceUrl, &source)) {
+        return false;
+    }
+
+    BinaryReader reader(file->getBytes(), file->getSize());
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    SourceStamp cached;
+    if (!reader.read(&magic) || magic != BINARY_MAGIC || !reader.read(&version) || version != BINARY_VERSION ||
+        !reader.read(&cached.size) || !reader.read(&cached.mtime) || !reader.readString(&cached.md5) ||
+        cached.size != source.size || cached.mtime != source.mtime || cached.md5 != source.md5) {
+        return false;
+    }
+
+    // Flag the manifest loaded up front, so that clear() drops a partially read cache
+    _versionLoaded = true;
+    _loaded = true;
+    uint8_t updating = 0;
+    bool succeed = reader.readString(&_version) && reader.readString(&_packageUrl) && reader.readString(&_remoteManifestUrl) &&
+                   reader.readString(&_remoteVersionUrl) && reader.readString(&_engineVer) && reader.read(&updating);
+    _updating = updating != 0;
+
+    uint32_t count = 0;
+    succeed = succeed && reader.read(&count);
+    std::string group;
+    std::string groupVersion;
+    for (uint32_t i = 0; succeed && i < count; ++i) {
+        succeed = reader.readString(&group) && reader.readString(&groupVersion);
+        _groups.push_back(group);
+        _groupVer.emplace(group, groupVersion);
+    }
+
+    succeed = succeed && reader.read(&count);
+    std::string path;
+    for (uint32_t i = 0; succeed && i < count; ++i) {
+        succeed = reader.readString(&path);
+        _searchPaths.push_back(path);
+    }
+
+    // The assets are stored sorted by key, so they are indexed without sorting them again
+    succeed = succeed && reader.read(&count) && count <= reader.remaining() / BINARY_ASSET_MIN_SIZE;
+    if (succeed) {
+        _assets.reserve(count);
+        _sortedAssets.reserve(count);
+    }
+    std::string key;
+    Asset asset;
+    uint8_t flags = 0;
+    int32_t downloadState = 0;
+    for (uint32_t i = 0; succeed && i < count; ++i) {
+        succeed = reader.readString(&key) && reader.readString(&asset.md5) && reader.read(&flags);
+        if (succeed && (flags & BINARY_ASSET_HAS_PATH) != 0) {
+            succeed = reader.readString(&asset.path);
+        } else {
+            asset.path = key;
+        }
+        succeed = succeed && reader.read(&asset.size) && reader.read(&downloadState);
+        // a cache out of order can't be merged by genDiff
+        succeed = succeed && (_sortedAssets.empty() || *_sortedAssets.back().key < key);
+        if (succeed) {
+            asset.compressed = (flags & BINARY_ASSET_COMPRESSED) != 0;
+            asset.downloadState = downloadState;
+            auto result = _assets.emplace(key, asset);
+            _sortedAssets.push_back({&result.first->first, &result.first->second, INVALID_JSON_INDEX});
+        }
+    }
+
+    if (!succeed) {
+        CC_LOG_DEBUG("Fail to parse manifest cache: %s\n", binaryUrl.c_str());
+        clear();
+        _packageUrl.clear();
+        _updating = false;
+        return false;
+    }
+
+    // Register the local manifest root
+    size_t found = binaryUrl.find_last_of("/\\");
+    if (found != std::string::npos) {
+        _manifestRoot = binaryUrl.substr(0, found + 1);
+    }
+    return true;
+}
+
 bool Manifest::isVersionLoaded() const {
     return _versionLoaded;
 }
@@ -232,53 +413,95 @@ bool Manifest::versionGreater(const Manifest *b, const std::function<int(const s
 }
 
 std::unordered_map<std::string, Manifest::AssetDiff> Manifest::genDiff(const Manifest *b) const {
-    std::unordered_map<std::string, AssetDiff> diffMap;
-    const std::unordered_map<std::string, Asset> &bAssets = b->getAssets();
+    struct Diff {
+        const SortedAsset *sorted;
+        DiffType type;
+    };
+
+    const std::vector<SortedAsset> &assetsA = _sortedAssets;
+    const std::vector<SortedAsset> &assetsB = b->_sortedAssets;
+
+    // Both lists are sorted by key, so a single merge pass finds all the differences in a key range
+    auto merge = [&assetsA, &assetsB](size_t beginA, size_t endA, size_t beginB, size_t endB, std::vector<Diff> *diffs) {
+        size_t i = beginA;
+        size_t j = beginB;
+        while (i < endA || j < endB) {
+            int order = 0;
+            if (i == endA) {
+                order = 1;
+            } else if (j == endB) {
+                order = -1;
+            } else {
+                order = assetsA[i].key->compare(*assetsB[j].key);
+            }
 
-    std::string key;
-    Asset valueA;
-    Asset valueB;
-
-    std::unordered_map<std::string, Asset>::const_iterator valueIt;
-    std::unordered_map<std::string, Asset>::const_iterator it;
-    for (it = _assets.begin(); it != _assets.end(); ++it) {
-        key = it->first;
-        valueA = it->second;
-
-        // Deleted
-        valueIt = bAssets.find(key);
-        if (valueIt == bAssets.cend()) {
-            AssetDiff diff;
-            diff.asset = valueA;
-            diff.type = DiffType::DELETED;
-            diffMap.emplace(key, diff);
-            continue;
+            if (order < 0) {
+                // Deleted
+                diffs->push_back({&assetsA[i++], DiffType::DELETED});
+            } else if (order > 0) {
+                // Added
+                diffs->push_back({&assetsB[j++], DiffType::ADDED});
+            } else {
+                // Modified
+                if (assetsA[i].asset->md5 != assetsB[j].asset->md5) {
+                    diffs->push_back({&assetsB[j], DiffType::MODIFIED});
+                }
+                ++i;
+                ++j;
+            }
         }
-
-        // Modified
-        valueB = valueIt->second;
-        if (valueA.md5 != valueB.md5) {
-            AssetDiff diff;
-            diff.asset = valueB;
-            diff.type = DiffType::MODIFIED;
-            diffMap.emplace(key, diff);
+    };
+
+    // Large manifests are split into key ranges merged in parallel, bounded by the keys of this manifest
+    auto *jobSystem = JobSystem::getInstance();
+    uint32_t rangeCount = 1;
+    if (assetsA.size() + assetsB.size() >= PARALLEL_DIFF_MIN_ASSETS && jobSystem->threadCount() > 1) {
+        rangeCount = static_cast<uint32_t>(std::min<size_t>({jobSystem->threadCount() + 1, MAX_DIFF_RANGES, assetsA.size()}));
+        rangeCount = std::max(rangeCount, 1U);
+    }
+    std::vector<size_t> boundsA(rangeCount + 1);
+    std::vector<size_t> boundsB(rangeCount + 1);
+    for (uint32_t r = 0; r < rangeCount; ++r) {
+        boundsA[r] = assetsA.size() * r / rangeCount;
+        if (r > 0) {
+            const std::string &key = *assetsA[boundsA[r]].key;
+            auto bound = std::lower_bound(assetsB.begin(), assetsB.end(), key, [](const SortedAsset &sorted, const std::string &k) {
+                return *sorted.key < k;
+            });
+            boundsB[r] = static_cast<size_t>(bound - assetsB.begin());
         }
     }
+    boundsA[rangeCount] = assetsA.size();
+    boundsB[rangeCount] = assetsB.size();
+
+    std::vector<std::vector<Diff>> diffs(rangeCount);
+    auto mergeRange = [&](uint32_t r) {
+        merge(boundsA[r], boundsA[r + 1], boundsB[r], boundsB[r + 1], &diffs[r]);
+    };
+    if (rangeCount > 1) {
+        JobGraph g(jobSystem);
+        g.createForEachIndexJob(1U, rangeCount, 1U, mergeRange);
+        g.run();
+        mergeRange(0); // the calling thread takes the first range
+        g.waitForAll();
+    } else {
+        mergeRange(0);
+    }
 
-    for (it = bAssets.begin(); it != bAssets.end(); ++it) {
-        key = it->first;
-        valueB = it->second;
-
-        // Added
-        valueIt = _assets.find(key);
-        if (valueIt == _assets.cend()) {
-            AssetDiff diff;
-            diff.asset = valueB;
-            diff.type = DiffType::ADDED;
-            diffMap.emplace(key, diff);
+    size_t diffCount = 0;
+    for (const auto &rangeDiffs : diffs) {
+        diffCount += rangeDiffs.size();
+    }
+    std::unordered_map<std::string, AssetDiff> diffMap;
+    diffMap.reserve(diffCount);
+    for (const auto &rangeDiffs : diffs) {
+        for (const auto &diff : rangeDiffs) {
+            AssetDiff assetDiff;
+            assetDiff.asset = *diff.sorted->asset;
+            assetDiff.type = diff.type;
+            diffMap.emplace(*diff.sorted->key, assetDiff);
         }
     }
-
     return diffMap;
 }
 
@@ -368,23 +591,31 @@ const std::unordered_map<std::string, Manifest::Asset> &Manifest::getAssets() co
     return _assets;
 }
 
+Manifest::SortedAsset *Manifest::findSortedAsset(const std::string &key) {
+    auto it = std::lower_bound(_sortedAssets.begin(), _sortedAssets.end(), key, [](const SortedAsset &sorted, const std::string &k) {
+        return *sorted.key < k;
+    });
+    if (it == _sortedAssets.end() || *it->key != key) {
+        return nullptr;
+    }
+    return &(*it);
+}
+
 void Manifest::setAssetDownloadState(const std::string &key, const Manifest::DownloadState &state) {
-    auto valueIt = _assets.find(key);
-    if (valueIt != _assets.end()) {
-        valueIt->second.downloadState = state;
+    SortedAsset *sorted = findSortedAsset(key);
+    if (sorted != nullptr) {
+        sorted->asset->downloadState = state;
 
-        // Update json object
-        if (_json.IsObject()) {
+        // Update json object, the entry is found by index since finding a member by name scans all the assets
+        if (sorted->jsonIndex != INVALID_JSON_INDEX && _json.IsObject()) {
             if (_json.HasMember(KEY_ASSETS)) {
                 rapidjson::Value &assets = _json[KEY_ASSETS];
-                if (assets.IsObject()) {
-                    if (assets.HasMember(key.c_str())) {
-                        rapidjson::Value &entry = assets[key.c_str()];
-                        if (entry.HasMember(KEY_DOWNLOAD_STATE) && entry[KEY_DOWNLOAD_STATE].IsInt()) {
-                            entry[KEY_DOWNLOAD_STATE].SetInt(static_cast<int>(state));
-                        } else {
-                            entry.AddMember<int>(KEY_DOWNLOAD_STATE, static_cast<int>(state), _json.GetAllocator());
-                        }
+                if (assets.IsObject() && sorted->jsonIndex < assets.MemberCount()) {
+                    rapidjson::Value &entry = (assets.MemberBegin() + sorted->jsonIndex)->value;
+                    if (entry.HasMember(KEY_DOWNLOAD_STATE) && entry[KEY_DOWNLOAD_STATE].IsInt()) {
+                        entry[KEY_DOWNLOAD_STATE].SetInt(static_cast<int>(state));
+                    } else {
+                        entry.AddMember<int>(KEY_DOWNLOAD_STATE, static_cast<int>(state), _json.GetAllocator());
                     }
                 }
             }
@@ -406,6 +637,7 @@ void Manifest::clear() {
     }
 
     if (_loaded) {
+        _sortedAssets.clear();
         _assets.clear();
         _searchPaths.clear();
         _loaded = false;
@@ -508,11 +740,24 @@ void Manifest::loadManifest(const rapidjson::Document &json) {
     if (json.HasMember(KEY_ASSETS)) {
         const rapidjson::Value &assets = json[KEY_ASSETS];
         if (assets.IsObject()) {
+            _assets.reserve(assets.MemberCount());
+            _sortedAssets.reserve(assets.MemberCount());
+            // the json entries can only be updated in the json object of this manifest
+            uint32_t jsonIndex = &json == &_json ? 0 : INVALID_JSON_INDEX;
             for (rapidjson::Value::ConstMemberIterator itr = assets.MemberBegin(); itr != assets.MemberEnd(); ++itr) {
                 std::string key = itr->name.GetString();
                 Asset asset = parseAsset(key, itr->value);
-                _assets.emplace(key, asset);
+                auto result = _assets.emplace(key, asset);
+                if (result.second) {
+                    _sortedAssets.push_back({&result.first->first, &result.first->second, jsonIndex});
+                }
+                if (jsonIndex != INVALID_JSON_INDEX) {
+                    ++jsonIndex;
+                }
             }
+            std::sort(_sortedAssets.begin(), _sortedAssets.end(), [](const SortedAsset &a, const SortedAsset &b) {
+                return *a.key < *b.key;
+            });
         }
     }
 
@@ -543,4 +788,56 @@ void Manifest::saveToFile(const std::string &filepath) {
     }
 }
 
+bool Manifest::saveToBinaryFile(const std::string &filepath, const std::string &sourceUrl) const {
+    SourceStamp source;
+    if (!_loaded || !readSourceStamp(sourceUrl, &source)) {
+        return false;
+    }
+
+    BinaryWriter writer;
+    writer.write(BINARY_MAGIC);
+    writer.write(BINARY_VERSION);
+    writer.write(source.size);
+    writer.write(source.mtime);
+    writer.writeString(source.md5);
+    writer.writeString(_version);
+    writer.writeString(_packageUrl);
+    writer.writeString(_remoteManifestUrl);
+    writer.writeString(_remoteVersionUrl);
+    writer.writeString(_engineVer);
+    writer.write(static_cast<uint8_t>(_updating ? 1 : 0));
+
+    writer.write(static_cast<uint32_t>(_groups.size()));
+    for (const auto &group : _groups) {
+        writer.writeString(group);
+        writer.writeString(_groupVer.at(group));
+    }
+
+    writer.write(static_cast<uint32_t>(_searchPaths.size()));
+    for (const auto &path : _searchPaths) {
+        writer.writeString(path);
+    }
+
+    writer.write(static_cast<uint32_t>(_sortedAssets.size()));
+    for (const auto &sorted : _sortedAssets) {
+        const Asset &asset = *sorted.asset;
+        // most assets are stored under their path, which is then not written twice
+        const bool hasPath = asset.path != *sorted.key;
+        uint8_t flags = asset.compressed ? BINARY_ASSET_COMPRESSED : 0;
+        if (hasPath) {
+            flags |= BINARY_ASSET_HAS_PATH;
+        }
+        writer.writeString(*sorted.key);
+        writer.writeString(asset.md5);
+        writer.write(flags);
+        if (hasPath) {
+            writer.writeString(asset.path);
+        }
+        writer.write(asset.size);
+        writer.write(static_cast<int32_t>(asset.downloadState));
+    }
+
+    return _fileUtils->writeStringToFile(writer.getBuffer(), filepath);
+}
+
 NS_CC_EXT_END
@@ -140,6 +140,14 @@ public:
      */
     void parseJSONString(const std::string &content, const std::string &manifestRoot);
 
+    /** @brief Parse the binary cache written by saveToBinaryFile into this manifest, which is much faster than parsing its json file
+     * @param binaryUrl   Url of the local binary cache
+     * @param sourceUrl   Path of the json file the cache was written from, the cache is stale unless the file has the same size,
+     *                    modification time and MD5 digest as when the cache was written
+     * @return Whether the cache was valid and loaded, the manifest has no json object to save with saveToFile then
+     */
+    bool parseBinaryFile(const std::string &binaryUrl, const std::string &sourceUrl);
+
     /** @brief Get whether the manifest is being updating
      * @return Updating or not
      */
@@ -208,6 +216,12 @@ protected:
 
     void saveToFile(const std::string &filepath);
 
+    /** @brief Save the manifest in the compact binary format read by parseBinaryFile, with the assets sorted by key
+     * @param filepath    Path of the binary cache
+     * @param sourceUrl   Path of the json file the manifest was loaded from
+     */
+    bool saveToBinaryFile(const std::string &filepath, const std::string &sourceUrl) const;
+
     static Asset parseAsset(const std::string &path, const rapidjson::Value &json);
 
     void clear();
@@ -242,6 +256,17 @@ protected:
     };
 
 private:
+    struct SortedAsset {
+        const std::string *key;
+        Asset *asset;
+        //! Index of the asset in the json assets object, or INVALID_JSON_INDEX
+        uint32_t jsonIndex;
+    };
+
+    static constexpr uint32_t INVALID_JSON_INDEX = 0xFFFFFFFF;
+
+    SortedAsset *findSortedAsset(const std::string &key);
+
     //! Indicate whether the version informations have been fully loaded
     bool _versionLoaded;
 
@@ -281,6 +306,9 @@ private:
     //! Full assets list
     std::unordered_map<std::string, Asset> _assets;
 
+    //! Full assets list sorted by key, for diffing in linear time and for finding assets in the json object
+    std::vector<SortedAsset> _sortedAssets;
+
     //! All search paths
     std::vector<std::string> _searchPaths;
 
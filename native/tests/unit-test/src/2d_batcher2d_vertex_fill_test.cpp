@@ -0,0 +1,151 @@
+/****************************************************************************
+ Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <functional>
+#include <memory>
+#include "2d/renderer/Batcher2d.h"
+#include "2d/renderer/RenderDrawInfo.h"
+#include "2d/renderer/RenderEntity.h"
+#include "2d/renderer/UIMeshBuffer.h"
+#include "core/Root.h"
+#include "gtest/gtest.h"
+
+using namespace cc;
+
+namespace {
+
+constexpr uint32_t STRIDE = 9;
+constexpr float UNTOUCHED = -1234.F;
+
+// a component draw info whose vertices are filled from its own render2d layout
+struct FillTarget {
+    ccstd::vector<float> source;
+    ccstd::vector<float> vertices;
+    ccstd::vector<uint16_t> indices;
+    RenderDrawInfo drawInfo;
+
+    FillTarget(uint32_t vertexCount, UIMeshBuffer *meshBuffer, uint16_t *indexData) {
+        source.resize(vertexCount * STRIDE);
+        for (uint32_t i = 0; i < vertexCount; ++i) {
+            float *vertex = &source[i * STRIDE];
+            vertex[0] = static_cast<float>(i) * 0.75F - 3.F;
+            vertex[1] = 2.F - static_cast<float>(i % 5) * 1.5F;
+            vertex[2] = static_cast<float>(i % 3) * 0.25F;
+        }
+        vertices.assign(vertexCount * STRIDE, UNTOUCHED);
+        for (uint32_t i = 0; i < vertexCount + 2; ++i) {
+            indices.push_back(static_cast<uint16_t>((i * 7) % vertexCount));
+        }
+
+        drawInfo.setDrawInfoType(static_cast<uint32_t>(RenderDrawInfoType::COMP));
+        drawInfo.setStride(STRIDE);
+        drawInfo.setVbCount(vertexCount);
+        drawInfo.setIbCount(static_cast<uint32_t>(indices.size()));
+        drawInfo.setVbBuffer(vertices.data());
+        drawInfo.setIbBuffer(indices.data());
+        drawInfo.setIDataBuffer(indexData);
+        drawInfo.setMeshBuffer(meshBuffer);
+        drawInfo.setRender2dBufferToNative(reinterpret_cast<uint8_t *>(source.data()));
+        drawInfo.setVertDirty(true);
+    }
+};
+
+void expectFilled(const FillTarget &target, const Mat4 &world, float opacity) {
+    const uint32_t vertexCount = target.drawInfo.getVbCount();
+    for (uint32_t i = 0; i < vertexCount; ++i) {
+        const float *src = &target.source[i * STRIDE];
+        const float *dst = &target.vertices[i * STRIDE];
+        Vec3 expected;
+        expected.transformMat4(Vec3(src[0], src[1], src[2]), world);
+        EXPECT_NEAR(dst[0], expected.x, 1e-4F);
+        EXPECT_NEAR(dst[1], expected.y, 1e-4F);
+        EXPECT_NEAR(dst[2], expected.z, 1e-4F);
+        // the uv after the position is not written
+        EXPECT_EQ(dst[3], UNTOUCHED);
+        EXPECT_EQ(dst[4], UNTOUCHED);
+        EXPECT_EQ(dst[5], 1.F);
+        EXPECT_EQ(dst[6], 1.F);
+        EXPECT_EQ(dst[7], 1.F);
+        EXPECT_EQ(dst[8], opacity);
+    }
+    EXPECT_FALSE(target.drawInfo.getVertDirty());
+}
+
+void runFills(uint32_t targetCount, const std::function<uint32_t(uint32_t)> &vertexCountOf) {
+    IntrusivePtr<Node> node = new Node();
+    node->setPosition(Vec3(4, -2, 1.5F));
+    node->setRotationFromEuler(20, -35, 70);
+    node->setScale(Vec3(2, 0.5F, 3));
+    IntrusivePtr<RenderEntity> entity = ccnew RenderEntity(RenderEntityType::DYNAMIC);
+    entity->setNode(node);
+    entity->setVBColorDirty(true);
+    entity->setOpacity(0.5F);
+
+    UIMeshBuffer meshBuffer;
+    meshBuffer.initialize(ccstd::vector<gfx::Attribute>{}, true);
+    constexpr uint32_t FIRST_INDEX = 6;
+    meshBuffer.setIndexOffset(FIRST_INDEX);
+
+    uint32_t indexCount = FIRST_INDEX;
+    for (uint32_t i = 0; i < targetCount; ++i) {
+        indexCount += vertexCountOf(i) + 2;
+    }
+    ccstd::vector<uint16_t> indexData(indexCount, 0xFFFF);
+    ccstd::vector<std::unique_ptr<FillTarget>> targets;
+    for (uint32_t i = 0; i < targetCount; ++i) {
+        targets.emplace_back(std::make_unique<FillTarget>(vertexCountOf(i), &meshBuffer, indexData.data()));
+    }
+
+    Batcher2d batcher(Root::getInstance());
+    for (auto &target : targets) {
+        batcher.enqueueVertexFill(entity, &target->drawInfo, node);
+    }
+    // the index ranges are reserved by the walk, before anything is filled
+    EXPECT_EQ(meshBuffer.getIndexOffset(), indexCount);
+    EXPECT_EQ(targets.back()->vertices[0], UNTOUCHED);
+    batcher.flushVertexFills();
+
+    const Mat4 &world = node->getWorldMatrix();
+    uint32_t indexOffset = FIRST_INDEX;
+    for (auto &target : targets) {
+        expectFilled(*target, world, 0.5F);
+        for (uint16_t index : target->indices) {
+            EXPECT_EQ(indexData[indexOffset++], index);
+        }
+    }
+    EXPECT_EQ(indexData[0], 0xFFFF);
+}
+
+} // namespace
+
+TEST(Batcher2dTest, fillsVerticesLikeVec3TransformMat4) {
+    const uint32_t vertexCounts[] = {1, 3, 4, 7, 2, 5};
+    runFills(6, [&](uint32_t i) { return vertexCounts[i]; });
+}
+
+TEST(Batcher2dTest, fillsVerticesInParallelChunks) {
+    // enough jobs and vertices to be split across the job system
+    runFills(129, [](uint32_t i) { return 33 + (i % 4) * 2; });
+}
@@ -0,0 +1,84 @@
+/****************************************************************************
+ Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <cmath>
+#include "cocos/3d/models/SkinningModel.h"
+#include "cocos/math/Quaternion.h"
+#include "gtest/gtest.h"
+
+using namespace cc;
+
+namespace {
+
+Mat4 makeRTS(const Vec3 &euler, const Vec3 &translation, const Vec3 &scale) {
+    Quaternion rotation;
+    Quaternion::fromEuler(euler.x, euler.y, euler.z, &rotation);
+    Mat4 out;
+    Mat4::fromRTS(rotation, translation, scale, &out);
+    return out;
+}
+
+void expectJointData(const Mat4 &world, const Mat4 &bindpose) {
+    float jointData[12];
+    SkinningModel::computeJointData(world, bindpose, jointData);
+
+    Mat4 expected;
+    Mat4::multiply(world, bindpose, &expected);
+    const auto expectNear = [](float actual, float value) {
+        EXPECT_NEAR(actual, value, 1e-5F * std::fmax(1.F, std::fabs(value)));
+    };
+    // the first three columns of world * bindpose, with the translation in their w components
+    for (uint32_t c = 0; c < 3; ++c) {
+        for (uint32_t r = 0; r < 3; ++r) {
+            expectNear(jointData[c * 4 + r], expected.m[c * 4 + r]);
+        }
+        expectNear(jointData[c * 4 + 3], expected.m[12 + c]);
+    }
+}
+
+} // namespace
+
+TEST(SkinningModelTest, jointDataMatchesMatrixMultiply) {
+    expectJointData(Mat4::IDENTITY, Mat4::IDENTITY);
+
+    const Mat4 world = makeRTS(Vec3(30, -45, 60), Vec3(1.5F, -2, 3), Vec3(2, 0.5F, 3));
+    const Mat4 bindpose = makeRTS(Vec3(-10, 80, 15), Vec3(-0.25F, 4, 7), Vec3(0.1F, 4, 1.25F));
+    expectJointData(world, Mat4::IDENTITY);
+    expectJointData(Mat4::IDENTITY, bindpose);
+    expectJointData(world, bindpose);
+    expectJointData(bindpose, world);
+
+    Mat4 inverse = bindpose;
+    inverse.inverse();
+    expectJointData(world, inverse);
+
+    // a projective bottom row still has to take part in every column
+    Mat4 general(1, 2, 3, 4,
+                 -5, 6, -7, 8,
+                 9, -10, 11, 12,
+                 0.5F, -0.25F, 0.125F, 2);
+    expectJointData(general, world);
+    expectJointData(world, general);
+}
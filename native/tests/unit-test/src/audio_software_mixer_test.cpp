@@ -0,0 +1,195 @@
+/****************************************************************************
+ Copyright (c) 2021-2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#include <vector>
+#include "audio/common/mixer/SoftwareMixer.h"
+#include "gtest/gtest.h"
+#include "utils.h"
+
+// the mixer is built with the OpenAL backend
+#if CC_USE_AUDIO && (CC_PLATFORM == CC_PLATFORM_WINDOWS || CC_PLATFORM == CC_PLATFORM_LINUX)
+
+using namespace cc;
+
+// SoftwareMixer run through a NullMixerOutput: exact mixing at the output rate, resampling,
+// voice endings and the virtualization of voices beyond the budget.
+
+namespace {
+
+constexpr uint32_t SAMPLE_RATE = 48000;
+
+SoftwareMixer::Sound makeSound(const std::vector<int16_t> &samples, uint32_t channelCount, uint32_t sampleRate = SAMPLE_RATE) {
+    SoftwareMixer::Sound sound;
+    sound.frames = samples.data();
+    sound.frameCount = static_cast<uint32_t>(samples.size() / channelCount);
+    sound.channelCount = channelCount;
+    sound.sampleRate = sampleRate;
+    return sound;
+}
+
+std::vector<int16_t> makeRamp(uint32_t count, int16_t start, int16_t step) {
+    std::vector<int16_t> samples(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        samples[i] = static_cast<int16_t>(start + step * static_cast<int>(i));
+    }
+    return samples;
+}
+
+} // namespace
+
+TEST(SoftwareMixerTest, mixesAtTheOutputRateExactly) {
+    SoftwareMixer mixer(SAMPLE_RATE, 2, 8);
+    NullMixerOutput output;
+    ASSERT_TRUE(output.start(&mixer));
+
+    const auto silence = output.render(64);
+    ASSERT_EQ(128U, silence.size());
+    for (auto sample : silence) {
+        EXPECT_EQ(0, sample);
+    }
+
+    // odd lengths leave tails for the scalar loops
+    const auto stereo = makeRamp(2 * 1001, -2000, 3);
+    const auto mono = makeRamp(1001, 500, -1);
+    mixer.play(makeSound(stereo, 2), 1.0F, false);
+    mixer.play(makeSound(mono, 1), 1.0F, false);
+
+    const auto &mixed = output.render(999);
+    for (uint32_t i = 0; i < 999; ++i) {
+        ASSERT_EQ(stereo[i * 2] + mono[i], mixed[i * 2]) << "frame " << i;
+        ASSERT_EQ(stereo[i * 2 + 1] + mono[i], mixed[i * 2 + 1]) << "frame " << i;
+    }
+}
+
+TEST(SoftwareMixerTest, resamplesByLinearInterpolation) {
+    SoftwareMixer mixer(SAMPLE_RATE, 2, 8);
+    NullMixerOutput output;
+    output.start(&mixer);
+
+    const auto mono = makeRamp(400, 0, 100);
+    mixer.play(makeSound(mono, 1, SAMPLE_RATE / 2), 1.0F, false);
+
+    const auto &mixed = output.render(501);
+    for (uint32_t i = 0; i + 2 < 501; ++i) {
+        const int expected = static_cast<int>(i) * 50;
+        ASSERT_NEAR(expected, mixed[i * 2], 1) << "frame " << i;
+        ASSERT_EQ(mixed[i * 2], mixed[i * 2 + 1]);
+    }
+}
+
+TEST(SoftwareMixerTest, finishesAndLoops) {
+    SoftwareMixer mixer(SAMPLE_RATE, 2, 8);
+    NullMixerOutput output;
+    output.start(&mixer);
+
+    const auto once = makeRamp(100, 1, 1);
+    const auto looped = makeRamp(30, 1000, 1);
+    const auto onceId = mixer.play(makeSound(once, 1), 1.0F, false);
+    const auto loopedId = mixer.play(makeSound(looped, 1), 1.0F, true);
+
+    const auto &mixed = output.render(256);
+    for (uint32_t i = 0; i < 256; ++i) {
+        const int expected = (i < 100 ? once[i] : 0) + looped[i % 30];
+        ASSERT_EQ(expected, mixed[i * 2]) << "frame " << i;
+    }
+
+    std::vector<SoftwareMixer::VoiceId> finished;
+    mixer.collectFinished(finished);
+    ASSERT_EQ(1U, finished.size());
+    EXPECT_EQ(onceId, finished[0]);
+    EXPECT_FALSE(mixer.isActive(onceId));
+    EXPECT_TRUE(mixer.isActive(loopedId));
+    EXPECT_NEAR(16.0F / SAMPLE_RATE, mixer.getTime(loopedId), 1e-6F);
+
+    // a stopped voice's id never addresses the voice reusing its slot
+    EXPECT_TRUE(mixer.stop(loopedId));
+    const auto reusedId = mixer.play(makeSound(once, 1), 1.0F, false);
+    EXPECT_NE(loopedId, reusedId);
+    EXPECT_FALSE(mixer.setVolume(loopedId, 0.5F));
+    EXPECT_TRUE(mixer.setVolume(reusedId, 0.5F));
+}
+
+TEST(SoftwareMixerTest, mixesOnlyTheMostImportantVoices) {
+    SoftwareMixer mixer(SAMPLE_RATE, 2, 4);
+    NullMixerOutput output;
+    output.start(&mixer);
+
+    std::vector<std::vector<int16_t>> sounds;
+    for (int i = 0; i < 10; ++i) {
+        sounds.emplace_back(2048, static_cast<int16_t>(100 * (i + 1)));
+    }
+    for (int i = 0; i < 10; ++i) {
+        mixer.play(makeSound(sounds[i], 1), 1.0F, false, i);
+    }
+    // silent voices are virtual without taking a place in the budget
+    const auto silentId = mixer.play(makeSound(sounds[9], 1), 0.0F, false, 100);
+
+    const auto &mixed = output.render(128);
+    for (uint32_t i = 0; i < 128; ++i) {
+        ASSERT_EQ(700 + 800 + 900 + 1000, mixed[i * 2]) << "frame " << i;
+    }
+    auto stats = mixer.getStats();
+    EXPECT_EQ(11U, stats.voices);
+    EXPECT_EQ(4U, stats.audible);
+    EXPECT_EQ(7U, stats.virtualized);
+
+    // virtual voices keep their time
+    EXPECT_NEAR(128.0F / SAMPLE_RATE, mixer.getTime(silentId), 1e-6F);
+    mixer.setMaxAudibleVoices(16);
+    mixer.setVolume(silentId, 1.0F);
+    output.render(128);
+    stats = mixer.getStats();
+    EXPECT_EQ(11U, stats.audible);
+    EXPECT_EQ(0U, stats.virtualized);
+    EXPECT_NEAR(256.0F / SAMPLE_RATE, mixer.getTime(silentId), 1e-6F);
+}
+
+TEST(SoftwareMixerBenchmark, DISABLED_hundredsOfVoices) {
+    constexpr uint32_t VOICE_COUNT = 512;
+    constexpr uint32_t BLOCK_FRAMES = 1024;
+    constexpr uint32_t BLOCK_COUNT = 200;
+
+    const auto sound = makeRamp(SAMPLE_RATE, -8000, 1);
+    for (const uint32_t budget : {VOICE_COUNT, 64U}) {
+        SoftwareMixer mixer(SAMPLE_RATE, 2, budget);
+        NullMixerOutput output;
+        output.start(&mixer);
+        for (uint32_t i = 0; i < VOICE_COUNT; ++i) {
+            // mixed rates, so most voices are resampled
+            mixer.play(makeSound(sound, 1 + i % 2, i % 3 == 0 ? SAMPLE_RATE : 44100), 0.01F, true, static_cast<int>(i % 4));
+        }
+
+        const double ms = measureMs([&]() {
+            for (uint32_t i = 0; i < BLOCK_COUNT; ++i) {
+                output.render(BLOCK_FRAMES);
+            }
+        });
+        const double realtime = static_cast<double>(BLOCK_FRAMES) * BLOCK_COUNT / SAMPLE_RATE * 1000.0;
+        reportBenchmark("%u voices, %u audible: %.2f ms per block, %.1f%% of realtime",
+                        VOICE_COUNT, mixer.getStats().audible, ms / BLOCK_COUNT, ms / realtime * 100.0);
+        EXPECT_EQ(VOICE_COUNT, mixer.getStats().voices);
+    }
+}
+
+#endif
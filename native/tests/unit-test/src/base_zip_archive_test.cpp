@@ -0,0 +1,330 @@
+/****************************************************************************
+ Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+#include <cstdio>
+#include <cstring>
+#include "cocos/base/ZipArchive.h"
+#include "cocos/base/memory/Memory.h"
+#include "cocos/base/std/container/string.h"
+#include "cocos/base/std/container/vector.h"
+#include "gtest/gtest.h"
+
+using namespace cc;
+
+namespace {
+
+struct TestEntry {
+    ccstd::string name;
+    ccstd::vector<uint8_t> contents;
+    bool deflate{false};
+};
+
+void putU16(ccstd::vector<uint8_t> *out, uint32_t value) {
+    out->push_back(static_cast<uint8_t>(value));
+    out->push_back(static_cast<uint8_t>(value >> 8));
+}
+
+void putU32(ccstd::vector<uint8_t> *out, uint32_t value) {
+    putU16(out, value & 0xffff);
+    putU16(out, value >> 16);
+}
+
+ccstd::vector<uint8_t> deflateRaw(const ccstd::vector<uint8_t> &contents) {
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    deflateInit2(&stream, Z_BEST_SPEED, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+    ccstd::vector<uint8_t> out(deflateBound(&stream, static_cast<uLong>(contents.size())));
+    stream.next_in = const_cast<Bytef *>(contents.data());
+    stream.avail_in = static_cast<uInt>(contents.size());
+    stream.next_out = out.data();
+    stream.avail_out = static_cast<uInt>(out.size());
+    deflate(&stream, Z_FINISH);
+    out.resize(stream.total_out);
+    deflateEnd(&stream);
+    return out;
+}
+
+// writes a minimal archive: local headers and data, then the central directory
+ccstd::vector<uint8_t> buildArchive(const ccstd::vector<TestEntry> &entries) {
+    ccstd::vector<uint8_t> archive;
+    ccstd::vector<uint8_t> directory;
+    for (const auto &entry : entries) {
+        const auto data = entry.deflate ? deflateRaw(entry.contents) : entry.contents;
+        const auto crc = static_cast<uint32_t>(crc32(0, entry.contents.data(), static_cast<uInt>(entry.contents.size())));
+        const auto offset = static_cast<uint32_t>(archive.size());
+        const uint32_t method = entry.deflate ? 8 : 0;
+
+        putU32(&archive, 0x04034b50);
+        putU16(&archive, 20);
+        putU16(&archive, 0);
+        putU16(&archive, method);
+        putU32(&archive, 0);
+        putU32(&archive, crc);
+        putU32(&archive, static_cast<uint32_t>(data.size()));
+        putU32(&archive, static_cast<uint32_t>(entry.contents.size()));
+        putU16(&archive, static_cast<uint32_t>(entry.name.size()));
+        putU16(&archive, 4);
+        archive.insert(archive.end(), entry.name.begin(), entry.name.end());
+        putU32(&archive, 0xcafe0000); // an unknown extra field only present in the local header
+        archive.insert(archive.end(), data.begin(), data.end());
+
+        putU32(&directory, 0x02014b50);
+        putU16(&directory, 20);
+        putU16(&directory, 20);
+        putU16(&directory, 0);
+        putU16(&directory, method);
+        putU32(&directory, 0);
+        putU32(&directory, crc);
+        putU32(&directory, static_cast<uint32_t>(data.size()));
+        putU32(&directory, static_cast<uint32_t>(entry.contents.size()));
+        putU16(&directory, static_cast<uint32_t>(entry.name.size()));
+        putU16(&directory, 0);
+        putU16(&directory, 0);
+        putU16(&directory, 0);
+        putU16(&directory, 0);
+        putU32(&directory, 0);
+        putU32(&directory, offset);
+        directory.insert(directory.end(), entry.name.begin(), entry.name.end());
+    }
+
+    const auto directoryOffset = static_cast<uint32_t>(archive.size());
+    archive.insert(archive.end(), directory.begin(), directory.end());
+    putU32(&archive, 0x06054b50);
+    putU16(&archive, 0);
+    putU16(&archive, 0);
+    putU16(&archive, static_cast<uint32_t>(entries.size()));
+    putU16(&archive, static_cast<uint32_t>(entries.size()));
+    putU32(&archive, static_cast<uint32_t>(directory.size()));
+    putU32(&archive, directoryOffset);
+    const char comment[] = "archive comment";
+    putU16(&archive, sizeof(comment));
+    archive.insert(archive.end(), comment, comment + sizeof(comment));
+    return archive;
+}
+
+ccstd::vector<uint8_t> makeContents(size_t size, uint32_t seed, bool compressible) {
+    ccstd::vector<uint8_t> contents(size);
+    uint32_t state = seed * 2654435761U + 1;
+    for (size_t i = 0; i < size; ++i) {
+        state = state * 1664525U + 1013904223U;
+        contents[i] = compressible ? static_cast<uint8_t>((i / 64) + seed) : static_cast<uint8_t>(state >> 24);
+    }
+    return contents;
+}
+
+IntrusivePtr<ZipArchive> createArchive(const ccstd::vector<uint8_t> &bytes) {
+    Data data;
+    data.copy(bytes.data(), static_cast<uint32_t>(bytes.size()));
+    return ZipArchive::create(ccnew MappedFile(std::move(data)));
+}
+
+} // namespace
+
+TEST(ZipArchiveTest, indexesEntries) {
+    ccstd::vector<TestEntry> entries;
+    entries.push_back({"stored.bin", makeContents(1000, 1, false), false});
+    entries.push_back({"dir/deflated.bin", makeContents(50000, 2, true), true});
+    entries.push_back({"empty.bin", {}, false});
+    auto archive = createArchive(buildArchive(entries));
+    ASSERT_NE(archive, nullptr);
+
+    EXPECT_EQ(archive->getFileCount(), 3);
+    EXPECT_TRUE(archive->fileExists("dir/deflated.bin"));
+    EXPECT_FALSE(archive->fileExists("missing.bin"));
+    EXPECT_EQ(archive->getFileSize("dir/deflated.bin"), 50000);
+    EXPECT_EQ(archive->getFileSize("missing.bin"), -1);
+
+    for (const auto &entry : entries) {
+        Data data;
+        ASSERT_TRUE(archive->getFileData(entry.name, &data));
+        ASSERT_EQ(data.getSize(), entry.contents.size());
+        EXPECT_TRUE(entry.contents.empty() || memcmp(data.getBytes(), entry.contents.data(), entry.contents.size()) == 0);
+    }
+
+    uint32_t size = 0;
+    unsigned char *bytes = archive->getFileData("missing.bin", &size);
+    EXPECT_EQ(bytes, nullptr);
+    EXPECT_EQ(size, 0);
+}
+
+TEST(ZipArchiveTest, servesStoredEntriesWithoutCopying) {
+    ccstd::vector<TestEntry> entries;
+    entries.push_back({"stored.bin", makeContents(4096, 3, false), false});
+    entries.push_back({"deflated.bin", makeContents(4096, 4, true), true});
+    const auto bytes = buildArchive(entries);
+    auto archive = createArchive(bytes);
+    ASSERT_NE(archive, nullptr);
+
+    const uint8_t *view = nullptr;
+    uint32_t size = 0;
+    ASSERT_TRUE(archive->getStoredView("stored.bin", &view, &size));
+    EXPECT_EQ(size, 4096);
+    EXPECT_EQ(memcmp(view, entries[0].contents.data(), size), 0);
+    EXPECT_FALSE(archive->getStoredView("deflated.bin", &view, &size));
+}
+
+TEST(ZipArchiveTest, readsEntriesInBatches) {
+    ccstd::vector<TestEntry> entries;
+    ccstd::vector<ccstd::string> names;
+    for (uint32_t i = 0; i < 24; ++i) {
+        entries.push_back({"file" + std::to_string(i), makeContents(32 * 1024 + i, i, i % 2 == 0), i % 3 != 0});
+        names.push_back(entries.back().name);
+    }
+    names.emplace_back("missing.bin");
+    auto archive = createArchive(buildArchive(entries));
+    ASSERT_NE(archive, nullptr);
+
+    ccstd::vector<Data> results;
+    archive->getFilesData(names, &results);
+    ASSERT_EQ(results.size(), names.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        ASSERT_EQ(results[i].getSize(), entries[i].contents.size());
+        EXPECT_EQ(memcmp(results[i].getBytes(), entries[i].contents.data(), entries[i].contents.size()), 0);
+    }
+    EXPECT_TRUE(results.back().isNull());
+}
+
+TEST(ZipArchiveTest, rejectsInvalidArchives) {
+    EXPECT_EQ(createArchive(makeContents(1000, 5, false)), nullptr);
+
+    ccstd::vector<TestEntry> entries;
+    entries.push_back({"stored.bin", makeContents(100, 6, false), false});
+    auto bytes = buildArchive(entries);
+    bytes.resize(bytes.size() - 30);
+    EXPECT_EQ(createArchive(bytes), nullptr);
+}
+
+#if (CC_PLATFORM != CC_PLATFORM_WINDOWS)
+
+namespace {
+
+bool writeFile(const ccstd::string &path, const ccstd::vector<uint8_t> &bytes) {
+    FILE *fp = fopen(path.c_str(), "wb");
+    if (!fp) {
+        return false;
+    }
+    fwrite(bytes.data(), 1, bytes.size(), fp);
+    fclose(fp);
+    return true;
+}
+
+} // namespace
+
+TEST(ZipArchiveTest, sharesMountedArchives) {
+    ccstd::vector<TestEntry> entries;
+    entries.push_back({"stored.bin", makeContents(100, 7, false), false});
+    const ccstd::string path{"zip_archive_test.zip"};
+    ASSERT_TRUE(writeFile(path, buildArchive(entries)));
+
+    auto archive = ZipArchive::mount(path);
+    ASSERT_NE(archive, nullptr);
+    EXPECT_EQ(ZipArchive::mount(path), archive);
+    ZipArchive::unmount(path);
+    EXPECT_NE(ZipArchive::mount(path), archive);
+    ZipArchive::unmountAll();
+    remove(path.c_str());
+}
+
+TEST(ZipArchiveTest, remountsReplacedArchives) {
+    ccstd::vector<TestEntry> entries;
+    entries.push_back({"stored.bin", makeContents(100, 8, false), false});
+    const ccstd::string path{"zip_archive_replaced_test.zip"};
+    ASSERT_TRUE(writeFile(path, buildArchive(entries)));
+    auto archive = ZipArchive::mount(path);
+    ASSERT_NE(archive, nullptr);
+
+    entries.push_back({"added.bin", makeContents(200, 9, true), true});
+    ASSERT_TRUE(writeFile(path, buildArchive(entries)));
+    auto replaced = ZipArchive::mount(path);
+    ASSERT_NE(replaced, nullptr);
+    EXPECT_NE(replaced, archive);
+    EXPECT_TRUE(replaced->fileExists("added.bin"));
+    // the old index is still readable by whoever holds it
+    EXPECT_EQ(archive->getFileCount(), 1);
+
+    ZipArchive::unmountAll();
+    remove(path.c_str());
+}
+
+TEST(ZipArchiveTest, unmountsArchivesBelowDirectory) {
+    ccstd::vector<TestEntry> entries;
+    entries.push_back({"stored.bin", makeContents(100, 10, false), false});
+    const auto bytes = buildArchive(entries);
+    const ccstd::string directory{"zip_archive_test_dir"};
+    const ccstd::string inside{directory + "/inside.zip"};
+    const ccstd::string sibling{directory + "_sibling.zip"};
+    mkdir(directory.c_str(), 0755);
+    ASSERT_TRUE(writeFile(inside, bytes));
+    ASSERT_TRUE(writeFile(sibling, bytes));
+
+    auto insideArchive = ZipArchive::mount(inside);
+    auto siblingArchive = ZipArchive::mount(sibling);
+    ASSERT_NE(insideArchive, nullptr);
+    ASSERT_NE(siblingArchive, nullptr);
+    ZipArchive::unmountDirectory(directory);
+    EXPECT_NE(ZipArchive::mount(inside), insideArchive);
+    EXPECT_EQ(ZipArchive::mount(sibling), siblingArchive);
+
+    ZipArchive::unmountAll();
+    remove(inside.c_str());
+    remove(sibling.c_str());
+    rmdir(directory.c_str());
+}
+
+TEST(ZipArchiveTest, readsStreamedArchives) {
+    ccstd::vector<TestEntry> entries;
+    ccstd::vector<ccstd::string> names;
+    for (uint32_t i = 0; i < 8; ++i) {
+        entries.push_back({"file" + std::to_string(i), makeContents(16 * 1024 + i, i + 11, i % 2 == 0), i % 2 == 0});
+        names.push_back(entries.back().name);
+    }
+    const ccstd::string path{"zip_archive_streamed_test.zip"};
+    ASSERT_TRUE(writeFile(path, buildArchive(entries)));
+
+    auto archive = ZipArchive::openStreamed(path);
+    ASSERT_NE(archive, nullptr);
+    EXPECT_EQ(archive->getFileCount(), entries.size());
+
+    const uint8_t *view = nullptr;
+    uint32_t size = 0;
+    EXPECT_FALSE(archive->getStoredView("file1", &view, &size));
+
+    ccstd::vector<Data> results;
+    archive->getFilesData(names, &results);
+    ASSERT_EQ(results.size(), entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        ASSERT_EQ(results[i].getSize(), entries[i].contents.size());
+        EXPECT_EQ(memcmp(results[i].getBytes(), entries[i].contents.data(), entries[i].contents.size()), 0);
+    }
+
+    archive = nullptr;
+    remove(path.c_str());
+    EXPECT_EQ(ZipArchive::openStreamed(path), nullptr);
+}
+
+#endif
@@ -0,0 +1,442 @@
+/****************************************************************************
+ Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#include <zlib.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include "cocos/base/MD5.h"
+#include "cocos/base/ZipStreamExtractor.h"
+#include "cocos/base/memory/Memory.h"
+#include "cocos/base/std/container/string.h"
+#include "cocos/base/std/container/vector.h"
+#include "cocos/network/HttpSession-curl.h"
+#include "cocos/platform/FileUtils.h"
+#include "gtest/gtest.h"
+
+using namespace cc;
+
+TEST(MD5Test, matchesReferenceDigests) {
+    const char *inputs[] = {"", "abc", "message digest", "12345678901234567890123456789012345678901234567890123456789012345678901234567890"};
+    const char *digests[] = {"d41d8cd98f00b204e9800998ecf8427e", "900150983cd24fb0d6963f7d28e17f72", "f96b697d7cb7938d525a2f31aaf161d0", "57edf4a22be3c955ac49da2e2107b67a"};
+    for (size_t i = 0; i < 4; ++i) {
+        MD5 whole;
+        whole.update(inputs[i], strlen(inputs[i]));
+        EXPECT_EQ(digests[i], whole.hexDigest());
+
+        MD5 pieces;
+        for (const char *p = inputs[i]; *p; ++p) {
+            pieces.update(p, 1);
+        }
+        EXPECT_EQ(digests[i], pieces.hexDigest());
+    }
+}
+
+// the extracted files are written through FileUtils
+#if (CC_PLATFORM != CC_PLATFORM_WINDOWS)
+
+    #include <unistd.h>
+    #include <atomic>
+    #include <chrono>
+    #include <condition_variable>
+    #include <mutex>
+    #include <thread>
+
+namespace {
+
+struct TestEntry {
+    ccstd::string name;
+    ccstd::vector<uint8_t> contents;
+    bool deflate{false};
+    // sizes and crc after the data, as written by streaming zip tools
+    bool dataDescriptor{false};
+};
+
+void putU16(ccstd::vector<uint8_t> *out, uint32_t value) {
+    out->push_back(static_cast<uint8_t>(value));
+    out->push_back(static_cast<uint8_t>(value >> 8));
+}
+
+void putU32(ccstd::vector<uint8_t> *out, uint32_t value) {
+    putU16(out, value & 0xffff);
+    putU16(out, value >> 16);
+}
+
+ccstd::vector<uint8_t> deflateRaw(const ccstd::vector<uint8_t> &contents) {
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    deflateInit2(&stream, Z_BEST_SPEED, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+    ccstd::vector<uint8_t> out(deflateBound(&stream, static_cast<uLong>(contents.size())));
+    stream.next_in = const_cast<Bytef *>(contents.data());
+    stream.avail_in = static_cast<uInt>(contents.size());
+    stream.next_out = out.data();
+    stream.avail_out = static_cast<uInt>(out.size());
+    deflate(&stream, Z_FINISH);
+    out.resize(stream.total_out);
+    deflateEnd(&stream);
+    return out;
+}
+
+// writes local headers and data, then the central directory, which the extractor never reads
+ccstd::vector<uint8_t> buildArchive(const ccstd::vector<TestEntry> &entries) {
+    ccstd::vector<uint8_t> archive;
+    ccstd::vector<uint8_t> directory;
+    for (const auto &entry : entries) {
+        const auto data = entry.deflate ? deflateRaw(entry.contents) : entry.contents;
+        const auto crc = static_cast<uint32_t>(crc32(0, entry.contents.data(), static_cast<uInt>(entry.contents.size())));
+        const auto offset = static_cast<uint32_t>(archive.size());
+        const uint32_t method = entry.deflate ? 8 : 0;
+        const uint32_t flags = entry.dataDescriptor ? 8 : 0;
+
+        putU32(&archive, 0x04034b50);
+        putU16(&archive, 20);
+        putU16(&archive, flags);
+        putU16(&archive, method);
+        putU32(&archive, 0);
+        putU32(&archive, entry.dataDescriptor ? 0 : crc);
+        putU32(&archive, entry.dataDescriptor ? 0 : static_cast<uint32_t>(data.size()));
+        putU32(&archive, entry.dataDescriptor ? 0 : static_cast<uint32_t>(entry.contents.size()));
+        putU16(&archive, static_cast<uint32_t>(entry.name.size()));
+        putU16(&archive, 4);
+        archive.insert(archive.end(), entry.name.begin(), entry.name.end());
+        putU32(&archive, 0xcafe0000); // an unknown extra field
+        archive.insert(archive.end(), data.begin(), data.end());
+        if (entry.dataDescriptor) {
+            putU32(&archive, 0x08074b50);
+            putU32(&archive, crc);
+            putU32(&archive, static_cast<uint32_t>(data.size()));
+            putU32(&archive, static_cast<uint32_t>(entry.contents.size()));
+        }
+
+        putU32(&directory, 0x02014b50);
+        putU16(&directory, 20);
+        putU16(&directory, 20);
+        putU16(&directory, flags);
+        putU16(&directory, method);
+        putU32(&directory, 0);
+        putU32(&directory, crc);
+        putU32(&directory, static_cast<uint32_t>(data.size()));
+        putU32(&directory, static_cast<uint32_t>(entry.contents.size()));
+        putU16(&directory, static_cast<uint32_t>(entry.name.size()));
+        putU16(&directory, 0);
+        putU16(&directory, 0);
+        putU16(&directory, 0);
+        putU16(&directory, 0);
+        putU32(&directory, 0);
+        putU32(&directory, offset);
+        directory.insert(directory.end(), entry.name.begin(), entry.name.end());
+    }
+
+    const auto directoryOffset = static_cast<uint32_t>(archive.size());
+    archive.insert(archive.end(), directory.begin(), directory.end());
+    putU32(&archive, 0x06054b50);
+    putU16(&archive, 0);
+    putU16(&archive, 0);
+    putU16(&archive, static_cast<uint32_t>(entries.size()));
+    putU16(&archive, static_cast<uint32_t>(entries.size()));
+    putU32(&archive, static_cast<uint32_t>(directory.size()));
+    putU32(&archive, directoryOffset);
+    putU16(&archive, 0);
+    return archive;
+}
+
+ccstd::vector<uint8_t> makeContents(size_t size, uint32_t seed, bool compressible) {
+    ccstd::vector<uint8_t> contents(size);
+    uint32_t state = seed * 2654435761U + 1;
+    for (size_t i = 0; i < size; ++i) {
+        state = state * 1664525U + 1013904223U;
+        contents[i] = compressible ? static_cast<uint8_t>((i / 64) + seed) : static_cast<uint8_t>(state >> 24);
+    }
+    return contents;
+}
+
+ccstd::vector<TestEntry> makeEntries() {
+    ccstd::vector<TestEntry> entries;
+    entries.push_back({"assets/", {}, false, false});
+    entries.push_back({"assets/empty.txt", {}, false, false});
+    entries.push_back({"assets/stored.bin", makeContents(3000, 1, false), false, false});
+    for (uint32_t i = 0; i < 40; ++i) {
+        // enough small entries for several batches
+        entries.push_back({"assets/small/" + std::to_string(i) + ".json", makeContents(60000 + i, 10 + i, i % 2 == 0), true, false});
+    }
+    entries.push_back({"assets/large.bin", makeContents(1536 * 1024, 2, false), true, false});
+    entries.push_back({"assets/large_stored.bin", makeContents(1100 * 1024, 3, false), false, false});
+    // small once deflated, but too large to be inflated into a buffer
+    entries.push_back({"assets/large_compressible.bin", makeContents(3 * 1024 * 1024, 7, true), true, false});
+    entries.push_back({"scripts/streamed.js", makeContents(200000, 4, true), true, true});
+    entries.push_back({"scripts/streamed_empty.js", {}, true, true});
+    return entries;
+}
+
+ccstd::string rootPath() {
+    char cwd[4096];
+    return ccstd::string{getcwd(cwd, sizeof(cwd))} + "/zip_stream_extractor_test/";
+}
+
+FileUtils *fileUtils() {
+    if (!FileUtils::getInstance()) {
+        createFileUtils(); // registers itself
+    }
+    return FileUtils::getInstance();
+}
+
+bool hasContents(const ccstd::string &path, const ccstd::vector<uint8_t> &contents) {
+    FILE *fp = fopen(path.c_str(), "rb");
+    if (!fp) {
+        return false;
+    }
+    ccstd::vector<uint8_t> read(contents.size() + 1);
+    const size_t size = fread(read.data(), 1, read.size(), fp);
+    fclose(fp);
+    return size == contents.size() && std::equal(contents.begin(), contents.end(), read.begin());
+}
+
+// feeds the archive in pieces of varying sizes, like a download does
+bool feedInPieces(ZipStreamExtractor *extractor, const ccstd::vector<uint8_t> &archive, size_t end) {
+    const size_t pieceSizes[] = {1, 7, 29, 4096, 65536, 3};
+    size_t offset = 0;
+    for (size_t i = 0; offset < end; ++i) {
+        const size_t size = std::min(pieceSizes[i % 6], end - offset);
+        if (!extractor->feed(archive.data() + offset, static_cast<uint32_t>(size))) {
+            return false;
+        }
+        offset += size;
+    }
+    return true;
+}
+
+    #if (CC_PLATFORM == CC_PLATFORM_LINUX || CC_PLATFORM == CC_PLATFORM_MACOS)
+
+        #include <arpa/inet.h>
+        #include <netinet/in.h>
+        #include <poll.h>
+        #include <signal.h>
+        #include <sys/socket.h>
+
+/**
+ * Stands in for the hot update server on 127.0.0.1: answers one request with a recorded archive,
+ * sent in small pieces so that it's extracted while it arrives.
+ */
+class ArchiveServer {
+public:
+    explicit ArchiveServer(ccstd::vector<uint8_t> archive) : _archive(std::move(archive)) {
+        signal(SIGPIPE, SIG_IGN);
+        _listenFd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0;
+        bind(_listenFd, reinterpret_cast<sockaddr *>(&address), sizeof(address));
+        listen(_listenFd, 4);
+        socklen_t length = sizeof(address);
+        getsockname(_listenFd, reinterpret_cast<sockaddr *>(&address), &length);
+        _port = ntohs(address.sin_port);
+        _thread = std::thread(&ArchiveServer::serve, this);
+    }
+
+    ~ArchiveServer() {
+        _running = false;
+        _thread.join();
+        close(_listenFd);
+    }
+
+    ccstd::string url() const {
+        return "http://127.0.0.1:" + std::to_string(_port) + "/update.zip";
+    }
+
+private:
+    bool waitReadable(int fd) const {
+        pollfd pfd{fd, POLLIN, 0};
+        return poll(&pfd, 1, 20) > 0;
+    }
+
+    void serve() {
+        int fd = -1;
+        while (_running && fd < 0) {
+            if (waitReadable(_listenFd)) {
+                fd = accept(_listenFd, nullptr, nullptr);
+            }
+        }
+        if (fd < 0) {
+            return;
+        }
+
+        ccstd::string request;
+        char chunk[1024];
+        while (_running && request.find("\r\n\r\n") == ccstd::string::npos) {
+            if (!waitReadable(fd)) {
+                continue;
+            }
+            const auto count = recv(fd, chunk, sizeof(chunk), 0);
+            if (count <= 0) {
+                break;
+            }
+            request.append(chunk, count);
+        }
+
+        const ccstd::string header = "HTTP/1.1 200 OK\r\nContent-Length: " + std::to_string(_archive.size()) + "\r\nConnection: close\r\n\r\n";
+        ::send(fd, header.data(), header.size(), 0);
+        constexpr size_t PIECE_SIZE = 16 * 1024;
+        for (size_t sent = 0; _running && sent < _archive.size();) {
+            const auto count = ::send(fd, _archive.data() + sent, std::min(PIECE_SIZE, _archive.size() - sent), 0);
+            if (count <= 0) {
+                break;
+            }
+            sent += count;
+        }
+        close(fd);
+    }
+
+    ccstd::vector<uint8_t> _archive;
+    int _listenFd{-1};
+    uint16_t _port{0};
+    std::atomic<bool> _running{true};
+    std::thread _thread;
+};
+
+    #endif
+
+} // namespace
+
+TEST(ZipStreamExtractorTest, extractsWhileFed) {
+    const auto root = rootPath();
+    fileUtils()->removeDirectory(root);
+    const auto entries = makeEntries();
+    const auto archive = buildArchive(entries);
+    {
+        ZipStreamExtractor extractor(root);
+        EXPECT_TRUE(feedInPieces(&extractor, archive, archive.size()));
+        EXPECT_TRUE(extractor.finish());
+        EXPECT_FALSE(extractor.isFailed());
+        EXPECT_EQ(archive.size(), extractor.getBytesFed());
+        EXPECT_EQ(entries.size() - 1, extractor.getFileCount());
+
+        MD5 md5;
+        md5.update(archive.data(), archive.size());
+        EXPECT_EQ(md5.hexDigest(), extractor.getMD5());
+    }
+
+    EXPECT_TRUE(fileUtils()->isDirectoryExist(root + "assets/"));
+    for (const auto &entry : entries) {
+        if (entry.name.back() != '/') {
+            EXPECT_TRUE(hasContents(root + entry.name, entry.contents)) << entry.name;
+        }
+    }
+    fileUtils()->removeDirectory(root);
+}
+
+TEST(ZipStreamExtractorTest, rejectsBrokenArchives) {
+    const auto root = rootPath();
+    fileUtils()->removeDirectory(root);
+    const auto entries = makeEntries();
+    const auto archive = buildArchive(entries);
+
+    {
+        // cut inside an entry
+        ZipStreamExtractor extractor(root);
+        EXPECT_TRUE(feedInPieces(&extractor, archive, archive.size() / 2));
+        EXPECT_FALSE(extractor.finish());
+    }
+
+    for (const auto &name : {ccstd::string{"assets/small/3.json"}, ccstd::string{"assets/large_stored.bin"}, ccstd::string{"scripts/streamed.js"}}) {
+        // a flipped bit in the data of a buffered, a stored and a streamed entry
+        auto corrupted = archive;
+        const auto nameIt = std::search(corrupted.begin(), corrupted.end(), name.begin(), name.end());
+        ASSERT_NE(nameIt, corrupted.end());
+        *(nameIt + static_cast<std::ptrdiff_t>(name.size()) + 100) ^= 0x10;
+
+        ZipStreamExtractor extractor(root);
+        feedInPieces(&extractor, corrupted, corrupted.size());
+        EXPECT_FALSE(extractor.finish()) << name;
+    }
+
+    for (const auto &name : {ccstd::string{"../outside.txt"}, ccstd::string{"assets/../../outside.txt"}, ccstd::string{"/outside.txt"}}) {
+        const auto slip = buildArchive({{name, makeContents(100, 5, true), true, false}});
+        ZipStreamExtractor extractor(root);
+        EXPECT_FALSE(feedInPieces(&extractor, slip, slip.size()));
+        EXPECT_FALSE(extractor.finish());
+    }
+    EXPECT_FALSE(fileUtils()->isFileExist(root + "../outside.txt"));
+
+    {
+        auto garbage = makeContents(1000, 6, false);
+        ZipStreamExtractor extractor(root);
+        EXPECT_FALSE(extractor.feed(garbage.data(), static_cast<uint32_t>(garbage.size())));
+    }
+    fileUtils()->removeDirectory(root);
+}
+
+    #if (CC_PLATFORM == CC_PLATFORM_LINUX || CC_PLATFORM == CC_PLATFORM_MACOS)
+
+TEST(ZipStreamExtractorTest, extractsWhileDownloading) {
+    const auto root = rootPath();
+    fileUtils()->removeDirectory(root);
+    const auto entries = makeEntries();
+    const auto archive = buildArchive(entries);
+    ArchiveServer server(archive);
+
+    ZipStreamExtractor extractor(root);
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool finished = false;
+    bool succeed = false;
+    network::HttpSessionCURL session([&](network::HttpResponse *response) {
+        std::lock_guard<std::mutex> lock(mutex);
+        succeed = response->isSucceed();
+        finished = true;
+        response->getHttpRequest()->release();
+        response->release();
+        condition.notify_all();
+    });
+
+    auto *request = ccnew network::HttpRequest();
+    request->addRef();
+    request->setRequestType(network::HttpRequest::Type::GET);
+    request->setUrl(server.url());
+    request->setResponseSink([&extractor](const char *data, size_t size) {
+        return extractor.feed(reinterpret_cast<const uint8_t *>(data), static_cast<uint32_t>(size));
+    });
+    session.send(request, false);
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait_for(lock, std::chrono::seconds(20), [&]() { return finished; });
+    }
+
+    EXPECT_TRUE(succeed);
+    EXPECT_TRUE(extractor.finish());
+    MD5 md5;
+    md5.update(archive.data(), archive.size());
+    EXPECT_EQ(md5.hexDigest(), extractor.getMD5());
+    for (const auto &entry : entries) {
+        if (entry.name.back() != '/') {
+            EXPECT_TRUE(hasContents(root + entry.name, entry.contents)) << entry.name;
+        }
+    }
+    fileUtils()->removeDirectory(root);
+}
+
+    #endif
+
+#endif
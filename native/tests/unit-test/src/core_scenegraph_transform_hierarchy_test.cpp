@@ -0,0 +1,135 @@
+/****************************************************************************
+ Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "core/scene-graph/Scene.h"
+#include "core/scene-graph/TransformHierarchy.h"
+#include "gtest/gtest.h"
+
+using namespace cc;
+
+namespace {
+
+IntrusivePtr<Node> addNode(Node *parent, const Vec3 &position) {
+    IntrusivePtr<Node> node = new Node();
+    node->setPosition(position);
+    node->setActiveInHierarchy(true);
+    node->setParent(parent);
+    return node;
+}
+
+} // namespace
+
+TEST(TransformHierarchyTest, rebuildsOnlyForChangesInItsScene) {
+    IntrusivePtr<Scene> scene = new Scene("temp");
+    scene->load();
+    scene->setActiveInHierarchy(true);
+    auto &hierarchy = scene->getTransformHierarchy();
+    auto a = addNode(scene, Vec3(1, 0, 0));
+    auto b = addNode(a, Vec3(0, 1, 0));
+    auto c = addNode(scene, Vec3(0, 0, 1));
+    hierarchy.update();
+    EXPECT_FALSE(hierarchy.isOrderDirty());
+    EXPECT_EQ(hierarchy.size(), 4);
+
+    // a tree built outside the scene does not touch its order
+    IntrusivePtr<Node> detached = new Node();
+    auto detachedChild = addNode(detached, Vec3(0, 0, 2));
+    detachedChild->setSiblingIndex(0);
+    detached->removeAllChildren();
+    detachedChild->setParent(detached);
+    EXPECT_FALSE(hierarchy.isOrderDirty());
+
+    detached->setActiveInHierarchy(true);
+    detached->setParent(b);
+    EXPECT_TRUE(hierarchy.isOrderDirty());
+    hierarchy.update();
+    EXPECT_FALSE(hierarchy.isOrderDirty());
+    EXPECT_EQ(hierarchy.size(), 6);
+    EXPECT_TRUE(detachedChild->getWorldPosition().approxEquals(Vec3(1, 1, 2)));
+
+    c->setSiblingIndex(0);
+    EXPECT_TRUE(hierarchy.isOrderDirty());
+    hierarchy.update();
+
+    // reparenting within the scene moves the subtree along with its world transform
+    detached->setParent(c);
+    EXPECT_TRUE(hierarchy.isOrderDirty());
+    hierarchy.update();
+    EXPECT_FALSE(detachedChild->isTransformDirty());
+    EXPECT_TRUE(detachedChild->getWorldPosition().approxEquals(Vec3(0, 0, 3)));
+
+    detached->setParent(nullptr);
+    EXPECT_TRUE(hierarchy.isOrderDirty());
+    hierarchy.update();
+    EXPECT_EQ(hierarchy.size(), 4);
+
+    // the detached subtree no longer reports its transform changes to the scene
+    detachedChild->setPosition(Vec3(0, 0, 4));
+    hierarchy.update();
+    EXPECT_TRUE(detachedChild->isTransformDirty());
+}
+
+TEST(TransformHierarchyTest, sweepsDirtySubtrees) {
+    IntrusivePtr<Scene> scene = new Scene("temp");
+    scene->load();
+    scene->setActiveInHierarchy(true);
+    auto &hierarchy = scene->getTransformHierarchy();
+    auto a = addNode(scene, Vec3(1, 0, 0));
+    auto b = addNode(a, Vec3(0, 1, 0));
+    auto c = addNode(b, Vec3(0, 0, 1));
+    auto d = addNode(scene, Vec3(2, 0, 0));
+    hierarchy.update();
+    EXPECT_FALSE(c->isTransformDirty());
+    EXPECT_FALSE(d->isTransformDirty());
+
+    // nested dirty subtrees are swept once, from their outermost root
+    c->setPosition(Vec3(0, 0, 5));
+    a->setPosition(Vec3(3, 0, 0));
+    b->setScale(Vec3(2, 2, 2));
+    EXPECT_TRUE(c->isTransformDirty());
+    EXPECT_FALSE(hierarchy.isOrderDirty());
+    hierarchy.update();
+    EXPECT_FALSE(a->isTransformDirty());
+    EXPECT_FALSE(b->isTransformDirty());
+    EXPECT_FALSE(c->isTransformDirty());
+    EXPECT_TRUE(c->getWorldPosition().approxEquals(Vec3(3, 1, 10)));
+
+    // inactive subtrees are left to update lazily
+    d->setActiveInHierarchy(false);
+    d->setPosition(Vec3(4, 0, 0));
+    hierarchy.update();
+    EXPECT_TRUE(d->isTransformDirty());
+    EXPECT_TRUE(d->getWorldPosition().approxEquals(Vec3(4, 0, 0)));
+    EXPECT_FALSE(d->isTransformDirty());
+
+    // a node destroyed after it was marked dirty is never swept
+    auto e = addNode(a, Vec3(0, 0, 0));
+    hierarchy.update();
+    e->setPosition(Vec3(1, 1, 1));
+    e->setParent(nullptr);
+    e = nullptr;
+    hierarchy.update();
+    EXPECT_EQ(hierarchy.size(), 5);
+}
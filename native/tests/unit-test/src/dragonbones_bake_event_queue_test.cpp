@@ -0,0 +1,99 @@
+/****************************************************************************
+ Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include "dragonbones/core/BaseObject.h"
+#include "dragonbones/core/DragonBones.h"
+#include "dragonbones/event/EventObject.h"
+#include "gtest/gtest.h"
+
+using namespace dragonBones;
+
+// ArmatureCache gives its baked armature a private DragonBones instance, the bake thread drops
+// whatever that armature buffers and the main thread pools it later.
+
+TEST(DragonBonesBakeTest, discardBufferedPoolsWithoutDispatch) {
+    DragonBones bakeDragonBones(nullptr);
+    // dispatching would dereference the missing armature
+    auto *event = BaseObject::borrowObject<EventObject>();
+    auto *object = BaseObject::borrowObject<EventObject>();
+    bakeDragonBones.bufferEvent(event);
+    bakeDragonBones.bufferObject(object);
+
+    bakeDragonBones.discardBuffered();
+    EXPECT_TRUE(event->isInPool());
+    EXPECT_TRUE(object->isInPool());
+
+    // nothing is left for a second round
+    bakeDragonBones.discardBuffered();
+}
+
+TEST(DragonBonesBakeTest, objectsDiscardedOnWorkerArePooledByOwner) {
+    DragonBones bakeDragonBones(nullptr);
+    auto *event = BaseObject::borrowObject<EventObject>();
+    bakeDragonBones.bufferEvent(event);
+
+    std::vector<BaseObject *> deferredReturns;
+    std::thread worker([&]() {
+        BaseObject::setDeferredReturnList(&deferredReturns);
+        bakeDragonBones.discardBuffered();
+        BaseObject::setDeferredReturnList(nullptr);
+    });
+    worker.join();
+
+    ASSERT_EQ(deferredReturns.size(), 1);
+    EXPECT_EQ(deferredReturns[0], event);
+    EXPECT_FALSE(event->isInPool());
+
+    BaseObject::returnDeferredObjects(deferredReturns);
+    EXPECT_TRUE(deferredReturns.empty());
+    EXPECT_TRUE(event->isInPool());
+}
+
+TEST(DragonBonesBakeTest, hashCodesStayUniqueAcrossThreads) {
+    constexpr int THREAD_COUNT = 4;
+    constexpr int OBJECT_COUNT = 1000;
+    std::vector<std::vector<EventObject *>> objects(THREAD_COUNT);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREAD_COUNT; ++t) {
+        threads.emplace_back([&objects, t]() {
+            for (int i = 0; i < OBJECT_COUNT; ++i) {
+                objects[t].push_back(new EventObject());
+            }
+        });
+    }
+    for (auto &thread : threads) thread.join();
+
+    std::vector<unsigned> hashCodes;
+    for (auto &list : objects) {
+        for (auto *object : list) {
+            hashCodes.push_back(object->hashCode);
+            delete object;
+        }
+    }
+    std::sort(hashCodes.begin(), hashCodes.end());
+    EXPECT_EQ(std::unique(hashCodes.begin(), hashCodes.end()), hashCodes.end());
+}
@@ -0,0 +1,276 @@
+/****************************************************************************
+ Copyright (c) 2021-2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#include <cstring>
+#include <string>
+#include <vector>
+#include "dragonbones/parser/FlatDataWriter.h"
+#include "dragonbones/parser/JSONDataParser.h"
+#include "gtest/gtest.h"
+#include "utils.h"
+
+using namespace dragonBones;
+
+// Round trip of DragonBones data through FlatDataWriter and FlatDataParser, and the load time
+// of the flat data against the json it was converted from.
+
+namespace {
+
+constexpr int ARMATURE_COUNT = 4;
+constexpr int BONE_COUNT = 48;
+constexpr int ANIMATION_COUNT = 6;
+constexpr int FRAME_COUNT = 60;
+constexpr int BENCHMARK_ROUNDS = 10;
+constexpr float SCALE = 2.0F;
+
+std::string makeSkeletonJson() {
+    std::string json = R"({"name":"bench","version":"5.5","compatibleVersion":"5.5","frameRate":30,"armature":[)";
+    for (int a = 0; a < ARMATURE_COUNT; ++a) {
+        const auto armatureName = "armature" + std::to_string(a);
+        json += a > 0 ? "," : "";
+        json += R"({"type":"Armature","frameRate":30,"name":")" + armatureName + R"(","aabb":{"x":-100,"y":-200,"width":200,"height":400},)";
+
+        json += R"("bone":[{"name":"root"})";
+        for (int b = 1; b < BONE_COUNT; ++b) {
+            json += R"(,{"name":"bone)" + std::to_string(b) + R"(","parent":")" + (b == 1 ? std::string("root") : "bone" + std::to_string(b - 1)) +
+                    R"(","length":)" + std::to_string(10 + b) + R"(,"transform":{"x":)" + std::to_string(b) + R"(,"y":)" + std::to_string(-b) +
+                    R"(,"skX":)" + std::to_string(b % 90) + R"(,"skY":)" + std::to_string(b % 90) + R"(,"scX":1.5}})";
+        }
+        json += "],";
+
+        json += R"("slot":[)";
+        for (int s = 1; s < BONE_COUNT; ++s) {
+            json += s > 1 ? "," : "";
+            json += R"({"name":"slot)" + std::to_string(s) + R"(","parent":"bone)" + std::to_string(s) + R"(")" +
+                    (s % 3 == 0 ? R"(,"color":{"aM":50,"rO":10})" : "") + "}";
+        }
+        json += "],";
+
+        json += R"("skin":[{"name":"","slot":[)";
+        for (int s = 1; s < BONE_COUNT; ++s) {
+            json += s > 1 ? "," : "";
+            json += R"({"name":"slot)" + std::to_string(s) + R"(","display":[)";
+            if (s == 1) {
+                // A weighted quad bound to the first two bones.
+                json += R"({"type":"mesh","name":"mesh","width":20,"height":20,"vertices":[-10,-10,10,-10,10,10,-10,10],)"
+                        R"("uvs":[0,0,1,0,1,1,0,1],"triangles":[0,1,2,0,2,3],"weights":[1,0,1,1,1,1,2,0,0.5,1,0.5,1,0,1],)"
+                        R"("slotPose":[1,0,0,1,0,0],"bonePose":[0,1,0,0,1,0,0,1,1,0,0,1,1,0]})";
+            } else {
+                json += R"({"name":"image)" + std::to_string(s) + R"(","transform":{"x":2,"y":3},"pivot":{"x":0.5,"y":0.5}})";
+            }
+            json += "]}";
+        }
+        json += "]}],";
+
+        json += R"("animation":[)";
+        for (int n = 0; n < ANIMATION_COUNT; ++n) {
+            json += n > 0 ? "," : "";
+            json += R"({"name":"animation)" + std::to_string(n) + R"(","duration":)" + std::to_string(FRAME_COUNT) + R"(,"playTimes":0,"bone":[)";
+            for (int b = 1; b < BONE_COUNT; ++b) {
+                std::string translate;
+                std::string rotate;
+                for (int f = 0; f < FRAME_COUNT; ++f) {
+                    translate += f > 0 ? "," : "";
+                    translate += R"({"duration":1,"tweenEasing":0,"x":)" + std::to_string(f * b % 17) + R"(,"y":)" + std::to_string(f % 5) + "}";
+                    rotate += f > 0 ? "," : "";
+                    rotate += R"({"duration":1,"tweenEasing":0,"rotate":)" + std::to_string((f * 7 + b) % 360) + "}";
+                }
+                json += b > 1 ? "," : "";
+                json += R"({"name":"bone)" + std::to_string(b) + R"(","translateFrame":[)" + translate + R"(],"rotateFrame":[)" + rotate + "]}";
+            }
+            json += R"(],"slot":[{"name":"slot2","colorFrame":[{"duration":30,"tweenEasing":0,"value":{"aM":0}},{"duration":30,"value":{"aM":100}}]}]})";
+        }
+        json += "]}";
+    }
+    json += "]}";
+
+    return json;
+}
+
+void expectSameBone(const BoneData *expected, const BoneData *actual) {
+    ASSERT_NE(actual, nullptr);
+    EXPECT_EQ(expected->name, actual->name);
+    EXPECT_EQ(expected->parent != nullptr ? expected->parent->name : "", actual->parent != nullptr ? actual->parent->name : "");
+    EXPECT_FLOAT_EQ(expected->length, actual->length);
+    EXPECT_FLOAT_EQ(expected->transform.x, actual->transform.x);
+    EXPECT_FLOAT_EQ(expected->transform.y, actual->transform.y);
+    EXPECT_FLOAT_EQ(expected->transform.skew, actual->transform.skew);
+    EXPECT_FLOAT_EQ(expected->transform.rotation, actual->transform.rotation);
+    EXPECT_FLOAT_EQ(expected->transform.scaleX, actual->transform.scaleX);
+}
+
+void expectSameData(const DragonBonesData *expected, const DragonBonesData *actual) {
+    ASSERT_NE(actual, nullptr);
+    EXPECT_EQ(expected->name, actual->name);
+    EXPECT_EQ(expected->version, actual->version);
+    EXPECT_EQ(expected->frameRate, actual->frameRate);
+    EXPECT_EQ(expected->frameIndices, actual->frameIndices);
+
+    const void *expectedArrays[] = {expected->intArray, expected->floatArray, expected->frameIntArray, expected->frameFloatArray, expected->frameArray, expected->timelineArray};
+    const void *actualArrays[] = {actual->intArray, actual->floatArray, actual->frameIntArray, actual->frameFloatArray, actual->frameArray, actual->timelineArray};
+    for (int i = 0; i < 6; ++i) {
+        ASSERT_EQ(expected->arrayLengths[i], actual->arrayLengths[i]) << "array " << i;
+        EXPECT_EQ(0, memcmp(expectedArrays[i], actualArrays[i], expected->arrayLengths[i])) << "array " << i;
+    }
+
+    ASSERT_EQ(expected->armatureNames, actual->armatureNames);
+    for (const auto &armatureName : expected->armatureNames) {
+        const auto *expectedArmature = expected->getArmature(armatureName);
+        const auto *actualArmature = actual->getArmature(armatureName);
+        ASSERT_NE(actualArmature, nullptr);
+        EXPECT_FLOAT_EQ(expectedArmature->aabb.width, actualArmature->aabb.width);
+
+        ASSERT_EQ(expectedArmature->sortedBones.size(), actualArmature->sortedBones.size());
+        for (std::size_t i = 0; i < expectedArmature->sortedBones.size(); ++i) {
+            expectSameBone(expectedArmature->sortedBones[i], actualArmature->sortedBones[i]);
+        }
+
+        ASSERT_EQ(expectedArmature->sortedSlots.size(), actualArmature->sortedSlots.size());
+        for (std::size_t i = 0; i < expectedArmature->sortedSlots.size(); ++i) {
+            const auto *expectedSlot = expectedArmature->sortedSlots[i];
+            const auto *actualSlot = actualArmature->sortedSlots[i];
+            EXPECT_EQ(expectedSlot->name, actualSlot->name);
+            EXPECT_EQ(expectedSlot->parent->name, actualSlot->parent->name);
+            EXPECT_FLOAT_EQ(expectedSlot->color->alphaMultiplier, actualSlot->color->alphaMultiplier);
+            EXPECT_EQ(expectedSlot->color->redOffset, actualSlot->color->redOffset);
+        }
+
+        ASSERT_NE(actualArmature->defaultSkin, nullptr);
+        for (const auto &pair : expectedArmature->defaultSkin->displays) {
+            const auto *displays = actualArmature->defaultSkin->getDisplays(pair.first);
+            ASSERT_NE(displays, nullptr);
+            ASSERT_EQ(pair.second.size(), displays->size());
+            for (std::size_t i = 0; i < pair.second.size(); ++i) {
+                EXPECT_EQ(pair.second[i]->type, (*displays)[i]->type);
+                EXPECT_EQ(pair.second[i]->name, (*displays)[i]->name);
+                EXPECT_FLOAT_EQ(pair.second[i]->transform.x, (*displays)[i]->transform.x);
+                if (pair.second[i]->type == DisplayType::Mesh) {
+                    const auto &expectedVertices = static_cast<const MeshDisplayData *>(pair.second[i])->vertices;
+                    const auto &actualVertices = static_cast<const MeshDisplayData *>((*displays)[i])->vertices;
+                    EXPECT_EQ(expectedVertices.offset, actualVertices.offset);
+                    ASSERT_NE(actualVertices.weight, nullptr);
+                    EXPECT_EQ(expectedVertices.weight->offset, actualVertices.weight->offset);
+                    EXPECT_EQ(expectedVertices.weight->count, actualVertices.weight->count);
+                    ASSERT_EQ(expectedVertices.weight->bones.size(), actualVertices.weight->bones.size());
+                    for (std::size_t j = 0; j < expectedVertices.weight->bones.size(); ++j) {
+                        EXPECT_EQ(expectedVertices.weight->bones[j]->name, actualVertices.weight->bones[j]->name);
+                    }
+                }
+            }
+        }
+
+        ASSERT_EQ(expectedArmature->animationNames, actualArmature->animationNames);
+        ASSERT_NE(actualArmature->defaultAnimation, nullptr);
+        EXPECT_EQ(expectedArmature->defaultAnimation->name, actualArmature->defaultAnimation->name);
+        for (const auto &animationName : expectedArmature->animationNames) {
+            const auto *expectedAnimation = expectedArmature->getAnimation(animationName);
+            auto *actualAnimation = actualArmature->getAnimation(animationName);
+            ASSERT_NE(actualAnimation, nullptr);
+            EXPECT_EQ(expectedAnimation->frameCount, actualAnimation->frameCount);
+            EXPECT_EQ(expectedAnimation->frameOffset, actualAnimation->frameOffset);
+            EXPECT_FLOAT_EQ(expectedAnimation->duration, actualAnimation->duration);
+            ASSERT_EQ(expectedAnimation->boneTimelines.size(), actualAnimation->boneTimelines.size());
+            for (const auto &pair : expectedAnimation->boneTimelines) {
+                const auto *timelines = actualAnimation->getBoneTimelines(pair.first);
+                ASSERT_NE(timelines, nullptr);
+                ASSERT_EQ(pair.second.size(), timelines->size());
+                for (std::size_t i = 0; i < pair.second.size(); ++i) {
+                    EXPECT_EQ(pair.second[i]->type, (*timelines)[i]->type);
+                    EXPECT_EQ(pair.second[i]->offset, (*timelines)[i]->offset);
+                }
+            }
+            EXPECT_EQ(expectedAnimation->slotTimelines.size(), actualAnimation->slotTimelines.size());
+        }
+    }
+}
+
+DragonBonesData *parseFlat(FlatDataParser &parser, const std::vector<char> &flatData, float scale) {
+    auto *data = parser.parseDragonBonesData(flatData.data(), scale);
+    if (data != nullptr) {
+        // Read in place, the buffer belongs to the test.
+        data->releaseBinary = []() {};
+    }
+    return data;
+}
+
+} // namespace
+
+TEST(DragonBonesFlatDataTest, roundTripMatchesJson) {
+    const auto json = makeSkeletonJson();
+    JSONDataParser jsonParser;
+    auto *expected = jsonParser.parseDragonBonesData(json.c_str(), SCALE);
+    ASSERT_NE(expected, nullptr);
+
+    std::vector<char> flatData;
+    FlatDataWriter writer;
+    writer.write(*expected, flatData);
+    ASSERT_TRUE(FlatDataParser::isFlatData(flatData.data()));
+
+    FlatDataParser flatParser;
+    auto *actual = parseFlat(flatParser, flatData, SCALE);
+    expectSameData(expected, actual);
+
+    // Positions are stored at scale 1, so other scales load from the same file.
+    auto *unscaled = parseFlat(flatParser, flatData, 1.0F);
+    ASSERT_NE(unscaled, nullptr);
+    const auto *bone = unscaled->getArmature("armature0")->getBone("bone3");
+    EXPECT_FLOAT_EQ(3.0F, bone->transform.x);
+    EXPECT_FLOAT_EQ(13.0F, bone->length);
+
+    expected->returnToPool();
+    if (actual != nullptr) {
+        actual->returnToPool();
+    }
+    unscaled->returnToPool();
+}
+
+TEST(DragonBonesFlatDataBenchmark, DISABLED_loadTime) {
+    const auto json = makeSkeletonJson();
+    JSONDataParser jsonParser;
+    FlatDataParser flatParser;
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<char> flatData;
+    for (int i = 0; i < BENCHMARK_ROUNDS; ++i) {
+        auto *data = jsonParser.parseDragonBonesData(json.c_str());
+        ASSERT_NE(data, nullptr);
+        if (flatData.empty()) {
+            FlatDataWriter writer;
+            writer.write(*data, flatData);
+        }
+        data->returnToPool();
+    }
+    const auto jsonMs = elapsedMs(start) / BENCHMARK_ROUNDS;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCHMARK_ROUNDS; ++i) {
+        auto *data = parseFlat(flatParser, flatData, 1.0F);
+        ASSERT_NE(data, nullptr);
+        data->returnToPool();
+    }
+    const auto flatMs = elapsedMs(start) / BENCHMARK_ROUNDS;
+
+    reportBenchmark("dragonbones json: %zu bytes, %.3f ms per load", json.size(), jsonMs);
+    reportBenchmark("dragonbones flat: %zu bytes, %.3f ms per load (%.1fx)", flatData.size(), flatMs, jsonMs / flatMs);
+}
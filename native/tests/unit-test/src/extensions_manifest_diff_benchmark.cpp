@@ -0,0 +1,308 @@
+/****************************************************************************
+ Copyright (c) 2021-2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "cocos/platform/FileUtils.h"
+#include "extensions/assets-manager/Manifest.h"
+#include "gtest/gtest.h"
+#include "utils.h"
+
+using namespace cc;
+using namespace cc::extension;
+
+// Diff of manifests merged from their sorted assets against the lookup of every asset in the other
+// manifest, and the load time of the binary manifest cache against the json it was written from.
+
+// the binary cache is written through FileUtils
+#if (CC_PLATFORM != CC_PLATFORM_WINDOWS)
+
+    #include <unistd.h>
+
+namespace {
+
+constexpr int BENCHMARK_ROUNDS = 3;
+constexpr int BENCHMARK_SIZES[] = {1000, 10000, 50000, 200000};
+
+class TestManifest : public Manifest {
+public:
+    using Manifest::genDiff;
+    using Manifest::getAssets;
+    using Manifest::getGroupVerions;
+    using Manifest::getGroups;
+    using Manifest::saveToBinaryFile;
+    using Manifest::saveToFile;
+    using Manifest::setAssetDownloadState;
+};
+
+FileUtils *fileUtils() {
+    if (!FileUtils::getInstance()) {
+        createFileUtils(); // registers itself
+    }
+    return FileUtils::getInstance();
+}
+
+std::string rootPath() {
+    char cwd[4096];
+    return std::string{getcwd(cwd, sizeof(cwd))} + "/manifest_diff_benchmark/";
+}
+
+std::string md5Of(uint32_t value) {
+    char md5[33];
+    snprintf(md5, sizeof(md5), "%08x%08x%08x%08x", value, value * 31U, value ^ 0x5bd1e995U, value + 7U);
+    return md5;
+}
+
+// Assets keyed out of order, every 10th one deleted, every 7th one modified and count / 20 added in the remote version
+std::string makeManifestJson(int count, bool remote) {
+    std::string json = R"({"packageUrl":"http://localhost/remote-assets/","remoteManifestUrl":"http://localhost/project.manifest",)";
+    json += R"("remoteVersionUrl":"http://localhost/version.manifest","version":")";
+    json += remote ? "1.0.1" : "1.0.0";
+    json += R"(","engineVersion":"3.8.0","groupVersions":{"1":"1.0.0","2":"1.0.1"},"searchPaths":["patch/","res/"],"assets":{)";
+    const int total = remote ? count + count / 20 : count;
+    bool first = true;
+    for (int i = 0; i < total; ++i) {
+        if (remote && i < count && i % 10 == 0) {
+            continue;
+        }
+        char key[64];
+        snprintf(key, sizeof(key), "assets/main/%08x/%d.png", static_cast<uint32_t>(i) * 2654435761U, i);
+        const bool modified = remote && i % 7 == 0;
+        json += first ? "\"" : ",\"";
+        first = false;
+        json += key;
+        json += R"(":{"size":)" + std::to_string(1024 + i) + R"(,"md5":")" + md5Of(modified ? i + 1000000U : i) + "\"";
+        if (i % 50 == 0) {
+            json += R"(,"compressed":true)";
+        }
+        if (i % 13 == 0) {
+            json += std::string(R"(,"path":"renamed/)") + key + "\"";
+        }
+        if (i % 3 == 0) {
+            json += R"(,"downloadState":2)";
+        }
+        json += "}";
+    }
+    json += "}}";
+    return json;
+}
+
+// The lookup of every asset in the other manifest, as the diff was generated before it merged sorted assets
+std::unordered_map<std::string, Manifest::AssetDiff> lookupDiff(const TestManifest &a, const TestManifest &b) {
+    std::unordered_map<std::string, Manifest::AssetDiff> diffMap;
+    const auto &assetsA = a.getAssets();
+    const auto &assetsB = b.getAssets();
+    for (const auto &it : assetsA) {
+        auto found = assetsB.find(it.first);
+        if (found == assetsB.end()) {
+            diffMap.emplace(it.first, Manifest::AssetDiff{it.second, Manifest::DiffType::DELETED});
+        } else if (found->second.md5 != it.second.md5) {
+            diffMap.emplace(it.first, Manifest::AssetDiff{found->second, Manifest::DiffType::MODIFIED});
+        }
+    }
+    for (const auto &it : assetsB) {
+        if (assetsA.find(it.first) == assetsA.end()) {
+            diffMap.emplace(it.first, Manifest::AssetDiff{it.second, Manifest::DiffType::ADDED});
+        }
+    }
+    return diffMap;
+}
+
+void expectSameAsset(const Manifest::Asset &expected, const Manifest::Asset &actual) {
+    EXPECT_EQ(expected.md5, actual.md5);
+    EXPECT_EQ(expected.path, actual.path);
+    EXPECT_EQ(expected.compressed, actual.compressed);
+    EXPECT_FLOAT_EQ(expected.size, actual.size);
+    EXPECT_EQ(expected.downloadState, actual.downloadState);
+}
+
+void expectSameDiff(const std::unordered_map<std::string, Manifest::AssetDiff> &expected, const std::unordered_map<std::string, Manifest::AssetDiff> &actual) {
+    ASSERT_EQ(expected.size(), actual.size());
+    for (const auto &it : expected) {
+        auto found = actual.find(it.first);
+        ASSERT_NE(found, actual.end()) << it.first;
+        EXPECT_EQ(it.second.type, found->second.type) << it.first;
+        expectSameAsset(it.second.asset, found->second.asset);
+    }
+}
+
+} // namespace
+
+TEST(ManifestDiffTest, mergedDiffMatchesLookup) {
+    fileUtils();
+    // the larger manifests are merged in parallel key ranges
+    for (int count : {0, 1, 2000, 40000}) {
+        TestManifest local;
+        local.parseJSONString(makeManifestJson(count, false), rootPath());
+        TestManifest remote;
+        remote.parseJSONString(makeManifestJson(count, true), rootPath());
+        ASSERT_TRUE(local.isLoaded());
+        ASSERT_TRUE(remote.isLoaded());
+
+        expectSameDiff(lookupDiff(local, remote), local.genDiff(&remote));
+        expectSameDiff(lookupDiff(remote, local), remote.genDiff(&local));
+        EXPECT_TRUE(local.genDiff(&local).empty());
+    }
+}
+
+TEST(ManifestDiffTest, binaryCacheRoundTrip) {
+    auto *fs = fileUtils();
+    fs->createDirectory(rootPath());
+    const std::string jsonPath = rootPath() + "project.manifest";
+    const std::string binaryPath = jsonPath + ".bin";
+    const std::string json = makeManifestJson(3000, true);
+    ASSERT_TRUE(fs->writeStringToFile(json, jsonPath));
+
+    TestManifest expected;
+    expected.parseJSONString(json, rootPath());
+    ASSERT_TRUE(expected.saveToBinaryFile(binaryPath, jsonPath));
+
+    TestManifest actual;
+    ASSERT_TRUE(actual.parseBinaryFile(binaryPath, jsonPath));
+    EXPECT_TRUE(actual.isLoaded());
+    EXPECT_TRUE(actual.isVersionLoaded());
+    EXPECT_EQ(expected.getVersion(), actual.getVersion());
+    EXPECT_EQ(expected.getPackageUrl(), actual.getPackageUrl());
+    EXPECT_EQ(expected.getManifestFileUrl(), actual.getManifestFileUrl());
+    EXPECT_EQ(expected.getVersionFileUrl(), actual.getVersionFileUrl());
+    EXPECT_EQ(expected.getGroups(), actual.getGroups());
+    EXPECT_EQ(expected.getGroupVerions(), actual.getGroupVerions());
+    EXPECT_EQ(expected.getSearchPaths(), actual.getSearchPaths());
+    ASSERT_EQ(expected.getAssets().size(), actual.getAssets().size());
+    for (const auto &it : expected.getAssets()) {
+        auto found = actual.getAssets().find(it.first);
+        ASSERT_NE(found, actual.getAssets().end()) << it.first;
+        expectSameAsset(it.second, found->second);
+    }
+    EXPECT_TRUE(actual.genDiff(&expected).empty());
+
+    // a cache written from another json, even one of the same size written within the
+    // same second, or a cache cut short is not loaded
+    std::string edited = json;
+    edited[edited.find("\"version\"") + 11] ^= 1; // 1.0.1 becomes 0.0.1
+    ASSERT_TRUE(fs->writeStringToFile(edited, jsonPath));
+    TestManifest stale;
+    EXPECT_FALSE(stale.parseBinaryFile(binaryPath, jsonPath));
+    EXPECT_FALSE(stale.isLoaded());
+    TestManifest missing;
+    EXPECT_FALSE(missing.parseBinaryFile(binaryPath, rootPath() + "missing.manifest"));
+    ASSERT_TRUE(fs->writeStringToFile(json, jsonPath));
+    ASSERT_TRUE(expected.saveToBinaryFile(binaryPath, jsonPath));
+    std::string binary = fs->getStringFromFile(binaryPath);
+    fs->writeStringToFile(binary.substr(0, binary.size() / 2), binaryPath);
+    TestManifest truncated;
+    EXPECT_FALSE(truncated.parseBinaryFile(binaryPath, jsonPath));
+    EXPECT_FALSE(truncated.isLoaded());
+    EXPECT_TRUE(truncated.getAssets().empty());
+
+    fs->removeDirectory(rootPath());
+}
+
+TEST(ManifestDiffTest, downloadStateIsSavedToJson) {
+    auto *fs = fileUtils();
+    fs->createDirectory(rootPath());
+    const std::string path = rootPath() + "project.manifest";
+
+    TestManifest manifest;
+    manifest.parseJSONString(makeManifestJson(500, false), rootPath());
+    std::vector<std::string> keys;
+    for (const auto &it : manifest.getAssets()) {
+        keys.push_back(it.first);
+    }
+    for (size_t i = 0; i < keys.size(); ++i) {
+        manifest.setAssetDownloadState(keys[i], i % 2 == 0 ? Manifest::DownloadState::SUCCESSED : Manifest::DownloadState::DOWNLOADING);
+    }
+    manifest.saveToFile(path);
+
+    TestManifest saved;
+    saved.parseFile(path);
+    ASSERT_TRUE(saved.isLoaded());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        const auto &asset = saved.getAssets().at(keys[i]);
+        EXPECT_EQ(i % 2 == 0 ? Manifest::DownloadState::SUCCESSED : Manifest::DownloadState::DOWNLOADING, asset.downloadState) << keys[i];
+        expectSameAsset(manifest.getAssets().at(keys[i]), asset);
+    }
+
+    fs->removeDirectory(rootPath());
+}
+
+TEST(ManifestDiffBenchmark, DISABLED_loadAndDiffTime) {
+    auto *fs = fileUtils();
+    fs->createDirectory(rootPath());
+    const std::string jsonPath = rootPath() + "project.manifest";
+    const std::string binaryPath = jsonPath + ".bin";
+
+    for (int count : BENCHMARK_SIZES) {
+        const std::string localJson = makeManifestJson(count, false);
+        const std::string remoteJson = makeManifestJson(count, true);
+        ASSERT_TRUE(fs->writeStringToFile(localJson, jsonPath));
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < BENCHMARK_ROUNDS; ++i) {
+            TestManifest manifest;
+            manifest.parseJSONString(localJson, rootPath());
+            if (i == 0) {
+                ASSERT_TRUE(manifest.saveToBinaryFile(binaryPath, jsonPath));
+            }
+        }
+        const auto jsonMs = elapsedMs(start) / BENCHMARK_ROUNDS;
+
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < BENCHMARK_ROUNDS; ++i) {
+            TestManifest manifest;
+            ASSERT_TRUE(manifest.parseBinaryFile(binaryPath, jsonPath));
+        }
+        const auto binaryMs = elapsedMs(start) / BENCHMARK_ROUNDS;
+
+        TestManifest local;
+        local.parseJSONString(localJson, rootPath());
+        TestManifest remote;
+        remote.parseJSONString(remoteJson, rootPath());
+
+        start = std::chrono::steady_clock::now();
+        size_t lookupCount = 0;
+        for (int i = 0; i < BENCHMARK_ROUNDS; ++i) {
+            lookupCount = lookupDiff(local, remote).size();
+        }
+        const auto lookupMs = elapsedMs(start) / BENCHMARK_ROUNDS;
+
+        start = std::chrono::steady_clock::now();
+        size_t mergeCount = 0;
+        for (int i = 0; i < BENCHMARK_ROUNDS; ++i) {
+            mergeCount = local.genDiff(&remote).size();
+        }
+        const auto mergeMs = elapsedMs(start) / BENCHMARK_ROUNDS;
+        EXPECT_EQ(lookupCount, mergeCount);
+
+        reportBenchmark("manifest of %d assets: json %zu bytes, %.3f ms per load, binary cache %.3f ms per load (%.1fx)",
+                        count, localJson.size(), jsonMs, binaryMs, jsonMs / binaryMs);
+        reportBenchmark("manifest of %d assets: %zu differences, lookup diff %.3f ms, merged diff %.3f ms (%.1fx)",
+                        count, mergeCount, lookupMs, mergeMs, lookupMs / mergeMs);
+    }
+
+    fs->removeDirectory(rootPath());
+}
+
+#endif
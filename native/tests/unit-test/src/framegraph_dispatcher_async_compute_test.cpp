@@ -0,0 +1,157 @@
+/****************************************************************************
+Copyright (c) 2023 Xiamen Yaji Software Co., Ltd.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "cocos/renderer/pipeline/custom/FGDispatcherGraphs.h"
+#include "cocos/renderer/pipeline/custom/test/test.h"
+#include "gfx-base/GFXDef-common.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+const cc::render::ScheduledPass *findPass(const cc::render::PassSchedule &schedule, cc::render::RenderGraph::vertex_descriptor passID) {
+    for (const auto &pass : schedule.passes) {
+        if (pass.passID == passID) {
+            return &pass;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+TEST(fgDispatcherAsyncCompute, postProcessChain) {
+    // pass0: compute, everything depends on it, stays on graphics queue
+    // pass1: raster, writes "0"
+    // pass2, pass3: compute chain on "0", overlaps pass4 and pass5
+    // pass4, pass5: raster chain
+    // pass6: raster, composes "2" and "4" into backbuffer
+    TEST_CASE_5;
+
+    boost::container::pmr::memory_resource* resource = boost::container::pmr::get_default_resource();
+    RenderGraph renderGraph(resource);
+    ResourceGraph rescGraph(resource);
+    LayoutGraphData layoutGraphData(resource);
+
+    fillTestGraph(rasterData, resources, layoutInfo, renderGraph, rescGraph, layoutGraphData);
+
+    FrameGraphDispatcher fgDispatcher(rescGraph, renderGraph, layoutGraphData, resource, resource);
+    fgDispatcher.enableAsyncCompute(true);
+    fgDispatcher.run();
+
+    const auto& schedule = fgDispatcher.getSchedule();
+    ASSERT_EQ(schedule.passes.size(), 7);
+
+    const cc::gfx::QueueType expectedQueues[] = {
+        cc::gfx::QueueType::GRAPHICS,
+        cc::gfx::QueueType::GRAPHICS,
+        cc::gfx::QueueType::COMPUTE,
+        cc::gfx::QueueType::COMPUTE,
+        cc::gfx::QueueType::GRAPHICS,
+        cc::gfx::QueueType::GRAPHICS,
+        cc::gfx::QueueType::GRAPHICS,
+    };
+    const uint32_t expectedQueueIndices[] = {0, 1, 0, 1, 2, 3, 4};
+    const uint32_t expectedLevels[] = {0, 1, 2, 3, 1, 2, 4};
+    for (uint32_t passID = 0; passID < 7; ++passID) {
+        const auto* pass = findPass(schedule, passID);
+        ASSERT_NE(pass, nullptr);
+        EXPECT_EQ(pass->queue, expectedQueues[passID]);
+        EXPECT_EQ(pass->queueIndex, expectedQueueIndices[passID]);
+        EXPECT_EQ(pass->level, expectedLevels[passID]);
+    }
+
+    // pass2 waits for pass1 on graphics queue, pass6 waits for pass3 on compute queue,
+    // compute queue is joined by pass6 so nothing left for the end of frame.
+    ASSERT_EQ(schedule.syncs.size(), 2);
+    const auto& computeWait = schedule.syncs[0];
+    EXPECT_EQ(computeWait.signalQueue, cc::gfx::QueueType::GRAPHICS);
+    EXPECT_EQ(computeWait.waitQueue, cc::gfx::QueueType::COMPUTE);
+    EXPECT_EQ(computeWait.signalPass, 1);
+    EXPECT_EQ(computeWait.waitPass, 2);
+    EXPECT_EQ(computeWait.fenceValue, 2);
+    const auto& graphicsWait = schedule.syncs[1];
+    EXPECT_EQ(graphicsWait.signalQueue, cc::gfx::QueueType::COMPUTE);
+    EXPECT_EQ(graphicsWait.waitQueue, cc::gfx::QueueType::GRAPHICS);
+    EXPECT_EQ(graphicsWait.signalPass, 3);
+    EXPECT_EQ(graphicsWait.waitPass, 6);
+    EXPECT_EQ(graphicsWait.fenceValue, 2);
+
+    // "0" moves from graphics to compute, "2" from compute to graphics
+    ASSERT_EQ(schedule.queueTransfers.size(), 2);
+    for (const auto& transfer : schedule.queueTransfers) {
+        const auto& name = get(ResourceGraph::NameTag{}, rescGraph, transfer.resourceID);
+        if (name == "0") {
+            EXPECT_EQ(transfer.beginVert, 1);
+            EXPECT_EQ(transfer.endVert, 2);
+        } else {
+            EXPECT_EQ(name, "2");
+            EXPECT_EQ(transfer.beginVert, 3);
+            EXPECT_EQ(transfer.endVert, 6);
+        }
+    }
+}
+
+TEST(fgDispatcherAsyncCompute, disabledByDefault) {
+    TEST_CASE_5;
+
+    boost::container::pmr::memory_resource* resource = boost::container::pmr::get_default_resource();
+    RenderGraph renderGraph(resource);
+    ResourceGraph rescGraph(resource);
+    LayoutGraphData layoutGraphData(resource);
+
+    fillTestGraph(rasterData, resources, layoutInfo, renderGraph, rescGraph, layoutGraphData);
+
+    FrameGraphDispatcher fgDispatcher(rescGraph, renderGraph, layoutGraphData, resource, resource);
+    fgDispatcher.run();
+
+    const auto& schedule = fgDispatcher.getSchedule();
+    EXPECT_TRUE(schedule.passes.empty());
+    EXPECT_TRUE(schedule.syncs.empty());
+    EXPECT_TRUE(schedule.queueTransfers.empty());
+}
+
+TEST(fgDispatcherAsyncCompute, clearedOnceDisabled) {
+    TEST_CASE_5;
+
+    boost::container::pmr::memory_resource* resource = boost::container::pmr::get_default_resource();
+    RenderGraph renderGraph(resource);
+    ResourceGraph rescGraph(resource);
+    LayoutGraphData layoutGraphData(resource);
+
+    fillTestGraph(rasterData, resources, layoutInfo, renderGraph, rescGraph, layoutGraphData);
+
+    FrameGraphDispatcher fgDispatcher(rescGraph, renderGraph, layoutGraphData, resource, resource);
+    fgDispatcher.enableAsyncCompute(true);
+    fgDispatcher.run();
+    ASSERT_FALSE(fgDispatcher.getSchedule().passes.empty());
+
+    // the next run must not hand out the schedule of the previous one
+    fgDispatcher.enableAsyncCompute(false);
+    fgDispatcher.run();
+
+    const auto& schedule = fgDispatcher.getSchedule();
+    EXPECT_TRUE(schedule.passes.empty());
+    EXPECT_TRUE(schedule.syncs.empty());
+    EXPECT_TRUE(schedule.queueTransfers.empty());
+}
@@ -0,0 +1,105 @@
+/****************************************************************************
+ Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#include "gfx-base/GFXCommandBuffer.h"
+#include "gfx-base/GFXQueue.h"
+#include "gtest/gtest.h"
+#include "renderer/GFXDeviceManager.h"
+#include "renderer/pipeline/ParallelCommandRecorder.h"
+#include "utils.h"
+
+using namespace cc;
+
+// Main thread cost of recording a large render queue sequentially and through
+// ParallelCommandRecorder, on the empty backend directly and behind the agent.
+
+namespace {
+
+constexpr uint32_t DRAW_COUNT = 1U << 15U;
+constexpr uint32_t CHUNK_SIZE = 1024U;
+constexpr uint32_t FRAME_COUNT = 8U;
+
+void recordDraws(gfx::CommandBuffer *cmdBuffer, uint32_t begin, uint32_t end) {
+    gfx::Rect scissor{0, 0, 64U, 64U};
+    gfx::DrawInfo drawInfo;
+    drawInfo.vertexCount = 3U;
+    for (uint32_t i = begin; i < end; ++i) {
+        scissor.x = static_cast<int32_t>(i & 63U);
+        drawInfo.firstVertex = i * 3U;
+        cmdBuffer->setScissor(scissor);
+        cmdBuffer->draw(drawInfo);
+    }
+}
+
+double recordFrames(gfx::Device *device, pipeline::ParallelCommandRecorder *recorder, bool withAgent) {
+    gfx::CommandBuffer *cmdBuffer = device->getCommandBuffer();
+
+    double totalMs = 0.0;
+    for (uint32_t frame = 0U; frame < FRAME_COUNT; ++frame) {
+        cmdBuffer->begin();
+
+        totalMs += measureMs([&]() {
+            if (recorder) {
+                recorder->record(cmdBuffer, nullptr, 0U, DRAW_COUNT, CHUNK_SIZE, recordDraws);
+            } else {
+                recordDraws(cmdBuffer, 0U, DRAW_COUNT);
+            }
+        });
+
+        cmdBuffer->end();
+        if (recorder) recorder->flush();
+        device->flushCommands(&cmdBuffer, 1U);
+        device->getQueue()->submit(&cmdBuffer, 1U);
+        if (withAgent) device->present();
+    }
+    return totalMs / FRAME_COUNT;
+}
+
+void runBackend(char const *name, bool withAgent) {
+    // a device of its own, the one of the test runner is current again once it is destroyed
+    gfx::Device *device = gfx::DeviceManager::createHeadless(gfx::DeviceInfo{}, withAgent);
+    ASSERT_NE(device, nullptr);
+
+    double const sequentialMs = recordFrames(device, nullptr, withAgent);
+
+    auto *recorder = ccnew pipeline::ParallelCommandRecorder(device);
+    EXPECT_TRUE(pipeline::ParallelCommandRecorder::isSupported(device));
+    double const parallelMs = recordFrames(device, recorder, withAgent);
+    CC_SAFE_DESTROY_AND_DELETE(recorder);
+
+    reportBenchmark("%-12s draws: %u, sequential %8.3f ms, parallel (chunk %u) %8.3f ms",
+                    name, DRAW_COUNT, sequentialMs, CHUNK_SIZE, parallelMs);
+
+    gfx::DeviceManager::destroyHeadless(device);
+}
+
+} // namespace
+
+TEST(ParallelRecordingBenchmark, DISABLED_emptyBackend) {
+    runBackend("gfx-empty", false);
+}
+
+TEST(ParallelRecordingBenchmark, DISABLED_agentBackend) {
+    runBackend("gfx-agent", true);
+}
@@ -0,0 +1,117 @@
+/****************************************************************************
+ Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#include <atomic>
+#include <vector>
+#include "base/job-system/JobSystem.h"
+#include "gtest/gtest.h"
+
+using namespace cc;
+
+TEST(JobSystemTest, forEachIndexVisitsEveryIndexOnce) {
+    constexpr uint32_t COUNT = 10000U;
+    std::vector<std::atomic<uint32_t>> visits(COUNT);
+
+    JobGraph g(JobSystem::getInstance());
+    g.createForEachIndexJob(0U, COUNT, 1U, [&visits](uint32_t i) {
+        visits[i].fetch_add(1U);
+    });
+    g.run();
+    g.waitForAll();
+
+    for (auto &visit : visits) {
+        EXPECT_EQ(visit.load(), 1U);
+    }
+}
+
+TEST(JobSystemTest, forEachIndexRespectsStep) {
+    std::atomic<uint32_t> sum{0U};
+
+    JobGraph g(JobSystem::getInstance());
+    g.createForEachIndexJob(3U, 100U, 7U, [&sum](uint32_t i) {
+        EXPECT_EQ((i - 3U) % 7U, 0U);
+        sum.fetch_add(i);
+    });
+    g.run();
+    g.waitForAll();
+
+    uint32_t expected = 0U;
+    for (uint32_t i = 3U; i < 100U; i += 7U) expected += i;
+    EXPECT_EQ(sum.load(), expected);
+}
+
+TEST(JobSystemTest, edgesOrderJobs) {
+    std::atomic<uint32_t> stage{0U};
+    std::atomic<uint32_t> forEachDone{0U};
+    std::atomic<bool> orderKept{true};
+
+    JobGraph g(JobSystem::getInstance());
+    auto first = g.createJob([&]() {
+        stage.store(1U);
+    });
+    auto middle = g.createForEachIndexJob(0U, 256U, 1U, [&](uint32_t /*i*/) {
+        if (stage.load() != 1U) orderKept.store(false);
+        forEachDone.fetch_add(1U);
+    });
+    auto last = g.createJob([&]() {
+        if (forEachDone.load() != 256U) orderKept.store(false);
+        stage.store(2U);
+    });
+    g.makeEdge(first, middle);
+    g.makeEdge(middle, last);
+    g.run();
+    g.waitForAll();
+
+    EXPECT_TRUE(orderKept.load());
+    EXPECT_EQ(stage.load(), 2U);
+}
+
+TEST(JobSystemTest, diamondDependencies) {
+    std::vector<uint32_t> results(4U, 0U);
+
+    JobGraph g(JobSystem::getInstance());
+    auto a = g.createJob([&]() { results[0] = 1U; });
+    auto b = g.createJob([&]() { results[1] = results[0] + 1U; });
+    auto c = g.createJob([&]() { results[2] = results[0] + 2U; });
+    auto d = g.createJob([&]() { results[3] = results[1] + results[2]; });
+    g.makeEdge(a, b);
+    g.makeEdge(a, c);
+    g.makeEdge(b, d);
+    g.makeEdge(c, d);
+    g.run();
+    g.waitForAll();
+
+    EXPECT_EQ(results[3], 5U);
+}
+
+TEST(JobSystemTest, emptyRange) {
+    std::atomic<bool> called{false};
+
+    JobGraph g(JobSystem::getInstance());
+    g.createForEachIndexJob(5U, 5U, 1U, [&called](uint32_t /*i*/) { called.store(true); });
+    g.run();
+    g.waitForAll();
+
+    EXPECT_FALSE(called.load());
+}
@@ -0,0 +1,134 @@
+/****************************************************************************
+ Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "base/threading/MessageQueue.h"
+#include "base/threading/MultiProducerMessageQueue.h"
+#include "gtest/gtest.h"
+#include "utils.h"
+
+using namespace cc;
+
+// Throughput of the single-producer MessageQueue against MultiProducerMessageQueue.
+// The single-producer queue needs a lock to be shared by several threads,
+// which is what the agents would have to do without the multi-producer variant.
+
+namespace {
+
+constexpr uint32_t MESSAGE_COUNT = 1U << 18U;
+constexpr uint32_t MESSAGES_PER_KICK = 256U;
+constexpr uint32_t PAYLOAD_SIZE = 8U;
+
+// the enqueue macros can't be used with a dependent queue type, so stamp out an overload per queue
+#define DEFINE_ENQUEUE_WORK(QueueType)                                                   \
+    void enqueueWork(QueueType *queue, uint64_t *sum, uint32_t count) {                  \
+        for (uint32_t i = 0U; i < count; ++i) {                                          \
+            auto *payload = queue->allocate<uint32_t>(PAYLOAD_SIZE);                     \
+            for (uint32_t j = 0U; j < PAYLOAD_SIZE; ++j) payload[j] = i;                 \
+                                                                                         \
+            ENQUEUE_MESSAGE_2(                                                           \
+                queue, AccumulatePayload,                                                \
+                sum, sum,                                                                \
+                payload, payload,                                                        \
+                {                                                                        \
+                    for (uint32_t j = 0U; j < PAYLOAD_SIZE; ++j) *sum += payload[j];     \
+                });                                                                      \
+                                                                                         \
+            if (i % MESSAGES_PER_KICK == MESSAGES_PER_KICK - 1U) queue->kick();          \
+        }                                                                                \
+    }
+
+DEFINE_ENQUEUE_WORK(MessageQueue)
+DEFINE_ENQUEUE_WORK(MultiProducerMessageQueue)
+
+#undef DEFINE_ENQUEUE_WORK
+
+void report(char const *name, uint32_t producers, double ms) {
+    reportBenchmark("%-40s producers: %u, %8.2f ms, %8.2f M msg/s",
+                    name, producers, ms, static_cast<double>(MESSAGE_COUNT) / ms / 1000.0);
+}
+
+double runSingleProducer(uint32_t producerCount) {
+    MessageQueue queue;
+    queue.setImmediateMode(false);
+    queue.runConsumerThread();
+
+    std::mutex mutex;
+    uint64_t sum{0U};
+    uint32_t const countPerProducer = MESSAGE_COUNT / producerCount;
+    double const ms = measureMs([&]() {
+        std::vector<std::thread> threads;
+        for (uint32_t p = 0U; p < producerCount; ++p) {
+            threads.emplace_back([&]() {
+                for (uint32_t i = 0U; i < countPerProducer; i += MESSAGES_PER_KICK) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    enqueueWork(&queue, &sum, MESSAGES_PER_KICK);
+                }
+            });
+        }
+        for (auto &thread : threads) thread.join();
+        queue.kickAndWait();
+    });
+    queue.terminateConsumerThread();
+
+    EXPECT_EQ(sum, uint64_t{producerCount} * PAYLOAD_SIZE * (countPerProducer / MESSAGES_PER_KICK) * (MESSAGES_PER_KICK * (MESSAGES_PER_KICK - 1U) / 2U));
+    return ms;
+}
+
+double runMultiProducer(uint32_t producerCount) {
+    MultiProducerMessageQueue queue;
+    queue.setImmediateMode(false);
+    queue.runConsumerThread();
+
+    uint64_t sum{0U};
+    uint32_t const countPerProducer = MESSAGE_COUNT / producerCount;
+    double const ms = measureMs([&]() {
+        std::vector<std::thread> threads;
+        for (uint32_t p = 0U; p < producerCount; ++p) {
+            threads.emplace_back([&]() {
+                for (uint32_t i = 0U; i < countPerProducer; i += MESSAGES_PER_KICK) {
+                    enqueueWork(&queue, &sum, MESSAGES_PER_KICK);
+                }
+                queue.kick();
+            });
+        }
+        for (auto &thread : threads) thread.join();
+        queue.kickAndWait();
+    });
+    queue.terminateConsumerThread();
+
+    EXPECT_EQ(sum, uint64_t{producerCount} * PAYLOAD_SIZE * (countPerProducer / MESSAGES_PER_KICK) * (MESSAGES_PER_KICK * (MESSAGES_PER_KICK - 1U) / 2U));
+    return ms;
+}
+
+} // namespace
+
+TEST(MessageQueueBenchmark, DISABLED_throughput) {
+    for (uint32_t producers : {1U, 2U, 4U}) {
+        report("MessageQueue (locked)", producers, runSingleProducer(producers));
+        report("MultiProducerMessageQueue", producers, runMultiProducer(producers));
+    }
+}
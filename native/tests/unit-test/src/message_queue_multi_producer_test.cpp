@@ -0,0 +1,168 @@
+/****************************************************************************
+ Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#include <thread>
+#include <vector>
+#include "base/threading/MultiProducerMessageQueue.h"
+#include "gtest/gtest.h"
+
+using namespace cc;
+
+namespace {
+
+constexpr uint32_t PRODUCER_COUNT = 4U;
+constexpr uint32_t MESSAGES_PER_PRODUCER = 20000U;
+constexpr uint32_t MESSAGES_PER_KICK = 64U;
+// small payloads batched many per kick, so chunks fill up and switch in the middle of a batch
+constexpr uint32_t CHUNK_SWITCH_MESSAGE_COUNT = MultiProducerMessageQueue::MEMORY_CHUNK_SIZE;
+constexpr uint32_t CHUNK_SWITCH_PAYLOAD_COUNT = 8U;
+constexpr uint32_t CHUNK_SWITCH_MESSAGES_PER_KICK = 256U;
+
+struct ProducerRecord {
+    uint32_t nextSequence{0U};
+    uint32_t outOfOrder{0U};
+    uint64_t payloadSum{0U};
+};
+
+void produce(MultiProducerMessageQueue *queue, ProducerRecord *record, uint32_t producer) {
+    for (uint32_t i = 0U; i < MESSAGES_PER_PRODUCER; ++i) {
+        // the payload makes the producers cross chunk boundaries regularly
+        auto *payload = queue->allocate<uint32_t>(16U);
+        for (uint32_t j = 0U; j < 16U; ++j) payload[j] = producer + j;
+
+        ENQUEUE_MESSAGE_3(
+            queue, RecordSequence,
+            record, record,
+            sequence, i,
+            payload, payload,
+            {
+                if (record->nextSequence != sequence) ++record->outOfOrder;
+                record->nextSequence = sequence + 1U;
+                for (uint32_t j = 0U; j < 16U; ++j) record->payloadSum += payload[j];
+            });
+
+        if (i % MESSAGES_PER_KICK == MESSAGES_PER_KICK - 1U) queue->kick();
+    }
+    queue->kick();
+}
+
+// a chunk switch between a payload and its message must not hand the payload back before it executed
+uint64_t produceAcrossChunks(MultiProducerMessageQueue *queue, ProducerRecord *record, uint32_t producer) {
+    uint64_t expectedSum = 0U;
+    for (uint32_t i = 0U; i < CHUNK_SWITCH_MESSAGE_COUNT; ++i) {
+        auto *payload = queue->allocate<uint32_t>(CHUNK_SWITCH_PAYLOAD_COUNT);
+        for (uint32_t j = 0U; j < CHUNK_SWITCH_PAYLOAD_COUNT; ++j) payload[j] = producer + i;
+        expectedSum += uint64_t{CHUNK_SWITCH_PAYLOAD_COUNT} * (producer + i);
+
+        ENQUEUE_MESSAGE_3(
+            queue, CheckPayload,
+            record, record,
+            sequence, i,
+            payload, payload,
+            {
+                if (record->nextSequence != sequence) ++record->outOfOrder;
+                record->nextSequence = sequence + 1U;
+                for (uint32_t j = 0U; j < CHUNK_SWITCH_PAYLOAD_COUNT; ++j) record->payloadSum += payload[j];
+            });
+
+        if (i % CHUNK_SWITCH_MESSAGES_PER_KICK == CHUNK_SWITCH_MESSAGES_PER_KICK - 1U) queue->kick();
+    }
+    queue->kick();
+    return expectedSum;
+}
+
+} // namespace
+
+TEST(MultiProducerMessageQueueTest, consumerThreadKeepsPerProducerOrder) {
+    MultiProducerMessageQueue queue;
+    queue.setImmediateMode(false);
+    queue.runConsumerThread();
+
+    std::vector<ProducerRecord> records(PRODUCER_COUNT);
+    std::vector<std::thread> producers;
+    for (uint32_t p = 0U; p < PRODUCER_COUNT; ++p) {
+        producers.emplace_back(produce, &queue, &records[p], p);
+    }
+    for (auto &producer : producers) producer.join();
+
+    queue.kickAndWait();
+    queue.terminateConsumerThread();
+
+    for (uint32_t p = 0U; p < PRODUCER_COUNT; ++p) {
+        EXPECT_EQ(records[p].nextSequence, MESSAGES_PER_PRODUCER);
+        EXPECT_EQ(records[p].outOfOrder, 0U);
+        EXPECT_EQ(records[p].payloadSum, uint64_t{MESSAGES_PER_PRODUCER} * (16U * p + 120U));
+    }
+}
+
+TEST(MultiProducerMessageQueueTest, flushMessagesWithoutConsumerThread) {
+    MultiProducerMessageQueue queue;
+    queue.setImmediateMode(false);
+
+    std::vector<ProducerRecord> records(PRODUCER_COUNT);
+    std::vector<std::thread> producers;
+    for (uint32_t p = 0U; p < PRODUCER_COUNT; ++p) {
+        producers.emplace_back(produce, &queue, &records[p], p);
+    }
+    for (auto &producer : producers) producer.join();
+
+    queue.flushMessages();
+
+    for (uint32_t p = 0U; p < PRODUCER_COUNT; ++p) {
+        EXPECT_EQ(records[p].nextSequence, MESSAGES_PER_PRODUCER);
+        EXPECT_EQ(records[p].outOfOrder, 0U);
+    }
+}
+
+TEST(MultiProducerMessageQueueTest, immediateModeExecutesInline) {
+    MultiProducerMessageQueue queue;
+    ProducerRecord record;
+    produce(&queue, &record, 0U);
+
+    EXPECT_EQ(record.nextSequence, MESSAGES_PER_PRODUCER);
+    EXPECT_EQ(record.outOfOrder, 0U);
+}
+
+TEST(MultiProducerMessageQueueTest, payloadsSurviveChunkSwitches) {
+    MultiProducerMessageQueue queue;
+    queue.setImmediateMode(false);
+    queue.runConsumerThread();
+
+    std::vector<ProducerRecord> records(PRODUCER_COUNT);
+    std::vector<uint64_t> expectedSums(PRODUCER_COUNT);
+    std::vector<std::thread> producers;
+    for (uint32_t p = 0U; p < PRODUCER_COUNT; ++p) {
+        producers.emplace_back([&, p]() { expectedSums[p] = produceAcrossChunks(&queue, &records[p], p); });
+    }
+    for (auto &producer : producers) producer.join();
+
+    queue.kickAndWait();
+    queue.terminateConsumerThread();
+
+    for (uint32_t p = 0U; p < PRODUCER_COUNT; ++p) {
+        EXPECT_EQ(records[p].nextSequence, CHUNK_SWITCH_MESSAGE_COUNT);
+        EXPECT_EQ(records[p].outOfOrder, 0U);
+        EXPECT_EQ(records[p].payloadSum, expectedSums[p]);
+    }
+}
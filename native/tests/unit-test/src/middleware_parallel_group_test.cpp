@@ -0,0 +1,106 @@
+/****************************************************************************
+ Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "editor-support/MiddlewareManager.h"
+#include "gtest/gtest.h"
+
+using cc::middleware::IMiddleware;
+using cc::middleware::MiddlewareManager;
+
+namespace {
+
+// what the instances of a group share, e.g. a skeleton
+struct SharedData {
+    std::atomic<int> running{0};
+    std::atomic<int> maxRunning{0};
+    std::mutex mutex;
+    std::vector<int> order;
+};
+
+class GroupedMiddleware : public IMiddleware {
+public:
+    GroupedMiddleware(int index, SharedData *shared) : _index(index), _shared(shared) {}
+
+    void update(float /*dt*/) override {}
+    void render(float /*dt*/) override {}
+    bool beginParallelUpdate() override { return true; }
+    const void *getParallelGroup() const override { return _shared; }
+
+    void updateParallel() override {
+        const int running = ++_shared->running;
+        int maxRunning = _shared->maxRunning;
+        while (running > maxRunning && !_shared->maxRunning.compare_exchange_weak(maxRunning, running)) {
+        }
+        // long enough for the other workers to run into a group member if it was not serialized
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        {
+            std::lock_guard<std::mutex> lock(_shared->mutex);
+            _shared->order.push_back(_index);
+        }
+        --_shared->running;
+    }
+
+private:
+    int _index{0};
+    SharedData *_shared{nullptr};
+};
+
+} // namespace
+
+TEST(MiddlewareManagerTest, runsParallelGroupsOnOneWorkerInOrder) {
+    constexpr int GROUP_COUNT = 4;
+    constexpr int INSTANCE_COUNT = 32;
+
+    auto *manager = MiddlewareManager::getInstance();
+    const bool parallelEnabled = manager->isParallelEnabled();
+    manager->setParallelEnabled(true);
+
+    std::vector<SharedData> shared(GROUP_COUNT);
+    std::vector<std::unique_ptr<GroupedMiddleware>> instances;
+    for (int i = 0; i < INSTANCE_COUNT; ++i) {
+        instances.push_back(std::make_unique<GroupedMiddleware>(i, &shared[i % GROUP_COUNT]));
+        manager->addTimer(instances.back().get());
+    }
+
+    manager->update(0.0F);
+
+    for (int group = 0; group < GROUP_COUNT; ++group) {
+        EXPECT_EQ(1, shared[group].maxRunning.load()) << "group " << group;
+        ASSERT_EQ(INSTANCE_COUNT / GROUP_COUNT, shared[group].order.size()) << "group " << group;
+        EXPECT_TRUE(std::is_sorted(shared[group].order.begin(), shared[group].order.end())) << "group " << group;
+    }
+
+    for (auto &instance : instances) {
+        manager->removeTimer(instance.get());
+    }
+    manager->update(0.0F);
+    manager->setParallelEnabled(parallelEnabled);
+}
@@ -0,0 +1,424 @@
+/****************************************************************************
+ Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "cocos/base/std/container/string.h"
+#include "cocos/base/std/container/vector.h"
+#include "cocos/network/Downloader-curl.h"
+#include "cocos/network/Downloader.h"
+#include "cocos/platform/FileUtils.h"
+#include "gtest/gtest.h"
+
+// the curl downloader runs against a POSIX loopback server
+#if (CC_PLATFORM == CC_PLATFORM_LINUX || CC_PLATFORM == CC_PLATFORM_MACOS)
+
+    #include <arpa/inet.h>
+    #include <netinet/in.h>
+    #include <poll.h>
+    #include <signal.h>
+    #include <sys/socket.h>
+    #include <unistd.h>
+
+using namespace cc;
+using namespace cc::network;
+
+namespace {
+
+constexpr uint32_t CONTENT_SIZE = 1024 * 1024;
+
+uint8_t contentByte(uint32_t i) {
+    return static_cast<uint8_t>((i >> 8) ^ (i * 31));
+}
+
+struct Request {
+    ccstd::string method;
+    ccstd::string path;
+    ccstd::string range; // value of the Range header, empty if none
+    std::chrono::steady_clock::time_point time;
+};
+
+/**
+ * An HTTP/1.1 server on 127.0.0.1 serving CONTENT_SIZE bytes, a thread per connection:
+ * /ranged answers Range requests with 206, /plain ignores them and has no Accept-Ranges,
+ * /flaky is /ranged but closes the connection halfway through the first dropCount GET responses.
+ */
+class LoopbackServer {
+public:
+    explicit LoopbackServer(int dropCount = 0) : _dropsLeft(dropCount) {
+        signal(SIGPIPE, SIG_IGN);
+        _listenFd = socket(AF_INET, SOCK_STREAM, 0);
+        int reuse = 1;
+        setsockopt(_listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0;
+        bind(_listenFd, reinterpret_cast<sockaddr *>(&address), sizeof(address));
+        listen(_listenFd, 64);
+        socklen_t length = sizeof(address);
+        getsockname(_listenFd, reinterpret_cast<sockaddr *>(&address), &length);
+        _port = ntohs(address.sin_port);
+        _acceptThread = std::thread(&LoopbackServer::acceptLoop, this);
+    }
+
+    ~LoopbackServer() {
+        _running = false;
+        _acceptThread.join();
+        for (auto &thread : _connectionThreads) {
+            thread.join();
+        }
+        close(_listenFd);
+    }
+
+    ccstd::string url(const ccstd::string &path) const {
+        return "http://127.0.0.1:" + std::to_string(_port) + path;
+    }
+
+    // the GET requests in the order they arrived
+    ccstd::vector<Request> gets() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        ccstd::vector<Request> result;
+        for (const auto &request : _requests) {
+            if (request.method == "GET") {
+                result.push_back(request);
+            }
+        }
+        return result;
+    }
+
+private:
+    static bool waitReadable(int fd) {
+        pollfd pfd{fd, POLLIN, 0};
+        return poll(&pfd, 1, 20) > 0;
+    }
+
+    static bool sendAll(int fd, const char *data, size_t size) {
+        size_t sent = 0;
+        while (sent < size) {
+            const auto count = ::send(fd, data + sent, size - sent, 0);
+            if (count <= 0) {
+                return false;
+            }
+            sent += count;
+        }
+        return true;
+    }
+
+    void acceptLoop() {
+        while (_running) {
+            if (!waitReadable(_listenFd)) {
+                continue;
+            }
+            int fd = accept(_listenFd, nullptr, nullptr);
+            if (fd >= 0) {
+                _connectionThreads.emplace_back(&LoopbackServer::serve, this, fd);
+            }
+        }
+    }
+
+    void serve(int fd) {
+        ccstd::string buffer;
+        char chunk[4096];
+        while (_running) {
+            const auto headerEnd = buffer.find("\r\n\r\n");
+            if (headerEnd == ccstd::string::npos) {
+                if (!waitReadable(fd)) {
+                    continue;
+                }
+                const auto count = recv(fd, chunk, sizeof(chunk), 0);
+                if (count <= 0) {
+                    break;
+                }
+                buffer.append(chunk, count);
+                continue;
+            }
+
+            Request request;
+            request.time = std::chrono::steady_clock::now();
+            const auto pathStart = buffer.find(' ') + 1;
+            request.method = buffer.substr(0, pathStart - 1);
+            request.path = buffer.substr(pathStart, buffer.find(' ', pathStart) - pathStart);
+            const auto rangeStart = buffer.find("\r\nRange: bytes=");
+            if (rangeStart < headerEnd) {
+                const auto valueStart = rangeStart + 15;
+                request.range = buffer.substr(valueStart, buffer.find("\r\n", valueStart) - valueStart);
+            }
+            buffer.erase(0, headerEnd + 4);
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _requests.push_back(request);
+            }
+
+            if (!respond(fd, request)) {
+                break;
+            }
+        }
+        close(fd);
+    }
+
+    // false if the connection is to be closed
+    bool respond(int fd, const Request &request) {
+        const bool acceptRanges = request.path == "/ranged" || request.path == "/flaky";
+        if (!acceptRanges && request.path != "/plain") {
+            const char *notFound = "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n";
+            return sendAll(fd, notFound, strlen(notFound));
+        }
+
+        uint32_t begin = 0;
+        uint32_t end = CONTENT_SIZE;
+        ccstd::string status = "200 OK";
+        ccstd::string headers;
+        if (acceptRanges) {
+            headers += "Accept-Ranges: bytes\r\n";
+            if (!request.range.empty()) {
+                const auto dash = request.range.find('-');
+                begin = static_cast<uint32_t>(std::stoul(request.range.substr(0, dash)));
+                if (dash + 1 < request.range.size()) {
+                    end = static_cast<uint32_t>(std::stoul(request.range.substr(dash + 1))) + 1;
+                }
+                status = "206 Partial Content";
+                headers += "Content-Range: bytes " + std::to_string(begin) + "-" + std::to_string(end - 1) + "/" + std::to_string(CONTENT_SIZE) + "\r\n";
+            }
+        }
+        headers += "Content-Length: " + std::to_string(end - begin) + "\r\n";
+
+        ccstd::string response = "HTTP/1.1 " + status + "\r\n" + headers + "\r\n";
+        if (request.method == "HEAD") {
+            return sendAll(fd, response.data(), response.size());
+        }
+
+        bool drop = request.path == "/flaky" && _dropsLeft.fetch_sub(1) > 0;
+        const uint32_t sentEnd = drop ? begin + (end - begin) / 2 : end;
+        for (uint32_t i = begin; i < sentEnd; ++i) {
+            response.push_back(static_cast<char>(contentByte(i)));
+        }
+        return sendAll(fd, response.data(), response.size()) && !drop;
+    }
+
+    int _listenFd{-1};
+    uint16_t _port{0};
+    std::atomic<bool> _running{true};
+    std::atomic<int> _dropsLeft{0};
+    std::mutex _mutex;
+    ccstd::vector<Request> _requests;
+    std::thread _acceptThread;
+    ccstd::vector<std::thread> _connectionThreads;
+};
+
+// delivers the finished tasks by calling onSchedule, there is no running application
+class PumpedDownloader : public DownloaderCURL {
+public:
+    using DownloaderCURL::DownloaderCURL;
+    using DownloaderCURL::onSchedule;
+};
+
+ccstd::string rootPath() {
+    char cwd[4096];
+    return ccstd::string{getcwd(cwd, sizeof(cwd))} + "/downloader_curl_test/";
+}
+
+FileUtils *fileUtils() {
+    if (!FileUtils::getInstance()) {
+        createFileUtils(); // registers itself
+    }
+    return FileUtils::getInstance();
+}
+
+DownloaderHints splitHints() {
+    DownloaderHints hints;
+    hints.countOfMaxRangesPerTask = 4;
+    hints.minRangeSizeInBytes = CONTENT_SIZE / 8;
+    return hints;
+}
+
+// downloads url to path, true if the task succeeded
+bool download(const DownloaderHints &hints, const ccstd::string &url, const ccstd::string &path) {
+    PumpedDownloader downloader(hints);
+    bool finished = false;
+    int errorCode = DownloadTask::ERROR_NO_ERROR;
+    downloader.onTaskProgress = [](const DownloadTask & /*task*/, uint32_t /*received*/, uint32_t /*totalReceived*/, uint32_t /*totalExpected*/,
+                                   std::function<uint32_t(void *, uint32_t)> & /*transferDataToBuffer*/) {};
+    downloader.onTaskFinish = [&](const DownloadTask & /*task*/, int code, int /*internal*/, const ccstd::string & /*desc*/, const ccstd::vector<unsigned char> & /*data*/) {
+        finished = true;
+        errorCode = code;
+    };
+
+    auto task = std::make_shared<DownloadTask>();
+    task->requestURL = url;
+    task->storagePath = path;
+    std::shared_ptr<const DownloadTask> constTask = task;
+    std::unique_ptr<IDownloadTask> coTask(downloader.createCoTask(constTask));
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(20);
+    while (!finished && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        downloader.onSchedule(0);
+    }
+    EXPECT_TRUE(finished) << url;
+    return finished && DownloadTask::ERROR_NO_ERROR == errorCode;
+}
+
+// writes the content, the bytes outside of [begin, end) pairs are left zero
+void writeContent(const ccstd::string &path, uint32_t size, const ccstd::vector<std::pair<uint32_t, uint32_t>> &parts) {
+    ccstd::vector<uint8_t> bytes(size, 0);
+    for (const auto &part : parts) {
+        for (uint32_t i = part.first; i < part.second; ++i) {
+            bytes[i] = contentByte(i);
+        }
+    }
+    FILE *fp = fopen(path.c_str(), "wb");
+    ASSERT_NE(fp, nullptr);
+    fwrite(bytes.data(), 1, bytes.size(), fp);
+    fclose(fp);
+}
+
+bool hasContent(const ccstd::string &path) {
+    FILE *fp = fopen(path.c_str(), "rb");
+    if (!fp) {
+        return false;
+    }
+    ccstd::vector<uint8_t> bytes(CONTENT_SIZE + 1);
+    const size_t size = fread(bytes.data(), 1, bytes.size(), fp);
+    fclose(fp);
+    if (size != CONTENT_SIZE) {
+        return false;
+    }
+    for (uint32_t i = 0; i < CONTENT_SIZE; ++i) {
+        if (bytes[i] != contentByte(i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void resetRoot() {
+    fileUtils()->removeDirectory(rootPath());
+    fileUtils()->createDirectory(rootPath());
+}
+
+} // namespace
+
+TEST(DownloaderCURLTest, splitsIntoRanges) {
+    resetRoot();
+    LoopbackServer server;
+    const ccstd::string path = rootPath() + "ranged.bin";
+    EXPECT_TRUE(download(splitHints(), server.url("/ranged"), path));
+    EXPECT_TRUE(hasContent(path));
+    EXPECT_FALSE(fileUtils()->isFileExist(path + ".tmp"));
+    EXPECT_FALSE(fileUtils()->isFileExist(path + ".tmp.ranges"));
+
+    // four ranges of a quarter each, in parallel
+    auto gets = server.gets();
+    ASSERT_EQ(gets.size(), 4);
+    ccstd::vector<ccstd::string> ranges;
+    for (const auto &get : gets) {
+        ranges.push_back(get.range);
+    }
+    std::sort(ranges.begin(), ranges.end());
+    EXPECT_EQ(ranges[0], "0-262143");
+    EXPECT_EQ(ranges[1], "262144-524287");
+    EXPECT_EQ(ranges[2], "524288-786431");
+    EXPECT_EQ(ranges[3], "786432-1048575");
+}
+
+TEST(DownloaderCURLTest, serverWithoutRangesGetsOneStream) {
+    resetRoot();
+    LoopbackServer server;
+    const ccstd::string path = rootPath() + "plain.bin";
+
+    // the temp file can't be continued without ranges, so it's truncated rather than appended to
+    writeContent(path + ".tmp", 1000, {{0, 1000}});
+    EXPECT_TRUE(download(splitHints(), server.url("/plain"), path));
+    EXPECT_TRUE(hasContent(path));
+
+    auto gets = server.gets();
+    ASSERT_EQ(gets.size(), 1);
+    EXPECT_TRUE(gets[0].range.empty());
+}
+
+TEST(DownloaderCURLTest, resumesAfterDroppedConnection) {
+    resetRoot();
+    LoopbackServer server(1);
+    const ccstd::string path = rootPath() + "flaky.bin";
+    DownloaderHints hints;
+    hints.minRangeSizeInBytes = CONTENT_SIZE; // one stream
+    EXPECT_TRUE(download(hints, server.url("/flaky"), path));
+    EXPECT_TRUE(hasContent(path));
+
+    // the retry continues where the dropped response stopped, after a delay
+    auto gets = server.gets();
+    ASSERT_EQ(gets.size(), 2);
+    EXPECT_TRUE(gets[0].range.empty());
+    EXPECT_EQ(gets[1].range, "524288-1048575");
+    EXPECT_GE(gets[1].time - gets[0].time, std::chrono::milliseconds(200));
+}
+
+TEST(DownloaderCURLTest, resumesSavedRanges) {
+    resetRoot();
+    LoopbackServer server;
+    const ccstd::string path = rootPath() + "saved.bin";
+
+    // an interrupted download of two ranges, 100 KiB and 200 KiB into them
+    writeContent(path + ".tmp", CONTENT_SIZE, {{0, 102400}, {524288, 729088}});
+    FILE *fp = fopen((path + ".tmp.ranges").c_str(), "w");
+    ASSERT_NE(fp, nullptr);
+    fprintf(fp, "%u 2\n0 524288 102400\n524288 1048576 204800\n", CONTENT_SIZE);
+    fclose(fp);
+
+    EXPECT_TRUE(download(splitHints(), server.url("/ranged"), path));
+    EXPECT_TRUE(hasContent(path));
+    EXPECT_FALSE(fileUtils()->isFileExist(path + ".tmp.ranges"));
+
+    auto gets = server.gets();
+    ASSERT_EQ(gets.size(), 2);
+    ccstd::vector<ccstd::string> ranges{gets[0].range, gets[1].range};
+    std::sort(ranges.begin(), ranges.end());
+    EXPECT_EQ(ranges[0], "102400-524287");
+    EXPECT_EQ(ranges[1], "729088-1048575");
+}
+
+TEST(DownloaderCURLTest, resumesTheTempFileOfOneStream) {
+    resetRoot();
+    LoopbackServer server;
+    const ccstd::string path = rootPath() + "stream.bin";
+    DownloaderHints hints;
+    hints.minRangeSizeInBytes = CONTENT_SIZE; // one stream
+
+    writeContent(path + ".tmp", 300000, {{0, 300000}});
+    EXPECT_TRUE(download(hints, server.url("/ranged"), path));
+    EXPECT_TRUE(hasContent(path));
+
+    auto gets = server.gets();
+    ASSERT_EQ(gets.size(), 1);
+    EXPECT_EQ(gets[0].range, "300000-1048575");
+}
+
+#endif
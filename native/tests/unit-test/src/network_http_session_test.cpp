@@ -0,0 +1,398 @@
+/****************************************************************************
+ Copyright (c) 2021-2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "cocos/base/memory/Memory.h"
+#include "cocos/base/std/container/string.h"
+#include "cocos/base/std/container/vector.h"
+#include "gtest/gtest.h"
+#include "cocos/network/HttpSession-curl.h"
+
+// the curl session runs against a POSIX loopback server
+#if (CC_PLATFORM == CC_PLATFORM_LINUX || CC_PLATFORM == CC_PLATFORM_MACOS)
+
+    #include <arpa/inet.h>
+    #include <netinet/in.h>
+    #include <poll.h>
+    #include <signal.h>
+    #include <sys/socket.h>
+    #include <unistd.h>
+
+using namespace cc;
+using namespace cc::network;
+
+namespace {
+
+constexpr size_t BIG_BODY_SIZE = 4 * 1024 * 1024;
+
+char bigBodyByte(size_t i) {
+    return static_cast<char>('a' + i % 26);
+}
+
+/**
+ * A keep-alive HTTP/1.1 server on 127.0.0.1, a thread per connection:
+ * /fast/<n> answers at once, /wait after 100 ms, /big with BIG_BODY_SIZE bytes,
+ * /block once releaseBlocked() is called, anything else with a 404.
+ */
+class LoopbackServer {
+public:
+    LoopbackServer() {
+        signal(SIGPIPE, SIG_IGN);
+        _listenFd = socket(AF_INET, SOCK_STREAM, 0);
+        int reuse = 1;
+        setsockopt(_listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0;
+        bind(_listenFd, reinterpret_cast<sockaddr *>(&address), sizeof(address));
+        listen(_listenFd, 64);
+        socklen_t length = sizeof(address);
+        getsockname(_listenFd, reinterpret_cast<sockaddr *>(&address), &length);
+        _port = ntohs(address.sin_port);
+        _acceptThread = std::thread(&LoopbackServer::acceptLoop, this);
+    }
+
+    ~LoopbackServer() {
+        releaseBlocked();
+        _running = false;
+        _acceptThread.join();
+        for (auto &thread : _connectionThreads) {
+            thread.join();
+        }
+        close(_listenFd);
+    }
+
+    ccstd::string url(const ccstd::string &path) const {
+        return "http://127.0.0.1:" + std::to_string(_port) + path;
+    }
+
+    int connectionCount() const { return _connections; }
+    int maxRequestsInFlight() const { return _maxInFlight; }
+    int requestCount() const { return _requests; }
+
+    // waits until count /block requests are held by the server
+    bool waitForBlocked(int count) {
+        std::unique_lock<std::mutex> lock(_blockMutex);
+        return _blockCondition.wait_for(lock, std::chrono::seconds(20), [&]() { return _blocked >= count; });
+    }
+
+    int blockedCount() {
+        std::lock_guard<std::mutex> lock(_blockMutex);
+        return _blocked;
+    }
+
+    void releaseBlocked() {
+        std::lock_guard<std::mutex> lock(_blockMutex);
+        _blockReleased = true;
+        _blockCondition.notify_all();
+    }
+
+private:
+    static bool waitReadable(int fd) {
+        pollfd pfd{fd, POLLIN, 0};
+        return poll(&pfd, 1, 20) > 0;
+    }
+
+    void acceptLoop() {
+        while (_running) {
+            if (!waitReadable(_listenFd)) {
+                continue;
+            }
+            int fd = accept(_listenFd, nullptr, nullptr);
+            if (fd >= 0) {
+                ++_connections;
+                _connectionThreads.emplace_back(&LoopbackServer::serve, this, fd);
+            }
+        }
+    }
+
+    void serve(int fd) {
+        ccstd::string buffer;
+        char chunk[4096];
+        while (_running) {
+            const auto headerEnd = buffer.find("\r\n\r\n");
+            if (headerEnd == ccstd::string::npos) {
+                if (!waitReadable(fd)) {
+                    continue;
+                }
+                const auto count = recv(fd, chunk, sizeof(chunk), 0);
+                if (count <= 0) {
+                    break;
+                }
+                buffer.append(chunk, count);
+                continue;
+            }
+
+            const auto pathStart = buffer.find(' ') + 1;
+            const ccstd::string path = buffer.substr(pathStart, buffer.find(' ', pathStart) - pathStart);
+            buffer.erase(0, headerEnd + 4);
+
+            ++_requests;
+            const int inFlight = ++_inFlight;
+            int maxInFlight = _maxInFlight;
+            while (inFlight > maxInFlight && !_maxInFlight.compare_exchange_weak(maxInFlight, inFlight)) {
+            }
+            respond(fd, path);
+            --_inFlight;
+        }
+        close(fd);
+    }
+
+    void respond(int fd, const ccstd::string &path) {
+        const char *status = "200 OK";
+        ccstd::string body;
+        if (path.compare(0, 6, "/fast/") == 0) {
+            body = "fast " + path.substr(6);
+        } else if (path == "/block") {
+            std::unique_lock<std::mutex> lock(_blockMutex);
+            ++_blocked;
+            _blockCondition.notify_all();
+            _blockCondition.wait(lock, [&]() { return _blockReleased; });
+            --_blocked;
+            body = "block";
+        } else if (path == "/wait") {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            body = "wait";
+        } else if (path == "/big") {
+            body.resize(BIG_BODY_SIZE);
+            for (size_t i = 0; i < BIG_BODY_SIZE; ++i) {
+                body[i] = bigBodyByte(i);
+            }
+        } else {
+            status = "404 Not Found";
+        }
+
+        ccstd::string response = ccstd::string("HTTP/1.1 ") + status + "\r\nContent-Length: " + std::to_string(body.size()) +
+                                 "\r\nConnection: keep-alive\r\n\r\n" + body;
+        size_t sent = 0;
+        while (sent < response.size()) {
+            const auto count = ::send(fd, response.data() + sent, response.size() - sent, 0);
+            if (count <= 0) {
+                return;
+            }
+            sent += count;
+        }
+    }
+
+    int _listenFd{-1};
+    uint16_t _port{0};
+    std::atomic<bool> _running{true};
+    std::atomic<int> _connections{0};
+    std::atomic<int> _inFlight{0};
+    std::atomic<int> _maxInFlight{0};
+    std::atomic<int> _requests{0};
+    std::mutex _blockMutex;
+    std::condition_variable _blockCondition;
+    int _blocked{0};
+    bool _blockReleased{false};
+    std::thread _acceptThread;
+    ccstd::vector<std::thread> _connectionThreads;
+};
+
+struct Result {
+    ccstd::string tag;
+    bool succeed{false};
+    long code{0};
+    ccstd::string body;
+};
+
+// Collects the responses of a session in the order they finish
+class Collector {
+public:
+    HttpSessionCURL::CompletionCallback callback() {
+        return [this](HttpResponse *response) {
+            auto *request = response->getHttpRequest();
+            Result result;
+            result.tag = request->getTag();
+            result.succeed = response->isSucceed();
+            result.code = response->getResponseCode();
+            result.body.assign(response->getResponseData()->begin(), response->getResponseData()->end());
+            response->release();
+            request->release();
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            _results.push_back(result);
+            _condition.notify_all();
+        };
+    }
+
+    ccstd::vector<Result> wait(size_t count) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _condition.wait_for(lock, std::chrono::seconds(20), [&]() { return _results.size() >= count; });
+        return _results;
+    }
+
+private:
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    ccstd::vector<Result> _results;
+};
+
+HttpRequest *makeRequest(const ccstd::string &url, const ccstd::string &tag) {
+    auto *request = ccnew HttpRequest();
+    request->addRef();
+    request->setRequestType(HttpRequest::Type::GET);
+    request->setUrl(url);
+    request->setTag(tag);
+    return request;
+}
+
+} // namespace
+
+TEST(HttpSessionCURLTest, slowRequestDoesNotBlockOthers) {
+    LoopbackServer server;
+    Collector collector;
+    HttpSessionCURL session(collector.callback());
+
+    // the server holds the slow request until every other one has been answered
+    session.send(makeRequest(server.url("/block"), "slow"), false);
+    ASSERT_TRUE(server.waitForBlocked(1));
+    for (int i = 0; i < 10; ++i) {
+        session.send(makeRequest(server.url("/fast/" + std::to_string(i)), std::to_string(i)), false);
+    }
+    session.send(makeRequest(server.url("/missing"), "missing"), false);
+
+    auto results = collector.wait(11);
+    ASSERT_EQ(11U, results.size());
+    for (const auto &result : results) {
+        ASSERT_NE("slow", result.tag);
+        if (result.tag == "missing") {
+            EXPECT_FALSE(result.succeed);
+            EXPECT_EQ(404, result.code);
+        } else {
+            EXPECT_TRUE(result.succeed);
+            EXPECT_EQ("fast " + result.tag, result.body);
+        }
+    }
+    EXPECT_EQ(1, server.blockedCount());
+
+    server.releaseBlocked();
+    results = collector.wait(12);
+    ASSERT_EQ(12U, results.size());
+    EXPECT_EQ("slow", results.back().tag);
+    EXPECT_TRUE(results.back().succeed);
+    EXPECT_EQ("block", results.back().body);
+}
+
+TEST(HttpSessionCURLTest, limitsConcurrencyAndReusesConnections) {
+    LoopbackServer server;
+    Collector collector;
+    HttpSessionCURL session(collector.callback());
+    session.setMaxConcurrentRequests(3);
+    session.setMaxConnectionsPerHost(3);
+
+    for (int i = 0; i < 12; ++i) {
+        session.send(makeRequest(server.url("/wait"), std::to_string(i)), false);
+    }
+
+    const auto results = collector.wait(12);
+    ASSERT_EQ(12U, results.size());
+    for (const auto &result : results) {
+        EXPECT_TRUE(result.succeed);
+    }
+    EXPECT_LE(server.maxRequestsInFlight(), 3);
+    EXPECT_LE(server.connectionCount(), 3);
+}
+
+TEST(HttpSessionCURLTest, streamsIntoTheSink) {
+    LoopbackServer server;
+    Collector collector;
+    HttpSessionCURL session(collector.callback());
+
+    size_t received = 0;
+    size_t mismatches = 0;
+    auto *request = makeRequest(server.url("/big"), "big");
+    request->setResponseSink([&](const char *data, size_t size) {
+        for (size_t i = 0; i < size; ++i) {
+            mismatches += data[i] != bigBodyByte(received + i);
+        }
+        received += size;
+        return true;
+    });
+    session.send(request, false);
+
+    // a sink returning false cancels its request
+    auto *cancelled = makeRequest(server.url("/big"), "cancelled");
+    cancelled->setResponseSink([](const char * /*data*/, size_t /*size*/) { return false; });
+    session.send(cancelled, true);
+
+    const auto results = collector.wait(2);
+    ASSERT_EQ(2U, results.size());
+    for (const auto &result : results) {
+        EXPECT_TRUE(result.body.empty());
+        EXPECT_EQ(result.tag == "big", result.succeed);
+    }
+    EXPECT_EQ(BIG_BODY_SIZE, received);
+    EXPECT_EQ(0U, mismatches);
+}
+
+TEST(HttpSessionCURLTest, immediateRequestsBypassTheLimit) {
+    LoopbackServer server;
+    Collector collector;
+    HttpSessionCURL session(collector.callback());
+    session.setMaxConcurrentRequests(1);
+    session.send(makeRequest(server.url("/block"), "block"), false);
+    ASSERT_TRUE(server.waitForBlocked(1));
+
+    // the only slot is taken until the server is released
+    session.send(makeRequest(server.url("/fast/0"), "0"), true);
+    auto results = collector.wait(1);
+    ASSERT_EQ(1U, results.size());
+    EXPECT_EQ("0", results[0].tag);
+    EXPECT_TRUE(results[0].succeed);
+    EXPECT_EQ(1, server.blockedCount());
+
+    server.releaseBlocked();
+    results = collector.wait(2);
+    ASSERT_EQ(2U, results.size());
+    EXPECT_EQ("block", results[1].tag);
+    EXPECT_TRUE(results[1].succeed);
+}
+
+TEST(HttpSessionCURLTest, stopDropsPendingRequests) {
+    LoopbackServer server;
+    Collector collector;
+    {
+        HttpSessionCURL session(collector.callback());
+        session.setMaxConcurrentRequests(1);
+        session.send(makeRequest(server.url("/block"), "block"), false);
+        session.send(makeRequest(server.url("/fast/0"), "0"), false);
+        ASSERT_TRUE(server.waitForBlocked(1));
+
+        // stop() aborts the transfer the server still holds instead of waiting for its response
+        session.stop();
+        EXPECT_EQ(1, server.blockedCount());
+    }
+    server.releaseBlocked();
+    // neither the aborted nor the queued request called back, the queued one was never sent
+    EXPECT_TRUE(collector.wait(0).empty());
+    EXPECT_EQ(1, server.requestCount());
+}
+
+#endif
@@ -0,0 +1,234 @@
+/****************************************************************************
+ Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include "cocos/base/std/container/string.h"
+#include "cocos/base/std/container/vector.h"
+#include "cocos/platform/AsyncFileBackend.h"
+#include "cocos/platform/AsyncFileReader.h"
+#include "gtest/gtest.h"
+
+#if (CC_PLATFORM != CC_PLATFORM_WINDOWS)
+    #include <unistd.h>
+#endif
+
+using namespace cc;
+
+namespace {
+
+// stands in for the Scheduler, completions run when the test pumps them
+class MainThreadQueue {
+public:
+    AsyncFileReader::Dispatcher dispatcher() {
+        return [this](std::function<void()> &&func) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _functions.push_back(std::move(func));
+        };
+    }
+
+    void pump() {
+        ccstd::vector<std::function<void()>> functions;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            functions.swap(_functions);
+        }
+        for (auto &func : functions) {
+            func();
+        }
+    }
+
+    bool pumpUntil(const std::function<bool()> &done) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (!done()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            pump();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+private:
+    std::mutex _mutex;
+    ccstd::vector<std::function<void()>> _functions;
+};
+
+AsyncFileRequest makeRequest(uint32_t id, uint8_t priority, uint64_t sequence) {
+    AsyncFileRequest request;
+    request.id = id;
+    request.priority = priority;
+    request.sequence = sequence;
+    return request;
+}
+
+} // namespace
+
+TEST(AsyncFileRequestQueueTest, ordersByPriorityThenSubmission) {
+    AsyncFileRequestQueue queue;
+    ccstd::vector<AsyncFileRequest> requests;
+    requests.push_back(makeRequest(1, 1, 0));
+    requests.push_back(makeRequest(2, 0, 1));
+    requests.push_back(makeRequest(3, 2, 2));
+    requests.push_back(makeRequest(4, 1, 3));
+    requests.push_back(makeRequest(5, 2, 4));
+    queue.push(std::move(requests));
+
+    EXPECT_TRUE(queue.remove(4));
+    EXPECT_FALSE(queue.remove(4));
+
+    ccstd::vector<AsyncFileRequest> popped;
+    EXPECT_EQ(queue.tryPop(&popped, 10), 4);
+    ccstd::vector<uint32_t> ids;
+    for (const auto &request : popped) {
+        ids.push_back(request.id);
+    }
+    EXPECT_EQ(ids, (ccstd::vector<uint32_t>{3, 5, 1, 2}));
+
+    queue.close();
+    AsyncFileRequest request;
+    EXPECT_FALSE(queue.pop(&request));
+}
+
+#if (CC_PLATFORM != CC_PLATFORM_WINDOWS)
+
+namespace {
+
+ccstd::string absolutePath(const char *name) {
+    char cwd[4096];
+    return ccstd::string{getcwd(cwd, sizeof(cwd))} + "/" + name;
+}
+
+ccstd::string writeFile(const char *name, size_t size, uint8_t seed) {
+    ccstd::string path = absolutePath(name);
+    FILE *fp = fopen(path.c_str(), "wb");
+    for (size_t i = 0; i < size; ++i) {
+        fputc(static_cast<uint8_t>(seed + i * 13), fp);
+    }
+    fclose(fp);
+    return path;
+}
+
+bool hasContents(const Data &data, size_t size, uint8_t seed) {
+    if (data.getSize() != size) {
+        return false;
+    }
+    for (size_t i = 0; i < size; ++i) {
+        if (data.getBytes()[i] != static_cast<uint8_t>(seed + i * 13)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void readsFiles(bool useIOUring) {
+    MainThreadQueue mainThread;
+    AsyncFileReader reader{mainThread.dispatcher(), useIOUring};
+
+    constexpr uint32_t FILE_COUNT = 300;
+    ccstd::vector<ccstd::string> paths;
+    ccstd::vector<AsyncFileReader::ReadRequest> requests;
+    uint32_t completed = 0;
+    uint32_t matching = 0;
+    for (uint32_t i = 0; i < FILE_COUNT; ++i) {
+        const size_t size = (i % 7) * 1000 + i;
+        const auto seed = static_cast<uint8_t>(i);
+        const ccstd::string name = "async_file_reader_test_" + std::to_string(i) + ".bin";
+        paths.push_back(writeFile(name.c_str(), size, seed));
+        requests.push_back({paths.back(), [&, size, seed](FileUtils::Status status, Data &data) {
+                                ++completed;
+                                if (status == FileUtils::Status::OK && hasContents(data, size, seed)) {
+                                    ++matching;
+                                }
+                            },
+                            i % 3 == 0 ? AsyncFileReader::Priority::HIGH : AsyncFileReader::Priority::NORMAL});
+    }
+
+    FileUtils::Status missingStatus = FileUtils::Status::OK;
+    bool missingDone = false;
+    reader.read(absolutePath("async_file_reader_test_missing.bin"), [&](FileUtils::Status status, Data & /*data*/) {
+        missingStatus = status;
+        missingDone = true;
+    });
+
+    const auto ids = reader.readBatch(std::move(requests));
+    EXPECT_EQ(ids.size(), FILE_COUNT);
+    // callbacks only ever run on the thread pumping the dispatcher
+    EXPECT_EQ(completed, 0);
+
+    EXPECT_TRUE(mainThread.pumpUntil([&]() { return completed == FILE_COUNT && missingDone; }));
+    EXPECT_EQ(matching, FILE_COUNT);
+    EXPECT_EQ(missingStatus, FileUtils::Status::NOT_EXISTS);
+    EXPECT_EQ(reader.getPendingCount(), 0);
+
+    for (const auto &path : paths) {
+        remove(path.c_str());
+    }
+}
+
+} // namespace
+
+TEST(AsyncFileReaderTest, threadPoolBackendReadsFiles) {
+    readsFiles(false);
+}
+
+TEST(AsyncFileReaderTest, ioUringBackendReadsFiles) {
+    // falls back to the thread pool where io_uring is not available
+    readsFiles(true);
+}
+
+TEST(AsyncFileReaderTest, cancelledRequestsAreNotDelivered) {
+    MainThreadQueue mainThread;
+    AsyncFileReader reader{mainThread.dispatcher()};
+    const ccstd::string path = writeFile("async_file_reader_test_cancel.bin", 100, 1);
+
+    bool cancelledCalled = false;
+    bool keptCalled = false;
+    const auto cancelled = reader.read(path, [&](FileUtils::Status /*status*/, Data & /*data*/) { cancelledCalled = true; });
+    reader.read(path, [&](FileUtils::Status /*status*/, Data & /*data*/) { keptCalled = true; });
+    EXPECT_TRUE(reader.cancel(cancelled));
+    EXPECT_FALSE(reader.cancel(cancelled));
+
+    EXPECT_TRUE(mainThread.pumpUntil([&]() { return keptCalled; }));
+    // let the backend finish the cancelled read if it had already started
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    mainThread.pump();
+    EXPECT_FALSE(cancelledCalled);
+
+    reader.read(path, [&](FileUtils::Status /*status*/, Data & /*data*/) { cancelledCalled = true; });
+    reader.cancelAll();
+    EXPECT_EQ(reader.getPendingCount(), 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    mainThread.pump();
+    EXPECT_FALSE(cancelledCalled);
+
+    remove(path.c_str());
+}
+
+#endif
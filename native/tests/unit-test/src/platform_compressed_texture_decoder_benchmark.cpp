@@ -0,0 +1,372 @@
+/****************************************************************************
+ Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#include <cstring>
+#include <random>
+#include <vector>
+#include "base/etc2.h"
+#include "gtest/gtest.h"
+#include "platform/CompressedTextureDecoder.h"
+#include "utils.h"
+
+using namespace cc;
+
+// CompressedTextureDecoder against outputs worked out from the Khronos ETC2/EAC
+// specification by a separate decoder, and its time on a large texture next to base/etc2.cpp.
+
+namespace {
+
+constexpr uint32_t BENCHMARK_SIZE = 2048U;
+constexpr uint32_t BENCHMARK_ROUNDS = 4U;
+
+enum class ColorMode {
+    INDIVIDUAL,
+    DIFFERENTIAL,
+    T,
+    H,
+    PLANAR,
+};
+
+const int DIFF_LOOKUP[8] = {0, 1, 2, 3, -4, -3, -2, -1};
+
+ColorMode getColorMode(const uint8_t *block) {
+    if (!(block[3] & 2)) return ColorMode::INDIVIDUAL;
+    if ((block[0] >> 3) + DIFF_LOOKUP[block[0] & 7] < 0 || (block[0] >> 3) + DIFF_LOOKUP[block[0] & 7] > 31) return ColorMode::T;
+    if ((block[1] >> 3) + DIFF_LOOKUP[block[1] & 7] < 0 || (block[1] >> 3) + DIFF_LOOKUP[block[1] & 7] > 31) return ColorMode::H;
+    if ((block[2] >> 3) + DIFF_LOOKUP[block[2] & 7] < 0 || (block[2] >> 3) + DIFF_LOOKUP[block[2] & 7] > 31) return ColorMode::PLANAR;
+    return ColorMode::DIFFERENTIAL;
+}
+
+std::vector<uint8_t> randomBytes(size_t count, uint32_t seed) {
+    std::mt19937 random(seed);
+    std::vector<uint8_t> bytes(count);
+    for (auto &b : bytes) {
+        b = static_cast<uint8_t>(random());
+    }
+    return bytes;
+}
+
+void decodeBlock(gfx::Format format, const uint8_t *block, uint8_t *out) {
+    auto decoder = CompressedTextureDecoder::getBlockDecoder(format);
+    ASSERT_NE(decoder, nullptr);
+    decoder(block, out, 16);
+}
+
+// an encoded block and its 4 x 4 RGBA8 pixels in row order
+struct ReferenceBlock {
+    uint8_t block[16];
+    uint8_t rgba[64];
+};
+
+// ETC2 RGB blocks of every mode, flip bit included for the ETC1 modes
+const ReferenceBlock RGB_REFERENCES[] = {
+    // individual
+    {{0xCD, 0x0E, 0xAA, 0x80, 0x3E, 0xB0, 0x3E, 0x8E},
+     {0xDE, 0x12, 0xBC, 0xFF, 0xBA, 0x00, 0x98, 0xFF, 0xDF, 0xF0, 0xAC, 0xFF, 0xD5, 0xE6, 0xA2, 0xFF,
+      0xFF, 0x3C, 0xE6, 0xFF, 0xBA, 0x00, 0x98, 0xFF, 0xD5, 0xE6, 0xA2, 0xFF, 0xD5, 0xE6, 0xA2, 0xFF,
+      0xFF, 0x3C, 0xE6, 0xFF, 0xDE, 0x12, 0xBC, 0xFF, 0xD5, 0xE6, 0xA2, 0xFF, 0xDF, 0xF0, 0xAC, 0xFF,
+      0xFF, 0x3C, 0xE6, 0xFF, 0x90, 0x00, 0x6E, 0xFF, 0xD5, 0xE6, 0xA2, 0xFF, 0xDF, 0xF0, 0xAC, 0xFF}},
+    // individual
+    {{0xDB, 0x83, 0x05, 0x3C, 0x93, 0x03, 0x2B, 0x75},
+     {0xCC, 0x77, 0x00, 0xFF, 0xEE, 0x99, 0x11, 0xFF, 0x04, 0x00, 0x00, 0xFF, 0x8C, 0x04, 0x26, 0xFF,
+      0xD8, 0x83, 0x00, 0xFF, 0xEE, 0x99, 0x11, 0xFF, 0x04, 0x00, 0x00, 0xFF, 0xFF, 0xEA, 0xFF, 0xFF,
+      0xEE, 0x99, 0x11, 0xFF, 0xEE, 0x99, 0x11, 0xFF, 0xEA, 0x62, 0x84, 0xFF, 0xEA, 0x62, 0x84, 0xFF,
+      0xE2, 0x8D, 0x05, 0xFF, 0xE2, 0x8D, 0x05, 0xFF, 0xFF, 0xEA, 0xFF, 0xFF, 0x8C, 0x04, 0x26, 0xFF}},
+    // individual, flipped
+    {{0x23, 0x47, 0xC6, 0xF5, 0x68, 0x5D, 0x6C, 0x94},
+     {0x00, 0x15, 0x9D, 0xFF, 0x00, 0x00, 0x15, 0xFF, 0x51, 0x73, 0xFB, 0xFF, 0x51, 0x73, 0xFB, 0xFF,
+      0x51, 0x73, 0xFB, 0xFF, 0x51, 0x73, 0xFB, 0xFF, 0x51, 0x73, 0xFB, 0xFF, 0x00, 0x00, 0x15, 0xFF,
+      0x00, 0x27, 0x16, 0xFF, 0x1B, 0x5F, 0x4E, 0xFF, 0x83, 0xC7, 0xB6, 0xFF, 0x00, 0x27, 0x16, 0xFF,
+      0x1B, 0x5F, 0x4E, 0xFF, 0x83, 0xC7, 0xB6, 0xFF, 0x00, 0x27, 0x16, 0xFF, 0x4B, 0x8F, 0x7E, 0xFF}},
+    // individual, flipped
+    {{0x5B, 0x00, 0x90, 0x49, 0x66, 0x56, 0x80, 0xDE},
+     {0x5E, 0x09, 0xA2, 0xFF, 0x38, 0x00, 0x7C, 0xFF, 0x5E, 0x09, 0xA2, 0xFF, 0x5E, 0x09, 0xA2, 0xFF,
+      0x38, 0x00, 0x7C, 0xFF, 0x5E, 0x09, 0xA2, 0xFF, 0x4C, 0x00, 0x90, 0xFF, 0x4C, 0x00, 0x90, 0xFF,
+      0x9E, 0x00, 0x00, 0xFF, 0x9E, 0x00, 0x00, 0xFF, 0xB2, 0x00, 0x00, 0xFF, 0xB2, 0x00, 0x00, 0xFF,
+      0xD8, 0x1D, 0x1D, 0xFF, 0xD8, 0x1D, 0x1D, 0xFF, 0xC4, 0x09, 0x09, 0xFF, 0xD8, 0x1D, 0x1D, 0xFF}},
+    // differential
+    {{0x9A, 0x5B, 0x77, 0x5A, 0x08, 0x6B, 0xB9, 0x23},
+     {0x7F, 0x3D, 0x56, 0xFF, 0xA5, 0x63, 0x7C, 0xFF, 0xFF, 0xDD, 0xD5, 0xFF, 0xFF, 0xDD, 0xD5, 0xFF,
+      0x7F, 0x3D, 0x56, 0xFF, 0x7F, 0x3D, 0x56, 0xFF, 0xCE, 0x94, 0x8C, 0xFF, 0xFF, 0xDD, 0xD5, 0xFF,
+      0xA5, 0x63, 0x7C, 0xFF, 0x93, 0x51, 0x6A, 0xFF, 0xCE, 0x94, 0x8C, 0xFF, 0xCE, 0x94, 0x8C, 0xFF,
+      0x93, 0x51, 0x6A, 0xFF, 0xA5, 0x63, 0x7C, 0xFF, 0x43, 0x09, 0x01, 0xFF, 0xFF, 0xDD, 0xD5, 0xFF}},
+    // differential
+    {{0x27, 0xB6, 0x74, 0x4A, 0xB1, 0x3C, 0x0A, 0x8C},
+     {0x2A, 0xBE, 0x7C, 0xFF, 0x18, 0xAC, 0x6A, 0xFF, 0x0F, 0x9C, 0x49, 0xFF, 0x0F, 0x9C, 0x49, 0xFF,
+      0x2A, 0xBE, 0x7C, 0xFF, 0x18, 0xAC, 0x6A, 0xFF, 0x35, 0xC2, 0x6F, 0xFF, 0x0F, 0x9C, 0x49, 0xFF,
+      0x04, 0x98, 0x56, 0xFF, 0x2A, 0xBE, 0x7C, 0xFF, 0x21, 0xAE, 0x5B, 0xFF, 0x21, 0xAE, 0x5B, 0xFF,
+      0x04, 0x98, 0x56, 0xFF, 0x3E, 0xD2, 0x90, 0xFF, 0x35, 0xC2, 0x6F, 0xFF, 0x0F, 0x9C, 0x49, 0xFF}},
+    // differential, flipped
+    {{0xC4, 0xE4, 0xC7, 0xA3, 0xAC, 0x33, 0x3F, 0x9B},
+     {0x76, 0x97, 0x76, 0xFF, 0x76, 0x97, 0x76, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+      0x76, 0x97, 0x76, 0xFF, 0xAE, 0xCF, 0xAE, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x76, 0x97, 0x76, 0xFF,
+      0xA7, 0xC8, 0xBF, 0xFF, 0xA7, 0xC8, 0xBF, 0xFF, 0x9D, 0xBE, 0xB5, 0xFF, 0xA7, 0xC8, 0xBF, 0xFF,
+      0xAD, 0xCE, 0xC5, 0xFF, 0xAD, 0xCE, 0xC5, 0xFF, 0x9D, 0xBE, 0xB5, 0xFF, 0xA3, 0xC4, 0xBB, 0xFF}},
+    // differential, flipped
+    {{0x40, 0x13, 0x66, 0x4F, 0xF5, 0xE4, 0xAE, 0x21},
+     {0x5F, 0x2D, 0x80, 0xFF, 0x4B, 0x19, 0x6C, 0xFF, 0x39, 0x07, 0x5A, 0xFF, 0x39, 0x07, 0x5A, 0xFF,
+      0x4B, 0x19, 0x6C, 0xFF, 0x25, 0x00, 0x46, 0xFF, 0x5F, 0x2D, 0x80, 0xFF, 0x25, 0x00, 0x46, 0xFF,
+      0x35, 0x1C, 0x45, 0xFF, 0x35, 0x1C, 0x45, 0xFF, 0x18, 0x00, 0x28, 0xFF, 0x35, 0x1C, 0x45, 0xFF,
+      0x4F, 0x36, 0x5F, 0xFF, 0x35, 0x1C, 0x45, 0xFF, 0x6C, 0x53, 0x7C, 0xFF, 0x18, 0x00, 0x28, 0xFF}},
+    // T
+    {{0x15, 0x0D, 0xA4, 0xB7, 0xFC, 0xDA, 0x1D, 0x6C},
+     {0x99, 0x00, 0xDD, 0xFF, 0xAA, 0x44, 0xBB, 0xFF, 0xBA, 0x54, 0xCB, 0xFF, 0x9A, 0x34, 0xAB, 0xFF,
+      0xAA, 0x44, 0xBB, 0xFF, 0xBA, 0x54, 0xCB, 0xFF, 0x99, 0x00, 0xDD, 0xFF, 0xAA, 0x44, 0xBB, 0xFF,
+      0xBA, 0x54, 0xCB, 0xFF, 0x9A, 0x34, 0xAB, 0xFF, 0x9A, 0x34, 0xAB, 0xFF, 0xAA, 0x44, 0xBB, 0xFF,
+      0x9A, 0x34, 0xAB, 0xFF, 0xAA, 0x44, 0xBB, 0xFF, 0x9A, 0x34, 0xAB, 0xFF, 0xAA, 0x44, 0xBB, 0xFF}},
+    // T
+    {{0xFB, 0xAF, 0x02, 0xE2, 0x05, 0xAF, 0xA5, 0x4A},
+     {0x00, 0x22, 0xEE, 0xFF, 0xFF, 0xAA, 0xFF, 0xFF, 0x00, 0x1F, 0xEB, 0xFF, 0xFF, 0xAA, 0xFF, 0xFF,
+      0x00, 0x1F, 0xEB, 0xFF, 0x00, 0x22, 0xEE, 0xFF, 0xFF, 0xAA, 0xFF, 0xFF, 0x03, 0x25, 0xF1, 0xFF,
+      0x00, 0x22, 0xEE, 0xFF, 0x03, 0x25, 0xF1, 0xFF, 0x00, 0x1F, 0xEB, 0xFF, 0xFF, 0xAA, 0xFF, 0xFF,
+      0x00, 0x1F, 0xEB, 0xFF, 0x00, 0x22, 0xEE, 0xFF, 0xFF, 0xAA, 0xFF, 0xFF, 0x03, 0x25, 0xF1, 0xFF}},
+    // H
+    {{0x90, 0x14, 0x70, 0x6B, 0xB8, 0x92, 0x4E, 0x50},
+     {0x2D, 0x1C, 0x0B, 0xFF, 0xE3, 0x00, 0xD2, 0xFF, 0x2D, 0x1C, 0x0B, 0xFF, 0xF9, 0x0B, 0xE8, 0xFF,
+      0xF9, 0x0B, 0xE8, 0xFF, 0x2D, 0x1C, 0x0B, 0xFF, 0x17, 0x06, 0x00, 0xFF, 0xF9, 0x0B, 0xE8, 0xFF,
+      0x2D, 0x1C, 0x0B, 0xFF, 0x17, 0x06, 0x00, 0xFF, 0x17, 0x06, 0x00, 0xFF, 0x17, 0x06, 0x00, 0xFF,
+      0x2D, 0x1C, 0x0B, 0xFF, 0xF9, 0x0B, 0xE8, 0xFF, 0xE3, 0x00, 0xD2, 0xFF, 0xF9, 0x0B, 0xE8, 0xFF}},
+    // H
+    {{0x6A, 0x14, 0xCA, 0x56, 0x29, 0x17, 0xF5, 0x44},
+     {0xB9, 0x64, 0xCA, 0xFF, 0xB9, 0x64, 0xCA, 0xFF, 0x79, 0x24, 0x8A, 0xFF, 0xBD, 0x35, 0x00, 0xFF,
+      0xB9, 0x64, 0xCA, 0xFF, 0xFD, 0x75, 0x31, 0xFF, 0xFD, 0x75, 0x31, 0xFF, 0x79, 0x24, 0x8A, 0xFF,
+      0x79, 0x24, 0x8A, 0xFF, 0xBD, 0x35, 0x00, 0xFF, 0xBD, 0x35, 0x00, 0xFF, 0xBD, 0x35, 0x00, 0xFF,
+      0xFD, 0x75, 0x31, 0xFF, 0xFD, 0x75, 0x31, 0xFF, 0xB9, 0x64, 0xCA, 0xFF, 0xBD, 0x35, 0x00, 0xFF}},
+    // planar
+    {{0x8A, 0x3C, 0x1C, 0xBF, 0xF3, 0x4E, 0x96, 0x2C},
+     {0x14, 0x3C, 0x65, 0xFF, 0x2E, 0x6A, 0x75, 0xFF, 0x49, 0x98, 0x86, 0xFF, 0x63, 0xC5, 0x96, 0xFF,
+      0x44, 0x59, 0x78, 0xFF, 0x5E, 0x87, 0x89, 0xFF, 0x78, 0xB5, 0x99, 0xFF, 0x93, 0xE3, 0xA9, 0xFF,
+      0x74, 0x77, 0x8C, 0xFF, 0x8E, 0xA4, 0x9C, 0xFF, 0xA8, 0xD2, 0xAC, 0xFF, 0xC2, 0xFF, 0xBC, 0xFF,
+      0xA3, 0x94, 0x9F, 0xFF, 0xBE, 0xC2, 0xAF, 0xFF, 0xD8, 0xEF, 0xBF, 0xFF, 0xF2, 0xFF, 0xD0, 0xFF}},
+    // planar
+    {{0x30, 0xD9, 0xFA, 0xDB, 0x2D, 0xA0, 0xA9, 0x3B},
+     {0x61, 0x58, 0xF7, 0xFF, 0x76, 0x4D, 0xEE, 0xFF, 0x8C, 0x42, 0xE5, 0xFF, 0xA1, 0x37, 0xDC, 0xFF,
+      0x4E, 0x54, 0xF5, 0xFF, 0x63, 0x49, 0xEC, 0xFF, 0x78, 0x3E, 0xE3, 0xFF, 0x8E, 0x33, 0xDA, 0xFF,
+      0x3B, 0x50, 0xF3, 0xFF, 0x50, 0x45, 0xEA, 0xFF, 0x65, 0x3A, 0xE1, 0xFF, 0x7A, 0x2F, 0xD8, 0xFF,
+      0x27, 0x4C, 0xF1, 0xFF, 0x3D, 0x41, 0xE8, 0xFF, 0x52, 0x36, 0xDF, 0xFF, 0x67, 0x2B, 0xD6, 0xFF}},
+};
+
+// EAC alpha blocks, followed by the second color block of RGB_REFERENCES
+const ReferenceBlock RGBA_REFERENCES[] = {
+    // multiplier 1, table 0
+    {{0x7D, 0x10, 0x43, 0x3B, 0x84, 0xDA, 0x08, 0x42,
+      0xDB, 0x83, 0x05, 0x3C, 0x93, 0x03, 0x2B, 0x75},
+     {0xCC, 0x77, 0x00, 0x74, 0xEE, 0x99, 0x11, 0x82, 0x04, 0x00, 0x00, 0x85, 0x8C, 0x04, 0x26, 0x7F,
+      0xD8, 0x83, 0x00, 0x7A, 0xEE, 0x99, 0x11, 0x85, 0x04, 0x00, 0x00, 0x85, 0xFF, 0xEA, 0xFF, 0x77,
+      0xEE, 0x99, 0x11, 0x85, 0xEE, 0x99, 0x11, 0x7A, 0xEA, 0x62, 0x84, 0x7F, 0xEA, 0x62, 0x84, 0x7A,
+      0xE2, 0x8D, 0x05, 0x6E, 0xE2, 0x8D, 0x05, 0x7F, 0xFF, 0xEA, 0xFF, 0x7A, 0x8C, 0x04, 0x26, 0x74}},
+    // multiplier 5, table 6
+    {{0x4E, 0x56, 0xDB, 0xF6, 0x54, 0xB2, 0xD3, 0xF6,
+      0x9A, 0x5B, 0x77, 0x5A, 0x08, 0x6B, 0xB9, 0x23},
+     {0x7F, 0x3D, 0x56, 0x71, 0xA5, 0x63, 0x7C, 0x17, 0xFF, 0xDD, 0xD5, 0x6C, 0xFF, 0xDD, 0xD5, 0x2B,
+      0x7F, 0x3D, 0x56, 0x71, 0x7F, 0x3D, 0x56, 0x2B, 0xCE, 0x94, 0x8C, 0x5D, 0xFF, 0xDD, 0xD5, 0x80,
+      0xA5, 0x63, 0x7C, 0x80, 0x93, 0x51, 0x6A, 0x26, 0xCE, 0x94, 0x8C, 0x6C, 0xCE, 0x94, 0x8C, 0x71,
+      0x93, 0x51, 0x6A, 0x80, 0xA5, 0x63, 0x7C, 0x5D, 0x43, 0x09, 0x01, 0x6C, 0xFF, 0xDD, 0xD5, 0x71}},
+    // multiplier 11, table 13
+    {{0xFA, 0xBD, 0x59, 0xEF, 0xD8, 0x2A, 0x79, 0x70,
+      0x40, 0x13, 0x66, 0x4F, 0xF5, 0xE4, 0xAE, 0x21},
+     {0x5F, 0x2D, 0x80, 0xD9, 0x4B, 0x19, 0x6C, 0xFF, 0x39, 0x07, 0x5A, 0xE4, 0x39, 0x07, 0x5A, 0xFA,
+      0x4B, 0x19, 0x6C, 0xFF, 0x25, 0x00, 0x46, 0xFF, 0x5F, 0x2D, 0x80, 0xD9, 0x25, 0x00, 0x46, 0xFF,
+      0x35, 0x1C, 0x45, 0x8C, 0x35, 0x1C, 0x45, 0x8C, 0x18, 0x00, 0x28, 0xFA, 0x35, 0x1C, 0x45, 0xFF,
+      0x4F, 0x36, 0x5F, 0xFF, 0x35, 0x1C, 0x45, 0xEF, 0x6C, 0x53, 0x7C, 0xFF, 0x18, 0x00, 0x28, 0xEF}},
+    // multiplier 15, table 3
+    {{0x06, 0xF3, 0x1E, 0x6B, 0x10, 0x33, 0xAE, 0x93,
+      0x90, 0x14, 0x70, 0x6B, 0xB8, 0x92, 0x4E, 0x50},
+     {0x2D, 0x1C, 0x0B, 0x00, 0xE3, 0x00, 0xD2, 0x33, 0x2D, 0x1C, 0x0B, 0x00, 0xF9, 0x0B, 0xE8, 0xBA,
+      0xF9, 0x0B, 0xE8, 0xBA, 0x2D, 0x1C, 0x0B, 0x15, 0x17, 0x06, 0x00, 0x15, 0xF9, 0x0B, 0xE8, 0x00,
+      0x2D, 0x1C, 0x0B, 0x15, 0x17, 0x06, 0x00, 0x00, 0x17, 0x06, 0x00, 0xBA, 0x17, 0x06, 0x00, 0x00,
+      0x2D, 0x1C, 0x0B, 0x51, 0xF9, 0x0B, 0xE8, 0x00, 0xE3, 0x00, 0xD2, 0x00, 0xF9, 0x0B, 0xE8, 0x00}},
+};
+
+} // namespace
+
+TEST(CompressedTextureDecoderTest, blocksMatchReferenceOutputs) {
+    uint32_t modeCounts[5] = {};
+    uint8_t actual[64];
+    for (uint32_t i = 0; i < sizeof(RGB_REFERENCES) / sizeof(RGB_REFERENCES[0]); ++i) {
+        const auto &ref = RGB_REFERENCES[i];
+        const ColorMode mode = getColorMode(ref.block);
+        ++modeCounts[static_cast<uint32_t>(mode)];
+        decodeBlock(gfx::Format::ETC2_RGB8, ref.block, actual);
+        EXPECT_EQ(0, memcmp(ref.rgba, actual, sizeof(actual))) << "ETC2 block " << i;
+
+        // ETC1 has the individual and differential modes only
+        if (mode == ColorMode::INDIVIDUAL || mode == ColorMode::DIFFERENTIAL) {
+            decodeBlock(gfx::Format::ETC_RGB8, ref.block, actual);
+            EXPECT_EQ(0, memcmp(ref.rgba, actual, sizeof(actual))) << "ETC1 block " << i;
+        }
+    }
+    for (uint32_t count : modeCounts) {
+        EXPECT_GT(count, 0U);
+    }
+
+    for (uint32_t i = 0; i < sizeof(RGBA_REFERENCES) / sizeof(RGBA_REFERENCES[0]); ++i) {
+        const auto &ref = RGBA_REFERENCES[i];
+        decodeBlock(gfx::Format::ETC2_RGBA8, ref.block, actual);
+        EXPECT_EQ(0, memcmp(ref.rgba, actual, sizeof(actual))) << "EAC block " << i;
+    }
+}
+
+TEST(CompressedTextureDecoderTest, handCheckedBlocks) {
+    uint8_t actual[64];
+
+    // T mode with every index 0 paints the block with the first color
+    const uint8_t tBlock[8] = {0x1C, 0x9A, 0x50, 0x02, 0, 0, 0, 0};
+    ASSERT_EQ(ColorMode::T, getColorMode(tBlock));
+    decodeBlock(gfx::Format::ETC2_RGB8, tBlock, actual);
+    for (uint32_t p = 0; p < 16; ++p) {
+        EXPECT_EQ(0xCC, actual[p * 4 + 0]);
+        EXPECT_EQ(0x99, actual[p * 4 + 1]);
+        EXPECT_EQ(0xAA, actual[p * 4 + 2]);
+        EXPECT_EQ(0xFF, actual[p * 4 + 3]);
+    }
+
+    // EAC alpha with a zero multiplier is the base value everywhere
+    uint8_t alphaBlock[16] = {0x80, 0x0D, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    memcpy(alphaBlock + 8, tBlock, 8);
+    decodeBlock(gfx::Format::ETC2_RGBA8, alphaBlock, actual);
+    for (uint32_t p = 0; p < 16; ++p) {
+        EXPECT_EQ(0x80, actual[p * 4 + 3]);
+    }
+
+    // planar pixel (0, 0) is the origin color
+    auto blocks = randomBytes(1024 * 8, 4);
+    uint32_t planarBlocks = 0;
+    for (uint32_t i = 0; i < 1024; ++i) {
+        const uint8_t *block = blocks.data() + i * 8;
+        if (getColorMode(block) != ColorMode::PLANAR) continue;
+        ++planarBlocks;
+        decodeBlock(gfx::Format::ETC2_RGB8, block, actual);
+        int ro = (block[0] >> 1) & 0x3F;
+        EXPECT_EQ((ro << 2) | (ro >> 4), actual[0]);
+    }
+    EXPECT_GT(planarBlocks, 0U);
+}
+
+TEST(CompressedTextureDecoderTest, imagesMatchReferenceOutputs) {
+    // odd sizes exercise the edge blocks, the large one the parallel path
+    const uint32_t sizes[][2] = {{1, 1}, {37, 21}, {1024, 1030}};
+    const uint32_t refCount = sizeof(RGBA_REFERENCES) / sizeof(RGBA_REFERENCES[0]);
+    for (const auto &size : sizes) {
+        const uint32_t width = size[0];
+        const uint32_t height = size[1];
+        const uint32_t stride = width * 4 + 12;
+        const uint32_t blocksX = (width + 3) / 4;
+        const uint32_t blocksY = (height + 3) / 4;
+        const uint32_t encodedSize = CompressedTextureDecoder::getEncodedSize(gfx::Format::ETC2_RGBA8, width, height);
+        ASSERT_EQ(blocksX * blocksY * 16, encodedSize);
+
+        std::vector<uint8_t> encoded(encodedSize);
+        for (uint32_t by = 0; by < blocksY; ++by) {
+            for (uint32_t bx = 0; bx < blocksX; ++bx) {
+                memcpy(encoded.data() + (by * blocksX + bx) * 16, RGBA_REFERENCES[(bx + by) % refCount].block, 16);
+            }
+        }
+
+        std::vector<uint8_t> actual(stride * height, 0xCD);
+        ASSERT_TRUE(CompressedTextureDecoder::decode(gfx::Format::ETC2_RGBA8, encoded.data(), encodedSize, width, height, actual.data(), stride));
+        uint32_t mismatches = 0;
+        for (uint32_t y = 0; y < height; ++y) {
+            const uint8_t *row = actual.data() + y * stride;
+            for (uint32_t x = 0; x < width; ++x) {
+                const auto &ref = RGBA_REFERENCES[(x / 4 + y / 4) % refCount];
+                mismatches += memcmp(row + x * 4, ref.rgba + (y % 4) * 16 + (x % 4) * 4, 4) != 0;
+            }
+            for (uint32_t i = width * 4; i < stride; ++i) {
+                mismatches += row[i] != 0xCD;
+            }
+        }
+        EXPECT_EQ(0U, mismatches) << width << "x" << height;
+
+        EXPECT_FALSE(CompressedTextureDecoder::decode(gfx::Format::ETC2_RGBA8, encoded.data(), encodedSize - 1, width, height, actual.data(), stride));
+    }
+    EXPECT_FALSE(CompressedTextureDecoder::isSupported(gfx::Format::ASTC_RGBA_4X4));
+}
+
+TEST(CompressedTextureDecoderTest, rgba8IsCopied) {
+    const uint32_t width = 37;
+    const uint32_t height = 21;
+    const uint32_t stride = width * 4 + 12;
+    ASSERT_TRUE(CompressedTextureDecoder::isSupported(gfx::Format::RGBA8));
+    ASSERT_EQ(nullptr, CompressedTextureDecoder::getBlockDecoder(gfx::Format::RGBA8));
+    const uint32_t size = CompressedTextureDecoder::getEncodedSize(gfx::Format::RGBA8, width, height);
+    ASSERT_EQ(width * height * 4, size);
+
+    auto pixels = randomBytes(size, 6);
+    std::vector<uint8_t> actual(stride * height, 0xCD);
+    ASSERT_TRUE(CompressedTextureDecoder::decode(gfx::Format::RGBA8, pixels.data(), size, width, height, actual.data(), stride));
+    for (uint32_t y = 0; y < height; ++y) {
+        const uint8_t *row = actual.data() + y * stride;
+        EXPECT_EQ(0, memcmp(pixels.data() + y * width * 4, row, width * 4)) << "row " << y;
+        for (uint32_t i = width * 4; i < stride; ++i) {
+            EXPECT_EQ(0xCD, row[i]);
+        }
+    }
+    EXPECT_FALSE(CompressedTextureDecoder::decode(gfx::Format::RGBA8, pixels.data(), size - 1, width, height, actual.data(), stride));
+}
+
+TEST(CompressedTextureDecoderBenchmark, DISABLED_etc2) {
+    const struct {
+        const char *name;
+        gfx::Format format;
+        uint32_t pkmFormat;
+    } cases[] = {
+        {"ETC2_RGB8", gfx::Format::ETC2_RGB8, ETC2_RGB_NO_MIPMAPS},
+        {"ETC2_RGBA8", gfx::Format::ETC2_RGBA8, ETC2_RGBA_NO_MIPMAPS},
+    };
+    const uint32_t stride = BENCHMARK_SIZE * 4;
+    std::vector<uint8_t> decoded(stride * BENCHMARK_SIZE);
+    for (const auto &c : cases) {
+        const uint32_t encodedSize = CompressedTextureDecoder::getEncodedSize(c.format, BENCHMARK_SIZE, BENCHMARK_SIZE);
+        auto encoded = randomBytes(encodedSize, 5);
+
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < BENCHMARK_ROUNDS; ++i) {
+            etc2_decode_image(encoded.data(), c.pkmFormat, decoded.data(), BENCHMARK_SIZE, BENCHMARK_SIZE, stride);
+        }
+        const double referenceMs = elapsedMs(start) / BENCHMARK_ROUNDS;
+
+        auto decoder = CompressedTextureDecoder::getBlockDecoder(c.format);
+        const uint32_t blockBytes = encodedSize / (BENCHMARK_SIZE / 4 * BENCHMARK_SIZE / 4);
+        start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < BENCHMARK_ROUNDS; ++i) {
+            const uint8_t *block = encoded.data();
+            for (uint32_t y = 0; y < BENCHMARK_SIZE; y += 4) {
+                for (uint32_t x = 0; x < BENCHMARK_SIZE; x += 4, block += blockBytes) {
+                    decoder(block, decoded.data() + y * stride + x * 4, stride);
+                }
+            }
+        }
+        const double singleThreadMs = elapsedMs(start) / BENCHMARK_ROUNDS;
+
+        start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < BENCHMARK_ROUNDS; ++i) {
+            CompressedTextureDecoder::decode(c.format, encoded.data(), encodedSize, BENCHMARK_SIZE, BENCHMARK_SIZE, decoded.data(), stride);
+        }
+        const double parallelMs = elapsedMs(start) / BENCHMARK_ROUNDS;
+
+        reportBenchmark("%-10s %ux%u, reference %8.3f ms, block decoder %8.3f ms, parallel %8.3f ms",
+                        c.name, BENCHMARK_SIZE, BENCHMARK_SIZE, referenceMs, singleThreadMs, parallelMs);
+    }
+}
@@ -0,0 +1,185 @@
+/****************************************************************************
+ Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <zlib.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include "cocos/base/Ptr.h"
+#include "cocos/base/memory/Memory.h"
+#include "cocos/base/std/container/vector.h"
+#include "cocos/platform/Image.h"
+#include "cocos/platform/ImageDecodeService.h"
+#include "gtest/gtest.h"
+
+using namespace cc;
+
+namespace {
+
+constexpr int WIDTH = 64;
+constexpr int HEIGHT = 50;
+constexpr uint32_t ROW_BYTES = WIDTH * 4;
+
+void putU32BE(ccstd::vector<uint8_t> *out, uint32_t value) {
+    out->push_back(static_cast<uint8_t>(value >> 24));
+    out->push_back(static_cast<uint8_t>(value >> 16));
+    out->push_back(static_cast<uint8_t>(value >> 8));
+    out->push_back(static_cast<uint8_t>(value));
+}
+
+void putChunk(ccstd::vector<uint8_t> *out, const char *type, const ccstd::vector<uint8_t> &data) {
+    putU32BE(out, static_cast<uint32_t>(data.size()));
+    const size_t typeOffset = out->size();
+    out->insert(out->end(), type, type + 4);
+    out->insert(out->end(), data.begin(), data.end());
+    putU32BE(out, static_cast<uint32_t>(crc32(0, out->data() + typeOffset, static_cast<uInt>(data.size() + 4))));
+}
+
+ccstd::vector<uint8_t> makePixels(uint32_t seed) {
+    ccstd::vector<uint8_t> pixels(ROW_BYTES * HEIGHT);
+    for (size_t i = 0; i < pixels.size(); ++i) {
+        pixels[i] = static_cast<uint8_t>(i * 31 + seed);
+    }
+    return pixels;
+}
+
+// a non-interlaced 8 bit RGBA png with no filtering
+ccstd::vector<uint8_t> encodePng(const ccstd::vector<uint8_t> &pixels) {
+    ccstd::vector<uint8_t> png{0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+
+    ccstd::vector<uint8_t> header;
+    putU32BE(&header, WIDTH);
+    putU32BE(&header, HEIGHT);
+    header.insert(header.end(), {8, 6, 0, 0, 0});
+    putChunk(&png, "IHDR", header);
+
+    ccstd::vector<uint8_t> raw;
+    for (int y = 0; y < HEIGHT; ++y) {
+        raw.push_back(0);
+        raw.insert(raw.end(), pixels.begin() + y * ROW_BYTES, pixels.begin() + (y + 1) * ROW_BYTES);
+    }
+    uLongf compressedSize = compressBound(static_cast<uLong>(raw.size()));
+    ccstd::vector<uint8_t> compressed(compressedSize);
+    compress(compressed.data(), &compressedSize, raw.data(), static_cast<uLong>(raw.size()));
+    compressed.resize(compressedSize);
+    putChunk(&png, "IDAT", compressed);
+    putChunk(&png, "IEND", {});
+    return png;
+}
+
+} // namespace
+
+TEST(ImageDecodeTest, readsHeaderWithoutPixels) {
+    const auto png = encodePng(makePixels(1));
+    IntrusivePtr<Image> image{ccnew Image()};
+    ASSERT_TRUE(image->initWithImageHeader(png.data(), static_cast<uint32_t>(png.size())));
+    EXPECT_EQ(image->getWidth(), WIDTH);
+    EXPECT_EQ(image->getHeight(), HEIGHT);
+    EXPECT_EQ(image->getRenderFormat(), gfx::Format::RGBA8);
+    EXPECT_EQ(image->getDataLen(), ROW_BYTES * HEIGHT);
+    EXPECT_EQ(image->getData(), nullptr);
+}
+
+TEST(ImageDecodeTest, decodesIntoCallerMemory) {
+    const auto pixels = makePixels(2);
+    const auto png = encodePng(pixels);
+    ccstd::vector<uint8_t> dst(pixels.size());
+    IntrusivePtr<Image> image{ccnew Image()};
+    ASSERT_TRUE(image->initWithImageData(png.data(), static_cast<uint32_t>(png.size()), dst.data(), static_cast<uint32_t>(dst.size())));
+    EXPECT_EQ(image->getData(), nullptr);
+    EXPECT_EQ(dst, pixels);
+
+    // too small a destination is refused
+    EXPECT_FALSE(image->initWithImageData(png.data(), static_cast<uint32_t>(png.size()), dst.data(), static_cast<uint32_t>(dst.size() - 1)));
+}
+
+TEST(ImageDecodeTest, streamsRowsInSlices) {
+    const auto pixels = makePixels(3);
+    const auto png = encodePng(pixels);
+    ccstd::vector<uint8_t> collected;
+    int slices = 0;
+    int nextRow = 0;
+    IntrusivePtr<Image> image{ccnew Image()};
+    const bool ok = image->decodeRows(png.data(), static_cast<uint32_t>(png.size()), 7, [&](const unsigned char *rows, uint32_t rowBytes, int firstRow, int rowCount) {
+        EXPECT_EQ(rowBytes, ROW_BYTES);
+        EXPECT_EQ(firstRow, nextRow);
+        EXPECT_LE(rowCount, 7);
+        nextRow = firstRow + rowCount;
+        collected.insert(collected.end(), rows, rows + rowBytes * rowCount);
+        ++slices;
+        return true;
+    });
+    EXPECT_TRUE(ok);
+    EXPECT_EQ(slices, (HEIGHT + 6) / 7);
+    EXPECT_EQ(collected, pixels);
+    EXPECT_EQ(image->getData(), nullptr);
+
+    slices = 0;
+    EXPECT_FALSE(image->decodeRows(png.data(), static_cast<uint32_t>(png.size()), 7, [&](const unsigned char * /*rows*/, uint32_t /*rowBytes*/, int /*firstRow*/, int /*rowCount*/) {
+        return ++slices < 2;
+    }));
+    EXPECT_EQ(slices, 2);
+}
+
+TEST(ImageDecodeTest, serviceDecodesOnWorkerThreads) {
+    constexpr uint32_t IMAGE_COUNT = 16;
+    ccstd::vector<ccstd::vector<uint8_t>> pixels;
+    ccstd::vector<ccstd::vector<uint8_t>> dsts(IMAGE_COUNT);
+    std::atomic<uint32_t> completed{0};
+    std::atomic<uint32_t> matching{0};
+    const auto callerThread = std::this_thread::get_id();
+
+    ImageDecodeService service{3};
+    ccstd::vector<ImageDecodeService::DecodeRequest> requests;
+    for (uint32_t i = 0; i < IMAGE_COUNT; ++i) {
+        pixels.push_back(makePixels(i));
+        const auto png = encodePng(pixels.back());
+        ImageDecodeService::DecodeRequest request;
+        request.data.copy(png.data(), static_cast<uint32_t>(png.size()));
+        if (i % 2 == 0) {
+            dsts[i].resize(pixels.back().size());
+            request.dst = dsts[i].data();
+            request.dstLen = static_cast<uint32_t>(dsts[i].size());
+        }
+        request.callback = [&, i](Image *image) {
+            const bool decoded = image && std::this_thread::get_id() != callerThread;
+            const bool same = i % 2 == 0 ? dsts[i] == pixels[i] : decoded && memcmp(image->getData(), pixels[i].data(), pixels[i].size()) == 0;
+            if (decoded && same) {
+                ++matching;
+            }
+            ++completed;
+        };
+        requests.push_back(std::move(request));
+    }
+    service.decodeBatch(std::move(requests));
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (completed < IMAGE_COUNT && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(completed, IMAGE_COUNT);
+    EXPECT_EQ(matching, IMAGE_COUNT);
+}
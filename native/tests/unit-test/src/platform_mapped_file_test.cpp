@@ -0,0 +1,102 @@
+/****************************************************************************
+ Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <cstdio>
+#include <cstring>
+#include "cocos/base/std/container/string.h"
+#include "cocos/base/std/container/vector.h"
+#include "gtest/gtest.h"
+#include "cocos/platform/MappedFile.h"
+
+using namespace cc;
+
+namespace {
+
+ccstd::vector<uint8_t> writeFile(const ccstd::string &path, size_t size) {
+    ccstd::vector<uint8_t> contents(size);
+    for (size_t i = 0; i < size; ++i) {
+        contents[i] = static_cast<uint8_t>(i * 7 + 3);
+    }
+    FILE *fp = fopen(path.c_str(), "wb");
+    if (fp) {
+        fwrite(contents.data(), 1, contents.size(), fp);
+        fclose(fp);
+    }
+    return contents;
+}
+
+void expectContents(const MappedFile &file, const ccstd::vector<uint8_t> &contents) {
+    ASSERT_EQ(file.getSize(), contents.size());
+    EXPECT_EQ(memcmp(file.getBytes(), contents.data(), contents.size()), 0);
+}
+
+} // namespace
+
+TEST(MappedFileTest, readsSmallFilesIntoMemory) {
+    const ccstd::string path{"mapped_file_test_small.bin"};
+    const auto contents = writeFile(path, 1000);
+    auto file = MappedFile::open(path);
+    ASSERT_NE(file, nullptr);
+    expectContents(*file, contents);
+    remove(path.c_str());
+}
+
+TEST(MappedFileTest, mapsLargeFiles) {
+    const ccstd::string path{"mapped_file_test_large.bin"};
+    const auto contents = writeFile(path, 1024 * 1024 + 13);
+    auto file = MappedFile::open(path);
+    ASSERT_NE(file, nullptr);
+    expectContents(*file, contents);
+#if (CC_PLATFORM != CC_PLATFORM_WINDOWS)
+    EXPECT_TRUE(file->isMapped());
+    // the mapping is private, writing to it leaves the file untouched
+    const_cast<uint8_t *>(file->getBytes())[0] = static_cast<uint8_t>(contents[0] + 1);
+    auto reopened = MappedFile::open(path);
+    ASSERT_NE(reopened, nullptr);
+    EXPECT_EQ(reopened->getBytes()[0], contents[0]);
+#endif
+    remove(path.c_str());
+}
+
+TEST(MappedFileTest, emptyFile) {
+    const ccstd::string path{"mapped_file_test_empty.bin"};
+    writeFile(path, 0);
+    auto file = MappedFile::open(path);
+    ASSERT_NE(file, nullptr);
+    EXPECT_EQ(file->getSize(), 0);
+    remove(path.c_str());
+}
+
+TEST(MappedFileTest, missingFile) {
+    EXPECT_EQ(MappedFile::open("mapped_file_test_missing.bin"), nullptr);
+}
+
+TEST(MappedFileTest, wrapsData) {
+    Data data;
+    data.copy(reinterpret_cast<const unsigned char *>("abc"), 3);
+    MappedFile file{std::move(data)};
+    EXPECT_FALSE(file.isMapped());
+    expectContents(file, {'a', 'b', 'c'});
+}
@@ -0,0 +1,95 @@
+/****************************************************************************
+ Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#include <random>
+#include "cocos/core/geometry/AABB.h"
+#include "cocos/core/geometry/Frustum.h"
+#include "cocos/math/Mat4.h"
+#include "cocos/scene/ModelBoundsArray.h"
+#include "gtest/gtest.h"
+
+using namespace cc;
+
+TEST(ModelBoundsArrayTest, cullFrustumMatchesAABB) {
+    constexpr uint32_t COUNT = 1027; // not a multiple of the simd width
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> position(-60.0F, 60.0F);
+    std::uniform_real_distribution<float> extent(0.1F, 5.0F);
+
+    geometry::Frustum frustum;
+    Mat4 transform;
+    Mat4::createTranslation(Vec3{1.0F, 2.0F, 10.0F}, &transform);
+    geometry::Frustum::createPerspective(&frustum, 1.0F, 1.5F, 0.1F, 50.0F, transform);
+
+    scene::ModelBoundsArray boundsArray;
+    boundsArray.resize(COUNT);
+    ccstd::vector<geometry::AABB> bounds(COUNT);
+    for (uint32_t i = 0; i < COUNT; ++i) {
+        bounds[i].set(Vec3{position(rng), position(rng), position(rng)}, Vec3{extent(rng), extent(rng), extent(rng)});
+        boundsArray.setBounds(i, &bounds[i]);
+    }
+
+    ccstd::vector<uint8_t> results(COUNT);
+    boundsArray.cullFrustum(frustum, 0, COUNT, results.data());
+    uint32_t numVisible = 0;
+    for (uint32_t i = 0; i < COUNT; ++i) {
+        EXPECT_EQ(results[i] != 0, bounds[i].aabbFrustum(frustum));
+        numVisible += results[i];
+    }
+    EXPECT_GT(numVisible, 0U);
+    EXPECT_LT(numVisible, COUNT);
+
+    // unaligned sub range
+    ccstd::vector<uint8_t> subResults(COUNT);
+    boundsArray.cullFrustum(frustum, 3, 518, subResults.data());
+    for (uint32_t i = 3; i < 518; ++i) {
+        EXPECT_EQ(subResults[i - 3], results[i]);
+    }
+}
+
+TEST(ModelBoundsArrayTest, boundlessIsNeverCulled) {
+    geometry::Frustum frustum;
+    geometry::Frustum::createPerspective(&frustum, 1.0F, 1.0F, 0.1F, 10.0F, Mat4::IDENTITY);
+
+    scene::ModelBoundsArray boundsArray;
+    boundsArray.resize(5);
+    geometry::AABB farAway{1000.0F, 1000.0F, 1000.0F, 1.0F, 1.0F, 1.0F};
+    for (uint32_t i = 0; i < 5; ++i) {
+        boundsArray.setBounds(i, &farAway);
+    }
+    boundsArray.setBounds(2, nullptr);
+
+    uint8_t results[5]{};
+    boundsArray.cullFrustum(frustum, 0, 5, results);
+    EXPECT_EQ(results[0], 0);
+    EXPECT_EQ(results[1], 0);
+    EXPECT_EQ(results[2], 1);
+    EXPECT_EQ(results[3], 0);
+    EXPECT_EQ(results[4], 0);
+
+    boundsArray.erase(2);
+    EXPECT_EQ(boundsArray.size(), 4U);
+    boundsArray.cullFrustum(frustum, 0, 4, results);
+    EXPECT_EQ(results[2], 0);
+}
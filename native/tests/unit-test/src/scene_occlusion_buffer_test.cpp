@@ -0,0 +1,154 @@
+/****************************************************************************
+ Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#include <algorithm>
+#include <cfloat>
+#include "cocos/core/geometry/AABB.h"
+#include "cocos/math/Mat4.h"
+#include "cocos/scene/OcclusionBuffer.h"
+#include "gtest/gtest.h"
+
+using namespace cc;
+
+namespace {
+
+// camera at the origin looking down -z
+Mat4 makeViewProj() {
+    Mat4 proj;
+    Mat4::createPerspective(1.0F, 2.0F, 0.1F, 100.0F, true, -1.0F, 1.0F, 0, &proj);
+    return proj;
+}
+
+// a square facing the camera at depth z
+void rasterizeWall(scene::OcclusionBuffer &buffer, float z, float halfSize) {
+    const float positions[] = {
+        -halfSize, -halfSize, z,
+        halfSize, -halfSize, z,
+        halfSize, halfSize, z,
+        -halfSize, halfSize, z,
+    };
+    const uint16_t indices[] = {0, 1, 2, 0, 2, 3};
+    buffer.rasterize(Mat4::IDENTITY, positions, 3, 4, indices, 6);
+}
+
+geometry::AABB makeBox(const Vec3 &center, float halfExtent) {
+    geometry::AABB box;
+    box.set(center, Vec3{halfExtent, halfExtent, halfExtent});
+    return box;
+}
+
+} // namespace
+
+TEST(OcclusionBufferTest, emptyBufferOccludesNothing) {
+    scene::OcclusionBuffer buffer;
+    buffer.begin(makeViewProj());
+    buffer.end();
+    EXPECT_FALSE(buffer.isOccluded(makeBox({0.0F, 0.0F, -10.0F}, 1.0F)));
+}
+
+TEST(OcclusionBufferTest, wallHidesBoxesBehindIt) {
+    scene::OcclusionBuffer buffer;
+    buffer.begin(makeViewProj());
+    rasterizeWall(buffer, -5.0F, 4.0F);
+    buffer.end();
+
+    EXPECT_TRUE(buffer.isOccluded(makeBox({0.0F, 0.0F, -10.0F}, 1.0F)));
+    EXPECT_TRUE(buffer.isOccluded(makeBox({1.0F, -1.0F, -20.0F}, 0.5F)));
+    // in front of the wall
+    EXPECT_FALSE(buffer.isOccluded(makeBox({0.0F, 0.0F, -3.0F}, 1.0F)));
+    // intersects the wall
+    EXPECT_FALSE(buffer.isOccluded(makeBox({0.0F, 0.0F, -5.0F}, 1.0F)));
+    // sticks out beside the wall
+    EXPECT_FALSE(buffer.isOccluded(makeBox({9.0F, 0.0F, -10.0F}, 1.0F)));
+    // reaches behind the camera
+    EXPECT_FALSE(buffer.isOccluded(makeBox({0.0F, 0.0F, 0.0F}, 1.0F)));
+}
+
+TEST(OcclusionBufferTest, clipsTrianglesAtNearPlane) {
+    scene::OcclusionBuffer buffer;
+    buffer.begin(makeViewProj());
+    // a floor reaching behind the camera
+    const float positions[] = {
+        -50.0F, -1.0F, 10.0F,
+        50.0F, -1.0F, 10.0F,
+        50.0F, -1.0F, -50.0F,
+        -50.0F, -1.0F, -50.0F,
+    };
+    const uint32_t indices[] = {0, 1, 2, 0, 2, 3};
+    buffer.rasterize(Mat4::IDENTITY, positions, 3, 4, indices, 6);
+    buffer.end();
+
+    // below the floor
+    EXPECT_TRUE(buffer.isOccluded(makeBox({0.0F, -5.0F, -20.0F}, 1.0F)));
+    // above the floor
+    EXPECT_FALSE(buffer.isOccluded(makeBox({0.0F, 1.0F, -20.0F}, 0.5F)));
+}
+
+TEST(OcclusionBufferTest, hierarchyKeepsFarthestDepth) {
+    scene::OcclusionBuffer buffer;
+    buffer.begin(makeViewProj(), 37, 19); // not a power of two, nor a multiple of the simd width
+    rasterizeWall(buffer, -5.0F, 2.0F);
+    // a closer wall in front of the first one, non-indexed
+    const float positions[] = {
+        -1.0F, -1.0F, -3.0F,
+        1.0F, -1.0F, -3.0F,
+        1.0F, 1.0F, -3.0F,
+    };
+    buffer.rasterize(Mat4::IDENTITY, positions, 3, 3);
+    buffer.end();
+
+    ASSERT_GT(buffer.getLevelCount(), 1U);
+    EXPECT_EQ(buffer.getDepth(buffer.getLevelCount() - 1, 0, 0), FLT_MAX);
+    uint32_t width = buffer.getWidth();
+    uint32_t height = buffer.getHeight();
+    for (uint32_t level = 1; level < buffer.getLevelCount(); ++level) {
+        const uint32_t parentWidth = (width + 1) / 2;
+        const uint32_t parentHeight = (height + 1) / 2;
+        for (uint32_t y = 0; y < parentHeight; ++y) {
+            for (uint32_t x = 0; x < parentWidth; ++x) {
+                float expected = -FLT_MAX;
+                for (uint32_t i = 0; i < 4; ++i) {
+                    const uint32_t cx = std::min(x * 2 + (i & 1), width - 1);
+                    const uint32_t cy = std::min(y * 2 + (i >> 1), height - 1);
+                    expected = std::max(expected, buffer.getDepth(level - 1, cx, cy));
+                }
+                EXPECT_EQ(buffer.getDepth(level, x, y), expected);
+            }
+        }
+        width = parentWidth;
+        height = parentHeight;
+    }
+
+    // the same input always gives the same buffer
+    scene::OcclusionBuffer other;
+    other.begin(makeViewProj(), 37, 19);
+    rasterizeWall(other, -5.0F, 2.0F);
+    other.rasterize(Mat4::IDENTITY, positions, 3, 3);
+    other.end();
+    for (uint32_t y = 0; y < buffer.getHeight(); ++y) {
+        for (uint32_t x = 0; x < buffer.getWidth(); ++x) {
+            EXPECT_EQ(buffer.getDepth(0, x, y), other.getDepth(0, x, y));
+        }
+    }
+}
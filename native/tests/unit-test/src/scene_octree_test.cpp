@@ -0,0 +1,258 @@
+/****************************************************************************
+ Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#include "cocos/base/Ptr.h"
+#include "cocos/scene/Model.h"
+#include "cocos/scene/Octree.h"
+#include "gtest/gtest.h"
+
+using namespace cc;
+
+// Deferred reinsertion of moved models, Octree::update only lists them and
+// Octree::flushUpdates reinserts them once per frame. Also covers loose node
+// bounds, growing the root to fit models and reusing pooled nodes.
+
+namespace {
+
+IntrusivePtr<scene::Model> createModel(const Vec3 &center) {
+    IntrusivePtr<scene::Model> model = ccnew scene::Model();
+    model->createBoundingShape(center - Vec3{0.5F, 0.5F, 0.5F}, center + Vec3{0.5F, 0.5F, 0.5F});
+    return model;
+}
+
+void moveModel(scene::Model *model, const Vec3 &center) {
+    model->getWorldBounds()->setCenter(center);
+}
+
+// the root box is [-74, 64] on every axis, so its center planes lie at -5 and leaf cells are 17.25 wide
+void initOctree(scene::Octree &octree, bool loose = false) {
+    scene::OctreeInfo info;
+    info.setEnabled(true);
+    info.setMinPos(Vec3{-64.0F, -64.0F, -64.0F});
+    info.setMaxPos(Vec3{64.0F, 64.0F, 64.0F});
+    info.setDepth(4);
+    info.setLoose(loose);
+    octree.initialize(info);
+}
+
+} // namespace
+
+TEST(OctreeTest, updatesAreDeferredUntilFlush) {
+    scene::Octree octree;
+    initOctree(octree);
+
+    auto model = createModel(Vec3{-40.0F, -40.0F, -40.0F});
+    octree.insert(model);
+    scene::OctreeNode *oldNode = model->getOctreeNode();
+    ASSERT_NE(oldNode, nullptr);
+    EXPECT_EQ(model->getOctreePendingIndex(), -1);
+
+    // listed once however often it moves in a frame
+    moveModel(model, Vec3{40.0F, 40.0F, 40.0F});
+    octree.update(model);
+    octree.update(model);
+    EXPECT_EQ(model->getOctreePendingIndex(), 0);
+    EXPECT_EQ(model->getOctreeNode(), oldNode);
+
+    // the models are in opposite octants, so in different leaves
+    octree.flushUpdates();
+    EXPECT_EQ(model->getOctreePendingIndex(), -1);
+    EXPECT_NE(model->getOctreeNode(), nullptr);
+    EXPECT_NE(model->getOctreeNode(), oldNode);
+
+    octree.remove(model);
+}
+
+TEST(OctreeTest, removedModelsAreSkippedByFlush) {
+    scene::Octree octree;
+    initOctree(octree);
+
+    auto kept = createModel(Vec3{-40.0F, -40.0F, -40.0F});
+    auto removed = createModel(Vec3{-30.0F, -30.0F, -30.0F});
+    octree.insert(kept);
+    octree.insert(removed);
+    scene::OctreeNode *keptNode = kept->getOctreeNode();
+
+    moveModel(removed, Vec3{30.0F, 30.0F, 30.0F});
+    moveModel(kept, Vec3{40.0F, 40.0F, 40.0F});
+    octree.update(removed);
+    octree.update(kept);
+    EXPECT_EQ(kept->getOctreePendingIndex(), 1);
+
+    // the model is released before the flush, which must not touch it
+    octree.remove(removed);
+    EXPECT_EQ(removed->getOctreePendingIndex(), -1);
+    EXPECT_EQ(removed->getOctreeNode(), nullptr);
+    removed = nullptr;
+
+    octree.flushUpdates();
+    EXPECT_EQ(kept->getOctreePendingIndex(), -1);
+    EXPECT_NE(kept->getOctreeNode(), nullptr);
+    EXPECT_NE(kept->getOctreeNode(), keptNode);
+
+    // a model inserted again after its removal is listed anew
+    auto readded = createModel(Vec3{-20.0F, -20.0F, -20.0F});
+    octree.insert(readded);
+    octree.update(readded);
+    octree.remove(readded);
+    octree.insert(readded);
+    scene::OctreeNode *readdedNode = readded->getOctreeNode();
+    moveModel(readded, Vec3{20.0F, 20.0F, 20.0F});
+    octree.update(readded);
+    EXPECT_EQ(readded->getOctreePendingIndex(), 1);
+    octree.flushUpdates();
+    EXPECT_NE(readded->getOctreeNode(), nullptr);
+    EXPECT_NE(readded->getOctreeNode(), readdedNode);
+
+    octree.remove(kept);
+    octree.remove(readded);
+}
+
+TEST(OctreeTest, disablingDropsPendingUpdates) {
+    scene::Octree octree;
+    initOctree(octree);
+
+    auto model = createModel(Vec3{-40.0F, -40.0F, -40.0F});
+    octree.insert(model);
+    octree.update(model);
+    ASSERT_EQ(model->getOctreePendingIndex(), 0);
+
+    octree.setEnabled(false);
+    EXPECT_EQ(model->getOctreePendingIndex(), -1);
+}
+
+TEST(OctreeTest, looseNodesHoldModelsAcrossCellBoundaries) {
+    for (const bool loose : {false, true}) {
+        scene::Octree octree;
+        initOctree(octree, loose);
+
+        // only the root holds a model this large
+        IntrusivePtr<scene::Model> large = ccnew scene::Model();
+        large->createBoundingShape(Vec3{-60.0F, -60.0F, -60.0F}, Vec3{60.0F, 60.0F, 60.0F});
+        octree.insert(large);
+        scene::OctreeNode *root = large->getOctreeNode();
+        ASSERT_NE(root, nullptr);
+
+        // straddles the center planes of the root, a loose child still takes it
+        auto straddling = createModel(Vec3{-5.0F, -5.0F, -5.0F});
+        octree.insert(straddling);
+        EXPECT_EQ(straddling->getOctreeNode() == root, !loose);
+
+        // the center of a leaf crosses the root's center plane, but the model stays in the leaf's loose bounds
+        auto model = createModel(Vec3{3.6F, 3.6F, 3.6F});
+        octree.insert(model);
+        scene::OctreeNode *leaf = model->getOctreeNode();
+        ASSERT_NE(leaf, nullptr);
+        ASSERT_NE(leaf, root);
+        moveModel(model, Vec3{-5.3F, 3.6F, 3.6F});
+        octree.update(model);
+        octree.flushUpdates();
+        EXPECT_EQ(model->getOctreeNode(), loose ? leaf : root);
+
+        // beyond the loose bounds the model moves on to where it would be inserted
+        auto reference = createModel(Vec3{-40.0F, 3.6F, 3.6F});
+        octree.insert(reference);
+        moveModel(model, Vec3{-40.0F, 3.6F, 3.6F});
+        octree.update(model);
+        octree.flushUpdates();
+        EXPECT_NE(model->getOctreeNode(), root);
+        EXPECT_EQ(model->getOctreeNode(), reference->getOctreeNode());
+
+        octree.remove(large);
+        octree.remove(straddling);
+        octree.remove(model);
+        octree.remove(reference);
+    }
+}
+
+TEST(OctreeTest, growsToFitModelsOutsideTheBounds) {
+    scene::Octree octree;
+    initOctree(octree);
+
+    auto inside = createModel(Vec3{-40.0F, -40.0F, -40.0F});
+    octree.insert(inside);
+
+    // the root doubles twice around its center, one level deeper each time
+    auto outside = createModel(Vec3{200.0F, 0.0F, 0.0F});
+    octree.insert(outside);
+    EXPECT_NE(outside->getOctreeNode(), nullptr);
+    EXPECT_NE(inside->getOctreeNode(), nullptr);
+    EXPECT_EQ(octree.getMaxDepth(), 6);
+
+    // moving out of the grown bounds grows them again
+    moveModel(inside, Vec3{-1000.0F, 0.0F, 0.0F});
+    octree.update(inside);
+    octree.flushUpdates();
+    EXPECT_NE(inside->getOctreeNode(), nullptr);
+    EXPECT_NE(outside->getOctreeNode(), nullptr);
+    EXPECT_GT(octree.getMaxDepth(), 6);
+
+    // far beyond the limit of doublings the model is left out
+    auto unreachable = createModel(Vec3{1.0e12F, 0.0F, 0.0F});
+    octree.insert(unreachable);
+    EXPECT_EQ(unreachable->getOctreeNode(), nullptr);
+
+    octree.remove(inside);
+    octree.remove(outside);
+}
+
+TEST(OctreeTest, growingKeepsADeeperMaxDepth) {
+    scene::Octree octree;
+    initOctree(octree);
+    octree.setMaxDepth(scene::OCTREE_MAX_DEPTH + 4);
+
+    auto outside = createModel(Vec3{200.0F, 0.0F, 0.0F});
+    octree.insert(outside);
+    EXPECT_NE(outside->getOctreeNode(), nullptr);
+    EXPECT_EQ(octree.getMaxDepth(), scene::OCTREE_MAX_DEPTH + 4);
+
+    octree.remove(outside);
+}
+
+TEST(OctreeTest, removedNodesAreReusedFromThePool) {
+    scene::Octree octree;
+    initOctree(octree);
+
+    auto kept = createModel(Vec3{40.0F, 40.0F, 40.0F});
+    octree.insert(kept);
+    auto model = createModel(Vec3{-40.0F, -40.0F, -40.0F});
+    octree.insert(model);
+    scene::OctreeNode *leaf = model->getOctreeNode();
+    ASSERT_NE(leaf, nullptr);
+
+    // the emptied branch goes back to the free list, and the same insert takes it again
+    octree.remove(model);
+    EXPECT_EQ(model->getOctreeNode(), nullptr);
+    octree.insert(model);
+    EXPECT_EQ(model->getOctreeNode(), leaf);
+
+    for (int i = 0; i < 8; ++i) {
+        octree.remove(model);
+        octree.insert(model);
+    }
+    EXPECT_EQ(model->getOctreeNode(), leaf);
+
+    octree.remove(kept);
+    octree.remove(model);
+}
@@ -0,0 +1,218 @@
+/****************************************************************************
+ Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include <algorithm>
+#include <vector>
+#include "editor-support/spine-creator-support/SkeletonCache.h"
+#include "gtest/gtest.h"
+
+using cc::middleware::Color4B;
+using cc::middleware::IOBuffer;
+using cc::middleware::V3F_T2F_C4B_C4B;
+using spine::SkeletonCache;
+
+// Baked frames are quantized and delta encoded into the animation arena,
+// decoding them has to give back the baked vertices within the quantization step.
+
+namespace {
+
+// half a quantization step, plus float rounding of the decoded values
+constexpr float POSITION_TOLERANCE = 0.5F / SkeletonCache::PositionScale + 1e-4F;
+constexpr float UV_TOLERANCE = 0.5F / SkeletonCache::UVScale + 1e-6F;
+// the render buffer already holds other vertices, indices are rebased past them
+constexpr uint32_t BASE_VERTEX = 100;
+
+struct BakedFrame {
+    std::vector<V3F_T2F_C4B_C4B> vertices;
+    std::vector<uint16_t> indices;
+    std::vector<SkeletonCache::ColorData> colors;
+    std::vector<SkeletonCache::SegmentData> segments;
+};
+
+SkeletonCache::ColorData makeColor(uint8_t value, uint32_t vertexEnd) {
+    SkeletonCache::ColorData color;
+    color.finalColor = Color4B(value, 255 - value, value / 2, 255);
+    color.darkColor = Color4B(value / 3, value, 0, 255);
+    color.vertexEnd = vertexEnd;
+    return color;
+}
+
+BakedFrame makeFrame(float offsetX, float offsetY, float uvShift) {
+    const float positions[][2] = {
+        {-123.456F, 78.9F},
+        {0.0078F, -0.0039F},
+        {1000.25F, -999.99F},
+        {-0.51F, 0.49F},
+        {4096.013F, 2048.987F},
+        {-7.777F, -3.333F},
+        {12.5F, 12.5F},
+    };
+    const float uvs[][2] = {
+        {0.1234567F, 0.9876543F},
+        {0.0F, 1.0F},
+        {1.0F, 0.0F},
+        {0.5F, 0.25F},
+        {0.333333F, 0.666667F},
+        {0.0000123F, 0.9999877F},
+        {0.75F, 0.125F},
+    };
+
+    BakedFrame frame;
+    for (std::size_t i = 0; i < 7; ++i) {
+        V3F_T2F_C4B_C4B vertex;
+        vertex.vertex.set(positions[i][0] + offsetX, positions[i][1] + offsetY, 0.0F);
+        vertex.texCoord.u = std::min(uvs[i][0] + uvShift, 1.0F);
+        vertex.texCoord.v = uvs[i][1];
+        frame.vertices.push_back(vertex);
+    }
+    // two segments of 4 and 3 vertices, with a color run crossing between them
+    frame.indices = {0, 1, 2, 2, 3, 0, 2, 1, 0};
+    frame.segments = {{6, 4, 0, 0}, {3, 3, 0, 1}};
+    frame.colors = {makeColor(40, 2), makeColor(200, 7)};
+    return frame;
+}
+
+// drops the second segment, so vertex and index counts change
+BakedFrame truncate(BakedFrame frame) {
+    frame.vertices.resize(4);
+    frame.indices.resize(6);
+    frame.segments.resize(1);
+    frame.colors = {makeColor(90, 4)};
+    return frame;
+}
+
+void append(SkeletonCache::AnimationData &data, const BakedFrame &frame) {
+    const auto vbBytes = frame.vertices.size() * sizeof(V3F_T2F_C4B_C4B);
+    const auto ibBytes = frame.indices.size() * sizeof(uint16_t);
+    IOBuffer vb(vbBytes);
+    IOBuffer ib(ibBytes);
+    vb.writeBytes(reinterpret_cast<const char *>(frame.vertices.data()), vbBytes);
+    ib.writeBytes(reinterpret_cast<const char *>(frame.indices.data()), ibBytes);
+    data.appendFrame(vb, ib, {}, frame.colors, frame.segments);
+}
+
+const SkeletonCache::ColorData &colorOf(const BakedFrame &frame, uint32_t vertex) {
+    for (const auto &color : frame.colors) {
+        if (vertex < color.vertexEnd) {
+            return color;
+        }
+    }
+    return frame.colors.back();
+}
+
+void expectDecodes(const SkeletonCache::AnimationData &data, std::size_t frameIdx, const BakedFrame &frame) {
+    const auto *frameData = data.getFrameData(frameIdx);
+    ASSERT_NE(frameData, nullptr);
+    ASSERT_EQ(frameData->vertexCount, frame.vertices.size());
+    ASSERT_EQ(frameData->indexCount, frame.indices.size());
+    ASSERT_EQ(frameData->segmentCount, frame.segments.size());
+
+    // decoded segment by segment, the way the render path fills its buffers
+    std::vector<V3F_T2F_C4B_C4B> vertices(frame.vertices.size());
+    std::vector<uint16_t> indices(frame.indices.size());
+    std::vector<uint32_t> indexBase(frame.indices.size());
+    SkeletonCache::FrameReader reader(data, *frameData);
+    const auto *segments = data.getSegments(*frameData);
+    uint32_t vertexOffset = 0;
+    uint32_t indexOffset = 0;
+    for (uint32_t s = 0; s < frameData->segmentCount; ++s) {
+        reader.readVertices(segments[s].vertexCount, reinterpret_cast<uint8_t *>(vertices.data() + vertexOffset), sizeof(V3F_T2F_C4B_C4B), true);
+        reader.readIndices(segments[s].indexCount, indices.data() + indexOffset, BASE_VERTEX + vertexOffset);
+        std::fill_n(indexBase.begin() + indexOffset, segments[s].indexCount, BASE_VERTEX + vertexOffset);
+        vertexOffset += segments[s].vertexCount;
+        indexOffset += segments[s].indexCount;
+    }
+
+    for (uint32_t i = 0; i < frame.vertices.size(); ++i) {
+        const auto &expected = frame.vertices[i];
+        const auto &actual = vertices[i];
+        EXPECT_NEAR(actual.vertex.x, expected.vertex.x, POSITION_TOLERANCE) << "frame " << frameIdx << " vertex " << i;
+        EXPECT_NEAR(actual.vertex.y, expected.vertex.y, POSITION_TOLERANCE) << "frame " << frameIdx << " vertex " << i;
+        EXPECT_EQ(actual.vertex.z, 0.0F);
+        EXPECT_NEAR(actual.texCoord.u, expected.texCoord.u, UV_TOLERANCE) << "frame " << frameIdx << " vertex " << i;
+        EXPECT_NEAR(actual.texCoord.v, expected.texCoord.v, UV_TOLERANCE) << "frame " << frameIdx << " vertex " << i;
+        EXPECT_TRUE(actual.color == colorOf(frame, i).finalColor);
+        EXPECT_TRUE(actual.color2 == colorOf(frame, i).darkColor);
+    }
+    for (uint32_t i = 0; i < frame.indices.size(); ++i) {
+        EXPECT_EQ(indices[i], frame.indices[i] + indexBase[i]) << "frame " << frameIdx << " index " << i;
+    }
+}
+
+} // namespace
+
+TEST(SkeletonCacheArenaTest, decodesFramesWithinQuantizationError) {
+    SkeletonCache::AnimationData data;
+    const std::vector<BakedFrame> frames{
+        makeFrame(0.0F, 0.0F, 0.0F),
+        makeFrame(3.3F, -1.7F, 0.0F),      // only positions move
+        makeFrame(-250.125F, 0.01F, 0.1F), // texture coordinates change too
+        truncate(makeFrame(0.5F, 0.5F, 0.0F)),
+        truncate(makeFrame(1.5F, 0.5F, 0.0F)),
+    };
+    for (const auto &frame : frames) {
+        append(data, frame);
+    }
+    ASSERT_EQ(data.getFrameCount(), frames.size());
+    for (std::size_t i = 0; i < frames.size(); ++i) {
+        expectDecodes(data, i, frames[i]);
+    }
+}
+
+TEST(SkeletonCacheArenaTest, framesShareUnchangedStreams) {
+    SkeletonCache::AnimationData data;
+    append(data, makeFrame(0.0F, 0.0F, 0.0F));
+    append(data, makeFrame(3.3F, -1.7F, 0.0F));
+    append(data, makeFrame(3.3F, -1.7F, 0.1F));
+    append(data, truncate(makeFrame(0.0F, 0.0F, 0.0F)));
+    append(data, truncate(makeFrame(2.0F, 0.0F, 0.0F)));
+
+    const auto *frame0 = data.getFrameData(0);
+    const auto *frame1 = data.getFrameData(1);
+    const auto *frame2 = data.getFrameData(2);
+    const auto *frame3 = data.getFrameData(3);
+    const auto *frame4 = data.getFrameData(4);
+
+    // positions are always encoded anew
+    EXPECT_NE(frame1->positionOffset, frame0->positionOffset);
+    EXPECT_NE(frame2->positionOffset, frame1->positionOffset);
+
+    // texture coordinates and indices point back while they are unchanged
+    EXPECT_EQ(frame1->uvOffset, frame0->uvOffset);
+    EXPECT_EQ(frame1->indexOffset, frame0->indexOffset);
+    EXPECT_NE(frame2->uvOffset, frame1->uvOffset);
+    EXPECT_EQ(frame2->indexOffset, frame1->indexOffset);
+
+    // other vertex and index counts start new streams, which the next frame shares again
+    EXPECT_NE(frame3->uvOffset, frame2->uvOffset);
+    EXPECT_NE(frame3->indexOffset, frame2->indexOffset);
+    EXPECT_EQ(frame4->uvOffset, frame3->uvOffset);
+    EXPECT_EQ(frame4->indexOffset, frame3->indexOffset);
+
+    // shared streams still decode to the frames that refer to them
+    expectDecodes(data, 1, makeFrame(3.3F, -1.7F, 0.0F));
+    expectDecodes(data, 2, makeFrame(3.3F, -1.7F, 0.1F));
+    expectDecodes(data, 4, truncate(makeFrame(2.0F, 0.0F, 0.0F)));
+}
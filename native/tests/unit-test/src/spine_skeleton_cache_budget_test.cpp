@@ -0,0 +1,58 @@
+/****************************************************************************
+ Copyright (c) 2021 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#include <vector>
+#include "editor-support/spine-creator-support/SkeletonCacheMgr.h"
+#include "gtest/gtest.h"
+
+using spine::SkeletonCacheMgr;
+
+TEST(SkeletonCacheBudgetTest, evictsLeastRecentlyUsedFirst) {
+    std::vector<SkeletonCacheMgr::CacheUsage> usages{
+        {100, 5, true},
+        {100, 2, true},
+        {100, 7, true},
+        {100, 3, true},
+    };
+    // 400 bytes against 250, the two oldest go
+    auto evicted = SkeletonCacheMgr::selectEvictions(usages, 250, 10);
+    ASSERT_EQ(evicted.size(), 2);
+    EXPECT_EQ(evicted[0], 1);
+    EXPECT_EQ(evicted[1], 3);
+
+    EXPECT_TRUE(SkeletonCacheMgr::selectEvictions(usages, 400, 10).empty());
+}
+
+TEST(SkeletonCacheBudgetTest, keepsRecentlyRenderedAndUnfinishedBakes) {
+    std::vector<SkeletonCacheMgr::CacheUsage> usages{
+        {100, 10, true},  // rendered this frame
+        {100, 9, true},   // rendered last frame
+        {100, 1, false},  // still baking
+        {100, 4, true},
+        {0, 1, true},     // already evicted
+    };
+    auto evicted = SkeletonCacheMgr::selectEvictions(usages, 0, 10);
+    ASSERT_EQ(evicted.size(), 1);
+    EXPECT_EQ(evicted[0], 3);
+}
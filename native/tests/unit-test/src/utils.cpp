@@ -1,4 +1,15 @@
 #include "utils.h"
+#include <cstdarg>
+#include <cstdio>
+
+void reportBenchmark(const char *format, ...) {
+    printf("[ BENCHMARK] ");
+    va_list args;
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+    printf("\n");
+}
 
 #ifdef CC_USE_VULKAN
     #undef CC_USE_VULKAN
@@ -23,6 +23,7 @@ THE SOFTWARE.
 ****************************************************************************/
 #pragma once
 
+#include <chrono>
 #include <string>
 
 #include "cocos/math/Math.h"
@@ -38,3 +39,19 @@ static void ExpectEq(bool lf, bool rt) {
 
 void initCocos(int width, int height);
 void destroyCocos();
+
+// Benchmarks are registered as DISABLED_ tests, so that the regular run stays fast and
+// free of timing noise. Run them with --gtest_also_run_disabled_tests.
+inline double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+template <typename Func>
+double measureMs(Func &&func) {
+    const auto start = std::chrono::steady_clock::now();
+    func();
+    return elapsedMs(start);
+}
+
+// Prints a printf formatted line tagged with [ BENCHMARK] among the gtest output.
+void reportBenchmark(const char *format, ...);
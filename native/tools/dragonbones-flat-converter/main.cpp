@@ -0,0 +1,120 @@
+/****************************************************************************
+ Copyright (c) 2021-2023 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos.com
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated engine source code (the "Software"), a limited,
+ worldwide, royalty-free, non-assignable, revocable and non-exclusive license
+ to use Cocos Creator solely to develop games on your target platforms. You shall
+ not use Cocos Creator software for developing other software or tools that's
+ used for developing games. You are not granted to publish, distribute,
+ sublicense, and/or sell copies of Cocos Creator.
+
+ The software or tools in this License Agreement are licensed, not sold.
+ Xiamen Yaji Software Co., Ltd. reserves all rights not expressly granted to you.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+****************************************************************************/
+
+// Converts DragonBones skeleton data (*_ske.json or DBDT *.dbbin) to the flat data format
+// read in place by FlatDataParser. The output keeps the .dbbin extension, the runtime tells
+// the formats apart by their magic.
+//
+// usage: dragonbones-flat-converter <input> <output.dbbin>
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "dragonbones/parser/BinaryDataParser.h"
+#include "dragonbones/parser/FlatDataWriter.h"
+#include "dragonbones/parser/JSONDataParser.h"
+
+using namespace dragonBones;
+
+// Defined by core/DragonBones.cpp, which is not linked in with the runtime.
+bool DragonBones::checkInPool = true;
+
+namespace {
+
+char *readFile(const char *path) {
+    auto *file = fopen(path, "rb");
+    if (file == nullptr) {
+        return nullptr;
+    }
+
+    fseek(file, 0, SEEK_END);
+    const auto size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    // NUL terminated for the json parser.
+    auto *buffer = static_cast<char *>(malloc(size + 1));
+    const auto read = fread(buffer, 1, size, file);
+    fclose(file);
+    if (read != static_cast<size_t>(size)) {
+        free(buffer);
+        return nullptr;
+    }
+
+    buffer[size] = '\0';
+    return buffer;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s <input _ske.json or .dbbin> <output .dbbin>\n", argv[0]);
+        return 1;
+    }
+
+    auto *rawData = readFile(argv[1]);
+    if (rawData == nullptr) {
+        fprintf(stderr, "failed to read %s\n", argv[1]);
+        return 1;
+    }
+
+    DragonBonesData *data = nullptr;
+    if (rawData[0] == 'D' && rawData[1] == 'B' && rawData[2] == 'D' && rawData[3] == 'T') {
+        // The binary data owns rawData from now on.
+        BinaryDataParser parser;
+        data = parser.parseDragonBonesData(rawData);
+    } else if (FlatDataParser::isFlatData(rawData)) {
+        fprintf(stderr, "%s is flat data already\n", argv[1]);
+        free(rawData);
+        return 1;
+    } else {
+        JSONDataParser parser;
+        data = parser.parseDragonBonesData(rawData);
+        free(rawData);
+    }
+
+    if (data == nullptr) {
+        fprintf(stderr, "failed to parse %s\n", argv[1]);
+        return 1;
+    }
+
+    std::vector<char> result;
+    FlatDataWriter writer;
+    writer.write(*data, result);
+    data->returnToPool();
+
+    auto *file = fopen(argv[2], "wb");
+    if (file == nullptr || fwrite(result.data(), 1, result.size(), file) != result.size()) {
+        fprintf(stderr, "failed to write %s\n", argv[2]);
+        if (file != nullptr) {
+            fclose(file);
+        }
+        return 1;
+    }
+
+    fclose(file);
+    printf("%s: %zu bytes\n", argv[2], result.size());
+    return 0;
+}
@@ -172,7 +172,18 @@ const fsUtils = {
     },
 
     readArrayBuffer (filePath, onComplete) {
-        fsUtils.readFile(filePath, '', onComplete);
+        if (!fs.mapFile) {
+            fsUtils.readFile(filePath, '', onComplete);
+            return;
+        }
+        // binary assets such as meshes are read once, so share the pages of the file instead of copying them
+        const content = fs.mapFile(filePath);
+        let err = null;
+        if (!content) {
+            err = new Error(`Read file failed: path: ${filePath}`);
+            cc.warn(err.message);
+        }
+        onComplete && onComplete(err, content);
     },
 
     readJson (filePath, onComplete) {
@@ -16,6 +16,7 @@ export interface ICMakeConfig {
     // 任务调度系统配置，配置为布尔值的属性，会在生成时修改为 set(XXX ON) 的形式
     USE_JOB_SYSTEM_TBB?: boolean;
     USE_JOB_SYSTEM_TASKFLOW?: boolean;
+    USE_JOB_SYSTEM_NATIVE?: boolean;
     // 是否勾选竖屏
     USE_PORTRAIT?: boolean;
 